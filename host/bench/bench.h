@@ -0,0 +1,40 @@
+// Shared by the host benchmark sources (see bg95_host_bench.c)
+#pragma once
+
+#include "esp_err.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef esp_err_t (*bench_fn)(void* context);
+
+// Runs 'iterations' operations at once (e.g. spread over several publisher threads)
+typedef esp_err_t (*bench_batch_fn)(void* context, uint32_t iterations);
+
+typedef struct
+{
+  const char*    name;
+  const char*    group;
+  uint32_t       iterations; // At most - cases over the simulator also stop at the time budget
+  bench_fn       run;        // One operation
+  bench_batch_fn run_batch;  // Optional - used instead of 'run' for the timed iterations
+  void*          context;
+  size_t         bytes_per_op; // Payload per operation, for throughput (0 - not reported)
+} bench_case_t;
+
+// Keeps the compiler from dropping the work of a case
+extern volatile int32_t g_bench_sink;
+
+// Allocations made by the calling thread between pause and resume are not counted (e.g. the
+// simulator's own)
+void bench_alloc_pause(void);
+void bench_alloc_resume(void);
+
+// Parsers, formatters, the tokenizer and the NMEA parser - no I/O
+size_t bench_codec_cases(bench_case_t* cases, size_t max_cases);
+
+// Command round trips, publish throughput and driver APIs, over the simulator. 'baud' 0 does not
+// throttle the line
+esp_err_t bench_sim_setup(uint32_t baud, uint32_t latency_ms);
+size_t    bench_sim_cases(bench_case_t* cases, size_t max_cases);
+void      bench_sim_teardown(void);
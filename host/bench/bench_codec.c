@@ -0,0 +1,309 @@
+// Parser / formatter benchmarks on canned responses - no UART, no simulator
+#include "at_cmd_cereg.h"
+#include "at_cmd_cgatt.h"
+#include "at_cmd_cops.h"
+#include "at_cmd_cpsms.h"
+#include "at_cmd_formatter.h"
+#include "at_cmd_handler.h"
+#include "at_cmd_tokenizer.h"
+#include "at_cmd_trace.h"
+#include "bench.h"
+#include "bg95_nmea.h"
+#include "enum_utils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NMEA_CHUNK_SIZE 16 // As read from a UART with a small FIFO threshold
+
+// ------------------------------ CANNED RESPONSES ---------------------------------
+
+static const char COPS_TEST_RESPONSE[] =
+    "\r\n+COPS: (2,\"Vodafone.de\",\"Vodafone\",\"26202\",8),"
+    "(1,\"Telekom.de\",\"TDG\",\"26201\",8),(3,\"o2 - de\",\"o2 - de\",\"26203\",0),"
+    ",(0-4),(0-2)\r\n\r\nOK\r\n";
+
+static const char CGATT_READ_RESPONSE[] = "\r\n+CGATT: 1\r\n\r\nOK\r\n";
+
+static const char CEREG_READ_RESPONSE[] =
+    "\r\n+CEREG: 2,1,\"1A2B\",\"01A2D001\",7\r\n\r\nOK\r\n";
+
+static const char CPSMS_READ_RESPONSE[] =
+    "\r\n+CPSMS: 1,,,\"00100100\",\"00001111\"\r\n\r\nOK\r\n";
+
+// A few seconds of a tracker's NMEA port - GSV is not used by the parser, so it is skipped
+static const char NMEA_LOG[] =
+    "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n"
+    "$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*0A\r\n"
+    "$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n"
+    "$GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14*79\r\n"
+    "$GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,*76\r\n"
+    "$GPRMC,092750.000,A,5321.6802,N,00630.3372,W,0.02,31.66,280511,,,A*43\r\n"
+    "$GPVTG,31.66,T,,M,0.02,N,0.04,K,A*09\r\n"
+    "$GPGGA,092751.000,5321.6802,N,00630.3371,W,1,8,1.03,61.7,M,55.3,M,,*75\r\n"
+    "$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*0A\r\n"
+    "$GPRMC,092751.000,A,5321.6802,N,00630.3371,W,0.06,31.66,280511,,,A*45\r\n"
+    "$GPVTG,31.66,T,,M,0.06,N,0.11,K,A*09\r\n"
+    "$GNGNS,092752.000,5321.6803,N,00630.3370,W,AN,12,0.90,61.8,55.3,,,V*08\r\n"
+    "$GPGGA,092752.000,5321.6803,N,00630.3370,W,1,8,1.03,61.8,M,55.3,M,,*79\r\n"
+    "$GPRMC,092752.000,A,5321.6803,N,00630.3370,W,0.05,31.66,280511,,,A*45\r\n";
+
+#define NMEA_LOG_UPDATES 7 // GGA, RMC and GNS sentences in NMEA_LOG
+
+// ------------------------------ CASES ---------------------------------
+
+static esp_err_t bench_tokenize_cops_test(void* context)
+{
+  at_tokenizer_t tok;
+  at_field_t     field;
+  esp_err_t      err = at_tokenizer_init(&tok, COPS_TEST_RESPONSE, "+COPS: ");
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  int32_t fields = 0;
+  while ((err = at_tokenizer_next(&tok, &field)) == ESP_OK)
+  {
+    fields += (int32_t) field.len;
+  }
+  g_bench_sink = fields;
+  return err == ESP_ERR_NOT_FOUND ? ESP_OK : err;
+}
+
+static esp_err_t bench_parse_cops_test(void* context)
+{
+  cops_test_response_t response;
+  esp_err_t            err =
+      AT_CMD_COPS.type_info[AT_CMD_TYPE_TEST].parser(COPS_TEST_RESPONSE, &response);
+  g_bench_sink = response.num_operators;
+  return err;
+}
+
+static esp_err_t bench_parse_cgatt_read(void* context)
+{
+  cgatt_read_params_t response;
+  esp_err_t err = AT_CMD_CGATT.type_info[AT_CMD_TYPE_READ].parser(CGATT_READ_RESPONSE, &response);
+  g_bench_sink  = (int32_t) response.state;
+  return err;
+}
+
+static esp_err_t bench_parse_cereg_read(void* context)
+{
+  cereg_read_response_t response;
+  esp_err_t err = AT_CMD_CEREG.type_info[AT_CMD_TYPE_READ].parser(CEREG_READ_RESPONSE, &response);
+  g_bench_sink  = (int32_t) response.stat + response.tac[0];
+  return err;
+}
+
+// What the parsers did before the tokenizer - kept as the baseline for parse_cereg_read
+static esp_err_t bench_sscanf_cereg_read(void* context)
+{
+  const char* line = strstr(CEREG_READ_RESPONSE, "+CEREG: ");
+  if (!line)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  int  n;
+  int  stat;
+  int  act;
+  char tac[CEREG_TAC_MAX_CHARS];
+  char ci[CEREG_CI_MAX_CHARS];
+  if (sscanf(line, "+CEREG: %d,%d,\"%4[^\"]\",\"%8[^\"]\",%d", &n, &stat, tac, ci, &act) != 5)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  g_bench_sink = stat + tac[0];
+  return ESP_OK;
+}
+
+static esp_err_t bench_parse_cpsms_read(void* context)
+{
+  cpsms_read_response_t response;
+  esp_err_t err = AT_CMD_CPSMS.type_info[AT_CMD_TYPE_READ].parser(CPSMS_READ_RESPONSE, &response);
+  g_bench_sink  = (int32_t) response.mode + response.active_time[7];
+  return err;
+}
+
+// The field splitter CPSMS used before the tokenizer - the baseline for parse_cpsms_read
+static bool split_cpsms_field(const char* start, int field_idx, char* out, size_t out_size)
+{
+  const char* pos = start;
+  for (int i = 0; i < field_idx; i++)
+  {
+    pos = strchr(pos, ',');
+    if (!pos)
+    {
+      return false;
+    }
+    pos++;
+  }
+
+  if (*pos == '"')
+  {
+    pos++;
+  }
+
+  size_t len = strcspn(pos, "\",\r\n");
+  if (len == 0 || len >= out_size)
+  {
+    return false;
+  }
+
+  memcpy(out, pos, len);
+  out[len] = '\0';
+  return true;
+}
+
+static esp_err_t bench_split_cpsms_read(void* context)
+{
+  const char* start = strstr(CPSMS_READ_RESPONSE, "+CPSMS: ");
+  if (!start)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 8; // Skip "+CPSMS: "
+
+  int  mode;
+  char periodic_tau[CPSMS_TIMER_STR_SIZE];
+  char active_time[CPSMS_TIMER_STR_SIZE];
+  if (sscanf(start, "%d", &mode) != 1 ||
+      !split_cpsms_field(start, 3, periodic_tau, sizeof(periodic_tau)) ||
+      !split_cpsms_field(start, 4, active_time, sizeof(active_time)) ||
+      strspn(periodic_tau, "01") != CPSMS_TIMER_BITS_LEN ||
+      strspn(active_time, "01") != CPSMS_TIMER_BITS_LEN)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  g_bench_sink = mode + active_time[7];
+  return ESP_OK;
+}
+
+static esp_err_t bench_format_cgatt_write(void* context)
+{
+  cgatt_write_params_t params = {.state = CGATT_STATE_ATTACHED};
+  char                 cmd[AT_CMD_MAX_CMD_LEN];
+
+  esp_err_t err = format_at_cmd(&AT_CMD_CGATT, AT_CMD_TYPE_WRITE, &params, cmd, sizeof(cmd));
+  g_bench_sink  = cmd[0];
+  return err;
+}
+
+static esp_err_t bench_enum_to_str(void* context)
+{
+  g_bench_sink = enum_to_str(COPS_ACT_EMTC, COPS_ACT_MAP, COPS_ACT_MAP_SIZE)[0];
+  return ESP_OK;
+}
+
+static esp_err_t bench_trace_record(void* context)
+{
+  at_cmd_trace_record((at_cmd_trace_t*) context,
+                      AT_CMD_TRACE_EVENT_RESPONSE,
+                      &AT_CMD_CGATT,
+                      AT_CMD_TYPE_READ,
+                      ESP_OK,
+                      1,
+                      CGATT_READ_RESPONSE,
+                      sizeof(CGATT_READ_RESPONSE) - 1);
+  return ESP_OK;
+}
+
+static esp_err_t check_nmea_updates(size_t updates, const bg95_nmea_parser_t* parser)
+{
+  g_bench_sink = parser->fix.latitude_e7;
+  return updates == NMEA_LOG_UPDATES ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+// The whole log in one piece, e.g. a QGPSGNMEA answer
+static esp_err_t bench_nmea_feed_log(void* context)
+{
+  bg95_nmea_parser_t*    parser = (bg95_nmea_parser_t*) context;
+  bg95_gnss_fix_store_t* store  = (bg95_gnss_fix_store_t*) (parser + 1);
+
+  bg95_nmea_parser_init(parser);
+  size_t updates = bg95_nmea_parser_feed(parser, NMEA_LOG, sizeof(NMEA_LOG) - 1, store);
+  return check_nmea_updates(updates, parser);
+}
+
+// The log as it trickles in from the NMEA port
+static esp_err_t bench_nmea_feed_log_chunked(void* context)
+{
+  bg95_nmea_parser_t*    parser = (bg95_nmea_parser_t*) context;
+  bg95_gnss_fix_store_t* store  = (bg95_gnss_fix_store_t*) (parser + 1);
+
+  bg95_nmea_parser_init(parser);
+  size_t updates = 0;
+  for (size_t pos = 0; pos < sizeof(NMEA_LOG) - 1; pos += NMEA_CHUNK_SIZE)
+  {
+    size_t len = sizeof(NMEA_LOG) - 1 - pos;
+    updates += bg95_nmea_parser_feed(
+        parser, NMEA_LOG + pos, len < NMEA_CHUNK_SIZE ? len : NMEA_CHUNK_SIZE, store);
+  }
+  return check_nmea_updates(updates, parser);
+}
+
+static esp_err_t bench_gnss_fix_read(void* context)
+{
+  bg95_gnss_fix_t fix;
+  if (!bg95_gnss_fix_store_read((const bg95_gnss_fix_store_t*) context, &fix))
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+  g_bench_sink = fix.longitude_e7;
+  return ESP_OK;
+}
+
+// ------------------------------ CASE LIST ---------------------------------
+
+size_t bench_codec_cases(bench_case_t* cases, size_t max_cases)
+{
+  static at_cmd_trace_record_t records[256];
+  static uint8_t               capture[4096];
+  static at_cmd_trace_t        trace;
+  static struct
+  {
+    bg95_nmea_parser_t    parser; // The cases find the store right after it
+    bg95_gnss_fix_store_t store;
+  } nmea;
+
+  at_cmd_trace_init(&trace, records, 256, capture, sizeof(capture), 48);
+  bg95_gnss_fix_store_init(&nmea.store);
+  bench_nmea_feed_log(&nmea.parser); // A fix for gnss_fix_read
+
+  const bench_case_t list[] = {
+      {"tokenize_cops_test", "parse", 200000, bench_tokenize_cops_test},
+      {"parse_cops_test", "parse", 100000, bench_parse_cops_test},
+      {"parse_cgatt_read", "parse", 500000, bench_parse_cgatt_read},
+      {"parse_cereg_read", "parse", 500000, bench_parse_cereg_read},
+      {"sscanf_cereg_read", "parse", 500000, bench_sscanf_cereg_read},
+      {"parse_cpsms_read", "parse", 500000, bench_parse_cpsms_read},
+      {"split_cpsms_read", "parse", 500000, bench_split_cpsms_read},
+      {"format_cgatt_write", "format", 500000, bench_format_cgatt_write},
+      {"enum_to_str", "util", 5000000, bench_enum_to_str},
+      {"trace_record", "util", 2000000, bench_trace_record, NULL, &trace},
+      {"nmea_feed_log",
+       "nmea",
+       100000,
+       bench_nmea_feed_log,
+       NULL,
+       &nmea.parser,
+       sizeof(NMEA_LOG) - 1},
+      {"nmea_feed_log_chunked",
+       "nmea",
+       100000,
+       bench_nmea_feed_log_chunked,
+       NULL,
+       &nmea.parser,
+       sizeof(NMEA_LOG) - 1},
+      {"gnss_fix_read", "nmea", 5000000, bench_gnss_fix_read, NULL, &nmea.store},
+  };
+
+  size_t count = sizeof(list) / sizeof(list[0]);
+  if (count > max_cases)
+  {
+    count = max_cases;
+  }
+  memcpy(cases, list, count * sizeof(bench_case_t));
+  return count;
+}
@@ -0,0 +1,755 @@
+// Benchmarks over the simulator (host/sim): what a command, a publish or a driver API costs end to
+// end, including the line at the configured baud rate
+#include "at_cmd_at.h"
+#include "at_cmd_cedrxrdp.h"
+#include "at_cmd_cedrxs.h"
+#include "at_cmd_cereg.h"
+#include "at_cmd_cfun.h"
+#include "at_cmd_cgact.h"
+#include "at_cmd_cgatt.h"
+#include "at_cmd_cgdcont.h"
+#include "at_cmd_cgpaddr.h"
+#include "at_cmd_cmux.h"
+#include "at_cmd_cops.h"
+#include "at_cmd_cpin.h"
+#include "at_cmd_cpsms.h"
+#include "at_cmd_creg.h"
+#include "at_cmd_csq.h"
+#include "at_cmd_handler.h"
+#include "at_cmd_ifc.h"
+#include "at_cmd_ipr.h"
+#include "at_cmd_qcfg.h"
+#include "at_cmd_qcsq.h"
+#include "at_cmd_qfclose.h"
+#include "at_cmd_qfdwl.h"
+#include "at_cmd_qfopen.h"
+#include "at_cmd_qfread.h"
+#include "at_cmd_qfseek.h"
+#include "at_cmd_qfwrite.h"
+#include "at_cmd_qgps.h"
+#include "at_cmd_qgpscfg.h"
+#include "at_cmd_qgpsend.h"
+#include "at_cmd_qgpsgnmea.h"
+#include "at_cmd_qgpsloc.h"
+#include "at_cmd_qhttpcfg.h"
+#include "at_cmd_qhttpget.h"
+#include "at_cmd_qhttpgetex.h"
+#include "at_cmd_qhttppost.h"
+#include "at_cmd_qhttpread.h"
+#include "at_cmd_qhttpurl.h"
+#include "at_cmd_qiclose.h"
+#include "at_cmd_qiopen.h"
+#include "at_cmd_qird.h"
+#include "at_cmd_qisend.h"
+#include "at_cmd_qmtcfg.h"
+#include "at_cmd_qmtclose.h"
+#include "at_cmd_qmtconn.h"
+#include "at_cmd_qmtdisc.h"
+#include "at_cmd_qmtopen.h"
+#include "at_cmd_qmtpub.h"
+#include "at_cmd_qmtsub.h"
+#include "at_cmd_qmtuns.h"
+#include "at_cmd_qnwinfo.h"
+#include "at_cmd_qsclk.h"
+#include "at_cmd_qsslcfg.h"
+#include "bench.h"
+#include "bg95_driver.h"
+#include "bg95_sim.h"
+#include "bg95_uart_record.h"
+#include "bg95_uart_replay.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MQTT_CLIENT 0
+#define BENCH_MQTT_TOPIC "bench/publish"
+#define BENCH_MAX_PUBLISHERS 4
+#define BENCH_MAX_PAYLOAD 4096 // QMTPUB_MSG_MAX_LEN
+#define BENCH_CAPTURE_SIZE 65536
+#define BENCH_SOCKET_ID 0
+
+static const uint16_t PAYLOAD_SIZES[] = {16, 256, 1024, 4096};
+static const uint8_t  PUBLISH_DEPTHS[] = {1, 2, 4};
+static const uint16_t ECHO_SIZES[] = {256, 1460, 4096}; // 1460 - one QISEND
+static const uint32_t FILE_SIZES[] = {4096, 16384};
+
+#define NUM_PAYLOAD_SIZES (sizeof(PAYLOAD_SIZES) / sizeof(PAYLOAD_SIZES[0]))
+#define NUM_PUBLISH_DEPTHS (sizeof(PUBLISH_DEPTHS) / sizeof(PUBLISH_DEPTHS[0]))
+#define NUM_ECHO_SIZES (sizeof(ECHO_SIZES) / sizeof(ECHO_SIZES[0]))
+#define NUM_FILE_SIZES (sizeof(FILE_SIZES) / sizeof(FILE_SIZES[0]))
+
+typedef struct
+{
+  const at_cmd_t* cmd;
+  at_cmd_type_t   type;
+  const void*     params;
+} round_trip_t;
+
+typedef struct
+{
+  uint16_t payload_len;
+  uint8_t  depth; // Publishers sharing the handle
+  char     name[32];
+} publish_case_t;
+
+// An upload and a download case per size, both on the file the setup stores for that size
+typedef struct
+{
+  uint32_t size;
+  char     file[32];
+  char     upload_name[32];
+  char     download_name[32];
+} file_case_t;
+
+static bg95_sim_t*           s_sim;
+static bg95_uart_interface_t s_sim_uart;
+static bg95_handle_t*        s_handle;
+static uint32_t              s_bytes_per_sec;
+static uint8_t               s_payload[BENCH_MAX_PAYLOAD];
+static publish_case_t        s_publish_cases[NUM_PAYLOAD_SIZES * NUM_PUBLISH_DEPTHS];
+static uint8_t               s_echo[BENCH_MAX_PAYLOAD];
+static char                  s_echo_names[NUM_ECHO_SIZES][32];
+static file_case_t           s_file_cases[NUM_FILE_SIZES];
+static bg95_uart_replay_t*   s_replay;
+
+// Big enough for any response structure of the round trip cases
+static union
+{
+  uint8_t     bytes[16384];
+  long double align;
+} s_response;
+
+// ------------------------------ SIMULATED UART ---------------------------------
+
+// The simulator's own allocations are not the driver's. It only throttles what it sends, so the
+// time the host's bytes take on the line is spent here - a publish payload is not free
+static esp_err_t uart_write(const char* data, size_t len, void* context)
+{
+  if (s_bytes_per_sec)
+  {
+    uint64_t        line_us = ((uint64_t) len * 1000000U) / s_bytes_per_sec;
+    struct timespec line    = {.tv_sec  = (time_t) (line_us / 1000000U),
+                               .tv_nsec = (long) (line_us % 1000000U) * 1000};
+    nanosleep(&line, NULL);
+  }
+
+  bench_alloc_pause();
+  esp_err_t err = s_sim_uart.write(data, len, s_sim_uart.context);
+  bench_alloc_resume();
+  return err;
+}
+
+static esp_err_t
+uart_read(char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context)
+{
+  bench_alloc_pause();
+  esp_err_t err = s_sim_uart.read(buffer, max_len, bytes_read, timeout_ms, s_sim_uart.context);
+  bench_alloc_resume();
+  return err;
+}
+
+// ------------------------------ ROUND TRIPS ---------------------------------
+
+// Every command of the driver, grouped as in include/at/cmd
+static const at_cmd_t* const COMMANDS[] = {
+    // File
+    &AT_CMD_QFCLOSE,
+    &AT_CMD_QFDWL,
+    &AT_CMD_QFOPEN,
+    &AT_CMD_QFREAD,
+    &AT_CMD_QFSEEK,
+    &AT_CMD_QFWRITE,
+    // General / hardware
+    &AT_CMD_AT,
+    &AT_CMD_CFUN,
+    &AT_CMD_CMUX,
+    &AT_CMD_IFC,
+    &AT_CMD_IPR,
+    &AT_CMD_QSCLK,
+    // GNSS
+    &AT_CMD_QGPS,
+    &AT_CMD_QGPSCFG,
+    &AT_CMD_QGPSEND,
+    &AT_CMD_QGPSGNMEA,
+    &AT_CMD_QGPSLOC,
+    // HTTP
+    &AT_CMD_QHTTPCFG,
+    &AT_CMD_QHTTPGET,
+    &AT_CMD_QHTTPGETEX,
+    &AT_CMD_QHTTPPOST,
+    &AT_CMD_QHTTPREAD,
+    &AT_CMD_QHTTPURL,
+    // MQTT
+    &AT_CMD_QMTCFG,
+    &AT_CMD_QMTCLOSE,
+    &AT_CMD_QMTCONN,
+    &AT_CMD_QMTDISC,
+    &AT_CMD_QMTOPEN,
+    &AT_CMD_QMTPUB,
+    &AT_CMD_QMTSUB,
+    &AT_CMD_QMTUNS,
+    // Network service
+    &AT_CMD_CEDRXRDP,
+    &AT_CMD_CEDRXS,
+    &AT_CMD_CEREG,
+    &AT_CMD_COPS,
+    &AT_CMD_CPSMS,
+    &AT_CMD_CREG,
+    &AT_CMD_CSQ,
+    &AT_CMD_QCFG,
+    &AT_CMD_QCSQ,
+    &AT_CMD_QNWINFO,
+    // Packet domain / SIM
+    &AT_CMD_CGACT,
+    &AT_CMD_CGATT,
+    &AT_CMD_CGDCONT,
+    &AT_CMD_CGPADDR,
+    &AT_CMD_CPIN,
+    // SSL / TCP/IP
+    &AT_CMD_QSSLCFG,
+    &AT_CMD_QICLOSE,
+    &AT_CMD_QIOPEN,
+    &AT_CMD_QIRD,
+    &AT_CMD_QISEND,
+};
+
+#define NUM_COMMANDS (sizeof(COMMANDS) / sizeof(COMMANDS[0]))
+
+// Writes need parameters, and most of them change what the other cases run against (attach,
+// connect, close ...) - only the ones that leave the state as it is are timed
+static const cgpaddr_write_params_t CGPADDR_CID_1 = {.cid = 1};
+
+static const round_trip_t WRITES[] = {
+    {&AT_CMD_CGPADDR, AT_CMD_TYPE_WRITE, &CGPADDR_CID_1},
+};
+
+#define NUM_WRITES (sizeof(WRITES) / sizeof(WRITES[0]))
+
+// Test, read and execute of every command the simulator models, and WRITES
+#define MAX_ROUND_TRIPS (NUM_COMMANDS * AT_CMD_TYPE_MAX)
+
+static round_trip_t s_round_trips[MAX_ROUND_TRIPS];
+
+static const char* TYPE_SUFFIX[AT_CMD_TYPE_MAX] = {
+    [AT_CMD_TYPE_TEST] = "test",
+    [AT_CMD_TYPE_READ] = "read",
+    [AT_CMD_TYPE_WRITE] = "write",
+    [AT_CMD_TYPE_EXECUTE] = "exec",
+};
+
+static char s_round_trip_names[MAX_ROUND_TRIPS][32];
+
+static esp_err_t bench_round_trip(void* context)
+{
+  const round_trip_t* trip = (const round_trip_t*) context;
+  return at_cmd_handler_send_and_receive_cmd(
+      &s_handle->at_handler, trip->cmd, trip->type, trip->params, s_response.bytes);
+}
+
+// ------------------------------ PUBLISH ---------------------------------
+
+typedef struct
+{
+  const publish_case_t* publish;
+  uint32_t              count;
+  esp_err_t             err;
+} publisher_t;
+
+static esp_err_t publish_once(uint16_t payload_len)
+{
+  qmtpub_write_response_t response;
+  return bg95_mqtt_publish_fixed_length(s_handle,
+                                        BENCH_MQTT_CLIENT,
+                                        1,
+                                        QMTPUB_QOS_AT_LEAST_ONCE,
+                                        QMTPUB_RETAIN_DISABLED,
+                                        BENCH_MQTT_TOPIC,
+                                        s_payload,
+                                        payload_len,
+                                        &response);
+}
+
+static void* publisher_thread(void* arg)
+{
+  publisher_t* publisher = (publisher_t*) arg;
+  for (uint32_t i = 0; i < publisher->count && publisher->err == ESP_OK; i++)
+  {
+    publisher->err = publish_once(publisher->publish->payload_len);
+  }
+  return NULL;
+}
+
+static esp_err_t bench_publish(void* context)
+{
+  return publish_once(((const publish_case_t*) context)->payload_len);
+}
+
+// 'iterations' publishes spread over 'depth' threads. The handler sends one command at a time, so
+// this shows what publishers waiting on each other cost, not a gain
+static esp_err_t bench_publish_batch(void* context, uint32_t iterations)
+{
+  const publish_case_t* publish = (const publish_case_t*) context;
+  publisher_t           publishers[BENCH_MAX_PUBLISHERS];
+  pthread_t             threads[BENCH_MAX_PUBLISHERS];
+
+  for (uint8_t i = 0; i < publish->depth; i++)
+  {
+    publishers[i].publish = publish;
+    publishers[i].count   = iterations / publish->depth + (i < iterations % publish->depth);
+    publishers[i].err     = ESP_OK;
+    if (pthread_create(&threads[i], NULL, publisher_thread, &publishers[i]) != 0)
+    {
+      publishers[i].err = ESP_ERR_NO_MEM;
+      threads[i]        = 0;
+    }
+  }
+
+  esp_err_t err = ESP_OK;
+  for (uint8_t i = 0; i < publish->depth; i++)
+  {
+    if (threads[i])
+    {
+      pthread_join(threads[i], NULL);
+    }
+    if (publishers[i].err != ESP_OK)
+    {
+      err = publishers[i].err;
+    }
+  }
+  return err;
+}
+
+// ------------------------------ SOCKETS ---------------------------------
+
+// 'len' bytes to the simulator's echo server and back: QISEND with its prompt one way, QIRD the
+// other, so the payload crosses the line twice
+static esp_err_t bench_socket_echo(void* context)
+{
+  size_t    len = *(const uint16_t*) context;
+  esp_err_t err = bg95_socket_send(s_handle, BENCH_SOCKET_ID, s_payload, len);
+
+  size_t total = 0;
+  while (err == ESP_OK && total < len)
+  {
+    size_t received = 0;
+    err = bg95_socket_recv(s_handle, BENCH_SOCKET_ID, s_echo + total, len - total, &received);
+    if (err == ESP_OK && received == 0)
+    {
+      err = ESP_ERR_INVALID_SIZE; // The echo came back short
+    }
+    total += received;
+  }
+  g_bench_sink = s_echo[len - 1];
+  return err;
+}
+
+// ------------------------------ FILES ---------------------------------
+
+// The payload pattern over and over
+static esp_err_t bench_file_source(char* buffer, size_t buffer_size, size_t* len, void* context)
+{
+  uint32_t* offset = (uint32_t*) context;
+  size_t    start  = *offset % sizeof(s_payload);
+  size_t    left   = sizeof(s_payload) - start;
+  *len             = buffer_size < left ? buffer_size : left;
+  memcpy(buffer, s_payload + start, *len);
+  *offset += *len;
+  return ESP_OK;
+}
+
+static esp_err_t bench_file_sink(const char* data, size_t len, void* context)
+{
+  g_bench_sink = data[len - 1];
+  return ESP_OK;
+}
+
+// QFOPEN, QFWRITE windows and QFCLOSE - and the whole file read back by the check of the upload
+static esp_err_t bench_file_upload(void* context)
+{
+  const file_case_t*   file     = (const file_case_t*) context;
+  uint32_t             offset   = 0;
+  bg95_file_transfer_t transfer = {0};
+  return bg95_file_upload(s_handle, file->file, bench_file_source, &offset, file->size, &transfer);
+}
+
+// One QFDWL stream
+static esp_err_t bench_file_download(void* context)
+{
+  const file_case_t*   file     = (const file_case_t*) context;
+  bg95_file_transfer_t transfer = {0};
+  esp_err_t err = bg95_file_download(s_handle, file->file, bench_file_sink, NULL, &transfer);
+  return (err == ESP_OK && transfer.offset != file->size) ? ESP_ERR_INVALID_SIZE : err;
+}
+
+// ------------------------------ DRIVER APIS ---------------------------------
+
+static esp_err_t bench_api_signal_quality(void* context)
+{
+  int16_t   rssi_dbm;
+  esp_err_t err = bg95_get_signal_quality_dbm(s_handle, &rssi_dbm);
+  g_bench_sink  = rssi_dbm;
+  return err;
+}
+
+static esp_err_t bench_api_sim_card_status(void* context)
+{
+  cpin_status_t status;
+  esp_err_t     err = bg95_get_sim_card_status(s_handle, &status);
+  g_bench_sink      = (int32_t) status;
+  return err;
+}
+
+static esp_err_t bench_api_current_operator(void* context)
+{
+  cops_operator_data_t operator_data;
+  esp_err_t            err = bg95_get_current_operator(s_handle, &operator_data);
+  g_bench_sink             = operator_data.operator_name[0];
+  return err;
+}
+
+static esp_err_t bench_api_pdp_active(void* context)
+{
+  bool      active = false;
+  esp_err_t err    = bg95_is_pdp_context_active(s_handle, 1, &active);
+  g_bench_sink     = active;
+  return (err == ESP_OK && !active) ? ESP_ERR_INVALID_STATE : err;
+}
+
+static esp_err_t bench_api_mqtt_state(void* context)
+{
+  qmtconn_read_response_t state;
+  esp_err_t err = bg95_mqtt_query_connection_state(s_handle, BENCH_MQTT_CLIENT, &state);
+  g_bench_sink  = (int32_t) state.state;
+  return err;
+}
+
+// ------------------------------ REPLAY ---------------------------------
+
+static const bg95_config_t DRIVER_CONFIG = {.pwrkey_gpio_num = 0,
+                                            .status_gpio_num = BG95_GPIO_NOT_USED,
+                                            .dtr_gpio_num    = BG95_GPIO_NOT_USED};
+
+// Bring up a driver on 'uart' and make the calls of the api group on it - recorded once against
+// the simulator, then replayed
+static esp_err_t run_session(bg95_uart_interface_t* uart)
+{
+  bg95_handle_t* handle = calloc(1, sizeof(bg95_handle_t));
+  if (!handle)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  int16_t                 rssi_dbm;
+  cpin_status_t           status;
+  cops_operator_data_t    operator_data;
+  bool                    active;
+  qmtconn_read_response_t state;
+  qmtpub_write_response_t response;
+
+  esp_err_t err = bg95_init_with_config(handle, uart, &DRIVER_CONFIG);
+  if (err == ESP_OK)
+  {
+    err = bg95_get_signal_quality_dbm(handle, &rssi_dbm);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_get_sim_card_status(handle, &status);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_get_current_operator(handle, &operator_data);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_is_pdp_context_active(handle, 1, &active);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_mqtt_query_connection_state(handle, BENCH_MQTT_CLIENT, &state);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_mqtt_publish_fixed_length(handle,
+                                         BENCH_MQTT_CLIENT,
+                                         1,
+                                         QMTPUB_QOS_AT_LEAST_ONCE,
+                                         QMTPUB_RETAIN_DISABLED,
+                                         BENCH_MQTT_TOPIC,
+                                         s_payload,
+                                         256,
+                                         &response);
+  }
+
+  bg95_deinit(handle);
+  return err;
+}
+
+static esp_err_t record_session(void)
+{
+  static uint8_t            ring[BENCH_CAPTURE_SIZE];
+  bg95_uart_record_t        recorder;
+  bg95_uart_record_config_t config = {.ring = ring, .ring_size = sizeof(ring)};
+  bg95_uart_interface_t     uart   = {.write = uart_write, .read = uart_read, .context = s_sim};
+  bg95_uart_interface_t     recording;
+  size_t                    capture_len = 0;
+
+  esp_err_t err = bg95_uart_record_init(&recorder, &uart, &config, &recording);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+  err = run_session(&recording);
+
+  uint8_t* capture = malloc(BENCH_CAPTURE_SIZE + BG95_UART_RECORD_HEADER_LEN);
+  if (err == ESP_OK && !capture)
+  {
+    err = ESP_ERR_NO_MEM;
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_uart_record_read(&recorder,
+                                capture,
+                                BENCH_CAPTURE_SIZE + BG95_UART_RECORD_HEADER_LEN,
+                                &capture_len);
+  }
+  if (err == ESP_OK)
+  {
+    bg95_uart_replay_config_t replay_config = {.speedup = 0, .strict = true};
+    err = bg95_uart_replay_create(capture, capture_len, &replay_config, &s_replay);
+  }
+
+  free(capture);
+  bg95_uart_record_deinit(&recorder);
+  return err;
+}
+
+// The recorded session at full speed - what the driver itself costs for it, without the module
+static esp_err_t bench_replay_session(void* context)
+{
+  bg95_uart_interface_t uart;
+  bg95_uart_replay_rewind(s_replay);
+  bg95_uart_replay_uart_init(s_replay, &uart);
+
+  esp_err_t err = run_session(&uart);
+
+  bg95_uart_replay_stats_t stats;
+  bg95_uart_replay_get_stats(s_replay, &stats);
+  if (err == ESP_OK && (!stats.finished || stats.tx_mismatches > 0))
+  {
+    err = ESP_ERR_INVALID_RESPONSE;
+  }
+  return err;
+}
+
+// ------------------------------ SETUP ---------------------------------
+
+esp_err_t bench_sim_setup(uint32_t baud, uint32_t latency_ms)
+{
+  bg95_sim_config_t config = BG95_SIM_CONFIG_DEFAULT();
+  config.latency_ms        = latency_ms;
+  config.bytes_per_sec     = baud / 10; // 8N1 - ten bits per byte
+  s_bytes_per_sec          = config.bytes_per_sec;
+
+  esp_err_t err = bg95_sim_create(&config, &s_sim);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+  bg95_sim_uart_init(s_sim, &s_sim_uart);
+
+  bg95_uart_interface_t uart = {.write = uart_write, .read = uart_read, .context = s_sim};
+
+  s_handle = malloc(sizeof(bg95_handle_t));
+  if (!s_handle)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  err = bg95_init_with_config(s_handle, &uart, &DRIVER_CONFIG);
+
+  // A connected MQTT client for the publish and MQTT cases, and a socket for the socket cases
+  qmtopen_write_response_t open_response;
+  qmtconn_write_response_t conn_response;
+  if (err == ESP_OK)
+  {
+    err = bg95_define_pdp_context(s_handle, 1, CGDCONT_PDP_TYPE_IP, "bench");
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_activate_pdp_context(s_handle, 1);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_mqtt_open_network(s_handle, BENCH_MQTT_CLIENT, "broker", 1883, &open_response);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_mqtt_connect(s_handle, BENCH_MQTT_CLIENT, "bench", NULL, NULL, &conn_response);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_socket_open(s_handle, 1, BENCH_SOCKET_ID, QIOPEN_SERVICE_TYPE_TCP, "echo", 7, NULL);
+  }
+
+  for (size_t i = 0; i < sizeof(s_payload); i++)
+  {
+    s_payload[i] = (uint8_t) ('a' + i % 26);
+  }
+
+  // The files of the download cases (bench_sim_cases has named them)
+  for (size_t i = 0; i < NUM_FILE_SIZES && err == ESP_OK && s_file_cases[i].size; i++)
+  {
+    char* content = malloc(s_file_cases[i].size);
+    if (!content)
+    {
+      return ESP_ERR_NO_MEM;
+    }
+    uint32_t offset = 0;
+    size_t   len    = 0;
+    while (offset < s_file_cases[i].size)
+    {
+      bench_file_source(content + offset, s_file_cases[i].size - offset, &len, &offset);
+    }
+    err = bg95_sim_write_file(s_sim, s_file_cases[i].file, content, s_file_cases[i].size);
+    free(content);
+  }
+
+  // A capture of the api group for the replay case
+  if (err == ESP_OK)
+  {
+    err = record_session();
+  }
+  return err;
+}
+
+size_t bench_sim_cases(bench_case_t* cases, size_t max_cases)
+{
+  size_t count = 0;
+
+  size_t num_round_trips = 0;
+  for (size_t i = 0; i < NUM_COMMANDS; i++)
+  {
+    // Commands the simulator does not model would only time its ERROR
+    if (!bg95_sim_models(COMMANDS[i]->name))
+    {
+      continue;
+    }
+
+    for (int type = 0; type < AT_CMD_TYPE_MAX; type++)
+    {
+      if (type != AT_CMD_TYPE_WRITE && at_cmd_type_is_implemented(COMMANDS[i], type))
+      {
+        s_round_trips[num_round_trips++] = (round_trip_t) {COMMANDS[i], type, NULL};
+      }
+    }
+    for (size_t w = 0; w < NUM_WRITES; w++)
+    {
+      if (WRITES[w].cmd == COMMANDS[i])
+      {
+        s_round_trips[num_round_trips++] = WRITES[w];
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_round_trips && count < max_cases; i++)
+  {
+    snprintf(s_round_trip_names[i],
+             sizeof(s_round_trip_names[i]),
+             "rtt_%s_%s",
+             s_round_trips[i].cmd->name,
+             TYPE_SUFFIX[s_round_trips[i].type]);
+    cases[count++] = (bench_case_t) {.name       = s_round_trip_names[i],
+                                     .group      = "round_trip",
+                                     .iterations = 2000,
+                                     .run        = bench_round_trip,
+                                     .context    = &s_round_trips[i]};
+  }
+
+  for (size_t s = 0; s < NUM_PAYLOAD_SIZES; s++)
+  {
+    for (size_t d = 0; d < NUM_PUBLISH_DEPTHS && count < max_cases; d++)
+    {
+      publish_case_t* publish = &s_publish_cases[s * NUM_PUBLISH_DEPTHS + d];
+      publish->payload_len    = PAYLOAD_SIZES[s];
+      publish->depth          = PUBLISH_DEPTHS[d];
+      snprintf(publish->name,
+               sizeof(publish->name),
+               "publish_%uB_x%u",
+               (unsigned) publish->payload_len,
+               (unsigned) publish->depth);
+      cases[count++] = (bench_case_t) {.name         = publish->name,
+                                       .group        = "publish",
+                                       .iterations   = 500,
+                                       .run          = bench_publish,
+                                       .run_batch    = bench_publish_batch,
+                                       .context      = publish,
+                                       .bytes_per_op = publish->payload_len};
+    }
+  }
+
+  for (size_t i = 0; i < NUM_ECHO_SIZES && count < max_cases; i++)
+  {
+    snprintf(s_echo_names[i], sizeof(s_echo_names[i]), "socket_echo_%uB", (unsigned) ECHO_SIZES[i]);
+    cases[count++] = (bench_case_t) {.name         = s_echo_names[i],
+                                     .group        = "socket",
+                                     .iterations   = 500,
+                                     .run          = bench_socket_echo,
+                                     .context      = (void*) &ECHO_SIZES[i],
+                                     .bytes_per_op = ECHO_SIZES[i]};
+  }
+
+  for (size_t i = 0; i < NUM_FILE_SIZES && count + 1 < max_cases; i++)
+  {
+    file_case_t* file = &s_file_cases[i];
+    uint32_t     size = FILE_SIZES[i];
+    file->size        = size;
+    snprintf(file->file, sizeof(file->file), "UFS:bench_%u.bin", (unsigned) size);
+    snprintf(file->upload_name, sizeof(file->upload_name), "file_upload_%uB", (unsigned) size);
+    snprintf(file->download_name,
+             sizeof(file->download_name),
+             "file_download_%uB",
+             (unsigned) size);
+    cases[count++] = (bench_case_t) {.name         = file->upload_name,
+                                     .group        = "file",
+                                     .iterations   = 100,
+                                     .run          = bench_file_upload,
+                                     .context      = file,
+                                     .bytes_per_op = file->size};
+    cases[count++] = (bench_case_t) {.name         = file->download_name,
+                                     .group        = "file",
+                                     .iterations   = 100,
+                                     .run          = bench_file_download,
+                                     .context      = file,
+                                     .bytes_per_op = file->size};
+  }
+
+  const bench_case_t apis[] = {
+      {"api_get_signal_quality_dbm", "api", 2000, bench_api_signal_quality},
+      {"api_get_sim_card_status", "api", 2000, bench_api_sim_card_status},
+      {"api_get_current_operator", "api", 2000, bench_api_current_operator},
+      {"api_is_pdp_context_active", "api", 2000, bench_api_pdp_active},
+      {"api_mqtt_query_connection_state", "api", 2000, bench_api_mqtt_state},
+      {"api_mqtt_publish_256B", "api", 500, bench_publish, NULL, &s_publish_cases[3], 256},
+      {"replay_session", "replay", 2000, bench_replay_session},
+  };
+  for (size_t i = 0; i < sizeof(apis) / sizeof(apis[0]) && count < max_cases; i++)
+  {
+    cases[count++] = apis[i];
+  }
+  return count;
+}
+
+void bench_sim_teardown(void)
+{
+  if (s_handle)
+  {
+    bg95_deinit(s_handle);
+    s_handle = NULL;
+  }
+  bg95_uart_replay_destroy(s_replay);
+  s_replay = NULL;
+  bg95_sim_destroy(s_sim);
+  s_sim = NULL;
+}
@@ -0,0 +1,499 @@
+// Benchmarks of the driver, built for the host (see host/CMakeLists.txt):
+//
+//   - parse / format / util / nmea: parsers, formatters and helpers on canned input (bench_codec.c)
+//   - round_trip / publish / api:   commands, MQTT publishes and driver APIs end to end over the
+//                                   simulator at a given baud rate and latency (bench_sim.c)
+//
+// Every case is warmed up, then run until its iteration count or the time budget is reached. Per
+// case the mean time per operation, the heap allocations per operation (counted by wrapping
+// malloc / calloc / realloc at link time), the peak stack of one operation (measured on a painted
+// thread stack, less what an empty operation uses) and, for payload cases, the throughput are
+// reported. A case that fails makes the exit code non-zero.
+//
+//   bg95_host_bench [--json] [--baud N] [--latency MS] [--budget MS] [filter]
+//
+//   --json        one JSON document on stdout instead of the table
+//   --baud N      line rate of the simulated modem (default 115200, 0 - not throttled)
+//   --latency MS  command to answer latency of the simulated modem (default 0)
+//   --budget MS   time budget per case (default 1000)
+//   filter        only the cases whose name or group contains 'filter'
+#include "bench.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_CASES 128
+#define BENCH_WARMUP_DIVISOR 10 // Warm up with 1/10 of the iterations ...
+#define BENCH_WARMUP_MAX_NS 100000000ULL // ... or for 100 ms at most
+#define BENCH_STACK_SIZE (1024 * 1024)
+#define BENCH_STACK_PAINT 0xA5
+
+typedef struct
+{
+  uint32_t baud;
+  uint32_t latency_ms;
+  uint32_t budget_ms;
+  bool     json;
+} bench_options_t;
+
+typedef struct
+{
+  uint32_t  iterations;
+  double    ns_per_op;
+  double    allocs_per_op;
+  double    alloc_bytes_per_op;
+  size_t    stack_bytes;
+  double    bytes_per_sec; // 0 - no payload
+  esp_err_t err;
+} bench_result_t;
+
+volatile int32_t g_bench_sink;
+
+static uint64_t now_ns(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+// ------------------------------ ALLOCATION COUNTING ---------------------------------
+
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc, so only calls from the driver, the
+// shim and the benchmarks get here - not the ones inside libc
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+static atomic_uint_fast64_t s_allocs;
+static atomic_uint_fast64_t s_alloc_bytes;
+static _Thread_local bool   s_alloc_paused;
+
+static void count_alloc(size_t size)
+{
+  if (!s_alloc_paused)
+  {
+    atomic_fetch_add_explicit(&s_allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&s_alloc_bytes, size, memory_order_relaxed);
+  }
+}
+
+void* __wrap_malloc(size_t size)
+{
+  count_alloc(size);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+  count_alloc(count * size);
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  count_alloc(size);
+  return __real_realloc(ptr, size);
+}
+
+void bench_alloc_pause(void)
+{
+  s_alloc_paused = true;
+}
+
+void bench_alloc_resume(void)
+{
+  s_alloc_paused = false;
+}
+
+// ------------------------------ STACK MEASUREMENT ---------------------------------
+
+typedef struct
+{
+  const bench_case_t* bench;
+  esp_err_t           err;
+} stack_run_t;
+
+static esp_err_t bench_noop(void* context)
+{
+  return ESP_OK;
+}
+
+static void* stack_thread(void* arg)
+{
+  stack_run_t* run = (stack_run_t*) arg;
+  run->err         = run->bench->run(run->bench->context);
+  return NULL;
+}
+
+// Bytes of a painted stack touched by one operation on a fresh thread (including what the thread
+// itself needs - see measure_stack)
+static size_t painted_stack_use(const bench_case_t* bench, esp_err_t* err)
+{
+  uint8_t* stack = malloc(BENCH_STACK_SIZE);
+  if (!stack)
+  {
+    *err = ESP_ERR_NO_MEM;
+    return 0;
+  }
+  memset(stack, BENCH_STACK_PAINT, BENCH_STACK_SIZE);
+
+  pthread_attr_t attr;
+  pthread_t      thread;
+  stack_run_t    run = {.bench = bench, .err = ESP_OK};
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, BENCH_STACK_SIZE);
+  if (pthread_create(&thread, &attr, stack_thread, &run) != 0)
+  {
+    run.err = ESP_FAIL;
+  }
+  else
+  {
+    pthread_join(thread, NULL);
+  }
+  pthread_attr_destroy(&attr);
+
+  // The stack grows down - the lowest byte that changed is the high water mark
+  size_t untouched = 0;
+  while (untouched < BENCH_STACK_SIZE && stack[untouched] == BENCH_STACK_PAINT)
+  {
+    untouched++;
+  }
+  free(stack);
+
+  *err = run.err;
+  return BENCH_STACK_SIZE - untouched;
+}
+
+static size_t measure_stack(const bench_case_t* bench, esp_err_t* err)
+{
+  static size_t baseline;
+  if (!baseline)
+  {
+    bench_case_t noop = {.name = "noop", .run = bench_noop};
+    esp_err_t    noop_err;
+    baseline = painted_stack_use(&noop, &noop_err);
+  }
+
+  size_t used = painted_stack_use(bench, err);
+  return used > baseline ? used - baseline : 0;
+}
+
+// ------------------------------ RUNNER ---------------------------------
+
+static esp_err_t warm_up(const bench_case_t* bench)
+{
+  uint64_t start = now_ns();
+  uint32_t count = bench->iterations / BENCH_WARMUP_DIVISOR;
+  for (uint32_t i = 0; i == 0 || (i < count && now_ns() - start < BENCH_WARMUP_MAX_NS); i++)
+  {
+    esp_err_t err = bench->run(bench->context);
+    if (err != ESP_OK)
+    {
+      return err;
+    }
+  }
+  return ESP_OK;
+}
+
+// Runs in chunks that double while they are short, so the clock is read rarely for fast cases and
+// a slow case stops close to the budget
+static esp_err_t timed_run(const bench_case_t* bench,
+                           uint64_t            budget_ns,
+                           uint32_t*           iterations,
+                           uint64_t*           elapsed_ns)
+{
+  esp_err_t err   = ESP_OK;
+  uint32_t  done  = 0;
+  uint32_t  chunk = 1;
+  uint64_t  start = now_ns();
+  uint64_t  now   = start;
+
+  while (done < bench->iterations && now - start < budget_ns && err == ESP_OK)
+  {
+    if (chunk > bench->iterations - done)
+    {
+      chunk = bench->iterations - done;
+    }
+
+    uint64_t chunk_start = now;
+    if (bench->run_batch)
+    {
+      err = bench->run_batch(bench->context, chunk);
+    }
+    else
+    {
+      for (uint32_t i = 0; i < chunk; i++)
+      {
+        esp_err_t run_err = bench->run(bench->context);
+        if (run_err != ESP_OK)
+        {
+          err = run_err;
+        }
+      }
+    }
+    done += chunk;
+    now = now_ns();
+
+    if (now - chunk_start < budget_ns / 16 && chunk < UINT32_MAX / 2)
+    {
+      chunk *= 2;
+    }
+  }
+
+  *iterations = done;
+  *elapsed_ns = now - start;
+  return err;
+}
+
+static void run_case(const bench_case_t* bench, const bench_options_t* options, bench_result_t* r)
+{
+  memset(r, 0, sizeof(*r));
+
+  r->err = warm_up(bench);
+  if (r->err != ESP_OK)
+  {
+    return;
+  }
+
+  uint64_t budget_ns = (uint64_t) options->budget_ms * 1000000ULL;
+  uint64_t elapsed_ns;
+  atomic_store(&s_allocs, 0);
+  atomic_store(&s_alloc_bytes, 0);
+  r->err = timed_run(bench, budget_ns, &r->iterations, &elapsed_ns);
+  uint64_t allocs      = atomic_load(&s_allocs);
+  uint64_t alloc_bytes = atomic_load(&s_alloc_bytes);
+  if (r->err != ESP_OK || r->iterations == 0)
+  {
+    return;
+  }
+
+  r->ns_per_op          = (double) elapsed_ns / r->iterations;
+  r->allocs_per_op      = (double) allocs / r->iterations;
+  r->alloc_bytes_per_op = (double) alloc_bytes / r->iterations;
+  if (bench->bytes_per_op && elapsed_ns)
+  {
+    r->bytes_per_sec = (double) bench->bytes_per_op * r->iterations * 1e9 / (double) elapsed_ns;
+  }
+
+  r->stack_bytes = measure_stack(bench, &r->err);
+}
+
+// ------------------------------ OUTPUT ---------------------------------
+
+static void print_table_header(const bench_options_t* options)
+{
+  printf("baud %lu, latency %lu ms, budget %lu ms per case\n\n",
+         (unsigned long) options->baud,
+         (unsigned long) options->latency_ms,
+         (unsigned long) options->budget_ms);
+  printf("%-34s %14s %10s %10s %10s %8s %12s\n",
+         "case",
+         "ns/op",
+         "iterations",
+         "allocs/op",
+         "B alloc/op",
+         "B stack",
+         "KiB/s");
+}
+
+static void print_table_row(const bench_case_t* bench, const bench_result_t* r)
+{
+  if (r->err != ESP_OK)
+  {
+    printf("%-34s FAILED: %s\n", bench->name, esp_err_to_name(r->err));
+    return;
+  }
+
+  printf("%-34s %14.1f %10lu %10.2f %10.1f %8zu",
+         bench->name,
+         r->ns_per_op,
+         (unsigned long) r->iterations,
+         r->allocs_per_op,
+         r->alloc_bytes_per_op,
+         r->stack_bytes);
+  if (r->bytes_per_sec > 0)
+  {
+    printf(" %12.1f", r->bytes_per_sec / 1024.0);
+  }
+  printf("\n");
+}
+
+static void print_json_header(const bench_options_t* options)
+{
+  printf("{\n  \"suite\": \"bg95_host_bench\",\n  \"version\": 1,\n");
+  printf("  \"config\": {\"baud\": %lu, \"latency_ms\": %lu, \"budget_ms\": %lu},\n",
+         (unsigned long) options->baud,
+         (unsigned long) options->latency_ms,
+         (unsigned long) options->budget_ms);
+  printf("  \"results\": [");
+}
+
+// Case and group names are plain identifiers, so nothing needs escaping
+static void print_json_row(const bench_case_t* bench, const bench_result_t* r, bool first)
+{
+  printf("%s\n    {\"name\": \"%s\", \"group\": \"%s\", \"status\": \"%s\"",
+         first ? "" : ",",
+         bench->name,
+         bench->group,
+         r->err == ESP_OK ? "ok" : esp_err_to_name(r->err));
+  if (r->err != ESP_OK)
+  {
+    printf("}");
+    return;
+  }
+
+  printf(", \"iterations\": %lu, \"ns_per_op\": %.1f, \"allocs_per_op\": %.3f"
+         ", \"alloc_bytes_per_op\": %.1f, \"stack_bytes\": %zu, \"bytes_per_sec\": ",
+         (unsigned long) r->iterations,
+         r->ns_per_op,
+         r->allocs_per_op,
+         r->alloc_bytes_per_op,
+         r->stack_bytes);
+  if (r->bytes_per_sec > 0)
+  {
+    printf("%.1f}", r->bytes_per_sec);
+  }
+  else
+  {
+    printf("null}");
+  }
+}
+
+// ------------------------------ MAIN ---------------------------------
+
+static bool parse_u32(const char* text, uint32_t* value)
+{
+  char*         end;
+  unsigned long parsed = strtoul(text, &end, 10);
+  if (end == text || *end != '\0' || parsed > UINT32_MAX)
+  {
+    return false;
+  }
+  *value = (uint32_t) parsed;
+  return true;
+}
+
+static bool selected(const bench_case_t* bench, const char* filter)
+{
+  return !filter || strstr(bench->name, filter) || strstr(bench->group, filter);
+}
+
+int main(int argc, char** argv)
+{
+  bench_options_t options = {.baud = 115200, .latency_ms = 0, .budget_ms = 1000, .json = false};
+  const char*     filter  = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool has_value = i + 1 < argc;
+    if (strcmp(argv[i], "--json") == 0)
+    {
+      options.json = true;
+    }
+    else if (strcmp(argv[i], "--baud") == 0 && has_value && parse_u32(argv[i + 1], &options.baud))
+    {
+      i++;
+    }
+    else if (strcmp(argv[i], "--latency") == 0 && has_value &&
+             parse_u32(argv[i + 1], &options.latency_ms))
+    {
+      i++;
+    }
+    else if (strcmp(argv[i], "--budget") == 0 && has_value &&
+             parse_u32(argv[i + 1], &options.budget_ms) && options.budget_ms > 0)
+    {
+      i++;
+    }
+    else if (argv[i][0] != '-' && !filter)
+    {
+      filter = argv[i];
+    }
+    else
+    {
+      fprintf(stderr,
+              "usage: %s [--json] [--baud N] [--latency MS] [--budget MS] [filter]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  // Logging would be most of what is measured
+  esp_log_level_set("*", ESP_LOG_NONE);
+
+  static bench_case_t cases[BENCH_MAX_CASES];
+  size_t              num_codec = bench_codec_cases(cases, BENCH_MAX_CASES);
+  size_t num_cases = num_codec + bench_sim_cases(cases + num_codec, BENCH_MAX_CASES - num_codec);
+
+  // The simulator only comes up if a case needs it
+  bool needs_sim = false;
+  for (size_t i = num_codec; i < num_cases; i++)
+  {
+    needs_sim = needs_sim || selected(&cases[i], filter);
+  }
+  if (needs_sim)
+  {
+    esp_err_t err = bench_sim_setup(options.baud, options.latency_ms);
+    if (err != ESP_OK)
+    {
+      fprintf(stderr, "Failed to set up the simulated modem: %s\n", esp_err_to_name(err));
+      bench_sim_teardown();
+      return 1;
+    }
+  }
+
+  if (options.json)
+  {
+    print_json_header(&options);
+  }
+  else
+  {
+    print_table_header(&options);
+  }
+
+  int  failed = 0;
+  bool first  = true;
+  for (size_t i = 0; i < num_cases; i++)
+  {
+    if (!selected(&cases[i], filter))
+    {
+      continue;
+    }
+
+    bench_result_t result;
+    run_case(&cases[i], &options, &result);
+    if (result.err != ESP_OK)
+    {
+      failed++;
+    }
+
+    if (options.json)
+    {
+      print_json_row(&cases[i], &result, first);
+    }
+    else
+    {
+      print_table_row(&cases[i], &result);
+    }
+    fflush(stdout);
+    first = false;
+  }
+
+  if (options.json)
+  {
+    printf("\n  ]\n}\n");
+  }
+  if (needs_sim)
+  {
+    bench_sim_teardown();
+  }
+  return failed ? 1 : 0;
+}
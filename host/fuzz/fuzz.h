@@ -0,0 +1,60 @@
+// Shared by the fuzz harnesses (see fuzz_main.c). Every harness defines the libFuzzer entry point
+// and its seeds - real BG95 responses, with the harness's selector bytes in front
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FUZZ_MAX_INPUT_LEN AT_CMD_MAX_RESPONSE_LEN // The handler never passes on more
+#define FUZZ_MAX_SEEDS 256
+
+typedef struct
+{
+  const at_cmd_t* cmd;
+  at_cmd_type_t   type;
+  size_t          response_size; // Of the struct the parser fills
+} fuzz_parser_t;
+
+typedef struct
+{
+  const at_cmd_t* cmd; // Command it answers
+  at_cmd_type_t   type;
+  const char*     text;
+} fuzz_response_t;
+
+typedef struct
+{
+  uint8_t data[FUZZ_MAX_INPUT_LEN];
+  size_t  len;
+} fuzz_seed_t;
+
+// Every at_cmd_type_info_t.parser, with the size of its response struct
+extern const fuzz_parser_t FUZZ_PARSERS[];
+extern const size_t        FUZZ_NUM_PARSERS;
+
+// All commands, for has_command_terminated
+extern const at_cmd_t* const FUZZ_COMMANDS[];
+extern const size_t          FUZZ_NUM_COMMANDS;
+
+// The seed corpus - responses as the module sends them, terminator included
+extern const fuzz_response_t FUZZ_RESPONSES[];
+extern const size_t          FUZZ_NUM_RESPONSES;
+
+// Tokens the mutator splices in
+extern const char* const FUZZ_DICTIONARY[];
+extern const size_t      FUZZ_DICTIONARY_SIZE;
+
+// Silences the driver's logging - a fuzzer feeds it malformed responses all the time
+int LLVMFuzzerInitialize(int* argc, char*** argv);
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// Seeds of the harness, up to 'max_seeds'
+size_t fuzz_harness_seeds(fuzz_seed_t* seeds, size_t max_seeds);
+
+// Name of the harness, for reports
+extern const char* const FUZZ_HARNESS_NAME;
+
+// NUL terminated heap copy of an input, sized exactly so reads past the end are caught
+char* fuzz_copy_input(const uint8_t* data, size_t size);
@@ -0,0 +1,331 @@
+// The parsers under fuzz, the command list and the seed corpus. The seeds are responses as a
+// BG95-M2 sends them (echo off), so the fuzzer starts from inputs that get deep into every parser
+#include "fuzz.h"
+
+#include "at_cmd_cedrxrdp.h"
+#include "at_cmd_cedrxs.h"
+#include "at_cmd_cereg.h"
+#include "at_cmd_cfun.h"
+#include "at_cmd_cgact.h"
+#include "at_cmd_cgatt.h"
+#include "at_cmd_cgdcont.h"
+#include "at_cmd_cgpaddr.h"
+#include "at_cmd_cmux.h"
+#include "at_cmd_cops.h"
+#include "at_cmd_cpin.h"
+#include "at_cmd_cpsms.h"
+#include "at_cmd_creg.h"
+#include "at_cmd_csq.h"
+#include "at_cmd_at.h"
+#include "at_cmd_ifc.h"
+#include "at_cmd_ipr.h"
+#include "at_cmd_qcfg.h"
+#include "at_cmd_qcsq.h"
+#include "at_cmd_qfclose.h"
+#include "at_cmd_qfdwl.h"
+#include "at_cmd_qfopen.h"
+#include "at_cmd_qfread.h"
+#include "at_cmd_qfseek.h"
+#include "at_cmd_qfwrite.h"
+#include "at_cmd_qgps.h"
+#include "at_cmd_qgpscfg.h"
+#include "at_cmd_qgpsend.h"
+#include "at_cmd_qgpsgnmea.h"
+#include "at_cmd_qgpsloc.h"
+#include "at_cmd_qhttpcfg.h"
+#include "at_cmd_qhttpget.h"
+#include "at_cmd_qhttpgetex.h"
+#include "at_cmd_qhttppost.h"
+#include "at_cmd_qhttpread.h"
+#include "at_cmd_qhttpurl.h"
+#include "at_cmd_qiclose.h"
+#include "at_cmd_qiopen.h"
+#include "at_cmd_qird.h"
+#include "at_cmd_qisend.h"
+#include "at_cmd_qmtcfg.h"
+#include "at_cmd_qmtclose.h"
+#include "at_cmd_qmtconn.h"
+#include "at_cmd_qmtdisc.h"
+#include "at_cmd_qmtopen.h"
+#include "at_cmd_qmtpub.h"
+#include "at_cmd_qmtsub.h"
+#include "at_cmd_qmtuns.h"
+#include "at_cmd_qnwinfo.h"
+#include "at_cmd_qsclk.h"
+#include "at_cmd_qsslcfg.h"
+#include "esp_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PARSER(name, TYPE, response_t)                                                             \
+  {                                                                                                \
+    &AT_CMD_##name, AT_CMD_TYPE_##TYPE, sizeof(response_t)                                         \
+  }
+
+#define RESPONSE(name, TYPE, response_text)                                                        \
+  {                                                                                                \
+    &AT_CMD_##name, AT_CMD_TYPE_##TYPE, response_text                                              \
+  }
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+
+// ------------------------------ PARSERS ---------------------------------
+const fuzz_parser_t FUZZ_PARSERS[] = {
+    // File
+    PARSER(QFDWL, WRITE, qfdwl_write_response_t),
+    PARSER(QFOPEN, WRITE, qfopen_write_response_t),
+    PARSER(QFWRITE, WRITE, qfwrite_write_response_t),
+    // General / hardware
+    PARSER(CFUN, READ, cfun_read_response_t),
+    PARSER(IFC, READ, ifc_read_response_t),
+    PARSER(IPR, READ, ipr_read_response_t),
+    PARSER(QSCLK, READ, qsclk_read_response_t),
+    // GNSS
+    PARSER(QGPS, READ, qgps_read_response_t),
+    PARSER(QGPSGNMEA, WRITE, qgpsgnmea_write_response_t),
+    PARSER(QGPSLOC, WRITE, qgpsloc_write_response_t),
+    // HTTP
+    PARSER(QHTTPGET, WRITE, qhttpget_write_response_t),
+    PARSER(QHTTPGETEX, WRITE, qhttpgetex_write_response_t),
+    PARSER(QHTTPPOST, WRITE, qhttppost_write_response_t),
+    PARSER(QHTTPREAD, WRITE, qhttpread_write_response_t),
+    // MQTT
+    PARSER(QMTCFG, TEST, qmtcfg_test_response_t),
+    PARSER(QMTCFG, WRITE, qmtcfg_write_response_t),
+    PARSER(QMTCLOSE, TEST, qmtclose_test_response_t),
+    PARSER(QMTCLOSE, WRITE, qmtclose_write_response_t),
+    PARSER(QMTCONN, TEST, qmtconn_test_response_t),
+    PARSER(QMTCONN, READ, qmtconn_read_response_t),
+    PARSER(QMTCONN, WRITE, qmtconn_write_response_t),
+    PARSER(QMTDISC, TEST, qmtdisc_test_response_t),
+    PARSER(QMTDISC, WRITE, qmtdisc_write_response_t),
+    PARSER(QMTOPEN, READ, qmtopen_read_response_t),
+    PARSER(QMTOPEN, WRITE, qmtopen_write_response_t),
+    PARSER(QMTPUB, WRITE, qmtpub_write_response_t),
+    PARSER(QMTSUB, TEST, qmtsub_test_response_t),
+    PARSER(QMTSUB, WRITE, qmtsub_write_response_t),
+    PARSER(QMTUNS, TEST, qmtuns_test_response_t),
+    PARSER(QMTUNS, WRITE, qmtuns_write_response_t),
+    // Network service
+    PARSER(CEDRXRDP, EXECUTE, cedrxrdp_execute_response_t),
+    PARSER(CEDRXS, READ, cedrxs_read_response_t),
+    PARSER(CEREG, READ, cereg_read_response_t),
+    PARSER(COPS, TEST, cops_test_response_t),
+    PARSER(COPS, READ, cops_read_response_t),
+    PARSER(CPSMS, READ, cpsms_read_response_t),
+    PARSER(CREG, TEST, creg_test_response_t),
+    PARSER(CREG, READ, creg_read_response_t),
+    PARSER(CSQ, TEST, csq_test_response_t),
+    PARSER(CSQ, EXECUTE, csq_execute_response_t),
+    PARSER(QCFG, WRITE, qcfg_write_response_t),
+    PARSER(QCSQ, TEST, qcsq_test_response_t),
+    PARSER(QCSQ, EXECUTE, qcsq_execute_response_t),
+    PARSER(QNWINFO, EXECUTE, qnwinfo_execute_response_t),
+    // Packet domain / SIM
+    PARSER(CGACT, READ, cgact_read_response_t),
+    PARSER(CGATT, READ, cgatt_read_params_t),
+    PARSER(CGDCONT, READ, cgdcont_read_response_t),
+    PARSER(CGPADDR, WRITE, cgpaddr_write_response_t),
+    PARSER(CPIN, READ, cpin_read_response_t),
+    // TCP/IP
+    PARSER(QIOPEN, WRITE, qiopen_write_response_t),
+    PARSER(QIRD, WRITE, qird_write_response_t),
+};
+const size_t FUZZ_NUM_PARSERS = ARRAY_SIZE(FUZZ_PARSERS);
+
+// ------------------------------ COMMANDS ---------------------------------
+const at_cmd_t* const FUZZ_COMMANDS[] = {
+    &AT_CMD_QFCLOSE,  &AT_CMD_QFDWL,      &AT_CMD_QFOPEN,    &AT_CMD_QFREAD,   &AT_CMD_QFSEEK,
+    &AT_CMD_QFWRITE,  &AT_CMD_AT,         &AT_CMD_CFUN,      &AT_CMD_QGPS,     &AT_CMD_QGPSCFG,
+    &AT_CMD_QGPSEND,  &AT_CMD_QGPSGNMEA,  &AT_CMD_QGPSLOC,   &AT_CMD_CMUX,     &AT_CMD_IFC,
+    &AT_CMD_IPR,      &AT_CMD_QSCLK,      &AT_CMD_QHTTPCFG,  &AT_CMD_QHTTPGET, &AT_CMD_QHTTPGETEX,
+    &AT_CMD_QHTTPPOST, &AT_CMD_QHTTPREAD, &AT_CMD_QHTTPURL,  &AT_CMD_QMTCFG,   &AT_CMD_QMTCLOSE,
+    &AT_CMD_QMTCONN,  &AT_CMD_QMTDISC,    &AT_CMD_QMTOPEN,   &AT_CMD_QMTPUB,   &AT_CMD_QMTSUB,
+    &AT_CMD_QMTUNS,   &AT_CMD_CEDRXRDP,   &AT_CMD_CEDRXS,    &AT_CMD_CEREG,    &AT_CMD_COPS,
+    &AT_CMD_CPSMS,    &AT_CMD_CREG,       &AT_CMD_CSQ,       &AT_CMD_QCFG,     &AT_CMD_QCSQ,
+    &AT_CMD_QNWINFO,  &AT_CMD_CGACT,      &AT_CMD_CGATT,     &AT_CMD_CGDCONT,  &AT_CMD_CGPADDR,
+    &AT_CMD_CPIN,     &AT_CMD_QSSLCFG,    &AT_CMD_QICLOSE,   &AT_CMD_QIOPEN,   &AT_CMD_QIRD,
+    &AT_CMD_QISEND,
+};
+const size_t FUZZ_NUM_COMMANDS = ARRAY_SIZE(FUZZ_COMMANDS);
+
+// ------------------------------ SEEDS ---------------------------------
+const fuzz_response_t FUZZ_RESPONSES[] = {
+    // File
+    RESPONSE(QFDWL, WRITE, "\r\nCONNECT\r\n0123456789\r\n+QFDWL: 10,613e\r\n\r\nOK\r\n"),
+    RESPONSE(QFOPEN, WRITE, "\r\n+QFOPEN: 1027\r\n\r\nOK\r\n"),
+    RESPONSE(QFWRITE, WRITE, "\r\n+QFWRITE: 10,10\r\n\r\nOK\r\n"),
+    // General / hardware
+    RESPONSE(CFUN, READ, "\r\n+CFUN: 1\r\n\r\nOK\r\n"),
+    RESPONSE(IFC, READ, "\r\n+IFC: 2,2\r\n\r\nOK\r\n"),
+    RESPONSE(IPR, READ, "\r\n+IPR: 115200\r\n\r\nOK\r\n"),
+    RESPONSE(QSCLK, READ, "\r\n+QSCLK: 1\r\n\r\nOK\r\n"),
+    // GNSS
+    RESPONSE(QGPS, READ, "\r\n+QGPS: 1\r\n\r\nOK\r\n"),
+    RESPONSE(QGPSGNMEA,
+             WRITE,
+             "\r\n+QGPSGNMEA: $GPGGA,103647.00,3150.721154,N,11711.925873,E,1,02,4.7,59.8,M,-2.0,M"
+             ",,*7A\r\n\r\nOK\r\n"),
+    RESPONSE(QGPSGNMEA,
+             WRITE,
+             "\r\n+QGPSGNMEA: $GPGSV,3,1,11,10,63,137,17,07,61,320,,08,57,004,,27,41,067,*7B\r\n"
+             "+QGPSGNMEA: $GPGSV,3,2,11,16,31,203,,20,19,261,,30,12,057,,01,09,105,*79\r\n"
+             "+QGPSGNMEA: $GPGSV,3,3,11,21,07,306,,03,04,189,,23,02,021,*4C\r\n\r\nOK\r\n"),
+    RESPONSE(QGPSLOC,
+             WRITE,
+             "\r\n+QGPSLOC: 061951.000,3150.7223N,11711.9293E,0.7,62.2,2,0.00,0.0,0.0,110513,09\r\n"
+             "\r\nOK\r\n"),
+    RESPONSE(QGPSLOC,
+             WRITE,
+             "\r\n+QGPSLOC: 061951.0,31.84537,117.19882,0.7,62.2,3,0.00,0.0,0.0,110513,09\r\n"
+             "\r\nOK\r\n"),
+    RESPONSE(QGPSLOC, WRITE, "\r\n+CME ERROR: 516\r\n"),
+    // HTTP
+    RESPONSE(QHTTPGET, WRITE, "\r\nOK\r\n\r\n+QHTTPGET: 0,200,1024\r\n"),
+    RESPONSE(QHTTPGET, WRITE, "\r\nOK\r\n\r\n+QHTTPGET: 702\r\n"),
+    RESPONSE(QHTTPGETEX, WRITE, "\r\nOK\r\n\r\n+QHTTPGETEX: 0,206,100\r\n"),
+    RESPONSE(QHTTPPOST, WRITE, "\r\nOK\r\n\r\n+QHTTPPOST: 0,200,17\r\n"),
+    RESPONSE(QHTTPREAD,
+             WRITE,
+             "\r\nCONNECT\r\n{\"status\":\"ok\"}\r\nOK\r\n\r\n+QHTTPREAD: 0\r\n"),
+    // MQTT
+    RESPONSE(QMTCFG,
+             TEST,
+             "\r\n+QMTCFG: \"version\",(0-5),(3,4)\r\n"
+             "+QMTCFG: \"pdpcid\",(0-5),(1-16)\r\n"
+             "+QMTCFG: \"ssl\",(0-5),(0,1),(0-5)\r\n"
+             "+QMTCFG: \"keepalive\",(0-5),(0-3600)\r\n"
+             "+QMTCFG: \"session\",(0-5),(0,1)\r\n"
+             "+QMTCFG: \"timeout\",(0-5),(1-60),(0-10),(0,1)\r\n"
+             "+QMTCFG: \"will\",(0-5),(0,1),(0-2),(0,1),\"will_topic\",\"will_msg\"\r\n"
+             "+QMTCFG: \"recv/mode\",(0-5),(0,1),(0,1)\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCFG,
+             WRITE,
+             "\r\n+QMTCFG: \"will\",1,1,2,1,\"devices/bg95/status\",\"offline, unexpectedly\"\r\n"
+             "\r\nOK\r\n"),
+    RESPONSE(QMTCFG, WRITE, "\r\n+QMTCFG: \"will\",0\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCFG, WRITE, "\r\n+QMTCFG: \"version\",4\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCFG, WRITE, "\r\n+QMTCFG: \"keepalive\",120\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCFG, WRITE, "\r\n+QMTCFG: \"timeout\",5,3,0\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCFG, WRITE, "\r\n+QMTCFG: \"recv/mode\",0,1\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCLOSE, TEST, "\r\n+QMTCLOSE: (0-5)\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCLOSE, WRITE, "\r\nOK\r\n\r\n+QMTCLOSE: 0,0\r\n"),
+    RESPONSE(QMTCONN,
+             TEST,
+             "\r\n+QMTCONN: (0-5),\"clientID\",\"username\",\"password\"\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCONN, READ, "\r\n+QMTCONN: 0,3\r\n\r\nOK\r\n"),
+    RESPONSE(QMTCONN, WRITE, "\r\nOK\r\n\r\n+QMTCONN: 0,0,0\r\n"),
+    RESPONSE(QMTDISC, TEST, "\r\n+QMTDISC: (0-5)\r\n\r\nOK\r\n"),
+    RESPONSE(QMTDISC, WRITE, "\r\nOK\r\n\r\n+QMTDISC: 0,0\r\n"),
+    RESPONSE(QMTOPEN, READ, "\r\n+QMTOPEN: 0,\"test.mosquitto.org\",1883\r\n\r\nOK\r\n"),
+    RESPONSE(QMTOPEN, WRITE, "\r\nOK\r\n\r\n+QMTOPEN: 0,0\r\n"),
+    RESPONSE(QMTOPEN, WRITE, "\r\nOK\r\n\r\n+QMTOPEN: 0,-1\r\n"),
+    RESPONSE(QMTPUB, WRITE, "\r\nOK\r\n\r\n+QMTPUB: 0,1,0\r\n"),
+    RESPONSE(QMTPUB, WRITE, "\r\nOK\r\n\r\n+QMTPUB: 0,1,1,2\r\n"),
+    RESPONSE(QMTSUB,
+             TEST,
+             "\r\n+QMTSUB: (0-5),(1-65535),\"topic\",(0-2)\r\n\r\nOK\r\n"),
+    RESPONSE(QMTSUB, WRITE, "\r\nOK\r\n\r\n+QMTSUB: 0,1,0,1\r\n"),
+    RESPONSE(QMTSUB, WRITE, "\r\nOK\r\n\r\n+QMTSUB: 0,1,0,128\r\n"),
+    RESPONSE(QMTUNS, TEST, "\r\n+QMTUNS: (0-5),(1-65535),\"topic\"\r\n\r\nOK\r\n"),
+    RESPONSE(QMTUNS, WRITE, "\r\nOK\r\n\r\n+QMTUNS: 0,2,0\r\n"),
+    // Network service
+    RESPONSE(CEDRXRDP,
+             EXECUTE,
+             "\r\n+CEDRXRDP: 4,\"0010\",\"0010\",\"0011\"\r\n\r\nOK\r\n"),
+    RESPONSE(CEDRXRDP, EXECUTE, "\r\n+CEDRXRDP: 0\r\n\r\nOK\r\n"),
+    RESPONSE(CEDRXS,
+             READ,
+             "\r\n+CEDRXS: 4,\"0010\"\r\n+CEDRXS: 5,\"1001\"\r\n\r\nOK\r\n"),
+    RESPONSE(CEREG, READ, "\r\n+CEREG: 0,1\r\n\r\nOK\r\n"),
+    RESPONSE(CEREG,
+             READ,
+             "\r\n+CEREG: 4,5,\"3A9C\",\"0B3E5C01\",9,,,\"00000001\",\"00100011\"\r\n\r\nOK\r\n"),
+    RESPONSE(COPS,
+             TEST,
+             "\r\n+COPS: (2,\"CHINA MOBILE\",\"CMCC\",\"46000\",8),(1,\"CHN-UNICOM\",\"UNICOM\","
+             "\"46001\",8),(3,\"Vodafone\",\"voda\",\"26202\",9),,(0-4),(0-2)\r\n\r\nOK\r\n"),
+    RESPONSE(COPS, READ, "\r\n+COPS: 0,0,\"CHINA MOBILE\",8\r\n\r\nOK\r\n"),
+    RESPONSE(COPS, READ, "\r\n+COPS: 1,2,\"46000\",9\r\n\r\nOK\r\n"),
+    RESPONSE(COPS, READ, "\r\n+COPS: 0\r\n\r\nOK\r\n"),
+    RESPONSE(CPSMS,
+             READ,
+             "\r\n+CPSMS: 1,,,\"00000100\",\"00001111\"\r\n\r\nOK\r\n"),
+    RESPONSE(CREG, TEST, "\r\n+CREG: (0-2)\r\n\r\nOK\r\n"),
+    RESPONSE(CREG, READ, "\r\n+CREG: 2,1,\"3A9C\",\"0B3E5C01\",8\r\n\r\nOK\r\n"),
+    RESPONSE(CREG, READ, "\r\n+CREG: 0,3\r\n\r\nOK\r\n"),
+    RESPONSE(CSQ, TEST, "\r\n+CSQ: (0-31,99),(0-7,99)\r\n\r\nOK\r\n"),
+    RESPONSE(CSQ, EXECUTE, "\r\n+CSQ: 24,99\r\n\r\nOK\r\n"),
+    RESPONSE(QCFG,
+             WRITE,
+             "\r\n+QCFG: \"band\",0xf,0x100002000000000f0e189f,0x10004200000000090e189f\r\n"
+             "\r\nOK\r\n"),
+    RESPONSE(QCFG, WRITE, "\r\n+QCFG: \"iotopmode\",0\r\n\r\nOK\r\n"),
+    RESPONSE(QCFG, WRITE, "\r\n+QCFG: \"nwscanseq\",020301\r\n\r\nOK\r\n"),
+    RESPONSE(QCFG, WRITE, "\r\n+QCFG: \"nwscanmode\",3\r\n\r\nOK\r\n"),
+    RESPONSE(QCSQ,
+             TEST,
+             "\r\n+QCSQ: \"NOSERVICE\",\"GSM\",\"eMTC\",\"NBIoT\"\r\n\r\nOK\r\n"),
+    RESPONSE(QCSQ, EXECUTE, "\r\n+QCSQ: \"eMTC\",-67,-93,154,-9\r\n\r\nOK\r\n"),
+    RESPONSE(QCSQ, EXECUTE, "\r\n+QCSQ: \"NOSERVICE\"\r\n\r\nOK\r\n"),
+    RESPONSE(QNWINFO,
+             EXECUTE,
+             "\r\n+QNWINFO: \"eMTC\",\"26202\",\"LTE BAND 20\",6300\r\n\r\nOK\r\n"),
+    RESPONSE(QNWINFO, EXECUTE, "\r\n+QNWINFO: No Service\r\n\r\nOK\r\n"),
+    // Packet domain / SIM
+    RESPONSE(CGACT, READ, "\r\n+CGACT: 1,1\r\n+CGACT: 2,0\r\n+CGACT: 3,0\r\n\r\nOK\r\n"),
+    RESPONSE(CGATT, READ, "\r\n+CGATT: 1\r\n\r\nOK\r\n"),
+    RESPONSE(CGDCONT,
+             READ,
+             "\r\n+CGDCONT: 1,\"IP\",\"iot.1nce.net\",\"10.212.14.2\",0,0,0,0\r\n"
+             "+CGDCONT: 2,\"IPV4V6\",\"ims\",\"0.0.0.0.0.0.0.0.0.0.0.0.0.0.0.0\",0,0,0,0\r\n"
+             "+CGDCONT: 3,\"IPV6\",\"\",\"\",0,0,0,0\r\n\r\nOK\r\n"),
+    RESPONSE(CGDCONT, READ, "\r\n+CGDCONT: 1,\"IP\",\"internet\",\"0.0.0.0\",0,0\r\n\r\nOK\r\n"),
+    RESPONSE(CGPADDR, WRITE, "\r\n+CGPADDR: 1,\"10.212.14.2\"\r\n\r\nOK\r\n"),
+    RESPONSE(CPIN, READ, "\r\n+CPIN: READY\r\n\r\nOK\r\n"),
+    RESPONSE(CPIN, READ, "\r\n+CPIN: SIM PIN\r\n\r\nOK\r\n"),
+    RESPONSE(CPIN, READ, "\r\n+CME ERROR: 10\r\n"),
+    // TCP/IP
+    RESPONSE(QIOPEN, WRITE, "\r\nOK\r\n\r\n+QIOPEN: 0,0\r\n"),
+    RESPONSE(QIOPEN, WRITE, "\r\nOK\r\n\r\n+QIOPEN: 1,566\r\n"),
+    RESPONSE(QIRD, WRITE, "\r\n+QIRD: 12\r\nHello\r\nWorld\r\n\r\nOK\r\n"),
+    RESPONSE(QIRD, WRITE, "\r\n+QIRD: 0\r\n\r\nOK\r\n"),
+    // Plain terminators, for the commands without a data response
+    RESPONSE(AT, EXECUTE, "\r\nOK\r\n"),
+    RESPONSE(QISEND, WRITE, "\r\n> \r\nSEND OK\r\n"),
+    RESPONSE(QISEND, WRITE, "\r\n> \r\nSEND FAIL\r\n"),
+    RESPONSE(QHTTPURL, WRITE, "\r\nCONNECT\r\n\r\nOK\r\n"),
+    RESPONSE(QFCLOSE, WRITE, "\r\nERROR\r\n"),
+};
+const size_t FUZZ_NUM_RESPONSES = ARRAY_SIZE(FUZZ_RESPONSES);
+
+// ------------------------------ DICTIONARY ---------------------------------
+const char* const FUZZ_DICTIONARY[] = {
+    ",",           "\"",          "\r\n",        "\r\n\r\nOK\r\n", "OK",         "ERROR",
+    "+CME ERROR: ", "SEND OK",    ": ",          "(",              ")",          "-",
+    "0x",          ",,",          "\"\"",        "\"will\"",       "\"band\"",   "No Service",
+    "READY",       "CONNECT\r\n", "0",           "1",              "65535",      "4294967295",
+    "4294967296",  "2147483648",  "-2147483649", "99999999999999999999",
+};
+const size_t FUZZ_DICTIONARY_SIZE = ARRAY_SIZE(FUZZ_DICTIONARY);
+
+// ------------------------------ HELPERS ---------------------------------
+int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+  (void) argc;
+  (void) argv;
+  esp_log_level_set("*", ESP_LOG_NONE);
+  return 0;
+}
+
+char* fuzz_copy_input(const uint8_t* data, size_t size)
+{
+  char* copy = malloc(size + 1);
+  if (copy)
+  {
+    memcpy(copy, data, size);
+    copy[size] = '\0';
+  }
+  return copy;
+}
@@ -0,0 +1,425 @@
+// Standalone driver for the fuzz harnesses, for compilers without libFuzzer (with clang the same
+// harnesses are also built against -fsanitize=fuzzer, see host/CMakeLists.txt):
+//
+//   bg95_fuzz_<harness> [--runs N] [--seconds S] [--seed X] [--write-corpus DIR] [files...]
+//
+//   files           run each file once and exit - e.g. a crash to reproduce, or AFL's '@@'
+//   --runs N        stop after N inputs (default: no limit)
+//   --seconds S     stop after S seconds (default: 10, when --runs is not given either)
+//   --seed X        seed of the mutator, to repeat a run
+//   --write-corpus  write the seeds to DIR, one file each - the starting corpus for libFuzzer / AFL
+//
+// Without files the seeds are run first, then random mutations of them (bit flips, byte changes,
+// inserts, deletes, repeats, dictionary tokens, splices of two seeds). Execs/s are reported every
+// second and at the end. An input that crashes, aborts or trips a sanitizer is written to
+// crash-<harness>-<n> in the working directory
+#include "fuzz.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPORT_INTERVAL_NS 1000000000ULL
+#define DEFAULT_SECONDS 10
+#define MAX_MUTATIONS 8 // Stacked on one input
+
+typedef struct
+{
+  uint64_t runs;
+  uint64_t seconds;
+  uint64_t seed;
+  bool     seed_set;
+  char*    corpus_dir;
+} fuzz_options_t;
+
+static fuzz_seed_t s_seeds[FUZZ_MAX_SEEDS];
+static size_t      s_num_seeds;
+
+// The input being run, for the crash handlers
+static uint8_t s_input[FUZZ_MAX_INPUT_LEN];
+static size_t  s_input_len;
+
+// ------------------------------ HELPERS ---------------------------------
+static uint64_t now_ns(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+// xorshift64* - fast, and a run can be repeated from its seed
+static uint64_t s_rng;
+
+static uint64_t rng_next(void)
+{
+  s_rng ^= s_rng >> 12;
+  s_rng ^= s_rng << 25;
+  s_rng ^= s_rng >> 27;
+  return s_rng * 0x2545F4914F6CDD1DULL;
+}
+
+static size_t rng_below(size_t limit)
+{
+  return limit ? (size_t) (rng_next() % limit) : 0;
+}
+
+// ------------------------------ CRASHES ---------------------------------
+// Only async-signal-safe calls from here on
+static void write_crash(void)
+{
+  static volatile sig_atomic_t written;
+  if (written)
+  {
+    return;
+  }
+  written = 1;
+
+  char path[64] = "crash-";
+  strncat(path, FUZZ_HARNESS_NAME, sizeof(path) - sizeof("crash-") - 12);
+  size_t end = strlen(path);
+  path[end++] = '-';
+  unsigned pid = (unsigned) getpid();
+  char     digits[12];
+  size_t   n = 0;
+  do
+  {
+    digits[n++] = (char) ('0' + pid % 10);
+    pid /= 10;
+  } while (pid && n < sizeof(digits));
+  while (n)
+  {
+    path[end++] = digits[--n];
+  }
+  path[end] = '\0';
+
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd >= 0)
+  {
+    ssize_t ignored = write(fd, s_input, s_input_len);
+    (void) ignored;
+    close(fd);
+  }
+  static const char NOTE[] = "\n==== input written to ";
+  ssize_t           ignored;
+  ignored = write(STDERR_FILENO, NOTE, sizeof(NOTE) - 1);
+  ignored = write(STDERR_FILENO, path, strlen(path));
+  ignored = write(STDERR_FILENO, "\n", 1);
+  (void) ignored;
+}
+
+static void crash_signal_handler(int signal_number)
+{
+  write_crash();
+  signal(signal_number, SIG_DFL);
+  raise(signal_number);
+}
+
+// Set by the sanitizer runtime when it is linked in
+void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+static void install_crash_handlers(void)
+{
+  static const int SIGNALS[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+  for (size_t i = 0; i < sizeof(SIGNALS) / sizeof(SIGNALS[0]); i++)
+  {
+    signal(SIGNALS[i], crash_signal_handler);
+  }
+  if (__sanitizer_set_death_callback)
+  {
+    __sanitizer_set_death_callback(write_crash);
+  }
+}
+
+// ------------------------------ RUNNING ---------------------------------
+static void run_input(const uint8_t* data, size_t len)
+{
+  if (data != s_input)
+  {
+    memcpy(s_input, data, len);
+  }
+  s_input_len = len;
+  LLVMFuzzerTestOneInput(s_input, len);
+}
+
+static void insert_bytes(size_t* len, size_t at, const uint8_t* bytes, size_t count)
+{
+  if (*len + count > FUZZ_MAX_INPUT_LEN)
+  {
+    count = FUZZ_MAX_INPUT_LEN - *len;
+  }
+  memmove(&s_input[at + count], &s_input[at], *len - at);
+  memcpy(&s_input[at], bytes, count);
+  *len += count;
+}
+
+// Mutates s_input in place, returns the new length
+static size_t mutate(size_t len)
+{
+  size_t mutations = 1 + rng_below(MAX_MUTATIONS);
+  for (size_t m = 0; m < mutations; m++)
+  {
+    size_t at = rng_below(len + 1);
+    switch (rng_below(7))
+    {
+      case 0: // Flip a bit
+        if (len)
+        {
+          s_input[rng_below(len)] ^= (uint8_t) (1U << rng_below(8));
+        }
+        break;
+
+      case 1: // Change a byte - digits and separators more often than not
+        if (len)
+        {
+          static const char INTERESTING[] = "0123456789,\"\r\n:()-+ ";
+          s_input[rng_below(len)] = (rng_next() & 1)
+                                        ? (uint8_t) INTERESTING[rng_below(sizeof(INTERESTING) - 1)]
+                                        : (uint8_t) rng_next();
+        }
+        break;
+
+      case 2: // Insert a byte
+      {
+        uint8_t byte = (uint8_t) rng_next();
+        insert_bytes(&len, at, &byte, 1);
+        break;
+      }
+
+      case 3: // Delete a range
+        if (len)
+        {
+          size_t from  = rng_below(len);
+          size_t count = 1 + rng_below(len - from < 16 ? len - from : 16);
+          memmove(&s_input[from], &s_input[from + count], len - from - count);
+          len -= count;
+        }
+        break;
+
+      case 4: // Repeat a range - long fields and many lines
+        if (len)
+        {
+          uint8_t copy[64];
+          size_t  from  = rng_below(len);
+          size_t  count = 1 + rng_below(len - from < sizeof(copy) ? len - from : sizeof(copy));
+          size_t  times = 1 + rng_below(16);
+          memcpy(copy, &s_input[from], count);
+          for (size_t t = 0; t < times; t++)
+          {
+            insert_bytes(&len, from, copy, count);
+          }
+        }
+        break;
+
+      case 5: // Dictionary token
+      {
+        const char* token = FUZZ_DICTIONARY[rng_below(FUZZ_DICTIONARY_SIZE)];
+        insert_bytes(&len, at, (const uint8_t*) token, strlen(token));
+        break;
+      }
+
+      default: // Splice in part of another seed
+      {
+        const fuzz_seed_t* other = &s_seeds[rng_below(s_num_seeds)];
+        if (other->len)
+        {
+          size_t from = rng_below(other->len);
+          insert_bytes(&len, at, &other->data[from], 1 + rng_below(other->len - from));
+        }
+        break;
+      }
+    }
+  }
+  return len;
+}
+
+static void report(const char* label, uint64_t execs, uint64_t bytes, uint64_t start_ns)
+{
+  double seconds = (now_ns() - start_ns) / 1e9;
+  if (seconds <= 0)
+  {
+    seconds = 1e-9;
+  }
+  printf("%-6s %-16s %12" PRIu64 " execs %10.0f execs/s %8.2f MB/s %7.1f s\n",
+         label,
+         FUZZ_HARNESS_NAME,
+         execs,
+         execs / seconds,
+         bytes / seconds / 1e6,
+         seconds);
+  fflush(stdout);
+}
+
+static int run_files(char** paths, int count)
+{
+  int failures = 0;
+  for (int i = 0; i < count; i++)
+  {
+    FILE* file = fopen(paths[i], "rb");
+    if (!file)
+    {
+      perror(paths[i]);
+      failures++;
+      continue;
+    }
+    size_t len = fread(s_input, 1, sizeof(s_input), file);
+    fclose(file);
+    run_input(s_input, len);
+  }
+  printf("%s: ran %d input(s)\n", FUZZ_HARNESS_NAME, count - failures);
+  return failures ? 1 : 0;
+}
+
+static int write_corpus(const char* dir)
+{
+  if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+  {
+    perror(dir);
+    return 1;
+  }
+  for (size_t i = 0; i < s_num_seeds; i++)
+  {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/seed-%03zu", dir, i);
+    FILE* file = fopen(path, "wb");
+    if (!file || fwrite(s_seeds[i].data, 1, s_seeds[i].len, file) != s_seeds[i].len)
+    {
+      perror(path);
+      if (file)
+      {
+        fclose(file);
+      }
+      return 1;
+    }
+    fclose(file);
+  }
+  printf("%s: %zu seeds written to %s\n", FUZZ_HARNESS_NAME, s_num_seeds, dir);
+  return 0;
+}
+
+static void fuzz(const fuzz_options_t* options)
+{
+  uint64_t start_ns    = now_ns();
+  uint64_t deadline_ns = options->seconds ? start_ns + options->seconds * 1000000000ULL : 0;
+  uint64_t report_ns   = start_ns + REPORT_INTERVAL_NS;
+  uint64_t execs       = 0;
+  uint64_t bytes       = 0;
+
+  for (size_t i = 0; i < s_num_seeds; i++)
+  {
+    run_input(s_seeds[i].data, s_seeds[i].len);
+    execs++;
+    bytes += s_seeds[i].len;
+  }
+
+  while (!options->runs || execs < options->runs)
+  {
+    const fuzz_seed_t* seed = &s_seeds[rng_below(s_num_seeds)];
+    memcpy(s_input, seed->data, seed->len);
+    size_t len = mutate(seed->len);
+    run_input(s_input, len);
+    execs++;
+    bytes += len;
+
+    // The clock is only read every so often, it would cost more than a short input
+    if ((execs & 0x3FF) == 0)
+    {
+      uint64_t now = now_ns();
+      if (deadline_ns && now >= deadline_ns)
+      {
+        break;
+      }
+      if (now >= report_ns)
+      {
+        report("#", execs, bytes, start_ns);
+        report_ns = now + REPORT_INTERVAL_NS;
+      }
+    }
+  }
+  report("done", execs, bytes, start_ns);
+}
+
+// ------------------------------ MAIN ---------------------------------
+static void usage(const char* name)
+{
+  fprintf(stderr,
+          "usage: %s [--runs N] [--seconds S] [--seed X] [--write-corpus DIR] [files...]\n",
+          name);
+}
+
+int main(int argc, char** argv)
+{
+  fuzz_options_t options = {0};
+  int            first_file;
+  for (first_file = 1; first_file < argc; first_file++)
+  {
+    const char* arg   = argv[first_file];
+    const char* value = (first_file + 1 < argc) ? argv[first_file + 1] : NULL;
+    if (strncmp(arg, "--", 2) != 0)
+    {
+      break;
+    }
+    if (!value)
+    {
+      usage(argv[0]);
+      return 2;
+    }
+    if (strcmp(arg, "--runs") == 0)
+    {
+      options.runs = strtoull(value, NULL, 0);
+    }
+    else if (strcmp(arg, "--seconds") == 0)
+    {
+      options.seconds = strtoull(value, NULL, 0);
+    }
+    else if (strcmp(arg, "--seed") == 0)
+    {
+      options.seed     = strtoull(value, NULL, 0);
+      options.seed_set = true;
+    }
+    else if (strcmp(arg, "--write-corpus") == 0)
+    {
+      options.corpus_dir = argv[first_file + 1];
+    }
+    else
+    {
+      usage(argv[0]);
+      return 2;
+    }
+    first_file++;
+  }
+
+  LLVMFuzzerInitialize(&argc, &argv);
+  s_num_seeds = fuzz_harness_seeds(s_seeds, FUZZ_MAX_SEEDS);
+  if (options.corpus_dir)
+  {
+    return write_corpus(options.corpus_dir);
+  }
+
+  install_crash_handlers();
+  if (first_file < argc)
+  {
+    return run_files(&argv[first_file], argc - first_file);
+  }
+
+  if (!options.runs && !options.seconds)
+  {
+    options.seconds = DEFAULT_SECONDS;
+  }
+  if (!options.seed_set)
+  {
+    options.seed = now_ns() ^ ((uint64_t) getpid() << 32);
+  }
+  s_rng = options.seed ? options.seed : 1;
+  printf("%s: %zu seeds, seed %" PRIu64 "\n", FUZZ_HARNESS_NAME, s_num_seeds, options.seed);
+
+  fuzz(&options);
+  return 0;
+}
@@ -0,0 +1,52 @@
+// at_cmd_parse_response - the split into basic and data response every command goes through
+#include "fuzz.h"
+
+#include "at_cmd_parser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const char* const FUZZ_HARNESS_NAME = "parse_response";
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+  if (size > FUZZ_MAX_INPUT_LEN)
+  {
+    return 0;
+  }
+
+  char* response = fuzz_copy_input(data, size);
+  if (response)
+  {
+    at_parsed_response_t parsed;
+    if (at_cmd_parse_response(response, &parsed) == ESP_OK && parsed.has_data_response)
+    {
+      // The data response has to lie within the input
+      if (parsed.data_response < response ||
+          parsed.data_response + parsed.data_response_len > response + size)
+      {
+        abort();
+      }
+    }
+  }
+
+  free(response);
+  return 0;
+}
+
+size_t fuzz_harness_seeds(fuzz_seed_t* seeds, size_t max_seeds)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < FUZZ_NUM_RESPONSES && count < max_seeds; i++)
+  {
+    size_t len = strlen(FUZZ_RESPONSES[i].text);
+    if (len > FUZZ_MAX_INPUT_LEN)
+    {
+      continue;
+    }
+    memcpy(seeds[count].data, FUZZ_RESPONSES[i].text, len);
+    seeds[count].len = len;
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,57 @@
+// Every at_cmd_type_info_t.parser. The first byte picks the parser, the rest is the response. The
+// response struct is allocated to its exact size and filled with garbage, so a parser that writes
+// past it, or relies on a field it did not set, is caught by the sanitizers
+#include "fuzz.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const char* const FUZZ_HARNESS_NAME = "parsers";
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+  if (size < 1 || size > FUZZ_MAX_INPUT_LEN)
+  {
+    return 0;
+  }
+
+  const fuzz_parser_t* parser   = &FUZZ_PARSERS[data[0] % FUZZ_NUM_PARSERS];
+  char*                response = fuzz_copy_input(data + 1, size - 1);
+  void*                parsed   = malloc(parser->response_size);
+  if (response && parsed)
+  {
+    memset(parsed, 0xA5, parser->response_size);
+    parser->cmd->type_info[parser->type].parser(response, parsed);
+  }
+
+  free(parsed);
+  free(response);
+  return 0;
+}
+
+size_t fuzz_harness_seeds(fuzz_seed_t* seeds, size_t max_seeds)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < FUZZ_NUM_RESPONSES && count < max_seeds; i++)
+  {
+    const fuzz_response_t* response = &FUZZ_RESPONSES[i];
+    for (size_t p = 0; p < FUZZ_NUM_PARSERS; p++)
+    {
+      if (FUZZ_PARSERS[p].cmd != response->cmd || FUZZ_PARSERS[p].type != response->type)
+      {
+        continue;
+      }
+      size_t len = strlen(response->text);
+      if (len + 1 > FUZZ_MAX_INPUT_LEN)
+      {
+        break;
+      }
+      seeds[count].data[0] = (uint8_t) p;
+      memcpy(&seeds[count].data[1], response->text, len);
+      seeds[count].len = len + 1;
+      count++;
+      break;
+    }
+  }
+  return count;
+}
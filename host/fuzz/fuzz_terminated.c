@@ -0,0 +1,55 @@
+// has_command_terminated - run by the handler on every partial response it has read. The first byte
+// picks the command, the second the command type (out of range ones included), the rest is the
+// response read so far
+#include "fuzz.h"
+
+#include "at_cmd_handler.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+const char* const FUZZ_HARNESS_NAME = "terminated";
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+  if (size < 2 || size > FUZZ_MAX_INPUT_LEN)
+  {
+    return 0;
+  }
+
+  const at_cmd_t* cmd      = FUZZ_COMMANDS[data[0] % FUZZ_NUM_COMMANDS];
+  at_cmd_type_t   type     = (at_cmd_type_t) (data[1] % (AT_CMD_TYPE_MAX + 1));
+  char*           response = fuzz_copy_input(data + 2, size - 2);
+  if (response)
+  {
+    has_command_terminated(response, cmd, type);
+  }
+
+  free(response);
+  return 0;
+}
+
+size_t fuzz_harness_seeds(fuzz_seed_t* seeds, size_t max_seeds)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < FUZZ_NUM_RESPONSES && count < max_seeds; i++)
+  {
+    const fuzz_response_t* response = &FUZZ_RESPONSES[i];
+    size_t                 len      = strlen(response->text);
+    size_t                 cmd      = 0;
+    while (cmd < FUZZ_NUM_COMMANDS && FUZZ_COMMANDS[cmd] != response->cmd)
+    {
+      cmd++;
+    }
+    if (cmd == FUZZ_NUM_COMMANDS || len + 2 > FUZZ_MAX_INPUT_LEN)
+    {
+      continue;
+    }
+    seeds[count].data[0] = (uint8_t) cmd;
+    seeds[count].data[1] = (uint8_t) response->type;
+    memcpy(&seeds[count].data[2], response->text, len);
+    seeds[count].len = len + 2;
+    count++;
+  }
+  return count;
+}
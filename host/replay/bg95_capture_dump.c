@@ -0,0 +1,135 @@
+// Prints a capture of the recording UART (bg95_uart_record.h) as text, one chunk per line:
+//
+//   bg95_capture_dump <capture file>
+//
+//   time since the start, the gap to the previous chunk, direction, length, escaped bytes
+#include "bg95_uart_record.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char* KIND_NAME[] = {
+    [BG95_UART_RECORD_TX] = "TX", [BG95_UART_RECORD_RX] = "RX", [BG95_UART_RECORD_BAUD] = "BAUD"};
+
+static void print_escaped(const uint8_t* data, size_t len)
+{
+  putchar('"');
+  for (size_t i = 0; i < len; i++)
+  {
+    if (data[i] == '\r')
+    {
+      fputs("\\r", stdout);
+    }
+    else if (data[i] == '\n')
+    {
+      fputs("\\n", stdout);
+    }
+    else if (data[i] < 0x20 || data[i] >= 0x7F || data[i] == '"' || data[i] == '\\')
+    {
+      printf("\\x%02X", data[i]);
+    }
+    else
+    {
+      putchar(data[i]);
+    }
+  }
+  putchar('"');
+}
+
+static uint8_t* read_file(const char* path, size_t* len)
+{
+  FILE* file = fopen(path, "rb");
+  if (!file)
+  {
+    return NULL;
+  }
+
+  uint8_t* data = NULL;
+  long     size = -1;
+  if (fseek(file, 0, SEEK_END) == 0)
+  {
+    size = ftell(file);
+  }
+  if (size >= 0 && fseek(file, 0, SEEK_SET) == 0)
+  {
+    data = malloc((size_t) size + 1);
+  }
+  if (data && fread(data, 1, (size_t) size, file) != (size_t) size)
+  {
+    free(data);
+    data = NULL;
+  }
+  fclose(file);
+  *len = (size_t) size;
+  return data;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <capture file>\n", argv[0]);
+    return 2;
+  }
+
+  size_t   len;
+  uint8_t* capture = read_file(argv[1], &len);
+  if (!capture)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  bg95_uart_record_reader_t reader;
+  bg95_uart_record_chunk_t  chunk;
+  esp_err_t                 err = bg95_uart_record_reader_init(&reader, capture, len);
+  if (err != ESP_OK)
+  {
+    fprintf(stderr, "%s: not a capture (%s)\n", argv[1], esp_err_to_name(err));
+    free(capture);
+    return 1;
+  }
+
+  uint64_t previous_us = 0;
+  uint64_t bytes[3]    = {0};
+  uint32_t chunks      = 0;
+  while ((err = bg95_uart_record_reader_next(&reader, &chunk)) == ESP_OK)
+  {
+    const char* kind = (chunk.kind <= BG95_UART_RECORD_BAUD) ? KIND_NAME[chunk.kind] : "?";
+    printf("%12.3f ms %+10.3f ms  %-4s %5zu  ",
+           chunk.time_us / 1000.0,
+           (chunk.time_us - previous_us) / 1000.0,
+           kind,
+           chunk.len);
+    if (chunk.kind == BG95_UART_RECORD_BAUD && chunk.len == 4)
+    {
+      printf("%lu", (unsigned long) (chunk.data[0] | chunk.data[1] << 8 | chunk.data[2] << 16 |
+                                     (uint32_t) chunk.data[3] << 24));
+    }
+    else
+    {
+      print_escaped(chunk.data, chunk.len);
+    }
+    putchar('\n');
+
+    if (chunk.kind <= BG95_UART_RECORD_BAUD)
+    {
+      bytes[chunk.kind] += chunk.len;
+    }
+    previous_us = chunk.time_us;
+    chunks++;
+  }
+
+  printf("%lu chunks over %.3f s, %llu bytes TX, %llu bytes RX\n",
+         (unsigned long) chunks,
+         previous_us / 1000000.0,
+         (unsigned long long) bytes[BG95_UART_RECORD_TX],
+         (unsigned long long) bytes[BG95_UART_RECORD_RX]);
+  if (err != ESP_ERR_NOT_FOUND)
+  {
+    fprintf(stderr, "%s: last chunk cut short\n", argv[1]);
+  }
+
+  free(capture);
+  return err == ESP_ERR_NOT_FOUND ? 0 : 1;
+}
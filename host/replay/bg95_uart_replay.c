@@ -0,0 +1,409 @@
+#include "bg95_uart_replay.h"
+
+#include "bg95_uart_record.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char* TAG = "BG95_UART_REPLAY";
+
+typedef struct
+{
+  bg95_uart_record_kind_t kind;
+  uint64_t                time_us;
+  const uint8_t*          data;
+  size_t                  len;
+  uint64_t                tx_before; // Recorded TX bytes before the chunk
+  long                    anchor;    // Last TX chunk before it (-1 - none)
+  uint64_t                done_us;   // TX: when the host finished writing it
+} replay_chunk_t;
+
+struct bg95_uart_replay
+{
+  bg95_uart_replay_config_t config;
+  uint8_t*                  capture;
+  replay_chunk_t*           chunks;
+  size_t                    num_chunks;
+  uint64_t                  tx_total;
+  uint64_t                  start_us;
+
+  // TX cursor - bytes the host has written
+  size_t   tx_chunk;
+  size_t   tx_offset;
+  uint64_t tx_written;
+
+  // RX cursor - bytes the host has read
+  size_t rx_chunk;
+  size_t rx_offset;
+
+  bg95_uart_replay_stats_t stats;
+  pthread_mutex_t          lock;
+  pthread_cond_t           changed; // Something was written
+};
+
+static uint64_t now_us(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000U + (uint64_t) now.tv_nsec / 1000U;
+}
+
+// ------------------------------ CURSORS ---------------------------------
+
+// Caller holds the lock. Moves 'chunk' to the next chunk of 'kind' at or after it
+static size_t next_of_kind(const bg95_uart_replay_t* replay, size_t chunk, uint8_t kind)
+{
+  while (chunk < replay->num_chunks && replay->chunks[chunk].kind != kind)
+  {
+    chunk++;
+  }
+  return chunk;
+}
+
+static void update_finished(bg95_uart_replay_t* replay)
+{
+  replay->stats.finished =
+      next_of_kind(replay, replay->tx_chunk, BG95_UART_RECORD_TX) >= replay->num_chunks &&
+      next_of_kind(replay, replay->rx_chunk, BG95_UART_RECORD_RX) >= replay->num_chunks;
+}
+
+// When the RX chunk may be read - UINT64_MAX while the TX before it has not been written yet
+static uint64_t rx_due_us(const bg95_uart_replay_t* replay, const replay_chunk_t* chunk)
+{
+  if (replay->tx_written < chunk->tx_before)
+  {
+    return UINT64_MAX;
+  }
+
+  uint64_t base_us      = replay->start_us;
+  uint64_t base_time_us = 0;
+  if (chunk->anchor >= 0)
+  {
+    base_us      = replay->chunks[chunk->anchor].done_us;
+    base_time_us = replay->chunks[chunk->anchor].time_us;
+  }
+  if (replay->config.speedup == 0)
+  {
+    return base_us;
+  }
+  return base_us + (chunk->time_us - base_time_us) / replay->config.speedup;
+}
+
+// ------------------------------ INTERFACE ---------------------------------
+
+static esp_err_t replay_write(const char* data, size_t len, void* context)
+{
+  bg95_uart_replay_t* replay = (bg95_uart_replay_t*) context;
+  const uint8_t*      bytes  = (const uint8_t*) data;
+  if (!data)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&replay->lock);
+  replay->stats.writes++;
+
+  uint64_t now      = now_us();
+  long     mismatch = -1;
+  for (size_t i = 0; i < len; i++)
+  {
+    replay->tx_chunk = next_of_kind(replay, replay->tx_chunk, BG95_UART_RECORD_TX);
+    if (replay->tx_chunk >= replay->num_chunks)
+    {
+      replay->stats.tx_extra_bytes += len - i;
+      if (mismatch < 0)
+      {
+        mismatch = (long) i;
+      }
+      break;
+    }
+
+    replay_chunk_t* chunk = &replay->chunks[replay->tx_chunk];
+    if (chunk->data[replay->tx_offset] != bytes[i] && mismatch < 0)
+    {
+      mismatch = (long) i;
+    }
+    replay->tx_written++;
+    if (++replay->tx_offset == chunk->len)
+    {
+      chunk->done_us = now;
+      replay->tx_chunk++;
+      replay->tx_offset = 0;
+    }
+  }
+
+  if (mismatch >= 0)
+  {
+    replay->stats.tx_mismatches++;
+    ESP_LOGW(TAG,
+             "Write differs from the capture at byte %ld: %.*s",
+             mismatch,
+             (int) (len > 64 ? 64 : len),
+             data);
+  }
+  update_finished(replay);
+  pthread_cond_broadcast(&replay->changed);
+  pthread_mutex_unlock(&replay->lock);
+
+  return (mismatch >= 0 && replay->config.strict) ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
+
+static esp_err_t replay_read(
+    char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context)
+{
+  bg95_uart_replay_t* replay = (bg95_uart_replay_t*) context;
+  if (!buffer || max_len == 0 || !bytes_read)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&replay->lock);
+  uint64_t deadline = now_us() + (uint64_t) timeout_ms * 1000U;
+  size_t   got      = 0;
+  for (;;)
+  {
+    uint64_t now     = now_us();
+    uint64_t wake    = deadline;
+    replay->rx_chunk = next_of_kind(replay, replay->rx_chunk, BG95_UART_RECORD_RX);
+    if (replay->rx_chunk < replay->num_chunks)
+    {
+      replay_chunk_t* chunk = &replay->chunks[replay->rx_chunk];
+      uint64_t        due   = rx_due_us(replay, chunk);
+      if (due <= now)
+      {
+        got = chunk->len - replay->rx_offset;
+        if (got > max_len - 1)
+        {
+          got = max_len - 1;
+        }
+        memcpy(buffer, chunk->data + replay->rx_offset, got);
+        replay->rx_offset += got;
+        replay->stats.bytes_rx += got;
+        if (replay->rx_offset == chunk->len)
+        {
+          replay->stats.chunks_rx++;
+          replay->rx_chunk++;
+          replay->rx_offset = 0;
+          update_finished(replay);
+        }
+        break;
+      }
+      if (due < wake)
+      {
+        wake = due;
+      }
+    }
+    if (now >= deadline)
+    {
+      break;
+    }
+
+    struct timespec until = {.tv_sec  = (time_t) (wake / 1000000U),
+                             .tv_nsec = (long) (wake % 1000000U) * 1000L};
+    pthread_cond_timedwait(&replay->changed, &replay->lock, &until);
+  }
+  pthread_mutex_unlock(&replay->lock);
+
+  buffer[got] = '\0';
+  *bytes_read = got;
+  return ESP_OK;
+}
+
+esp_err_t bg95_uart_replay_uart_init(bg95_uart_replay_t* replay, bg95_uart_interface_t* uart)
+{
+  if (!replay || !uart)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(uart, 0, sizeof(bg95_uart_interface_t));
+  uart->write   = replay_write;
+  uart->read    = replay_read;
+  uart->context = replay;
+  return ESP_OK;
+}
+
+// ------------------------------ LIFECYCLE ---------------------------------
+
+// Split the capture into chunks and find what each RX chunk waits for
+static esp_err_t index_capture(bg95_uart_replay_t* replay, size_t len)
+{
+  bg95_uart_record_reader_t reader;
+  bg95_uart_record_chunk_t  chunk;
+  esp_err_t                 err = bg95_uart_record_reader_init(&reader, replay->capture, len);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  size_t count = 0;
+  while ((err = bg95_uart_record_reader_next(&reader, &chunk)) == ESP_OK)
+  {
+    count++;
+  }
+  if (err != ESP_ERR_NOT_FOUND)
+  {
+    return err;
+  }
+
+  replay->chunks = calloc(count ? count : 1, sizeof(replay_chunk_t));
+  if (!replay->chunks)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  bg95_uart_record_reader_init(&reader, replay->capture, len);
+  long anchor = -1;
+  while (bg95_uart_record_reader_next(&reader, &chunk) == ESP_OK)
+  {
+    replay_chunk_t* entry = &replay->chunks[replay->num_chunks];
+    entry->kind           = chunk.kind;
+    entry->time_us        = chunk.time_us;
+    entry->data           = chunk.data;
+    entry->len            = chunk.len;
+    entry->tx_before      = replay->tx_total;
+    entry->anchor         = anchor;
+    if (chunk.kind == BG95_UART_RECORD_TX)
+    {
+      replay->tx_total += chunk.len;
+      anchor = (long) replay->num_chunks;
+    }
+    replay->num_chunks++;
+  }
+  return ESP_OK;
+}
+
+esp_err_t bg95_uart_replay_create(const void*                      capture,
+                                  size_t                           len,
+                                  const bg95_uart_replay_config_t* config,
+                                  bg95_uart_replay_t**             replay)
+{
+  if (!capture || !config || !replay)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_uart_replay_t* new_replay = calloc(1, sizeof(bg95_uart_replay_t));
+  if (!new_replay)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  new_replay->config  = *config;
+  new_replay->capture = malloc(len ? len : 1);
+  if (!new_replay->capture)
+  {
+    free(new_replay);
+    return ESP_ERR_NO_MEM;
+  }
+  memcpy(new_replay->capture, capture, len);
+
+  esp_err_t err = index_capture(new_replay, len);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Capture can not be read: %s", esp_err_to_name(err));
+    free(new_replay->chunks);
+    free(new_replay->capture);
+    free(new_replay);
+    return err;
+  }
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&new_replay->changed, &attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&new_replay->lock, NULL);
+
+  bg95_uart_replay_rewind(new_replay);
+  *replay = new_replay;
+  return ESP_OK;
+}
+
+esp_err_t bg95_uart_replay_load(const char*                      path,
+                                const bg95_uart_replay_config_t* config,
+                                bg95_uart_replay_t**             replay)
+{
+  if (!path || !config || !replay)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  FILE* file = fopen(path, "rb");
+  if (!file)
+  {
+    ESP_LOGE(TAG, "Failed to open %s", path);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  esp_err_t err  = ESP_FAIL;
+  long      size = -1;
+  if (fseek(file, 0, SEEK_END) == 0)
+  {
+    size = ftell(file);
+  }
+  uint8_t* capture = (size >= 0) ? malloc((size_t) size + 1) : NULL;
+  if (capture && fseek(file, 0, SEEK_SET) == 0 &&
+      fread(capture, 1, (size_t) size, file) == (size_t) size)
+  {
+    err = bg95_uart_replay_create(capture, (size_t) size, config, replay);
+  }
+  else
+  {
+    ESP_LOGE(TAG, "Failed to read %s", path);
+  }
+
+  free(capture);
+  fclose(file);
+  return err;
+}
+
+void bg95_uart_replay_destroy(bg95_uart_replay_t* replay)
+{
+  if (!replay)
+  {
+    return;
+  }
+
+  pthread_cond_destroy(&replay->changed);
+  pthread_mutex_destroy(&replay->lock);
+  free(replay->chunks);
+  free(replay->capture);
+  free(replay);
+}
+
+void bg95_uart_replay_rewind(bg95_uart_replay_t* replay)
+{
+  if (!replay)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&replay->lock);
+  replay->tx_chunk   = 0;
+  replay->tx_offset  = 0;
+  replay->tx_written = 0;
+  replay->rx_chunk   = 0;
+  replay->rx_offset  = 0;
+  replay->start_us   = now_us();
+  memset(&replay->stats, 0, sizeof(replay->stats));
+  update_finished(replay);
+  pthread_cond_broadcast(&replay->changed);
+  pthread_mutex_unlock(&replay->lock);
+}
+
+void bg95_uart_replay_get_stats(bg95_uart_replay_t* replay, bg95_uart_replay_stats_t* stats)
+{
+  if (!replay || !stats)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&replay->lock);
+  *stats = replay->stats;
+  pthread_mutex_unlock(&replay->lock);
+}
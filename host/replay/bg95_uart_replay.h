@@ -0,0 +1,64 @@
+// Replays a capture of the recording UART (bg95_uart_record.h) on a bg95_uart_interface_t, so the
+// handler (or the whole driver) can be run against what a module in the field answered:
+//
+//   - what the host writes is checked against the recorded TX bytes, in order
+//   - a recorded RX chunk is only read once the TX bytes recorded before it have been written, and
+//     not before its recorded distance to the last of them - scaled by 'speedup', 0 serves it at
+//     once - so a command can not be answered before it was sent
+//   - reads return the recorded chunks (split if the caller's buffer is smaller), so the handler
+//     sees the same fragmentation as in the field
+//
+// The driver calls of the capture have to be made again in the same order - the replay only stands
+// in for the module. Rewind to run the same capture again, e.g. as a benchmark
+#pragma once
+
+#include "bg95_uart_interface.h"
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+  uint32_t speedup; // 1 - recorded timing, 10 - ten times faster, 0 - no waiting at all
+  bool     strict;  // A write that differs from the capture fails with ESP_ERR_INVALID_RESPONSE
+} bg95_uart_replay_config_t;
+
+#define BG95_UART_REPLAY_CONFIG_DEFAULT()                                                          \
+  {                                                                                                \
+    .speedup = 1, .strict = false                                                                  \
+  }
+
+typedef struct
+{
+  uint32_t writes;
+  uint32_t tx_mismatches;  // Writes that differed from the capture
+  uint64_t tx_extra_bytes; // Written past the end of the recorded TX
+  uint32_t chunks_rx;      // Recorded RX chunks read out in full
+  uint64_t bytes_rx;
+  bool     finished; // All recorded TX written and all RX read
+} bg95_uart_replay_stats_t;
+
+typedef struct bg95_uart_replay bg95_uart_replay_t;
+
+// 'capture' is copied. Returns the reader's errors for a capture it can not read
+esp_err_t bg95_uart_replay_create(const void*                      capture,
+                                  size_t                           len,
+                                  const bg95_uart_replay_config_t* config,
+                                  bg95_uart_replay_t**             replay);
+
+// A capture file, e.g. streamed by the recorder's sink
+esp_err_t bg95_uart_replay_load(const char*                      path,
+                                const bg95_uart_replay_config_t* config,
+                                bg95_uart_replay_t**             replay);
+
+void bg95_uart_replay_destroy(bg95_uart_replay_t* replay);
+
+// Fill 'uart' so the handler talks to the replay (no physical line settings)
+esp_err_t bg95_uart_replay_uart_init(bg95_uart_replay_t* replay, bg95_uart_interface_t* uart);
+
+// Start over - the recorded timing restarts from now
+void bg95_uart_replay_rewind(bg95_uart_replay_t* replay);
+
+void bg95_uart_replay_get_stats(bg95_uart_replay_t* replay, bg95_uart_replay_stats_t* stats);
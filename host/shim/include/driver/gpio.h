@@ -0,0 +1,15 @@
+// Host shim - GPIOs are just levels in memory. An output reads back what was last set, an input
+// reads what host_gpio_set_input_level put there (0 by default)
+#pragma once
+
+#include "esp_err.h"
+#include "hal/gpio_types.h"
+
+#define HOST_GPIO_COUNT 64
+
+esp_err_t gpio_config(const gpio_config_t* config);
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
+int       gpio_get_level(gpio_num_t gpio_num);
+
+// What the other side drives onto an input (e.g. the module's STATUS pin)
+void host_gpio_set_input_level(gpio_num_t gpio_num, uint32_t level);
@@ -0,0 +1,5 @@
+// Host shim - only the types bg95_uart_interface.h needs. There is no hardware UART on the host,
+// the mock UART takes its place
+#pragma once
+
+typedef int uart_port_t;
@@ -0,0 +1,42 @@
+// Host shim for esp_log.h - lines go to stderr as "L (time) TAG: message". Levels above
+// LOG_LOCAL_LEVEL are compiled out, the rest can be filtered at runtime with esp_log_level_set
+#pragma once
+
+#include <stdint.h>
+
+typedef enum
+{
+  ESP_LOG_NONE    = 0,
+  ESP_LOG_ERROR   = 1,
+  ESP_LOG_WARN    = 2,
+  ESP_LOG_INFO    = 3,
+  ESP_LOG_DEBUG   = 4,
+  ESP_LOG_VERBOSE = 5,
+} esp_log_level_t;
+
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL ESP_LOG_INFO
+#endif
+
+// NOTE: Unlike ESP-IDF the level is not kept per tag - any tag sets the level of all of them
+void esp_log_level_set(const char* tag, esp_log_level_t level);
+
+esp_log_level_t esp_log_level_get(const char* tag);
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOG_LEVEL_LOCAL(level, tag, format, ...)                                               \
+  do                                                                                               \
+  {                                                                                                \
+    if (LOG_LOCAL_LEVEL >= (level) && esp_log_level_get(tag) >= (level))                          \
+    {                                                                                              \
+      esp_log_write((level), (tag), format, ##__VA_ARGS__);                                        \
+    }                                                                                              \
+  } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_LOG_LEVEL_LOCAL(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
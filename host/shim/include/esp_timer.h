@@ -0,0 +1,7 @@
+// Host shim - esp_timer_get_time on CLOCK_MONOTONIC
+#pragma once
+
+#include <stdint.h>
+
+// Microseconds since an arbitrary point (boot on ESP-IDF)
+int64_t esp_timer_get_time(void);
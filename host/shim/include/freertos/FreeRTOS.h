@@ -0,0 +1,21 @@
+// Host shim for the FreeRTOS kernel - one tick is one millisecond of CLOCK_MONOTONIC, tasks are
+// pthreads
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFFUL)
+#define configTICK_RATE_HZ 1000
+
+#include "freertos/projdefs.h"
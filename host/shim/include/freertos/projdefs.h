@@ -0,0 +1,4 @@
+#pragma once
+
+#define pdMS_TO_TICKS(ms) ((TickType_t) (((uint64_t) (ms) * configTICK_RATE_HZ) / 1000U))
+#define pdTICKS_TO_MS(ticks) ((uint32_t) (((uint64_t) (ticks) * 1000U) / configTICK_RATE_HZ))
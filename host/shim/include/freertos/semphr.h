@@ -0,0 +1,17 @@
+// Host shim - mutexes only (plain and recursive), on top of pthread mutexes
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h" // As with ESP-IDF (through queue.h)
+
+typedef struct host_semaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+void              vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+#define xSemaphoreTakeRecursive(semaphore, ticks_to_wait) xSemaphoreTake(semaphore, ticks_to_wait)
+#define xSemaphoreGiveRecursive(semaphore) xSemaphoreGive(semaphore)
@@ -0,0 +1,22 @@
+// Host shim - a byte ring guarded by a mutex, with a condition variable for the blocking receive
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_stream_buffer* StreamBufferHandle_t;
+
+StreamBufferHandle_t xStreamBufferCreate(size_t buffer_size, size_t trigger_level);
+void                 vStreamBufferDelete(StreamBufferHandle_t buffer);
+
+// Never blocks on the host - 'ticks_to_wait' is ignored and what does not fit is dropped
+size_t xStreamBufferSend(StreamBufferHandle_t buffer,
+                         const void*          data,
+                         size_t               len,
+                         TickType_t           ticks_to_wait);
+
+size_t xStreamBufferReceive(StreamBufferHandle_t buffer,
+                            void*                data,
+                            size_t               max_len,
+                            TickType_t           ticks_to_wait);
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t buffer);
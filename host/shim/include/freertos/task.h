@@ -0,0 +1,25 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void* parameters);
+typedef struct host_task* TaskHandle_t;
+
+#define tskIDLE_PRIORITY 0
+
+TickType_t xTaskGetTickCount(void);
+
+// Sleeps the calling thread. 0 only yields
+void vTaskDelay(TickType_t ticks);
+
+// The task runs on a detached pthread. 'stack_depth' is in bytes, as on ESP-IDF (it is raised to a
+// host minimum), the priority is ignored
+BaseType_t xTaskCreate(TaskFunction_t function,
+                       const char*    name,
+                       uint32_t       stack_depth,
+                       void*          parameters,
+                       UBaseType_t    priority,
+                       TaskHandle_t*  created_task);
+
+// NOTE: Only vTaskDelete(NULL) from the task itself is supported - a pthread can not be killed
+void vTaskDelete(TaskHandle_t task);
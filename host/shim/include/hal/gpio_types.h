@@ -0,0 +1,45 @@
+// Host shim - the GPIO types the driver uses
+#pragma once
+
+#include <stdint.h>
+
+typedef int gpio_num_t;
+
+typedef enum
+{
+  GPIO_MODE_DISABLE = 0,
+  GPIO_MODE_INPUT,
+  GPIO_MODE_OUTPUT,
+  GPIO_MODE_INPUT_OUTPUT,
+} gpio_mode_t;
+
+typedef enum
+{
+  GPIO_PULLUP_DISABLE = 0,
+  GPIO_PULLUP_ENABLE  = 1,
+} gpio_pullup_t;
+
+typedef enum
+{
+  GPIO_PULLDOWN_DISABLE = 0,
+  GPIO_PULLDOWN_ENABLE  = 1,
+} gpio_pulldown_t;
+
+typedef enum
+{
+  GPIO_INTR_DISABLE = 0,
+  GPIO_INTR_POSEDGE,
+  GPIO_INTR_NEGEDGE,
+  GPIO_INTR_ANYEDGE,
+  GPIO_INTR_LOW_LEVEL,
+  GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+typedef struct
+{
+  uint64_t        pin_bit_mask;
+  gpio_mode_t     mode;
+  gpio_pullup_t   pull_up_en;
+  gpio_pulldown_t pull_down_en;
+  gpio_int_type_t intr_type;
+} gpio_config_t;
@@ -0,0 +1,3 @@
+// Host shim - there is no menuconfig on the host. Footprint options (see Kconfig) can be passed as
+// compile definitions instead, e.g. -DCONFIG_BG95_STRIP_DESCRIPTIONS=1
+#pragma once
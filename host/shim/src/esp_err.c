@@ -0,0 +1,47 @@
+#include "esp_err.h"
+#include "nvs.h"
+
+#include <stddef.h>
+
+typedef struct
+{
+  esp_err_t   code;
+  const char* name;
+} esp_err_name_t;
+
+#define ERR_NAME(code) {code, #code}
+
+static const esp_err_name_t ERR_NAMES[] = {
+    ERR_NAME(ESP_OK),
+    ERR_NAME(ESP_FAIL),
+    ERR_NAME(ESP_ERR_NO_MEM),
+    ERR_NAME(ESP_ERR_INVALID_ARG),
+    ERR_NAME(ESP_ERR_INVALID_STATE),
+    ERR_NAME(ESP_ERR_INVALID_SIZE),
+    ERR_NAME(ESP_ERR_NOT_FOUND),
+    ERR_NAME(ESP_ERR_NOT_SUPPORTED),
+    ERR_NAME(ESP_ERR_TIMEOUT),
+    ERR_NAME(ESP_ERR_INVALID_RESPONSE),
+    ERR_NAME(ESP_ERR_INVALID_CRC),
+    ERR_NAME(ESP_ERR_INVALID_VERSION),
+    ERR_NAME(ESP_ERR_INVALID_MAC),
+    ERR_NAME(ESP_ERR_NOT_FINISHED),
+    ERR_NAME(ESP_ERR_NOT_ALLOWED),
+    ERR_NAME(ESP_ERR_NVS_NOT_INITIALIZED),
+    ERR_NAME(ESP_ERR_NVS_NOT_FOUND),
+    ERR_NAME(ESP_ERR_NVS_NOT_ENOUGH_SPACE),
+    ERR_NAME(ESP_ERR_NVS_INVALID_HANDLE),
+    ERR_NAME(ESP_ERR_NVS_INVALID_LENGTH),
+};
+
+const char* esp_err_to_name(esp_err_t code)
+{
+  for (size_t i = 0; i < sizeof(ERR_NAMES) / sizeof(ERR_NAMES[0]); i++)
+  {
+    if (ERR_NAMES[i].code == code)
+    {
+      return ERR_NAMES[i].name;
+    }
+  }
+  return "UNKNOWN ERROR";
+}
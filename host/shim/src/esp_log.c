@@ -0,0 +1,34 @@
+#include "esp_log.h"
+
+#include "freertos/task.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+static volatile esp_log_level_t s_level = ESP_LOG_INFO;
+
+void esp_log_level_set(const char* tag, esp_log_level_t level)
+{
+  (void) tag;
+  s_level = level;
+}
+
+esp_log_level_t esp_log_level_get(const char* tag)
+{
+  (void) tag;
+  return s_level;
+}
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...)
+{
+  static const char LETTERS[] = "NEWIDV";
+
+  va_list args;
+  va_start(args, format);
+  flockfile(stderr);
+  fprintf(stderr, "%c (%lu) %s: ", LETTERS[level], (unsigned long) xTaskGetTickCount(), tag);
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+  funlockfile(stderr);
+  va_end(args);
+}
@@ -0,0 +1,10 @@
+#include "esp_timer.h"
+
+#include <time.h>
+
+int64_t esp_timer_get_time(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t) now.tv_sec * 1000000 + (int64_t) now.tv_nsec / 1000;
+}
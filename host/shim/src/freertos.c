@@ -0,0 +1,383 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/stream_buffer.h"
+#include "freertos/task.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------------------ TICKS ---------------------------------
+
+TickType_t xTaskGetTickCount(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  uint64_t ms = (uint64_t) now.tv_sec * 1000U + (uint64_t) now.tv_nsec / 1000000U;
+  return (TickType_t) ((ms * configTICK_RATE_HZ) / 1000U);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  if (ticks == 0)
+  {
+    sched_yield();
+    return;
+  }
+
+  uint64_t        ms = ((uint64_t) ticks * 1000U) / configTICK_RATE_HZ;
+  struct timespec delay;
+  delay.tv_sec  = (time_t) (ms / 1000U);
+  delay.tv_nsec = (long) (ms % 1000U) * 1000000L;
+  while (nanosleep(&delay, &delay) != 0 && errno == EINTR)
+  {
+  }
+}
+
+// 'ticks' from now on CLOCK_REALTIME (what pthread_mutex_timedlock and plain condvars use)
+static struct timespec deadline_after(TickType_t ticks)
+{
+  uint64_t        ms = ((uint64_t) ticks * 1000U) / configTICK_RATE_HZ;
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += (time_t) (ms / 1000U);
+  deadline.tv_nsec += (long) (ms % 1000U) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L)
+  {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  return deadline;
+}
+
+// ------------------------------ TASKS ---------------------------------
+
+// Stack sizes are made for the target - host libc calls (and the sanitizers) need a lot more
+#define HOST_TASK_MIN_STACK (256U * 1024U)
+
+typedef struct
+{
+  TaskFunction_t function;
+  void*          parameters;
+} task_start_t;
+
+static void* task_entry(void* arg)
+{
+  task_start_t start = *(task_start_t*) arg;
+  free(arg);
+  start.function(start.parameters);
+  return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function,
+                       const char*    name,
+                       uint32_t       stack_depth,
+                       void*          parameters,
+                       UBaseType_t    priority,
+                       TaskHandle_t*  created_task)
+{
+  task_start_t* start = malloc(sizeof(task_start_t));
+  if (!start)
+  {
+    return pdFAIL;
+  }
+  start->function   = function;
+  start->parameters = parameters;
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  pthread_attr_setstacksize(&attr, (stack_depth > HOST_TASK_MIN_STACK) ? stack_depth
+                                                                      : HOST_TASK_MIN_STACK);
+
+  pthread_t thread;
+  int       err = pthread_create(&thread, &attr, task_entry, start);
+  pthread_attr_destroy(&attr);
+  if (err != 0)
+  {
+    free(start);
+    return pdFAIL;
+  }
+
+  // Only compared against NULL by the callers
+  if (created_task)
+  {
+    *created_task = (TaskHandle_t) (uintptr_t) thread;
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+  if (!task)
+  {
+    pthread_exit(NULL);
+  }
+}
+
+// ------------------------------ MUTEXES ---------------------------------
+
+struct host_semaphore
+{
+  pthread_mutex_t mutex;
+};
+
+static SemaphoreHandle_t create_mutex(int type)
+{
+  SemaphoreHandle_t semaphore = malloc(sizeof(struct host_semaphore));
+  if (!semaphore)
+  {
+    return NULL;
+  }
+
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, type);
+  int err = pthread_mutex_init(&semaphore->mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+  if (err != 0)
+  {
+    free(semaphore);
+    return NULL;
+  }
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+  return create_mutex(PTHREAD_MUTEX_NORMAL);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+  return create_mutex(PTHREAD_MUTEX_RECURSIVE);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+  if (semaphore)
+  {
+    pthread_mutex_destroy(&semaphore->mutex);
+    free(semaphore);
+  }
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+  if (ticks_to_wait == portMAX_DELAY)
+  {
+    return pthread_mutex_lock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+  }
+  if (ticks_to_wait == 0)
+  {
+    return pthread_mutex_trylock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+  }
+
+  struct timespec deadline = deadline_after(ticks_to_wait);
+  return pthread_mutex_timedlock(&semaphore->mutex, &deadline) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+  return pthread_mutex_unlock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+}
+
+// ------------------------------ STREAM BUFFERS ---------------------------------
+
+struct host_stream_buffer
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t  available;
+  size_t          size;
+  size_t          head; // Next byte to receive
+  size_t          count;
+  uint8_t         data[];
+};
+
+StreamBufferHandle_t xStreamBufferCreate(size_t buffer_size, size_t trigger_level)
+{
+  StreamBufferHandle_t buffer = malloc(sizeof(struct host_stream_buffer) + buffer_size);
+  if (!buffer)
+  {
+    return NULL;
+  }
+
+  pthread_mutex_init(&buffer->mutex, NULL);
+  pthread_cond_init(&buffer->available, NULL);
+  buffer->size  = buffer_size;
+  buffer->head  = 0;
+  buffer->count = 0;
+  return buffer;
+}
+
+void vStreamBufferDelete(StreamBufferHandle_t buffer)
+{
+  if (buffer)
+  {
+    pthread_cond_destroy(&buffer->available);
+    pthread_mutex_destroy(&buffer->mutex);
+    free(buffer);
+  }
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t buffer,
+                         const void*          data,
+                         size_t               len,
+                         TickType_t           ticks_to_wait)
+{
+  pthread_mutex_lock(&buffer->mutex);
+  size_t space = buffer->size - buffer->count;
+  if (len > space)
+  {
+    len = space;
+  }
+  for (size_t i = 0; i < len; i++)
+  {
+    buffer->data[(buffer->head + buffer->count + i) % buffer->size] = ((const uint8_t*) data)[i];
+  }
+  buffer->count += len;
+  pthread_cond_broadcast(&buffer->available);
+  pthread_mutex_unlock(&buffer->mutex);
+  return len;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t buffer,
+                            void*                data,
+                            size_t               max_len,
+                            TickType_t           ticks_to_wait)
+{
+  pthread_mutex_lock(&buffer->mutex);
+  if (buffer->count == 0 && ticks_to_wait > 0)
+  {
+    struct timespec deadline = deadline_after(ticks_to_wait);
+    while (buffer->count == 0)
+    {
+      int err = (ticks_to_wait == portMAX_DELAY)
+                    ? pthread_cond_wait(&buffer->available, &buffer->mutex)
+                    : pthread_cond_timedwait(&buffer->available, &buffer->mutex, &deadline);
+      if (err == ETIMEDOUT)
+      {
+        break;
+      }
+    }
+  }
+
+  size_t len = (max_len < buffer->count) ? max_len : buffer->count;
+  for (size_t i = 0; i < len; i++)
+  {
+    ((uint8_t*) data)[i] = buffer->data[(buffer->head + i) % buffer->size];
+  }
+  buffer->head = (buffer->head + len) % buffer->size;
+  buffer->count -= len;
+  pthread_mutex_unlock(&buffer->mutex);
+  return len;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t buffer)
+{
+  pthread_mutex_lock(&buffer->mutex);
+  size_t space = buffer->size - buffer->count;
+  pthread_mutex_unlock(&buffer->mutex);
+  return space;
+}
+
+// ------------------------------ QUEUES ---------------------------------
+
+struct host_queue
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t  available;
+  UBaseType_t     length;
+  UBaseType_t     item_size;
+  UBaseType_t     head; // Next item to receive
+  UBaseType_t     count;
+  uint8_t         items[];
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+  QueueHandle_t queue = malloc(sizeof(struct host_queue) + (size_t) length * item_size);
+  if (!queue)
+  {
+    return NULL;
+  }
+
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->available, NULL);
+  queue->length    = length;
+  queue->item_size = item_size;
+  queue->head      = 0;
+  queue->count     = 0;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+  if (queue)
+  {
+    pthread_cond_destroy(&queue->available);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue);
+  }
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks_to_wait)
+{
+  pthread_mutex_lock(&queue->mutex);
+  if (queue->count == queue->length)
+  {
+    pthread_mutex_unlock(&queue->mutex);
+    return pdFALSE;
+  }
+
+  UBaseType_t tail = (queue->head + queue->count) % queue->length;
+  memcpy(&queue->items[(size_t) tail * queue->item_size], item, queue->item_size);
+  queue->count++;
+  pthread_cond_signal(&queue->available);
+  pthread_mutex_unlock(&queue->mutex);
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks_to_wait)
+{
+  pthread_mutex_lock(&queue->mutex);
+  if (queue->count == 0 && ticks_to_wait > 0)
+  {
+    struct timespec deadline = deadline_after(ticks_to_wait);
+    while (queue->count == 0)
+    {
+      int err = (ticks_to_wait == portMAX_DELAY)
+                    ? pthread_cond_wait(&queue->available, &queue->mutex)
+                    : pthread_cond_timedwait(&queue->available, &queue->mutex, &deadline);
+      if (err == ETIMEDOUT)
+      {
+        break;
+      }
+    }
+  }
+
+  if (queue->count == 0)
+  {
+    pthread_mutex_unlock(&queue->mutex);
+    return pdFALSE;
+  }
+
+  memcpy(item, &queue->items[(size_t) queue->head * queue->item_size], queue->item_size);
+  queue->head = (queue->head + 1) % queue->length;
+  queue->count--;
+  pthread_mutex_unlock(&queue->mutex);
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+  pthread_mutex_lock(&queue->mutex);
+  UBaseType_t count = queue->count;
+  pthread_mutex_unlock(&queue->mutex);
+  return count;
+}
@@ -0,0 +1,38 @@
+#include "driver/gpio.h"
+
+#include <stdatomic.h>
+
+static atomic_uint s_levels[HOST_GPIO_COUNT];
+
+esp_err_t gpio_config(const gpio_config_t* config)
+{
+  if (!config || config->pin_bit_mask == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+  if (gpio_num < 0 || gpio_num >= HOST_GPIO_COUNT)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  atomic_store(&s_levels[gpio_num], level ? 1U : 0U);
+  return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+  if (gpio_num < 0 || gpio_num >= HOST_GPIO_COUNT)
+  {
+    return 0;
+  }
+  return (int) atomic_load(&s_levels[gpio_num]);
+}
+
+void host_gpio_set_input_level(gpio_num_t gpio_num, uint32_t level)
+{
+  gpio_set_level(gpio_num, level);
+}
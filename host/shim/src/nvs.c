@@ -0,0 +1,173 @@
+#include "nvs.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#define HOST_NVS_MAX_NAME_LEN 16 // Including the NUL, as on ESP-IDF
+
+typedef struct
+{
+  bool    used;
+  char    namespace_name[HOST_NVS_MAX_NAME_LEN];
+  char    key[HOST_NVS_MAX_NAME_LEN];
+  size_t  len;
+  uint8_t value[HOST_NVS_MAX_BLOB_SIZE];
+} nvs_entry_t;
+
+static nvs_entry_t     s_entries[HOST_NVS_MAX_ENTRIES];
+static char            s_namespaces[HOST_NVS_MAX_ENTRIES][HOST_NVS_MAX_NAME_LEN];
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// A handle is the namespace slot + 1
+static const char* handle_namespace(nvs_handle_t handle)
+{
+  if (handle == 0 || handle > HOST_NVS_MAX_ENTRIES || s_namespaces[handle - 1][0] == '\0')
+  {
+    return NULL;
+  }
+  return s_namespaces[handle - 1];
+}
+
+static nvs_entry_t* find_entry(const char* namespace_name, const char* key)
+{
+  for (size_t i = 0; i < HOST_NVS_MAX_ENTRIES; i++)
+  {
+    if (s_entries[i].used && strcmp(s_entries[i].namespace_name, namespace_name) == 0 &&
+        strcmp(s_entries[i].key, key) == 0)
+    {
+      return &s_entries[i];
+    }
+  }
+  return NULL;
+}
+
+esp_err_t nvs_open(const char* namespace_name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle)
+{
+  if (!namespace_name || !out_handle || strlen(namespace_name) >= HOST_NVS_MAX_NAME_LEN)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+  pthread_mutex_lock(&s_lock);
+  for (size_t i = 0; i < HOST_NVS_MAX_ENTRIES; i++)
+  {
+    if (strcmp(s_namespaces[i], namespace_name) == 0 || s_namespaces[i][0] == '\0')
+    {
+      // As on ESP-IDF, a read only open of a namespace that was never written fails
+      if (s_namespaces[i][0] == '\0' && open_mode == NVS_READONLY)
+      {
+        err = ESP_ERR_NVS_NOT_FOUND;
+        break;
+      }
+      strcpy(s_namespaces[i], namespace_name);
+      *out_handle = (nvs_handle_t) (i + 1);
+      err         = ESP_OK;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&s_lock);
+  return err;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+  return handle_namespace(handle) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length)
+{
+  const char* namespace_name = handle_namespace(handle);
+  if (!namespace_name)
+  {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  if (!key || !length)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+  pthread_mutex_lock(&s_lock);
+  nvs_entry_t* entry = find_entry(namespace_name, key);
+  if (entry)
+  {
+    // NULL 'out_value' only asks for the length
+    if (out_value && *length < entry->len)
+    {
+      err = ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    else
+    {
+      if (out_value)
+      {
+        memcpy(out_value, entry->value, entry->len);
+      }
+      *length = entry->len;
+      err     = ESP_OK;
+    }
+  }
+  pthread_mutex_unlock(&s_lock);
+  return err;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length)
+{
+  const char* namespace_name = handle_namespace(handle);
+  if (!namespace_name)
+  {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  if (!key || !value || strlen(key) >= HOST_NVS_MAX_NAME_LEN || length > HOST_NVS_MAX_BLOB_SIZE)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+  pthread_mutex_lock(&s_lock);
+  nvs_entry_t* entry = find_entry(namespace_name, key);
+  for (size_t i = 0; !entry && i < HOST_NVS_MAX_ENTRIES; i++)
+  {
+    if (!s_entries[i].used)
+    {
+      entry = &s_entries[i];
+    }
+  }
+  if (entry)
+  {
+    entry->used = true;
+    strcpy(entry->namespace_name, namespace_name);
+    strcpy(entry->key, key);
+    memcpy(entry->value, value, length);
+    entry->len = length;
+    err        = ESP_OK;
+  }
+  pthread_mutex_unlock(&s_lock);
+  return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key)
+{
+  const char* namespace_name = handle_namespace(handle);
+  if (!namespace_name)
+  {
+    return ESP_ERR_NVS_INVALID_HANDLE;
+  }
+  if (!key)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&s_lock);
+  nvs_entry_t* entry = find_entry(namespace_name, key);
+  if (entry)
+  {
+    entry->used = false;
+  }
+  pthread_mutex_unlock(&s_lock);
+  return entry ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
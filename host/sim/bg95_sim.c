@@ -0,0 +1,2285 @@
+#include "bg95_sim.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+static const char* TAG = "BG95_SIM";
+
+#define SIM_ANSWER_SIZE 8192
+#define SIM_DEFERRED_SIZE 32768
+#define SIM_MQTT_HOST_LEN 128
+#define SIM_MQTT_TOPIC_LEN 256
+#define SIM_FAULT_PREFIX_LEN 32
+#define SIM_FILE_HANDLE_BASE 1024 // Handle of the first open file slot
+
+// Something the simulator sends. Pending segments wait for 'due_us', then move onto the line, where
+// 'due_us' becomes the time their first byte goes out (the line may still be busy with the previous
+// segment). With a byte rate the rest follows one byte per 1/rate seconds
+typedef struct sim_segment
+{
+  struct sim_segment* next;
+  uint64_t            due_us;
+  size_t              len;
+  size_t              sent;
+  char                data[];
+} sim_segment_t;
+
+typedef enum
+{
+  SIM_MQTT_CLOSED    = 0U,
+  SIM_MQTT_OPENED    = 1U,
+  SIM_MQTT_CONNECTED = 2U,
+} sim_mqtt_state_t;
+
+typedef struct
+{
+  char topic[SIM_MQTT_TOPIC_LEN];
+  int  qos;
+} sim_subscription_t;
+
+typedef struct
+{
+  sim_mqtt_state_t   state;
+  char               host[SIM_MQTT_HOST_LEN];
+  int                port;
+  sim_subscription_t subs[BG95_SIM_MAX_SUBSCRIPTIONS];
+  uint16_t           next_recv_msgid;
+} sim_mqtt_client_t;
+
+typedef struct
+{
+  bool   open;
+  int    context_id;
+  size_t rx_len; // Echoed back, waiting to be read with QIRD
+  char   rx[BG95_SIM_SOCKET_BUFFER_LEN];
+} sim_socket_t;
+
+typedef struct
+{
+  bool     used;
+  char     name[BG95_SIM_MAX_FILE_NAME_LEN + 1]; // Without the "UFS:" prefix
+  size_t   len;
+  size_t   capacity;
+  uint8_t* data;
+} sim_file_t;
+
+typedef struct
+{
+  bool   open;
+  int    file; // Index into the files
+  bool   read_only;
+  size_t position;
+} sim_open_file_t;
+
+typedef struct
+{
+  bool defined;
+  bool active;
+  char type[16];
+  char apn[64];
+} sim_pdp_context_t;
+
+typedef struct
+{
+  char                  prefix[SIM_FAULT_PREFIX_LEN];
+  bg95_sim_fault_kind_t kind;
+  int                   code;
+  uint32_t              count; // 0 - slot is free
+} sim_fault_t;
+
+typedef enum
+{
+  SIM_RESULT_OK    = 0U,
+  SIM_RESULT_ERROR = 1U,
+  SIM_RESULT_CME   = 2U, // +CME ERROR: sim->cme_error
+  SIM_RESULT_NONE  = 3U, // The answer is complete without a final result (e.g. the '>' prompt)
+} sim_result_t;
+
+typedef void (*sim_payload_fn)(bg95_sim_t* sim, uint64_t now);
+
+struct bg95_sim
+{
+  bg95_sim_config_t config;
+  pthread_mutex_t   lock;
+  pthread_cond_t    changed; // Something was scheduled
+
+  // Timeline
+  sim_segment_t* pending; // Sorted by due_us
+  sim_segment_t* line_head;
+  sim_segment_t* line_tail;
+  uint64_t       line_free_us; // The line has sent everything moved onto it by then
+
+  // Command input
+  char   line[BG95_SIM_MAX_LINE_LEN];
+  size_t line_len;
+  bool   line_overflow;
+  bool   line_ended; // The last byte was the CR ending a line - a LF right after it is dropped
+
+  // Payload after a '>' or CONNECT prompt (QMTPUB, QISEND, QFWRITE)
+  char           payload[BG95_SIM_MAX_PUBLISH_LEN];
+  size_t         payload_len;
+  size_t         payload_expected; // 0 - not waiting for a payload
+  sim_payload_fn payload_done;     // Called once the whole payload is in
+  uint8_t        send_socket;
+  uint8_t        write_file; // Open file slot
+  uint8_t        pub_client;
+  uint16_t       pub_msgid;
+  int            pub_qos;
+  char           pub_topic[SIM_MQTT_TOPIC_LEN];
+
+  // Answer to the current command, and the URCs that follow it
+  char   answer[SIM_ANSWER_SIZE];
+  size_t answer_len;
+  char   deferred[SIM_DEFERRED_SIZE];
+  size_t deferred_len;
+  int    cme_error;
+
+  // Module state
+  bool              echo;
+  bool              pin_entered;
+  int               cfun;
+  uint64_t          radio_on_us;
+  bool              network_lost;
+  bool              attached;
+  int               creg_mode;
+  int               cereg_mode;
+  sim_pdp_context_t pdp[BG95_SIM_MAX_PDP_CONTEXTS];
+  sim_mqtt_client_t mqtt[BG95_SIM_MAX_MQTT_CLIENTS];
+  sim_socket_t      sockets[BG95_SIM_MAX_SOCKETS];
+  sim_file_t        files[BG95_SIM_MAX_FILES];
+  sim_open_file_t   open_files[BG95_SIM_MAX_OPEN_FILES];
+
+  sim_fault_t      faults[BG95_SIM_MAX_FAULTS];
+  bg95_sim_stats_t stats;
+};
+
+static uint64_t now_us(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000U + (uint64_t) now.tv_nsec / 1000U;
+}
+
+// ------------------------------ TIMELINE ---------------------------------
+
+static void schedule(bg95_sim_t* sim, const char* data, size_t len, uint64_t due_us)
+{
+  if (len == 0)
+  {
+    return;
+  }
+
+  sim_segment_t* segment = malloc(sizeof(sim_segment_t) + len);
+  if (!segment)
+  {
+    ESP_LOGE(TAG, "Out of memory - %u bytes dropped", (unsigned) len);
+    return;
+  }
+  memcpy(segment->data, data, len);
+  segment->len    = len;
+  segment->sent   = 0;
+  segment->due_us = due_us;
+
+  // After everything that is due at the same time - the order of sending is kept
+  sim_segment_t** link = &sim->pending;
+  while (*link && (*link)->due_us <= due_us)
+  {
+    link = &(*link)->next;
+  }
+  segment->next = *link;
+  *link         = segment;
+
+  pthread_cond_broadcast(&sim->changed);
+}
+
+static uint64_t bytes_to_us(const bg95_sim_t* sim, size_t bytes)
+{
+  return sim->config.bytes_per_sec ? ((uint64_t) bytes * 1000000U) / sim->config.bytes_per_sec : 0;
+}
+
+// Move what is due onto the line
+static void advance(bg95_sim_t* sim, uint64_t now)
+{
+  while (sim->pending && sim->pending->due_us <= now)
+  {
+    sim_segment_t* segment = sim->pending;
+    sim->pending           = segment->next;
+    segment->next          = NULL;
+
+    if (segment->due_us < sim->line_free_us)
+    {
+      segment->due_us = sim->line_free_us;
+    }
+    sim->line_free_us = segment->due_us + bytes_to_us(sim, segment->len);
+
+    if (sim->line_tail)
+    {
+      sim->line_tail->next = segment;
+    }
+    else
+    {
+      sim->line_head = segment;
+    }
+    sim->line_tail = segment;
+  }
+}
+
+static size_t released_bytes(const bg95_sim_t* sim, const sim_segment_t* segment, uint64_t now)
+{
+  if (now < segment->due_us)
+  {
+    return 0;
+  }
+  if (!sim->config.bytes_per_sec)
+  {
+    return segment->len;
+  }
+
+  uint64_t bytes = ((now - segment->due_us) * sim->config.bytes_per_sec) / 1000000U;
+  return bytes < segment->len ? (size_t) bytes : segment->len;
+}
+
+static size_t collect(bg95_sim_t* sim, uint64_t now, char* buffer, size_t limit)
+{
+  size_t collected = 0;
+  while (sim->line_head && collected < limit)
+  {
+    sim_segment_t* segment = sim->line_head;
+    size_t         ready   = released_bytes(sim, segment, now) - segment->sent;
+    if (ready > limit - collected)
+    {
+      ready = limit - collected;
+    }
+    memcpy(buffer + collected, segment->data + segment->sent, ready);
+    collected += ready;
+    segment->sent += ready;
+
+    if (segment->sent < segment->len)
+    {
+      break;
+    }
+    sim->line_head = segment->next;
+    if (!sim->line_head)
+    {
+      sim->line_tail = NULL;
+    }
+    free(segment);
+  }
+  return collected;
+}
+
+// When the next byte can go out - UINT64_MAX if nothing is scheduled
+static uint64_t next_event_us(const bg95_sim_t* sim)
+{
+  uint64_t next = UINT64_MAX;
+  if (sim->line_head)
+  {
+    next = sim->line_head->due_us + bytes_to_us(sim, sim->line_head->sent + 1);
+  }
+  if (sim->pending && sim->pending->due_us < next)
+  {
+    next = sim->pending->due_us;
+  }
+  return next;
+}
+
+static void free_segments(sim_segment_t* segment)
+{
+  while (segment)
+  {
+    sim_segment_t* next = segment->next;
+    free(segment);
+    segment = next;
+  }
+}
+
+// ------------------------------ ANSWERS ---------------------------------
+
+static void append(char* buffer, size_t size, size_t* len, const char* format, va_list args)
+{
+  if (*len >= size)
+  {
+    return;
+  }
+
+  int written = vsnprintf(buffer + *len, size - *len, format, args);
+  if (written > 0)
+  {
+    *len += ((size_t) written < size - *len) ? (size_t) written : size - *len - 1;
+  }
+}
+
+// Information line of the answer - the first one is preceded by CRLF, as the module does
+static void __attribute__((format(printf, 2, 3)))
+answer_line(bg95_sim_t* sim, const char* format, ...)
+{
+  // Room is kept for the final result
+  if (sim->answer_len + 8 > sizeof(sim->answer))
+  {
+    return;
+  }
+  if (sim->answer_len == 0)
+  {
+    memcpy(sim->answer, "\r\n", 2);
+    sim->answer_len = 2;
+  }
+
+  va_list args;
+  va_start(args, format);
+  append(sim->answer, sizeof(sim->answer) - 8, &sim->answer_len, format, args);
+  va_end(args);
+  memcpy(sim->answer + sim->answer_len, "\r\n", 2);
+  sim->answer_len += 2;
+}
+
+// URC sent after the answer of the current command (e.g. the result of a network operation)
+static void __attribute__((format(printf, 2, 3)))
+defer_urc(bg95_sim_t* sim, const char* format, ...)
+{
+  size_t start = sim->deferred_len;
+  if (sizeof(sim->deferred) - start < 5)
+  {
+    return;
+  }
+  memcpy(sim->deferred + start, "\r\n", 2);
+  sim->deferred_len += 2;
+
+  va_list args;
+  va_start(args, format);
+  append(sim->deferred, sizeof(sim->deferred) - 2, &sim->deferred_len, format, args);
+  va_end(args);
+  memcpy(sim->deferred + sim->deferred_len, "\r\n", 2);
+  sim->deferred_len += 2;
+  sim->stats.urcs++;
+}
+
+// Send the deferred URCs 'delay_ms' from now (they are sent as one piece)
+static void flush_deferred(bg95_sim_t* sim, uint64_t now, uint32_t delay_ms)
+{
+  schedule(sim, sim->deferred, sim->deferred_len, now + (uint64_t) delay_ms * 1000U);
+  sim->deferred_len = 0;
+}
+
+static sim_result_t cme(bg95_sim_t* sim, int code)
+{
+  sim->cme_error = code;
+  return SIM_RESULT_CME;
+}
+
+// ------------------------------ ARGUMENTS ---------------------------------
+
+static bool arg_int(at_tokenizer_t* args, int32_t* value)
+{
+  at_field_t field;
+  return at_tokenizer_next(args, &field) == ESP_OK && at_field_get_int(&field, value) == ESP_OK;
+}
+
+// Trailing optional argument - 'value' is left as it is if there is none
+static bool arg_opt_int(at_tokenizer_t* args, int32_t* value)
+{
+  at_field_t field;
+  esp_err_t  err = at_tokenizer_next(args, &field);
+  return err == ESP_ERR_NOT_FOUND ||
+         (err == ESP_OK && at_field_get_int(&field, value) == ESP_OK);
+}
+
+static bool arg_str(at_tokenizer_t* args, char* out, size_t out_size)
+{
+  at_field_t field;
+  return at_tokenizer_next(args, &field) == ESP_OK && field.type == AT_FIELD_STRING &&
+         at_field_copy(&field, out, out_size) == ESP_OK;
+}
+
+// ------------------------------ STATE ---------------------------------
+
+static bool sim_ready(const bg95_sim_t* sim)
+{
+  return sim->config.sim_inserted && (!sim->config.pin || sim->pin_entered);
+}
+
+// +CREG / +CEREG <stat>: 0 not searching, 1 registered (home), 2 searching
+static int registration_stat(const bg95_sim_t* sim, uint64_t now)
+{
+  if (sim->cfun != 1 || !sim_ready(sim))
+  {
+    return 0;
+  }
+  if (sim->network_lost ||
+      now < sim->radio_on_us + (uint64_t) sim->config.register_delay_ms * 1000U)
+  {
+    return 2;
+  }
+  return 1;
+}
+
+static bool pdp_active(const bg95_sim_t* sim)
+{
+  for (int cid = 1; cid < BG95_SIM_MAX_PDP_CONTEXTS; cid++)
+  {
+    if (sim->pdp[cid].active)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The network is gone - contexts are deactivated, MQTT connections and sockets closed ('notify'
+// raises +QMTSTAT and +QIURC: "pdpdeact" for them)
+static void network_down(bg95_sim_t* sim, bool notify)
+{
+  for (int cid = 1; cid < BG95_SIM_MAX_PDP_CONTEXTS; cid++)
+  {
+    bool had_sockets = false;
+    for (int id = 0; id < BG95_SIM_MAX_SOCKETS; id++)
+    {
+      if (sim->sockets[id].open && sim->sockets[id].context_id == cid)
+      {
+        had_sockets = true;
+        memset(&sim->sockets[id], 0, sizeof(sim->sockets[id]));
+      }
+    }
+    if (had_sockets && notify)
+    {
+      defer_urc(sim, "+QIURC: \"pdpdeact\",%d", cid);
+    }
+    sim->pdp[cid].active = false;
+  }
+  for (int idx = 0; idx < BG95_SIM_MAX_MQTT_CLIENTS; idx++)
+  {
+    if (sim->mqtt[idx].state != SIM_MQTT_CLOSED && notify)
+    {
+      defer_urc(sim, "+QMTSTAT: %d,1", idx);
+    }
+    memset(&sim->mqtt[idx], 0, sizeof(sim->mqtt[idx]));
+  }
+}
+
+static void registration_urcs(bg95_sim_t* sim, int stat)
+{
+  if (sim->creg_mode > 0)
+  {
+    defer_urc(sim, "+CREG: %d", stat);
+  }
+  if (sim->cereg_mode > 0)
+  {
+    defer_urc(sim, "+CEREG: %d", stat);
+  }
+}
+
+// MQTT topic filter match with the '+' (one level) and '#' (all remaining levels) wildcards
+static bool topic_matches(const char* filter, const char* topic)
+{
+  while (*filter)
+  {
+    if (*filter == '#')
+    {
+      return true;
+    }
+    if (*filter == '+')
+    {
+      while (*topic && *topic != '/')
+      {
+        topic++;
+      }
+      filter++;
+      continue;
+    }
+    if (*filter != *topic)
+    {
+      return false;
+    }
+    filter++;
+    topic++;
+  }
+  return *topic == '\0';
+}
+
+// Broker loopback - every connected client with a matching subscription gets the message once
+static void mqtt_deliver(bg95_sim_t* sim, const char* topic, const char* payload, size_t len)
+{
+  for (int idx = 0; idx < BG95_SIM_MAX_MQTT_CLIENTS; idx++)
+  {
+    sim_mqtt_client_t* client = &sim->mqtt[idx];
+    if (client->state != SIM_MQTT_CONNECTED)
+    {
+      continue;
+    }
+
+    for (int i = 0; i < BG95_SIM_MAX_SUBSCRIPTIONS; i++)
+    {
+      const sim_subscription_t* sub = &client->subs[i];
+      if (sub->topic[0] == '\0' || !topic_matches(sub->topic, topic))
+      {
+        continue;
+      }
+
+      // QoS 0 messages carry msgid 0
+      uint16_t msgid = 0;
+      if (sub->qos > 0 && sim->pub_qos > 0)
+      {
+        msgid = ++client->next_recv_msgid;
+      }
+      defer_urc(sim, "+QMTRECV: %d,%u,\"%s\",\"%.*s\"", idx, msgid, topic, (int) len, payload);
+      sim->stats.mqtt_delivered++;
+      break;
+    }
+  }
+}
+
+// ------------------------------ COMMANDS ---------------------------------
+
+typedef sim_result_t (*sim_cmd_fn)(bg95_sim_t*     sim,
+                                   at_cmd_type_t   type,
+                                   at_tokenizer_t* args,
+                                   uint64_t        now);
+
+static sim_result_t
+cmd_cpin(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  if (!sim->config.sim_inserted)
+  {
+    return cme(sim, 10); // SIM not inserted
+  }
+
+  if (type == AT_CMD_TYPE_READ)
+  {
+    answer_line(sim, "+CPIN: %s", sim_ready(sim) ? "READY" : "SIM PIN");
+    return SIM_RESULT_OK;
+  }
+  if (type != AT_CMD_TYPE_WRITE)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  char pin[16];
+  if (!arg_str(args, pin, sizeof(pin)))
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (sim_ready(sim))
+  {
+    return cme(sim, 3); // Operation not allowed
+  }
+  if (strcmp(pin, sim->config.pin) != 0)
+  {
+    return cme(sim, 16); // Incorrect password
+  }
+
+  sim->pin_entered = true;
+  sim->radio_on_us = now; // Registration starts once the SIM is ready
+  defer_urc(sim, "+CPIN: READY");
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_cfun(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  if (type == AT_CMD_TYPE_READ)
+  {
+    answer_line(sim, "+CFUN: %d", sim->cfun);
+    return SIM_RESULT_OK;
+  }
+  if (type == AT_CMD_TYPE_TEST)
+  {
+    answer_line(sim, "+CFUN: (0,1,4),(0-1)");
+    return SIM_RESULT_OK;
+  }
+
+  int32_t fun;
+  if (type != AT_CMD_TYPE_WRITE || !arg_int(args, &fun) || (fun != 0 && fun != 1 && fun != 4))
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  if (fun == 1 && sim->cfun != 1)
+  {
+    sim->radio_on_us = now;
+  }
+  else if (fun != 1)
+  {
+    network_down(sim, false);
+  }
+  sim->cfun = fun;
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+registration(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now, bool eps)
+{
+  const char* name = eps ? "CEREG" : "CREG";
+  int*        mode = eps ? &sim->cereg_mode : &sim->creg_mode;
+
+  switch (type)
+  {
+    case AT_CMD_TYPE_READ:
+      answer_line(sim, "+%s: %d,%d", name, *mode, registration_stat(sim, now));
+      return SIM_RESULT_OK;
+
+    case AT_CMD_TYPE_TEST:
+      answer_line(sim, "+%s: (0-2)", name);
+      return SIM_RESULT_OK;
+
+    case AT_CMD_TYPE_WRITE:
+    {
+      int32_t value;
+      if (!arg_int(args, &value) || value < 0 || value > 2)
+      {
+        return SIM_RESULT_ERROR;
+      }
+      *mode = value;
+      return SIM_RESULT_OK;
+    }
+
+    default:
+      return SIM_RESULT_ERROR;
+  }
+}
+
+static sim_result_t
+cmd_creg(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  return registration(sim, type, args, now, false);
+}
+
+static sim_result_t
+cmd_cereg(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  return registration(sim, type, args, now, true);
+}
+
+static sim_result_t cmd_csq(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) args;
+
+  if (type == AT_CMD_TYPE_TEST)
+  {
+    answer_line(sim, "+CSQ: (0-31,99),(0-7,99)");
+    return SIM_RESULT_OK;
+  }
+  if (type != AT_CMD_TYPE_EXECUTE)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  answer_line(sim, "+CSQ: %d,99", registration_stat(sim, now) == 1 ? sim->config.rssi : 99);
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_cops(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) args;
+
+  bool registered = registration_stat(sim, now) == 1;
+
+  switch (type)
+  {
+    case AT_CMD_TYPE_READ:
+      if (registered)
+      {
+        answer_line(sim, "+COPS: 0,0,\"SIMULATED\",8");
+      }
+      else
+      {
+        answer_line(sim, "+COPS: 0");
+      }
+      return SIM_RESULT_OK;
+
+    case AT_CMD_TYPE_TEST:
+      if (sim->cfun != 1)
+      {
+        return cme(sim, 30); // No network service
+      }
+      answer_line(sim,
+                  "+COPS: (%d,\"SIMULATED\",\"SIM\",\"00101\",8),,(0-4),(0-2)",
+                  registered ? 2 : 1);
+      return SIM_RESULT_OK;
+
+    case AT_CMD_TYPE_WRITE:
+      return SIM_RESULT_OK;
+
+    default:
+      return SIM_RESULT_ERROR;
+  }
+}
+
+static sim_result_t
+cmd_cgatt(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  bool registered = registration_stat(sim, now) == 1;
+
+  if (type == AT_CMD_TYPE_READ)
+  {
+    answer_line(sim, "+CGATT: %d", registered && sim->attached ? 1 : 0);
+    return SIM_RESULT_OK;
+  }
+
+  int32_t state;
+  if (type != AT_CMD_TYPE_WRITE || !arg_int(args, &state) || state < 0 || state > 1)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (state == 1 && !registered)
+  {
+    return cme(sim, 30); // No network service
+  }
+
+  sim->attached = state == 1;
+  if (!sim->attached)
+  {
+    network_down(sim, true);
+  }
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_cgdcont(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  if (type == AT_CMD_TYPE_READ)
+  {
+    for (int cid = 1; cid < BG95_SIM_MAX_PDP_CONTEXTS; cid++)
+    {
+      if (sim->pdp[cid].defined)
+      {
+        answer_line(sim,
+                    "+CGDCONT: %d,\"%s\",\"%s\",\"0.0.0.0\",0,0,0",
+                    cid,
+                    sim->pdp[cid].type,
+                    sim->pdp[cid].apn);
+      }
+    }
+    return SIM_RESULT_OK;
+  }
+
+  int32_t cid;
+  if (type != AT_CMD_TYPE_WRITE || !arg_int(args, &cid) || cid < 1 ||
+      cid >= BG95_SIM_MAX_PDP_CONTEXTS)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  sim_pdp_context_t* pdp = &sim->pdp[cid];
+  char               pdp_type[sizeof(pdp->type)];
+  if (!arg_str(args, pdp_type, sizeof(pdp_type)))
+  {
+    // Only the cid - the context is undefined
+    memset(pdp, 0, sizeof(*pdp));
+    return SIM_RESULT_OK;
+  }
+
+  char apn[sizeof(pdp->apn)] = "";
+  arg_str(args, apn, sizeof(apn));
+  memcpy(pdp->type, pdp_type, sizeof(pdp->type));
+  memcpy(pdp->apn, apn, sizeof(pdp->apn));
+  pdp->defined = true;
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_cgact(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  if (type == AT_CMD_TYPE_READ)
+  {
+    for (int cid = 1; cid < BG95_SIM_MAX_PDP_CONTEXTS; cid++)
+    {
+      if (sim->pdp[cid].defined)
+      {
+        answer_line(sim, "+CGACT: %d,%d", cid, sim->pdp[cid].active ? 1 : 0);
+      }
+    }
+    return SIM_RESULT_OK;
+  }
+
+  int32_t state;
+  int32_t cid;
+  if (type != AT_CMD_TYPE_WRITE || !arg_int(args, &state) || state < 0 || state > 1 ||
+      !arg_int(args, &cid) || cid < 1 || cid >= BG95_SIM_MAX_PDP_CONTEXTS)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (!sim->pdp[cid].defined)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (state == 1 && (registration_stat(sim, now) != 1 || !sim->attached))
+  {
+    return cme(sim, 30); // No network service
+  }
+
+  sim->pdp[cid].active = state == 1;
+  return SIM_RESULT_OK;
+}
+
+static void cgpaddr_line(bg95_sim_t* sim, int cid)
+{
+  if (sim->pdp[cid].active)
+  {
+    answer_line(sim, "+CGPADDR: %d,\"10.64.0.%d\"", cid, cid);
+  }
+  else
+  {
+    answer_line(sim, "+CGPADDR: %d", cid);
+  }
+}
+
+static sim_result_t
+cmd_cgpaddr(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  if (type == AT_CMD_TYPE_EXECUTE)
+  {
+    for (int cid = 1; cid < BG95_SIM_MAX_PDP_CONTEXTS; cid++)
+    {
+      if (sim->pdp[cid].defined)
+      {
+        cgpaddr_line(sim, cid);
+      }
+    }
+    return SIM_RESULT_OK;
+  }
+
+  int32_t cid;
+  if (type != AT_CMD_TYPE_WRITE || !arg_int(args, &cid) || cid < 1 ||
+      cid >= BG95_SIM_MAX_PDP_CONTEXTS || !sim->pdp[cid].defined)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  cgpaddr_line(sim, cid);
+  return SIM_RESULT_OK;
+}
+
+// Client index of an MQTT write command, NULL if out of range
+static sim_mqtt_client_t* mqtt_client_arg(bg95_sim_t* sim, at_tokenizer_t* args, int32_t* idx)
+{
+  if (!arg_int(args, idx) || *idx < 0 || *idx >= BG95_SIM_MAX_MQTT_CLIENTS)
+  {
+    return NULL;
+  }
+  return &sim->mqtt[*idx];
+}
+
+static sim_result_t
+cmd_qmtopen(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  if (type == AT_CMD_TYPE_READ)
+  {
+    for (int idx = 0; idx < BG95_SIM_MAX_MQTT_CLIENTS; idx++)
+    {
+      if (sim->mqtt[idx].state != SIM_MQTT_CLOSED)
+      {
+        answer_line(sim, "+QMTOPEN: %d,\"%s\",%d", idx, sim->mqtt[idx].host, sim->mqtt[idx].port);
+      }
+    }
+    return SIM_RESULT_OK;
+  }
+
+  int32_t            idx;
+  int32_t            port;
+  char               host[SIM_MQTT_HOST_LEN];
+  sim_mqtt_client_t* client = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(client = mqtt_client_arg(sim, args, &idx)) ||
+      !arg_str(args, host, sizeof(host)) || !arg_int(args, &port))
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  if (client->state != SIM_MQTT_CLOSED)
+  {
+    defer_urc(sim, "+QMTOPEN: %d,2", (int) idx); // Identifier occupied
+  }
+  else if (!pdp_active(sim))
+  {
+    defer_urc(sim, "+QMTOPEN: %d,3", (int) idx); // PDP context not active
+  }
+  else
+  {
+    memset(client, 0, sizeof(*client));
+    client->state = SIM_MQTT_OPENED;
+    client->port  = port;
+    memcpy(client->host, host, sizeof(client->host));
+    defer_urc(sim, "+QMTOPEN: %d,0", (int) idx);
+  }
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_qmtconn(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  if (type == AT_CMD_TYPE_READ)
+  {
+    for (int idx = 0; idx < BG95_SIM_MAX_MQTT_CLIENTS; idx++)
+    {
+      if (sim->mqtt[idx].state != SIM_MQTT_CLOSED)
+      {
+        int state = (sim->mqtt[idx].state == SIM_MQTT_CONNECTED) ? 3 : 1;
+        answer_line(sim, "+QMTCONN: %d,%d", idx, state);
+      }
+    }
+    return SIM_RESULT_OK;
+  }
+  if (type == AT_CMD_TYPE_TEST)
+  {
+    answer_line(sim, "+QMTCONN: (0-5),\"clientID\",\"username\",\"password\"");
+    return SIM_RESULT_OK;
+  }
+
+  int32_t            idx;
+  char               client_id[128];
+  sim_mqtt_client_t* client = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(client = mqtt_client_arg(sim, args, &idx)) ||
+      !arg_str(args, client_id, sizeof(client_id)) || client->state != SIM_MQTT_OPENED)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  client->state = SIM_MQTT_CONNECTED;
+  defer_urc(sim, "+QMTCONN: %d,0,0", (int) idx);
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_qmtsub(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  if (type == AT_CMD_TYPE_TEST)
+  {
+    answer_line(sim, "+QMTSUB: (0-5),(1-65535),\"topic\",(0-2)");
+    return SIM_RESULT_OK;
+  }
+
+  int32_t            idx;
+  int32_t            msgid;
+  sim_mqtt_client_t* client = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(client = mqtt_client_arg(sim, args, &idx)) ||
+      !arg_int(args, &msgid) || client->state != SIM_MQTT_CONNECTED)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  // "topic",qos pairs
+  char    topic[SIM_MQTT_TOPIC_LEN];
+  int32_t qos;
+  int32_t first_qos = -1;
+  while (arg_str(args, topic, sizeof(topic)))
+  {
+    if (!arg_int(args, &qos) || qos < 0 || qos > 2)
+    {
+      return SIM_RESULT_ERROR;
+    }
+
+    sim_subscription_t* slot = NULL;
+    for (int i = 0; i < BG95_SIM_MAX_SUBSCRIPTIONS; i++)
+    {
+      if (strcmp(client->subs[i].topic, topic) == 0)
+      {
+        slot = &client->subs[i];
+        break;
+      }
+      if (!slot && client->subs[i].topic[0] == '\0')
+      {
+        slot = &client->subs[i];
+      }
+    }
+    if (!slot)
+    {
+      defer_urc(sim, "+QMTSUB: %d,%d,2", (int) idx, (int) msgid); // Failed to send the packet
+      return SIM_RESULT_OK;
+    }
+    memcpy(slot->topic, topic, sizeof(slot->topic));
+    slot->qos = qos;
+    if (first_qos < 0)
+    {
+      first_qos = qos;
+    }
+  }
+  if (first_qos < 0)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  defer_urc(sim, "+QMTSUB: %d,%d,0,%d", (int) idx, (int) msgid, (int) first_qos);
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_qmtuns(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  if (type == AT_CMD_TYPE_TEST)
+  {
+    answer_line(sim, "+QMTUNS: (0-5),(1-65535),\"topic\"");
+    return SIM_RESULT_OK;
+  }
+
+  int32_t            idx;
+  int32_t            msgid;
+  sim_mqtt_client_t* client = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(client = mqtt_client_arg(sim, args, &idx)) ||
+      !arg_int(args, &msgid) || client->state != SIM_MQTT_CONNECTED)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  char topic[SIM_MQTT_TOPIC_LEN];
+  while (arg_str(args, topic, sizeof(topic)))
+  {
+    for (int i = 0; i < BG95_SIM_MAX_SUBSCRIPTIONS; i++)
+    {
+      if (strcmp(client->subs[i].topic, topic) == 0)
+      {
+        client->subs[i].topic[0] = '\0';
+      }
+    }
+  }
+
+  defer_urc(sim, "+QMTUNS: %d,%d,0", (int) idx, (int) msgid);
+  return SIM_RESULT_OK;
+}
+
+static void qmtpub_payload_done(bg95_sim_t* sim, uint64_t now);
+
+static sim_result_t
+cmd_qmtpub(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  int32_t            idx;
+  int32_t            msgid;
+  int32_t            qos;
+  int32_t            retain;
+  int32_t            len;
+  sim_mqtt_client_t* client = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(client = mqtt_client_arg(sim, args, &idx)) ||
+      !arg_int(args, &msgid) || !arg_int(args, &qos) || !arg_int(args, &retain) ||
+      !arg_str(args, sim->pub_topic, sizeof(sim->pub_topic)) || !arg_int(args, &len) || len < 1 ||
+      len > BG95_SIM_MAX_PUBLISH_LEN || client->state != SIM_MQTT_CONNECTED)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  sim->pub_client       = (uint8_t) idx;
+  sim->pub_msgid        = (uint16_t) msgid;
+  sim->pub_qos          = qos;
+  sim->payload_len      = 0;
+  sim->payload_expected = (size_t) len;
+  sim->payload_done     = qmtpub_payload_done;
+
+  memcpy(sim->answer, "\r\n> ", 4);
+  sim->answer_len = 4;
+  return SIM_RESULT_NONE;
+}
+
+// The whole payload of a QMTPUB has been received
+static void qmtpub_payload_done(bg95_sim_t* sim, uint64_t now)
+{
+  memcpy(sim->answer, "\r\nOK\r\n", 6);
+  sim->answer_len = 6;
+  schedule(sim, sim->answer, sim->answer_len, now + (uint64_t) sim->config.latency_ms * 1000U);
+
+  uint32_t delay_ms = sim->config.latency_ms + sim->config.urc_delay_ms;
+  if (sim->mqtt[sim->pub_client].state != SIM_MQTT_CONNECTED)
+  {
+    defer_urc(sim, "+QMTPUB: %u,%u,2", sim->pub_client, sim->pub_msgid);
+    flush_deferred(sim, now, delay_ms);
+    return;
+  }
+
+  // The loopback takes another trip to the broker, so the messages come after the +QMTPUB
+  defer_urc(sim, "+QMTPUB: %u,%u,0", sim->pub_client, sim->pub_msgid);
+  flush_deferred(sim, now, delay_ms);
+  mqtt_deliver(sim, sim->pub_topic, sim->payload, sim->payload_len);
+  flush_deferred(sim, now, delay_ms + sim->config.urc_delay_ms);
+}
+
+static sim_result_t
+mqtt_close(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, bool disconnect)
+{
+  const char* name = disconnect ? "QMTDISC" : "QMTCLOSE";
+  if (type == AT_CMD_TYPE_TEST)
+  {
+    answer_line(sim, "+%s: (0-5)", name);
+    return SIM_RESULT_OK;
+  }
+
+  int32_t            idx;
+  sim_mqtt_client_t* client = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(client = mqtt_client_arg(sim, args, &idx)))
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  sim_mqtt_state_t required = disconnect ? SIM_MQTT_CONNECTED : SIM_MQTT_OPENED;
+  if (client->state < required)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  // A disconnect closes the network connection as well
+  memset(client, 0, sizeof(*client));
+  defer_urc(sim, "+%s: %d,0", name, (int) idx);
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_qmtdisc(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  return mqtt_close(sim, type, args, true);
+}
+
+static sim_result_t
+cmd_qmtclose(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  return mqtt_close(sim, type, args, false);
+}
+
+// ------------------------------ SOCKETS ---------------------------------
+
+// Socket of a QI* write command, NULL if out of range
+static sim_socket_t* socket_arg(bg95_sim_t* sim, at_tokenizer_t* args, int32_t* id)
+{
+  if (!arg_int(args, id) || *id < 0 || *id >= BG95_SIM_MAX_SOCKETS)
+  {
+    return NULL;
+  }
+  return &sim->sockets[*id];
+}
+
+// Only buffer access mode - the data is held until the host reads it with QIRD
+static sim_result_t
+cmd_qiopen(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  int32_t       cid;
+  int32_t       id;
+  int32_t       port;
+  int32_t       local_port  = 0;
+  int32_t       access_mode = 0;
+  char          service[8];
+  char          host[SIM_MQTT_HOST_LEN];
+  sim_socket_t* socket = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !arg_int(args, &cid) || cid < 1 ||
+      cid >= BG95_SIM_MAX_PDP_CONTEXTS || !(socket = socket_arg(sim, args, &id)) ||
+      !arg_str(args, service, sizeof(service)) || !arg_str(args, host, sizeof(host)) ||
+      !arg_int(args, &port))
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (!arg_opt_int(args, &local_port) || !arg_opt_int(args, &access_mode) || access_mode != 0 ||
+      (strcmp(service, "TCP") != 0 && strcmp(service, "UDP") != 0))
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  if (socket->open)
+  {
+    defer_urc(sim, "+QIOPEN: %d,563", (int) id); // Socket identity has been used
+  }
+  else if (!sim->pdp[cid].active)
+  {
+    defer_urc(sim, "+QIOPEN: %d,561", (int) id); // Open PDP context failed
+  }
+  else
+  {
+    memset(socket, 0, sizeof(*socket));
+    socket->open       = true;
+    socket->context_id = cid;
+    defer_urc(sim, "+QIOPEN: %d,0", (int) id);
+  }
+  return SIM_RESULT_OK;
+}
+
+// The whole payload of a QISEND has been received - the echo server sends it straight back
+static void qisend_payload_done(bg95_sim_t* sim, uint64_t now)
+{
+  sim_socket_t* socket = &sim->sockets[sim->send_socket];
+
+  memcpy(sim->answer, "\r\nSEND OK\r\n", 11);
+  sim->answer_len = 11;
+  schedule(sim, sim->answer, sim->answer_len, now + (uint64_t) sim->config.latency_ms * 1000U);
+
+  // What does not fit into the receive buffer is lost, as on the module
+  bool   was_empty = socket->rx_len == 0;
+  size_t room      = sizeof(socket->rx) - socket->rx_len;
+  size_t len       = sim->payload_len < room ? sim->payload_len : room;
+  memcpy(socket->rx + socket->rx_len, sim->payload, len);
+  socket->rx_len += len;
+  sim->stats.socket_echoed += len;
+
+  // 'recv' is only reported when data arrives in an empty buffer
+  if (was_empty && len > 0)
+  {
+    defer_urc(sim, "+QIURC: \"recv\",%u", sim->send_socket);
+    flush_deferred(sim, now, sim->config.latency_ms + sim->config.urc_delay_ms);
+  }
+}
+
+static sim_result_t
+cmd_qisend(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  int32_t       id;
+  int32_t       len;
+  sim_socket_t* socket = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(socket = socket_arg(sim, args, &id)) || !socket->open ||
+      !arg_int(args, &len) || len < 1 || len > BG95_SIM_MAX_PUBLISH_LEN)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  sim->send_socket      = (uint8_t) id;
+  sim->payload_len      = 0;
+  sim->payload_expected = (size_t) len;
+  sim->payload_done     = qisend_payload_done;
+
+  memcpy(sim->answer, "\r\n> ", 4);
+  sim->answer_len = 4;
+  return SIM_RESULT_NONE;
+}
+
+// +QIRD: <read_actual_length>, then the data as it is - it can hold anything, CRLF included
+static sim_result_t
+cmd_qird(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  int32_t       id;
+  int32_t       max_len;
+  sim_socket_t* socket = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(socket = socket_arg(sim, args, &id)) || !socket->open ||
+      !arg_int(args, &max_len) || max_len < 0)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  size_t len = socket->rx_len < (size_t) max_len ? socket->rx_len : (size_t) max_len;
+  if (len + 32 > sizeof(sim->answer))
+  {
+    len = sizeof(sim->answer) - 32;
+  }
+  answer_line(sim, "+QIRD: %u", (unsigned) len);
+  if (len > 0)
+  {
+    memcpy(sim->answer + sim->answer_len, socket->rx, len);
+    sim->answer_len += len;
+    memcpy(sim->answer + sim->answer_len, "\r\n", 2);
+    sim->answer_len += 2;
+    memmove(socket->rx, socket->rx + len, socket->rx_len - len);
+    socket->rx_len -= len;
+  }
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_qiclose(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  int32_t       id;
+  sim_socket_t* socket = NULL;
+  if (type != AT_CMD_TYPE_WRITE || !(socket = socket_arg(sim, args, &id)))
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  // Closing a socket that is not open is not an error
+  memset(socket, 0, sizeof(*socket));
+  return SIM_RESULT_OK;
+}
+
+// ------------------------------ FILES ---------------------------------
+
+// "UFS:" is the only storage - the prefix is optional
+static const char* file_base_name(const char* name)
+{
+  return strncmp(name, "UFS:", 4) == 0 ? name + 4 : name;
+}
+
+static sim_file_t* file_find(bg95_sim_t* sim, const char* name)
+{
+  const char* base = file_base_name(name);
+  for (int i = 0; i < BG95_SIM_MAX_FILES; i++)
+  {
+    if (sim->files[i].used && strcmp(sim->files[i].name, base) == 0)
+    {
+      return &sim->files[i];
+    }
+  }
+  return NULL;
+}
+
+// An empty file, NULL if the name is invalid or there is no room for another file
+static sim_file_t* file_create(bg95_sim_t* sim, const char* name)
+{
+  const char* base = file_base_name(name);
+  size_t      len  = strlen(base);
+  if (len == 0 || len > BG95_SIM_MAX_FILE_NAME_LEN)
+  {
+    return NULL;
+  }
+
+  for (int i = 0; i < BG95_SIM_MAX_FILES; i++)
+  {
+    if (!sim->files[i].used)
+    {
+      sim_file_t* file = &sim->files[i];
+      memset(file, 0, sizeof(*file));
+      file->used = true;
+      memcpy(file->name, base, len + 1);
+      return file;
+    }
+  }
+  return NULL;
+}
+
+// Room for 'len' bytes - false if that is more than a file can hold
+static bool file_reserve(sim_file_t* file, size_t len)
+{
+  if (len > BG95_SIM_MAX_FILE_LEN)
+  {
+    return false;
+  }
+  if (len <= file->capacity)
+  {
+    return true;
+  }
+
+  size_t capacity = file->capacity ? file->capacity : 1024;
+  while (capacity < len)
+  {
+    capacity *= 2;
+  }
+  capacity      = capacity < BG95_SIM_MAX_FILE_LEN ? capacity : BG95_SIM_MAX_FILE_LEN;
+  uint8_t* data = realloc(file->data, capacity);
+  if (!data)
+  {
+    return false;
+  }
+  file->data     = data;
+  file->capacity = capacity;
+  return true;
+}
+
+static bool file_is_open(const bg95_sim_t* sim, const sim_file_t* file)
+{
+  for (int i = 0; i < BG95_SIM_MAX_OPEN_FILES; i++)
+  {
+    if (sim->open_files[i].open && &sim->files[sim->open_files[i].file] == file)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Open file of a QF* write command, NULL if the handle is not one
+static sim_open_file_t* file_handle_arg(bg95_sim_t* sim, at_tokenizer_t* args)
+{
+  int32_t handle;
+  if (!arg_int(args, &handle) || handle < SIM_FILE_HANDLE_BASE ||
+      handle >= SIM_FILE_HANDLE_BASE + BG95_SIM_MAX_OPEN_FILES ||
+      !sim->open_files[handle - SIM_FILE_HANDLE_BASE].open)
+  {
+    return NULL;
+  }
+  return &sim->open_files[handle - SIM_FILE_HANDLE_BASE];
+}
+
+// XOR of the data taken as 16 bit big endian words, as QFDWL reports it
+static uint16_t file_checksum(const uint8_t* data, size_t len)
+{
+  uint16_t checksum = 0;
+  for (size_t i = 0; i < len; i++)
+  {
+    checksum ^= (i & 1) ? data[i] : (uint16_t) (data[i] << 8);
+  }
+  return checksum;
+}
+
+// Error codes are the module's: 400 invalid value, 405 not found, 406 invalid name, 413 too many
+// open files, 414 read only, 416 invalid handle, 420 no space, 423 file too large, 426 already open
+static sim_result_t
+cmd_qfopen(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  char    name[BG95_SIM_MAX_FILE_NAME_LEN + 8];
+  int32_t mode = 0;
+  if (type != AT_CMD_TYPE_WRITE || !arg_str(args, name, sizeof(name)) ||
+      !arg_opt_int(args, &mode) || mode < 0 || mode > 2)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  int slot = 0;
+  while (slot < BG95_SIM_MAX_OPEN_FILES && sim->open_files[slot].open)
+  {
+    slot++;
+  }
+  if (slot == BG95_SIM_MAX_OPEN_FILES)
+  {
+    return cme(sim, 413);
+  }
+
+  sim_file_t* file = file_find(sim, name);
+  if (file && file_is_open(sim, file))
+  {
+    return cme(sim, 426);
+  }
+  if (!file && mode == 2)
+  {
+    return cme(sim, 405);
+  }
+  if (!file)
+  {
+    size_t len = strlen(file_base_name(name));
+    file       = file_create(sim, name);
+    if (!file)
+    {
+      return cme(sim, (len == 0 || len > BG95_SIM_MAX_FILE_NAME_LEN) ? 406 : 420);
+    }
+  }
+  if (mode == 1)
+  {
+    file->len = 0;
+  }
+
+  sim->open_files[slot] = (sim_open_file_t) {
+      .open = true, .file = (int) (file - sim->files), .read_only = mode == 2, .position = 0};
+  answer_line(sim, "+QFOPEN: %d", SIM_FILE_HANDLE_BASE + slot);
+  return SIM_RESULT_OK;
+}
+
+static sim_result_t
+cmd_qfclose(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  sim_open_file_t* open_file = NULL;
+  if (type != AT_CMD_TYPE_WRITE)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (!(open_file = file_handle_arg(sim, args)))
+  {
+    return cme(sim, 416);
+  }
+
+  memset(open_file, 0, sizeof(*open_file));
+  return SIM_RESULT_OK;
+}
+
+// The pointer can not be moved past the end of the file
+static sim_result_t
+cmd_qfseek(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  sim_open_file_t* open_file = NULL;
+  int32_t          offset;
+  int32_t          position = 0;
+  if (type != AT_CMD_TYPE_WRITE)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (!(open_file = file_handle_arg(sim, args)))
+  {
+    return cme(sim, 416);
+  }
+  if (!arg_int(args, &offset) || offset < 0 || !arg_opt_int(args, &position) || position < 0 ||
+      position > 2)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  size_t len  = sim->files[open_file->file].len;
+  size_t base = position == 0 ? 0 : (position == 1 ? open_file->position : len);
+  if (base + (size_t) offset > len)
+  {
+    return cme(sim, 400);
+  }
+  open_file->position = base + (size_t) offset;
+  return SIM_RESULT_OK;
+}
+
+// CONNECT <read_length>, then the data as it is and OK - 0 bytes at the end of the file
+static sim_result_t
+cmd_qfread(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  sim_open_file_t* open_file = NULL;
+  int32_t          max_len   = INT32_MAX; // Everything up to the end of the file
+  if (type != AT_CMD_TYPE_WRITE)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (!(open_file = file_handle_arg(sim, args)))
+  {
+    return cme(sim, 416);
+  }
+  if (!arg_opt_int(args, &max_len) || max_len < 1)
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  const sim_file_t* file = &sim->files[open_file->file];
+  size_t            left = file->len > open_file->position ? file->len - open_file->position : 0;
+  size_t            len  = left < (size_t) max_len ? left : (size_t) max_len;
+  if (len + 32 > sizeof(sim->answer))
+  {
+    len = sizeof(sim->answer) - 32;
+  }
+
+  answer_line(sim, "CONNECT %u", (unsigned) len);
+  if (len > 0)
+  {
+    memcpy(sim->answer + sim->answer_len, file->data + open_file->position, len);
+    sim->answer_len += len;
+    open_file->position += len;
+  }
+  sim->stats.file_read += len;
+  return SIM_RESULT_OK;
+}
+
+// The whole payload of a QFWRITE has been received - room for it was made before the CONNECT
+static void qfwrite_payload_done(bg95_sim_t* sim, uint64_t now)
+{
+  sim_open_file_t* open_file = &sim->open_files[sim->write_file];
+  sim_file_t*      file      = &sim->files[open_file->file];
+
+  memcpy(file->data + open_file->position, sim->payload, sim->payload_len);
+  open_file->position += sim->payload_len;
+  if (open_file->position > file->len)
+  {
+    file->len = open_file->position;
+  }
+  sim->stats.file_written += sim->payload_len;
+
+  sim->answer_len = 0;
+  answer_line(sim, "+QFWRITE: %u,%u", (unsigned) sim->payload_len, (unsigned) file->len);
+  memcpy(sim->answer + sim->answer_len, "\r\nOK\r\n", 6);
+  sim->answer_len += 6;
+  schedule(sim, sim->answer, sim->answer_len, now + (uint64_t) sim->config.latency_ms * 1000U);
+}
+
+// Only writes of exactly <length> bytes - the input time is not modelled
+static sim_result_t
+cmd_qfwrite(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  (void) now;
+
+  sim_open_file_t* open_file = NULL;
+  int32_t          len;
+  int32_t          input_time_s = 5;
+  if (type != AT_CMD_TYPE_WRITE)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (!(open_file = file_handle_arg(sim, args)))
+  {
+    return cme(sim, 416);
+  }
+  if (!arg_int(args, &len) || len < 1 || len > BG95_SIM_MAX_PUBLISH_LEN ||
+      !arg_opt_int(args, &input_time_s) || input_time_s < 1)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  if (open_file->read_only)
+  {
+    return cme(sim, 414);
+  }
+  if (!file_reserve(&sim->files[open_file->file], open_file->position + (size_t) len))
+  {
+    return cme(sim, 423);
+  }
+
+  sim->write_file       = (uint8_t) (open_file - sim->open_files);
+  sim->payload_len      = 0;
+  sim->payload_expected = (size_t) len;
+  sim->payload_done     = qfwrite_payload_done;
+
+  answer_line(sim, "CONNECT");
+  return SIM_RESULT_NONE;
+}
+
+// CONNECT, the whole file, then +QFDWL: <size>,<checksum>. The file goes out as its own piece, so
+// truncate and garble faults only hit the final OK
+static sim_result_t
+cmd_qfdwl(bg95_sim_t* sim, at_cmd_type_t type, at_tokenizer_t* args, uint64_t now)
+{
+  char name[BG95_SIM_MAX_FILE_NAME_LEN + 8];
+  if (type != AT_CMD_TYPE_WRITE || !arg_str(args, name, sizeof(name)))
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  const sim_file_t* file = file_find(sim, name);
+  if (!file)
+  {
+    return cme(sim, 405);
+  }
+
+  char*  output = malloc(file->len + 64);
+  size_t len    = 0;
+  if (!output)
+  {
+    return SIM_RESULT_ERROR;
+  }
+  memcpy(output, "\r\nCONNECT\r\n", 11);
+  len = 11;
+  if (file->len > 0)
+  {
+    memcpy(output + len, file->data, file->len);
+    len += file->len;
+  }
+  len += (size_t) snprintf(output + len,
+                           file->len + 64 - len,
+                           "\r\n+QFDWL: %u,%x\r\n",
+                           (unsigned) file->len,
+                           file_checksum(file->data, file->len));
+  schedule(sim, output, len, now + (uint64_t) sim->config.latency_ms * 1000U);
+  free(output);
+
+  sim->stats.file_read += file->len;
+  return SIM_RESULT_OK;
+}
+
+typedef struct
+{
+  const char* name;
+  sim_cmd_fn  fn;
+} sim_cmd_t;
+
+static const sim_cmd_t SIM_CMDS[] = {
+    {"CEREG", cmd_cereg},
+    {"CFUN", cmd_cfun},
+    {"CGACT", cmd_cgact},
+    {"CGATT", cmd_cgatt},
+    {"CGDCONT", cmd_cgdcont},
+    {"CGPADDR", cmd_cgpaddr},
+    {"COPS", cmd_cops},
+    {"CPIN", cmd_cpin},
+    {"CREG", cmd_creg},
+    {"CSQ", cmd_csq},
+    {"QFCLOSE", cmd_qfclose},
+    {"QFDWL", cmd_qfdwl},
+    {"QFOPEN", cmd_qfopen},
+    {"QFREAD", cmd_qfread},
+    {"QFSEEK", cmd_qfseek},
+    {"QFWRITE", cmd_qfwrite},
+    {"QICLOSE", cmd_qiclose},
+    {"QIOPEN", cmd_qiopen},
+    {"QIRD", cmd_qird},
+    {"QISEND", cmd_qisend},
+    {"QMTCLOSE", cmd_qmtclose},
+    {"QMTCONN", cmd_qmtconn},
+    {"QMTDISC", cmd_qmtdisc},
+    {"QMTOPEN", cmd_qmtopen},
+    {"QMTPUB", cmd_qmtpub},
+    {"QMTSUB", cmd_qmtsub},
+    {"QMTUNS", cmd_qmtuns},
+};
+
+// ------------------------------ COMMAND LINE ---------------------------------
+
+static sim_result_t run_extended(bg95_sim_t* sim, const char* cmd, uint64_t now)
+{
+  char   name[16];
+  size_t name_len = 0;
+  while (name_len < sizeof(name) - 1 &&
+         ((cmd[name_len] >= 'A' && cmd[name_len] <= 'Z') ||
+          (cmd[name_len] >= '0' && cmd[name_len] <= '9')))
+  {
+    name[name_len] = cmd[name_len];
+    name_len++;
+  }
+  name[name_len] = '\0';
+
+  const char*   rest = cmd + name_len;
+  at_cmd_type_t type;
+  if (strcmp(rest, "=?") == 0)
+  {
+    type = AT_CMD_TYPE_TEST;
+  }
+  else if (strcmp(rest, "?") == 0)
+  {
+    type = AT_CMD_TYPE_READ;
+  }
+  else if (rest[0] == '=')
+  {
+    type = AT_CMD_TYPE_WRITE;
+    rest++;
+  }
+  else if (rest[0] == '\0')
+  {
+    type = AT_CMD_TYPE_EXECUTE;
+  }
+  else
+  {
+    return SIM_RESULT_ERROR;
+  }
+
+  at_tokenizer_t args;
+  at_tokenizer_init_span(&args, rest, type == AT_CMD_TYPE_WRITE ? strlen(rest) : 0);
+
+  for (size_t i = 0; i < sizeof(SIM_CMDS) / sizeof(SIM_CMDS[0]); i++)
+  {
+    if (strcmp(SIM_CMDS[i].name, name) == 0)
+    {
+      return SIM_CMDS[i].fn(sim, type, &args, now);
+    }
+  }
+  return SIM_RESULT_ERROR;
+}
+
+static sim_fault_t* take_fault(bg95_sim_t* sim, const char* line)
+{
+  for (int i = 0; i < BG95_SIM_MAX_FAULTS; i++)
+  {
+    sim_fault_t* fault = &sim->faults[i];
+    if (fault->count > 0 && strncasecmp(line, fault->prefix, strlen(fault->prefix)) == 0)
+    {
+      fault->count--;
+      sim->stats.faults++;
+      return fault;
+    }
+  }
+  return NULL;
+}
+
+static void run_line(bg95_sim_t* sim, const char* line, uint64_t now)
+{
+  // Anything that is not a command is ignored, as the module does
+  if (strncasecmp(line, "AT", 2) != 0)
+  {
+    return;
+  }
+  sim->stats.commands++;
+  sim->answer_len = 0;
+
+  // Truncated, garbled and delayed answers still come from a command that was run (and changed
+  // the state) - the other faults replace it
+  const sim_fault_t* fault   = take_fault(sim, line);
+  uint64_t           due_us  = now + (uint64_t) sim->config.latency_ms * 1000U;
+  sim_result_t       result  = SIM_RESULT_ERROR;
+  const char*        cmd     = line + 2;
+  bool               run_cmd = !fault || fault->kind >= BG95_SIM_FAULT_TRUNCATE;
+
+  if (fault && fault->kind == BG95_SIM_FAULT_NO_ANSWER)
+  {
+    return;
+  }
+  if (fault && fault->kind == BG95_SIM_FAULT_CME_ERROR)
+  {
+    result = cme(sim, fault->code);
+  }
+  else if (!run_cmd)
+  {
+    result = SIM_RESULT_ERROR;
+  }
+  else if (cmd[0] == '\0')
+  {
+    result = SIM_RESULT_OK;
+  }
+  else if ((cmd[0] == 'E' || cmd[0] == 'e') && (cmd[1] == '0' || cmd[1] == '1' || cmd[1] == '\0'))
+  {
+    sim->echo = cmd[1] == '1';
+    result    = SIM_RESULT_OK;
+  }
+  else if (cmd[0] == '+')
+  {
+    result = run_extended(sim, cmd + 1, now);
+  }
+
+  // The final result is always preceded by an empty line - information lines end with CRLF, so
+  // after them it takes one more
+  switch (result)
+  {
+    case SIM_RESULT_OK:
+      if (sim->answer_len > 0)
+      {
+        memcpy(sim->answer + sim->answer_len, "\r\n", 2);
+        sim->answer_len += 2;
+      }
+      answer_line(sim, "OK");
+      break;
+    case SIM_RESULT_ERROR:
+      sim->answer_len = 0;
+      answer_line(sim, "ERROR");
+      break;
+    case SIM_RESULT_CME:
+      sim->answer_len = 0;
+      answer_line(sim, "+CME ERROR: %d", sim->cme_error);
+      break;
+    case SIM_RESULT_NONE:
+      break;
+  }
+
+  if (fault && fault->kind == BG95_SIM_FAULT_TRUNCATE)
+  {
+    sim->answer_len /= 2;
+  }
+  else if (fault && fault->kind == BG95_SIM_FAULT_GARBLE && sim->answer_len > 0)
+  {
+    sim->answer[sim->answer_len / 2] ^= 0x55;
+  }
+  else if (fault && fault->kind == BG95_SIM_FAULT_DELAY)
+  {
+    due_us += (uint64_t) fault->code * 1000U;
+  }
+
+  schedule(sim, sim->answer, sim->answer_len, due_us);
+  flush_deferred(sim, due_us, sim->config.urc_delay_ms);
+}
+
+// ------------------------------ PUBLIC API ---------------------------------
+
+esp_err_t bg95_sim_write(bg95_sim_t* sim, const char* data, size_t len)
+{
+  if (!sim || (!data && len > 0))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  uint64_t now = now_us();
+  sim->stats.bytes_in += len;
+
+  size_t echo_start = 0;
+  for (size_t i = 0; i < len; i++)
+  {
+    char c          = data[i];
+    bool after_line = sim->line_ended;
+    sim->line_ended = false;
+    if (after_line && c == '\n')
+    {
+      echo_start = i + 1;
+      continue;
+    }
+
+    if (sim->payload_expected)
+    {
+      sim->payload[sim->payload_len++] = c;
+      if (sim->payload_len == sim->payload_expected)
+      {
+        sim->payload_expected = 0;
+        sim->payload_done(sim, now);
+      }
+      echo_start = i + 1; // The payload is not echoed
+      continue;
+    }
+
+    if (c == '\r')
+    {
+      if (sim->echo)
+      {
+        schedule(sim, data + echo_start, i + 1 - echo_start, now);
+      }
+      echo_start = i + 1;
+
+      if (sim->line_overflow)
+      {
+        schedule(sim, "\r\nERROR\r\n", 9, now + (uint64_t) sim->config.latency_ms * 1000U);
+      }
+      else if (sim->line_len > 0)
+      {
+        sim->line[sim->line_len] = '\0';
+        run_line(sim, sim->line, now);
+      }
+      sim->line_len      = 0;
+      sim->line_overflow = false;
+      sim->line_ended    = true;
+    }
+    else if (c != '\n')
+    {
+      if (sim->line_len < sizeof(sim->line) - 1)
+      {
+        sim->line[sim->line_len++] = c;
+      }
+      else
+      {
+        sim->line_overflow = true;
+      }
+    }
+  }
+  if (sim->echo && echo_start < len)
+  {
+    schedule(sim, data + echo_start, len - echo_start, now);
+  }
+
+  pthread_mutex_unlock(&sim->lock);
+  return ESP_OK;
+}
+
+esp_err_t bg95_sim_read(
+    bg95_sim_t* sim, char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms)
+{
+  if (!sim || !buffer || max_len == 0 || !bytes_read)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  size_t limit = max_len - 1;
+  if (sim->config.max_read_len && limit > sim->config.max_read_len)
+  {
+    limit = sim->config.max_read_len;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  uint64_t deadline = now_us() + (uint64_t) timeout_ms * 1000U;
+  size_t   got      = 0;
+  for (;;)
+  {
+    uint64_t now = now_us();
+    advance(sim, now);
+    got = collect(sim, now, buffer, limit);
+    if (got > 0 || now >= deadline)
+    {
+      break;
+    }
+
+    uint64_t wake = next_event_us(sim);
+    if (wake > deadline)
+    {
+      wake = deadline;
+    }
+    struct timespec until = {.tv_sec  = (time_t) (wake / 1000000U),
+                             .tv_nsec = (long) (wake % 1000000U) * 1000L};
+    pthread_cond_timedwait(&sim->changed, &sim->lock, &until);
+  }
+  sim->stats.bytes_out += got;
+  pthread_mutex_unlock(&sim->lock);
+
+  buffer[got] = '\0';
+  *bytes_read = got;
+  return ESP_OK;
+}
+
+static esp_err_t sim_uart_write(const char* data, size_t len, void* context)
+{
+  return bg95_sim_write((bg95_sim_t*) context, data, len);
+}
+
+static esp_err_t sim_uart_read(
+    char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context)
+{
+  return bg95_sim_read((bg95_sim_t*) context, buffer, max_len, bytes_read, timeout_ms);
+}
+
+esp_err_t bg95_sim_uart_init(bg95_sim_t* sim, bg95_uart_interface_t* uart)
+{
+  if (!sim || !uart)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(uart, 0, sizeof(bg95_uart_interface_t));
+  uart->write   = sim_uart_write;
+  uart->read    = sim_uart_read;
+  uart->context = sim;
+  return ESP_OK;
+}
+
+esp_err_t bg95_sim_create(const bg95_sim_config_t* config, bg95_sim_t** sim)
+{
+  if (!config || !sim || (config->sim_inserted && config->pin && config->pin[0] == '\0'))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_sim_t* new_sim = calloc(1, sizeof(bg95_sim_t));
+  if (!new_sim)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&new_sim->changed, &attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&new_sim->lock, NULL);
+
+  new_sim->config      = *config;
+  new_sim->echo        = config->echo;
+  new_sim->cfun        = 1;
+  new_sim->radio_on_us = now_us();
+  new_sim->attached    = true;
+
+  *sim = new_sim;
+  return ESP_OK;
+}
+
+void bg95_sim_destroy(bg95_sim_t* sim)
+{
+  if (!sim)
+  {
+    return;
+  }
+
+  free_segments(sim->pending);
+  free_segments(sim->line_head);
+  for (int i = 0; i < BG95_SIM_MAX_FILES; i++)
+  {
+    free(sim->files[i].data);
+  }
+  pthread_cond_destroy(&sim->changed);
+  pthread_mutex_destroy(&sim->lock);
+  free(sim);
+}
+
+void bg95_sim_set_timing(bg95_sim_t* sim,
+                         uint32_t    latency_ms,
+                         uint32_t    bytes_per_sec,
+                         size_t      max_read_len)
+{
+  if (!sim)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  sim->config.latency_ms    = latency_ms;
+  sim->config.bytes_per_sec = bytes_per_sec;
+  sim->config.max_read_len  = max_read_len;
+  pthread_mutex_unlock(&sim->lock);
+}
+
+esp_err_t bg95_sim_inject_urc(bg95_sim_t* sim, const char* line, uint32_t delay_ms)
+{
+  if (!sim || !line)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  defer_urc(sim, "%s", line);
+  flush_deferred(sim, now_us(), delay_ms);
+  pthread_mutex_unlock(&sim->lock);
+  return ESP_OK;
+}
+
+esp_err_t bg95_sim_inject_fault(bg95_sim_t*           sim,
+                                const char*           cmd_prefix,
+                                bg95_sim_fault_kind_t kind,
+                                int                   code,
+                                uint32_t              count)
+{
+  if (!sim || !cmd_prefix || strlen(cmd_prefix) >= SIM_FAULT_PREFIX_LEN || count == 0 ||
+      kind > BG95_SIM_FAULT_DELAY)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = ESP_ERR_NO_MEM;
+  pthread_mutex_lock(&sim->lock);
+  for (int i = 0; i < BG95_SIM_MAX_FAULTS; i++)
+  {
+    sim_fault_t* fault = &sim->faults[i];
+    if (fault->count == 0)
+    {
+      snprintf(fault->prefix, sizeof(fault->prefix), "%s", cmd_prefix);
+      fault->kind  = kind;
+      fault->code  = code;
+      fault->count = count;
+      err          = ESP_OK;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&sim->lock);
+  return err;
+}
+
+void bg95_sim_clear_faults(bg95_sim_t* sim)
+{
+  if (!sim)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  memset(sim->faults, 0, sizeof(sim->faults));
+  pthread_mutex_unlock(&sim->lock);
+}
+
+void bg95_sim_set_registered(bg95_sim_t* sim, bool registered)
+{
+  if (!sim)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  uint64_t now = now_us();
+  if (sim->network_lost == registered)
+  {
+    sim->network_lost = !registered;
+    if (!registered)
+    {
+      network_down(sim, true);
+    }
+    registration_urcs(sim, registration_stat(sim, now));
+    flush_deferred(sim, now, 0);
+  }
+  pthread_mutex_unlock(&sim->lock);
+}
+
+void bg95_sim_drop_mqtt(bg95_sim_t* sim, uint8_t client_idx)
+{
+  if (!sim || client_idx >= BG95_SIM_MAX_MQTT_CLIENTS)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  if (sim->mqtt[client_idx].state != SIM_MQTT_CLOSED)
+  {
+    memset(&sim->mqtt[client_idx], 0, sizeof(sim->mqtt[client_idx]));
+    defer_urc(sim, "+QMTSTAT: %u,1", client_idx);
+    flush_deferred(sim, now_us(), 0);
+  }
+  pthread_mutex_unlock(&sim->lock);
+}
+
+void bg95_sim_close_socket(bg95_sim_t* sim, uint8_t connect_id)
+{
+  if (!sim || connect_id >= BG95_SIM_MAX_SOCKETS)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  if (sim->sockets[connect_id].open)
+  {
+    memset(&sim->sockets[connect_id], 0, sizeof(sim->sockets[connect_id]));
+    defer_urc(sim, "+QIURC: \"closed\",%u", connect_id);
+    flush_deferred(sim, now_us(), 0);
+  }
+  pthread_mutex_unlock(&sim->lock);
+}
+
+esp_err_t bg95_sim_write_file(bg95_sim_t* sim, const char* name, const void* data, size_t len)
+{
+  size_t name_len = name ? strlen(file_base_name(name)) : 0;
+  if (!sim || name_len == 0 || name_len > BG95_SIM_MAX_FILE_NAME_LEN || (!data && len > 0))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  esp_err_t   err  = ESP_OK;
+  sim_file_t* file = file_find(sim, name);
+  if (!file)
+  {
+    file = file_create(sim, name);
+  }
+  if (!file)
+  {
+    err = ESP_ERR_NO_MEM;
+  }
+  else if (!file_reserve(file, len))
+  {
+    err = ESP_ERR_INVALID_SIZE;
+  }
+  else
+  {
+    if (len > 0)
+    {
+      memcpy(file->data, data, len);
+    }
+    file->len = len;
+  }
+  pthread_mutex_unlock(&sim->lock);
+  return err;
+}
+
+esp_err_t bg95_sim_read_file(
+    bg95_sim_t* sim, const char* name, void* buffer, size_t buffer_size, size_t* len)
+{
+  if (!sim || !name || (!buffer && buffer_size > 0) || !len)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  esp_err_t         err  = ESP_OK;
+  const sim_file_t* file = file_find(sim, name);
+  if (!file)
+  {
+    err = ESP_ERR_NOT_FOUND;
+  }
+  else if (file->len > buffer_size)
+  {
+    err = ESP_ERR_INVALID_SIZE;
+  }
+  else
+  {
+    if (file->len > 0)
+    {
+      memcpy(buffer, file->data, file->len);
+    }
+    *len = file->len;
+  }
+  pthread_mutex_unlock(&sim->lock);
+  return err;
+}
+
+void bg95_sim_get_stats(bg95_sim_t* sim, bg95_sim_stats_t* stats)
+{
+  if (!sim || !stats)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&sim->lock);
+  *stats = sim->stats;
+  pthread_mutex_unlock(&sim->lock);
+}
+
+bool bg95_sim_models(const char* name)
+{
+  if (!name)
+  {
+    return false;
+  }
+
+  // Basic commands are answered by run_line itself
+  if (strcmp(name, "AT") == 0)
+  {
+    return true;
+  }
+  for (size_t i = 0; i < sizeof(SIM_CMDS) / sizeof(SIM_CMDS[0]); i++)
+  {
+    if (strcmp(SIM_CMDS[i].name, name) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,140 @@
+// Stateful BG95 simulator for the host build. It answers on a bg95_uart_interface_t like the module
+// would - SIM / PIN, radio, registration, PDP contexts, MQTT clients with a loopback broker, TCP /
+// UDP sockets to an echo server, the file system (UFS) - and can be made slow, choppy or faulty on
+// purpose:
+//
+//   - latency:      every answer starts 'latency_ms' after its command
+//   - throttling:   answers leave at 'bytes_per_sec' (e.g. 11520 for 115200 baud)
+//   - fragmentation: a read returns at most 'max_read_len' bytes
+//   - URCs:         injected at any time (bg95_sim_inject_urc), or raised by the state
+//   - faults:       per command prefix (bg95_sim_inject_fault)
+//
+// Everything the simulator sends is scheduled on a timeline, so a read only returns what a real
+// UART would have received by then. Thread safe - a test can inject URCs or faults while the
+// handler is waiting for an answer.
+//
+// Commands: AT, ATE, +CPIN, +CFUN, +CREG, +CEREG, +CSQ, +COPS, +CGATT, +CGDCONT, +CGACT, +CGPADDR,
+// +QMTOPEN, +QMTCONN, +QMTSUB, +QMTUNS, +QMTPUB, +QMTDISC, +QMTCLOSE, +QIOPEN, +QISEND, +QIRD,
+// +QICLOSE, +QFOPEN, +QFWRITE, +QFREAD, +QFSEEK, +QFCLOSE, +QFDWL. Anything else is answered with
+// ERROR. Sockets only use buffer access mode: what is sent comes back, and waits (up to
+// BG95_SIM_SOCKET_BUFFER_LEN) to be read with QIRD. Files are kept in memory for the lifetime of
+// the simulator, with or without the "UFS:" prefix.
+#pragma once
+
+#include "bg95_uart_interface.h"
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BG95_SIM_MAX_PDP_CONTEXTS 16 // cid 1..15
+#define BG95_SIM_MAX_MQTT_CLIENTS 6
+#define BG95_SIM_MAX_SUBSCRIPTIONS 8 // Per client
+#define BG95_SIM_MAX_FAULTS 8
+#define BG95_SIM_MAX_LINE_LEN 1024       // Longest command line
+#define BG95_SIM_MAX_PUBLISH_LEN 4096    // Also the longest QISEND and QFWRITE
+#define BG95_SIM_MAX_SOCKETS 12          // connectID 0..11
+#define BG95_SIM_SOCKET_BUFFER_LEN 16384 // Receive buffer per socket
+#define BG95_SIM_MAX_FILES 16
+#define BG95_SIM_MAX_OPEN_FILES 4
+#define BG95_SIM_MAX_FILE_LEN 262144  // Larger writes fail with +CME ERROR: 423
+#define BG95_SIM_MAX_FILE_NAME_LEN 80 // Without the "UFS:" prefix
+
+typedef struct
+{
+  uint32_t    latency_ms;        // End of a command to the start of its answer
+  uint32_t    urc_delay_ms;      // OK to the result URC of a network operation (e.g. +QMTOPEN)
+  uint32_t    bytes_per_sec;     // 0 - no limit
+  size_t      max_read_len;      // 0 - no limit
+  uint32_t    register_delay_ms; // Radio on (and SIM ready) to registered
+  bool        echo;              // ATE1 after reset
+  bool        sim_inserted;
+  const char* pin;  // NULL - the SIM does not ask for a PIN
+  int         rssi; // +CSQ value, 0..31 (99 unknown)
+} bg95_sim_config_t;
+
+#define BG95_SIM_CONFIG_DEFAULT()                                                                  \
+  {                                                                                                \
+    .latency_ms = 0, .urc_delay_ms = 0, .bytes_per_sec = 0, .max_read_len = 0,                     \
+    .register_delay_ms = 0, .echo = false, .sim_inserted = true, .pin = NULL, .rssi = 20           \
+  }
+
+typedef enum
+{
+  BG95_SIM_FAULT_ERROR     = 0U, // Answer ERROR
+  BG95_SIM_FAULT_CME_ERROR = 1U, // Answer +CME ERROR: <code>
+  BG95_SIM_FAULT_NO_ANSWER = 2U, // Swallow the command - the host times out
+  BG95_SIM_FAULT_TRUNCATE  = 3U, // Only the first half of the answer is sent
+  BG95_SIM_FAULT_GARBLE    = 4U, // One byte in the middle of the answer is flipped
+  BG95_SIM_FAULT_DELAY     = 5U, // The answer comes <code> ms late
+} bg95_sim_fault_kind_t;
+
+typedef struct
+{
+  uint32_t commands;       // Command lines processed
+  uint32_t faults;         // Faults applied
+  uint32_t urcs;           // Unsolicited lines sent (injected or raised by the state)
+  uint32_t mqtt_delivered; // Messages looped back to a subscriber
+  uint64_t socket_echoed;  // Bytes the socket echo server sent back
+  uint64_t file_written;   // Bytes written to files (QFWRITE)
+  uint64_t file_read;      // Bytes read from files (QFREAD, QFDWL)
+  uint64_t bytes_in;
+  uint64_t bytes_out;
+} bg95_sim_stats_t;
+
+typedef struct bg95_sim bg95_sim_t;
+
+esp_err_t bg95_sim_create(const bg95_sim_config_t* config, bg95_sim_t** sim);
+
+void bg95_sim_destroy(bg95_sim_t* sim);
+
+// Fill 'uart' so the handler talks to the simulator (no physical line settings)
+esp_err_t bg95_sim_uart_init(bg95_sim_t* sim, bg95_uart_interface_t* uart);
+
+// The raw byte stream, e.g. to serve the simulator over a pty. Reads behave like the UART read -
+// at most max_len - 1 bytes, NUL terminated, waiting up to 'timeout_ms' for the first byte
+esp_err_t bg95_sim_write(bg95_sim_t* sim, const char* data, size_t len);
+esp_err_t bg95_sim_read(
+    bg95_sim_t* sim, char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms);
+
+// Change the line timing while running (e.g. to sweep a throughput benchmark)
+void bg95_sim_set_timing(bg95_sim_t* sim,
+                         uint32_t    latency_ms,
+                         uint32_t    bytes_per_sec,
+                         size_t      max_read_len);
+
+// Send "\r\n<line>\r\n" after 'delay_ms'
+esp_err_t bg95_sim_inject_urc(bg95_sim_t* sim, const char* line, uint32_t delay_ms);
+
+// The next 'count' commands starting with 'cmd_prefix' (e.g. "AT+QMTCONN", or "AT" for all) get
+// the fault. 'code' is the CME error for BG95_SIM_FAULT_CME_ERROR and the delay for _DELAY
+esp_err_t bg95_sim_inject_fault(bg95_sim_t*           sim,
+                                const char*           cmd_prefix,
+                                bg95_sim_fault_kind_t kind,
+                                int                   code,
+                                uint32_t              count);
+
+void bg95_sim_clear_faults(bg95_sim_t* sim);
+
+// Network side events. Losing the registration deactivates the PDP contexts and closes the MQTT
+// connections (+QMTSTAT), and +CEREG / +CREG URCs are sent if they were enabled
+void bg95_sim_set_registered(bg95_sim_t* sim, bool registered);
+
+// The broker drops the connection of an MQTT client (+QMTSTAT: <client_idx>,1)
+void bg95_sim_drop_mqtt(bg95_sim_t* sim, uint8_t client_idx);
+
+// The peer closes a socket (+QIURC: "closed",<connectID>)
+void bg95_sim_close_socket(bg95_sim_t* sim, uint8_t connect_id);
+
+// Files as the host sees them through QFOPEN / QFDWL - e.g. to check an upload, or to store a file
+// for a download. A file that is written is created, or replaced. ESP_ERR_NOT_FOUND - no such file,
+// ESP_ERR_INVALID_SIZE - 'buffer' is too small, or the data larger than BG95_SIM_MAX_FILE_LEN
+esp_err_t bg95_sim_write_file(bg95_sim_t* sim, const char* name, const void* data, size_t len);
+esp_err_t bg95_sim_read_file(
+    bg95_sim_t* sim, const char* name, void* buffer, size_t buffer_size, size_t* len);
+
+void bg95_sim_get_stats(bg95_sim_t* sim, bg95_sim_stats_t* stats);
+
+// Whether the simulator models command 'name' (at_cmd_t.name, e.g. "CSQ") - see the list above
+bool bg95_sim_models(const char* name);
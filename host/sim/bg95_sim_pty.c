@@ -0,0 +1,100 @@
+// Serves the simulator on a pseudo terminal, so anything that opens a serial port (a terminal
+// program, another build of the driver) can talk to it:
+//
+//   bg95_sim_pty [latency_ms] [bytes_per_sec]
+//
+// The slave device path is printed on start. Runs until interrupted.
+#include "bg95_sim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define PTY_POLL_MS 5
+
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int signal)
+{
+  s_stop = 1;
+}
+
+int main(int argc, char** argv)
+{
+  bg95_sim_config_t config = BG95_SIM_CONFIG_DEFAULT();
+  config.echo              = true;
+  config.latency_ms        = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : 0;
+  config.bytes_per_sec     = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 10) : 0;
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    perror("posix_openpt");
+    return 1;
+  }
+
+  // Raw - no line discipline between the host and the simulator
+  struct termios tio;
+  if (tcgetattr(master, &tio) == 0)
+  {
+    cfmakeraw(&tio);
+    tcsetattr(master, TCSANOW, &tio);
+  }
+
+  bg95_sim_t* sim = NULL;
+  if (bg95_sim_create(&config, &sim) != ESP_OK)
+  {
+    fprintf(stderr, "Failed to create the simulator\n");
+    close(master);
+    return 1;
+  }
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  printf("%s\n", ptsname(master));
+  fflush(stdout);
+
+  char buffer[512];
+  while (!s_stop)
+  {
+    struct pollfd pfd = {.fd = master, .events = POLLIN};
+    int           ready = poll(&pfd, 1, PTY_POLL_MS);
+    if (ready < 0 && errno != EINTR)
+    {
+      perror("poll");
+      break;
+    }
+
+    if (ready > 0 && (pfd.revents & POLLIN))
+    {
+      ssize_t len = read(master, buffer, sizeof(buffer));
+      if (len > 0)
+      {
+        bg95_sim_write(sim, buffer, (size_t) len);
+      }
+    }
+
+    // POLLHUP only means the slave is not open (yet) - keep serving
+    if (ready > 0 && !(pfd.revents & POLLIN))
+    {
+      usleep(PTY_POLL_MS * 1000);
+    }
+
+    size_t got = 0;
+    bg95_sim_read(sim, buffer, sizeof(buffer), &got, 0);
+    if (got > 0 && write(master, buffer, got) < 0)
+    {
+      perror("write");
+      break;
+    }
+  }
+
+  bg95_sim_destroy(sim);
+  close(master);
+  return 0;
+}
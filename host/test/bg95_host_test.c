@@ -0,0 +1,268 @@
+// Unit tests of the driver, built for the host (see host/CMakeLists.txt) and run by ctest:
+//
+//   - codec: parsers and formatters of the command table, through the handler and the mock UART
+//   - data_mode: data mode reads and the NO CARRIER marker
+//   - psm: PSM / eDRX timer encoding, the CPSMS / CEDRXS commands and the PSM publish queue
+//   - attach: the attach hint and the fallback to a full scan
+//   - ssl: QSSLCFG setters and queries of the SSL contexts
+//   - pool: the worker pool over several simulated modems
+//   - socket: TCP / UDP sockets over the simulator's echo server
+//   - file: file uploads and downloads over the simulator's file system
+//   - scan: the background operator scan, its cancel and the one-scan-at-a-time rule
+//   - sleep: waking the module for a command, and keeping it awake for queued ones
+//
+// Each suite registers its cases itself (TEST_SUITE in test.h), in link order.
+//
+// Every check of a test is run - a failed one is reported with its file and line and makes the
+// exit code non-zero.
+//
+//   bg95_host_test [filter]
+//
+//   filter  only the tests whose name or suite contains 'filter'
+#include "esp_err.h"
+#include "esp_log.h"
+#include "test.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MAX_SUITES 32
+
+typedef struct
+{
+  const test_case_t* cases;
+  size_t             num_cases;
+} test_suite_t;
+
+static test_suite_t       s_suites[TEST_MAX_SUITES];
+static size_t             s_num_suites;
+static const test_case_t* s_current;
+static uint32_t           s_failures; // Of the running test
+
+// ------------------------------ SUITES ---------------------------------
+
+void test_register_suite(const test_case_t* cases, size_t num_cases)
+{
+  // Runs before main - there is nobody to return an error to
+  if (s_num_suites == TEST_MAX_SUITES)
+  {
+    fprintf(stderr, "More than %d test suites\n", TEST_MAX_SUITES);
+    abort();
+  }
+  s_suites[s_num_suites++] = (test_suite_t) {cases, num_cases};
+}
+
+// ------------------------------ CHECKS ---------------------------------
+
+void test_fail(const char* file, int line, const char* format, ...)
+{
+  // Only the file name - the build directory is not of interest
+  const char* base = strrchr(file, '/');
+  base             = base ? base + 1 : file;
+
+  printf("  %s:%d: %s: ", base, line, s_current ? s_current->name : "?");
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+  printf("\n");
+  s_failures++;
+}
+
+// ------------------------------ MOCK UART ---------------------------------
+
+esp_err_t test_mock_init(test_mock_t*                mock,
+                         const mock_uart_response_t* responses,
+                         size_t                      num_responses)
+{
+  memset(mock, 0, sizeof(*mock));
+
+  esp_err_t err = mock_uart_init(&mock->uart, responses, num_responses);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = at_cmd_handler_init(&mock->handler, &mock->uart);
+  if (err != ESP_OK)
+  {
+    mock_uart_deinit(&mock->uart);
+  }
+  return err;
+}
+
+void test_mock_deinit(test_mock_t* mock)
+{
+  at_cmd_handler_deinit(&mock->handler);
+  mock_uart_deinit(&mock->uart);
+}
+
+const char* test_mock_last_cmd(const test_mock_t* mock)
+{
+  const mock_uart_state_t* state = (const mock_uart_state_t*) mock->uart.context;
+  return state ? state->last_received_cmd : "";
+}
+
+static const bg95_config_t DRIVER_CONFIG = {.pwrkey_gpio_num = 0,
+                                            .status_gpio_num = BG95_GPIO_NOT_USED,
+                                            .dtr_gpio_num    = BG95_GPIO_NOT_USED};
+
+esp_err_t test_driver_init(test_driver_t*              driver,
+                           const mock_uart_response_t* responses,
+                           size_t                      num_responses)
+{
+  memset(driver, 0, sizeof(*driver));
+
+  esp_err_t err = mock_uart_init(&driver->uart, responses, num_responses);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  driver->handle = malloc(sizeof(bg95_handle_t));
+  err            = driver->handle
+                       ? bg95_init_with_config(driver->handle, &driver->uart, &DRIVER_CONFIG)
+                       : ESP_ERR_NO_MEM;
+  if (err != ESP_OK)
+  {
+    test_driver_deinit(driver);
+  }
+  return err;
+}
+
+void test_driver_deinit(test_driver_t* driver)
+{
+  if (driver->handle)
+  {
+    bg95_deinit(driver->handle); // Frees the handle
+    driver->handle = NULL;
+  }
+  mock_uart_deinit(&driver->uart);
+}
+
+const char* test_driver_last_cmd(const test_driver_t* driver)
+{
+  const mock_uart_state_t* state = (const mock_uart_state_t*) driver->uart.context;
+  return state ? state->last_received_cmd : "";
+}
+
+// ------------------------------ SIMULATOR ---------------------------------
+
+esp_err_t test_sim_init(test_sim_t* fixture, const bg95_sim_config_t* config)
+{
+  memset(fixture, 0, sizeof(*fixture));
+
+  bg95_sim_config_t default_config = BG95_SIM_CONFIG_DEFAULT();
+  esp_err_t err = bg95_sim_create(config ? config : &default_config, &fixture->sim);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  bg95_uart_interface_t uart;
+  bg95_sim_uart_init(fixture->sim, &uart);
+  fixture->handle = malloc(sizeof(bg95_handle_t));
+  err = fixture->handle ? bg95_init_with_config(fixture->handle, &uart, &DRIVER_CONFIG)
+                        : ESP_ERR_NO_MEM;
+
+  qmtopen_write_response_t open_response;
+  qmtconn_write_response_t conn_response;
+  if (err == ESP_OK)
+  {
+    err = bg95_define_pdp_context(fixture->handle, 1, CGDCONT_PDP_TYPE_IP, "test");
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_activate_pdp_context(fixture->handle, 1);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_mqtt_open_network(
+        fixture->handle, TEST_SIM_MQTT_CLIENT, "broker", 1883, &open_response);
+  }
+  if (err == ESP_OK)
+  {
+    err = bg95_mqtt_connect(
+        fixture->handle, TEST_SIM_MQTT_CLIENT, "test", NULL, NULL, &conn_response);
+  }
+
+  if (err != ESP_OK)
+  {
+    test_sim_deinit(fixture);
+  }
+  return err;
+}
+
+void test_sim_deinit(test_sim_t* fixture)
+{
+  if (fixture->handle)
+  {
+    bg95_deinit(fixture->handle); // Frees the handle
+    fixture->handle = NULL;
+  }
+  if (fixture->sim)
+  {
+    bg95_sim_destroy(fixture->sim);
+    fixture->sim = NULL;
+  }
+}
+
+// ------------------------------ MAIN ---------------------------------
+
+static bool selected(const test_case_t* test, const char* filter)
+{
+  return !filter || strstr(test->name, filter) || strstr(test->suite, filter);
+}
+
+int main(int argc, char** argv)
+{
+  const char* filter = NULL;
+  if (argc == 2 && argv[1][0] != '-')
+  {
+    filter = argv[1];
+  }
+  else if (argc != 1)
+  {
+    fprintf(stderr, "usage: %s [filter]\n", argv[0]);
+    return 2;
+  }
+
+  // Errors the tests provoke on purpose would bury the failures
+  esp_log_level_set("*", ESP_LOG_NONE);
+
+  uint32_t run    = 0;
+  uint32_t failed = 0;
+  for (size_t s = 0; s < s_num_suites; s++)
+  {
+    for (size_t i = 0; i < s_suites[s].num_cases; i++)
+    {
+      const test_case_t* test = &s_suites[s].cases[i];
+      if (!selected(test, filter))
+      {
+        continue;
+      }
+
+      s_current  = test;
+      s_failures = 0;
+      test->run();
+      run++;
+      if (s_failures)
+      {
+        failed++;
+      }
+      printf("%-8s %s/%s\n", s_failures ? "FAILED" : "ok", test->suite, test->name);
+    }
+  }
+  s_current = NULL;
+
+  if (run == 0)
+  {
+    fprintf(stderr, "No test matches '%s'\n", filter);
+    return 2;
+  }
+  printf("\n%lu of %lu tests failed\n", (unsigned long) failed, (unsigned long) run);
+  return failed ? 1 : 0;
+}
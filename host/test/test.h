@@ -0,0 +1,144 @@
+// Shared by the host unit tests (see bg95_host_test.c)
+#pragma once
+
+#include "at_cmd_handler.h"
+#include "bg95_driver.h"
+#include "bg95_sim.h"
+#include "bg95_uart_interface.h"
+#include "esp_err.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef void (*test_fn)(void);
+
+typedef struct
+{
+  const char* name;
+  const char* suite;
+  test_fn     run;
+} test_case_t;
+
+// Records a failed check of the running test - the test carries on, so one run shows every failure
+void test_fail(const char* file, int line, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define TEST_ASSERT(cond)                                                                          \
+  do                                                                                               \
+  {                                                                                                \
+    if (!(cond))                                                                                   \
+    {                                                                                              \
+      test_fail(__FILE__, __LINE__, "%s", #cond);                                                  \
+    }                                                                                              \
+  } while (0)
+
+#define TEST_ASSERT_EQUAL_INT(expected, actual)                                                    \
+  do                                                                                               \
+  {                                                                                                \
+    long long test_expected_ = (long long) (expected);                                             \
+    long long test_actual_   = (long long) (actual);                                               \
+    if (test_expected_ != test_actual_)                                                            \
+    {                                                                                              \
+      test_fail(__FILE__,                                                                          \
+                __LINE__,                                                                          \
+                "%s: expected %lld, got %lld",                                                     \
+                #actual,                                                                           \
+                test_expected_,                                                                    \
+                test_actual_);                                                                     \
+    }                                                                                              \
+  } while (0)
+
+#define TEST_ASSERT_EQUAL_STRING(expected, actual)                                                 \
+  do                                                                                               \
+  {                                                                                                \
+    const char* test_expected_ = (expected);                                                       \
+    const char* test_actual_   = (actual);                                                         \
+    if (strcmp(test_expected_, test_actual_) != 0)                                                 \
+    {                                                                                              \
+      test_fail(__FILE__,                                                                          \
+                __LINE__,                                                                          \
+                "%s: expected \"%s\", got \"%s\"",                                                 \
+                #actual,                                                                           \
+                test_expected_,                                                                    \
+                test_actual_);                                                                     \
+    }                                                                                              \
+  } while (0)
+
+#define TEST_ASSERT_ERR(expected, expr)                                                            \
+  do                                                                                               \
+  {                                                                                                \
+    esp_err_t test_expected_ = (expected);                                                         \
+    esp_err_t test_actual_   = (expr);                                                             \
+    if (test_expected_ != test_actual_)                                                            \
+    {                                                                                              \
+      test_fail(__FILE__,                                                                          \
+                __LINE__,                                                                          \
+                "%s: expected %s, got %s",                                                         \
+                #expr,                                                                             \
+                esp_err_to_name(test_expected_),                                                   \
+                esp_err_to_name(test_actual_));                                                    \
+    }                                                                                              \
+  } while (0)
+
+#define TEST_ASSERT_OK(expr) TEST_ASSERT_ERR(ESP_OK, expr)
+
+// ------------------------------ MOCK UART ---------------------------------
+
+// A handler over the mock UART. 'responses' are matched against the last command written, in
+// order - put a bare "AT" last, it matches every command
+typedef struct
+{
+  bg95_uart_interface_t uart;
+  at_cmd_handler_t      handler;
+} test_mock_t;
+
+esp_err_t test_mock_init(test_mock_t*                mock,
+                         const mock_uart_response_t* responses,
+                         size_t                      num_responses);
+void      test_mock_deinit(test_mock_t* mock);
+
+// The last command written to the mock, with its "\r\n"
+const char* test_mock_last_cmd(const test_mock_t* mock);
+
+// A driver over the mock UART. bg95_init_with_config probes the module with "AT", so 'responses'
+// must end with a bare "AT"
+typedef struct
+{
+  bg95_uart_interface_t uart;
+  bg95_handle_t*        handle;
+} test_driver_t;
+
+esp_err_t   test_driver_init(test_driver_t*              driver,
+                             const mock_uart_response_t* responses,
+                             size_t                      num_responses);
+void        test_driver_deinit(test_driver_t* driver);
+const char* test_driver_last_cmd(const test_driver_t* driver);
+
+// ------------------------------ SIMULATOR ---------------------------------
+
+#define TEST_SIM_MQTT_CLIENT 0
+
+// A driver over the simulator, with PDP context 1 active and MQTT client TEST_SIM_MQTT_CLIENT
+// connected to the loopback broker. 'config' NULL - BG95_SIM_CONFIG_DEFAULT
+typedef struct
+{
+  bg95_sim_t*    sim;
+  bg95_handle_t* handle;
+} test_sim_t;
+
+esp_err_t test_sim_init(test_sim_t* fixture, const bg95_sim_config_t* config);
+void      test_sim_deinit(test_sim_t* fixture);
+
+// ------------------------------ SUITES ---------------------------------
+
+// Registers the cases of a suite with bg95_host_test.c before main runs - once at the end of every
+// test_<suite>.c, e.g. TEST_SUITE(sleep, SLEEP_CASES). The suite also needs its name in
+// BG95_TEST_SUITES (host/CMakeLists.txt), which builds test_<suite>.c and adds its ctest entry
+void test_register_suite(const test_case_t* cases, size_t num_cases);
+
+#define TEST_SUITE(name_, cases_)                                                                  \
+  __attribute__((constructor)) static void test_register_##name_(void)                             \
+  {                                                                                                \
+    test_register_suite((cases_), sizeof(cases_) / sizeof((cases_)[0]));                           \
+  }
@@ -0,0 +1,170 @@
+// Attach hint: what is saved from QNWINFO, and that a hinted attach that does not register puts
+// the user's scan config back
+#include "bg95_driver.h"
+#include "bg95_persist.h"
+#include "test.h"
+
+// The user's own scan config, as the module reports it: NB-IoT first, LTE bands 3, 8 and 20. A
+// query and a write of the same setting both match - the write takes the OK
+#define USER_SEQUENCE_RESPONSE "\r\n+QCFG: \"nwscanseq\",0302\r\n\r\nOK\r\n"
+#define USER_BANDS_RESPONSE "\r\n+QCFG: \"band\",0x1,0x80084,0x80084\r\n\r\nOK\r\n"
+#define USER_BANDS_CMD "AT+QCFG=\"band\",0x1,0x80084,0x80084,1\r\n"
+
+static void save_hint(qcfg_rat_t rat, uint8_t lte_band)
+{
+  bg95_attach_hint_t hint = {.version = BG95_ATTACH_HINT_VERSION, .rat = rat, .lte_band = lte_band};
+  TEST_ASSERT_OK(bg95_persist_save(BG95_PERSIST_KEY_ATTACH_HINT, &hint, sizeof(hint)));
+}
+
+static void test_save_attach_hint(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QNWINFO", "\r\n+QNWINFO: \"eMTC\",\"310260\",\"LTE BAND 3\",1575\r\n\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 2));
+
+  TEST_ASSERT_OK(bg95_save_attach_hint(driver.handle));
+
+  bg95_attach_hint_t hint;
+  TEST_ASSERT_OK(bg95_load_attach_hint(&hint));
+  TEST_ASSERT_EQUAL_INT(QCFG_RAT_EMTC, hint.rat);
+  TEST_ASSERT_EQUAL_INT(3, hint.lte_band);
+  TEST_ASSERT_EQUAL_STRING("310260", hint.operator_numeric);
+
+  bg95_clear_attach_hint();
+  test_driver_deinit(&driver);
+}
+
+// Registered - the narrowed config is kept, and what it replaced is handed back
+static void test_attach_with_hint_registered(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QCFG=\"nwscanseq\"", USER_SEQUENCE_RESPONSE, 0},
+      {"AT+QCFG=\"band\"", USER_BANDS_RESPONSE, 0},
+      {"AT+CEREG?", "\r\n+CEREG: 0,1\r\n\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 4));
+  save_hint(QCFG_RAT_EMTC, 3);
+
+  bg95_scan_config_t previous = {0};
+  TEST_ASSERT_OK(bg95_attach_with_hint(driver.handle, 0, &previous));
+  TEST_ASSERT_EQUAL_STRING("AT+CEREG?\r\n", test_driver_last_cmd(&driver));
+  TEST_ASSERT_EQUAL_INT(2, previous.sequence.num_rats);
+  TEST_ASSERT_EQUAL_INT(QCFG_RAT_NBIOT, previous.sequence.rats[0]);
+  TEST_ASSERT_EQUAL_INT(QCFG_RAT_EMTC, previous.sequence.rats[1]);
+  TEST_ASSERT_EQUAL_INT(0x1, previous.bands.gsm);
+  TEST_ASSERT_EQUAL_INT(0x80084, previous.bands.emtc.low);
+
+  bg95_clear_attach_hint();
+  test_driver_deinit(&driver);
+}
+
+// Only the hinted RAT is narrowed to the hinted band - the other RATs keep the user's bands
+static void test_apply_attach_hint_keeps_other_bands(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QCFG=\"nwscanseq\"", USER_SEQUENCE_RESPONSE, 0},
+      {"AT+QCFG=\"band\"", USER_BANDS_RESPONSE, 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 3));
+  save_hint(QCFG_RAT_EMTC, 3);
+
+  TEST_ASSERT_OK(bg95_apply_attach_hint(driver.handle, NULL));
+  TEST_ASSERT_EQUAL_STRING("AT+QCFG=\"band\",0x1,0x4,0x80084,1\r\n", test_driver_last_cmd(&driver));
+
+  bg95_clear_attach_hint();
+  test_driver_deinit(&driver);
+}
+
+// Not registered within the timeout - the user's band masks go back, not the factory ones
+static void test_attach_with_hint_timeout_restores_bands(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QCFG=\"nwscanseq\"", USER_SEQUENCE_RESPONSE, 0},
+      {"AT+QCFG=\"band\"", USER_BANDS_RESPONSE, 0},
+      {"AT+CEREG?", "\r\n+CEREG: 0,2\r\n\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 4));
+  save_hint(QCFG_RAT_EMTC, 3);
+
+  TEST_ASSERT_ERR(ESP_ERR_TIMEOUT, bg95_attach_with_hint(driver.handle, 0, NULL));
+  TEST_ASSERT_EQUAL_STRING(USER_BANDS_CMD, test_driver_last_cmd(&driver));
+
+  bg95_clear_attach_hint();
+  test_driver_deinit(&driver);
+}
+
+static void test_attach_with_hint_denied_restores_bands(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QCFG=\"nwscanseq\"", USER_SEQUENCE_RESPONSE, 0},
+      {"AT+QCFG=\"band\"", USER_BANDS_RESPONSE, 0},
+      {"AT+CEREG?", "\r\n+CEREG: 0,3\r\n\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 4));
+  save_hint(QCFG_RAT_NBIOT, 20);
+
+  TEST_ASSERT_ERR(ESP_FAIL, bg95_attach_with_hint(driver.handle, 60000, NULL));
+  TEST_ASSERT_EQUAL_STRING(USER_BANDS_CMD, test_driver_last_cmd(&driver));
+
+  bg95_clear_attach_hint();
+  test_driver_deinit(&driver);
+}
+
+// The config cannot be read - nothing is narrowed, so nothing is written back either
+static void test_attach_with_hint_unreadable_config(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QCFG", "\r\nERROR\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 2));
+  save_hint(QCFG_RAT_EMTC, 3);
+
+  TEST_ASSERT(bg95_attach_with_hint(driver.handle, 0, NULL) != ESP_OK);
+  TEST_ASSERT_EQUAL_STRING("AT+QCFG=\"nwscanseq\"\r\n", test_driver_last_cmd(&driver));
+
+  bg95_clear_attach_hint();
+  test_driver_deinit(&driver);
+}
+
+// Without a hint nothing is narrowed, so there is nothing to restore
+static void test_attach_without_hint(void)
+{
+  static const mock_uart_response_t responses[] = {{"AT", "\r\nOK\r\n", 0}};
+  test_driver_t                     driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 1));
+  bg95_clear_attach_hint();
+
+  TEST_ASSERT_ERR(ESP_ERR_NOT_FOUND, bg95_attach_with_hint(driver.handle, 0, NULL));
+  TEST_ASSERT(strstr(test_driver_last_cmd(&driver), "QCFG") == NULL);
+
+  test_driver_deinit(&driver);
+}
+
+static const test_case_t ATTACH_CASES[] = {
+    {"save_attach_hint", "attach", test_save_attach_hint},
+    {"attach_with_hint_registered", "attach", test_attach_with_hint_registered},
+    {"apply_attach_hint_keeps_other_bands", "attach", test_apply_attach_hint_keeps_other_bands},
+    {"attach_with_hint_timeout_restores_bands",
+     "attach",
+     test_attach_with_hint_timeout_restores_bands},
+    {"attach_with_hint_denied_restores_bands",
+     "attach",
+     test_attach_with_hint_denied_restores_bands},
+    {"attach_with_hint_unreadable_config", "attach", test_attach_with_hint_unreadable_config},
+    {"attach_without_hint", "attach", test_attach_without_hint},
+};
+
+TEST_SUITE(attach, ATTACH_CASES)
@@ -0,0 +1,225 @@
+// Parsers and formatters of the command table, end to end through the handler and the mock UART:
+// the exact command written and the parsed response are checked
+#include "at_cmd_cereg.h"
+#include "at_cmd_cgdcont.h"
+#include "at_cmd_cops.h"
+#include "at_cmd_csq.h"
+#include "test.h"
+
+// ------------------------------ CEREG ---------------------------------
+
+static void test_cereg_read_with_psm_timers(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CEREG?",
+       "\r\n+CEREG: 4,1,\"1A2B\",\"01A2D001\",8,,,\"00100001\",\"00000110\"\r\n\r\nOK\r\n",
+       0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cereg_read_response_t read;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CEREG, AT_CMD_TYPE_READ, NULL, &read));
+  TEST_ASSERT_EQUAL_STRING("AT+CEREG?\r\n", test_mock_last_cmd(&mock));
+  TEST_ASSERT_EQUAL_INT(CEREG_N_ENABLE_URC_PSM, read.n);
+  TEST_ASSERT_EQUAL_INT(CEREG_STAT_HOME, read.stat);
+  TEST_ASSERT(read.present.has_tac && read.present.has_ci && read.present.has_act);
+  TEST_ASSERT_EQUAL_STRING("1A2B", read.tac);
+  TEST_ASSERT_EQUAL_STRING("01A2D001", read.ci);
+  TEST_ASSERT_EQUAL_INT(CEREG_ACT_EMTC, read.act);
+  TEST_ASSERT(read.present.has_active_time && read.present.has_periodic_tau);
+  TEST_ASSERT_EQUAL_STRING("00100001", read.active_time);
+  TEST_ASSERT_EQUAL_STRING("00000110", read.periodic_tau);
+
+  test_mock_deinit(&mock);
+}
+
+static void test_cereg_read_not_registered(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CEREG?", "\r\n+CEREG: 0,2\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cereg_read_response_t read;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CEREG, AT_CMD_TYPE_READ, NULL, &read));
+  TEST_ASSERT_EQUAL_INT(CEREG_N_DISABLE_URC, read.n);
+  TEST_ASSERT_EQUAL_INT(CEREG_STAT_SEARCHING, read.stat);
+  TEST_ASSERT(!read.present.has_tac && !read.present.has_ci && !read.present.has_act);
+  TEST_ASSERT(!read.present.has_active_time && !read.present.has_periodic_tau);
+
+  test_mock_deinit(&mock);
+}
+
+static void test_cereg_write(void)
+{
+  static const mock_uart_response_t responses[] = {{"AT+CEREG=", "\r\nOK\r\n", 0}};
+  test_mock_t                       mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cereg_write_params_t params = {.n = CEREG_N_ENABLE_URC_LOCATION};
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CEREG, AT_CMD_TYPE_WRITE, &params, NULL));
+  TEST_ASSERT_EQUAL_STRING("AT+CEREG=2\r\n", test_mock_last_cmd(&mock));
+
+  test_mock_deinit(&mock);
+}
+
+static void test_cereg_read_error(void)
+{
+  static const mock_uart_response_t responses[] = {{"AT+CEREG?", "\r\n+CME ERROR: 10\r\n", 0}};
+  test_mock_t                       mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cereg_read_response_t read;
+  TEST_ASSERT_ERR(ESP_FAIL,
+                  at_cmd_handler_send_and_receive_cmd(
+                      &mock.handler, &AT_CMD_CEREG, AT_CMD_TYPE_READ, NULL, &read));
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ CGDCONT ---------------------------------
+
+static void test_cgdcont_write(void)
+{
+  static const mock_uart_response_t responses[] = {{"AT+CGDCONT=", "\r\nOK\r\n", 0}};
+  test_mock_t                       mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cgdcont_write_params_t params = {.cid      = 1,
+                                   .pdp_type = CGDCONT_PDP_TYPE_IP,
+                                   .apn      = "internet",
+                                   .present  = {.has_pdp_type = true, .has_apn = true}};
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CGDCONT, AT_CMD_TYPE_WRITE, &params, NULL));
+  // The PDP address is left empty once the APN is given
+  TEST_ASSERT_EQUAL_STRING("AT+CGDCONT=1,\"IP\",\"internet\",\"\"\r\n", test_mock_last_cmd(&mock));
+
+  // Only the cid - deletes the context
+  params.present = (cgdcont_present_flags_t) {0};
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CGDCONT, AT_CMD_TYPE_WRITE, &params, NULL));
+  TEST_ASSERT_EQUAL_STRING("AT+CGDCONT=1\r\n", test_mock_last_cmd(&mock));
+
+  test_mock_deinit(&mock);
+}
+
+// Longer than a read chunk - the response arrives in several reads
+static void test_cgdcont_read_multiple_contexts(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CGDCONT?",
+       "\r\n+CGDCONT: 1,\"IP\",\"internet\",\"0.0.0.0\",0,0,0\r\n"
+       "+CGDCONT: 2,\"IPV4V6\",\"iot.example\",\"0.0.0.0\",0,0,0\r\n\r\nOK\r\n",
+       0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cgdcont_read_response_t read;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CGDCONT, AT_CMD_TYPE_READ, NULL, &read));
+  TEST_ASSERT_EQUAL_STRING("AT+CGDCONT?\r\n", test_mock_last_cmd(&mock));
+  TEST_ASSERT_EQUAL_INT(2, read.num_contexts);
+  TEST_ASSERT_EQUAL_INT(1, read.contexts[0].cid);
+  TEST_ASSERT_EQUAL_INT(CGDCONT_PDP_TYPE_IP, read.contexts[0].pdp_type);
+  TEST_ASSERT_EQUAL_STRING("internet", read.contexts[0].apn);
+  TEST_ASSERT_EQUAL_INT(2, read.contexts[1].cid);
+  TEST_ASSERT_EQUAL_INT(CGDCONT_PDP_TYPE_IPV4V6, read.contexts[1].pdp_type);
+  TEST_ASSERT_EQUAL_STRING("iot.example", read.contexts[1].apn);
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ COPS ---------------------------------
+
+static void test_cops_test_operator_list(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+COPS=?",
+       "\r\n+COPS: (2,\"Vodafone.de\",\"Vodafone\",\"26202\",8),"
+       "(1,\"Telekom.de\",\"TDG\",\"26201\",9),(3,\"o2 - de\",\"o2 - de\",\"26203\",0),"
+       ",(0-4),(0-2)\r\n\r\nOK\r\n",
+       0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cops_test_response_t test;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_COPS, AT_CMD_TYPE_TEST, NULL, &test));
+  TEST_ASSERT_EQUAL_STRING("AT+COPS=?\r\n", test_mock_last_cmd(&mock));
+  TEST_ASSERT_EQUAL_INT(3, test.num_operators);
+  TEST_ASSERT_EQUAL_INT(COPS_STAT_CURRENT_OPERATOR, test.operators[0].stat);
+  TEST_ASSERT_EQUAL_STRING("Vodafone.de", test.operators[0].long_name);
+  TEST_ASSERT_EQUAL_STRING("Vodafone", test.operators[0].short_name);
+  TEST_ASSERT_EQUAL_STRING("26202", test.operators[0].numeric);
+  TEST_ASSERT_EQUAL_INT(COPS_ACT_EMTC, test.operators[0].act);
+  TEST_ASSERT_EQUAL_INT(COPS_STAT_OPERATOR_AVAILABLE, test.operators[1].stat);
+  TEST_ASSERT_EQUAL_INT(COPS_ACT_NB_IOT, test.operators[1].act);
+  TEST_ASSERT_EQUAL_INT(COPS_STAT_OPERATOR_FORBIDDEN, test.operators[2].stat);
+  TEST_ASSERT_EQUAL_STRING("26203", test.operators[2].numeric);
+
+  test_mock_deinit(&mock);
+}
+
+static void test_cops_read(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+COPS?", "\r\n+COPS: 0,2,\"26202\",8\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  cops_read_response_t read;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_COPS, AT_CMD_TYPE_READ, NULL, &read));
+  TEST_ASSERT_EQUAL_INT(COPS_MODE_AUTO, read.mode);
+  TEST_ASSERT(read.present.has_format && read.present.has_operator && read.present.has_act);
+  TEST_ASSERT_EQUAL_INT(COPS_FORMAT_NUMERIC, read.format);
+  TEST_ASSERT_EQUAL_STRING("26202", read.operator_name);
+  TEST_ASSERT_EQUAL_INT(COPS_ACT_EMTC, read.act);
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ CSQ ---------------------------------
+
+static void test_csq_execute(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CSQ", "\r\n+CSQ: 18,99\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  csq_execute_response_t csq;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CSQ, AT_CMD_TYPE_EXECUTE, NULL, &csq));
+  TEST_ASSERT_EQUAL_STRING("AT+CSQ\r\n", test_mock_last_cmd(&mock));
+  TEST_ASSERT_EQUAL_INT(18, csq.rssi);
+  TEST_ASSERT_EQUAL_INT(CSQ_BER_UNKNOWN, csq.ber);
+  TEST_ASSERT_EQUAL_INT(-77, csq_rssi_to_dbm(csq.rssi));
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ CASES ---------------------------------
+
+static const test_case_t CODEC_CASES[] = {
+    {"cereg_read_with_psm_timers", "codec", test_cereg_read_with_psm_timers},
+    {"cereg_read_not_registered", "codec", test_cereg_read_not_registered},
+    {"cereg_write", "codec", test_cereg_write},
+    {"cereg_read_error", "codec", test_cereg_read_error},
+    {"cgdcont_write", "codec", test_cgdcont_write},
+    {"cgdcont_read_multiple_contexts", "codec", test_cgdcont_read_multiple_contexts},
+    {"cops_test_operator_list", "codec", test_cops_test_operator_list},
+    {"cops_read", "codec", test_cops_read},
+    {"csq_execute", "codec", test_csq_execute},
+};
+
+TEST_SUITE(codec, CODEC_CASES)
@@ -0,0 +1,205 @@
+// Data (transparent) mode reads: NO CARRIER is found wherever the reads split it, and only the data
+// before it is returned
+#include "at_cmd_handler.h"
+#include "test.h"
+
+#define SCRIPT_MAX_CHUNKS 8
+
+// A UART that answers ATO with CONNECT, then returns one scripted chunk per read. Like the real one
+// it reads at most max_len - 1 bytes and NUL terminates them
+typedef struct
+{
+  const char* chunks[SCRIPT_MAX_CHUNKS];
+  size_t      num_chunks;
+  size_t      next;
+  const char* pending; // Rest of the chunk being read
+} script_uart_t;
+
+static esp_err_t script_write(const char* data, size_t len, void* context)
+{
+  script_uart_t* script = (script_uart_t*) context;
+  if (len >= 3 && memcmp(data, "ATO", 3) == 0)
+  {
+    script->pending = "\r\nCONNECT\r\n";
+  }
+  return ESP_OK;
+}
+
+static esp_err_t
+script_read(char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context)
+{
+  script_uart_t* script = (script_uart_t*) context;
+  if ((!script->pending || !*script->pending) && script->next < script->num_chunks)
+  {
+    script->pending = script->chunks[script->next++];
+  }
+
+  *bytes_read = 0;
+  if (script->pending)
+  {
+    size_t len  = strlen(script->pending);
+    *bytes_read = len < max_len - 1 ? len : max_len - 1;
+    memcpy(buffer, script->pending, *bytes_read);
+    script->pending += *bytes_read;
+  }
+  buffer[*bytes_read] = '\0';
+  return ESP_OK;
+}
+
+typedef struct
+{
+  script_uart_t         script;
+  bg95_uart_interface_t uart;
+  at_cmd_handler_t      handler;
+} data_fixture_t;
+
+// The handler, switched to data mode with ATO
+static void fixture_init(data_fixture_t* fixture)
+{
+  memset(fixture, 0, sizeof(*fixture));
+  fixture->uart.write   = script_write;
+  fixture->uart.read    = script_read;
+  fixture->uart.context = &fixture->script;
+  TEST_ASSERT_OK(at_cmd_handler_init(&fixture->handler, &fixture->uart));
+  TEST_ASSERT_OK(at_cmd_handler_resume_data_mode(&fixture->handler));
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_DATA, at_cmd_handler_get_mode(&fixture->handler));
+}
+
+static void fixture_script(data_fixture_t* fixture, const char* const* chunks, size_t num_chunks)
+{
+  for (size_t i = 0; i < num_chunks && i < SCRIPT_MAX_CHUNKS; i++)
+  {
+    fixture->script.chunks[i] = chunks[i];
+  }
+  fixture->script.num_chunks = num_chunks;
+  fixture->script.next       = 0;
+}
+
+// Reads once, NUL terminating what was returned
+static size_t fixture_read(data_fixture_t* fixture, char* buffer, size_t size)
+{
+  size_t bytes_read = 0;
+  TEST_ASSERT_OK(at_cmd_handler_data_read(&fixture->handler, buffer, size - 1, &bytes_read, 0));
+  buffer[bytes_read] = '\0';
+  return bytes_read;
+}
+
+// ------------------------------ CASES ---------------------------------
+
+static void test_no_carrier_in_one_read(void)
+{
+  static const char* const chunks[] = {"payload\r\nNO CARRIER\r\n"};
+  data_fixture_t           fixture;
+  char                     buffer[64];
+  fixture_init(&fixture);
+  fixture_script(&fixture, chunks, 1);
+
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("payload", buffer);
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_COMMAND, at_cmd_handler_get_mode(&fixture.handler));
+
+  at_cmd_handler_deinit(&fixture.handler);
+}
+
+static void test_no_carrier_split_across_reads(void)
+{
+  static const char* const chunks[] = {"hello\r\nNO CAR", "RIER\r\n"};
+  data_fixture_t           fixture;
+  char                     buffer[64];
+  fixture_init(&fixture);
+  fixture_script(&fixture, chunks, 2);
+
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("hello", buffer);
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_DATA, at_cmd_handler_get_mode(&fixture.handler));
+
+  TEST_ASSERT_EQUAL_INT(0, fixture_read(&fixture, buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_COMMAND, at_cmd_handler_get_mode(&fixture.handler));
+
+  at_cmd_handler_deinit(&fixture.handler);
+}
+
+// Not at the end of the read - what follows the marker is not data
+static void test_no_carrier_mid_chunk(void)
+{
+  static const char* const chunks[] = {"abc\r\nNO CARRIER\r\n\r\n+QIURC: \"closed\",0\r\n"};
+  data_fixture_t           fixture;
+  char                     buffer[64];
+  fixture_init(&fixture);
+  fixture_script(&fixture, chunks, 1);
+
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("abc", buffer);
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_COMMAND, at_cmd_handler_get_mode(&fixture.handler));
+
+  at_cmd_handler_deinit(&fixture.handler);
+}
+
+// A held back "\r\n" that turns out to be data is returned by the next read
+static void test_partial_marker_is_data(void)
+{
+  static const char* const chunks[] = {"line\r\n", "next\r\nNO", " SIGNAL"};
+  data_fixture_t           fixture;
+  char                     buffer[64];
+  fixture_init(&fixture);
+  fixture_script(&fixture, chunks, 3);
+
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("line", buffer);
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("\r\nnext", buffer);
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("\r\nNO SIGNAL", buffer);
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_DATA, at_cmd_handler_get_mode(&fixture.handler));
+
+  at_cmd_handler_deinit(&fixture.handler);
+}
+
+// Nothing new arrived - the held bytes were data
+static void test_held_bytes_flushed_when_idle(void)
+{
+  static const char* const chunks[] = {"end\r\n"};
+  data_fixture_t           fixture;
+  char                     buffer[64];
+  fixture_init(&fixture);
+  fixture_script(&fixture, chunks, 1);
+
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("end", buffer);
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL_STRING("\r\n", buffer);
+  TEST_ASSERT_EQUAL_INT(AT_CMD_MODE_DATA, at_cmd_handler_get_mode(&fixture.handler));
+
+  at_cmd_handler_deinit(&fixture.handler);
+}
+
+static void test_read_needs_data_mode(void)
+{
+  static const char* const chunks[] = {"x\r\nNO CARRIER\r\n"};
+  data_fixture_t           fixture;
+  char                     buffer[64];
+  size_t                   bytes_read;
+  fixture_init(&fixture);
+  fixture_script(&fixture, chunks, 1);
+
+  fixture_read(&fixture, buffer, sizeof(buffer));
+  TEST_ASSERT_ERR(
+      ESP_ERR_INVALID_STATE,
+      at_cmd_handler_data_read(&fixture.handler, buffer, sizeof(buffer), &bytes_read, 0));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG,
+                  at_cmd_handler_data_read(
+                      &fixture.handler, buffer, AT_CMD_DATA_TAIL_LEN + 1, &bytes_read, 0));
+
+  at_cmd_handler_deinit(&fixture.handler);
+}
+
+static const test_case_t DATA_MODE_CASES[] = {
+    {"no_carrier_in_one_read", "data_mode", test_no_carrier_in_one_read},
+    {"no_carrier_split_across_reads", "data_mode", test_no_carrier_split_across_reads},
+    {"no_carrier_mid_chunk", "data_mode", test_no_carrier_mid_chunk},
+    {"partial_marker_is_data", "data_mode", test_partial_marker_is_data},
+    {"held_bytes_flushed_when_idle", "data_mode", test_held_bytes_flushed_when_idle},
+    {"read_needs_data_mode", "data_mode", test_read_needs_data_mode},
+};
+
+TEST_SUITE(data_mode, DATA_MODE_CASES)
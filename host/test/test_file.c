@@ -0,0 +1,213 @@
+// File transfers over the simulator's file system: uploads and downloads in several windows,
+// resumed transfers and the checksum check against what the module stores
+#include "test.h"
+
+#define FILE_NAME "UFS:test.bin"
+#define FILE_SIZE 5000 // Five windows of BG95_FILE_WINDOW_SIZE
+#define FILE_SPLIT 2048
+
+typedef struct
+{
+  const uint8_t* data;
+  size_t         len;
+  size_t         position;
+} file_source_t;
+
+typedef struct
+{
+  uint8_t* buffer;
+  size_t   size;
+  size_t   len;
+} file_sink_t;
+
+static esp_err_t file_source(char* buffer, size_t buffer_size, size_t* len, void* context)
+{
+  file_source_t* source = (file_source_t*) context;
+  size_t         left   = source->len - source->position;
+  *len                  = left < buffer_size ? left : buffer_size;
+  memcpy(buffer, source->data + source->position, *len);
+  source->position += *len;
+  return ESP_OK;
+}
+
+static esp_err_t file_sink(const char* data, size_t len, void* context)
+{
+  file_sink_t* sink = (file_sink_t*) context;
+  if (sink->len + len > sink->size)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memcpy(sink->buffer + sink->len, data, len);
+  sink->len += len;
+  return ESP_OK;
+}
+
+// Binary content, with the lines the handler looks for in between
+static void fill_file(uint8_t* data, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    data[i] = (uint8_t) (i * 13 + 5);
+  }
+  memcpy(data + 100, "\r\nOK\r\n", 6);
+  memcpy(data + 1500, "\r\nCONNECT 10\r\n", 14);
+  memcpy(data + 3000, "\r\nERROR\r\n", 9);
+}
+
+// ------------------------------ CASES ---------------------------------
+
+static void test_upload_download(void)
+{
+  static uint8_t content[FILE_SIZE];
+  static uint8_t stored[FILE_SIZE + 1];
+  static uint8_t downloaded[FILE_SIZE + 1];
+  fill_file(content, sizeof(content));
+
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  file_source_t        source   = {.data = content, .len = sizeof(content)};
+  bg95_file_transfer_t transfer = {0};
+  TEST_ASSERT_OK(
+      bg95_file_upload(fixture.handle, FILE_NAME, file_source, &source, FILE_SIZE, &transfer));
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, transfer.offset);
+  TEST_ASSERT_EQUAL_INT(bg95_file_checksum_update(0, 0, content, FILE_SIZE), transfer.checksum);
+
+  // The prefix is optional
+  size_t stored_len = 0;
+  TEST_ASSERT_OK(
+      bg95_sim_read_file(fixture.sim, "test.bin", stored, sizeof(stored), &stored_len));
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, stored_len);
+  TEST_ASSERT(memcmp(content, stored, FILE_SIZE) == 0);
+
+  file_sink_t          sink     = {.buffer = downloaded, .size = sizeof(downloaded)};
+  bg95_file_transfer_t download = {0};
+  TEST_ASSERT_OK(bg95_file_download(fixture.handle, FILE_NAME, file_sink, &sink, &download));
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, sink.len);
+  TEST_ASSERT(memcmp(content, downloaded, FILE_SIZE) == 0);
+  TEST_ASSERT_EQUAL_INT(transfer.checksum, download.checksum);
+
+  bg95_sim_stats_t stats;
+  bg95_sim_get_stats(fixture.sim, &stats);
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, stats.file_written);
+
+  // A second upload replaces the file
+  source   = (file_source_t) {.data = content, .len = 10};
+  transfer = (bg95_file_transfer_t) {0};
+  TEST_ASSERT_OK(bg95_file_upload(fixture.handle, FILE_NAME, file_source, &source, 10, &transfer));
+  TEST_ASSERT_OK(bg95_sim_read_file(fixture.sim, FILE_NAME, stored, sizeof(stored), &stored_len));
+  TEST_ASSERT_EQUAL_INT(10, stored_len);
+
+  test_sim_deinit(&fixture);
+}
+
+// Both directions pick up at the offset of an interrupted transfer and still check the whole file
+static void test_resume(void)
+{
+  static uint8_t content[FILE_SIZE];
+  static uint8_t stored[FILE_SIZE + 1];
+  static uint8_t downloaded[FILE_SIZE + 1];
+  fill_file(content, sizeof(content));
+
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  // The first FILE_SPLIT bytes made it before the upload was interrupted
+  uint16_t split_checksum = bg95_file_checksum_update(0, 0, content, FILE_SPLIT);
+  TEST_ASSERT_OK(bg95_sim_write_file(fixture.sim, FILE_NAME, content, FILE_SPLIT));
+  file_source_t        source   = {.data = content, .len = sizeof(content), .position = FILE_SPLIT};
+  bg95_file_transfer_t transfer = {.offset = FILE_SPLIT, .checksum = split_checksum};
+  TEST_ASSERT_OK(
+      bg95_file_upload(fixture.handle, FILE_NAME, file_source, &source, FILE_SIZE, &transfer));
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, transfer.offset);
+
+  size_t stored_len = 0;
+  TEST_ASSERT_OK(bg95_sim_read_file(fixture.sim, FILE_NAME, stored, sizeof(stored), &stored_len));
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, stored_len);
+  TEST_ASSERT(memcmp(content, stored, FILE_SIZE) == 0);
+
+  // Same for a download - QFSEEK and QFREAD from the offset on
+  memcpy(downloaded, content, FILE_SPLIT);
+  file_sink_t          sink     = {downloaded, sizeof(downloaded), FILE_SPLIT};
+  bg95_file_transfer_t download = {.offset = FILE_SPLIT, .checksum = split_checksum};
+  TEST_ASSERT_OK(bg95_file_download(fixture.handle, FILE_NAME, file_sink, &sink, &download));
+  TEST_ASSERT_EQUAL_INT(FILE_SIZE, download.offset);
+  TEST_ASSERT(memcmp(content, downloaded, FILE_SIZE) == 0);
+
+  test_sim_deinit(&fixture);
+}
+
+static void test_verify_mismatch(void)
+{
+  static uint8_t content[FILE_SIZE];
+  fill_file(content, sizeof(content));
+
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  bg95_file_transfer_t transfer = {.offset   = FILE_SIZE,
+                                   .checksum = bg95_file_checksum_update(0, 0, content, FILE_SIZE)};
+  TEST_ASSERT_OK(bg95_sim_write_file(fixture.sim, FILE_NAME, content, FILE_SIZE));
+  TEST_ASSERT_OK(bg95_file_verify(fixture.handle, FILE_NAME, &transfer));
+
+  // One byte changed, then one byte missing
+  content[FILE_SIZE / 2] ^= 0x01;
+  TEST_ASSERT_OK(bg95_sim_write_file(fixture.sim, FILE_NAME, content, FILE_SIZE));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_CRC, bg95_file_verify(fixture.handle, FILE_NAME, &transfer));
+  content[FILE_SIZE / 2] ^= 0x01;
+  TEST_ASSERT_OK(bg95_sim_write_file(fixture.sim, FILE_NAME, content, FILE_SIZE - 1));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_CRC, bg95_file_verify(fixture.handle, FILE_NAME, &transfer));
+
+  test_sim_deinit(&fixture);
+}
+
+// A missing file fails a download, and a resumed one as well (QFOPEN in read only mode)
+static void test_missing_file(void)
+{
+  uint8_t     buffer[16];
+  file_sink_t sink = {.buffer = buffer, .size = sizeof(buffer)};
+
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  bg95_file_transfer_t download = {0};
+  TEST_ASSERT_ERR(ESP_FAIL,
+                  bg95_file_download(fixture.handle, "missing.bin", file_sink, &sink, &download));
+  TEST_ASSERT_EQUAL_INT(0, download.offset);
+
+  download = (bg95_file_transfer_t) {.offset = 4};
+  TEST_ASSERT(bg95_file_download(fixture.handle, "missing.bin", file_sink, &sink, &download) !=
+              ESP_OK);
+  TEST_ASSERT_EQUAL_INT(0, sink.len);
+
+  size_t len;
+  TEST_ASSERT_ERR(ESP_ERR_NOT_FOUND,
+                  bg95_sim_read_file(fixture.sim, "missing.bin", buffer, sizeof(buffer), &len));
+
+  test_sim_deinit(&fixture);
+}
+
+static const test_case_t FILE_CASES[] = {
+    {"upload_download", "file", test_upload_download},
+    {"resume", "file", test_resume},
+    {"verify_mismatch", "file", test_verify_mismatch},
+    {"missing_file", "file", test_missing_file},
+};
+
+TEST_SUITE(file, FILE_CASES)
@@ -0,0 +1,182 @@
+// Worker pool over several simulated modems: publishes spread over the online modems, and one whose
+// publishes fail is taken offline while its publishes go out on the others
+#include "bg95_pool.h"
+#include "test.h"
+
+#include <stdio.h>
+
+#define POOL_MODEMS 3
+#define POOL_WORKERS 2
+#define POOL_PUBLISHES 12
+#define POOL_FAILING_MODEM 1
+#define POOL_WAIT_MS 5000
+
+typedef struct
+{
+  SemaphoreHandle_t lock;
+  uint32_t          done;
+  uint32_t          failed;
+} publish_results_t;
+
+static void on_publish_done(bg95_handle_t* handle, esp_err_t result, void* context)
+{
+  publish_results_t* results = (publish_results_t*) context;
+  xSemaphoreTake(results->lock, portMAX_DELAY);
+  results->done++;
+  if (result != ESP_OK)
+  {
+    results->failed++;
+  }
+  xSemaphoreGive(results->lock);
+}
+
+static uint32_t results_done(publish_results_t* results)
+{
+  xSemaphoreTake(results->lock, portMAX_DELAY);
+  uint32_t done = results->done;
+  xSemaphoreGive(results->lock);
+  return done;
+}
+
+// ------------------------------ CASES ---------------------------------
+
+static void test_publish_moves_off_failing_modem(void)
+{
+  test_sim_t        fixtures[POOL_MODEMS] = {0};
+  bg95_pool_t       pool;
+  publish_results_t results = {.lock = xSemaphoreCreateMutex()};
+  TEST_ASSERT(results.lock != NULL);
+  TEST_ASSERT_OK(bg95_pool_init(&pool));
+
+  bool ready = results.lock != NULL;
+  for (int i = 0; i < POOL_MODEMS && ready; i++)
+  {
+    ready = test_sim_init(&fixtures[i], NULL) == ESP_OK;
+    TEST_ASSERT(ready);
+    if (ready)
+    {
+      qmtsub_write_response_t sub_response;
+      TEST_ASSERT_OK(bg95_mqtt_subscribe(fixtures[i].handle,
+                                         TEST_SIM_MQTT_CLIENT,
+                                         1,
+                                         "pool/#",
+                                         QMTSUB_QOS_AT_MOST_ONCE,
+                                         &sub_response));
+
+      uint8_t modem_idx;
+      TEST_ASSERT_OK(
+          bg95_pool_add_modem(&pool, fixtures[i].handle, TEST_SIM_MQTT_CLIENT, &modem_idx));
+      TEST_ASSERT_EQUAL_INT(i, modem_idx);
+      TEST_ASSERT_OK(bg95_pool_set_online(&pool, modem_idx, true));
+    }
+  }
+
+  if (ready)
+  {
+    TEST_ASSERT_OK(bg95_sim_inject_fault(fixtures[POOL_FAILING_MODEM].sim,
+                                         "AT+QMTPUB",
+                                         BG95_SIM_FAULT_ERROR,
+                                         0,
+                                         POOL_PUBLISHES));
+    TEST_ASSERT_OK(bg95_pool_start(&pool, POOL_WORKERS));
+
+    char message[16];
+    for (int i = 0; i < POOL_PUBLISHES; i++)
+    {
+      snprintf(message, sizeof(message), "reading %d", i);
+      TEST_ASSERT_OK(bg95_pool_publish(&pool,
+                                       "pool/readings",
+                                       message,
+                                       (uint16_t) strlen(message),
+                                       QMTPUB_QOS_AT_MOST_ONCE,
+                                       QMTPUB_RETAIN_DISABLED,
+                                       on_publish_done,
+                                       &results));
+    }
+
+    uint32_t waited_ms = 0;
+    while (results_done(&results) < POOL_PUBLISHES && waited_ms < POOL_WAIT_MS)
+    {
+      vTaskDelay(pdMS_TO_TICKS(10));
+      waited_ms += 10;
+    }
+    TEST_ASSERT_EQUAL_INT(POOL_PUBLISHES, results_done(&results));
+    TEST_ASSERT_EQUAL_INT(0, results.failed);
+
+    // Every publish went out once, none of them on the failing modem
+    uint32_t published = 0;
+    uint32_t delivered = 0;
+    for (uint8_t i = 0; i < POOL_MODEMS; i++)
+    {
+      bg95_pool_modem_stats_t pool_stats;
+      bg95_sim_stats_t        sim_stats;
+      TEST_ASSERT_OK(bg95_pool_get_stats(&pool, i, &pool_stats));
+      bg95_sim_get_stats(fixtures[i].sim, &sim_stats);
+      published += pool_stats.publishes;
+      delivered += sim_stats.mqtt_delivered;
+
+      if (i == POOL_FAILING_MODEM)
+      {
+        TEST_ASSERT_EQUAL_INT(0, pool_stats.publishes);
+        TEST_ASSERT(pool_stats.publish_failures >= 1);
+        TEST_ASSERT_EQUAL_INT(0, sim_stats.mqtt_delivered);
+        TEST_ASSERT(!pool.modems[i].online);
+      }
+      else
+      {
+        TEST_ASSERT_EQUAL_INT(0, pool_stats.publish_failures);
+        TEST_ASSERT(pool.modems[i].online);
+      }
+    }
+    TEST_ASSERT_EQUAL_INT(POOL_PUBLISHES, published);
+    TEST_ASSERT_EQUAL_INT(POOL_PUBLISHES, delivered);
+  }
+
+  bg95_pool_stop(&pool);
+  for (int i = 0; i < POOL_MODEMS; i++)
+  {
+    test_sim_deinit(&fixtures[i]);
+  }
+  if (results.lock)
+  {
+    vSemaphoreDelete(results.lock);
+  }
+}
+
+// With every modem offline there is nowhere to publish
+static void test_publish_without_online_modem(void)
+{
+  test_sim_t  fixture;
+  bg95_pool_t pool;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  TEST_ASSERT_OK(bg95_pool_init(&pool));
+
+  if (fixture.handle)
+  {
+    uint8_t modem_idx;
+    TEST_ASSERT_OK(bg95_pool_add_modem(&pool, fixture.handle, TEST_SIM_MQTT_CLIENT, &modem_idx));
+    TEST_ASSERT_ERR(ESP_ERR_NOT_FOUND,
+                    bg95_pool_publish(&pool,
+                                      "pool/readings",
+                                      "x",
+                                      1,
+                                      QMTPUB_QOS_AT_MOST_ONCE,
+                                      QMTPUB_RETAIN_DISABLED,
+                                      NULL,
+                                      NULL));
+    // Modems only join before the start
+    TEST_ASSERT_OK(bg95_pool_start(&pool, 1));
+    TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE,
+                    bg95_pool_add_modem(&pool, fixture.handle, TEST_SIM_MQTT_CLIENT, NULL));
+  }
+
+  bg95_pool_stop(&pool);
+  test_sim_deinit(&fixture);
+}
+
+static const test_case_t POOL_CASES[] = {
+    {"publish_moves_off_failing_modem", "pool", test_publish_moves_off_failing_modem},
+    {"publish_without_online_modem", "pool", test_publish_without_online_modem},
+};
+
+TEST_SUITE(pool, POOL_CASES)
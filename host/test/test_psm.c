@@ -0,0 +1,525 @@
+// PSM and eDRX: the 3GPP timer and cycle encodings, the AT+CPSMS / AT+CEDRXS commands the driver
+// writes for them, the granted timer query and the publish queue
+#include "at_cmd_cedrxs.h"
+#include "at_cmd_cpsms.h"
+#include "bg95_driver.h"
+#include "test.h"
+
+// ------------------------------ TIMER ENCODING ---------------------------------
+
+typedef struct
+{
+  uint32_t    seconds;
+  const char* bits;
+  uint32_t    encoded_s; // What the bits decode to - the request rounded up
+} timer_case_t;
+
+// Every unit, and both sides of each switch to a coarser one
+static const timer_case_t PERIODIC_TAU_CASES[] = {
+    {0, "01100000", 0},
+    {1, "01100001", 2},
+    {62, "01111111", 62},           // Last value of the 2 s unit
+    {63, "10000011", 90},           // First of the 30 s unit
+    {930, "10011111", 930},         // Last of the 30 s unit
+    {931, "10110000", 960},         // 60 s unit
+    {3600, "00000110", 3600},       // 10 min unit
+    {18601, "00100110", 21600},     // 1 h unit
+    {111601, "01000100", 144000},   // 10 h unit
+    {1116001, "11000001", 1152000}, // 320 h unit
+    {35712000, "11011111", 35712000},
+    {CPSMS_TIMER_DEACTIVATED, "11100000", CPSMS_TIMER_DEACTIVATED},
+};
+
+static const timer_case_t ACTIVE_TIME_CASES[] = {
+    {0, "00000000", 0},
+    {30, "00001111", 30},
+    {62, "00011111", 62},     // Last value of the 2 s unit
+    {63, "00100010", 120},    // First of the 1 min unit
+    {1861, "01000110", 2160}, // 6 min unit
+    {11160, "01011111", 11160},
+    {CPSMS_TIMER_DEACTIVATED, "11100000", CPSMS_TIMER_DEACTIVATED},
+};
+
+static void check_timer_cases(const timer_case_t* cases,
+                              size_t              num_cases,
+                              esp_err_t (*encode)(uint32_t, char*, size_t),
+                              esp_err_t (*decode)(const char*, uint32_t*))
+{
+  for (size_t i = 0; i < num_cases; i++)
+  {
+    char     bits[CPSMS_TIMER_STR_SIZE] = {0};
+    uint32_t seconds                    = 0;
+    TEST_ASSERT_OK(encode(cases[i].seconds, bits, sizeof(bits)));
+    TEST_ASSERT_EQUAL_STRING(cases[i].bits, bits);
+    TEST_ASSERT_OK(decode(bits, &seconds));
+    TEST_ASSERT_EQUAL_INT(cases[i].encoded_s, seconds);
+  }
+}
+
+static void test_periodic_tau_encoding(void)
+{
+  check_timer_cases(PERIODIC_TAU_CASES,
+                    sizeof(PERIODIC_TAU_CASES) / sizeof(PERIODIC_TAU_CASES[0]),
+                    cpsms_encode_periodic_tau,
+                    cpsms_decode_periodic_tau);
+}
+
+static void test_active_time_encoding(void)
+{
+  check_timer_cases(ACTIVE_TIME_CASES,
+                    sizeof(ACTIVE_TIME_CASES) / sizeof(ACTIVE_TIME_CASES[0]),
+                    cpsms_encode_active_time,
+                    cpsms_decode_active_time);
+}
+
+static void test_timer_out_of_range(void)
+{
+  char bits[CPSMS_TIMER_STR_SIZE];
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cpsms_encode_periodic_tau(35712001, bits, sizeof(bits)));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cpsms_encode_active_time(11161, bits, sizeof(bits)));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cpsms_encode_active_time(60, bits, CPSMS_TIMER_BITS_LEN));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cpsms_encode_active_time(60, NULL, sizeof(bits)));
+}
+
+static void test_timer_decode_errors(void)
+{
+  uint32_t seconds;
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cpsms_decode_periodic_tau("0000011", &seconds));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cpsms_decode_periodic_tau("000001100", &seconds));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_RESPONSE, cpsms_decode_periodic_tau("0000011x", &seconds));
+
+  // Unit 111 of GPRS Timer 3 is 'deactivated', there is no other unused unit. For GPRS Timer 2 the
+  // unused units (011 - 110) count as 1 min
+  TEST_ASSERT_OK(cpsms_decode_active_time("01100011", &seconds));
+  TEST_ASSERT_EQUAL_INT(180, seconds);
+}
+
+// Whatever is asked for, the network is never asked for less, and the encoded value is stable
+static void test_timer_round_trip(void)
+{
+  uint32_t seconds = 0;
+  while (seconds <= 35712000)
+  {
+    char     bits[CPSMS_TIMER_STR_SIZE];
+    char     again[CPSMS_TIMER_STR_SIZE];
+    uint32_t decoded = 0;
+    TEST_ASSERT_OK(cpsms_encode_periodic_tau(seconds, bits, sizeof(bits)));
+    TEST_ASSERT_OK(cpsms_decode_periodic_tau(bits, &decoded));
+    TEST_ASSERT(decoded >= seconds);
+    TEST_ASSERT_OK(cpsms_encode_periodic_tau(decoded, again, sizeof(again)));
+    TEST_ASSERT_EQUAL_STRING(bits, again);
+
+    if (seconds <= 11160)
+    {
+      TEST_ASSERT_OK(cpsms_encode_active_time(seconds, bits, sizeof(bits)));
+      TEST_ASSERT_OK(cpsms_decode_active_time(bits, &decoded));
+      TEST_ASSERT(decoded >= seconds);
+      TEST_ASSERT_OK(cpsms_encode_active_time(decoded, again, sizeof(again)));
+      TEST_ASSERT_EQUAL_STRING(bits, again);
+    }
+
+    // Every second up to 1000 s, then in steps of half the value
+    seconds = seconds < 1000 ? seconds + 1 : seconds * 3 / 2;
+  }
+}
+
+// ------------------------------ eDRX CYCLES ---------------------------------
+
+static void test_edrx_cycle_rounding(void)
+{
+  uint8_t value = 0xFF;
+
+  // Shortest cycle that is not shorter than the request - rounded up, like the PSM timers
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 0, &value));
+  TEST_ASSERT_EQUAL_INT(0, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 5121, &value));
+  TEST_ASSERT_EQUAL_INT(1, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 10240, &value));
+  TEST_ASSERT_EQUAL_INT(1, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 163840, &value));
+  TEST_ASSERT_EQUAL_INT(9, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 10485760, &value));
+  TEST_ASSERT_EQUAL_INT(15, value);
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG,
+                  cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 10485761, &value));
+
+  // NB-IoT has no 5.12, 10.24, 61.44, 102.4, 122.88 or 143.36 s cycles
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_NBIOT, 5120, &value));
+  TEST_ASSERT_EQUAL_INT(2, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_NBIOT, 61440, &value));
+  TEST_ASSERT_EQUAL_INT(5, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_NBIOT, 102400, &value));
+  TEST_ASSERT_EQUAL_INT(9, value);
+  TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_NBIOT, 163840, &value));
+  TEST_ASSERT_EQUAL_INT(9, value);
+
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG,
+                  cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_NOT_USED, 10240, &value));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, cedrxs_cycle_ms_to_value(CEDRXS_ACT_TYPE_EMTC, 10240, NULL));
+}
+
+static void test_edrx_cycle_round_trip(void)
+{
+  static const cedrxs_act_type_t act_types[] = {CEDRXS_ACT_TYPE_EMTC, CEDRXS_ACT_TYPE_NBIOT};
+  for (size_t a = 0; a < 2; a++)
+  {
+    for (uint8_t value = 0; value <= CEDRXS_VALUE_MAX; value++)
+    {
+      uint32_t cycle_ms = cedrxs_value_to_cycle_ms(act_types[a], value);
+      if (cycle_ms == 0)
+      {
+        TEST_ASSERT(act_types[a] == CEDRXS_ACT_TYPE_NBIOT); // Unused by NB-S1 only
+        continue;
+      }
+
+      uint8_t again = 0xFF;
+      TEST_ASSERT_OK(cedrxs_cycle_ms_to_value(act_types[a], cycle_ms, &again));
+      TEST_ASSERT_EQUAL_INT(value, again);
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(0, cedrxs_value_to_cycle_ms(CEDRXS_ACT_TYPE_EMTC, CEDRXS_VALUE_MAX + 1));
+
+  TEST_ASSERT_EQUAL_INT(1280, cedrxs_ptw_to_ms(CEDRXS_ACT_TYPE_EMTC, 0));
+  TEST_ASSERT_EQUAL_INT(20480, cedrxs_ptw_to_ms(CEDRXS_ACT_TYPE_EMTC, 15));
+  TEST_ASSERT_EQUAL_INT(40960, cedrxs_ptw_to_ms(CEDRXS_ACT_TYPE_NBIOT, 15));
+}
+
+// ------------------------------ COMMANDS ---------------------------------
+
+static const mock_uart_response_t OK_RESPONSES[] = {{"AT", "\r\nOK\r\n", 0}};
+
+static void test_psm_request_command(void)
+{
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, OK_RESPONSES, 1));
+
+  TEST_ASSERT_OK(bg95_psm_request(driver.handle, 3600, 60));
+  TEST_ASSERT_EQUAL_STRING("AT+CPSMS=1,,,\"00000110\",\"00011110\"\r\n",
+                           test_driver_last_cmd(&driver));
+  TEST_ASSERT_EQUAL_INT(3600, driver.handle->power_saving.requested_periodic_tau_s);
+  TEST_ASSERT_EQUAL_INT(60, driver.handle->power_saving.requested_active_time_s);
+
+  // Rounded up, and the rounded value is what is tracked
+  TEST_ASSERT_OK(bg95_psm_request(driver.handle, 63, 63));
+  TEST_ASSERT_EQUAL_STRING("AT+CPSMS=1,,,\"10000011\",\"00100010\"\r\n",
+                           test_driver_last_cmd(&driver));
+  TEST_ASSERT_EQUAL_INT(90, driver.handle->power_saving.requested_periodic_tau_s);
+  TEST_ASSERT_EQUAL_INT(120, driver.handle->power_saving.requested_active_time_s);
+
+  TEST_ASSERT_OK(bg95_psm_disable(driver.handle));
+  TEST_ASSERT_EQUAL_STRING("AT+CPSMS=0\r\n", test_driver_last_cmd(&driver));
+  TEST_ASSERT(!driver.handle->power_saving.psm_requested);
+
+  test_driver_deinit(&driver);
+}
+
+// Nothing is sent for timers that can not be encoded
+static void test_psm_request_out_of_range(void)
+{
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, OK_RESPONSES, 1));
+
+  TEST_ASSERT_OK(bg95_psm_disable(driver.handle));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, bg95_psm_request(driver.handle, 35712001, 60));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, bg95_psm_request(driver.handle, 3600, 11161));
+  TEST_ASSERT_EQUAL_STRING("AT+CPSMS=0\r\n", test_driver_last_cmd(&driver));
+  TEST_ASSERT(!driver.handle->power_saving.psm_requested);
+
+  test_driver_deinit(&driver);
+}
+
+static void test_edrx_request_command(void)
+{
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, OK_RESPONSES, 1));
+
+  TEST_ASSERT_OK(bg95_edrx_request(driver.handle, CEDRXS_ACT_TYPE_EMTC, 81920));
+  TEST_ASSERT_EQUAL_STRING("AT+CEDRXS=1,4,\"0101\"\r\n", test_driver_last_cmd(&driver));
+  TEST_ASSERT_EQUAL_INT(81920, driver.handle->power_saving.requested_edrx_cycle_ms);
+
+  // 61.44 s is not an NB-IoT cycle - rounded up to 81.92 s
+  TEST_ASSERT_OK(bg95_edrx_request(driver.handle, CEDRXS_ACT_TYPE_NBIOT, 61440));
+  TEST_ASSERT_EQUAL_STRING("AT+CEDRXS=1,5,\"0101\"\r\n", test_driver_last_cmd(&driver));
+  TEST_ASSERT_EQUAL_INT(81920, driver.handle->power_saving.requested_edrx_cycle_ms);
+
+  TEST_ASSERT_OK(bg95_edrx_disable(driver.handle, CEDRXS_ACT_TYPE_EMTC));
+  TEST_ASSERT_EQUAL_STRING("AT+CEDRXS=0,4\r\n", test_driver_last_cmd(&driver));
+
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG,
+                  bg95_edrx_request(driver.handle, CEDRXS_ACT_TYPE_NOT_USED, 81920));
+  TEST_ASSERT_EQUAL_STRING("AT+CEDRXS=0,4\r\n", test_driver_last_cmd(&driver));
+
+  test_driver_deinit(&driver);
+}
+
+static void test_cpsms_cedrxs_read(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CPSMS?", "\r\n+CPSMS: 1,,,\"00000110\",\"00011110\"\r\n\r\nOK\r\n", 0},
+      {"AT+CEDRXS?", "\r\n+CEDRXS: 4,\"0101\"\r\n+CEDRXS: 5,\"0011\"\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 2));
+
+  cpsms_read_response_t cpsms;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CPSMS, AT_CMD_TYPE_READ, NULL, &cpsms));
+  TEST_ASSERT_EQUAL_INT(CPSMS_MODE_ENABLE, cpsms.mode);
+  TEST_ASSERT(cpsms.present.has_periodic_tau && cpsms.present.has_active_time);
+  TEST_ASSERT_EQUAL_STRING("00000110", cpsms.periodic_tau);
+  TEST_ASSERT_EQUAL_STRING("00011110", cpsms.active_time);
+
+  cedrxs_read_response_t cedrxs;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_CEDRXS, AT_CMD_TYPE_READ, NULL, &cedrxs));
+  TEST_ASSERT_EQUAL_INT(2, cedrxs.num_settings);
+  TEST_ASSERT_EQUAL_INT(CEDRXS_ACT_TYPE_EMTC, cedrxs.settings[0].act_type);
+  TEST_ASSERT_EQUAL_INT(5, cedrxs.settings[0].edrx_value);
+  TEST_ASSERT_EQUAL_INT(CEDRXS_ACT_TYPE_NBIOT, cedrxs.settings[1].act_type);
+  TEST_ASSERT_EQUAL_INT(3, cedrxs.settings[1].edrx_value);
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ GRANTED TIMERS ---------------------------------
+
+static void test_query_granted_with_n4(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CEREG?",
+       "\r\n+CEREG: 4,1,\"1A2B\",\"01A2D001\",8,,,\"00011110\",\"00000110\"\r\n\r\nOK\r\n",
+       0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 2));
+
+  uint32_t tau    = 0;
+  uint32_t active = 0;
+  TEST_ASSERT_OK(bg95_psm_query_granted(driver.handle, &tau, &active));
+  TEST_ASSERT_EQUAL_INT(3600, tau);
+  TEST_ASSERT_EQUAL_INT(60, active);
+  // Already n=4 - nothing to switch or restore
+  TEST_ASSERT_EQUAL_STRING("AT+CEREG?\r\n", test_driver_last_cmd(&driver));
+
+  test_driver_deinit(&driver);
+}
+
+// n is switched to 4 for the read and put back, whatever the read gave
+static void test_query_granted_restores_n(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+CEREG?", "\r\n+CEREG: 2,2\r\n\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 2));
+
+  uint32_t tau;
+  uint32_t active;
+  TEST_ASSERT_ERR(ESP_ERR_NOT_FOUND, bg95_psm_query_granted(driver.handle, &tau, &active));
+  TEST_ASSERT_EQUAL_STRING("AT+CEREG=2\r\n", test_driver_last_cmd(&driver));
+
+  test_driver_deinit(&driver);
+}
+
+// ------------------------------ PUBLISH QUEUE ---------------------------------
+
+static void test_queue_copies_publish(void)
+{
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, OK_RESPONSES, 1));
+
+  char    topic[32]   = "psm/a";
+  uint8_t message[16] = "first";
+  TEST_ASSERT_OK(bg95_psm_queue_publish(
+      driver.handle, 0, 1, QMTPUB_QOS_AT_MOST_ONCE, QMTPUB_RETAIN_DISABLED, topic, message, 5));
+  strcpy(topic, "psm/b");
+  memcpy(message, "other", 5);
+
+  const bg95_queued_publish_t* queued = &driver.handle->power_saving.publish_queue[0];
+  TEST_ASSERT_EQUAL_STRING("psm/a", queued->topic);
+  TEST_ASSERT_EQUAL_INT(5, queued->message_length);
+  TEST_ASSERT(memcmp(queued->message, "first", 5) == 0);
+
+  static char long_topic[QMTPUB_TOPIC_MAX_SIZE + 1];
+  memset(long_topic, 't', QMTPUB_TOPIC_MAX_SIZE);
+  static uint8_t big[BG95_PSM_PUBLISH_MAX_MESSAGE_LEN + 1];
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_SIZE,
+                  bg95_psm_queue_publish(driver.handle,
+                                         0,
+                                         2,
+                                         QMTPUB_QOS_AT_MOST_ONCE,
+                                         QMTPUB_RETAIN_DISABLED,
+                                         long_topic,
+                                         message,
+                                         5));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_SIZE,
+                  bg95_psm_queue_publish(driver.handle,
+                                         0,
+                                         2,
+                                         QMTPUB_QOS_AT_MOST_ONCE,
+                                         QMTPUB_RETAIN_DISABLED,
+                                         topic,
+                                         big,
+                                         sizeof(big)));
+
+  for (uint16_t msgid = 2; msgid <= BG95_PSM_PUBLISH_QUEUE_LEN; msgid++)
+  {
+    TEST_ASSERT_OK(bg95_psm_queue_publish(driver.handle,
+                                          0,
+                                          msgid,
+                                          QMTPUB_QOS_AT_MOST_ONCE,
+                                          QMTPUB_RETAIN_DISABLED,
+                                          topic,
+                                          message,
+                                          5));
+  }
+  TEST_ASSERT_ERR(ESP_ERR_NO_MEM,
+                  bg95_psm_queue_publish(driver.handle,
+                                         0,
+                                         9,
+                                         QMTPUB_QOS_AT_MOST_ONCE,
+                                         QMTPUB_RETAIN_DISABLED,
+                                         topic,
+                                         message,
+                                         5));
+
+  test_driver_deinit(&driver);
+}
+
+// Queued from one reused buffer, flushed over the simulator - every publish reaches the broker
+static void test_flush_publish_queue(void)
+{
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  qmtsub_write_response_t sub_response;
+  TEST_ASSERT_OK(bg95_mqtt_subscribe(
+      fixture.handle, TEST_SIM_MQTT_CLIENT, 1, "psm/#", QMTSUB_QOS_AT_MOST_ONCE, &sub_response));
+
+  char topic[16];
+  char message[16];
+  for (int i = 0; i < 3; i++)
+  {
+    snprintf(topic, sizeof(topic), "psm/%d", i);
+    snprintf(message, sizeof(message), "reading %d", i);
+    TEST_ASSERT_OK(bg95_psm_queue_publish(fixture.handle,
+                                          TEST_SIM_MQTT_CLIENT,
+                                          0,
+                                          QMTPUB_QOS_AT_MOST_ONCE,
+                                          QMTPUB_RETAIN_DISABLED,
+                                          topic,
+                                          message,
+                                          (uint16_t) strlen(message)));
+  }
+
+  uint8_t published = 0;
+  TEST_ASSERT_OK(bg95_psm_flush_publish_queue(fixture.handle, &published));
+  TEST_ASSERT_EQUAL_INT(3, published);
+  TEST_ASSERT_EQUAL_INT(0, fixture.handle->power_saving.publish_queue_count);
+
+  bg95_sim_stats_t stats;
+  bg95_sim_get_stats(fixture.sim, &stats);
+  TEST_ASSERT_EQUAL_INT(3, stats.mqtt_delivered);
+
+  // Nothing queued - nothing sent
+  TEST_ASSERT_OK(bg95_psm_flush_publish_queue(fixture.handle, &published));
+  TEST_ASSERT_EQUAL_INT(0, published);
+
+  test_sim_deinit(&fixture);
+}
+
+static uint32_t wait_queue_empty(bg95_handle_t* handle, uint32_t max_ms)
+{
+  uint32_t waited = 0;
+  while (handle->power_saving.publish_queue_count > 0 && waited < max_ms)
+  {
+    vTaskDelay(pdMS_TO_TICKS(10));
+    waited += 10;
+  }
+  return waited;
+}
+
+// The flush task sends at once while the module is awake, and otherwise waits for the TAU wake
+static void test_auto_flush(void)
+{
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  qmtsub_write_response_t sub_response;
+  TEST_ASSERT_OK(bg95_mqtt_subscribe(
+      fixture.handle, TEST_SIM_MQTT_CLIENT, 1, "psm/#", QMTSUB_QOS_AT_MOST_ONCE, &sub_response));
+
+  bg95_power_saving_t* ps = &fixture.handle->power_saving;
+  TEST_ASSERT_OK(bg95_psm_start_auto_flush(fixture.handle));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE, bg95_psm_start_auto_flush(fixture.handle));
+
+  // No timers granted - the module is awake
+  TEST_ASSERT_OK(bg95_psm_queue_publish(fixture.handle,
+                                        TEST_SIM_MQTT_CLIENT,
+                                        0,
+                                        QMTPUB_QOS_AT_MOST_ONCE,
+                                        QMTPUB_RETAIN_DISABLED,
+                                        "psm/now",
+                                        "a",
+                                        1));
+  TEST_ASSERT(wait_queue_empty(fixture.handle, 1000) < 1000);
+
+  // Granted: no active time and a 2 s TAU - asleep until 2 s after the last exchange
+  ps->psm_granted_known      = true;
+  ps->granted_active_time_s  = 0;
+  ps->granted_periodic_tau_s = 2;
+  TEST_ASSERT(bg95_test_module_is_responsive(fixture.handle));
+  TEST_ASSERT_OK(bg95_psm_queue_publish(fixture.handle,
+                                        TEST_SIM_MQTT_CLIENT,
+                                        0,
+                                        QMTPUB_QOS_AT_MOST_ONCE,
+                                        QMTPUB_RETAIN_DISABLED,
+                                        "psm/tau",
+                                        "b",
+                                        1));
+  vTaskDelay(pdMS_TO_TICKS(500));
+  TEST_ASSERT_EQUAL_INT(1, ps->publish_queue_count);
+  TEST_ASSERT(wait_queue_empty(fixture.handle, 3000) < 3000);
+
+  bg95_sim_stats_t stats;
+  bg95_sim_get_stats(fixture.sim, &stats);
+  TEST_ASSERT_EQUAL_INT(2, stats.mqtt_delivered);
+
+  TEST_ASSERT_OK(bg95_psm_stop_auto_flush(fixture.handle));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE, bg95_psm_stop_auto_flush(fixture.handle));
+
+  // Deinit stops a running task as well
+  TEST_ASSERT_OK(bg95_psm_start_auto_flush(fixture.handle));
+  test_sim_deinit(&fixture);
+}
+
+static const test_case_t PSM_CASES[] = {
+    {"periodic_tau_encoding", "psm", test_periodic_tau_encoding},
+    {"active_time_encoding", "psm", test_active_time_encoding},
+    {"timer_out_of_range", "psm", test_timer_out_of_range},
+    {"timer_decode_errors", "psm", test_timer_decode_errors},
+    {"timer_round_trip", "psm", test_timer_round_trip},
+    {"edrx_cycle_rounding", "psm", test_edrx_cycle_rounding},
+    {"edrx_cycle_round_trip", "psm", test_edrx_cycle_round_trip},
+    {"psm_request_command", "psm", test_psm_request_command},
+    {"psm_request_out_of_range", "psm", test_psm_request_out_of_range},
+    {"edrx_request_command", "psm", test_edrx_request_command},
+    {"cpsms_cedrxs_read", "psm", test_cpsms_cedrxs_read},
+    {"query_granted_with_n4", "psm", test_query_granted_with_n4},
+    {"query_granted_restores_n", "psm", test_query_granted_restores_n},
+    {"queue_copies_publish", "psm", test_queue_copies_publish},
+    {"flush_publish_queue", "psm", test_flush_publish_queue},
+    {"auto_flush", "psm", test_auto_flush},
+};
+
+TEST_SUITE(psm, PSM_CASES)
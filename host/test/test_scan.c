@@ -0,0 +1,140 @@
+// Background operator scan: entries stream in through the observer, one scan at a time, and a
+// cancel takes effect even while the module has not sent anything yet
+#include "test.h"
+
+#define SCAN_WAIT_MS 2000
+
+typedef struct
+{
+  uint32_t  found;
+  uint32_t  done;
+  esp_err_t result;
+} scan_events_t;
+
+static void on_operator_found(const cops_operator_info_t* op, void* context)
+{
+  (void) op;
+  ((scan_events_t*) context)->found++;
+}
+
+static void on_scan_done(esp_err_t result, const cops_test_response_t* operators, void* context)
+{
+  scan_events_t* events = (scan_events_t*) context;
+  (void) operators;
+  events->result = result;
+  events->done++;
+}
+
+// Returns how long the scan took to stop, or SCAN_WAIT_MS if it did not
+static uint32_t wait_scan_done(bg95_handle_t* handle)
+{
+  uint32_t start = pdTICKS_TO_MS(xTaskGetTickCount());
+  uint32_t took  = 0;
+  while (bg95_operator_scan_in_progress(handle) && took < SCAN_WAIT_MS)
+  {
+    vTaskDelay(pdMS_TO_TICKS(5));
+    took = pdTICKS_TO_MS(xTaskGetTickCount()) - start;
+  }
+  return took;
+}
+
+// ------------------------------ CASES ---------------------------------
+
+static void test_scan_completes(void)
+{
+  test_sim_t    fixture;
+  scan_events_t events = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  TEST_ASSERT_OK(
+      bg95_start_operator_scan(fixture.handle, on_operator_found, on_scan_done, &events));
+  TEST_ASSERT(wait_scan_done(fixture.handle) < SCAN_WAIT_MS);
+  TEST_ASSERT_EQUAL_INT(1, events.done);
+  TEST_ASSERT_OK(events.result);
+  TEST_ASSERT_EQUAL_INT(1, events.found);
+
+  cops_test_response_t operators;
+  TEST_ASSERT_OK(bg95_get_cached_operators(fixture.handle, &operators, NULL));
+  TEST_ASSERT_EQUAL_INT(1, operators.num_operators);
+  TEST_ASSERT_EQUAL_STRING("00101", operators.operators[0].numeric);
+
+  test_sim_deinit(&fixture);
+}
+
+// The module sends nothing until AT+COPS=? ends - the cancel must not wait for the first byte
+static void test_cancel_silent_scan(void)
+{
+  test_sim_t    fixture;
+  scan_events_t events = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  TEST_ASSERT_OK(bg95_sim_inject_fault(fixture.sim, "AT+COPS=?", BG95_SIM_FAULT_NO_ANSWER, 0, 1));
+  TEST_ASSERT_OK(
+      bg95_start_operator_scan(fixture.handle, on_operator_found, on_scan_done, &events));
+  vTaskDelay(pdMS_TO_TICKS(50));
+  TEST_ASSERT(bg95_operator_scan_in_progress(fixture.handle));
+
+  TEST_ASSERT_OK(bg95_cancel_operator_scan(fixture.handle));
+  TEST_ASSERT(wait_scan_done(fixture.handle) < SCAN_WAIT_MS);
+  TEST_ASSERT_EQUAL_INT(1, events.done);
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE, events.result);
+  TEST_ASSERT_EQUAL_INT(0, events.found);
+
+  // The abort drained the module's answer - the next command is not thrown off
+  TEST_ASSERT(bg95_test_module_is_responsive(fixture.handle));
+
+  // And deinit does not spin on a silent scan either
+  TEST_ASSERT_OK(bg95_sim_inject_fault(fixture.sim, "AT+COPS=?", BG95_SIM_FAULT_NO_ANSWER, 0, 1));
+  TEST_ASSERT_OK(bg95_start_operator_scan(fixture.handle, NULL, NULL, NULL));
+  vTaskDelay(pdMS_TO_TICKS(50));
+  uint32_t start = pdTICKS_TO_MS(xTaskGetTickCount());
+  test_sim_deinit(&fixture);
+  TEST_ASSERT(pdTICKS_TO_MS(xTaskGetTickCount()) - start < SCAN_WAIT_MS);
+}
+
+// Only one scan at a time, whether started in the background or blocking
+static void test_scan_already_running(void)
+{
+  test_sim_t    fixture;
+  scan_events_t events = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  TEST_ASSERT_OK(bg95_sim_inject_fault(fixture.sim, "AT+COPS=?", BG95_SIM_FAULT_NO_ANSWER, 0, 1));
+  TEST_ASSERT_OK(bg95_start_operator_scan(fixture.handle, NULL, on_scan_done, &events));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE,
+                  bg95_start_operator_scan(fixture.handle, NULL, NULL, NULL));
+
+  cops_test_response_t operators;
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE, bg95_get_available_operators(fixture.handle, &operators));
+
+  TEST_ASSERT_OK(bg95_cancel_operator_scan(fixture.handle));
+  TEST_ASSERT(wait_scan_done(fixture.handle) < SCAN_WAIT_MS);
+  TEST_ASSERT_EQUAL_INT(1, events.done);
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE, bg95_cancel_operator_scan(fixture.handle));
+
+  // Free again
+  TEST_ASSERT_OK(bg95_get_available_operators(fixture.handle, &operators));
+  TEST_ASSERT_EQUAL_INT(1, operators.num_operators);
+
+  test_sim_deinit(&fixture);
+}
+
+static const test_case_t SCAN_CASES[] = {
+    {"scan_completes", "scan", test_scan_completes},
+    {"cancel_silent_scan", "scan", test_cancel_silent_scan},
+    {"scan_already_running", "scan", test_scan_already_running},
+};
+
+TEST_SUITE(scan, SCAN_CASES)
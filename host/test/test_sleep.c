@@ -0,0 +1,148 @@
+// Sleep control of the handler: the answers to wake probes do not leak into the next command, and
+// commands queued from several tasks share one wake interval
+#include "test.h"
+
+#define SLEEP_TASKS 2
+#define SLEEP_CMDS_PER_TASK 10
+
+typedef struct
+{
+  uint32_t asserted;
+  uint32_t released;
+} wake_line_t;
+
+static esp_err_t set_wake_line(bool awake, void* context)
+{
+  wake_line_t* line = (wake_line_t*) context;
+  if (awake)
+  {
+    line->asserted++;
+  }
+  else
+  {
+    line->released++;
+  }
+  return ESP_OK;
+}
+
+typedef struct
+{
+  bg95_handle_t* handle;
+  atomic_uint*   finished;
+  uint32_t       failures;
+} sleep_worker_t;
+
+static void sleep_worker_task(void* arg)
+{
+  sleep_worker_t* worker = (sleep_worker_t*) arg;
+  for (int i = 0; i < SLEEP_CMDS_PER_TASK; i++)
+  {
+    if (!bg95_test_module_is_responsive(worker->handle))
+    {
+      worker->failures++;
+    }
+  }
+  atomic_fetch_add(worker->finished, 1);
+  vTaskDelete(NULL);
+}
+
+// ------------------------------ CASES ---------------------------------
+
+// The module answers the first probes late - by the time the first OK is in, more probes have
+// been sent. Their OKs must not be taken for the answer of the next command, which is slow enough
+// for them to arrive in the middle of it
+static void test_wake_drains_probes(void)
+{
+  test_sim_t  fixture;
+  wake_line_t line = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  at_cmd_handler_t* handler = &fixture.handle->at_handler;
+  TEST_ASSERT_OK(at_cmd_handler_sleep_enable(handler, set_wake_line, &line));
+  // The first fault covers three probes, the second one the command
+  TEST_ASSERT_OK(bg95_sim_inject_fault(
+      fixture.sim, "AT", BG95_SIM_FAULT_DELAY, 3 * AT_CMD_WAKE_PROBE_INTERVAL_MS, 3));
+  TEST_ASSERT_OK(bg95_sim_inject_fault(
+      fixture.sim, "AT", BG95_SIM_FAULT_DELAY, 5 * AT_CMD_WAKE_PROBE_INTERVAL_MS, 1));
+
+  TEST_ASSERT(bg95_test_module_is_responsive(fixture.handle));
+
+  // Nothing is left on the line - the command waited for its own OK
+  char   rest[16];
+  size_t rest_len = 0;
+  vTaskDelay(pdMS_TO_TICKS(8 * AT_CMD_WAKE_PROBE_INTERVAL_MS));
+  handler->uart.read(rest, sizeof(rest), &rest_len, 0, handler->uart.context);
+  TEST_ASSERT_EQUAL_INT(0, rest_len);
+
+  at_cmd_sleep_stats_t stats;
+  TEST_ASSERT_OK(at_cmd_handler_get_sleep_stats(handler, &stats));
+  TEST_ASSERT_EQUAL_INT(1, stats.wake_count);
+  TEST_ASSERT(at_cmd_handler_avg_wake_latency_ms(handler) >= 3 * AT_CMD_WAKE_PROBE_INTERVAL_MS);
+  TEST_ASSERT_EQUAL_INT(line.asserted + 1, line.released);
+
+  cpin_status_t status;
+  TEST_ASSERT_OK(bg95_get_sim_card_status(fixture.handle, &status));
+  TEST_ASSERT_EQUAL_INT(CPIN_STATUS_READY, status);
+
+  TEST_ASSERT_OK(at_cmd_handler_sleep_disable(handler));
+  test_sim_deinit(&fixture);
+}
+
+// Commands from two tasks at once - the module is not put to sleep between a command and one that
+// is already waiting for the lock
+static void test_queued_cmds_stay_awake(void)
+{
+  // Each exchange takes long enough for the other task to queue up behind it
+  bg95_sim_config_t config = BG95_SIM_CONFIG_DEFAULT();
+  config.latency_ms        = 2;
+  test_sim_t  fixture;
+  wake_line_t line = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, &config));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  at_cmd_handler_t* handler = &fixture.handle->at_handler;
+  TEST_ASSERT_OK(at_cmd_handler_sleep_enable(handler, set_wake_line, &line));
+
+  atomic_uint    finished = 0;
+  sleep_worker_t workers[SLEEP_TASKS];
+  for (int i = 0; i < SLEEP_TASKS; i++)
+  {
+    workers[i] = (sleep_worker_t) {.handle = fixture.handle, .finished = &finished};
+    TEST_ASSERT(xTaskCreate(sleep_worker_task, "sleep_worker", 4096, &workers[i], 5, NULL) ==
+                pdPASS);
+  }
+  for (int i = 0; i < 1000 && atomic_load(&finished) < SLEEP_TASKS; i++)
+  {
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+  TEST_ASSERT_EQUAL_INT(SLEEP_TASKS, atomic_load(&finished));
+  for (int i = 0; i < SLEEP_TASKS; i++)
+  {
+    TEST_ASSERT_EQUAL_INT(0, workers[i].failures);
+  }
+
+  at_cmd_sleep_stats_t stats;
+  TEST_ASSERT_OK(at_cmd_handler_get_sleep_stats(handler, &stats));
+  TEST_ASSERT_EQUAL_INT(SLEEP_TASKS * SLEEP_CMDS_PER_TASK, stats.cmd_count);
+  TEST_ASSERT(stats.kept_awake_count > 0);
+  TEST_ASSERT_EQUAL_INT(stats.cmd_count, stats.wake_count + stats.kept_awake_count);
+  // Released again once the queue is empty
+  TEST_ASSERT(!handler->sleep.awake);
+
+  TEST_ASSERT_OK(at_cmd_handler_sleep_disable(handler));
+  test_sim_deinit(&fixture);
+}
+
+static const test_case_t SLEEP_CASES[] = {
+    {"wake_drains_probes", "sleep", test_wake_drains_probes},
+    {"queued_cmds_stay_awake", "sleep", test_queued_cmds_stay_awake},
+};
+
+TEST_SUITE(sleep, SLEEP_CASES)
@@ -0,0 +1,243 @@
+// TCP / UDP sockets over the simulator's echo server: what is sent comes back through QIRD byte for
+// byte, and the socket URCs reach the event callback
+#include "test.h"
+
+#define SOCKET_ID 0
+#define SOCKET_CONTEXT 1
+
+typedef struct
+{
+  uint32_t data;
+  uint32_t closed;
+} socket_events_t;
+
+static void on_socket_event(uint8_t connect_id, bg95_socket_event_t event, void* context)
+{
+  socket_events_t* events = (socket_events_t*) context;
+  if (connect_id != SOCKET_ID)
+  {
+    return;
+  }
+  if (event == BG95_SOCKET_EVENT_DATA)
+  {
+    events->data++;
+  }
+  else
+  {
+    events->closed++;
+  }
+}
+
+// Reads until 'len' bytes are in, or the module has nothing more
+static size_t recv_all(bg95_handle_t* handle, uint8_t* buffer, size_t len)
+{
+  size_t total = 0;
+  while (total < len)
+  {
+    size_t received = 0;
+    TEST_ASSERT_OK(bg95_socket_recv(handle, SOCKET_ID, buffer + total, len - total, &received));
+    if (received == 0)
+    {
+      break;
+    }
+    total += received;
+  }
+  return total;
+}
+
+// ------------------------------ CASES ---------------------------------
+
+// More than one QISEND and one QIRD each way, with bytes a line based parser would trip over
+static void test_tcp_echo(void)
+{
+  static uint8_t sent[4000];
+  static uint8_t received[sizeof(sent)];
+  for (size_t i = 0; i < sizeof(sent); i++)
+  {
+    sent[i] = (uint8_t) (i * 7);
+  }
+  memcpy(sent + 100, "\r\nOK\r\n", 6);
+  memcpy(sent + 2000, "\r\n+QIURC: \"closed\",0\r\n", 22);
+
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  qiopen_write_response_t open_response;
+  TEST_ASSERT_OK(bg95_socket_open(fixture.handle,
+                                  SOCKET_CONTEXT,
+                                  SOCKET_ID,
+                                  QIOPEN_SERVICE_TYPE_TCP,
+                                  "echo.example",
+                                  7,
+                                  &open_response));
+  TEST_ASSERT_EQUAL_INT(QIOPEN_RESULT_SUCCESS, open_response.result);
+
+  TEST_ASSERT_OK(bg95_socket_send(fixture.handle, SOCKET_ID, sent, sizeof(sent)));
+  memset(received, 0, sizeof(received));
+  TEST_ASSERT_EQUAL_INT(sizeof(sent), recv_all(fixture.handle, received, sizeof(received)));
+  TEST_ASSERT(memcmp(sent, received, sizeof(sent)) == 0);
+
+  // Drained - a read returns nothing
+  size_t left = 1;
+  TEST_ASSERT_OK(bg95_socket_recv(fixture.handle, SOCKET_ID, received, 16, &left));
+  TEST_ASSERT_EQUAL_INT(0, left);
+  TEST_ASSERT(!bg95_socket_data_pending(fixture.handle, SOCKET_ID));
+
+  bg95_sim_stats_t stats;
+  bg95_sim_get_stats(fixture.sim, &stats);
+  TEST_ASSERT_EQUAL_INT(sizeof(sent), stats.socket_echoed);
+
+  TEST_ASSERT_OK(bg95_socket_close(fixture.handle, SOCKET_ID));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE,
+                  bg95_socket_send(fixture.handle, SOCKET_ID, sent, sizeof(sent)));
+
+  test_sim_deinit(&fixture);
+}
+
+static void test_udp_datagram(void)
+{
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  TEST_ASSERT_OK(bg95_socket_open(fixture.handle,
+                                  SOCKET_CONTEXT,
+                                  SOCKET_ID,
+                                  QIOPEN_SERVICE_TYPE_UDP,
+                                  "10.0.0.1",
+                                  5683,
+                                  NULL));
+  TEST_ASSERT_OK(bg95_socket_send(fixture.handle, SOCKET_ID, "\x40\x01\x12\x34", 4));
+
+  uint8_t datagram[16];
+  TEST_ASSERT_EQUAL_INT(4, recv_all(fixture.handle, datagram, 4));
+  TEST_ASSERT(memcmp(datagram, "\x40\x01\x12\x34", 4) == 0);
+
+  TEST_ASSERT_OK(bg95_socket_close(fixture.handle, SOCKET_ID));
+  test_sim_deinit(&fixture);
+}
+
+// The connectID is taken, or the PDP context is not active - the module reports it in +QIOPEN
+static void test_open_failures(void)
+{
+  test_sim_t fixture;
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  qiopen_write_response_t open_response;
+  TEST_ASSERT_ERR(ESP_FAIL,
+                  bg95_socket_open(fixture.handle,
+                                   SOCKET_CONTEXT + 1,
+                                   SOCKET_ID,
+                                   QIOPEN_SERVICE_TYPE_TCP,
+                                   "echo.example",
+                                   7,
+                                   &open_response));
+  TEST_ASSERT_EQUAL_INT(561, open_response.result);
+
+  TEST_ASSERT_OK(bg95_socket_open(
+      fixture.handle, SOCKET_CONTEXT, SOCKET_ID, QIOPEN_SERVICE_TYPE_TCP, "echo.example", 7, NULL));
+  // The driver knows the socket is open, so the module is not asked
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE,
+                  bg95_socket_open(fixture.handle,
+                                   SOCKET_CONTEXT,
+                                   SOCKET_ID,
+                                   QIOPEN_SERVICE_TYPE_TCP,
+                                   "echo.example",
+                                   7,
+                                   NULL));
+
+  TEST_ASSERT_OK(bg95_socket_close(fixture.handle, SOCKET_ID));
+  test_sim_deinit(&fixture);
+}
+
+// A 'recv' URC that arrives while the driver is idle is picked up by bg95_socket_poll, and so is
+// the peer closing the connection
+static void test_events(void)
+{
+  bg95_sim_config_t config = BG95_SIM_CONFIG_DEFAULT();
+  config.urc_delay_ms      = 20;
+  test_sim_t      fixture;
+  socket_events_t events = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, &config));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  TEST_ASSERT_OK(bg95_socket_set_event_callback(fixture.handle, on_socket_event, &events));
+  TEST_ASSERT_OK(bg95_socket_open(
+      fixture.handle, SOCKET_CONTEXT, SOCKET_ID, QIOPEN_SERVICE_TYPE_TCP, "echo.example", 7, NULL));
+  TEST_ASSERT_OK(bg95_socket_send(fixture.handle, SOCKET_ID, "ping", 4));
+
+  TEST_ASSERT_OK(bg95_socket_poll(fixture.handle, 200));
+  TEST_ASSERT_EQUAL_INT(1, events.data);
+  TEST_ASSERT(bg95_socket_data_pending(fixture.handle, SOCKET_ID));
+
+  char pong[8];
+  TEST_ASSERT_EQUAL_INT(4, recv_all(fixture.handle, (uint8_t*) pong, 4));
+  size_t received;
+  TEST_ASSERT_OK(bg95_socket_recv(fixture.handle, SOCKET_ID, pong, sizeof(pong), &received));
+  TEST_ASSERT(!bg95_socket_data_pending(fixture.handle, SOCKET_ID));
+
+  bg95_sim_close_socket(fixture.sim, SOCKET_ID);
+  TEST_ASSERT_OK(bg95_socket_poll(fixture.handle, 200));
+  TEST_ASSERT_EQUAL_INT(1, events.closed);
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_STATE, bg95_socket_send(fixture.handle, SOCKET_ID, "ping", 4));
+
+  TEST_ASSERT_OK(bg95_socket_close(fixture.handle, SOCKET_ID));
+  test_sim_deinit(&fixture);
+}
+
+// Socket URCs with a connect ID that is not a number, or not a socket, are dropped
+static void test_malformed_urcs(void)
+{
+  test_sim_t      fixture;
+  socket_events_t events = {0};
+  TEST_ASSERT_OK(test_sim_init(&fixture, NULL));
+  if (!fixture.handle)
+  {
+    return;
+  }
+
+  TEST_ASSERT_OK(bg95_socket_set_event_callback(fixture.handle, on_socket_event, &events));
+  TEST_ASSERT_OK(bg95_socket_open(
+      fixture.handle, SOCKET_CONTEXT, SOCKET_ID, QIOPEN_SERVICE_TYPE_TCP, "echo.example", 7, NULL));
+
+  TEST_ASSERT_OK(bg95_sim_inject_urc(fixture.sim, "+QIURC: \"recv\",0abc", 0));
+  TEST_ASSERT_OK(bg95_sim_inject_urc(fixture.sim, "+QIURC: \"recv\",", 0));
+  TEST_ASSERT_OK(bg95_sim_inject_urc(fixture.sim, "+QIURC: \"closed\",\"0\"", 0));
+  TEST_ASSERT_OK(bg95_sim_inject_urc(fixture.sim, "+QIURC: \"closed\",12", 0));
+  TEST_ASSERT_OK(bg95_socket_poll(fixture.handle, 100));
+  TEST_ASSERT_EQUAL_INT(0, events.data);
+  TEST_ASSERT_EQUAL_INT(0, events.closed);
+  TEST_ASSERT(!bg95_socket_data_pending(fixture.handle, SOCKET_ID));
+
+  TEST_ASSERT_OK(bg95_sim_inject_urc(fixture.sim, "+QIURC: \"recv\",0", 0));
+  TEST_ASSERT_OK(bg95_socket_poll(fixture.handle, 100));
+  TEST_ASSERT_EQUAL_INT(1, events.data);
+  TEST_ASSERT(bg95_socket_data_pending(fixture.handle, SOCKET_ID));
+
+  TEST_ASSERT_OK(bg95_socket_close(fixture.handle, SOCKET_ID));
+  test_sim_deinit(&fixture);
+}
+
+static const test_case_t SOCKET_CASES[] = {
+    {"tcp_echo", "socket", test_tcp_echo},
+    {"udp_datagram", "socket", test_udp_datagram},
+    {"open_failures", "socket", test_open_failures},
+    {"events", "socket", test_events},
+    {"malformed_urcs", "socket", test_malformed_urcs},
+};
+
+TEST_SUITE(socket, SOCKET_CASES)
@@ -0,0 +1,266 @@
+// SSL contexts: the exact QSSLCFG command of every setting, the parse of every query response and
+// bg95_ssl_configure / bg95_ssl_get over the mock UART
+#include "at_cmd_qsslcfg.h"
+#include "test.h"
+
+// ------------------------------ SET ---------------------------------
+
+typedef struct
+{
+  qsslcfg_write_params_t params;
+  const char*            expected;
+} set_case_t;
+
+static void test_set_every_type(void)
+{
+  static const set_case_t cases[] = {
+      {{QSSLCFG_TYPE_SSLVERSION, 1, {.sslversion = QSSLCFG_SSLVERSION_TLS1_2}, {true}},
+       "AT+QSSLCFG=\"sslversion\",1,3\r\n"},
+      {{QSSLCFG_TYPE_CIPHERSUITE,
+        1,
+        {.ciphersuite = QSSLCFG_CIPHER_ECDHE_RSA_AES_128_GCM_SHA256},
+        {true}},
+       "AT+QSSLCFG=\"ciphersuite\",1,0XC02F\r\n"},
+      {{QSSLCFG_TYPE_CIPHERSUITE, 0, {.ciphersuite = QSSLCFG_CIPHER_ALL}, {true}},
+       "AT+QSSLCFG=\"ciphersuite\",0,0XFFFF\r\n"},
+      {{QSSLCFG_TYPE_CACERT, 2, {.path = "UFS:ca.pem"}, {true}},
+       "AT+QSSLCFG=\"cacert\",2,\"UFS:ca.pem\"\r\n"},
+      {{QSSLCFG_TYPE_CLIENTCERT, 2, {.path = "UFS:client.pem"}, {true}},
+       "AT+QSSLCFG=\"clientcert\",2,\"UFS:client.pem\"\r\n"},
+      {{QSSLCFG_TYPE_CLIENTKEY, 2, {.path = "UFS:client.key"}, {true}},
+       "AT+QSSLCFG=\"clientkey\",2,\"UFS:client.key\"\r\n"},
+      {{QSSLCFG_TYPE_SECLEVEL, 3, {.seclevel = QSSLCFG_SECLEVEL_SERVER_CLIENT}, {true}},
+       "AT+QSSLCFG=\"seclevel\",3,2\r\n"},
+      {{QSSLCFG_TYPE_IGNORELOCALTIME, 4, {.enable = true}, {true}},
+       "AT+QSSLCFG=\"ignorelocaltime\",4,1\r\n"},
+      {{QSSLCFG_TYPE_NEGOTIATETIME, 5, {.negotiate_time_s = 120}, {true}},
+       "AT+QSSLCFG=\"negotiatetime\",5,120\r\n"},
+      {{QSSLCFG_TYPE_SNI, 0, {.enable = true}, {true}}, "AT+QSSLCFG=\"sni\",0,1\r\n"},
+      {{QSSLCFG_TYPE_SESSION_CACHE, 0, {.enable = false}, {true}},
+       "AT+QSSLCFG=\"session_cache\",0,0\r\n"},
+  };
+  static const mock_uart_response_t responses[] = {{"AT+QSSLCFG=", "\r\nOK\r\n", 0}};
+  test_mock_t                       mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+        &mock.handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &cases[i].params, NULL));
+    TEST_ASSERT_EQUAL_STRING(cases[i].expected, test_mock_last_cmd(&mock));
+  }
+
+  test_mock_deinit(&mock);
+}
+
+// Nothing is sent for a value the module would reject
+static void test_set_invalid(void)
+{
+  static const qsslcfg_write_params_t cases[] = {
+      {QSSLCFG_TYPE_SNI, QSSLCFG_CTX_ID_MAX + 1, {.enable = true}, {true}},
+      {QSSLCFG_TYPE_SSLVERSION, 0, {.sslversion = QSSLCFG_SSLVERSION_ALL + 1}, {true}},
+      {QSSLCFG_TYPE_SECLEVEL, 0, {.seclevel = QSSLCFG_SECLEVEL_SERVER_CLIENT + 1}, {true}},
+      {QSSLCFG_TYPE_NEGOTIATETIME,
+       0,
+       {.negotiate_time_s = QSSLCFG_NEGOTIATE_TIME_MIN_S - 1},
+       {true}},
+      {QSSLCFG_TYPE_NEGOTIATETIME,
+       0,
+       {.negotiate_time_s = QSSLCFG_NEGOTIATE_TIME_MAX_S + 1},
+       {true}},
+      {QSSLCFG_TYPE_CACERT, 0, {.path = ""}, {true}},
+      {(qsslcfg_type_t) QSSLCFG_TYPE_MAP_SIZE, 0, {.enable = true}, {true}},
+  };
+  static const mock_uart_response_t responses[] = {{"AT", "\r\nOK\r\n", 0}};
+  test_mock_t                       mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG,
+                    at_cmd_handler_send_and_receive_cmd(
+                        &mock.handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &cases[i], NULL));
+    TEST_ASSERT_EQUAL_STRING("", test_mock_last_cmd(&mock));
+  }
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ QUERY ---------------------------------
+
+static void test_query_every_type(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"\"sslversion\"", "\r\n+QSSLCFG: \"sslversion\",1,4\r\n\r\nOK\r\n", 0},
+      {"\"ciphersuite\"", "\r\n+QSSLCFG: \"ciphersuite\",1,0XC030\r\n\r\nOK\r\n", 0},
+      {"\"cacert\"", "\r\n+QSSLCFG: \"cacert\",1,\"UFS:ca.pem\"\r\n\r\nOK\r\n", 0},
+      {"\"clientcert\"", "\r\n+QSSLCFG: \"clientcert\",1,\"UFS:client.pem\"\r\n\r\nOK\r\n", 0},
+      {"\"clientkey\"", "\r\n+QSSLCFG: \"clientkey\",1,\"UFS:client.key\"\r\n\r\nOK\r\n", 0},
+      {"\"seclevel\"", "\r\n+QSSLCFG: \"seclevel\",1,1\r\n\r\nOK\r\n", 0},
+      {"\"ignorelocaltime\"", "\r\n+QSSLCFG: \"ignorelocaltime\",1,1\r\n\r\nOK\r\n", 0},
+      {"\"negotiatetime\"", "\r\n+QSSLCFG: \"negotiatetime\",1,300\r\n\r\nOK\r\n", 0},
+      {"\"sni\"", "\r\n+QSSLCFG: \"sni\",1,0\r\n\r\nOK\r\n", 0},
+      {"\"session_cache\"", "\r\n+QSSLCFG: \"session_cache\",1,1\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 10));
+
+  qsslcfg_write_response_t read[QSSLCFG_TYPE_MAP_SIZE];
+  for (int type = 0; type < QSSLCFG_TYPE_MAP_SIZE; type++)
+  {
+    qsslcfg_write_params_t params = {.type = (qsslcfg_type_t) type, .ctx_id = 1};
+    TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+        &mock.handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &params, &read[type]));
+    TEST_ASSERT(read[type].has_data);
+    TEST_ASSERT_EQUAL_INT(type, read[type].type);
+    TEST_ASSERT_EQUAL_INT(1, read[type].ctx_id);
+  }
+  TEST_ASSERT_EQUAL_STRING("AT+QSSLCFG=\"session_cache\",1\r\n", test_mock_last_cmd(&mock));
+
+  TEST_ASSERT_EQUAL_INT(QSSLCFG_SSLVERSION_ALL, read[QSSLCFG_TYPE_SSLVERSION].value.sslversion);
+  TEST_ASSERT_EQUAL_INT(QSSLCFG_CIPHER_ECDHE_RSA_AES_256_GCM_SHA384,
+                        read[QSSLCFG_TYPE_CIPHERSUITE].value.ciphersuite);
+  TEST_ASSERT_EQUAL_STRING("UFS:ca.pem", read[QSSLCFG_TYPE_CACERT].value.path);
+  TEST_ASSERT_EQUAL_STRING("UFS:client.pem", read[QSSLCFG_TYPE_CLIENTCERT].value.path);
+  TEST_ASSERT_EQUAL_STRING("UFS:client.key", read[QSSLCFG_TYPE_CLIENTKEY].value.path);
+  TEST_ASSERT_EQUAL_INT(QSSLCFG_SECLEVEL_SERVER, read[QSSLCFG_TYPE_SECLEVEL].value.seclevel);
+  TEST_ASSERT(read[QSSLCFG_TYPE_IGNORELOCALTIME].value.enable);
+  TEST_ASSERT_EQUAL_INT(300, read[QSSLCFG_TYPE_NEGOTIATETIME].value.negotiate_time_s);
+  TEST_ASSERT(!read[QSSLCFG_TYPE_SNI].value.enable);
+  TEST_ASSERT(read[QSSLCFG_TYPE_SESSION_CACHE].value.enable);
+
+  test_mock_deinit(&mock);
+}
+
+static void test_query_command(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QSSLCFG=", "\r\n+QSSLCFG: \"sslversion\",1,3\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 1));
+
+  qsslcfg_write_params_t   params = {.type = QSSLCFG_TYPE_SSLVERSION, .ctx_id = 1};
+  qsslcfg_write_response_t read;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &params, &read));
+  TEST_ASSERT_EQUAL_STRING("AT+QSSLCFG=\"sslversion\",1\r\n", test_mock_last_cmd(&mock));
+  TEST_ASSERT_EQUAL_INT(QSSLCFG_SSLVERSION_TLS1_2, read.value.sslversion);
+
+  test_mock_deinit(&mock);
+}
+
+// A quoted cipher suite is accepted, out of range values and unknown settings are not
+static void test_query_parse_edge_cases(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"\"ciphersuite\"", "\r\n+QSSLCFG: \"ciphersuite\",0,\"0X0035\"\r\n\r\nOK\r\n", 0},
+      {"\"seclevel\"", "\r\n+QSSLCFG: \"seclevel\",0,3\r\n\r\nOK\r\n", 0},
+      {"\"sslversion\"", "\r\n+QSSLCFG: \"sslversion\",6,1\r\n\r\nOK\r\n", 0},
+      {"\"cacert\"", "\r\n+QSSLCFG: \"cacert\",0,UFS:ca.pem\r\n\r\nOK\r\n", 0},
+      {"\"sni\"", "\r\n+QSSLCFG: \"dtls\",0,1\r\n\r\nOK\r\n", 0},
+  };
+  test_mock_t mock;
+  TEST_ASSERT_OK(test_mock_init(&mock, responses, 5));
+
+  qsslcfg_write_params_t   params = {.type = QSSLCFG_TYPE_CIPHERSUITE, .ctx_id = 0};
+  qsslcfg_write_response_t read;
+  TEST_ASSERT_OK(at_cmd_handler_send_and_receive_cmd(
+      &mock.handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &params, &read));
+  TEST_ASSERT_EQUAL_INT(QSSLCFG_CIPHER_RSA_AES_256_CBC_SHA, read.value.ciphersuite);
+
+  static const qsslcfg_type_t rejected[] = {
+      QSSLCFG_TYPE_SECLEVEL, QSSLCFG_TYPE_SSLVERSION, QSSLCFG_TYPE_CACERT, QSSLCFG_TYPE_SNI};
+  for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++)
+  {
+    params.type = rejected[i];
+    TEST_ASSERT_ERR(ESP_ERR_INVALID_RESPONSE,
+                    at_cmd_handler_send_and_receive_cmd(
+                        &mock.handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &params, &read));
+  }
+
+  test_mock_deinit(&mock);
+}
+
+// ------------------------------ DRIVER ---------------------------------
+
+static void test_configure_mutual_authentication(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"AT+QSSLCFG=", "\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 2));
+
+  bg95_ssl_config_t config = {.version            = QSSLCFG_SSLVERSION_TLS1_2,
+                              .cipher_suite       = QSSLCFG_CIPHER_ALL,
+                              .seclevel           = QSSLCFG_SECLEVEL_SERVER_CLIENT,
+                              .cacert_path        = "UFS:ca.pem",
+                              .client_cert_path   = "UFS:client.pem",
+                              .client_key_path    = "UFS:client.key",
+                              .session_resumption = true};
+  TEST_ASSERT_OK(bg95_ssl_configure(driver.handle, 2, &config));
+  // The boolean settings come last
+  TEST_ASSERT_EQUAL_STRING("AT+QSSLCFG=\"session_cache\",2,1\r\n", test_driver_last_cmd(&driver));
+
+  test_driver_deinit(&driver);
+}
+
+static void test_configure_missing_certificates(void)
+{
+  static const mock_uart_response_t responses[] = {{"AT", "\r\nOK\r\n", 0}};
+  test_driver_t                     driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 1));
+
+  bg95_ssl_config_t config = {.version     = QSSLCFG_SSLVERSION_TLS1_2,
+                              .seclevel    = QSSLCFG_SECLEVEL_SERVER_CLIENT,
+                              .cacert_path = "UFS:ca.pem"};
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, bg95_ssl_configure(driver.handle, 0, &config));
+  config.seclevel    = QSSLCFG_SECLEVEL_SERVER;
+  config.cacert_path = NULL;
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG, bg95_ssl_configure(driver.handle, 0, &config));
+  TEST_ASSERT(strstr(test_driver_last_cmd(&driver), "QSSLCFG") == NULL);
+
+  test_driver_deinit(&driver);
+}
+
+static void test_get(void)
+{
+  static const mock_uart_response_t responses[] = {
+      {"\"negotiatetime\",3", "\r\n+QSSLCFG: \"negotiatetime\",3,90\r\n\r\nOK\r\n", 0},
+      {"\"seclevel\",3", "\r\n+QSSLCFG: \"sni\",3,1\r\n\r\nOK\r\n", 0},
+      {"AT+QSSLCFG=", "\r\nOK\r\n", 0},
+      {"AT", "\r\nOK\r\n", 0},
+  };
+  test_driver_t driver;
+  TEST_ASSERT_OK(test_driver_init(&driver, responses, 4));
+
+  qsslcfg_value_t value;
+  TEST_ASSERT_OK(bg95_ssl_get(driver.handle, 3, QSSLCFG_TYPE_NEGOTIATETIME, &value));
+  TEST_ASSERT_EQUAL_STRING("AT+QSSLCFG=\"negotiatetime\",3\r\n", test_driver_last_cmd(&driver));
+  TEST_ASSERT_EQUAL_INT(90, value.negotiate_time_s);
+
+  // Another setting in the answer, or none at all
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_RESPONSE,
+                  bg95_ssl_get(driver.handle, 3, QSSLCFG_TYPE_SECLEVEL, &value));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_RESPONSE,
+                  bg95_ssl_get(driver.handle, 3, QSSLCFG_TYPE_CACERT, &value));
+  TEST_ASSERT_ERR(ESP_ERR_INVALID_ARG,
+                  bg95_ssl_get(driver.handle, QSSLCFG_CTX_ID_MAX + 1, QSSLCFG_TYPE_SNI, &value));
+
+  test_driver_deinit(&driver);
+}
+
+static const test_case_t SSL_CASES[] = {
+    {"set_every_type", "ssl", test_set_every_type},
+    {"set_invalid", "ssl", test_set_invalid},
+    {"query_every_type", "ssl", test_query_every_type},
+    {"query_command", "ssl", test_query_command},
+    {"query_parse_edge_cases", "ssl", test_query_parse_edge_cases},
+    {"configure_mutual_authentication", "ssl", test_configure_mutual_authentication},
+    {"configure_missing_certificates", "ssl", test_configure_missing_certificates},
+    {"get", "ssl", test_get},
+};
+
+TEST_SUITE(ssl, SSL_CASES)
@@ -0,0 +1,13 @@
+// Close a file opened with QFOPEN
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+typedef struct
+{
+  uint32_t file_handle;
+} qfclose_write_params_t;
+
+extern const at_cmd_t AT_CMD_QFCLOSE;
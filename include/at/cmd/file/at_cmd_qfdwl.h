@@ -0,0 +1,24 @@
+// Download a whole file. The module answers CONNECT, outputs the file data, then reports
+// \r\n+QFDWL: <download_size>,<checksum> and OK - use at_cmd_handler_send_and_stream with
+// QFDWL_END_MARKER so the data is never buffered whole
+#pragma once
+
+#include "at_cmd_qfopen.h"
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QFDWL_END_MARKER "\r\n+QFDWL: "
+
+typedef struct
+{
+  char filename[QFOPEN_FILENAME_MAX_LEN + 1];
+} qfdwl_write_params_t;
+
+typedef struct
+{
+  uint32_t download_size;
+  uint16_t checksum; // 16 bit XOR of the data, see bg95_file_checksum_update
+} qfdwl_write_response_t;
+
+extern const at_cmd_t AT_CMD_QFDWL;
@@ -0,0 +1,32 @@
+// Open a file on the module file system (UFS). The returned file handle is used by the other
+// QF* file commands
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdint.h>
+
+#define QFOPEN_FILENAME_MAX_LEN 80 // Including a "UFS:" prefix
+
+typedef enum
+{
+  QFOPEN_MODE_CREATE_OR_OPEN  = 0U, // Create if missing, otherwise open (read / write)
+  QFOPEN_MODE_CREATE_OR_CLEAR = 1U, // Create if missing, otherwise truncate (read / write)
+  QFOPEN_MODE_READ_ONLY       = 2U, // The file must exist
+} qfopen_mode_t;
+#define QFOPEN_MODE_MAP_SIZE 3
+extern const enum_str_map_t QFOPEN_MODE_MAP[QFOPEN_MODE_MAP_SIZE];
+
+typedef struct
+{
+  char          filename[QFOPEN_FILENAME_MAX_LEN + 1];
+  qfopen_mode_t mode;
+} qfopen_write_params_t;
+
+typedef struct
+{
+  uint32_t file_handle;
+} qfopen_write_response_t;
+
+extern const at_cmd_t AT_CMD_QFOPEN;
@@ -0,0 +1,21 @@
+// Read from an open file. The response carries raw, possibly binary, data:
+// CONNECT <read_length>\r\n<data>\r\nOK
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QFREAD_READ_MAX_LEN 1024 // Max bytes per QFREAD used by the driver
+
+typedef struct
+{
+  uint32_t file_handle;
+  uint16_t length;
+} qfread_write_params_t;
+
+// Payload locator for at_cmd_handler_send_and_receive_payload. The read length is the payload
+// length (0 at the end of the file)
+esp_err_t qfread_locate_payload(const char* response, size_t* payload_offset, size_t* payload_len);
+
+extern const at_cmd_t AT_CMD_QFREAD;
@@ -0,0 +1,22 @@
+// Set the position of the file pointer of an open file
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+typedef enum
+{
+  QFSEEK_POSITION_BEGIN   = 0U, // Offset is counted from the start of the file
+  QFSEEK_POSITION_CURRENT = 1U,
+  QFSEEK_POSITION_END     = 2U,
+} qfseek_position_t;
+
+typedef struct
+{
+  uint32_t          file_handle;
+  uint32_t          offset;
+  qfseek_position_t position;
+} qfseek_write_params_t;
+
+extern const at_cmd_t AT_CMD_QFSEEK;
@@ -0,0 +1,25 @@
+// Write to an open file. The module answers CONNECT and takes the data, then reports
+// +QFWRITE: <written_length>,<total_length>
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QFWRITE_INPUT_TIME_MIN_S 1
+#define QFWRITE_INPUT_TIME_DEFAULT_S 5
+
+typedef struct
+{
+  uint32_t file_handle;
+  uint16_t length;       // Bytes sent after CONNECT
+  uint16_t input_time_s; // Max time to wait for the data
+} qfwrite_write_params_t;
+
+typedef struct
+{
+  uint32_t written_length;
+  uint32_t total_length; // Size of the file after the write
+} qfwrite_write_response_t;
+
+extern const at_cmd_t AT_CMD_QFWRITE;
@@ -0,0 +1,44 @@
+// Turn on GNSS. Positioning runs until QGPSEND (or until 'fix_count' fixes have been made)
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  QGPS_MODE_STANDALONE = 1U, // The only mode supported by the BG95
+} qgps_mode_t;
+
+#define QGPS_FIX_MAX_TIME_MIN_S 1
+#define QGPS_FIX_MAX_TIME_MAX_S 255
+#define QGPS_FIX_MAX_DIST_MAX_M 1000
+#define QGPS_FIX_COUNT_MAX 1000 // 0: keep positioning until QGPSEND
+#define QGPS_FIX_RATE_MIN_S 1
+
+typedef struct
+{
+  qgps_mode_t mode;
+  uint8_t     fix_max_time_s; // Max time to wait for a fix
+  uint16_t    fix_max_dist_m; // Accuracy threshold
+  uint16_t    fix_count;
+  uint16_t    fix_rate_s; // Interval between fixes
+  struct
+  {
+    bool has_fix_params : 1; // If not set the module defaults are used (30 s, 50 m, 0, 1 s)
+  } present;
+} qgps_write_params_t;
+
+typedef enum
+{
+  QGPS_STATE_OFF = 0U,
+  QGPS_STATE_ON  = 1U,
+} qgps_state_t;
+
+typedef struct
+{
+  qgps_state_t state;
+} qgps_read_response_t;
+
+extern const at_cmd_t AT_CMD_QGPS;
@@ -0,0 +1,36 @@
+// Configure GNSS - only the NMEA output related settings are implemented
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+
+typedef enum
+{
+  QGPSCFG_TYPE_OUTPORT = 0U, // Port the NMEA sentences are output on
+  QGPSCFG_TYPE_NMEASRC = 1U, // 1: NMEA sentences can be read with QGPSGNMEA
+} qgpscfg_type_t;
+#define QGPSCFG_TYPE_MAP_SIZE 2
+extern const enum_str_map_t QGPSCFG_TYPE_MAP[QGPSCFG_TYPE_MAP_SIZE];
+
+typedef enum
+{
+  QGPSCFG_OUTPORT_NONE     = 0U,
+  QGPSCFG_OUTPORT_USBNMEA  = 1U, // USB NMEA port
+  QGPSCFG_OUTPORT_UARTNMEA = 2U, // Debug UART
+} qgpscfg_outport_t;
+#define QGPSCFG_OUTPORT_MAP_SIZE 3
+extern const enum_str_map_t QGPSCFG_OUTPORT_MAP[QGPSCFG_OUTPORT_MAP_SIZE];
+
+typedef struct
+{
+  qgpscfg_type_t type;
+  union
+  {
+    qgpscfg_outport_t outport;
+    bool              nmeasrc;
+  } value;
+} qgpscfg_write_params_t;
+
+extern const at_cmd_t AT_CMD_QGPSCFG;
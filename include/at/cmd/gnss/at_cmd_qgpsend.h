@@ -0,0 +1,6 @@
+// Turn off GNSS
+#pragma once
+
+#include "at_cmd_structure.h"
+
+extern const at_cmd_t AT_CMD_QGPSEND;
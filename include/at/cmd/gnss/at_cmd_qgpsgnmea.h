@@ -0,0 +1,35 @@
+// Read the latest NMEA sentences of a type. Needs QGPSCFG="nmeasrc",1 and GNSS turned on
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stddef.h>
+
+typedef enum
+{
+  QGPSGNMEA_SENTENCE_GGA = 0U,
+  QGPSGNMEA_SENTENCE_RMC = 1U,
+  QGPSGNMEA_SENTENCE_GSV = 2U,
+  QGPSGNMEA_SENTENCE_GSA = 3U,
+  QGPSGNMEA_SENTENCE_VTG = 4U,
+  QGPSGNMEA_SENTENCE_GNS = 5U,
+} qgpsgnmea_sentence_t;
+#define QGPSGNMEA_SENTENCE_MAP_SIZE 6
+extern const enum_str_map_t QGPSGNMEA_SENTENCE_MAP[QGPSGNMEA_SENTENCE_MAP_SIZE];
+
+// Some types (e.g. GSV) come as several sentences, one '+QGPSGNMEA: ' line each
+#define QGPSGNMEA_NMEA_MAX_LEN 512
+
+typedef struct
+{
+  qgpsgnmea_sentence_t sentence;
+} qgpsgnmea_write_params_t;
+
+typedef struct
+{
+  char   nmea[QGPSGNMEA_NMEA_MAX_LEN]; // The sentences, each ending with CRLF
+  size_t nmea_len;
+} qgpsgnmea_write_response_t;
+
+extern const at_cmd_t AT_CMD_QGPSGNMEA;
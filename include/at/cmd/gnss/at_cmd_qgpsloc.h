@@ -0,0 +1,45 @@
+// Acquire the position. Fails with +CME ERROR: 516 until the first fix has been made.
+// Only <mode> 2 (decimal degrees) is implemented
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+typedef enum
+{
+  QGPSLOC_MODE_DECIMAL = 2U, // Latitude / longitude as (-)dd.ddddd / (-)ddd.ddddd
+} qgpsloc_mode_t;
+
+typedef enum
+{
+  QGPSLOC_FIX_2D = 2U,
+  QGPSLOC_FIX_3D = 3U,
+} qgpsloc_fix_t;
+
+typedef struct
+{
+  qgpsloc_mode_t mode;
+} qgpsloc_write_params_t;
+
+// Fixed point, so the position keeps the full resolution reported by the module
+typedef struct
+{
+  uint8_t       hour; // UTC
+  uint8_t       minute;
+  uint8_t       second;
+  uint16_t      millisecond;
+  int32_t       latitude_e7;  // Degrees * 10^7, negative is south
+  int32_t       longitude_e7; // Degrees * 10^7, negative is west
+  uint16_t      hdop_x100;
+  int32_t       altitude_cm; // Above mean sea level
+  qgpsloc_fix_t fix;
+  uint16_t      course_x100; // Course over ground, degrees from true north * 100
+  uint32_t      speed_kmh_x100;
+  uint8_t       day;
+  uint8_t       month;
+  uint16_t      year;
+  uint8_t       satellites; // Used for the fix
+} qgpsloc_write_response_t;
+
+extern const at_cmd_t AT_CMD_QGPSLOC;
@@ -0,0 +1,55 @@
+// Enable the 3GPP TS 27.010 multiplexer. Once OK is received, the UART only carries CMUX frames
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  CMUX_MODE_BASIC = 0U, // Basic option (the only mode supported by the module)
+} cmux_mode_t;
+
+typedef enum
+{
+  CMUX_SUBSET_UIH = 0U, // Only UIH frames are used
+} cmux_subset_t;
+
+typedef enum
+{
+  CMUX_PORT_SPEED_9600   = 1U,
+  CMUX_PORT_SPEED_19200  = 2U,
+  CMUX_PORT_SPEED_38400  = 3U,
+  CMUX_PORT_SPEED_57600  = 4U,
+  CMUX_PORT_SPEED_115200 = 5U,
+  CMUX_PORT_SPEED_230400 = 6U,
+  CMUX_PORT_SPEED_460800 = 7U,
+  CMUX_PORT_SPEED_921600 = 8U,
+} cmux_port_speed_t;
+
+#define CMUX_PORT_SPEED_MAP_SIZE 8
+extern const enum_str_map_t CMUX_PORT_SPEED_MAP[CMUX_PORT_SPEED_MAP_SIZE];
+
+#define CMUX_N1_MIN 1
+#define CMUX_N1_MAX 32768
+#define CMUX_N1_DEFAULT 31 // Max info field length per frame
+
+typedef struct
+{
+  bool has_port_speed : 1;
+  bool has_n1 : 1;
+} cmux_write_present_flags_t;
+
+// Trailing parameters can only be given when all parameters before them are given
+typedef struct
+{
+  cmux_mode_t                mode;
+  cmux_subset_t              subset;
+  cmux_port_speed_t          port_speed;
+  uint16_t                   n1;
+  cmux_write_present_flags_t present;
+} cmux_write_params_t;
+
+extern const at_cmd_t AT_CMD_CMUX;
@@ -0,0 +1,29 @@
+// Set the local data flow control of the main UART. Like AT+IPR, the setting is only kept across
+// reboots once saved with AT&W (see ipr_write_params_t).
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+typedef enum
+{
+  IFC_FLOW_CONTROL_NONE    = 0U,
+  IFC_FLOW_CONTROL_RTS_CTS = 2U, // RTS for DCE by DTE, CTS for DTE by DCE
+} ifc_flow_control_t;
+
+#define IFC_FLOW_CONTROL_MAP_SIZE 2
+extern const enum_str_map_t IFC_FLOW_CONTROL_MAP[IFC_FLOW_CONTROL_MAP_SIZE];
+
+typedef struct
+{
+  ifc_flow_control_t dce_by_dte; // Host -> module direction (host RTS)
+  ifc_flow_control_t dte_by_dce; // Module -> host direction (module CTS)
+} ifc_read_response_t;
+
+typedef struct
+{
+  ifc_flow_control_t dce_by_dte;
+  ifc_flow_control_t dte_by_dce;
+} ifc_write_params_t;
+
+extern const at_cmd_t AT_CMD_IFC;
@@ -0,0 +1,26 @@
+// Set the fixed baud rate of the main UART. The module answers at the old rate and then switches,
+// but the rate is only kept across reboots once saved with AT&W ('save').
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define IPR_NUM_RATES 8
+extern const uint32_t IPR_RATES[IPR_NUM_RATES];
+
+bool ipr_rate_is_valid(uint32_t rate);
+
+typedef struct
+{
+  uint32_t rate;
+} ipr_read_response_t;
+
+typedef struct
+{
+  uint32_t rate;
+  bool     save; // Appends ';&W' - stores all current settings (incl. AT+IFC) in the user profile
+} ipr_write_params_t;
+
+extern const at_cmd_t AT_CMD_IPR;
@@ -0,0 +1,27 @@
+// Configure whether the module is allowed to enter sleep mode. When enabled, the module sleeps while
+// DTR is pulled HIGH and wakes (UART usable again) once DTR is pulled LOW.
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+typedef enum
+{
+  QSCLK_SLEEP_DISABLE = 0U,
+  QSCLK_SLEEP_ENABLE  = 1U, // Sleep is controlled by the DTR pin
+} qsclk_sleep_mode_t;
+
+#define QSCLK_SLEEP_MODE_MAP_SIZE 2
+extern const enum_str_map_t QSCLK_SLEEP_MODE_MAP[QSCLK_SLEEP_MODE_MAP_SIZE];
+
+typedef struct
+{
+  qsclk_sleep_mode_t mode;
+} qsclk_read_response_t;
+
+typedef struct
+{
+  qsclk_sleep_mode_t mode;
+} qsclk_write_params_t;
+
+extern const at_cmd_t AT_CMD_QSCLK;
@@ -0,0 +1,41 @@
+// Configure parameters for the HTTP(S) server
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdint.h>
+
+typedef enum
+{
+  QHTTPCFG_TYPE_CONTEXTID      = 0U, // PDP context used for HTTP(S)
+  QHTTPCFG_TYPE_REQUESTHEADER  = 1U, // 1: the request header is given by the host
+  QHTTPCFG_TYPE_RESPONSEHEADER = 2U, // 1: QHTTPREAD also outputs the response header
+  QHTTPCFG_TYPE_SSLCTXID       = 3U, // SSL context used for HTTPS
+  QHTTPCFG_TYPE_CONTENTTYPE    = 4U, // Content type of POST bodies
+} qhttpcfg_type_t;
+#define QHTTPCFG_TYPE_MAP_SIZE 5
+extern const enum_str_map_t QHTTPCFG_TYPE_MAP[QHTTPCFG_TYPE_MAP_SIZE];
+
+typedef enum
+{
+  QHTTPCFG_CONTENT_TYPE_FORM_URLENCODED = 0U,
+  QHTTPCFG_CONTENT_TYPE_TEXT_PLAIN      = 1U,
+  QHTTPCFG_CONTENT_TYPE_OCTET_STREAM    = 2U,
+  QHTTPCFG_CONTENT_TYPE_MULTIPART_FORM  = 3U,
+} qhttpcfg_content_type_t;
+#define QHTTPCFG_CONTENT_TYPE_MAP_SIZE 4
+extern const enum_str_map_t QHTTPCFG_CONTENT_TYPE_MAP[QHTTPCFG_CONTENT_TYPE_MAP_SIZE];
+
+#define QHTTPCFG_CONTEXT_ID_MIN 1
+#define QHTTPCFG_CONTEXT_ID_MAX 16
+#define QHTTPCFG_SSL_CONTEXT_ID_MAX 5
+
+// Every setting takes a single integer value (booleans are 0 / 1)
+typedef struct
+{
+  qhttpcfg_type_t type;
+  int             value;
+} qhttpcfg_write_params_t;
+
+extern const at_cmd_t AT_CMD_QHTTPCFG;
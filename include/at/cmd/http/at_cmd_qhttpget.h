@@ -0,0 +1,42 @@
+// Send a GET request to the HTTP(S) server (URL set with QHTTPURL). The result is reported by the
+// '+QHTTPGET: <err>[,<httprspcode>[,<content_length>]]' URC that follows OK
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define QHTTP_ERR_OK 0 // Any other value is an error code (e.g. 702 HTTP(S) timeout)
+
+// Response time the module is allowed - bounded by the command timeouts of the request commands
+#define QHTTP_RSPTIME_MIN_S 1
+#define QHTTP_RSPTIME_MAX_S 120
+#define QHTTP_RSPTIME_DEFAULT_S 60
+
+typedef struct
+{
+  bool has_http_status : 1;
+  bool has_content_length : 1; // Not given for chunked responses
+} qhttp_result_present_flags_t;
+
+// Result of a request (GET, GET by range, POST)
+typedef struct
+{
+  int                          err; // QHTTP_ERR_OK or an error code
+  uint16_t                     http_status;
+  uint32_t                     content_length;
+  qhttp_result_present_flags_t present;
+} qhttp_request_result_t;
+
+// Parses '<err>[,<httprspcode>[,<content_length>]]' - shared by the request commands
+esp_err_t qhttp_parse_request_result(const char* start, qhttp_request_result_t* result);
+
+typedef struct
+{
+  uint16_t rsptime_s;
+} qhttpget_write_params_t;
+
+typedef qhttp_request_result_t qhttpget_write_response_t;
+
+extern const at_cmd_t AT_CMD_QHTTPGET;
@@ -0,0 +1,19 @@
+// Send a GET request for a byte range of the resource (e.g. to resume a download). The result is
+// reported by the '+QHTTPGETEX: <err>[,<httprspcode>[,<content_length>]]' URC that follows OK
+#pragma once
+
+#include "at_cmd_qhttpget.h"
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+typedef struct
+{
+  uint16_t rsptime_s;
+  uint32_t start_position; // Offset of the first byte requested
+  uint32_t read_len;       // Number of bytes requested
+} qhttpgetex_write_params_t;
+
+typedef qhttp_request_result_t qhttpgetex_write_response_t;
+
+extern const at_cmd_t AT_CMD_QHTTPGETEX;
@@ -0,0 +1,23 @@
+// Send a POST request to the HTTP(S) server. The module answers CONNECT and takes the body as data,
+// then reports the result with the '+QHTTPPOST: <err>[,<httprspcode>[,<content_length>]]' URC
+#pragma once
+
+#include "at_cmd_qhttpget.h"
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QHTTPPOST_DATA_MAX_LEN 1024000
+#define QHTTPPOST_INPUT_TIME_MIN_S 1
+#define QHTTPPOST_INPUT_TIME_DEFAULT_S 60
+
+typedef struct
+{
+  uint32_t data_length;  // Length of the body sent after CONNECT
+  uint16_t input_time_s; // Max time to wait for the body to be input
+  uint16_t rsptime_s;
+} qhttppost_write_params_t;
+
+typedef qhttp_request_result_t qhttppost_write_response_t;
+
+extern const at_cmd_t AT_CMD_QHTTPPOST;
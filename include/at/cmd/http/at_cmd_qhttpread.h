@@ -0,0 +1,24 @@
+// Read the response of the last request. The module answers CONNECT, outputs the body, then OK and
+// '+QHTTPREAD: <err>' - use at_cmd_handler_send_and_stream so the body is never buffered whole
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+// Max gap between two packets of the body - bounded by the command timeout
+#define QHTTPREAD_WAIT_TIME_MIN_S 1
+#define QHTTPREAD_WAIT_TIME_MAX_S 60
+#define QHTTPREAD_WAIT_TIME_DEFAULT_S 60
+
+typedef struct
+{
+  uint16_t wait_time_s;
+} qhttpread_write_params_t;
+
+typedef struct
+{
+  int err; // QHTTP_ERR_OK or an error code
+} qhttpread_write_response_t;
+
+extern const at_cmd_t AT_CMD_QHTTPREAD;
@@ -0,0 +1,19 @@
+// Set the URL of the HTTP(S) server. The module answers CONNECT, then takes the URL itself as data
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QHTTPURL_URL_MAX_LEN 700
+#define QHTTPURL_INPUT_TIME_MIN_S 1
+#define QHTTPURL_INPUT_TIME_MAX_S 65535
+#define QHTTPURL_INPUT_TIME_DEFAULT_S 60
+
+typedef struct
+{
+  uint16_t url_length;   // Length of the URL sent after CONNECT
+  uint16_t input_time_s; // Max time to wait for the URL to be input
+} qhttpurl_write_params_t;
+
+extern const at_cmd_t AT_CMD_QHTTPURL;
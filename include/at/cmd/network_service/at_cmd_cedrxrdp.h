@@ -0,0 +1,24 @@
+// eDRX Read Dynamic Parameters - the eDRX cycle and paging time window granted by the network
+#pragma once
+
+#include "at_cmd_cedrxs.h"
+#include "at_cmd_structure.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+  cedrxs_act_type_t act_type;
+  uint8_t           requested_edrx_value; // 4 bit eDRX value requested by the UE
+  uint8_t           nw_edrx_value;        // 4 bit eDRX value provided by the network
+  uint8_t           paging_time_window;   // 4 bit PTW provided by the network
+  struct
+  {
+    bool has_requested_edrx_value : 1;
+    bool has_nw_edrx_value : 1;
+    bool has_paging_time_window : 1;
+  } present;
+} cedrxrdp_execute_response_t;
+
+extern const at_cmd_t AT_CMD_CEDRXRDP;
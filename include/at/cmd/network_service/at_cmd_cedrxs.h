@@ -0,0 +1,77 @@
+// e-I-DRX Setting - request an extended DRX cycle for the given access technology
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  CEDRXS_MODE_DISABLE             = 0U,
+  CEDRXS_MODE_ENABLE              = 1U,
+  CEDRXS_MODE_ENABLE_WITH_URC     = 2U, // Enable and report +CEDRXP URC when params change
+  CEDRXS_MODE_DISABLE_AND_DISCARD = 3U, // Disable eDRX and reset params to manufacturer defaults
+} cedrxs_mode_t;
+#define CEDRXS_MODE_MAP_SIZE 4
+extern const enum_str_map_t CEDRXS_MODE_MAP[CEDRXS_MODE_MAP_SIZE];
+
+typedef enum
+{
+  CEDRXS_ACT_TYPE_NOT_USED = 0U,
+  CEDRXS_ACT_TYPE_EMTC     = 4U, // E-UTRAN (WB-S1 mode)
+  CEDRXS_ACT_TYPE_NBIOT    = 5U, // E-UTRAN (NB-S1 mode)
+} cedrxs_act_type_t;
+#define CEDRXS_ACT_TYPE_MAP_SIZE 3
+extern const enum_str_map_t CEDRXS_ACT_TYPE_MAP[CEDRXS_ACT_TYPE_MAP_SIZE];
+
+// eDRX values are sent as half a byte in binary string format, e.g. "0101" (3GPP TS 24.008)
+#define CEDRXS_VALUE_BITS_LEN 4
+#define CEDRXS_VALUE_STR_SIZE (CEDRXS_VALUE_BITS_LEN + 1)
+#define CEDRXS_VALUE_MAX 15
+#define CEDRXS_MAX_ACT_TYPES 2 // Cat-M1 and NB-IoT
+
+typedef struct
+{
+  cedrxs_mode_t     mode;
+  cedrxs_act_type_t act_type;
+  uint8_t           edrx_value; // 0-15, see cedrxs_cycle_ms_to_value()
+  struct
+  {
+    bool has_act_type : 1;
+    bool has_edrx_value : 1;
+  } present;
+} cedrxs_write_params_t;
+
+typedef struct
+{
+  cedrxs_act_type_t act_type;
+  uint8_t           edrx_value;
+} cedrxs_setting_t;
+
+// Read response has one line per access technology
+typedef struct
+{
+  cedrxs_setting_t settings[CEDRXS_MAX_ACT_TYPES];
+  uint8_t          num_settings;
+} cedrxs_read_response_t;
+
+// eDRX cycle helpers (3GPP TS 24.008 table 10.5.5.32)
+// Returns 0 if the value is not used for the given access technology
+uint32_t cedrxs_value_to_cycle_ms(cedrxs_act_type_t act_type, uint8_t edrx_value);
+// Picks the shortest cycle that is >= cycle_ms, like the PSM timer encoding (cpsms_encode_*).
+// ESP_ERR_INVALID_ARG if cycle_ms is longer than the longest cycle
+esp_err_t
+cedrxs_cycle_ms_to_value(cedrxs_act_type_t act_type, uint32_t cycle_ms, uint8_t* edrx_value);
+// Paging time window, reported by +CEDRXRDP
+uint32_t cedrxs_ptw_to_ms(cedrxs_act_type_t act_type, uint8_t ptw_value);
+
+// Binary string conversion ("0101" <-> 5)
+esp_err_t cedrxs_bits_to_value(const char* bits, uint8_t* value);
+
+// Same for a (quoted) response field - it must be exactly CEDRXS_VALUE_BITS_LEN bits
+esp_err_t cedrxs_field_to_value(const at_field_t* field, uint8_t* value);
+
+extern const at_cmd_t AT_CMD_CEDRXS;
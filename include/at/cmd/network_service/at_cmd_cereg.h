@@ -0,0 +1,71 @@
+// EPS Network Registration Status (LTE Cat-M1 / NB-IoT). With n=4 the read response also carries
+// the PSM timers granted by the network.
+#pragma once
+
+#include "at_cmd_cpsms.h"
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  CEREG_N_DISABLE_URC          = 0U,
+  CEREG_N_ENABLE_URC           = 1U,
+  CEREG_N_ENABLE_URC_LOCATION  = 2U,
+  CEREG_N_ENABLE_URC_CAUSE     = 3U,
+  CEREG_N_ENABLE_URC_PSM       = 4U, // Location and PSM timers
+  CEREG_N_ENABLE_URC_PSM_CAUSE = 5U, // Location, cause and PSM timers
+} cereg_n_t;
+#define CEREG_N_MAP_SIZE 6
+extern const enum_str_map_t CEREG_N_MAP[CEREG_N_MAP_SIZE];
+
+typedef enum
+{
+  CEREG_STAT_NOT_SEARCHING = 0U,
+  CEREG_STAT_HOME          = 1U,
+  CEREG_STAT_SEARCHING     = 2U,
+  CEREG_STAT_DENIED        = 3U,
+  CEREG_STAT_UNKNOWN       = 4U,
+  CEREG_STAT_ROAMING       = 5U,
+} cereg_stat_t;
+#define CEREG_STAT_MAP_SIZE 6
+extern const enum_str_map_t CEREG_STAT_MAP[CEREG_STAT_MAP_SIZE];
+
+typedef enum
+{
+  CEREG_ACT_EMTC  = 8U,
+  CEREG_ACT_NBIOT = 9U,
+} cereg_act_t;
+
+#define CEREG_TAC_MAX_CHARS 5 // 2 byte hex string
+#define CEREG_CI_MAX_CHARS 9  // 4 byte hex string
+
+typedef struct
+{
+  bool has_tac : 1;
+  bool has_ci : 1;
+  bool has_act : 1;
+  bool has_active_time : 1;
+  bool has_periodic_tau : 1;
+} cereg_present_flags_t;
+
+typedef struct
+{
+  cereg_n_t             n;
+  cereg_stat_t          stat;
+  char                  tac[CEREG_TAC_MAX_CHARS];
+  char                  ci[CEREG_CI_MAX_CHARS];
+  cereg_act_t           act;
+  char                  active_time[CPSMS_TIMER_STR_SIZE];  // T3324 granted by the network
+  char                  periodic_tau[CPSMS_TIMER_STR_SIZE]; // T3412 extended granted by network
+  cereg_present_flags_t present;
+} cereg_read_response_t;
+
+typedef struct
+{
+  cereg_n_t n;
+} cereg_write_params_t;
+
+extern const at_cmd_t AT_CMD_CEREG;
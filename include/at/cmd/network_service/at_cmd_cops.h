@@ -45,26 +45,37 @@ typedef enum
 #define COPS_ACT_MAP_SIZE 3
 extern const enum_str_map_t COPS_ACT_MAP[COPS_ACT_MAP_SIZE];
 
-// TODO: Implement the test type of this AT cmd
-//  Response structures
-//  typedef struct
-//  {
-//    cops_stat_t stat;
-//    char        operator_name[64];
-//    cops_act_t  act;
-//    struct
-//    {
-//      bool has_stat : 1;
-//      bool has_operator : 1;
-//      bool has_act : 1;
-//    } present;
-//  } cops_operator_info_t;
-//
-//  typedef struct
-//  {
-//    cops_operator_info_t operators[10];
-//    uint8_t              num_operators;
-//  } cops_test_response_t;
+#define COPS_MAX_OPERATORS 10
+#define COPS_OPERATOR_LONG_NAME_MAX_CHARS 32
+#define COPS_OPERATOR_SHORT_NAME_MAX_CHARS 16
+#define COPS_OPERATOR_NUMERIC_MAX_CHARS 8 // MCC + MNC, e.g. "302720"
+
+// One entry of the test (scan) response: (<stat>,"<long>","<short>","<numeric>"[,<AcT>])
+typedef struct
+{
+  cops_stat_t stat;
+  char        long_name[COPS_OPERATOR_LONG_NAME_MAX_CHARS];
+  char        short_name[COPS_OPERATOR_SHORT_NAME_MAX_CHARS];
+  char        numeric[COPS_OPERATOR_NUMERIC_MAX_CHARS];
+  cops_act_t  act;
+  struct
+  {
+    bool has_act : 1;
+  } present;
+} cops_operator_info_t;
+
+typedef struct
+{
+  cops_operator_info_t operators[COPS_MAX_OPERATORS];
+  uint8_t              num_operators;
+} cops_test_response_t;
+
+// Parse a single operator entry. 'entry' must point at the opening '('. On success 'entry_end' (if
+// not NULL) is set past the closing ')'. Returns ESP_ERR_NOT_FOUND if the entry is not yet complete
+// and ESP_ERR_INVALID_RESPONSE if it is not an operator entry (e.g. the trailing "(0-4)" ranges).
+// This is exposed so a scan in progress can be decoded entry by entry while it streams in
+esp_err_t
+cops_parse_operator_entry(const char* entry, cops_operator_info_t* info, const char** entry_end);
 
 // This is the struct used by the bg95 driver fxn , so it doesn't use a response or parameter struct
 // for parsing or formatting only
@@ -0,0 +1,59 @@
+// Power Saving Mode Setting - request the periodic TAU (T3412) and active time (T3324) timers
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  CPSMS_MODE_DISABLE             = 0U,
+  CPSMS_MODE_ENABLE              = 1U,
+  CPSMS_MODE_DISABLE_AND_DISCARD = 2U, // Disable PSM and reset all params to manufacturer defaults
+} cpsms_mode_t;
+#define CPSMS_MODE_MAP_SIZE 3
+extern const enum_str_map_t CPSMS_MODE_MAP[CPSMS_MODE_MAP_SIZE];
+
+// Timers are sent as one byte in binary string format, e.g. "00100100" (3GPP TS 24.008)
+#define CPSMS_TIMER_BITS_LEN 8
+#define CPSMS_TIMER_STR_SIZE (CPSMS_TIMER_BITS_LEN + 1)
+#define CPSMS_TIMER_VALUE_MAX 31 // Value field is the lower 5 bits
+
+// Returned when the timer unit bits are 'deactivated' (111)
+#define CPSMS_TIMER_DEACTIVATED UINT32_MAX
+
+typedef struct
+{
+  bool has_periodic_tau : 1;
+  bool has_active_time : 1;
+} cpsms_present_flags_t;
+
+// NOTE: The 2G/3G params (Requested_Periodic-RAU / Requested_GPRS-READY-timer) are not used by the
+// BG95 on Cat-M1/NB-IoT, so they are always left empty
+typedef struct
+{
+  cpsms_mode_t          mode;
+  char                  periodic_tau[CPSMS_TIMER_STR_SIZE]; // T3412 extended, e.g. "00100100"
+  char                  active_time[CPSMS_TIMER_STR_SIZE];  // T3324, e.g. "00001111"
+  cpsms_present_flags_t present;
+} cpsms_write_params_t;
+
+typedef struct
+{
+  cpsms_mode_t          mode;
+  char                  periodic_tau[CPSMS_TIMER_STR_SIZE];
+  char                  active_time[CPSMS_TIMER_STR_SIZE];
+  cpsms_present_flags_t present;
+} cpsms_read_response_t;
+
+// Timer encoding helpers (3GPP TS 24.008 10.5.7.4a GPRS Timer 3 / 10.5.7.3 GPRS Timer 2)
+// Encoding picks the smallest representable value that is >= the requested number of seconds, so
+// the network is never asked for less. ESP_ERR_INVALID_ARG if it is above the largest value.
+esp_err_t cpsms_encode_periodic_tau(uint32_t seconds, char* bits, size_t bits_size);
+esp_err_t cpsms_decode_periodic_tau(const char* bits, uint32_t* seconds);
+esp_err_t cpsms_encode_active_time(uint32_t seconds, char* bits, size_t bits_size);
+esp_err_t cpsms_decode_active_time(const char* bits, uint32_t* seconds);
+
+extern const at_cmd_t AT_CMD_CPSMS;
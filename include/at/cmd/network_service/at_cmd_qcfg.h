@@ -0,0 +1,168 @@
+// Extended configuration settings - only the network scan (RAT / band) related settings are
+// implemented
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Command sub-types
+typedef enum
+{
+  QCFG_TYPE_NWSCANSEQ  = 0U, // RAT scan sequence
+  QCFG_TYPE_NWSCANMODE = 1U, // RATs to be searched (GSM / LTE)
+  QCFG_TYPE_IOTOPMODE  = 2U, // LTE network category (eMTC / NB-IoT)
+  QCFG_TYPE_BAND       = 3U, // Band masks
+} qcfg_type_t;
+#define QCFG_TYPE_MAP_SIZE 4
+extern const enum_str_map_t QCFG_TYPE_MAP[QCFG_TYPE_MAP_SIZE];
+
+// When the new setting takes effect
+typedef enum
+{
+  QCFG_EFFECT_AFTER_REBOOT = 0U,
+  QCFG_EFFECT_IMMEDIATELY  = 1U,
+} qcfg_effect_t;
+
+// RAT codes used in the scan sequence
+typedef enum
+{
+  QCFG_RAT_AUTO  = 0U, // eMTC -> NB-IoT -> GSM
+  QCFG_RAT_GSM   = 1U,
+  QCFG_RAT_EMTC  = 2U,
+  QCFG_RAT_NBIOT = 3U,
+} qcfg_rat_t;
+#define QCFG_RAT_MAP_SIZE 4
+extern const enum_str_map_t QCFG_RAT_MAP[QCFG_RAT_MAP_SIZE];
+
+#define QCFG_NWSCANSEQ_MAX_RATS 3
+
+typedef enum
+{
+  QCFG_NWSCANMODE_AUTO     = 0U,
+  QCFG_NWSCANMODE_GSM_ONLY = 1U,
+  QCFG_NWSCANMODE_LTE_ONLY = 3U,
+} qcfg_nwscanmode_t;
+#define QCFG_NWSCANMODE_MAP_SIZE 3
+extern const enum_str_map_t QCFG_NWSCANMODE_MAP[QCFG_NWSCANMODE_MAP_SIZE];
+
+typedef enum
+{
+  QCFG_IOTOPMODE_EMTC       = 0U,
+  QCFG_IOTOPMODE_NBIOT      = 1U,
+  QCFG_IOTOPMODE_EMTC_NBIOT = 2U,
+} qcfg_iotopmode_t;
+#define QCFG_IOTOPMODE_MAP_SIZE 3
+extern const enum_str_map_t QCFG_IOTOPMODE_MAP[QCFG_IOTOPMODE_MAP_SIZE];
+
+// GSM band mask bits
+#define QCFG_GSM_BAND_900 0x1U
+#define QCFG_GSM_BAND_1800 0x2U
+#define QCFG_GSM_BAND_850 0x4U
+#define QCFG_GSM_BAND_1900 0x8U
+#define QCFG_GSM_BAND_ANY 0xFU
+
+// LTE band masks are up to 128 bits wide - band N is bit (N - 1)
+#define QCFG_LTE_BAND_MAX 128
+typedef struct
+{
+  uint64_t low;  // Bands 1 - 64
+  uint64_t high; // Bands 65 - 128
+} qcfg_lte_band_mask_t;
+
+// Helpers for the 128 bit LTE band masks
+void qcfg_lte_band_mask_set(qcfg_lte_band_mask_t* mask, uint8_t band);
+bool qcfg_lte_band_mask_has(const qcfg_lte_band_mask_t* mask, uint8_t band);
+bool qcfg_lte_band_mask_is_empty(const qcfg_lte_band_mask_t* mask);
+
+typedef struct
+{
+  uint32_t             gsm;
+  qcfg_lte_band_mask_t emtc;
+  qcfg_lte_band_mask_t nbiot;
+} qcfg_band_config_t;
+
+// ------- Write parameters -------
+// The value (and the effect) can be left out to query the current setting
+typedef struct
+{
+  qcfg_rat_t    rats[QCFG_NWSCANSEQ_MAX_RATS];
+  uint8_t       num_rats;
+  qcfg_effect_t effect;
+  struct
+  {
+    bool has_rats : 1;
+    bool has_effect : 1;
+  } present;
+} qcfg_write_nwscanseq_params_t;
+
+typedef struct
+{
+  qcfg_nwscanmode_t mode;
+  qcfg_effect_t     effect;
+  struct
+  {
+    bool has_mode : 1;
+    bool has_effect : 1;
+  } present;
+} qcfg_write_nwscanmode_params_t;
+
+typedef struct
+{
+  qcfg_iotopmode_t mode;
+  qcfg_effect_t    effect;
+  struct
+  {
+    bool has_mode : 1;
+    bool has_effect : 1;
+  } present;
+} qcfg_write_iotopmode_params_t;
+
+typedef struct
+{
+  qcfg_band_config_t bands;
+  qcfg_effect_t      effect;
+  struct
+  {
+    bool has_bands : 1;
+    bool has_effect : 1;
+  } present;
+} qcfg_write_band_params_t;
+
+// Generic write parameters structure for the AT command handler
+typedef struct
+{
+  qcfg_type_t type;
+  union
+  {
+    qcfg_write_nwscanseq_params_t  nwscanseq;
+    qcfg_write_nwscanmode_params_t nwscanmode;
+    qcfg_write_iotopmode_params_t  iotopmode;
+    qcfg_write_band_params_t       band;
+  } params;
+} qcfg_write_params_t;
+
+// ------- Write (query) responses -------
+typedef struct
+{
+  qcfg_rat_t rats[QCFG_NWSCANSEQ_MAX_RATS];
+  uint8_t    num_rats;
+} qcfg_nwscanseq_response_t;
+
+// Generic write response structure - 'has_data' is false if the module only answered OK
+typedef struct
+{
+  qcfg_type_t type;
+  bool        has_data;
+  union
+  {
+    qcfg_nwscanseq_response_t nwscanseq;
+    qcfg_nwscanmode_t         nwscanmode;
+    qcfg_iotopmode_t          iotopmode;
+    qcfg_band_config_t        band;
+  } response;
+} qcfg_write_response_t;
+
+extern const at_cmd_t AT_CMD_QCFG;
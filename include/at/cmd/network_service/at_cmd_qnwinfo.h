@@ -0,0 +1,39 @@
+// Query network information - access technology, operator, band and channel currently in use
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+  QNWINFO_ACT_NONE  = 0U, // "No Service"
+  QNWINFO_ACT_GSM   = 1U,
+  QNWINFO_ACT_EMTC  = 2U,
+  QNWINFO_ACT_NBIOT = 3U,
+} qnwinfo_act_t;
+#define QNWINFO_ACT_MAP_SIZE 4
+extern const enum_str_map_t QNWINFO_ACT_MAP[QNWINFO_ACT_MAP_SIZE];
+
+#define QNWINFO_OPERATOR_MAX_CHARS 8
+#define QNWINFO_BAND_MAX_CHARS 24
+
+typedef struct
+{
+  qnwinfo_act_t act;
+  char          operator_numeric[QNWINFO_OPERATOR_MAX_CHARS]; // e.g. "310410"
+  char          band_str[QNWINFO_BAND_MAX_CHARS];             // e.g. "LTE BAND 12", "GSM 850"
+  uint8_t       lte_band;                                     // e.g. 12, only for eMTC/NB-IoT
+  uint32_t      channel;
+  struct
+  {
+    bool has_operator : 1;
+    bool has_band : 1;
+    bool has_lte_band : 1;
+    bool has_channel : 1;
+  } present;
+} qnwinfo_execute_response_t;
+
+extern const at_cmd_t AT_CMD_QNWINFO;
@@ -0,0 +1,94 @@
+// Configure the parameters of an SSL context. The context is then selected by index by the
+// application protocol (e.g. QMTCFG "ssl", QHTTPCFG "sslctxid")
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define QSSLCFG_CTX_ID_MAX 5
+#define QSSLCFG_PATH_MAX_LEN 80 // e.g. "UFS:cacert.pem"
+#define QSSLCFG_NEGOTIATE_TIME_MIN_S 10
+#define QSSLCFG_NEGOTIATE_TIME_MAX_S 300
+
+typedef enum
+{
+  QSSLCFG_TYPE_SSLVERSION      = 0U,
+  QSSLCFG_TYPE_CIPHERSUITE     = 1U,
+  QSSLCFG_TYPE_CACERT          = 2U, // Trusted CA certificate file
+  QSSLCFG_TYPE_CLIENTCERT      = 3U,
+  QSSLCFG_TYPE_CLIENTKEY       = 4U,
+  QSSLCFG_TYPE_SECLEVEL        = 5U, // Authentication mode
+  QSSLCFG_TYPE_IGNORELOCALTIME = 6U, // 1: do not check the certificate validity period
+  QSSLCFG_TYPE_NEGOTIATETIME   = 7U, // Max time for the handshake
+  QSSLCFG_TYPE_SNI             = 8U, // Server Name Indication
+  QSSLCFG_TYPE_SESSION_CACHE   = 9U, // 1: resume the previous session on reconnect
+} qsslcfg_type_t;
+#define QSSLCFG_TYPE_MAP_SIZE 10
+extern const enum_str_map_t QSSLCFG_TYPE_MAP[QSSLCFG_TYPE_MAP_SIZE];
+
+typedef enum
+{
+  QSSLCFG_SSLVERSION_SSL3_0 = 0U,
+  QSSLCFG_SSLVERSION_TLS1_0 = 1U,
+  QSSLCFG_SSLVERSION_TLS1_1 = 2U,
+  QSSLCFG_SSLVERSION_TLS1_2 = 3U,
+  QSSLCFG_SSLVERSION_ALL    = 4U,
+} qsslcfg_sslversion_t;
+#define QSSLCFG_SSLVERSION_MAP_SIZE 5
+extern const enum_str_map_t QSSLCFG_SSLVERSION_MAP[QSSLCFG_SSLVERSION_MAP_SIZE];
+
+typedef enum
+{
+  QSSLCFG_SECLEVEL_NONE          = 0U, // No authentication
+  QSSLCFG_SECLEVEL_SERVER        = 1U, // Server authentication (needs 'cacert')
+  QSSLCFG_SECLEVEL_SERVER_CLIENT = 2U, // Mutual authentication (also needs 'clientcert/key')
+} qsslcfg_seclevel_t;
+#define QSSLCFG_SECLEVEL_MAP_SIZE 3
+extern const enum_str_map_t QSSLCFG_SECLEVEL_MAP[QSSLCFG_SECLEVEL_MAP_SIZE];
+
+// Cipher suites (IANA values)
+#define QSSLCFG_CIPHER_RSA_AES_128_CBC_SHA 0x002FU
+#define QSSLCFG_CIPHER_RSA_AES_256_CBC_SHA 0x0035U
+#define QSSLCFG_CIPHER_ECDHE_RSA_AES_128_CBC_SHA256 0xC027U
+#define QSSLCFG_CIPHER_ECDHE_ECDSA_AES_128_GCM_SHA256 0xC02BU
+#define QSSLCFG_CIPHER_ECDHE_ECDSA_AES_256_GCM_SHA384 0xC02CU
+#define QSSLCFG_CIPHER_ECDHE_RSA_AES_128_GCM_SHA256 0xC02FU
+#define QSSLCFG_CIPHER_ECDHE_RSA_AES_256_GCM_SHA384 0xC030U
+#define QSSLCFG_CIPHER_ALL 0xFFFFU // Module offers all of its suites
+
+// Value of a setting - the member is picked by the type
+typedef union
+{
+  qsslcfg_sslversion_t sslversion;
+  uint16_t             ciphersuite;
+  char                 path[QSSLCFG_PATH_MAX_LEN + 1]; // cacert / clientcert / clientkey
+  qsslcfg_seclevel_t   seclevel;
+  uint16_t             negotiate_time_s;
+  bool                 enable; // ignorelocaltime / sni / session_cache
+} qsslcfg_value_t;
+
+// Without a value the write queries the setting: ="<type>",<SSL_ctxID>
+typedef struct
+{
+  qsslcfg_type_t  type;
+  uint8_t         ctx_id;
+  qsslcfg_value_t value;
+  struct
+  {
+    bool has_value : 1;
+  } present;
+} qsslcfg_write_params_t;
+
+// Write (query) response - 'has_data' is false if the module only answered OK (a value was set)
+typedef struct
+{
+  qsslcfg_type_t  type;
+  uint8_t         ctx_id;
+  bool            has_data;
+  qsslcfg_value_t value;
+} qsslcfg_write_response_t;
+
+extern const at_cmd_t AT_CMD_QSSLCFG;
@@ -0,0 +1,24 @@
+// Close a TCP / UDP socket service
+#pragma once
+#include "at_cmd_structure.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define QICLOSE_CONNECT_ID_MAX 11
+#define QICLOSE_TIMEOUT_S_DEFAULT 10
+
+typedef struct
+{
+  bool has_timeout : 1;
+} qiclose_write_present_flags_t;
+
+// QICLOSE write parameters
+typedef struct
+{
+  uint8_t                       connect_id; // Socket identifier (0-11)
+  uint16_t                      timeout_s;  // Time to wait for the FIN ACK before a forced close
+  qiclose_write_present_flags_t present;
+} qiclose_write_params_t;
+
+extern const at_cmd_t AT_CMD_QICLOSE;
@@ -0,0 +1,67 @@
+// Open a TCP / UDP socket service
+#pragma once
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <stdint.h>
+
+typedef enum
+{
+  QIOPEN_SERVICE_TYPE_TCP = 0U, // TCP client
+  QIOPEN_SERVICE_TYPE_UDP = 1U, // UDP client
+} qiopen_service_type_t;
+
+#define QIOPEN_SERVICE_TYPE_MAP_SIZE 2
+extern const enum_str_map_t QIOPEN_SERVICE_TYPE_MAP[QIOPEN_SERVICE_TYPE_MAP_SIZE];
+
+typedef enum
+{
+  QIOPEN_ACCESS_MODE_BUFFER      = 0U, // Received data is buffered, read with QIRD
+  QIOPEN_ACCESS_MODE_DIRECT_PUSH = 1U, // Received data is output with the 'recv' URC
+  QIOPEN_ACCESS_MODE_TRANSPARENT = 2U, // The UART carries the raw socket stream
+} qiopen_access_mode_t;
+
+#define QIOPEN_ACCESS_MODE_MAP_SIZE 3
+extern const enum_str_map_t QIOPEN_ACCESS_MODE_MAP[QIOPEN_ACCESS_MODE_MAP_SIZE];
+
+#define QIOPEN_CONTEXT_ID_MIN 1
+#define QIOPEN_CONTEXT_ID_MAX 16
+#define QIOPEN_CONNECT_ID_MIN 0
+#define QIOPEN_CONNECT_ID_MAX 11
+#define QIOPEN_HOST_MAX_SIZE 100
+#define QIOPEN_RESULT_SUCCESS 0 // Any other result is an error code (e.g. 565 DNS parse failed)
+
+typedef struct
+{
+  bool has_local_port : 1;
+  bool has_access_mode : 1;
+} qiopen_write_present_flags_t;
+
+// QIOPEN write parameters
+typedef struct
+{
+  uint8_t                      context_id; // PDP context (1-16)
+  uint8_t                      connect_id; // Socket identifier (0-11)
+  qiopen_service_type_t        service_type;
+  char                         host[QIOPEN_HOST_MAX_SIZE + 1]; // IP address or domain name
+  uint16_t                     remote_port;
+  uint16_t                     local_port;  // 0 lets the module pick one
+  qiopen_access_mode_t         access_mode; // Local port must also be present
+  qiopen_write_present_flags_t present;
+} qiopen_write_params_t;
+
+typedef struct
+{
+  bool has_connect_id : 1;
+  bool has_result : 1;
+} qiopen_present_flags_t;
+
+// QIOPEN write response - from the '+QIOPEN: <connectID>,<err>' URC that follows OK
+typedef struct
+{
+  uint8_t                connect_id;
+  int                    result; // QIOPEN_RESULT_SUCCESS or an error code
+  qiopen_present_flags_t present;
+} qiopen_write_response_t;
+
+extern const at_cmd_t AT_CMD_QIOPEN;
@@ -0,0 +1,27 @@
+// Read received data from a socket (buffer access mode). The response carries raw, possibly binary,
+// data: +QIRD: <read_actual_length>\r\n<data>\r\n\r\nOK
+#pragma once
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QIRD_CONNECT_ID_MAX 11
+#define QIRD_READ_MAX_LEN 1500 // Max bytes per QIRD
+
+// QIRD write parameters
+typedef struct
+{
+  uint8_t  connect_id; // Socket identifier (0-11)
+  uint16_t read_length;
+} qird_write_params_t;
+
+// QIRD write response - only the header, the data itself is placed in the caller's buffer
+typedef struct
+{
+  uint16_t read_actual_length; // 0 if there is no data left in the receive buffer
+} qird_write_response_t;
+
+// Payload locator for at_cmd_handler_send_and_receive_payload
+esp_err_t qird_locate_payload(const char* response, size_t* payload_offset, size_t* payload_len);
+
+extern const at_cmd_t AT_CMD_QIRD;
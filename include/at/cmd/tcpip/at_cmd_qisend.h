@@ -0,0 +1,18 @@
+// Send data over a socket. The data is written after the '>' prompt, and the module answers with
+// SEND OK (data is in the send buffer) or SEND FAIL (send buffer is full)
+#pragma once
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+#define QISEND_CONNECT_ID_MAX 11
+#define QISEND_DATA_MAX_LEN 1460 // Max bytes per QISEND
+
+// QISEND write parameters (fixed length send for TCP / UDP client sockets)
+typedef struct
+{
+  uint8_t  connect_id; // Socket identifier (0-11)
+  uint16_t send_length;
+} qisend_write_params_t;
+
+extern const at_cmd_t AT_CMD_QISEND;
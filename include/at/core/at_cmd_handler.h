@@ -1,32 +1,138 @@
 #pragma once
 
+#include "at_cmd_metrics.h"
 #include "at_cmd_parser.h"
 #include "at_cmd_structure.h"
+#include "at_cmd_trace.h"
 #include "bg95_uart_interface.h"
 
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 
 #define AT_CRLF "\r\n"
 #define AT_OK AT_CRLF "OK" AT_CRLF
 #define AT_ERROR AT_CRLF "ERROR" AT_CRLF
 #define AT_CME_ERROR AT_CRLF "+CME ERROR:"
+#define AT_SEND_OK AT_CRLF "SEND OK" AT_CRLF
+#define AT_SEND_FAIL AT_CRLF "SEND FAIL" AT_CRLF
+#define AT_CONNECT "CONNECT" AT_CRLF
+#define AT_NO_CARRIER AT_CRLF "NO CARRIER" AT_CRLF
 
 #define AT_CMD_READ_CHUNK_SIZE 32
 #define AT_CMD_READ_CHUNK_INTERVAL_MS 100
 #define AT_CMD_MAX_RESPONSE_LEN 2048
 #define AT_CMD_MAX_CMD_LEN 256
+#define AT_CMD_ABORT_DRAIN_MS 500 // Time allowed for an aborted cmd to finish answering
+#define AT_CMD_URC_POLL_BUFFER_SIZE 256
+#define AT_CMD_STREAM_CHUNK_SIZE 128 // Max bytes held (or written) at once by the streaming paths
+#define AT_CMD_TX_DONE_TIMEOUT_MS 1000 // Max wait for queued bytes to leave the UART
+
+// Data (transparent) mode - the +++ escape needs this much silence before and after it
+#define AT_CMD_ESCAPE_GUARD_MS 1000
+#define AT_CMD_DATA_MODE_RESUME_TIMEOUT_MS 5000 // ATO / +++ answer
+// Bytes read in data mode that could be the start of NO CARRIER are held back until the next read
+#define AT_CMD_DATA_TAIL_LEN (sizeof(AT_NO_CARRIER) - 2)
+
+// What the UART currently carries: AT commands, or the raw stream of a transparent connection
+typedef enum
+{
+  AT_CMD_MODE_COMMAND = 0U,
+  AT_CMD_MODE_DATA    = 1U,
+} at_cmd_mode_t;
+
+// Waking the module from sleep - 'AT' is probed until it answers
+#define AT_CMD_WAKE_PROBE_INTERVAL_MS 20
+#define AT_CMD_WAKE_TIMEOUT_MS 1000
+
+// Drives the host side of the module wake line (e.g. DTR). awake=true means the module must stay
+// awake, awake=false allows it to sleep
+typedef esp_err_t (*at_cmd_wake_line_fn)(bool awake, void* context);
+
+typedef struct
+{
+  uint32_t wake_count;            // Number of times the module had to be woken
+  uint32_t cmd_count;             // Commands sent while sleep mode was enabled
+  uint32_t wake_latency_total_ms; // Sum of the time from asserting the wake line to 'OK'
+  uint32_t wake_latency_max_ms;
+  uint32_t awake_total_ms;   // Time the wake line was held asserted
+  uint32_t asleep_total_ms;  // Time the module was allowed to sleep
+  uint32_t kept_awake_count; // Exchanges after which the line stayed asserted for a queued one
+} at_cmd_sleep_stats_t;
+
+typedef struct
+{
+  bool                 enabled;
+  at_cmd_wake_line_fn  set_wake_line;
+  void*                wake_line_context;
+  bool                 awake;
+  uint8_t              batch_depth;    // While > 0 the module is kept awake between commands
+  uint32_t             state_since_ms; // Start of the current awake / asleep period
+  at_cmd_sleep_stats_t stats;
+} at_cmd_sleep_ctrl_t;
+
+// Called every time new bytes are appended to the response buffer ('response' is NUL terminated),
+// and on every read that times out without data - so it may see the same 'len' more than once.
+// Return false to abort the command (e.g. to cancel a long running scan)
+typedef bool (*at_cmd_rx_observer_fn)(const char* response, size_t len, void* context);
+
+// Called for each complete line starting with '+' (without the CRLF, so NOT NUL terminated at
+// 'len'). This includes the data lines of command responses - only act on known URC prefixes.
+// NOTE: Runs with the handler locked - it must not send commands itself
+typedef void (*at_cmd_urc_fn)(const char* line, size_t len, void* context);
+
+// Payload commands (e.g. QIRD) answer with a header that announces the payload length, followed by
+// the raw (possibly binary) payload and the final result. The locator finds the payload in what has
+// been received so far, and returns ESP_ERR_NOT_FOUND until the header is complete
+typedef esp_err_t (*at_cmd_payload_locator_fn)(const char* response,
+                                               size_t*     payload_offset,
+                                               size_t*     payload_len);
+
+// Streamed responses (e.g. QHTTPREAD) deliver their body in pieces as it arrives. Returning an
+// error aborts the command
+typedef esp_err_t (*at_cmd_stream_sink_fn)(const char* data, size_t len, void* context);
+
+// Supplies data written after a prompt, at most 'buffer_size' bytes per call. 'len' must be > 0
+// until all announced data has been supplied
+typedef esp_err_t (*at_cmd_stream_source_fn)(char*   buffer,
+                                             size_t  buffer_size,
+                                             size_t* len,
+                                             void*   context);
 
 // Uses a provided UART interface - then either real HW or a mock TEST UART can be used
-// -  no  mutex because this assumed to be used as a singleton
+// The lock serializes cmd exchanges, so a background task (e.g. an operator scan) can share the UART
 typedef struct
 {
-  bg95_uart_interface_t uart;
+  bg95_uart_interface_t     uart;
+  SemaphoreHandle_t         lock;
+  atomic_uint               lock_waiters;     // Exchanges queued on the lock (module kept awake)
+  uint32_t                  last_activity_ms; // Tick time (ms) of the last completed cmd exchange
+  at_cmd_sleep_ctrl_t       sleep;
+  at_cmd_rx_observer_fn     rx_observer; // Only set for the duration of an observed cmd
+  void*                     rx_observer_context;
+  at_cmd_urc_fn             urc_handler;
+  void*                     urc_context;
+  at_cmd_mode_t             mode; // Commands are refused while in data mode
+  char                      data_tail[AT_CMD_DATA_TAIL_LEN]; // Held back by the last data read
+  size_t                    data_tail_len;
+  at_cmd_trace_t*           trace;             // NULL - exchanges are not traced
+  uint32_t                  cmd_sent_ms;       // Tick time (ms) the current cmd was written
+  uint32_t                  exchange_start_ms; // Tick time (ms) the current exchange began
+  at_cmd_metrics_t*         metrics;           // NULL - no metrics are kept
+  at_cmd_metrics_exchange_t exchange;          // What the current exchange sent and got so far
 } at_cmd_handler_t;
 
 // Initialize AT command handler - it can be init either with mock or hardware(real) UART interface
 esp_err_t at_cmd_handler_init(at_cmd_handler_t* handler, bg95_uart_interface_t* uart);
 
+esp_err_t at_cmd_handler_deinit(at_cmd_handler_t* handler);
+
+// Swap the UART the handler talks over (e.g. to a CMUX virtual channel and back). Waits for the
+// exchange in progress, and is refused in data mode
+esp_err_t at_cmd_handler_bind_uart(at_cmd_handler_t* handler, const bg95_uart_interface_t* uart);
+
 // Only reason this is not static is for ease of testing
 bool has_command_terminated(const char* raw_response, const at_cmd_t* cmd, at_cmd_type_t type);
 
@@ -55,6 +161,16 @@ esp_err_t at_cmd_handler_send_and_receive_cmd(
     const void*       params, // Params for write commands
     void*             response_data);     // Response structure - specific to command and type
 
+// Same as at_cmd_handler_send_and_receive_cmd, but 'observer' sees the response while it streams in.
+// NOTE: The observer runs with the handler locked - it must not send commands itself
+esp_err_t at_cmd_handler_send_and_receive_cmd_observed(at_cmd_handler_t*     handler,
+                                                       const at_cmd_t*       cmd,
+                                                       at_cmd_type_t         type,
+                                                       const void*           params,
+                                                       void*                 response_data,
+                                                       at_cmd_rx_observer_fn observer,
+                                                       void*                 observer_context);
+
 // Add to at_cmd_handler.h
 esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
                                           const at_cmd_t*   cmd,
@@ -63,3 +179,118 @@ esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
                                           const void*       data,
                                           size_t            data_len,
                                           void*             response_data);
+
+// Same as at_cmd_handler_send_with_prompt, but the data is pulled from 'source' while it is being
+// sent, so it never has to be held in memory as a whole
+esp_err_t at_cmd_handler_send_with_prompt_stream(at_cmd_handler_t*       handler,
+                                                 const at_cmd_t*         cmd,
+                                                 at_cmd_type_t           type,
+                                                 const void*             params,
+                                                 at_cmd_stream_source_fn source,
+                                                 void*                   source_context,
+                                                 size_t                  data_len,
+                                                 void*                   response_data);
+
+// Send a payload command. The payload is read straight into the caller's buffer (it is never copied
+// through the response buffer), and only the header is passed to the command parser
+esp_err_t at_cmd_handler_send_and_receive_payload(at_cmd_handler_t*         handler,
+                                                  const at_cmd_t*           cmd,
+                                                  at_cmd_type_t             type,
+                                                  const void*               params,
+                                                  void*                     response_data,
+                                                  at_cmd_payload_locator_fn locate_payload,
+                                                  void*                     payload,
+                                                  size_t                    payload_size,
+                                                  size_t*                   payload_len);
+
+// ---------------------------- URC HANDLING ----------------------------------
+// URCs are picked out of every command response, and out of the idle UART with poll
+esp_err_t at_cmd_handler_set_urc_handler(at_cmd_handler_t* handler,
+                                         at_cmd_urc_fn     urc_handler,
+                                         void*             context);
+
+// Read whatever the module sent while no command was running (waits up to 'timeout_ms' for it)
+esp_err_t at_cmd_handler_poll_urcs(at_cmd_handler_t* handler, uint32_t timeout_ms);
+
+// ---------------------------- TRACE ----------------------------------
+// Record every exchange into 'trace' (see at_cmd_trace.h). NULL detaches the trace. The trace is
+// not owned by the handler - it must stay valid until it is detached
+esp_err_t at_cmd_handler_set_trace(at_cmd_handler_t* handler, at_cmd_trace_t* trace);
+
+// ---------------------------- METRICS ----------------------------------
+// Count every exchange in 'metrics' (see at_cmd_metrics.h). NULL detaches the metrics. They are
+// not owned by the handler - they must stay valid until they are detached
+esp_err_t at_cmd_handler_set_metrics(at_cmd_handler_t* handler, at_cmd_metrics_t* metrics);
+
+// ---------------------------- DATA MODE ----------------------------------
+// Send a command that answers CONNECT and switches the channel to data mode (e.g. QIOPEN with
+// transparent access mode). The module is kept awake while in data mode
+esp_err_t at_cmd_handler_enter_data_mode(at_cmd_handler_t* handler,
+                                         const at_cmd_t*   cmd,
+                                         at_cmd_type_t     type,
+                                         const void*       params);
+
+// Return to data mode (ATO) after it was left with at_cmd_handler_exit_data_mode
+esp_err_t at_cmd_handler_resume_data_mode(at_cmd_handler_t* handler);
+
+// Switch back to command mode with the +++ escape. The connection stays open. Takes at least
+// 2 * AT_CMD_ESCAPE_GUARD_MS
+esp_err_t at_cmd_handler_exit_data_mode(at_cmd_handler_t* handler);
+
+at_cmd_mode_t at_cmd_handler_get_mode(at_cmd_handler_t* handler);
+
+// Raw stream access - only valid in data mode
+esp_err_t at_cmd_handler_data_write(at_cmd_handler_t* handler, const void* data, size_t len);
+
+// Reads at most buffer_size - 1 bytes (the UART read NUL terminates), buffer_size must be more than
+// AT_CMD_DATA_TAIL_LEN + 1. If the peer closed the connection, only the data before NO CARRIER is
+// returned and the channel is back in command mode afterwards (see at_cmd_handler_get_mode). A
+// chunk ending in what could be the start of NO CARRIER (e.g. "\r\n") has those bytes held back
+// until the next read - they are returned by it, or once a read gets nothing new
+esp_err_t at_cmd_handler_data_read(at_cmd_handler_t* handler,
+                                   void*             buffer,
+                                   size_t            buffer_size,
+                                   size_t*           bytes_read,
+                                   uint32_t          timeout_ms);
+
+// ---------------------------- STREAMED RESPONSES ----------------------------------
+// For commands that answer with CONNECT, a body of unknown length, then the final result. The body
+// ends at 'end_marker' - NULL means OK followed by the '+<NAME>: ' result line (e.g. QHTTPREAD).
+// The body goes to the sink as it arrives - it is never held in the response buffer - and only the
+// final result is passed to the command parser
+esp_err_t at_cmd_handler_send_and_stream(at_cmd_handler_t*     handler,
+                                         const at_cmd_t*       cmd,
+                                         at_cmd_type_t         type,
+                                         const void*           params,
+                                         const char*           end_marker,
+                                         void*                 response_data,
+                                         at_cmd_stream_sink_fn sink,
+                                         void*                 sink_context);
+
+// ---------------------------- SLEEP CONTROL ----------------------------------
+// Once enabled, the handler releases the wake line after every command, and wakes the module (assert
+// the line, then probe 'AT') before the next one. Sleep must also be enabled on the module (QSCLK).
+// While other exchanges are queued on the handler lock the line is kept asserted, so commands from
+// several tasks back to back share one wake interval, like an explicit batch
+esp_err_t at_cmd_handler_sleep_enable(at_cmd_handler_t*   handler,
+                                      at_cmd_wake_line_fn set_wake_line,
+                                      void*               context);
+
+// Keep the module awake permanently (the wake line is left asserted)
+esp_err_t at_cmd_handler_sleep_disable(at_cmd_handler_t* handler);
+
+// Wake the module if it is allowed to sleep. No-op if sleep control is not enabled
+esp_err_t at_cmd_handler_wake(at_cmd_handler_t* handler);
+
+// Release the wake line, unless a batch is open
+esp_err_t at_cmd_handler_allow_sleep(at_cmd_handler_t* handler);
+
+// All commands sent between begin and end share a single wake interval. Batches can be nested
+esp_err_t at_cmd_handler_begin_batch(at_cmd_handler_t* handler);
+esp_err_t at_cmd_handler_end_batch(at_cmd_handler_t* handler);
+
+// Average measured wake latency (line asserted to the answer of the probe). 0 before the first wake
+uint32_t at_cmd_handler_avg_wake_latency_ms(const at_cmd_handler_t* handler);
+
+// Snapshot of the sleep statistics, with the current awake/asleep period included
+esp_err_t at_cmd_handler_get_sleep_stats(at_cmd_handler_t* handler, at_cmd_sleep_stats_t* stats);
@@ -0,0 +1,155 @@
+// Runtime metrics of the command exchanges: per command and type, how often it was sent and how
+// it ended (OK, ERROR, CME error, timeout), the bytes that went over the UART for it and a
+// histogram of its latency. Plus gauges of the handler, e.g. commands queued for the UART.
+// Recording is a few additions under a short lock and a snapshot is a copy, so the metrics can
+// stay on and be polled every second. at_cmd_metrics_encode packs a snapshot for a telemetry
+// uplink.
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Latency buckets by powers of two: [0, 1) ms, [1, 2) ms, [2, 4) ms ... and the last one holds
+// everything from 2^(AT_CMD_METRICS_LATENCY_BUCKETS - 2) ms (~131 s) on
+#define AT_CMD_METRICS_LATENCY_BUCKETS 19
+#define AT_CMD_METRICS_MAX_CME_CODES 8 // Distinct CME error codes counted, the rest in 'cme_other'
+#define AT_CMD_METRICS_CME_UNKNOWN -1  // '+CME ERROR: <text>' (verbose error reporting)
+
+#define AT_CMD_METRICS_ENCODING_VERSION 1
+
+typedef enum
+{
+  AT_CMD_METRICS_GAUGE_QUEUE_DEPTH         = 0U, // Exchanges waiting for the UART
+  AT_CMD_METRICS_GAUGE_PUBLISHES_IN_FLIGHT = 1U, // MQTT publishes waiting for the UART or result
+  AT_CMD_METRICS_GAUGE_MAX                 = 2U,
+} at_cmd_metrics_gauge_t;
+
+typedef struct
+{
+  int32_t current;
+  int32_t peak; // Since the last reset
+} at_cmd_metrics_gauge_value_t;
+
+typedef struct
+{
+  int16_t  code;
+  uint32_t count;
+} at_cmd_metrics_cme_count_t;
+
+// One command and type
+typedef struct
+{
+  const at_cmd_t* cmd;
+  uint8_t         type; // at_cmd_type_t
+  uint32_t        sent; // Written to the UART (the others count exchanges, sent or not)
+  uint32_t        ok;
+  uint32_t        error;     // Plain ERROR
+  uint32_t        cme_error; // +CME ERROR
+  uint32_t        timeout;
+  uint32_t        failed;        // Anything else, e.g. a response the parser rejected
+  int16_t         last_cme_code; // Valid if cme_error > 0
+  uint64_t        bytes_tx;
+  uint64_t        bytes_rx;
+  uint32_t        latency_total_ms; // From the write of the command to the end of the exchange
+  uint32_t        latency_max_ms;
+  uint32_t        latency_hist[AT_CMD_METRICS_LATENCY_BUCKETS];
+} at_cmd_metrics_entry_t;
+
+// What the handler saw of one exchange
+typedef struct
+{
+  bool      sent;
+  esp_err_t result;
+  bool      cme_error;
+  int16_t   cme_code;
+  uint32_t  latency_ms;
+  uint32_t  bytes_tx;
+  uint32_t  bytes_rx;
+} at_cmd_metrics_exchange_t;
+
+typedef struct
+{
+  uint32_t                     period_ms;   // Since init or the last reset
+  uint16_t                     num_entries; // Copied into the caller's entries
+  uint16_t                     total_entries;
+  uint32_t                     dropped; // Exchanges of command / type pairs there was no entry for
+  at_cmd_metrics_gauge_value_t gauges[AT_CMD_METRICS_GAUGE_MAX];
+  uint8_t                      num_cme_codes;
+  at_cmd_metrics_cme_count_t   cme_codes[AT_CMD_METRICS_MAX_CME_CODES];
+  uint32_t                     cme_other;
+} at_cmd_metrics_snapshot_t;
+
+typedef struct
+{
+  at_cmd_metrics_entry_t*      entries;
+  uint16_t                     max_entries;
+  uint16_t                     num_entries;
+  uint32_t                     dropped;
+  at_cmd_metrics_gauge_value_t gauges[AT_CMD_METRICS_GAUGE_MAX];
+  uint8_t                      num_cme_codes;
+  at_cmd_metrics_cme_count_t   cme_codes[AT_CMD_METRICS_MAX_CME_CODES];
+  uint32_t                     cme_other;
+  uint32_t                     period_start_ms;
+  SemaphoreHandle_t            lock;
+} at_cmd_metrics_t;
+
+// 'entries' is owned by the caller and must outlive the metrics - one entry per command / type pair
+// that is used (the driver uses a few dozen)
+esp_err_t at_cmd_metrics_init(at_cmd_metrics_t*       metrics,
+                              at_cmd_metrics_entry_t* entries,
+                              uint16_t                max_entries);
+
+esp_err_t at_cmd_metrics_deinit(at_cmd_metrics_t* metrics);
+
+// Start a new period - the counters are cleared, the gauge peaks restart from the current values
+void at_cmd_metrics_reset(at_cmd_metrics_t* metrics);
+
+// Does nothing if 'metrics' is NULL (no metrics attached) or 'cmd' is NULL
+void at_cmd_metrics_record(at_cmd_metrics_t*                metrics,
+                           const at_cmd_t*                  cmd,
+                           at_cmd_type_t                    type,
+                           const at_cmd_metrics_exchange_t* exchange);
+
+// Does nothing if 'metrics' is NULL
+void at_cmd_metrics_gauge_add(at_cmd_metrics_t*      metrics,
+                              at_cmd_metrics_gauge_t gauge,
+                              int32_t                delta);
+
+// Copy out the metrics - up to 'max_entries' entries (can be 0). With 'reset' the next period
+// starts at the same time, so periodic snapshots add up to the whole
+esp_err_t at_cmd_metrics_snapshot(at_cmd_metrics_t*          metrics,
+                                  at_cmd_metrics_snapshot_t* snapshot,
+                                  at_cmd_metrics_entry_t*    entries,
+                                  uint16_t                   max_entries,
+                                  bool                       reset);
+
+// Bucket of a latency in at_cmd_metrics_entry_t.latency_hist
+uint8_t at_cmd_metrics_latency_bucket(uint32_t latency_ms);
+
+// Pack a snapshot for the uplink. All numbers are unsigned LEB128 varints, signed ones zigzag
+// encoded first:
+//
+//   version (AT_CMD_METRICS_ENCODING_VERSION), period_ms, dropped
+//   per gauge: current, peak (signed)
+//   num_cme_codes, per code: code (signed), count - then cme_other
+//   num_entries, per entry:
+//     name length, name (cmd->name), type, sent, ok, error, cme_error, timeout, failed,
+//     last_cme_code (signed), bytes_tx, bytes_rx, latency_total_ms, latency_max_ms,
+//     bucket mask (bit n - latency_hist[n] is not 0), then the count of each bucket in the mask
+//
+// Returns ESP_ERR_INVALID_SIZE if 'buffer' is too small
+esp_err_t at_cmd_metrics_encode(const at_cmd_metrics_snapshot_t* snapshot,
+                                const at_cmd_metrics_entry_t*    entries,
+                                uint8_t*                         buffer,
+                                size_t                           buffer_size,
+                                size_t*                          len);
+
+// Log the snapshot, one line per entry
+void at_cmd_metrics_log(const at_cmd_metrics_snapshot_t* snapshot,
+                        const at_cmd_metrics_entry_t*    entries);
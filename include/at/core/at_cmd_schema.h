@@ -0,0 +1,90 @@
+// Declarative commands: the fields of a params / response struct are listed once (as an X-macro)
+// and one shared engine formats, parses and range checks them - instead of a hand written
+// formatter and parser per command.
+//
+//   // X(type, member, spec) for every field, in the order of the fields on the wire
+//   #define CGATT_FIELDS(X, type) X(type, state, AT_SCHEMA_INT(0, 1))
+//
+//   AT_SCHEMA_DEFINE(CGATT_READ_SCHEMA, cgatt_read_params_t, "+CGATT: ", CGATT_FIELDS, 1);
+//   AT_SCHEMA_PARSER(cgatt_read_parser, CGATT_READ_SCHEMA)
+//
+// Which path a command takes: a schema if every field is a plain integer / enum or quoted string,
+// the formatter writes all of them, and only trailing response fields may be left out (IFC,
+// QSCLK, CFUN, CGATT, CGPADDR, QFOPEN, QFCLOSE, QFSEEK). Everything else has a hand written
+// formatter and a parser built on at_cmd_tokenizer - optional write params (present flags),
+// multi-line or streamed responses, sub-command specific formats (QCFG), bit strings, hex masks
+// and values outside int32_t. New commands that fit a schema use one.
+#pragma once
+
+#include "at_cmd_structure.h"
+#include "enum_utils.h"
+
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AT_CMD_RESPONSE_PREFIX(name) "+" name ": "
+
+typedef enum
+{
+  AT_SCHEMA_KIND_INT    = 0U, // Integer or enum member - signed if 'min' is negative
+  AT_SCHEMA_KIND_STRING = 1U, // char array member, quoted on the wire
+} at_schema_kind_t;
+
+typedef struct
+{
+  at_schema_kind_t      kind;
+  uint16_t              offset;
+  uint16_t              size;
+  int32_t               min;    // INT: lowest value, STRING: shortest length
+  int32_t               max;    // INT: highest value
+  const enum_str_map_t* values; // INT: the allowed values (instead of min / max)
+  uint8_t               num_values;
+} at_schema_field_t;
+
+typedef struct
+{
+  const char*              prefix; // Of the response line, e.g. "+IFC: "
+  const at_schema_field_t* fields;
+  uint8_t                  num_fields;
+  uint8_t                  num_required; // Response fields after these may be left out
+  size_t                   size;         // Of the params / response struct
+} at_schema_t;
+
+// Field specs
+#define AT_SCHEMA_INT(min_, max_) .kind = AT_SCHEMA_KIND_INT, .min = (min_), .max = (max_)
+#define AT_SCHEMA_ENUM(map_, map_size_)                                                            \
+  .kind = AT_SCHEMA_KIND_INT, .values = (map_), .num_values = (map_size_)
+#define AT_SCHEMA_STRING(min_len_) .kind = AT_SCHEMA_KIND_STRING, .min = (min_len_)
+
+#define AT_SCHEMA_FIELD(type_, member_, ...)                                                       \
+  {.offset = offsetof(type_, member_), .size = sizeof(((type_*) 0)->member_), __VA_ARGS__},
+
+#define AT_SCHEMA_DEFINE(name_, type_, prefix_, fields_, num_required_)                            \
+  static const at_schema_field_t name_##_FIELDS[] = {fields_(AT_SCHEMA_FIELD, type_)};             \
+  static const at_schema_t       name_            = {                                              \
+      .prefix       = (prefix_),                                                                   \
+      .fields       = name_##_FIELDS,                                                              \
+      .num_fields   = sizeof(name_##_FIELDS) / sizeof(name_##_FIELDS[0]),                          \
+      .num_required = (num_required_),                                                             \
+      .size         = sizeof(type_)}
+
+// Define an at_param_parser_t / at_param_formatter_t for a schema
+#define AT_SCHEMA_PARSER(fn_, schema_)                                                             \
+  static esp_err_t fn_(const char* response, void* parsed_data)                                    \
+  {                                                                                                \
+    return at_schema_parse(&(schema_), response, parsed_data);                                     \
+  }
+
+#define AT_SCHEMA_FORMATTER(fn_, schema_)                                                          \
+  static esp_err_t fn_(const void* params, char* buffer, size_t buffer_size)                       \
+  {                                                                                                \
+    return at_schema_format(&(schema_), params, buffer, buffer_size);                              \
+  }
+
+// Zeroes 'parsed_data' and fills it from the first line starting with the schema prefix
+esp_err_t at_schema_parse(const at_schema_t* schema, const char* response, void* parsed_data);
+
+// Validates all fields and writes '=<field>,<field>,...'
+esp_err_t
+at_schema_format(const at_schema_t* schema, const void* params, char* buffer, size_t buffer_size);
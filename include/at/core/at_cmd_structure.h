@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sdkconfig.h"
+
 #include <esp_err.h>
 #include <stdbool.h>
 #include <stddef.h> //For size_t
@@ -22,6 +24,13 @@
 // AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY} #define AT_CMD_TYPE_DOES_NOT_EXIST {.parser = NULL, .formatter
 // = NULL, .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY}
 
+// at_cmd_t description - compiled out with CONFIG_BG95_STRIP_DESCRIPTIONS
+#ifdef CONFIG_BG95_STRIP_DESCRIPTIONS
+#define AT_CMD_DESCRIPTION(str) ""
+#else
+#define AT_CMD_DESCRIPTION(str) str
+#endif
+
 #define AT_CMD_MAX_RESPONSE_LEN 2048
 #define AT_CMD_MAX_CMD_LEN 256
 
@@ -0,0 +1,81 @@
+// Single pass tokenizer for the '+CMD: 1,"two",(3-4),(5,"six")' grammar shared by the responses.
+// Fields are views into the response - nothing is copied until a parser asks for the value, and
+// the response is never modified.
+#pragma once
+
+#include "enum_utils.h"
+
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+  AT_FIELD_EMPTY  = 0U, // Nothing between the commas (omitted optional parameter)
+  AT_FIELD_VALUE  = 1U, // Unquoted, e.g. a number or a range like 0-4
+  AT_FIELD_STRING = 2U, // Quoted - the view excludes the quotes
+  AT_FIELD_LIST   = 3U, // Parenthesized - the view excludes the parentheses
+} at_field_type_t;
+
+typedef struct
+{
+  at_field_type_t type;
+  const char*     start;
+  size_t          len;
+} at_field_t;
+
+typedef struct
+{
+  const char* pos;
+  const char* end;    // End of the current line (or span)
+  const char* prefix; // NULL for a span
+  size_t      prefix_len;
+  bool        done; // The last field has been returned
+} at_tokenizer_t;
+
+// Start right after the first occurrence of 'prefix' (e.g. "+COPS: "). The line ends at CR, LF or
+// the end of the string. Returns ESP_ERR_NOT_FOUND if there is no such line
+esp_err_t at_tokenizer_init(at_tokenizer_t* tok, const char* response, const char* prefix);
+
+// Move on to the next line with the same prefix. Returns ESP_ERR_NOT_FOUND if there is none
+esp_err_t at_tokenizer_next_line(at_tokenizer_t* tok);
+
+// Tokenize [start, start + len) as one line - e.g. the elements of an AT_FIELD_LIST field
+esp_err_t at_tokenizer_init_span(at_tokenizer_t* tok, const char* start, size_t len);
+
+// Returns ESP_ERR_NOT_FOUND once all fields of the line have been returned, and
+// ESP_ERR_INVALID_RESPONSE for an unterminated string or list, or anything between a closing quote
+// or parenthesis and the next comma. A trailing comma yields a last, empty field
+esp_err_t at_tokenizer_next(at_tokenizer_t* tok, at_field_t* field);
+
+// -------------------- FIELD VALUES ---------------------------
+// All return ESP_ERR_NOT_FOUND for an empty field (or "") and ESP_ERR_INVALID_RESPONSE if the field
+// does not hold a value of the requested type (or it does not fit)
+
+esp_err_t at_field_get_int(const at_field_t* field, int32_t* value);
+
+// Hex digits without a prefix, quoted or not (e.g. "1A2B" for a TAC)
+esp_err_t at_field_get_hex(const at_field_t* field, uint32_t* value);
+
+// Signed decimal number as fixed point with 'decimals' fraction digits ("-12.345" with 2 decimals
+// is -1234). Extra fraction digits are truncated
+esp_err_t at_field_get_fixed(const at_field_t* field, uint8_t decimals, int64_t* value);
+
+// A range like 0-4, bare or parenthesized. A single number is a range of one
+esp_err_t at_field_get_range(const at_field_t* field, int32_t* min, int32_t* max);
+
+// Whether 'value' is one of the elements of a list like (0,1), (0-31,99) or a bare range
+bool at_field_list_contains(const at_field_t* field, int32_t value);
+
+// Copy the field into a NUL terminated 'out'. On ESP_ERR_INVALID_SIZE 'out' holds the truncated
+// value
+esp_err_t at_field_copy(const at_field_t* field, char* out, size_t out_size);
+
+bool at_field_equals(const at_field_t* field, const char* str);
+
+// Look a (quoted) field up by its string in an enum map
+esp_err_t at_field_to_enum(const at_field_t*     field,
+                           const enum_str_map_t* map,
+                           size_t                map_size,
+                           int*                  value);
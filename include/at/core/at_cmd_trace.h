@@ -0,0 +1,100 @@
+// Binary trace of the command exchanges: a ring of fixed size records (what was sent, how long the
+// module took, how it ended), optionally with a copy of the bytes themselves. Recording only copies
+// - nothing is formatted until the trace is read back (at_cmd_trace_read / _format / _dump), so it
+// can stay on where logging every command and response would cost more than the exchange itself.
+#pragma once
+
+#include "at_cmd_structure.h"
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AT_CMD_TRACE_LINE_MAX_LEN 192 // at_cmd_trace_format output, including a captured excerpt
+
+typedef enum
+{
+  AT_CMD_TRACE_EVENT_SEND     = 0U, // Command written, 'len' bytes
+  AT_CMD_TRACE_EVENT_PROMPT   = 1U, // '>' (or CONNECT) awaited before the data of the command
+  AT_CMD_TRACE_EVENT_RESPONSE = 2U, // Response read (or timed out) 'latency_ms' after the send
+  AT_CMD_TRACE_EVENT_DONE     = 3U, // Exchange finished - 'latency_ms' includes waking the module
+  AT_CMD_TRACE_EVENT_URC      = 4U, // Bytes polled from the idle UART
+} at_cmd_trace_event_t;
+
+typedef struct
+{
+  uint32_t        seq;          // Running number - tells readers which records they missed
+  uint32_t        timestamp_ms; // Tick time
+  const at_cmd_t* cmd;          // NULL if the event does not belong to a command
+  uint32_t        latency_ms;
+  esp_err_t       result;
+  uint16_t        len;      // Bytes sent / received (the capture may be shorter)
+  uint8_t         event;    // at_cmd_trace_event_t
+  uint8_t         cmd_type; // at_cmd_type_t
+  uint32_t        capture_pos;
+  uint16_t        capture_len; // 0 if nothing was captured (or it has been overwritten since)
+} at_cmd_trace_record_t;
+
+typedef struct
+{
+  at_cmd_trace_record_t* records;
+  uint16_t               num_records;
+  uint32_t               next_seq;
+  uint8_t*               capture; // NULL - no capture
+  size_t                 capture_size;
+  uint32_t               capture_pos;  // Bytes captured so far
+  size_t                 capture_head; // Ring offset of the next byte
+  uint16_t               capture_max; // Per record
+  bool                   enabled;
+  SemaphoreHandle_t      lock;
+} at_cmd_trace_t;
+
+// The buffers are owned by the caller and must outlive the trace. 'capture' can be NULL, otherwise
+// up to 'capture_max' bytes of every command / response are kept in it (oldest overwritten first)
+esp_err_t at_cmd_trace_init(at_cmd_trace_t*        trace,
+                            at_cmd_trace_record_t* records,
+                            uint16_t               num_records,
+                            uint8_t*               capture,
+                            size_t                 capture_size,
+                            uint16_t               capture_max);
+
+esp_err_t at_cmd_trace_deinit(at_cmd_trace_t* trace);
+
+// Recording can be paused without detaching the trace
+void at_cmd_trace_enable(at_cmd_trace_t* trace, bool enabled);
+
+void at_cmd_trace_clear(at_cmd_trace_t* trace);
+
+// Does nothing if 'trace' is NULL (no trace attached) or disabled. 'data' can be NULL
+void at_cmd_trace_record(at_cmd_trace_t*      trace,
+                         at_cmd_trace_event_t event,
+                         const at_cmd_t*      cmd,
+                         at_cmd_type_t        type,
+                         esp_err_t            result,
+                         uint32_t             latency_ms,
+                         const void*          data,
+                         size_t               len);
+
+// Copy out the record '*seq' and move 'seq' past it, e.g. to stream the trace as it fills. If that
+// record has been overwritten already, the oldest one held is returned instead (compare record->seq
+// to see how many were missed). The capture (up to 'capture_size' bytes, 'capture' can be NULL) is
+// copied as well, record->capture_len says how much of it is valid.
+// Returns ESP_ERR_NOT_FOUND if there is no record '*seq' yet
+esp_err_t at_cmd_trace_read(at_cmd_trace_t*        trace,
+                            uint32_t*              seq,
+                            at_cmd_trace_record_t* record,
+                            void*                  capture,
+                            size_t                 capture_size);
+
+// One line of text for a record, with the captured bytes (if any) escaped and cut to fit. Returns
+// like snprintf
+int at_cmd_trace_format(const at_cmd_trace_record_t* record,
+                        const void*                  capture,
+                        char*                        buffer,
+                        size_t                       buffer_size);
+
+// Log all records held, oldest first
+esp_err_t at_cmd_trace_dump(at_cmd_trace_t* trace);
@@ -0,0 +1,116 @@
+// 3GPP TS 27.010 multiplexer (basic option, UIH frames) over the single BG95 UART.
+// Each DLCI is exposed as its own bg95_uart_interface_t, so an AT handler can be bound to any of
+// them - e.g. control commands on one channel while a transparent transfer runs on another.
+#pragma once
+
+#include "bg95_uart_interface.h"
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/stream_buffer.h>
+#include <freertos/task.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BG95_CMUX_MAX_CHANNELS 4 // DLCI 1-4 (DLCI 0 is the control channel)
+#define BG95_CMUX_MAX_FRAME_DATA 127
+#define BG95_CMUX_CHANNEL_RX_BUFFER_SIZE 2048
+
+// Ask the module to stop sending on a channel once its receive buffer has less space than this,
+// and to resume once half of the buffer is free again
+#define BG95_CMUX_RX_FLOW_STOP_SPACE 512
+
+#define BG95_CMUX_RX_TASK_STACK_SIZE 4096
+#define BG95_CMUX_RX_TASK_PRIORITY 10
+#define BG95_CMUX_RESPONSE_TIMEOUT_MS 1000 // Wait for UA / DM after SABM / DISC
+#define BG95_CMUX_TX_FLOW_TIMEOUT_MS 5000  // Max wait for the module to lift a flow stop
+
+// Suggested channel use
+#define BG95_CMUX_DLCI_AT 1   // Control plane AT commands
+#define BG95_CMUX_DLCI_DATA 2 // Bulk / transparent data
+#define BG95_CMUX_DLCI_URC 3  // Notifications
+
+typedef struct
+{
+  uint32_t frames_rx;
+  uint32_t frames_tx;
+  uint32_t fcs_errors;        // Frames dropped because of a bad checksum
+  uint32_t invalid_frames;    // Frames dropped because of a bad header / length / unknown DLCI
+  uint32_t rx_overflow_bytes; // Bytes dropped because a channel receive buffer was full
+  uint32_t flow_stops_sent;
+  uint32_t flow_stops_received;
+} bg95_cmux_stats_t;
+
+struct bg95_cmux;
+
+typedef struct
+{
+  struct bg95_cmux*    cmux;
+  uint8_t              dlci;
+  volatile bool        open;
+  volatile bool        remote_flow_stopped; // Module asked us to stop sending (MSC FC bit)
+  volatile bool        local_flow_stopped;  // We asked the module to stop sending
+  StreamBufferHandle_t rx_buffer;
+} bg95_cmux_channel_t;
+
+// Frame decoder state
+typedef enum
+{
+  BG95_CMUX_RX_WAIT_FLAG = 0U,
+  BG95_CMUX_RX_ADDRESS,
+  BG95_CMUX_RX_CONTROL,
+  BG95_CMUX_RX_LENGTH,
+  BG95_CMUX_RX_LENGTH_2,
+  BG95_CMUX_RX_DATA,
+  BG95_CMUX_RX_FCS,
+  BG95_CMUX_RX_END_FLAG,
+} bg95_cmux_rx_state_t;
+
+typedef struct
+{
+  bg95_cmux_rx_state_t state;
+  uint8_t              address;
+  uint8_t              control;
+  uint8_t              header[4]; // Address, control and length - covered by the FCS
+  uint8_t              header_len;
+  uint16_t             length;
+  uint16_t             received;
+  uint8_t              fcs;
+  uint8_t              data[BG95_CMUX_MAX_FRAME_DATA];
+} bg95_cmux_rx_frame_t;
+
+typedef struct bg95_cmux
+{
+  bg95_uart_interface_t physical;
+  uint16_t              frame_size; // N1 - max info bytes per frame
+  SemaphoreHandle_t     tx_lock;
+  TaskHandle_t          rx_task;
+  volatile bool         running;
+  volatile bool         stop_requested;
+  bg95_cmux_rx_frame_t  rx_frame;
+  volatile uint8_t      last_response_dlci; // UA / DM seen by the receive task
+  volatile uint8_t      last_response_control;
+  bg95_cmux_channel_t   control; // DLCI 0
+  bg95_cmux_channel_t   channels[BG95_CMUX_MAX_CHANNELS];
+  bg95_cmux_stats_t     stats;
+} bg95_cmux_t;
+
+// Start the multiplexer on 'physical'. The module must already be in CMUX mode (AT+CMUX with the
+// same N1 as 'frame_size'). Opens DLCI 0 and DLCI 1..num_channels
+esp_err_t bg95_cmux_start(bg95_cmux_t*                 cmux,
+                          const bg95_uart_interface_t* physical,
+                          uint16_t                     frame_size,
+                          uint8_t                      num_channels);
+
+// Close all channels, close down the multiplexer (the module returns to plain AT mode) and stop
+// the receive task
+esp_err_t bg95_cmux_stop(bg95_cmux_t* cmux);
+
+// Virtual UART of an open channel. Reads and writes follow the bg95_uart_interface_t contract
+esp_err_t bg95_cmux_get_channel(bg95_cmux_t* cmux, uint8_t dlci, bg95_uart_interface_t* channel);
+
+esp_err_t bg95_cmux_get_stats(bg95_cmux_t* cmux, bg95_cmux_stats_t* stats);
+
+// Frame checksum (27.010 CRC-8 over the address, control and length fields). Exposed for testing
+uint8_t bg95_cmux_fcs(const uint8_t* data, size_t len);
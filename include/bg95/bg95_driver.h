@@ -1,9 +1,17 @@
 #pragma once
+#include "at_cmd_cedrxs.h"
 #include "at_cmd_cgdcont.h"
 #include "at_cmd_cops.h"
 #include "at_cmd_cpin.h"
+#include "at_cmd_cpsms.h"
 #include "at_cmd_handler.h"
+#include "at_cmd_qcfg.h"
 #include "at_cmd_qcsq.h"
+#include "at_cmd_qfread.h"
+#include "at_cmd_qgpsgnmea.h"
+#include "at_cmd_qhttpcfg.h"
+#include "at_cmd_qhttpget.h"
+#include "at_cmd_qiopen.h"
 #include "at_cmd_qmtcfg.h"
 // #include "at_cmds.h"
 #include "at_cmd_qmtclose.h"
@@ -13,22 +21,257 @@
 #include "at_cmd_qmtpub.h"
 #include "at_cmd_qmtsub.h"
 #include "at_cmd_qmtuns.h"
+#include "at_cmd_qnwinfo.h"
+#include "at_cmd_qsslcfg.h"
+#include "bg95_cmux.h"
+#include "bg95_nmea.h"
 #include "bg95_uart_interface.h"
 
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdatomic.h>
+
+// Use for optional GPIOs that are not wired to the host
+#define BG95_GPIO_NOT_USED (-1)
+
+// Boot detection (see bg95_wait_for_boot)
+// NOTE: These are upper bounds - boot detection returns as soon as the module answers 'AT'
+#define BG95_BOOT_TIMEOUT_MS 15000
+#define BG95_BOOT_PROBE_INTERVAL_MIN_MS 100
+#define BG95_BOOT_PROBE_INTERVAL_MAX_MS 2000
+#define BG95_BOOT_URC_APP_READY "RDY" // Matches both the 'RDY' and 'APP RDY' boot URCs
+
+// Max number of publishes that can be held until the next PSM wake window (see bg95_psm_*), and
+// the longest message one can hold. Each queued publish is copied into its slot, and the slots are
+// part of every bg95_handle_t - set both in menuconfig to trade RAM for queue depth
+#ifdef CONFIG_BG95_PSM_PUBLISH_QUEUE_LEN
+#define BG95_PSM_PUBLISH_QUEUE_LEN CONFIG_BG95_PSM_PUBLISH_QUEUE_LEN
+#else
+#define BG95_PSM_PUBLISH_QUEUE_LEN 8
+#endif
+#ifdef CONFIG_BG95_PSM_PUBLISH_MAX_MESSAGE_LEN
+#define BG95_PSM_PUBLISH_MAX_MESSAGE_LEN CONFIG_BG95_PSM_PUBLISH_MAX_MESSAGE_LEN
+#else
+#define BG95_PSM_PUBLISH_MAX_MESSAGE_LEN 256
+#endif
+
+// Automatic flush of the publish queue (bg95_psm_start_auto_flush)
+#define BG95_PSM_FLUSH_TASK_STACK_SIZE 4096
+#define BG95_PSM_FLUSH_TASK_PRIORITY 5
+#define BG95_PSM_FLUSH_POLL_MS 100 // Longest the task sleeps before it looks at the queue again
+#define BG95_PSM_FLUSH_RETRY_MS 10000 // Wait after a failed flush (e.g. the module did not wake)
+
+// Background operator scan (AT+COPS=?)
+#define BG95_OPERATOR_SCAN_TASK_STACK_SIZE 4096
+#define BG95_OPERATOR_SCAN_TASK_PRIORITY 5
+
+// Hardware connections between the host and the BG95
+typedef struct
+{
+  uint8_t pwrkey_gpio_num;
+  int     status_gpio_num; // STATUS pin (reads HIGH once module is on), or BG95_GPIO_NOT_USED
+  int     dtr_gpio_num;    // DTR pin (LOW keeps the module awake), or BG95_GPIO_NOT_USED
+} bg95_config_t;
+
+// A publish held until the module is awake, with its own copy of the topic and message
+typedef struct
+{
+  uint8_t         client_idx;
+  uint16_t        msgid;
+  qmtpub_qos_t    qos;
+  qmtpub_retain_t retain;
+  char            topic[QMTPUB_TOPIC_MAX_SIZE];
+  uint8_t         message[BG95_PSM_PUBLISH_MAX_MESSAGE_LEN];
+  uint16_t        message_length;
+} bg95_queued_publish_t;
+
+// Power saving state - what was requested from the network, and what it actually granted.
+// NOTE: All timers are in the resolution of the 3GPP encoding, not what the user originally asked.
+// Requests (PSM TAU and active time, eDRX cycle) are rounded up to the next value the encoding
+// has, so the network is never asked for less than requested - ones above the largest value fail
+typedef struct
+{
+  bool              psm_requested;
+  uint32_t          requested_periodic_tau_s;
+  uint32_t          requested_active_time_s;
+  bool              psm_granted_known;
+  uint32_t          granted_periodic_tau_s; // CPSMS_TIMER_DEACTIVATED if not granted
+  uint32_t          granted_active_time_s;  // CPSMS_TIMER_DEACTIVATED if not granted
+  bool              edrx_requested;
+  cedrxs_act_type_t edrx_act_type;
+  uint32_t          requested_edrx_cycle_ms;
+  bool              edrx_granted_known;
+  uint32_t          granted_edrx_cycle_ms; // 0 if the network did not grant eDRX
+  uint32_t          granted_paging_window_ms;
+
+  // Guarded by the AT handler lock - filled by the application, drained by a flush
+  bg95_queued_publish_t publish_queue[BG95_PSM_PUBLISH_QUEUE_LEN];
+  uint8_t               publish_queue_count;
+  TaskHandle_t          flush_task;
+  atomic_bool           auto_flush_running;
+  atomic_bool           auto_flush_stop;
+} bg95_power_saving_t;
+
+// Called from the scan task for each operator as soon as its entry has been received
+typedef void (*bg95_operator_found_cb)(const cops_operator_info_t* op, void* context);
+// Called from the scan task when the scan ends. 'operators' is NULL unless result is ESP_OK
+typedef void (*bg95_operator_scan_done_cb)(esp_err_t                   result,
+                                           const cops_test_response_t* operators,
+                                           void*                       context);
+
+// State of the background operator scan, and the cached result of the last completed scan
+typedef struct
+{
+  TaskHandle_t               task;
+  atomic_bool                in_progress; // Claimed with a compare-exchange, so one scan at a time
+  atomic_bool                cancel_requested;
+  bg95_operator_found_cb     on_found;
+  bg95_operator_scan_done_cb on_done;
+  void*                      user_context;
+  size_t                     stream_offset; // How far into the response entries have been decoded
+  cops_test_response_t       result;        // Scan task's response - kept off its stack
+  cops_test_response_t       cache;
+  uint32_t                   cache_timestamp_ms;
+  bool                       cache_valid;
+} bg95_operator_scan_t;
+
+// Sockets are identified by their QIOPEN connectID
+#define BG95_SOCKET_MAX (QIOPEN_CONNECT_ID_MAX + 1)
+
+typedef enum
+{
+  BG95_SOCKET_EVENT_DATA   = 0U, // Data is waiting in the module receive buffer
+  BG95_SOCKET_EVENT_CLOSED = 1U, // Closed by the peer (or the PDP context was deactivated)
+} bg95_socket_event_t;
+
+// Called (with the AT handler locked) when a socket URC arrives - must not send commands itself
+typedef void (*bg95_socket_event_cb)(uint8_t connect_id, bg95_socket_event_t event, void* context);
+
+typedef struct
+{
+  bool                  open;
+  uint8_t               context_id;
+  qiopen_service_type_t service_type;
+  qiopen_access_mode_t  access_mode;
+  atomic_bool           data_pending;  // Set by the 'recv' URC, cleared once the buffer is drained
+  atomic_bool           remote_closed; // Set by the URC handler - read without the AT handler lock
+  uint32_t              bytes_sent;
+  uint32_t              bytes_received;
+} bg95_socket_t;
+
+typedef struct
+{
+  bg95_socket_t        sockets[BG95_SOCKET_MAX];
+  bg95_socket_event_cb on_event;
+  void*                event_context;
+  bool                 transparent_open; // Only one socket can use transparent access mode
+  uint8_t              transparent_connect_id;
+} bg95_sockets_t;
+
+// Persisted hint of where the module last attached - used to narrow the next network scan
+#define BG95_ATTACH_HINT_VERSION 1
+typedef struct
+{
+  uint8_t    version; // BG95_ATTACH_HINT_VERSION - hints from other versions are ignored
+  qcfg_rat_t rat;
+  uint8_t    lte_band; // 0 if unknown (or GSM)
+  char       operator_numeric[QNWINFO_OPERATOR_MAX_CHARS];
+} bg95_attach_hint_t;
+
+// The QCFG settings an attach hint narrows - read before narrowing, so exactly these are put back
+typedef struct
+{
+  qcfg_nwscanseq_response_t sequence;
+  qcfg_band_config_t        bands;
+} bg95_scan_config_t;
+
+// UART link between the host and the module - persisted by bg95_set_uart_link, so the host can
+// open the UART at the saved rate on the next boot (bg95_load_uart_link)
+#define BG95_UART_LINK_VERSION 1
+typedef struct
+{
+  uint8_t  version; // BG95_UART_LINK_VERSION - links saved by other versions are ignored
+  uint32_t baud_rate;
+  bool     hw_flow_control; // RTS / CTS
+} bg95_uart_link_t;
+
+// SSL context settings - applied with bg95_ssl_configure
+typedef struct
+{
+  qsslcfg_sslversion_t version;
+  uint16_t             cipher_suite; // QSSLCFG_CIPHER_* (QSSLCFG_CIPHER_ALL: module chooses)
+  qsslcfg_seclevel_t   seclevel;
+  const char*          cacert_path;      // Needed from QSSLCFG_SECLEVEL_SERVER on
+  const char*          client_cert_path; // Only used with QSSLCFG_SECLEVEL_SERVER_CLIENT
+  const char*          client_key_path;  // Only used with QSSLCFG_SECLEVEL_SERVER_CLIENT
+  bool                 sni;
+  bool                 session_resumption; // Abbreviated handshake when reconnecting to a server
+  bool                 ignore_local_time;  // Skip the certificate validity check (no network time)
+  uint16_t             negotiate_time_s;   // 0 for the module default
+} bg95_ssl_config_t;
+
+// HTTP(S) client settings - applied with bg95_http_configure
+typedef struct
+{
+  uint8_t                 context_id;     // PDP context used for the requests
+  uint8_t                 ssl_context_id; // Only used for https:// URLs
+  qhttpcfg_content_type_t content_type;   // Of POST bodies
+  uint16_t                rsptime_s;      // Max time to wait for the server to respond
+} bg95_http_config_t;
+
+// Response bodies are handed over in pieces as they arrive from the UART
+typedef at_cmd_stream_sink_fn bg95_http_sink_fn;
+// Request bodies are pulled in pieces while they are being sent
+typedef at_cmd_stream_source_fn bg95_http_source_fn;
+
+typedef struct
+{
+  uint16_t http_status;
+  uint32_t content_length; // Only valid if has_content_length (not given for chunked responses)
+  bool     has_content_length;
+  uint32_t body_length; // Bytes handed to the sink
+} bg95_http_response_t;
+
+// GNSS state - the parser merges the NMEA sentences, readers get the latest fix from the store
+typedef struct
+{
+  bg95_nmea_parser_t    parser;
+  bg95_gnss_fix_store_t latest_fix;
+} bg95_gnss_t;
 
 // Driver handle containing all context needed
 typedef struct
 {
-  at_cmd_handler_t at_handler;
-  bool             initialized;
-  uint8_t          pwrkey_gpio_num;
+  at_cmd_handler_t     at_handler;
+  bool                 initialized;
+  uint8_t              pwrkey_gpio_num;
+  int                  status_gpio_num;
+  int                  dtr_gpio_num;
+  bg95_power_saving_t  power_saving;
+  bg95_operator_scan_t operator_scan;
+  bg95_sockets_t       sockets;
+  bg95_cmux_t*         cmux; // NULL unless the UART is multiplexed
+  bg95_uart_link_t     uart_link;
+  bg95_http_config_t   http_config;
+  bg95_gnss_t          gnss;
 } bg95_handle_t;
 
 // Init a driver handle - scope of the handle pointer is responsibility of user
 // The driver can be init with either a mock or hardware (actual) UART interface
 esp_err_t bg95_init(bg95_handle_t* handle, bg95_uart_interface_t* uart, uint8_t pwrkey_gpio_num);
 
+// Same as bg95_init, but allows optional pins (e.g. STATUS) to be provided for faster boot detection
+esp_err_t bg95_init_with_config(bg95_handle_t*         handle,
+                                bg95_uart_interface_t* uart,
+                                const bg95_config_t*   config);
+
+// Wait for the module to finish booting (e.g. after a PWRKEY pulse).
+// Watches the UART for the 'RDY' / 'APP RDY' URCs, checks the STATUS pin if one is configured, and
+// probes with 'AT' on an exponential backoff schedule (BG95_BOOT_PROBE_INTERVAL_MIN/MAX_MS).
+// Returns ESP_OK as soon as the module responds, or ESP_ERR_TIMEOUT after timeout_ms.
+esp_err_t bg95_wait_for_boot(bg95_handle_t* handle, uint32_t timeout_ms);
+
 // free handle pointer
 esp_err_t bg95_deinit(bg95_handle_t* handle);
 
@@ -56,9 +299,124 @@ esp_err_t bg95_soft_restart(bg95_handle_t* handle);
 // HIGH LEVEL fxn called by user - this calls a sequence of AT CMDS to connect to network bearer
 esp_err_t bg95_connect_to_network(bg95_handle_t* handle);
 
+// -------------------- POWER SAVING (PSM / eDRX) ---------------------------
+// Request PSM with the given periodic TAU (T3412) and active time (T3324). The values are rounded up
+// to the nearest value the 3GPP timer encoding can represent, and that value is what is tracked.
+esp_err_t
+bg95_psm_request(bg95_handle_t* handle, uint32_t periodic_tau_s, uint32_t active_time_s);
+
+esp_err_t bg95_psm_disable(bg95_handle_t* handle);
+
+// Read the PSM timers granted by the network (AT+CEREG?). If the CEREG URC mode (n) is below 4, n=4
+// is set for the read and the previous n restored afterwards.
+// Returns ESP_ERR_NOT_FOUND if the network has not provided the timers (e.g. not registered yet)
+esp_err_t bg95_psm_query_granted(bg95_handle_t* handle,
+                                 uint32_t*      periodic_tau_s,
+                                 uint32_t*      active_time_s);
+
+// Query the granted timers and compare them with the last request.
+// ESP_OK if PSM was granted (matches_request tells if the network changed the timers),
+// ESP_ERR_NOT_FOUND if the network did not grant PSM, ESP_ERR_INVALID_STATE if nothing requested
+esp_err_t bg95_psm_verify(bg95_handle_t* handle, bool* matches_request);
+
+// Request an eDRX cycle for the given access technology. The shortest supported cycle that is not
+// shorter than cycle_ms is used (ESP_ERR_INVALID_ARG if there is none)
+esp_err_t
+bg95_edrx_request(bg95_handle_t* handle, cedrxs_act_type_t act_type, uint32_t cycle_ms);
+
+esp_err_t bg95_edrx_disable(bg95_handle_t* handle, cedrxs_act_type_t act_type);
+
+// Read the eDRX cycle and paging time window granted by the network (AT+CEDRXRDP).
+// Returns ESP_ERR_NOT_FOUND if the network is not using eDRX
+esp_err_t
+bg95_edrx_query_granted(bg95_handle_t* handle, uint32_t* cycle_ms, uint32_t* paging_window_ms);
+
+// Same semantics as bg95_psm_verify, for the eDRX cycle
+esp_err_t bg95_edrx_verify(bg95_handle_t* handle, bool* matches_request);
+
+// Estimated time until the module enters PSM (granted active time after the last AT exchange).
+// 0 means the wake window has closed. Requires the granted timers (bg95_psm_query_granted)
+esp_err_t bg95_psm_ms_until_sleep(bg95_handle_t* handle, uint32_t* ms);
+
+// Estimated time until the module wakes for its next periodic TAU
+esp_err_t bg95_psm_ms_until_next_wake(bg95_handle_t* handle, uint32_t* ms);
+
+// Queue a publish to be sent in the next wake window. Topic and message are copied, so the caller's
+// buffers can be reused as soon as this returns. Returns ESP_ERR_NO_MEM if the queue is full, and
+// ESP_ERR_INVALID_SIZE if the topic or message do not fit a slot (QMTPUB_TOPIC_MAX_SIZE,
+// BG95_PSM_PUBLISH_MAX_MESSAGE_LEN).
+// NOTE: The queue is drained by bg95_psm_flush_publish_queue - either called by the application
+// once the module is awake, or by the task of bg95_psm_start_auto_flush
+esp_err_t bg95_psm_queue_publish(bg95_handle_t*  handle,
+                                 uint8_t         client_idx,
+                                 uint16_t        msgid,
+                                 qmtpub_qos_t    qos,
+                                 qmtpub_retain_t retain,
+                                 const char*     topic,
+                                 const void*     message,
+                                 uint16_t        message_length);
+
+// Send all queued publishes back to back while the module is awake. On failure the failed publish
+// and everything after it stay queued. 'published' (optional) is set to the number sent
+esp_err_t bg95_psm_flush_publish_queue(bg95_handle_t* handle, uint8_t* published);
+
+// Start a task that flushes the publish queue at the next wake boundary: right away while the
+// module is awake (bg95_psm_ms_until_sleep not 0, or the granted timers are not known), otherwise
+// when the module wakes for its periodic TAU (bg95_psm_ms_until_next_wake is 0). A failed flush is
+// retried after BG95_PSM_FLUSH_RETRY_MS. Stopped by bg95_psm_stop_auto_flush or bg95_deinit
+esp_err_t bg95_psm_start_auto_flush(bg95_handle_t* handle);
+
+// Returns once the task has stopped. ESP_ERR_INVALID_STATE if it is not running
+esp_err_t bg95_psm_stop_auto_flush(bg95_handle_t* handle);
+
+// -------------------- UART SLEEP (QSCLK / DTR) ---------------------------
+// Let the module sleep between commands (AT+QSCLK=1). DTR is released after each command and
+// asserted again (then probed with 'AT') before the next one. Requires a DTR pin in bg95_config_t
+esp_err_t bg95_sleep_enable(bg95_handle_t* handle);
+
+esp_err_t bg95_sleep_disable(bg95_handle_t* handle);
+
+// Keep the module awake for all commands sent until the matching end call, so they share one wake
+esp_err_t bg95_sleep_begin_batch(bg95_handle_t* handle);
+esp_err_t bg95_sleep_end_batch(bg95_handle_t* handle);
+
+// Wake counts, measured wake latency and the time spent awake vs asleep
+esp_err_t bg95_get_sleep_stats(bg95_handle_t* handle, at_cmd_sleep_stats_t* stats);
+
+// -------------------- METRICS ---------------------------
+// Keep per command counters and latency histograms, the UART queue depth and the publishes in
+// flight (see at_cmd_metrics.h). 'metrics' is set up with at_cmd_metrics_init and must outlive the
+// handle, or be detached first with NULL
+esp_err_t bg95_enable_stats(bg95_handle_t* handle, at_cmd_metrics_t* metrics);
+
+// Snapshot of the metrics, with up to 'max_entries' commands copied into 'entries'. 'reset' starts
+// a new period, e.g. for a telemetry report of the last interval (see at_cmd_metrics_encode).
+// Returns ESP_ERR_INVALID_STATE if no metrics are kept
+esp_err_t bg95_get_stats(bg95_handle_t*             handle,
+                         at_cmd_metrics_snapshot_t* snapshot,
+                         at_cmd_metrics_entry_t*    entries,
+                         uint16_t                   max_entries,
+                         bool                       reset);
+
 //    =========  COMMAND SPECIFIC USER EXPOSED FXNS (API)  ==========   //
 // =======================================================================
 
+// -------------------- UART LINK (IPR / IFC) ---------------------------
+// Switch the module and the host UART to 'baud_rate' (one of IPR_RATES) and turn RTS / CTS flow
+// control on or off. The link is checked with an 'AT' round trip after each step, and falls back to
+// the previous settings if the module stops answering. Once working, the settings are saved on both
+// sides (module user profile and bg95_persist), so they survive a reboot of either. Nothing is
+// saved before the link is verified - if even the fallback fails, restarting the module brings it
+// back to the last saved settings.
+// NOTE: Needs the physical UART (bg95_uart_interface_init_hw) - not while CMUX is enabled.
+// Flow control also needs the RTS / CTS pins in bg95_uart_config_t
+esp_err_t bg95_set_uart_link(bg95_handle_t* handle, uint32_t baud_rate, bool hw_flow_control);
+
+// Returns ESP_ERR_NOT_FOUND if no (valid) link was saved - the module is then at BG95_BAUD_RATE
+// NOTE: Use the baud rate for bg95_uart_config_t, and pass the same link to bg95_set_uart_link
+// once the driver is up to also restore the flow control on the host side
+esp_err_t bg95_load_uart_link(bg95_uart_link_t* link);
+
 // -------------------- SIM RELATED CMDS ---------------------------
 // CPIN - Enter PIN
 esp_err_t bg95_get_sim_card_status(bg95_handle_t* handle, cpin_status_t* cpin_status);
@@ -67,14 +425,81 @@ esp_err_t bg95_get_sim_card_status(bg95_handle_t* handle, cpin_status_t* cpin_st
 // -------------------- NETWORK SERVICE CMDS ---------------------------
 // // COPS - Operator Selector
 esp_err_t bg95_get_current_operator(bg95_handle_t* handle, cops_operator_data_t* operator_data);
-// esp_err_t bg95_get_available_operators(bg95_handle_t* handle, cops_test_response_t*
-// operators);
+
+// Blocking operator scan - can take up to 3 minutes. The result also refreshes the scan cache
+esp_err_t bg95_get_available_operators(bg95_handle_t* handle, cops_test_response_t* operators);
+
+// Start an operator scan in a background task. Other cmds block until the scan ends or is cancelled
+esp_err_t bg95_start_operator_scan(bg95_handle_t*             handle,
+                                   bg95_operator_found_cb     on_found,
+                                   bg95_operator_scan_done_cb on_done,
+                                   void*                      context);
+
+// Request the running scan to stop - on_done is called with ESP_ERR_INVALID_STATE once it has
+esp_err_t bg95_cancel_operator_scan(bg95_handle_t* handle);
+
+bool bg95_operator_scan_in_progress(bg95_handle_t* handle);
+
+// Result of the last completed scan, and its age. ESP_ERR_NOT_FOUND if no scan has completed yet
+esp_err_t
+bg95_get_cached_operators(bg95_handle_t* handle, cops_test_response_t* operators, uint32_t* age_ms);
 // // esp_err_t bg95_get_current_operator(bg95_handle_t* handle, cops_read_response_t*
 // operator_info);
 // // esp_err_t bg95_select_operator_manual(bg95_handle_t* handle, const cops_write_params_t*
 // params);
 // // esp_err_t bg95_select_operator_auto(bg95_handle_t* handle);
 //
+// QCFG - RAT scan order and bands. Narrowing these avoids scanning every RAT on every band at attach
+esp_err_t bg95_set_scan_sequence(bg95_handle_t*    handle,
+                                 const qcfg_rat_t* rats,
+                                 uint8_t           num_rats,
+                                 qcfg_effect_t     effect);
+esp_err_t bg95_get_scan_sequence(bg95_handle_t* handle, qcfg_nwscanseq_response_t* sequence);
+
+esp_err_t bg95_set_scan_mode(bg95_handle_t* handle, qcfg_nwscanmode_t mode, qcfg_effect_t effect);
+esp_err_t bg95_get_scan_mode(bg95_handle_t* handle, qcfg_nwscanmode_t* mode);
+
+esp_err_t bg95_set_iot_op_mode(bg95_handle_t* handle, qcfg_iotopmode_t mode, qcfg_effect_t effect);
+esp_err_t bg95_get_iot_op_mode(bg95_handle_t* handle, qcfg_iotopmode_t* mode);
+
+esp_err_t
+bg95_set_bands(bg95_handle_t* handle, const qcfg_band_config_t* bands, qcfg_effect_t effect);
+esp_err_t bg95_get_bands(bg95_handle_t* handle, qcfg_band_config_t* bands);
+
+// Automatic scan sequence and the factory default band masks of the BG95-M2
+esp_err_t bg95_restore_default_scan_config(bg95_handle_t* handle);
+
+// Scan sequence and band masks together (bg95_set_scan_config applies them immediately)
+esp_err_t bg95_get_scan_config(bg95_handle_t* handle, bg95_scan_config_t* config);
+esp_err_t bg95_set_scan_config(bg95_handle_t* handle, const bg95_scan_config_t* config);
+
+// QNWINFO - RAT, operator and band currently in use
+esp_err_t bg95_get_network_info(bg95_handle_t* handle, qnwinfo_execute_response_t* info);
+
+// Save the RAT/band the module is attached to (call once attached). Persisted in NVS
+esp_err_t bg95_save_attach_hint(bg95_handle_t* handle);
+
+// ESP_ERR_NOT_FOUND if no (valid) hint has been saved
+esp_err_t bg95_load_attach_hint(bg95_attach_hint_t* hint);
+
+// Scan the hinted RAT first, and only the hinted band for that RAT - the other RATs keep their
+// current bands. The config in place before is returned in 'previous' (NULL - not needed).
+// NOTE: The module saves the narrowed config - it stays until bg95_set_scan_config('previous')
+esp_err_t bg95_apply_attach_hint(bg95_handle_t* handle, bg95_scan_config_t* previous);
+
+// Apply the attach hint and wait up to 'timeout_ms' for registration (AT+CEREG?). If the module
+// does not register in time (or is denied), the scan config read before narrowing is written back
+// as it was, and the attach goes on with that (full) scan.
+// On ESP_OK the narrowed config is deliberately kept: it is what makes the next attach fast, and
+// the module is registered within it. The config it replaced is returned in 'previous' (NULL - not
+// needed) - pass it to bg95_set_scan_config to widen the scan again, e.g. once the device moved.
+// Returns ESP_OK if registered with the hint, ESP_ERR_NOT_FOUND if there is no hint (nothing is
+// changed), ESP_ERR_TIMEOUT / ESP_FAIL if the previous config was restored
+esp_err_t
+bg95_attach_with_hint(bg95_handle_t* handle, uint32_t timeout_ms, bg95_scan_config_t* previous);
+
+esp_err_t bg95_clear_attach_hint(void);
+
 // CSQ - Signal Quality Report
 esp_err_t bg95_get_signal_quality_dbm(bg95_handle_t* handle, int16_t* rssi_dbm);
 // esp_err_t bg95_get_signal_quality(bg95_handle_t* handle, csq_response_t* signal_quality);
@@ -227,3 +652,202 @@ esp_err_t bg95_mqtt_unsubscribe(bg95_handle_t*           handle,
 // Function to add to bg95_driver.h
 esp_err_t bg95_get_extended_signal_quality(bg95_handle_t*           handle,
                                            qcsq_execute_response_t* signal_quality);
+
+// -------------------- TCP/IP SOCKETS ---------------------------
+// Sockets use buffer access mode: the module holds received data until it is read with QIRD. A
+// 'recv' URC marks the socket as having data pending - URCs are picked up from every command
+// response, or with bg95_socket_poll while the driver is idle
+esp_err_t bg95_socket_set_event_callback(bg95_handle_t*       handle,
+                                         bg95_socket_event_cb on_event,
+                                         void*                context);
+
+// Blocks until the module reports the result of the connection (up to 150s)
+esp_err_t bg95_socket_open(bg95_handle_t*           handle,
+                           uint8_t                  context_id,
+                           uint8_t                  connect_id,
+                           qiopen_service_type_t    service_type,
+                           const char*              host,
+                           uint16_t                 remote_port,
+                           qiopen_write_response_t* response);
+
+esp_err_t bg95_socket_close(bg95_handle_t* handle, uint8_t connect_id);
+
+// Data longer than QISEND_DATA_MAX_LEN is sent with multiple QISENDs.
+// NOTE: For UDP each QISEND is one datagram, so keep datagrams within QISEND_DATA_MAX_LEN
+esp_err_t bg95_socket_send(bg95_handle_t* handle, uint8_t connect_id, const void* data, size_t len);
+
+// Read up to 'buffer_size' bytes (at most QIRD_READ_MAX_LEN per call) straight into 'buffer'.
+// 'received' is 0 once the receive buffer of the module is empty
+esp_err_t bg95_socket_recv(bg95_handle_t* handle,
+                           uint8_t        connect_id,
+                           void*          buffer,
+                           size_t         buffer_size,
+                           size_t*        received);
+
+bool bg95_socket_data_pending(bg95_handle_t* handle, uint8_t connect_id);
+
+// Pick up socket URCs that arrived while no command was running
+esp_err_t bg95_socket_poll(bg95_handle_t* handle, uint32_t timeout_ms);
+
+// Transparent access mode: the UART carries the raw socket stream (no AT framing, no per-send size
+// limit). While in data mode no commands can be sent - leave it with bg95_transparent_exit, and
+// return with bg95_transparent_resume. Close the socket with bg95_socket_close from command mode
+esp_err_t bg95_socket_open_transparent(bg95_handle_t*        handle,
+                                       uint8_t               context_id,
+                                       uint8_t               connect_id,
+                                       qiopen_service_type_t service_type,
+                                       const char*           host,
+                                       uint16_t              remote_port);
+
+esp_err_t bg95_transparent_write(bg95_handle_t* handle, const void* data, size_t len);
+
+// Reads at most buffer_size - 1 bytes. Once the peer closes the connection the driver is back in
+// command mode, and the socket is marked as closed
+esp_err_t bg95_transparent_read(bg95_handle_t* handle,
+                                void*          buffer,
+                                size_t         buffer_size,
+                                size_t*        bytes_read,
+                                uint32_t       timeout_ms);
+
+esp_err_t bg95_transparent_exit(bg95_handle_t* handle);
+esp_err_t bg95_transparent_resume(bg95_handle_t* handle);
+
+// -------------------- CMUX (3GPP TS 27.010) ---------------------------
+// Split the UART into virtual channels (see bg95_cmux.h). The AT handler is moved to
+// BG95_CMUX_DLCI_AT - the other channels can be taken with bg95_cmux_get_channel(handle->cmux, ..)
+// e.g. for a transparent socket or for URCs. The cmux context must outlive the multiplexer
+esp_err_t bg95_cmux_enable(bg95_handle_t* handle, bg95_cmux_t* cmux, uint8_t num_channels);
+
+// Move the AT handler to another open virtual channel
+esp_err_t bg95_cmux_bind_at_channel(bg95_handle_t* handle, uint8_t dlci);
+
+// Close all channels and return the AT handler to the physical UART
+esp_err_t bg95_cmux_disable(bg95_handle_t* handle);
+
+// -------------------- SSL CONTEXTS ---------------------------
+// Configure SSL context 'ctx_id' (0 - QSSLCFG_CTX_ID_MAX), which can then be used by MQTT
+// (bg95_mqtt_config_set_ssl) or HTTP(S) (bg95_http_config_t). Certificates must already be
+// stored in the module file system (e.g. bg95_file_upload).
+// NOTE: Pinning the version and a single cipher suite, and enabling session resumption, keeps
+// reconnect handshakes short - a resumed session skips the certificate exchange
+esp_err_t
+bg95_ssl_configure(bg95_handle_t* handle, uint8_t ctx_id, const bg95_ssl_config_t* config);
+
+// Read one setting of SSL context 'ctx_id' - 'type' picks the member of 'value' that is set
+esp_err_t bg95_ssl_get(bg95_handle_t*   handle,
+                       uint8_t          ctx_id,
+                       qsslcfg_type_t   type,
+                       qsslcfg_value_t* value);
+
+// -------------------- HTTP(S) CLIENT ---------------------------
+// Requests use the PDP context given in the config, which must be active (bg95_activate_pdp_context)
+esp_err_t bg95_http_configure(bg95_handle_t* handle, const bg95_http_config_t* config);
+
+// GET 'url' and stream the body to 'sink' (NULL to skip the body). 'response' can be NULL.
+// NOTE: A status other than 2xx is not an error - the body (e.g. an error page) is still streamed
+esp_err_t bg95_http_get(bg95_handle_t*        handle,
+                        const char*           url,
+                        bg95_http_sink_fn     sink,
+                        void*                 sink_context,
+                        bg95_http_response_t* response);
+
+// GET only 'len' bytes starting at 'offset'. To resume an interrupted download, pass the number of
+// bytes already stored as 'offset'
+esp_err_t bg95_http_get_range(bg95_handle_t*        handle,
+                              const char*           url,
+                              uint32_t              offset,
+                              uint32_t              len,
+                              bg95_http_sink_fn     sink,
+                              void*                 sink_context,
+                              bg95_http_response_t* response);
+
+// POST 'body' (sent with the content type of the config), then stream the response body to 'sink'
+esp_err_t bg95_http_post(bg95_handle_t*        handle,
+                         const char*           url,
+                         const void*           body,
+                         size_t                body_len,
+                         bg95_http_sink_fn     sink,
+                         void*                 sink_context,
+                         bg95_http_response_t* response);
+
+// Same as bg95_http_post, but the body is pulled from 'source' while it is sent. 'body_len' must be
+// known up front
+esp_err_t bg95_http_post_stream(bg95_handle_t*        handle,
+                                const char*           url,
+                                bg95_http_source_fn   source,
+                                void*                 source_context,
+                                size_t                body_len,
+                                bg95_http_sink_fn     sink,
+                                void*                 sink_context,
+                                bg95_http_response_t* response);
+
+// -------------------- FILE SYSTEM (UFS) TRANSFERS ---------------------------
+// Data is moved in windows of BG95_FILE_WINDOW_SIZE (one QFREAD / QFWRITE each), straight between
+// the caller's callbacks and the UART. File names can carry the "UFS:" prefix
+#define BG95_FILE_WINDOW_SIZE QFREAD_READ_MAX_LEN
+
+// Progress of a transfer. Zero it before the first attempt, and pass the same struct again to
+// resume after an interruption - 'offset' only advances once the data has been confirmed
+typedef struct
+{
+  uint32_t offset;     // Bytes transferred so far
+  uint16_t checksum;   // Checksum of the bytes before 'offset'
+  uint32_t elapsed_ms; // Time spent moving data over all attempts (throughput = offset / elapsed)
+} bg95_file_transfer_t;
+
+typedef at_cmd_stream_source_fn bg95_file_source_fn;
+typedef at_cmd_stream_sink_fn   bg95_file_sink_fn;
+
+// The checksum reported by the module: XOR of the data taken as 16 bit big endian words. 'offset'
+// is the position of 'data' in the file, so checksums of consecutive pieces can be chained
+uint16_t
+bg95_file_checksum_update(uint16_t checksum, uint32_t offset, const void* data, size_t len);
+
+// Upload 'size' bytes pulled from 'source'. A resumed upload continues at transfer->offset - the
+// source must then supply the data from that offset on. Once complete, the stored file is verified
+// against the checksum reported by the module (bg95_file_verify)
+esp_err_t bg95_file_upload(bg95_handle_t*        handle,
+                           const char*           filename,
+                           bg95_file_source_fn   source,
+                           void*                 source_context,
+                           uint32_t              size,
+                           bg95_file_transfer_t* transfer);
+
+// Download a file to 'sink'. A first attempt streams the whole file (QFDWL) and checks the checksum
+// reported with it. A resumed download reads on from transfer->offset, then verifies the whole file
+esp_err_t bg95_file_download(bg95_handle_t*        handle,
+                             const char*           filename,
+                             bg95_file_sink_fn     sink,
+                             void*                 sink_context,
+                             bg95_file_transfer_t* transfer);
+
+// Compare the size and checksum the module reports for the stored file with 'transfer'.
+// NOTE: The module only reports the checksum while outputting the file, so the whole file is read
+// (and discarded). Returns ESP_ERR_INVALID_CRC on a mismatch
+esp_err_t
+bg95_file_verify(bg95_handle_t* handle, const char* filename, const bg95_file_transfer_t* transfer);
+
+// -------------------- GNSS ---------------------------
+// Every fix that reaches the driver (bg95_gnss_get_location, bg95_gnss_poll_nmea and
+// bg95_gnss_feed_nmea) updates the latest fix, which bg95_gnss_get_latest_fix returns without
+// touching the modem or taking any lock.
+// NOTE: Updates must come from one task at a time (reads can come from any task)
+
+// Turn on GNSS (if it is not already on) and enable reading NMEA sentences with QGPSGNMEA
+esp_err_t bg95_gnss_start(bg95_handle_t* handle);
+
+esp_err_t bg95_gnss_stop(bg95_handle_t* handle);
+
+// Ask the module for the current position (QGPSLOC). Returns ESP_FAIL until the first fix is made.
+// 'fix' can be NULL
+esp_err_t bg95_gnss_get_location(bg95_handle_t* handle, bg95_gnss_fix_t* fix);
+
+// Read the latest sentences of one type (QGPSGNMEA) and run them through the NMEA parser
+esp_err_t bg95_gnss_poll_nmea(bg95_handle_t* handle, qgpsgnmea_sentence_t sentence);
+
+// Run NMEA data read by the application (e.g. from the NMEA port, see QGPSCFG "outport") through
+// the parser. Does not use the AT interface
+esp_err_t bg95_gnss_feed_nmea(bg95_handle_t* handle, const char* data, size_t len);
+
+// Latest fix from any of the above. Never blocks - returns ESP_ERR_NOT_FOUND if there is none yet
+esp_err_t bg95_gnss_get_latest_fix(bg95_handle_t* handle, bg95_gnss_fix_t* fix);
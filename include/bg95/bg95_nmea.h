@@ -0,0 +1,88 @@
+// Incremental NMEA 0183 parser and a lock-free snapshot of the latest GNSS fix.
+// The parser takes the stream in pieces of any size (e.g. straight from the NMEA port, or the
+// output of QGPSGNMEA) and works in place on a single sentence buffer - it never allocates.
+// Supported sentences (any talker): GGA, GNS, RMC, GSA and VTG - everything else is skipped.
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BG95_NMEA_MAX_SENTENCE_LEN 82 // '$' up to and including CRLF (NMEA 0183)
+#define BG95_NMEA_MAX_FIELDS 24
+
+typedef enum
+{
+  BG95_GNSS_FIX_NONE = 0U,
+  BG95_GNSS_FIX_2D   = 2U,
+  BG95_GNSS_FIX_3D   = 3U,
+} bg95_gnss_fix_type_t;
+
+// Fixed point, so no precision is lost on the way from the sentence
+typedef struct
+{
+  bool                 valid; // Position is from a fix (not just the last known one)
+  bg95_gnss_fix_type_t fix_type;
+  uint8_t              hour; // UTC
+  uint8_t              minute;
+  uint8_t              second;
+  uint16_t             millisecond;
+  uint8_t              day; // 0 until the date is known (RMC)
+  uint8_t              month;
+  uint16_t             year;
+  int32_t              latitude_e7;  // Degrees * 10^7, negative is south
+  int32_t              longitude_e7; // Degrees * 10^7, negative is west
+  int32_t              altitude_cm;  // Above mean sea level
+  uint16_t             hdop_x100;
+  uint16_t             course_x100; // Course over ground, degrees from true north * 100
+  uint32_t             speed_kmh_x100;
+  uint8_t              satellites; // Used for the fix
+  uint32_t             updated_ms; // Host time of the last update
+} bg95_gnss_fix_t;
+
+// Latest fix, written by one task and read by any number of others without locking.
+// Two copies are kept and 'sequence' selects the stable one, so a reader never waits for a writer
+// (even one that was preempted half way through an update) - it only retries if the copy it was
+// reading got overwritten meanwhile.
+typedef struct
+{
+  atomic_uint     sequence; // 0 until the first fix is published
+  bg95_gnss_fix_t copies[2];
+} bg95_gnss_fix_store_t;
+
+void bg95_gnss_fix_store_init(bg95_gnss_fix_store_t* store);
+
+// NOTE: Only one task may publish at a time
+void bg95_gnss_fix_store_publish(bg95_gnss_fix_store_t* store, const bg95_gnss_fix_t* fix);
+
+// Returns false if nothing has been published yet
+bool bg95_gnss_fix_store_read(const bg95_gnss_fix_store_t* store, bg95_gnss_fix_t* fix);
+
+typedef struct
+{
+  uint32_t sentences;       // Parsed (supported) sentences
+  uint32_t skipped;         // Valid sentences of types that are not supported
+  uint32_t checksum_errors; // Sentences dropped because of a missing / bad checksum
+  uint32_t overflows;       // Sentences dropped because they did not fit the buffer
+} bg95_nmea_stats_t;
+
+typedef struct
+{
+  char              sentence[BG95_NMEA_MAX_SENTENCE_LEN + 1];
+  size_t            len;
+  bool              in_sentence;
+  bool              overflowed; // Current sentence is dropped, wait for the next '$'
+  bg95_gnss_fix_t   fix;        // Merged from all sentences seen so far
+  bg95_nmea_stats_t stats;
+} bg95_nmea_parser_t;
+
+void bg95_nmea_parser_init(bg95_nmea_parser_t* parser);
+
+// Feed the next piece of the stream. Anything outside of a sentence (e.g. '+QGPSGNMEA: ') is
+// ignored. Each GGA / GNS / RMC sentence completes an update, which is published to 'store' (can be
+// NULL). Returns the number of updates
+size_t bg95_nmea_parser_feed(bg95_nmea_parser_t*    parser,
+                             const char*            data,
+                             size_t                 len,
+                             bg95_gnss_fix_store_t* store);
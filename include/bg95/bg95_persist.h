@@ -0,0 +1,20 @@
+// Small key/value store for driver state that should survive a host reboot (e.g. the last attached
+// RAT/band). Backed by NVS - the application must call nvs_flash_init() before using the driver.
+#pragma once
+
+#include <esp_err.h>
+#include <stddef.h>
+
+#define BG95_PERSIST_NAMESPACE "bg95"
+
+// Keys used by the driver (NVS keys are limited to 15 chars)
+#define BG95_PERSIST_KEY_ATTACH_HINT "attach_hint"
+#define BG95_PERSIST_KEY_UART_LINK "uart_link"
+
+esp_err_t bg95_persist_save(const char* key, const void* data, size_t len);
+
+// Returns ESP_ERR_NOT_FOUND if nothing was saved, and ESP_ERR_INVALID_SIZE if the stored blob does
+// not have the expected length (e.g. saved by an older driver version)
+esp_err_t bg95_persist_load(const char* key, void* data, size_t len);
+
+esp_err_t bg95_persist_erase(const char* key);
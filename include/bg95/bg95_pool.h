@@ -0,0 +1,106 @@
+// Shared worker pool for several BG95 modules (e.g. one per UART, for carrier diversity).
+// Every module keeps its own bg95_handle_t - the pool only decides which worker runs what: jobs for
+// one module run one at a time and in submission order, jobs for different modules run in parallel.
+// Modules without queued jobs are polled for URCs, so no task has to block on a module of its own.
+#pragma once
+
+#include "bg95_driver.h"
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BG95_POOL_MAX_MODEMS 4
+#define BG95_POOL_MAX_WORKERS 4
+#define BG95_POOL_QUEUE_LEN 8 // Pending jobs per modem
+
+#define BG95_POOL_WORKER_STACK_SIZE 4096
+#define BG95_POOL_WORKER_PRIORITY 5
+#define BG95_POOL_POLL_INTERVAL_MS 100 // URC poll of modems without queued jobs
+
+// Runs on a worker, with the modem to itself
+typedef esp_err_t (*bg95_pool_job_fn)(bg95_handle_t* handle, void* context);
+
+// Called on the worker once a job is done (or, for publishes, once every modem has failed)
+typedef void (*bg95_pool_done_cb)(bg95_handle_t* handle, esp_err_t result, void* context);
+
+typedef struct
+{
+  bg95_pool_job_fn  fn;
+  bg95_pool_done_cb on_done; // Can be NULL
+  void*             context;
+} bg95_pool_job_t;
+
+typedef struct
+{
+  uint32_t jobs_run;
+  uint32_t jobs_failed;
+  uint32_t publishes;
+  uint32_t publish_failures; // Publishes that failed here - the modem is then taken offline
+} bg95_pool_modem_stats_t;
+
+typedef struct
+{
+  bg95_handle_t*          handle;
+  QueueHandle_t           jobs;
+  volatile bool           scheduled; // Queued as ready, or owned by a worker
+  volatile bool           online;    // Takes publishes - see bg95_pool_set_online
+  uint8_t                 mqtt_client_idx;
+  uint16_t                next_msgid;
+  uint32_t                last_poll_ms;
+  bg95_pool_modem_stats_t stats;
+} bg95_pool_modem_t;
+
+typedef struct
+{
+  bg95_pool_modem_t modems[BG95_POOL_MAX_MODEMS];
+  uint8_t           num_modems;
+  QueueHandle_t     ready; // Indices of modems with jobs waiting, each queued at most once
+  SemaphoreHandle_t lock;
+  TaskHandle_t      workers[BG95_POOL_MAX_WORKERS];
+  uint8_t           num_workers;
+  volatile uint8_t  running_workers;
+  volatile bool     stop_requested;
+  uint8_t           next_publish_modem; // Round robin start of the least loaded search
+} bg95_pool_t;
+
+// Modems must be added before the pool is started. 'handle' must be initialized and outlive the
+// pool. 'mqtt_client_idx' is the MQTT client used by bg95_pool_publish on this modem
+esp_err_t bg95_pool_init(bg95_pool_t* pool);
+esp_err_t bg95_pool_add_modem(bg95_pool_t*   pool,
+                              bg95_handle_t* handle,
+                              uint8_t        mqtt_client_idx,
+                              uint8_t*       modem_idx);
+
+esp_err_t bg95_pool_start(bg95_pool_t* pool, uint8_t num_workers);
+
+// Waits for the running jobs to finish and releases the pool. Jobs still queued do not run - their
+// on_done is called with ESP_ERR_INVALID_STATE
+esp_err_t bg95_pool_stop(bg95_pool_t* pool);
+
+// Returns ESP_ERR_NO_MEM if BG95_POOL_QUEUE_LEN jobs are already waiting for this modem
+esp_err_t bg95_pool_submit(bg95_pool_t* pool, uint8_t modem_idx, const bg95_pool_job_t* job);
+
+// Mark a modem as (not) connected to the MQTT broker. A modem is taken offline automatically when a
+// publish on it fails - bring it back once it has reconnected
+esp_err_t bg95_pool_set_online(bg95_pool_t* pool, uint8_t modem_idx, bool online);
+
+// Publish on the online modem with the fewest queued jobs. Topic and message are copied, so they do
+// not have to outlive the call. If the publish fails, it is moved to the next online modem -
+// on_done reports the final result (and the modem that published it).
+// Returns ESP_ERR_NOT_FOUND if no modem is online, ESP_ERR_NO_MEM if all online modems are busy
+esp_err_t bg95_pool_publish(bg95_pool_t*      pool,
+                            const char*       topic,
+                            const void*       message,
+                            uint16_t          message_length,
+                            qmtpub_qos_t      qos,
+                            qmtpub_retain_t   retain,
+                            bg95_pool_done_cb on_done,
+                            void*             context);
+
+esp_err_t
+bg95_pool_get_stats(bg95_pool_t* pool, uint8_t modem_idx, bg95_pool_modem_stats_t* stats);
@@ -1,16 +1,22 @@
 #pragma once
 #include <driver/uart.h>
 #include <esp_err.h>
+#include <stdbool.h>
 #include <stddef.h>
 
 #define BG95_BAUD_RATE 115200
 #define BG95_UART_BUFF_SIZE 2048
+#define BG95_UART_RTS_THRESHOLD 122 // RX FIFO level (of 128) at which RTS is deasserted
+#define BG95_UART_TX_TIMEOUT_MS 1000   // Max time the TX path may stall before a write fails
 
 typedef struct
 {
-  int tx_gpio_num;
-  int rx_gpio_num;
-  int port_num;
+  int      tx_gpio_num;
+  int      rx_gpio_num;
+  int      port_num;
+  uint32_t baud_rate;    // 0 for BG95_BAUD_RATE (e.g. a rate saved with bg95_set_uart_link)
+  int      rts_gpio_num; // RTS / CTS are only needed for hardware flow control - leave both at
+  int      cts_gpio_num; // the same value if they are not wired
 } bg95_uart_config_t;
 
 typedef struct
@@ -20,25 +26,41 @@ typedef struct
   uint32_t delay_ms;     // Delay before emitting response
 } mock_uart_response_t;
 
+#define MOCK_UART_MAX_CMD_LEN 256
+
 // State manager for entire mock UART interface
 typedef struct
 {
   const mock_uart_response_t*
          responses; // const ptr - because responses doesnt change during lifetime of state struct
   size_t num_responses;
-  const char* last_received_cmd; // const ptr - because  command data wont change
+  char   last_received_cmd[MOCK_UART_MAX_CMD_LEN]; // Copy - the writer's buffer does not outlive
+                                                   // the write
+  size_t response_offset; // Bytes of the response already read (reset by every write)
 } mock_uart_state_t;
 
 typedef esp_err_t (*uart_write_fn)(const char* data, size_t len, void* context);
 typedef esp_err_t (*uart_read_fn)(
     char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context);
+// Writes only queue the data - this waits until all of it has actually left the UART.
+// Optional (NULL if writes are synchronous, e.g. the mock)
+typedef esp_err_t (*uart_wait_tx_done_fn)(uint32_t timeout_ms, void* context);
+// Optional - only a physical UART can change its line settings (NULL for the mock / CMUX channels)
+typedef esp_err_t (*uart_set_baud_rate_fn)(uint32_t baud_rate, void* context);
+typedef esp_err_t (*uart_set_flow_control_fn)(bool enable, void* context);
 
 typedef struct
 {
-  uart_write_fn write;
-  uart_read_fn  read;
-  void*         context;
-  uart_port_t   uart_num;
+  uart_write_fn            write;
+  uart_read_fn             read;
+  uart_wait_tx_done_fn     wait_tx_done;
+  uart_set_baud_rate_fn    set_baud_rate;
+  uart_set_flow_control_fn set_flow_control; // NULL if RTS / CTS are not wired
+  void*                    context;
+  uart_port_t              uart_num;
+  uint32_t                 baud_rate; // Rate the UART was initialized with (0: BG95_BAUD_RATE)
+  int                      rts_gpio_num;
+  int                      cts_gpio_num;
 } bg95_uart_interface_t;
 
 // Real UART implementation
@@ -0,0 +1,123 @@
+// Recording UART: a bg95_uart_interface_t that passes everything through to another one and logs
+// every chunk written and read, with the time it crossed the interface. Put it between the driver
+// and the physical UART (or a CMUX channel) to capture what happened on the wire in the field.
+//
+// The capture is kept in a ring owned by the caller (oldest chunks dropped first) and / or streamed
+// to a sink, e.g. a file. Both hold the same format, read back with bg95_uart_record_reader_next:
+//
+//   header:  "B95R", version (BG95_UART_RECORD_VERSION)
+//   chunk:   kind (bg95_uart_record_kind_t), time since the previous chunk in us, length - all
+//            unsigned LEB128 varints - then 'length' bytes
+//
+// An AT exchange costs a few bytes on top of its own, so a 16 kB ring holds the last few hundred
+// commands. The host build can replay a capture to the handler (host/replay).
+#pragma once
+
+#include "bg95_uart_interface.h"
+
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BG95_UART_RECORD_VERSION 1
+#define BG95_UART_RECORD_HEADER_LEN 5
+#define BG95_UART_RECORD_MIN_RING_SIZE 256
+#define BG95_UART_RECORD_CHUNK_OVERHEAD 16 // Largest chunk header: kind, time and length varints
+
+typedef enum
+{
+  BG95_UART_RECORD_TX   = 0U, // Written by the host
+  BG95_UART_RECORD_RX   = 1U, // Read by the host
+  BG95_UART_RECORD_BAUD = 2U, // Line rate changed - 4 bytes, little endian
+} bg95_uart_record_kind_t;
+
+// Gets the capture as it is recorded - the header first, then the header and the bytes of each
+// chunk. An error stops the streaming (the ring keeps recording)
+typedef esp_err_t (*bg95_uart_record_sink_fn)(const void* data, size_t len, void* context);
+
+typedef struct
+{
+  uint8_t*                 ring; // NULL - no ring
+  size_t                   ring_size;
+  bg95_uart_record_sink_fn sink; // NULL - no sink
+  void*                    sink_context;
+} bg95_uart_record_config_t;
+
+typedef struct
+{
+  uint32_t chunks_tx;
+  uint32_t chunks_rx;
+  uint64_t bytes_tx;
+  uint64_t bytes_rx;
+  uint32_t chunks_dropped; // Overwritten in the ring
+  uint32_t sink_errors;
+} bg95_uart_record_stats_t;
+
+typedef struct
+{
+  bg95_uart_interface_t     inner;
+  bg95_uart_record_config_t config;
+  size_t                    ring_head; // Offset of the next byte
+  size_t                    ring_used; // Bytes of whole chunks, the oldest starts 'ring_used' back
+  int64_t                   last_us;   // Time of the previous chunk
+  bool                      sink_failed;
+  bool                      enabled;
+  bg95_uart_record_stats_t  stats;
+  SemaphoreHandle_t         lock;
+} bg95_uart_record_t;
+
+// A chunk of a capture
+typedef struct
+{
+  bg95_uart_record_kind_t kind;
+  uint64_t                time_us; // Since the start of the capture
+  const uint8_t*          data;    // Points into the capture
+  size_t                  len;
+} bg95_uart_record_chunk_t;
+
+typedef struct
+{
+  const uint8_t* capture;
+  size_t         len;
+  size_t         pos;
+  uint64_t       time_us;
+} bg95_uart_record_reader_t;
+
+// Fill 'uart' with the recording interface over 'inner' (copied - the optional functions stay NULL
+// where 'inner' has none). The ring is owned by the caller and must outlive the recorder (at least
+// BG95_UART_RECORD_MIN_RING_SIZE bytes - longer chunks are split to fit). The header goes to the
+// sink here
+esp_err_t bg95_uart_record_init(bg95_uart_record_t*              recorder,
+                                const bg95_uart_interface_t*     inner,
+                                const bg95_uart_record_config_t* config,
+                                bg95_uart_interface_t*           uart);
+
+esp_err_t bg95_uart_record_deinit(bg95_uart_record_t* recorder);
+
+// Recording can be paused without taking the recorder out of the path
+void bg95_uart_record_enable(bg95_uart_record_t* recorder, bool enabled);
+
+void bg95_uart_record_clear(bg95_uart_record_t* recorder);
+
+// Copy the ring out as a capture, oldest chunk first (its time starts the capture). '*len' is the
+// size of the capture - also if 'buffer' is too small, which returns ESP_ERR_INVALID_SIZE
+esp_err_t bg95_uart_record_read(bg95_uart_record_t* recorder,
+                                uint8_t*            buffer,
+                                size_t              buffer_size,
+                                size_t*             len);
+
+esp_err_t bg95_uart_record_get_stats(bg95_uart_record_t* recorder, bg95_uart_record_stats_t* stats);
+
+// Returns ESP_ERR_INVALID_RESPONSE if 'capture' does not start with the header, and
+// ESP_ERR_INVALID_VERSION if it is from a newer recorder
+esp_err_t bg95_uart_record_reader_init(bg95_uart_record_reader_t* reader,
+                                       const void*                capture,
+                                       size_t                     len);
+
+// Returns ESP_ERR_NOT_FOUND at the end of the capture and ESP_ERR_INVALID_SIZE if the last chunk is
+// cut short (e.g. a file that was still being written)
+esp_err_t bg95_uart_record_reader_next(bg95_uart_record_reader_t* reader,
+                                       bg95_uart_record_chunk_t*  chunk);
@@ -1,8 +1,19 @@
 #pragma once
 
+#include "sdkconfig.h"
+
 #include <esp_err.h>
 #include <stdbool.h>
 
+// Text of an enum value that is only ever logged - compiled out with
+// CONFIG_BG95_STRIP_ENUM_STRINGS. Not for strings that are sent to or parsed from the module, e.g.
+// "READY" or "nwscanmode"
+#ifdef CONFIG_BG95_STRIP_ENUM_STRINGS
+#define ENUM_DESC(str) ""
+#else
+#define ENUM_DESC(str) str
+#endif
+
 typedef struct
 {
   int         value;
@@ -16,6 +27,7 @@ typedef struct
   esp_err_t error;
 } enum_convert_result_t;
 
-// Generic conversion function declarations
+// Generic conversion function declarations. Maps whose values are 0, 1, 2, ... in order (most of
+// them) are indexed directly, others are searched
 const char*           enum_to_str(int value, const enum_str_map_t* mapping, size_t map_size);
 enum_convert_result_t str_to_enum(const char* str, const enum_str_map_t* mapping, size_t map_size);
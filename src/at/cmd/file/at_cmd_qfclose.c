@@ -0,0 +1,29 @@
+#include "at_cmd_qfclose.h"
+
+#include "at_cmd_schema.h"
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+// Format: =<filehandle>
+#define QFCLOSE_WRITE_FIELDS(X, type) X(type, file_handle, AT_SCHEMA_INT(0, INT32_MAX))
+
+AT_SCHEMA_DEFINE(QFCLOSE_WRITE_SCHEMA,
+                 qfclose_write_params_t,
+                 AT_CMD_RESPONSE_PREFIX("QFCLOSE"),
+                 QFCLOSE_WRITE_FIELDS,
+                 1);
+
+AT_SCHEMA_FORMATTER(qfclose_write_formatter, QFCLOSE_WRITE_SCHEMA)
+
+const at_cmd_t AT_CMD_QFCLOSE = {
+    .name        = "QFCLOSE",
+    .description = AT_CMD_DESCRIPTION("Close a File"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qfclose_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
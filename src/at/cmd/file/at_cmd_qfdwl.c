@@ -0,0 +1,86 @@
+#include "at_cmd_qfdwl.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QFDWL";
+
+static esp_err_t qfdwl_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qfdwl_write_params_t* write_params = (const qfdwl_write_params_t*) params;
+
+  if (write_params->filename[0] == '\0' || strchr(write_params->filename, '"'))
+  {
+    ESP_LOGE(TAG, "Invalid filename");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: ="<filename>"
+  int written = snprintf(buffer, buffer_size, "=\"%s\"", write_params->filename);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+// Only gets the result - the file data has already been handed to the stream sink
+static esp_err_t qfdwl_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qfdwl_write_response_t* write_resp = (qfdwl_write_response_t*) parsed_data;
+  memset(write_resp, 0, sizeof(qfdwl_write_response_t));
+
+  // Format: +QFDWL: <download_size>,<checksum> (checksum in hex)
+  const char* start = strstr(response, "+QFDWL: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QFDWL: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 8; // Skip "+QFDWL: "
+
+  unsigned long download_size;
+  unsigned int  checksum;
+  if (sscanf(start, "%lu,%x", &download_size, &checksum) != 2 || checksum > UINT16_MAX)
+  {
+    ESP_LOGE(TAG, "Failed to parse QFDWL response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  write_resp->download_size = (uint32_t) download_size;
+  write_resp->checksum      = (uint16_t) checksum;
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QFDWL = {
+    .name        = "QFDWL",
+    .description = AT_CMD_DESCRIPTION("Download a File"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qfdwl_write_parser,
+                                             .formatter     = qfdwl_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 5000 // Max gap between packets of the data
+};
@@ -0,0 +1,46 @@
+#include "at_cmd_qfopen.h"
+
+#include "at_cmd_schema.h"
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+const enum_str_map_t QFOPEN_MODE_MAP[QFOPEN_MODE_MAP_SIZE] = {
+    {QFOPEN_MODE_CREATE_OR_OPEN, ENUM_DESC("Create or open")},
+    {QFOPEN_MODE_CREATE_OR_CLEAR, ENUM_DESC("Create or clear")},
+    {QFOPEN_MODE_READ_ONLY, ENUM_DESC("Read only")}};
+
+// Format: ="<filename>",<mode>
+#define QFOPEN_WRITE_FIELDS(X, type)                                                               \
+  X(type, filename, AT_SCHEMA_STRING(1))                                                           \
+  X(type, mode, AT_SCHEMA_ENUM(QFOPEN_MODE_MAP, QFOPEN_MODE_MAP_SIZE))
+
+// Format: +QFOPEN: <filehandle>
+#define QFOPEN_RESPONSE_FIELDS(X, type)                                                            \
+  X(type, file_handle, AT_SCHEMA_INT(0, INT32_MAX))
+
+AT_SCHEMA_DEFINE(QFOPEN_WRITE_SCHEMA,
+                 qfopen_write_params_t,
+                 AT_CMD_RESPONSE_PREFIX("QFOPEN"),
+                 QFOPEN_WRITE_FIELDS,
+                 2);
+AT_SCHEMA_DEFINE(QFOPEN_RESPONSE_SCHEMA,
+                 qfopen_write_response_t,
+                 AT_CMD_RESPONSE_PREFIX("QFOPEN"),
+                 QFOPEN_RESPONSE_FIELDS,
+                 1);
+
+AT_SCHEMA_FORMATTER(qfopen_write_formatter, QFOPEN_WRITE_SCHEMA)
+AT_SCHEMA_PARSER(qfopen_write_parser, QFOPEN_RESPONSE_SCHEMA)
+
+const at_cmd_t AT_CMD_QFOPEN = {
+    .name        = "QFOPEN",
+    .description = AT_CMD_DESCRIPTION("Open a File"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qfopen_write_parser,
+                                             .formatter     = qfopen_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,94 @@
+#include "at_cmd_qfread.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QFREAD";
+
+esp_err_t qfread_locate_payload(const char* response, size_t* payload_offset, size_t* payload_len)
+{
+  if (NULL == response || NULL == payload_offset || NULL == payload_len)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const char* start = strstr(response, "CONNECT ");
+  if (!start)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // The header is only complete once its CRLF has been received
+  const char* header_end = strstr(start, "\r\n");
+  if (!header_end)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  char*         end;
+  unsigned long length = strtoul(start + 8, &end, 10); // Skip "CONNECT "
+  if (end == start + 8 || end != header_end || length > QFREAD_READ_MAX_LEN)
+  {
+    ESP_LOGE(TAG, "Invalid QFREAD header");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  *payload_offset = (size_t) (header_end + 2 - response);
+  *payload_len    = (size_t) length;
+  return ESP_OK;
+}
+
+static esp_err_t qfread_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qfread_write_params_t* write_params = (const qfread_write_params_t*) params;
+
+  if (write_params->length == 0 || write_params->length > QFREAD_READ_MAX_LEN)
+  {
+    ESP_LOGE(TAG,
+             "Invalid length: %d (must be 1-%d)",
+             write_params->length,
+             QFREAD_READ_MAX_LEN);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<filehandle>,<length>
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "=%lu,%d",
+                         (unsigned long) write_params->file_handle,
+                         write_params->length);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+// The header has no '+' data line, so only the payload path (which returns the read length) is used
+const at_cmd_t AT_CMD_QFREAD = {
+    .name        = "QFREAD",
+    .description = AT_CMD_DESCRIPTION("Read a File"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qfread_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 5000 // Depends on the file system
+};
@@ -0,0 +1,32 @@
+#include "at_cmd_qfseek.h"
+
+#include "at_cmd_schema.h"
+#include "at_cmd_structure.h"
+
+#include <stdint.h>
+
+// Format: =<filehandle>,<offset>,<position>
+#define QFSEEK_WRITE_FIELDS(X, type)                                                               \
+  X(type, file_handle, AT_SCHEMA_INT(0, INT32_MAX))                                                \
+  X(type, offset, AT_SCHEMA_INT(0, INT32_MAX))                                                     \
+  X(type, position, AT_SCHEMA_INT(QFSEEK_POSITION_BEGIN, QFSEEK_POSITION_END))
+
+AT_SCHEMA_DEFINE(QFSEEK_WRITE_SCHEMA,
+                 qfseek_write_params_t,
+                 AT_CMD_RESPONSE_PREFIX("QFSEEK"),
+                 QFSEEK_WRITE_FIELDS,
+                 3);
+
+AT_SCHEMA_FORMATTER(qfseek_write_formatter, QFSEEK_WRITE_SCHEMA)
+
+const at_cmd_t AT_CMD_QFSEEK = {
+    .name        = "QFSEEK",
+    .description = AT_CMD_DESCRIPTION("Set File Pointer to Specified Position"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qfseek_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,92 @@
+#include "at_cmd_qfwrite.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QFWRITE";
+
+static esp_err_t qfwrite_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qfwrite_write_params_t* write_params = (const qfwrite_write_params_t*) params;
+
+  if (write_params->length == 0 || write_params->input_time_s < QFWRITE_INPUT_TIME_MIN_S)
+  {
+    ESP_LOGE(TAG,
+             "Invalid length (%d) or input time (%d)",
+             write_params->length,
+             write_params->input_time_s);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<filehandle>,<length>,<timeout>
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "=%lu,%d,%d",
+                         (unsigned long) write_params->file_handle,
+                         write_params->length,
+                         write_params->input_time_s);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qfwrite_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qfwrite_write_response_t* write_resp = (qfwrite_write_response_t*) parsed_data;
+  memset(write_resp, 0, sizeof(qfwrite_write_response_t));
+
+  // Format: +QFWRITE: <written_length>,<total_length>
+  const char* start = strstr(response, "+QFWRITE: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QFWRITE: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 10; // Skip "+QFWRITE: "
+
+  unsigned long written_length, total_length;
+  if (sscanf(start, "%lu,%lu", &written_length, &total_length) != 2)
+  {
+    ESP_LOGE(TAG, "Failed to parse QFWRITE response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  write_resp->written_length = (uint32_t) written_length;
+  write_resp->total_length   = (uint32_t) total_length;
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QFWRITE = {
+    .name        = "QFWRITE",
+    .description = AT_CMD_DESCRIPTION("Write a File"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qfwrite_write_parser,
+                                             .formatter     = qfwrite_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 10000 // Counted from the end of the data, covers the default input time
+};
@@ -14,7 +14,7 @@ static esp_err_t at_execute_formatter(const void* params, char* buffer, size_t b
 // AT command definition
 const at_cmd_t AT_CMD_AT = {
     .name        = "AT", // This is a basic AT command without the + prefix
-    .description = "Basic AT Command",
+    .description = AT_CMD_DESCRIPTION("Basic AT Command"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_DOES_NOT_EXIST,
                     [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
                     [AT_CMD_TYPE_WRITE]   = AT_CMD_TYPE_DOES_NOT_EXIST,
@@ -0,0 +1,109 @@
+#include "at_cmd_qgps.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QGPS";
+
+static esp_err_t qgps_read_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qgps_read_response_t* read_data = (qgps_read_response_t*) parsed_data;
+
+  const char* start = strstr(response, "+QGPS: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QGPS: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 7; // Skip "+QGPS: "
+
+  int state;
+  if (sscanf(start, "%d", &state) != 1 || state < QGPS_STATE_OFF || state > QGPS_STATE_ON)
+  {
+    ESP_LOGE(TAG, "Failed to parse QGPS read response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  read_data->state = (qgps_state_t) state;
+
+  return ESP_OK;
+}
+
+static esp_err_t qgps_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qgps_write_params_t* write_params = (const qgps_write_params_t*) params;
+
+  if (write_params->mode != QGPS_MODE_STANDALONE)
+  {
+    ESP_LOGE(TAG, "Invalid GNSS mode: %d", write_params->mode);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written;
+  if (write_params->present.has_fix_params)
+  {
+    if (write_params->fix_max_time_s < QGPS_FIX_MAX_TIME_MIN_S ||
+        write_params->fix_max_dist_m > QGPS_FIX_MAX_DIST_MAX_M ||
+        write_params->fix_count > QGPS_FIX_COUNT_MAX ||
+        write_params->fix_rate_s < QGPS_FIX_RATE_MIN_S)
+    {
+      ESP_LOGE(TAG, "Invalid fix parameters");
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    // Format: =<GNSS_mode>,<fixmaxtime>,<fixmaxdist>,<fixcount>,<fixrate>
+    written = snprintf(buffer,
+                       buffer_size,
+                       "=%d,%u,%u,%u,%u",
+                       write_params->mode,
+                       write_params->fix_max_time_s,
+                       write_params->fix_max_dist_m,
+                       write_params->fix_count,
+                       write_params->fix_rate_s);
+  }
+  else
+  {
+    // Format: =<GNSS_mode>
+    written = snprintf(buffer, buffer_size, "=%d", write_params->mode);
+  }
+
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QGPS = {
+    .name        = "QGPS",
+    .description = AT_CMD_DESCRIPTION("Turn on GNSS"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = qgps_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qgps_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,78 @@
+#include "at_cmd_qgpscfg.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QGPSCFG";
+
+const enum_str_map_t QGPSCFG_TYPE_MAP[QGPSCFG_TYPE_MAP_SIZE] = {
+    {QGPSCFG_TYPE_OUTPORT, "outport"}, {QGPSCFG_TYPE_NMEASRC, "nmeasrc"}};
+
+const enum_str_map_t QGPSCFG_OUTPORT_MAP[QGPSCFG_OUTPORT_MAP_SIZE] = {
+    {QGPSCFG_OUTPORT_NONE, "none"},
+    {QGPSCFG_OUTPORT_USBNMEA, "usbnmea"},
+    {QGPSCFG_OUTPORT_UARTNMEA, "uartnmea"}};
+
+static esp_err_t qgpscfg_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qgpscfg_write_params_t* write_params = (const qgpscfg_write_params_t*) params;
+
+  int written;
+  switch (write_params->type)
+  {
+    case QGPSCFG_TYPE_OUTPORT:
+    {
+      const char* outport_str = enum_to_str(
+          write_params->value.outport, QGPSCFG_OUTPORT_MAP, QGPSCFG_OUTPORT_MAP_SIZE);
+      if (strcmp(outport_str, "UNKNOWN") == 0)
+      {
+        ESP_LOGE(TAG, "Invalid outport: %d", write_params->value.outport);
+        return ESP_ERR_INVALID_ARG;
+      }
+      // Format: ="outport","<outport>"
+      written = snprintf(buffer, buffer_size, "=\"outport\",\"%s\"", outport_str);
+      break;
+    }
+    case QGPSCFG_TYPE_NMEASRC:
+      // Format: ="nmeasrc",<enable>
+      written =
+          snprintf(buffer, buffer_size, "=\"nmeasrc\",%d", write_params->value.nmeasrc ? 1 : 0);
+      break;
+    default:
+      ESP_LOGE(TAG, "Invalid QGPSCFG type: %d", write_params->type);
+      return ESP_ERR_INVALID_ARG;
+  }
+
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QGPSCFG = {
+    .name        = "QGPSCFG",
+    .description = AT_CMD_DESCRIPTION("Configure GNSS"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qgpscfg_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,21 @@
+#include "at_cmd_qgpsend.h"
+
+#include "at_cmd_structure.h"
+
+// No parameters - only here to pass the implementation check
+static esp_err_t qgpsend_execute_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QGPSEND = {
+    .name        = "QGPSEND",
+    .description = AT_CMD_DESCRIPTION("Turn off GNSS"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_EXECUTE] = {.parser        = NULL,
+                                             .formatter     = qgpsend_execute_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY}},
+    .timeout_ms  = 300 // 300ms per spec
+};
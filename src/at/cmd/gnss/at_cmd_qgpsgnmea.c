@@ -0,0 +1,104 @@
+#include "at_cmd_qgpsgnmea.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QGPSGNMEA";
+
+const enum_str_map_t QGPSGNMEA_SENTENCE_MAP[QGPSGNMEA_SENTENCE_MAP_SIZE] = {
+    {QGPSGNMEA_SENTENCE_GGA, "GGA"},
+    {QGPSGNMEA_SENTENCE_RMC, "RMC"},
+    {QGPSGNMEA_SENTENCE_GSV, "GSV"},
+    {QGPSGNMEA_SENTENCE_GSA, "GSA"},
+    {QGPSGNMEA_SENTENCE_VTG, "VTG"},
+    {QGPSGNMEA_SENTENCE_GNS, "GNS"}};
+
+static esp_err_t qgpsgnmea_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qgpsgnmea_write_response_t* write_data = (qgpsgnmea_write_response_t*) parsed_data;
+  write_data->nmea[0]                    = '\0';
+  write_data->nmea_len                   = 0;
+
+  // Format: +QGPSGNMEA: <sentence> - repeated for multi sentence types
+  const char* start = strstr(response, "+QGPSGNMEA: ");
+  while (start)
+  {
+    start += 12; // Skip "+QGPSGNMEA: "
+
+    size_t len = strcspn(start, "\r\n");
+    if (write_data->nmea_len + len + 2 >= sizeof(write_data->nmea))
+    {
+      ESP_LOGE(TAG, "NMEA sentences do not fit the response");
+      return ESP_ERR_INVALID_SIZE;
+    }
+
+    memcpy(write_data->nmea + write_data->nmea_len, start, len);
+    write_data->nmea_len += len;
+    memcpy(write_data->nmea + write_data->nmea_len, "\r\n", 3);
+    write_data->nmea_len += 2;
+
+    start = strstr(start + len, "+QGPSGNMEA: ");
+  }
+
+  if (write_data->nmea_len == 0)
+  {
+    ESP_LOGE(TAG, "Failed to find +QGPSGNMEA: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qgpsgnmea_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qgpsgnmea_write_params_t* write_params = (const qgpsgnmea_write_params_t*) params;
+
+  const char* sentence_str = enum_to_str(
+      write_params->sentence, QGPSGNMEA_SENTENCE_MAP, QGPSGNMEA_SENTENCE_MAP_SIZE);
+  if (strcmp(sentence_str, "UNKNOWN") == 0)
+  {
+    ESP_LOGE(TAG, "Invalid NMEA sentence type: %d", write_params->sentence);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: ="<sentence>"
+  int written = snprintf(buffer, buffer_size, "=\"%s\"", sentence_str);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QGPSGNMEA = {
+    .name        = "QGPSGNMEA",
+    .description = AT_CMD_DESCRIPTION("Obtain GNSS NMEA Sentences"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qgpsgnmea_write_parser,
+                                             .formatter     = qgpsgnmea_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
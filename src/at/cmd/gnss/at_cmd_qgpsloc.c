@@ -0,0 +1,141 @@
+#include "at_cmd_qgpsloc.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QGPSLOC";
+
+// +QGPSLOC: <UTC>,<latitude>,<longitude>,<HDOP>,<altitude>,<fix>,<COG>,<spkm>,<spkn>,<date>,<nsat>
+#define QGPSLOC_NUM_FIELDS 11
+#define QGPSLOC_FIELD_UTC 0
+#define QGPSLOC_FIELD_LATITUDE 1
+#define QGPSLOC_FIELD_LONGITUDE 2
+#define QGPSLOC_FIELD_HDOP 3
+#define QGPSLOC_FIELD_ALTITUDE 4
+#define QGPSLOC_FIELD_FIX 5
+#define QGPSLOC_FIELD_COG 6
+#define QGPSLOC_FIELD_SPKM 7
+#define QGPSLOC_FIELD_DATE 9
+#define QGPSLOC_FIELD_NSAT 10
+
+static esp_err_t qgpsloc_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qgpsloc_write_response_t* write_data = (qgpsloc_write_response_t*) parsed_data;
+  memset(write_data, 0, sizeof(qgpsloc_write_response_t));
+
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+QGPSLOC: ") != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to find +QGPSLOC: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  at_field_t fields[QGPSLOC_NUM_FIELDS + 1];
+  int        num_fields = 0;
+  while (num_fields <= QGPSLOC_NUM_FIELDS && at_tokenizer_next(&tok, &fields[num_fields]) == ESP_OK)
+  {
+    num_fields++;
+  }
+
+  if (num_fields != QGPSLOC_NUM_FIELDS)
+  {
+    ESP_LOGE(TAG, "Expected %d fields, got %d", QGPSLOC_NUM_FIELDS, num_fields);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  int64_t utc, latitude, longitude, hdop, altitude, fix, cog, speed, date, nsat;
+  if (at_field_get_fixed(&fields[QGPSLOC_FIELD_UTC], 3, &utc) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_LATITUDE], 7, &latitude) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_LONGITUDE], 7, &longitude) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_HDOP], 2, &hdop) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_ALTITUDE], 2, &altitude) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_FIX], 0, &fix) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_COG], 2, &cog) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_SPKM], 2, &speed) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_DATE], 0, &date) != ESP_OK ||
+      at_field_get_fixed(&fields[QGPSLOC_FIELD_NSAT], 0, &nsat) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse QGPSLOC response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  if (latitude < -900000000LL || latitude > 900000000LL || longitude < -1800000000LL ||
+      longitude > 1800000000LL || (fix != QGPSLOC_FIX_2D && fix != QGPSLOC_FIX_3D))
+  {
+    ESP_LOGE(TAG, "QGPSLOC response out of range");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  // UTC is hhmmss.sss, the date ddmmyy
+  write_data->hour         = (uint8_t) (utc / 10000000);
+  write_data->minute       = (uint8_t) (utc / 100000 % 100);
+  write_data->second       = (uint8_t) (utc / 1000 % 100);
+  write_data->millisecond  = (uint16_t) (utc % 1000);
+  write_data->day          = (uint8_t) (date / 10000);
+  write_data->month        = (uint8_t) (date / 100 % 100);
+  write_data->year         = (uint16_t) (2000 + date % 100);
+  write_data->latitude_e7  = (int32_t) latitude;
+  write_data->longitude_e7 = (int32_t) longitude;
+  write_data->hdop_x100    = (uint16_t) hdop;
+  write_data->altitude_cm  = (int32_t) altitude;
+  write_data->fix          = (qgpsloc_fix_t) fix;
+  // COG is ddd.mm - degrees and minutes
+  write_data->course_x100    = (uint16_t) (cog / 100 * 100 + cog % 100 * 100 / 60);
+  write_data->speed_kmh_x100 = (uint32_t) speed;
+  write_data->satellites     = (uint8_t) nsat;
+
+  return ESP_OK;
+}
+
+static esp_err_t qgpsloc_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qgpsloc_write_params_t* write_params = (const qgpsloc_write_params_t*) params;
+
+  if (write_params->mode != QGPSLOC_MODE_DECIMAL)
+  {
+    ESP_LOGE(TAG, "Unsupported QGPSLOC mode: %d", write_params->mode);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written = snprintf(buffer, buffer_size, "=%d", write_params->mode);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QGPSLOC = {
+    .name        = "QGPSLOC",
+    .description = AT_CMD_DESCRIPTION("Acquire Positioning Information"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qgpsloc_write_parser,
+                                             .formatter     = qgpsloc_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_NOT_IMPLEMENTED},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,108 @@
+#include "at_cmd_cmux.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_CMUX";
+
+const enum_str_map_t CMUX_PORT_SPEED_MAP[CMUX_PORT_SPEED_MAP_SIZE] = {
+    {CMUX_PORT_SPEED_9600, ENUM_DESC("9600")},
+    {CMUX_PORT_SPEED_19200, ENUM_DESC("19200")},
+    {CMUX_PORT_SPEED_38400, ENUM_DESC("38400")},
+    {CMUX_PORT_SPEED_57600, ENUM_DESC("57600")},
+    {CMUX_PORT_SPEED_115200, ENUM_DESC("115200")},
+    {CMUX_PORT_SPEED_230400, ENUM_DESC("230400")},
+    {CMUX_PORT_SPEED_460800, ENUM_DESC("460800")},
+    {CMUX_PORT_SPEED_921600, ENUM_DESC("921600")}};
+
+static esp_err_t cmux_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const cmux_write_params_t* write_params = (const cmux_write_params_t*) params;
+
+  if (write_params->mode != CMUX_MODE_BASIC || write_params->subset != CMUX_SUBSET_UIH)
+  {
+    ESP_LOGE(TAG, "Only basic mode with UIH frames is supported");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_port_speed &&
+      (write_params->port_speed < CMUX_PORT_SPEED_9600 ||
+       write_params->port_speed > CMUX_PORT_SPEED_921600))
+  {
+    ESP_LOGE(TAG, "Invalid port speed: %d", write_params->port_speed);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_n1 &&
+      (write_params->n1 < CMUX_N1_MIN || write_params->n1 > CMUX_N1_MAX))
+  {
+    ESP_LOGE(TAG, "Invalid N1: %d", write_params->n1);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_n1 && !write_params->present.has_port_speed)
+  {
+    ESP_LOGE(TAG, "N1 requires the port speed to be given");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<mode>[,<subset>[,<port_speed>[,<N1>]]]
+  int written;
+  if (write_params->present.has_n1)
+  {
+    written = snprintf(buffer,
+                       buffer_size,
+                       "=%d,%d,%d,%d",
+                       write_params->mode,
+                       write_params->subset,
+                       write_params->port_speed,
+                       write_params->n1);
+  }
+  else if (write_params->present.has_port_speed)
+  {
+    written = snprintf(buffer,
+                       buffer_size,
+                       "=%d,%d,%d",
+                       write_params->mode,
+                       write_params->subset,
+                       write_params->port_speed);
+  }
+  else
+  {
+    written = snprintf(buffer, buffer_size, "=%d,%d", write_params->mode, write_params->subset);
+  }
+
+  if (written < 0 || (size_t) written >= buffer_size)
+  {
+    ESP_LOGE(TAG, "Buffer too small for CMUX write command");
+    if (buffer_size > 0)
+    {
+      buffer[0] = '\0'; // Ensure null-terminated in case of overflow
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_CMUX = {
+    .name        = "CMUX",
+    .description = AT_CMD_DESCRIPTION("Multiplexing Mode"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = cmux_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
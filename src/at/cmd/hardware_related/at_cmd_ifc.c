@@ -0,0 +1,39 @@
+#include "at_cmd_ifc.h"
+
+#include "at_cmd_schema.h"
+#include "at_cmd_structure.h"
+
+const enum_str_map_t IFC_FLOW_CONTROL_MAP[IFC_FLOW_CONTROL_MAP_SIZE] = {
+    {IFC_FLOW_CONTROL_NONE, ENUM_DESC("None")}, {IFC_FLOW_CONTROL_RTS_CTS, ENUM_DESC("RTS/CTS")}};
+
+#define IFC_FIELDS(X, type)                                                                        \
+  X(type, dce_by_dte, AT_SCHEMA_ENUM(IFC_FLOW_CONTROL_MAP, IFC_FLOW_CONTROL_MAP_SIZE))             \
+  X(type, dte_by_dce, AT_SCHEMA_ENUM(IFC_FLOW_CONTROL_MAP, IFC_FLOW_CONTROL_MAP_SIZE))
+
+AT_SCHEMA_DEFINE(IFC_READ_SCHEMA,
+                 ifc_read_response_t,
+                 AT_CMD_RESPONSE_PREFIX("IFC"),
+                 IFC_FIELDS,
+                 2);
+AT_SCHEMA_DEFINE(IFC_WRITE_SCHEMA,
+                 ifc_write_params_t,
+                 AT_CMD_RESPONSE_PREFIX("IFC"),
+                 IFC_FIELDS,
+                 2);
+
+AT_SCHEMA_PARSER(ifc_read_parser, IFC_READ_SCHEMA)
+AT_SCHEMA_FORMATTER(ifc_write_formatter, IFC_WRITE_SCHEMA)
+
+const at_cmd_t AT_CMD_IFC = {
+    .name        = "IFC",
+    .description = AT_CMD_DESCRIPTION("Set TE-TA Local Data Flow Control"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = ifc_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = ifc_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
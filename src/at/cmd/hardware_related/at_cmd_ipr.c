@@ -0,0 +1,102 @@
+#include "at_cmd_ipr.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_IPR";
+
+const uint32_t IPR_RATES[IPR_NUM_RATES] = {
+    9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+
+bool ipr_rate_is_valid(uint32_t rate)
+{
+  for (size_t i = 0; i < IPR_NUM_RATES; i++)
+  {
+    if (IPR_RATES[i] == rate)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+static esp_err_t ipr_read_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  ipr_read_response_t* read_data = (ipr_read_response_t*) parsed_data;
+  memset(read_data, 0, sizeof(ipr_read_response_t));
+
+  const char* start = strstr(response, "+IPR: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +IPR: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 6; // Skip "+IPR: "
+
+  unsigned long rate;
+  if (sscanf(start, "%lu", &rate) != 1 || !ipr_rate_is_valid((uint32_t) rate))
+  {
+    ESP_LOGE(TAG, "Failed to parse IPR read response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  read_data->rate = (uint32_t) rate;
+  return ESP_OK;
+}
+
+static esp_err_t ipr_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const ipr_write_params_t* write_params = (const ipr_write_params_t*) params;
+
+  if (!ipr_rate_is_valid(write_params->rate))
+  {
+    ESP_LOGE(TAG, "Invalid baud rate: %lu", (unsigned long) write_params->rate);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "=%lu%s",
+                         (unsigned long) write_params->rate,
+                         write_params->save ? ";&W" : "");
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_IPR = {
+    .name        = "IPR",
+    .description = AT_CMD_DESCRIPTION("Set TE-TA Fixed Local Rate"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = ipr_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = ipr_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,39 @@
+#include "at_cmd_qsclk.h"
+
+#include "at_cmd_schema.h"
+#include "at_cmd_structure.h"
+
+const enum_str_map_t QSCLK_SLEEP_MODE_MAP[QSCLK_SLEEP_MODE_MAP_SIZE] = {
+    {QSCLK_SLEEP_DISABLE, ENUM_DESC("Disable sleep mode")},
+    {QSCLK_SLEEP_ENABLE, ENUM_DESC("Enable sleep mode (controlled by DTR)")}};
+
+#define QSCLK_FIELDS(X, type)                                                                      \
+  X(type, mode, AT_SCHEMA_ENUM(QSCLK_SLEEP_MODE_MAP, QSCLK_SLEEP_MODE_MAP_SIZE))
+
+AT_SCHEMA_DEFINE(QSCLK_READ_SCHEMA,
+                 qsclk_read_response_t,
+                 AT_CMD_RESPONSE_PREFIX("QSCLK"),
+                 QSCLK_FIELDS,
+                 1);
+AT_SCHEMA_DEFINE(QSCLK_WRITE_SCHEMA,
+                 qsclk_write_params_t,
+                 AT_CMD_RESPONSE_PREFIX("QSCLK"),
+                 QSCLK_FIELDS,
+                 1);
+
+AT_SCHEMA_PARSER(qsclk_read_parser, QSCLK_READ_SCHEMA)
+AT_SCHEMA_FORMATTER(qsclk_write_formatter, QSCLK_WRITE_SCHEMA)
+
+const at_cmd_t AT_CMD_QSCLK = {
+    .name        = "QSCLK",
+    .description = AT_CMD_DESCRIPTION("Configure Whether or Not to Enter Sleep Mode"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = qsclk_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qsclk_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,92 @@
+#include "at_cmd_qhttpcfg.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QHTTPCFG";
+
+const enum_str_map_t QHTTPCFG_TYPE_MAP[QHTTPCFG_TYPE_MAP_SIZE] = {
+    {QHTTPCFG_TYPE_CONTEXTID, "contextid"},
+    {QHTTPCFG_TYPE_REQUESTHEADER, "requestheader"},
+    {QHTTPCFG_TYPE_RESPONSEHEADER, "responseheader"},
+    {QHTTPCFG_TYPE_SSLCTXID, "sslctxid"},
+    {QHTTPCFG_TYPE_CONTENTTYPE, "contenttype"}};
+
+const enum_str_map_t QHTTPCFG_CONTENT_TYPE_MAP[QHTTPCFG_CONTENT_TYPE_MAP_SIZE] = {
+    {QHTTPCFG_CONTENT_TYPE_FORM_URLENCODED, ENUM_DESC("application/x-www-form-urlencoded")},
+    {QHTTPCFG_CONTENT_TYPE_TEXT_PLAIN, ENUM_DESC("text/plain")},
+    {QHTTPCFG_CONTENT_TYPE_OCTET_STREAM, ENUM_DESC("application/octet-stream")},
+    {QHTTPCFG_CONTENT_TYPE_MULTIPART_FORM, ENUM_DESC("multipart/form-data")}};
+
+static bool qhttpcfg_value_is_valid(qhttpcfg_type_t type, int value)
+{
+  switch (type)
+  {
+    case QHTTPCFG_TYPE_CONTEXTID:
+      return value >= QHTTPCFG_CONTEXT_ID_MIN && value <= QHTTPCFG_CONTEXT_ID_MAX;
+    case QHTTPCFG_TYPE_REQUESTHEADER:
+    case QHTTPCFG_TYPE_RESPONSEHEADER:
+      return value == 0 || value == 1;
+    case QHTTPCFG_TYPE_SSLCTXID:
+      return value >= 0 && value <= QHTTPCFG_SSL_CONTEXT_ID_MAX;
+    case QHTTPCFG_TYPE_CONTENTTYPE:
+      return value >= QHTTPCFG_CONTENT_TYPE_FORM_URLENCODED &&
+             value <= QHTTPCFG_CONTENT_TYPE_MULTIPART_FORM;
+    default:
+      return false;
+  }
+}
+
+static esp_err_t qhttpcfg_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qhttpcfg_write_params_t* write_params = (const qhttpcfg_write_params_t*) params;
+
+  const char* type_str =
+      enum_to_str(write_params->type, QHTTPCFG_TYPE_MAP, QHTTPCFG_TYPE_MAP_SIZE);
+  if (strcmp(type_str, "UNKNOWN") == 0)
+  {
+    ESP_LOGE(TAG, "Invalid QHTTPCFG type: %d", write_params->type);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (!qhttpcfg_value_is_valid(write_params->type, write_params->value))
+  {
+    ESP_LOGE(TAG, "Invalid value %d for %s", write_params->value, type_str);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: ="<type>",<value>
+  int written = snprintf(buffer, buffer_size, "=\"%s\",%d", type_str, write_params->value);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QHTTPCFG = {
+    .name        = "QHTTPCFG",
+    .description = AT_CMD_DESCRIPTION("Configure Parameters for HTTP(S) Server"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qhttpcfg_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,110 @@
+#include "at_cmd_qhttpget.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QHTTPGET";
+
+esp_err_t qhttp_parse_request_result(const char* start, qhttp_request_result_t* result)
+{
+  if (NULL == start || NULL == result)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(result, 0, sizeof(qhttp_request_result_t));
+
+  int           err, http_status;
+  unsigned long content_length;
+  int           matched = sscanf(start, "%d,%d,%lu", &err, &http_status, &content_length);
+  if (matched < 1)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  result->err = err;
+  if (matched >= 2 && http_status >= 0 && http_status <= UINT16_MAX)
+  {
+    result->http_status             = (uint16_t) http_status;
+    result->present.has_http_status = true;
+  }
+  if (matched >= 3)
+  {
+    result->content_length             = (uint32_t) content_length;
+    result->present.has_content_length = true;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qhttpget_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qhttpget_write_params_t* write_params = (const qhttpget_write_params_t*) params;
+
+  if (write_params->rsptime_s < QHTTP_RSPTIME_MIN_S ||
+      write_params->rsptime_s > QHTTP_RSPTIME_MAX_S)
+  {
+    ESP_LOGE(TAG, "Invalid response time: %d", write_params->rsptime_s);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<rsptime>
+  int written = snprintf(buffer, buffer_size, "=%d", write_params->rsptime_s);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qhttpget_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // URC response format: +QHTTPGET: <err>[,<httprspcode>[,<content_length>]]
+  const char* start = strstr(response, "+QHTTPGET: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QHTTPGET: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 11; // Skip "+QHTTPGET: "
+
+  esp_err_t err = qhttp_parse_request_result(start, (qhttpget_write_response_t*) parsed_data);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse QHTTPGET response");
+  }
+  return err;
+}
+
+const at_cmd_t AT_CMD_QHTTPGET = {
+    .name        = "QHTTPGET",
+    .description = AT_CMD_DESCRIPTION("Send GET Request to HTTP(S) Server"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qhttpget_write_parser,
+                                             .formatter     = qhttpget_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = (QHTTP_RSPTIME_MAX_S + 5) * 1000 // Covers the longest response time allowed
+};
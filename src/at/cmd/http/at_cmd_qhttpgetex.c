@@ -0,0 +1,89 @@
+#include "at_cmd_qhttpgetex.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QHTTPGETEX";
+
+static esp_err_t qhttpgetex_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qhttpgetex_write_params_t* write_params = (const qhttpgetex_write_params_t*) params;
+
+  if (write_params->rsptime_s < QHTTP_RSPTIME_MIN_S ||
+      write_params->rsptime_s > QHTTP_RSPTIME_MAX_S)
+  {
+    ESP_LOGE(TAG, "Invalid response time: %d", write_params->rsptime_s);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->read_len == 0)
+  {
+    ESP_LOGE(TAG, "Empty range is not allowed");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<rsptime>,<start_position>,<read_len>
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "=%d,%lu,%lu",
+                         write_params->rsptime_s,
+                         (unsigned long) write_params->start_position,
+                         (unsigned long) write_params->read_len);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qhttpgetex_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // URC response format: +QHTTPGETEX: <err>[,<httprspcode>[,<content_length>]]
+  const char* start = strstr(response, "+QHTTPGETEX: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QHTTPGETEX: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 13; // Skip "+QHTTPGETEX: "
+
+  esp_err_t err = qhttp_parse_request_result(start, (qhttpgetex_write_response_t*) parsed_data);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse QHTTPGETEX response");
+  }
+  return err;
+}
+
+const at_cmd_t AT_CMD_QHTTPGETEX = {
+    .name        = "QHTTPGETEX",
+    .description = AT_CMD_DESCRIPTION("Send GET Request to HTTP(S) Server by Range"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qhttpgetex_write_parser,
+                                             .formatter     = qhttpgetex_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = (QHTTP_RSPTIME_MAX_S + 5) * 1000 // Covers the longest response time allowed
+};
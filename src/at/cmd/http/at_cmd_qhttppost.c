@@ -0,0 +1,93 @@
+#include "at_cmd_qhttppost.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QHTTPPOST";
+
+static esp_err_t qhttppost_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qhttppost_write_params_t* write_params = (const qhttppost_write_params_t*) params;
+
+  if (write_params->data_length == 0 || write_params->data_length > QHTTPPOST_DATA_MAX_LEN)
+  {
+    ESP_LOGE(TAG, "Invalid data length: %lu", (unsigned long) write_params->data_length);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->input_time_s < QHTTPPOST_INPUT_TIME_MIN_S ||
+      write_params->rsptime_s < QHTTP_RSPTIME_MIN_S ||
+      write_params->rsptime_s > QHTTP_RSPTIME_MAX_S)
+  {
+    ESP_LOGE(TAG,
+             "Invalid input time (%d) or response time (%d)",
+             write_params->input_time_s,
+             write_params->rsptime_s);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<data_length>,<input_time>,<rsptime>
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "=%lu,%d,%d",
+                         (unsigned long) write_params->data_length,
+                         write_params->input_time_s,
+                         write_params->rsptime_s);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qhttppost_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // URC response format: +QHTTPPOST: <err>[,<httprspcode>[,<content_length>]]
+  const char* start = strstr(response, "+QHTTPPOST: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QHTTPPOST: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 12; // Skip "+QHTTPPOST: "
+
+  esp_err_t err = qhttp_parse_request_result(start, (qhttppost_write_response_t*) parsed_data);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse QHTTPPOST response");
+  }
+  return err;
+}
+
+const at_cmd_t AT_CMD_QHTTPPOST = {
+    .name        = "QHTTPPOST",
+    .description = AT_CMD_DESCRIPTION("Send POST Request to HTTP(S) Server"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qhttppost_write_parser,
+                                             .formatter     = qhttppost_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = (QHTTP_RSPTIME_MAX_S + 5) * 1000 // Counted from the end of the body
+};
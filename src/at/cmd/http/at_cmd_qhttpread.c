@@ -0,0 +1,83 @@
+#include "at_cmd_qhttpread.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QHTTPREAD";
+
+static esp_err_t qhttpread_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qhttpread_write_params_t* write_params = (const qhttpread_write_params_t*) params;
+
+  if (write_params->wait_time_s < QHTTPREAD_WAIT_TIME_MIN_S ||
+      write_params->wait_time_s > QHTTPREAD_WAIT_TIME_MAX_S)
+  {
+    ESP_LOGE(TAG, "Invalid wait time: %d", write_params->wait_time_s);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<wait_time>
+  int written = snprintf(buffer, buffer_size, "=%d", write_params->wait_time_s);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+// Only gets the result line - the body has already been handed to the stream sink
+static esp_err_t qhttpread_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qhttpread_write_response_t* write_resp = (qhttpread_write_response_t*) parsed_data;
+  memset(write_resp, 0, sizeof(qhttpread_write_response_t));
+
+  // Format: +QHTTPREAD: <err>
+  const char* start = strstr(response, "+QHTTPREAD: ");
+  if (!start)
+  {
+    ESP_LOGE(TAG, "Failed to find +QHTTPREAD: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  start += 12; // Skip "+QHTTPREAD: "
+
+  if (sscanf(start, "%d", &write_resp->err) != 1)
+  {
+    ESP_LOGE(TAG, "Failed to parse QHTTPREAD response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QHTTPREAD = {
+    .name        = "QHTTPREAD",
+    .description = AT_CMD_DESCRIPTION("Read Response from HTTP(S) Server"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qhttpread_write_parser,
+                                             .formatter     = qhttpread_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = (QHTTPREAD_WAIT_TIME_MAX_S + 5) * 1000 // Max gap between packets of the body
+};
@@ -0,0 +1,59 @@
+#include "at_cmd_qhttpurl.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QHTTPURL";
+
+static esp_err_t qhttpurl_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qhttpurl_write_params_t* write_params = (const qhttpurl_write_params_t*) params;
+
+  if (write_params->url_length == 0 || write_params->url_length > QHTTPURL_URL_MAX_LEN)
+  {
+    ESP_LOGE(TAG, "Invalid URL length: %d", write_params->url_length);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->input_time_s < QHTTPURL_INPUT_TIME_MIN_S)
+  {
+    ESP_LOGE(TAG, "Invalid input time: %d", write_params->input_time_s);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<URL_length>,<timeout>
+  int written = snprintf(
+      buffer, buffer_size, "=%d,%d", write_params->url_length, write_params->input_time_s);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QHTTPURL = {
+    .name        = "QHTTPURL",
+    .description = AT_CMD_DESCRIPTION("Set URL of HTTP(S) Server"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qhttpurl_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 5000 // OK follows once the URL has been input
+};
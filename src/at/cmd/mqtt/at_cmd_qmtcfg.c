@@ -1,6 +1,7 @@
 #include "at_cmd_qmtcfg.h"
 
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
 #include "esp_err.h"
 #include "esp_log.h"
 
@@ -10,35 +11,40 @@ static const char* TAG = "AT_CMD_QMTCFG";
 
 // Define the mapping arrays
 const enum_str_map_t QMTCFG_VERSION_MAP[QMTCFG_VERSION_MAP_SIZE] = {
-    {QMTCFG_VERSION_MQTT_3_1, "MQTT v3.1"}, {QMTCFG_VERSION_MQTT_3_1_1, "MQTT v3.1.1"}};
+    {QMTCFG_VERSION_MQTT_3_1, ENUM_DESC("MQTT v3.1")},
+    {QMTCFG_VERSION_MQTT_3_1_1, ENUM_DESC("MQTT v3.1.1")}};
 
 const enum_str_map_t QMTCFG_SSL_MODE_MAP[QMTCFG_SSL_MODE_MAP_SIZE] = {
-    {QMTCFG_SSL_DISABLE, "Normal TCP"}, {QMTCFG_SSL_ENABLE, "SSL TCP"}};
+    {QMTCFG_SSL_DISABLE, ENUM_DESC("Normal TCP")}, {QMTCFG_SSL_ENABLE, ENUM_DESC("SSL TCP")}};
 
 const enum_str_map_t QMTCFG_CLEAN_SESSION_MAP[QMTCFG_CLEAN_SESSION_MAP_SIZE] = {
-    {QMTCFG_CLEAN_SESSION_DISABLE, "Store subscriptions"},
-    {QMTCFG_CLEAN_SESSION_ENABLE, "Discard information"}};
+    {QMTCFG_CLEAN_SESSION_DISABLE, ENUM_DESC("Store subscriptions")},
+    {QMTCFG_CLEAN_SESSION_ENABLE, ENUM_DESC("Discard information")}};
 
 const enum_str_map_t QMTCFG_WILL_FLAG_MAP[QMTCFG_WILL_FLAG_MAP_SIZE] = {
-    {QMTCFG_WILL_FLAG_IGNORE, "Ignore"}, {QMTCFG_WILL_FLAG_REQUIRE, "Require"}};
+    {QMTCFG_WILL_FLAG_IGNORE, ENUM_DESC("Ignore")},
+    {QMTCFG_WILL_FLAG_REQUIRE, ENUM_DESC("Require")}};
 
 const enum_str_map_t QMTCFG_WILL_QOS_MAP[QMTCFG_WILL_QOS_MAP_SIZE] = {
-    {QMTCFG_WILL_QOS_0, "At most once"},
-    {QMTCFG_WILL_QOS_1, "At least once"},
-    {QMTCFG_WILL_QOS_2, "Exactly once"}};
+    {QMTCFG_WILL_QOS_0, ENUM_DESC("At most once")},
+    {QMTCFG_WILL_QOS_1, ENUM_DESC("At least once")},
+    {QMTCFG_WILL_QOS_2, ENUM_DESC("Exactly once")}};
 
 const enum_str_map_t QMTCFG_WILL_RETAIN_MAP[QMTCFG_WILL_RETAIN_MAP_SIZE] = {
-    {QMTCFG_WILL_RETAIN_DISABLE, "Don't retain"}, {QMTCFG_WILL_RETAIN_ENABLE, "Retain"}};
+    {QMTCFG_WILL_RETAIN_DISABLE, ENUM_DESC("Don't retain")},
+    {QMTCFG_WILL_RETAIN_ENABLE, ENUM_DESC("Retain")}};
 
 const enum_str_map_t QMTCFG_MSG_RECV_MODE_MAP[QMTCFG_MSG_RECV_MODE_MAP_SIZE] = {
-    {QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC, "Contained in URC"},
-    {QMTCFG_MSG_RECV_MODE_NOT_CONTAIN_IN_URC, "Not contained in URC"}};
+    {QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC, ENUM_DESC("Contained in URC")},
+    {QMTCFG_MSG_RECV_MODE_NOT_CONTAIN_IN_URC, ENUM_DESC("Not contained in URC")}};
 
 const enum_str_map_t QMTCFG_MSG_LEN_ENABLE_MAP[QMTCFG_MSG_LEN_ENABLE_MAP_SIZE] = {
-    {QMTCFG_MSG_LEN_DISABLE, "Length not contained"}, {QMTCFG_MSG_LEN_ENABLE, "Length contained"}};
+    {QMTCFG_MSG_LEN_DISABLE, ENUM_DESC("Length not contained")},
+    {QMTCFG_MSG_LEN_ENABLE, ENUM_DESC("Length contained")}};
 
 const enum_str_map_t QMTCFG_TIMEOUT_NOTICE_MAP[QMTCFG_TIMEOUT_NOTICE_MAP_SIZE] = {
-    {QMTCFG_TIMEOUT_NOTICE_DISABLE, "Do not report"}, {QMTCFG_TIMEOUT_NOTICE_ENABLE, "Report"}};
+    {QMTCFG_TIMEOUT_NOTICE_DISABLE, ENUM_DESC("Do not report")},
+    {QMTCFG_TIMEOUT_NOTICE_ENABLE, ENUM_DESC("Report")}};
 
 const enum_str_map_t QMTCFG_TYPE_MAP[QMTCFG_TYPE_MAP_SIZE] = {{QMTCFG_TYPE_VERSION, "version"},
                                                               {QMTCFG_TYPE_PDPCID, "pdpcid"},
@@ -50,24 +56,47 @@ const enum_str_map_t QMTCFG_TYPE_MAP[QMTCFG_TYPE_MAP_SIZE] = {{QMTCFG_TYPE_VERSI
                                                               {QMTCFG_TYPE_RECV_MODE, "recv/mode"},
                                                               {QMTCFG_TYPE_ALIAUTH, "aliauth"}};
 
-// Helper function to convert string to qmtcfg_type_t
-static esp_err_t str_to_qmtcfg_type(const char* str, qmtcfg_type_t* type)
+// "<type>" plus at most 5 parameters (will)
+#define QMTCFG_MAX_FIELDS 6
+
+// Split the rest of the line into 'fields' and return how many there are
+static size_t qmtcfg_split_line(at_tokenizer_t* tok, at_field_t* fields)
 {
-  if (NULL == str || NULL == type)
+  size_t num_fields = 0;
+  while (num_fields < QMTCFG_MAX_FIELDS && at_tokenizer_next(tok, &fields[num_fields]) == ESP_OK)
   {
-    return ESP_ERR_INVALID_ARG;
+    num_fields++;
   }
+  return num_fields;
+}
 
-  for (size_t i = 0; i < QMTCFG_TYPE_MAP_SIZE; i++)
+static bool qmtcfg_get_int(const at_field_t* fields, size_t num_fields, size_t idx, int32_t* value)
+{
+  return idx < num_fields && at_field_get_int(&fields[idx], value) == ESP_OK;
+}
+
+static bool qmtcfg_get_range(
+    const at_field_t* fields, size_t num_fields, size_t idx, int32_t* min, int32_t* max)
+{
+  return idx < num_fields && at_field_get_range(&fields[idx], min, max) == ESP_OK;
+}
+
+// Mark which of the values 0..count-1 are in the list at 'idx'. Left as is if there is no list
+static void qmtcfg_get_supported(const at_field_t* fields,
+                                 size_t            num_fields,
+                                 size_t            idx,
+                                 bool*             supported,
+                                 size_t            count)
+{
+  if (idx >= num_fields || fields[idx].type != AT_FIELD_LIST)
   {
-    if (0 == strcmp(str, QMTCFG_TYPE_MAP[i].string))
-    {
-      *type = (qmtcfg_type_t) QMTCFG_TYPE_MAP[i].value;
-      return ESP_OK;
-    }
+    return;
   }
 
-  return ESP_ERR_NOT_FOUND;
+  for (size_t i = 0; i < count; i++)
+  {
+    supported[i] = at_field_list_contains(&fields[idx], (int32_t) i);
+  }
 }
 
 static esp_err_t qmtcfg_test_parser(const char* response, void* parsed_data)
@@ -117,115 +146,110 @@ static esp_err_t qmtcfg_test_parser(const char* response, void* parsed_data)
   test_data->supports_msg_len_modes[QMTCFG_MSG_LEN_DISABLE]                   = true;
   test_data->supports_msg_len_modes[QMTCFG_MSG_LEN_ENABLE]                    = true;
 
-  // Find response lines
-  const char* version_line   = strstr(response, "+QMTCFG: \"version\"");
-  const char* pdpcid_line    = strstr(response, "+QMTCFG: \"pdpcid\"");
-  const char* ssl_line       = strstr(response, "+QMTCFG: \"ssl\"");
-  const char* keepalive_line = strstr(response, "+QMTCFG: \"keepalive\"");
-  const char* session_line   = strstr(response, "+QMTCFG: \"session\"");
-  const char* timeout_line   = strstr(response, "+QMTCFG: \"timeout\"");
-  const char* will_line      = strstr(response, "+QMTCFG: \"will\"");
-  const char* recv_mode_line = strstr(response, "+QMTCFG: \"recv/mode\"");
-
-  // Parse version line
-  if (version_line)
-  {
-    int min_idx = 0, max_idx = 0;
-    if (sscanf(version_line, "+QMTCFG: \"version\",(%d-%d)", &min_idx, &max_idx) == 2)
-    {
-      test_data->client_idx_min = (uint8_t) min_idx;
-      test_data->client_idx_max = (uint8_t) max_idx;
-    }
-  }
+  // One line per type: +QMTCFG: "<type>",(<client_idx range>),<parameter lists>...
+  at_tokenizer_t tok;
+  esp_err_t      err = at_tokenizer_init(&tok, response, "+QMTCFG: ");
 
-  // Parse pdpcid line
-  if (pdpcid_line)
+  for (; err == ESP_OK; err = at_tokenizer_next_line(&tok))
   {
-    int min_idx = 0, max_idx = 0, min_cid = 0, max_cid = 0;
-    if (sscanf(pdpcid_line,
-               "+QMTCFG: \"pdpcid\",(%d-%d),(%d-%d)",
-               &min_idx,
-               &max_idx,
-               &min_cid,
-               &max_cid) == 4)
-    {
-      test_data->pdp_cid_min = (uint8_t) min_cid;
-      test_data->pdp_cid_max = (uint8_t) max_cid;
-    }
-  }
+    at_field_t fields[QMTCFG_MAX_FIELDS];
+    size_t     num_fields = qmtcfg_split_line(&tok, fields);
+    int        type;
+    int32_t    min, max, min2, max2;
 
-  // Parse ssl line
-  if (ssl_line)
-  {
-    int  min_idx = 0, max_idx = 0, min_ctx = 0, max_ctx = 0;
-    char ssl_modes[32] = {0};
-    if (sscanf(ssl_line,
-               "+QMTCFG: \"ssl\",(%d-%d),(%[^)]),(%d-%d)",
-               &min_idx,
-               &max_idx,
-               ssl_modes,
-               &min_ctx,
-               &max_ctx) == 5)
+    if (num_fields == 0 ||
+        at_field_to_enum(&fields[0], QMTCFG_TYPE_MAP, QMTCFG_TYPE_MAP_SIZE, &type) != ESP_OK)
     {
-      test_data->ctx_index_min = (uint8_t) min_ctx;
-      test_data->ctx_index_max = (uint8_t) max_ctx;
-
-      // Parse SSL modes
-      test_data->supports_ssl_modes[QMTCFG_SSL_DISABLE] = (strchr(ssl_modes, '0') != NULL);
-      test_data->supports_ssl_modes[QMTCFG_SSL_ENABLE]  = (strchr(ssl_modes, '1') != NULL);
+      continue;
     }
-  }
 
-  // Parse keepalive line
-  if (keepalive_line)
-  {
-    int min_idx = 0, max_idx = 0, min_keep = 0, max_keep = 0;
-    if (sscanf(keepalive_line,
-               "+QMTCFG: \"keepalive\",(%d-%d),(%d-%d)",
-               &min_idx,
-               &max_idx,
-               &min_keep,
-               &max_keep) == 4)
+    switch (type)
     {
-      test_data->keep_alive_min = (uint16_t) min_keep;
-      test_data->keep_alive_max = (uint16_t) max_keep;
-    }
-  }
+      case QMTCFG_TYPE_VERSION:
+        if (qmtcfg_get_range(fields, num_fields, 1, &min, &max))
+        {
+          test_data->client_idx_min = (uint8_t) min;
+          test_data->client_idx_max = (uint8_t) max;
+        }
+        break;
 
-  // Parse session line
-  if (session_line)
-  {
-    char clean_session_modes[32] = {0};
-    if (strstr(session_line, "0") != NULL)
-    {
-      test_data->supports_clean_session_modes[QMTCFG_CLEAN_SESSION_DISABLE] = true;
-    }
-    if (strstr(session_line, "1") != NULL)
-    {
-      test_data->supports_clean_session_modes[QMTCFG_CLEAN_SESSION_ENABLE] = true;
-    }
-  }
+      case QMTCFG_TYPE_PDPCID:
+        if (qmtcfg_get_range(fields, num_fields, 2, &min, &max))
+        {
+          test_data->pdp_cid_min = (uint8_t) min;
+          test_data->pdp_cid_max = (uint8_t) max;
+        }
+        break;
 
-  // Parse timeout line
-  if (timeout_line)
-  {
-    int min_timeout = 0, max_timeout = 0, min_retry = 0, max_retry = 0;
-    if (sscanf(timeout_line,
-               "+QMTCFG: \"timeout\",(%*[^)]),(%d-%d),(%d-%d)",
-               &min_timeout,
-               &max_timeout,
-               &min_retry,
-               &max_retry) == 4)
-    {
-      test_data->pkt_timeout_min = (uint8_t) min_timeout;
-      test_data->pkt_timeout_max = (uint8_t) max_timeout;
-      test_data->retry_times_min = (uint8_t) min_retry;
-      test_data->retry_times_max = (uint8_t) max_retry;
+      case QMTCFG_TYPE_SSL:
+        qmtcfg_get_supported(
+            fields, num_fields, 2, test_data->supports_ssl_modes, QMTCFG_SSL_MODE_MAP_SIZE);
+        if (qmtcfg_get_range(fields, num_fields, 3, &min, &max))
+        {
+          test_data->ctx_index_min = (uint8_t) min;
+          test_data->ctx_index_max = (uint8_t) max;
+        }
+        break;
+
+      case QMTCFG_TYPE_KEEPALIVE:
+        if (qmtcfg_get_range(fields, num_fields, 2, &min, &max))
+        {
+          test_data->keep_alive_min = (uint16_t) min;
+          test_data->keep_alive_max = (uint16_t) max;
+        }
+        break;
+
+      case QMTCFG_TYPE_SESSION:
+        qmtcfg_get_supported(fields,
+                             num_fields,
+                             2,
+                             test_data->supports_clean_session_modes,
+                             QMTCFG_CLEAN_SESSION_MAP_SIZE);
+        break;
+
+      case QMTCFG_TYPE_TIMEOUT:
+        if (qmtcfg_get_range(fields, num_fields, 2, &min, &max) &&
+            qmtcfg_get_range(fields, num_fields, 3, &min2, &max2))
+        {
+          test_data->pkt_timeout_min = (uint8_t) min;
+          test_data->pkt_timeout_max = (uint8_t) max;
+          test_data->retry_times_min = (uint8_t) min2;
+          test_data->retry_times_max = (uint8_t) max2;
+        }
+        qmtcfg_get_supported(fields,
+                             num_fields,
+                             4,
+                             test_data->supports_timeout_notice_modes,
+                             QMTCFG_TIMEOUT_NOTICE_MAP_SIZE);
+        break;
+
+      case QMTCFG_TYPE_WILL:
+        qmtcfg_get_supported(
+            fields, num_fields, 2, test_data->supports_will_flags, QMTCFG_WILL_FLAG_MAP_SIZE);
+        qmtcfg_get_supported(
+            fields, num_fields, 3, test_data->supports_will_qos, QMTCFG_WILL_QOS_MAP_SIZE);
+        qmtcfg_get_supported(
+            fields, num_fields, 4, test_data->supports_will_retain, QMTCFG_WILL_RETAIN_MAP_SIZE);
+        break;
+
+      case QMTCFG_TYPE_RECV_MODE:
+        qmtcfg_get_supported(fields,
+                             num_fields,
+                             2,
+                             test_data->supports_msg_recv_modes,
+                             QMTCFG_MSG_RECV_MODE_MAP_SIZE);
+        qmtcfg_get_supported(fields,
+                             num_fields,
+                             3,
+                             test_data->supports_msg_len_modes,
+                             QMTCFG_MSG_LEN_ENABLE_MAP_SIZE);
+        break;
+
+      default:
+        break;
     }
   }
 
-  // TODO: The rest of the parsing would follow the same pattern
-
   return ESP_OK;
 }
 
@@ -240,95 +264,70 @@ static esp_err_t qmtcfg_write_parser(const char* response, void* parsed_data)
   qmtcfg_write_response_t* write_response = (qmtcfg_write_response_t*) parsed_data;
 
   // Find response start
-  const char* data_start = strstr(response, "+QMTCFG: \"");
-  if (NULL == data_start)
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+QMTCFG: ") != ESP_OK)
   {
     // No data response, only OK response
     // This typically means the command was a write that succeeded, not a query
     return ESP_OK;
   }
 
-  data_start += 10; // Skip "+QMTCFG: \""
-
-  // Extract type string
-  char   type_str[32] = {0};
-  size_t i            = 0;
-  while (data_start[i] != '"' && data_start[i] != '\0' && i < sizeof(type_str) - 1)
-  {
-    type_str[i] = data_start[i];
-    i++;
-  }
-  type_str[i] = '\0';
+  at_field_t fields[QMTCFG_MAX_FIELDS];
+  size_t     num_fields = qmtcfg_split_line(&tok, fields);
 
   // Check if we extracted a valid type string
-  if (i == 0 || data_start[i] != '"')
+  if (num_fields == 0 || fields[0].type != AT_FIELD_STRING || fields[0].len == 0)
   {
     ESP_LOGE(TAG, "Malformed response: missing or invalid type string");
     return ESP_ERR_INVALID_RESPONSE;
   }
 
   // Convert type string to enum
-  qmtcfg_type_t config_type;
-  if (str_to_qmtcfg_type(type_str, &config_type) != ESP_OK)
+  int type;
+  if (at_field_to_enum(&fields[0], QMTCFG_TYPE_MAP, QMTCFG_TYPE_MAP_SIZE, &type) != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid configuration type: %s", type_str);
+    ESP_LOGE(TAG, "Invalid configuration type: %.*s", (int) fields[0].len, fields[0].start);
     return ESP_ERR_INVALID_RESPONSE;
   }
 
-  write_response->type = config_type;
-
-  // Find parameters after the type
-  const char* params_start = data_start + i + 2; // Skip type string and "\","
-  if (*params_start != ',')
-  {
-    params_start--; // Adjust if there's no comma
-  }
+  qmtcfg_type_t config_type = (qmtcfg_type_t) type;
+  write_response->type      = config_type;
 
   // Parse parameters based on type
+  int32_t value;
   switch (config_type)
   {
     case QMTCFG_TYPE_VERSION:
     {
-      int version = 0;
-      if (sscanf(params_start, ",%d", &version) == 1)
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && (value == 3 || value == 4))
       {
-        if (version == 3 || version == 4)
-        {
-          write_response->response.version.version             = (qmtcfg_version_t) version;
-          write_response->response.version.present.has_version = true;
-        }
+        write_response->response.version.version             = (qmtcfg_version_t) value;
+        write_response->response.version.present.has_version = true;
       }
     }
     break;
 
     case QMTCFG_TYPE_PDPCID:
     {
-      int pdp_cid = 0;
-      if (sscanf(params_start, ",%d", &pdp_cid) == 1)
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && value >= 1 && value <= 16)
       {
-        if (pdp_cid >= 1 && pdp_cid <= 16)
-        {
-          write_response->response.pdpcid.pdp_cid             = (uint8_t) pdp_cid;
-          write_response->response.pdpcid.present.has_pdp_cid = true;
-        }
+        write_response->response.pdpcid.pdp_cid             = (uint8_t) value;
+        write_response->response.pdpcid.present.has_pdp_cid = true;
       }
     }
     break;
 
     case QMTCFG_TYPE_SSL:
     {
-      int ssl_enable = 0, ctx_index = 0;
-      int items = sscanf(params_start, ",%d,%d", &ssl_enable, &ctx_index);
-
-      if (items >= 1 && (ssl_enable == 0 || ssl_enable == 1))
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && (value == 0 || value == 1))
       {
-        write_response->response.ssl.ssl_enable             = (qmtcfg_ssl_mode_t) ssl_enable;
+        write_response->response.ssl.ssl_enable             = (qmtcfg_ssl_mode_t) value;
         write_response->response.ssl.present.has_ssl_enable = true;
       }
 
-      if (items >= 2 && ctx_index >= 0 && ctx_index <= 5)
+      if (qmtcfg_get_int(fields, num_fields, 2, &value) && value >= 0 && value <= 5)
       {
-        write_response->response.ssl.ctx_index             = (uint8_t) ctx_index;
+        write_response->response.ssl.ctx_index             = (uint8_t) value;
         write_response->response.ssl.present.has_ctx_index = true;
       }
     }
@@ -336,52 +335,41 @@ static esp_err_t qmtcfg_write_parser(const char* response, void* parsed_data)
 
     case QMTCFG_TYPE_KEEPALIVE:
     {
-      int keep_alive_time = 0;
-      if (sscanf(params_start, ",%d", &keep_alive_time) == 1)
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && value >= 0 && value <= 3600)
       {
-        if (keep_alive_time >= 0 && keep_alive_time <= 3600)
-        {
-          write_response->response.keepalive.keep_alive_time = (uint16_t) keep_alive_time;
-          write_response->response.keepalive.present.has_keep_alive_time = true;
-        }
+        write_response->response.keepalive.keep_alive_time             = (uint16_t) value;
+        write_response->response.keepalive.present.has_keep_alive_time = true;
       }
     }
     break;
 
     case QMTCFG_TYPE_SESSION:
     {
-      int clean_session = 0;
-      if (sscanf(params_start, ",%d", &clean_session) == 1)
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && (value == 0 || value == 1))
       {
-        if (clean_session == 0 || clean_session == 1)
-        {
-          write_response->response.session.clean_session = (qmtcfg_clean_session_t) clean_session;
-          write_response->response.session.present.has_clean_session = true;
-        }
+        write_response->response.session.clean_session = (qmtcfg_clean_session_t) value;
+        write_response->response.session.present.has_clean_session = true;
       }
     }
     break;
 
     case QMTCFG_TYPE_TIMEOUT:
     {
-      int pkt_timeout = 0, retry_times = 0, timeout_notice = 0;
-      int items = sscanf(params_start, ",%d,%d,%d", &pkt_timeout, &retry_times, &timeout_notice);
-
-      if (items >= 1 && pkt_timeout >= 1 && pkt_timeout <= 60)
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && value >= 1 && value <= 60)
       {
-        write_response->response.timeout.pkt_timeout             = (uint8_t) pkt_timeout;
+        write_response->response.timeout.pkt_timeout             = (uint8_t) value;
         write_response->response.timeout.present.has_pkt_timeout = true;
       }
 
-      if (items >= 2 && retry_times >= 0 && retry_times <= 10)
+      if (qmtcfg_get_int(fields, num_fields, 2, &value) && value >= 0 && value <= 10)
       {
-        write_response->response.timeout.retry_times             = (uint8_t) retry_times;
+        write_response->response.timeout.retry_times             = (uint8_t) value;
         write_response->response.timeout.present.has_retry_times = true;
       }
 
-      if (items >= 3 && (timeout_notice == 0 || timeout_notice == 1))
+      if (qmtcfg_get_int(fields, num_fields, 3, &value) && (value == 0 || value == 1))
       {
-        write_response->response.timeout.timeout_notice = (qmtcfg_timeout_notice_t) timeout_notice;
+        write_response->response.timeout.timeout_notice = (qmtcfg_timeout_notice_t) value;
         write_response->response.timeout.present.has_timeout_notice = true;
       }
     }
@@ -389,69 +377,44 @@ static esp_err_t qmtcfg_write_parser(const char* response, void* parsed_data)
 
     case QMTCFG_TYPE_WILL:
     {
-      int will_flag = 0, will_qos = 0, will_retain = 0;
-      if (sscanf(params_start, ",%d", &will_flag) == 1)
+      // +QMTCFG: "will",<will_fg>[,<will_qos>,<will_retain>,"<will_topic>","<will_msg>"]
+      qmtcfg_write_will_response_t* will = &write_response->response.will;
+      if (!qmtcfg_get_int(fields, num_fields, 1, &value))
+      {
+        break;
+      }
+      will->will_flag             = (qmtcfg_will_flag_t) value;
+      will->present.has_will_flag = true;
+
+      int32_t will_qos, will_retain;
+      if (value != QMTCFG_WILL_FLAG_REQUIRE || !qmtcfg_get_int(fields, num_fields, 2, &will_qos) ||
+          !qmtcfg_get_int(fields, num_fields, 3, &will_retain))
+      {
+        break;
+      }
+
+      if (will_qos >= 0 && will_qos <= 2)
+      {
+        will->will_qos             = (qmtcfg_will_qos_t) will_qos;
+        will->present.has_will_qos = true;
+      }
+
+      if (will_retain == 0 || will_retain == 1)
+      {
+        will->will_retain             = (qmtcfg_will_retain_t) will_retain;
+        will->present.has_will_retain = true;
+      }
+
+      // Topic and message are quoted strings - the message is only taken along with the topic
+      if (num_fields > 4 && fields[4].type == AT_FIELD_STRING &&
+          at_field_copy(&fields[4], will->will_topic, sizeof(will->will_topic)) == ESP_OK)
       {
-        write_response->response.will.will_flag             = (qmtcfg_will_flag_t) will_flag;
-        write_response->response.will.present.has_will_flag = true;
+        will->present.has_will_topic = true;
 
-        if (will_flag == 1)
+        if (num_fields > 5 && fields[5].type == AT_FIELD_STRING &&
+            at_field_copy(&fields[5], will->will_message, sizeof(will->will_message)) == ESP_OK)
         {
-          // Find parameters for will
-          const char* will_params = strchr(params_start + 1, ',');
-          if (will_params)
-          {
-            if (sscanf(will_params, ",%d,%d", &will_qos, &will_retain) == 2)
-            {
-              if (will_qos >= 0 && will_qos <= 2)
-              {
-                write_response->response.will.will_qos             = (qmtcfg_will_qos_t) will_qos;
-                write_response->response.will.present.has_will_qos = true;
-              }
-
-              if (will_retain == 0 || will_retain == 1)
-              {
-                write_response->response.will.will_retain = (qmtcfg_will_retain_t) will_retain;
-                write_response->response.will.present.has_will_retain = true;
-              }
-
-              // Extract topic and message - these are quoted strings
-              const char* topic_start = strstr(will_params, ",\"");
-              if (topic_start)
-              {
-                topic_start += 2; // Skip ,\"
-                const char* topic_end = strchr(topic_start, '"');
-                if (topic_end)
-                {
-                  size_t topic_len = topic_end - topic_start;
-                  if (topic_len < sizeof(write_response->response.will.will_topic))
-                  {
-                    strncpy(write_response->response.will.will_topic, topic_start, topic_len);
-                    write_response->response.will.will_topic[topic_len]  = '\0';
-                    write_response->response.will.present.has_will_topic = true;
-
-                    // Now look for message
-                    const char* msg_start = strstr(topic_end, ",\"");
-                    if (msg_start)
-                    {
-                      msg_start += 2; // Skip ,\"
-                      const char* msg_end = strchr(msg_start, '"');
-                      if (msg_end)
-                      {
-                        size_t msg_len = msg_end - msg_start;
-                        if (msg_len < sizeof(write_response->response.will.will_message))
-                        {
-                          strncpy(write_response->response.will.will_message, msg_start, msg_len);
-                          write_response->response.will.will_message[msg_len]    = '\0';
-                          write_response->response.will.present.has_will_message = true;
-                        }
-                      }
-                    }
-                  }
-                }
-              }
-            }
-          }
+          will->present.has_will_message = true;
         }
       }
     }
@@ -459,19 +422,15 @@ static esp_err_t qmtcfg_write_parser(const char* response, void* parsed_data)
 
     case QMTCFG_TYPE_RECV_MODE:
     {
-      int msg_recv_mode = 0, msg_len_enable = 0;
-      int items = sscanf(params_start, ",%d,%d", &msg_recv_mode, &msg_len_enable);
-
-      if (items >= 1 && (msg_recv_mode == 0 || msg_recv_mode == 1))
+      if (qmtcfg_get_int(fields, num_fields, 1, &value) && (value == 0 || value == 1))
       {
-        write_response->response.recv_mode.msg_recv_mode = (qmtcfg_msg_recv_mode_t) msg_recv_mode;
+        write_response->response.recv_mode.msg_recv_mode = (qmtcfg_msg_recv_mode_t) value;
         write_response->response.recv_mode.present.has_msg_recv_mode = true;
       }
 
-      if (items >= 2 && (msg_len_enable == 0 || msg_len_enable == 1))
+      if (qmtcfg_get_int(fields, num_fields, 2, &value) && (value == 0 || value == 1))
       {
-        write_response->response.recv_mode.msg_len_enable =
-            (qmtcfg_msg_len_enable_t) msg_len_enable;
+        write_response->response.recv_mode.msg_len_enable = (qmtcfg_msg_len_enable_t) value;
         write_response->response.recv_mode.present.has_msg_len_enable = true;
       }
     }
@@ -955,7 +914,7 @@ static esp_err_t qmtcfg_write_formatter(const void* params, char* buffer, size_t
 // AT command definition (at the bottom of the file as requested)
 const at_cmd_t AT_CMD_QMTCFG = {
     .name        = "QMTCFG",
-    .description = "Configure Optional Parameters of MQTT",
+    .description = AT_CMD_DESCRIPTION("Configure Optional Parameters of MQTT"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qmtcfg_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
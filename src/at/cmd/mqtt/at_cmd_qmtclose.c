@@ -10,8 +10,8 @@ static const char* TAG = "AT_CMD_QMTCLOSE";
 
 // Define the result code mapping array
 const enum_str_map_t QMTCLOSE_RESULT_MAP[QMTCLOSE_RESULT_MAP_SIZE] = {
-    {QMTCLOSE_RESULT_FAILED_TO_CLOSE, "Failed to close network"},
-    {QMTCLOSE_RESULT_CLOSE_SUCCESS, "Network closed successfully"}};
+    {QMTCLOSE_RESULT_FAILED_TO_CLOSE, ENUM_DESC("Failed to close network")},
+    {QMTCLOSE_RESULT_CLOSE_SUCCESS, ENUM_DESC("Network closed successfully")}};
 
 static esp_err_t qmtclose_test_parser(const char* response, void* parsed_data)
 {
@@ -142,7 +142,7 @@ static esp_err_t qmtclose_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTCLOSE
 const at_cmd_t AT_CMD_QMTCLOSE = {
     .name        = "QMTCLOSE",
-    .description = "Close a Network Connection for MQTT Client",
+    .description = AT_CMD_DESCRIPTION("Close a Network Connection for MQTT Client"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qmtclose_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
@@ -10,23 +10,24 @@ static const char* TAG = "AT_CMD_QMTCONN";
 
 // Define the mapping arrays
 const enum_str_map_t QMTCONN_RESULT_MAP[QMTCONN_RESULT_MAP_SIZE] = {
-    {QMTCONN_RESULT_SUCCESS, "Packet sent successfully and ACK received"},
-    {QMTCONN_RESULT_RETRANSMISSION, "Packet retransmission"},
-    {QMTCONN_RESULT_FAILED_TO_SEND, "Failed to send a packet"}};
+    {QMTCONN_RESULT_SUCCESS, ENUM_DESC("Packet sent successfully and ACK received")},
+    {QMTCONN_RESULT_RETRANSMISSION, ENUM_DESC("Packet retransmission")},
+    {QMTCONN_RESULT_FAILED_TO_SEND, ENUM_DESC("Failed to send a packet")}};
 
 const enum_str_map_t QMTCONN_STATE_MAP[QMTCONN_STATE_MAP_SIZE] = {
-    {QMTCONN_STATE_INITIALIZING, "MQTT is initializing"},
-    {QMTCONN_STATE_CONNECTING, "MQTT is connecting"},
-    {QMTCONN_STATE_CONNECTED, "MQTT is connected"},
-    {QMTCONN_STATE_DISCONNECTING, "MQTT is disconnecting"}};
+    {QMTCONN_STATE_INITIALIZING, ENUM_DESC("MQTT is initializing")},
+    {QMTCONN_STATE_CONNECTING, ENUM_DESC("MQTT is connecting")},
+    {QMTCONN_STATE_CONNECTED, ENUM_DESC("MQTT is connected")},
+    {QMTCONN_STATE_DISCONNECTING, ENUM_DESC("MQTT is disconnecting")}};
 
 const enum_str_map_t QMTCONN_RET_CODE_MAP[QMTCONN_RET_CODE_MAP_SIZE] = {
-    {QMTCONN_RET_CODE_ACCEPTED, "Connection Accepted"},
-    {QMTCONN_RET_CODE_UNACCEPTABLE_PROTOCOL, "Connection Refused: Unacceptable Protocol Version"},
-    {QMTCONN_RET_CODE_IDENTIFIER_REJECTED, "Connection Refused: Identifier Rejected"},
-    {QMTCONN_RET_CODE_SERVER_UNAVAILABLE, "Connection Refused: Server Unavailable"},
-    {QMTCONN_RET_CODE_BAD_CREDENTIALS, "Connection Refused: Bad Username or Password"},
-    {QMTCONN_RET_CODE_NOT_AUTHORIZED, "Connection Refused: Not Authorized"}};
+    {QMTCONN_RET_CODE_ACCEPTED, ENUM_DESC("Connection Accepted")},
+    {QMTCONN_RET_CODE_UNACCEPTABLE_PROTOCOL,
+     ENUM_DESC("Connection Refused: Unacceptable Protocol Version")},
+    {QMTCONN_RET_CODE_IDENTIFIER_REJECTED, ENUM_DESC("Connection Refused: Identifier Rejected")},
+    {QMTCONN_RET_CODE_SERVER_UNAVAILABLE, ENUM_DESC("Connection Refused: Server Unavailable")},
+    {QMTCONN_RET_CODE_BAD_CREDENTIALS, ENUM_DESC("Connection Refused: Bad Username or Password")},
+    {QMTCONN_RET_CODE_NOT_AUTHORIZED, ENUM_DESC("Connection Refused: Not Authorized")}};
 
 static esp_err_t qmtconn_test_parser(const char* response, void* parsed_data)
 {
@@ -289,7 +290,7 @@ static esp_err_t qmtconn_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTCONN
 const at_cmd_t AT_CMD_QMTCONN = {
     .name        = "QMTCONN",
-    .description = "Connect a Client to MQTT Server",
+    .description = AT_CMD_DESCRIPTION("Connect a Client to MQTT Server"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qmtconn_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
@@ -10,8 +10,8 @@ static const char* TAG = "AT_CMD_QMTDISC";
 
 // Define the result code mapping array
 const enum_str_map_t QMTDISC_RESULT_MAP[QMTDISC_RESULT_MAP_SIZE] = {
-    {QMTDISC_RESULT_SUCCESS, "Disconnect message sent successfully"},
-    {QMTDISC_RESULT_FAILED_TO_SEND, "Failed to send disconnect message"}};
+    {QMTDISC_RESULT_SUCCESS, ENUM_DESC("Disconnect message sent successfully")},
+    {QMTDISC_RESULT_FAILED_TO_SEND, ENUM_DESC("Failed to send disconnect message")}};
 
 static esp_err_t qmtdisc_test_parser(const char* response, void* parsed_data)
 {
@@ -142,7 +142,7 @@ static esp_err_t qmtdisc_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTDISC
 const at_cmd_t AT_CMD_QMTDISC = {
     .name        = "QMTDISC",
-    .description = "Disconnect a Client from MQTT Server",
+    .description = AT_CMD_DESCRIPTION("Disconnect a Client from MQTT Server"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qmtdisc_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
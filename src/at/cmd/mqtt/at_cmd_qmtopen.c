@@ -10,13 +10,13 @@ static const char* TAG = "AT_CMD_QMTOPEN";
 
 // Define the result code mapping array
 const enum_str_map_t QMTOPEN_RESULT_MAP[QMTOPEN_RESULT_MAP_SIZE] = {
-    {QMTOPEN_RESULT_FAILED_TO_OPEN, "Failed to open network"},
-    {QMTOPEN_RESULT_OPEN_SUCCESS, "Network opened successfully"},
-    {QMTOPEN_RESULT_WRONG_PARAMETER, "Wrong parameter"},
-    {QMTOPEN_RESULT_MQTT_ID_OCCUPIED, "MQTT client identifier is occupied"},
-    {QMTOPEN_RESULT_FAILED_ACTIVATE_PDP, "Failed to activate PDP"},
-    {QMTOPEN_RESULT_FAILED_PARSE_DOMAIN, "Failed to parse domain name"},
-    {QMTOPEN_RESULT_NETWORK_CONN_ERROR, "Network connection error"}};
+    {QMTOPEN_RESULT_FAILED_TO_OPEN, ENUM_DESC("Failed to open network")},
+    {QMTOPEN_RESULT_OPEN_SUCCESS, ENUM_DESC("Network opened successfully")},
+    {QMTOPEN_RESULT_WRONG_PARAMETER, ENUM_DESC("Wrong parameter")},
+    {QMTOPEN_RESULT_MQTT_ID_OCCUPIED, ENUM_DESC("MQTT client identifier is occupied")},
+    {QMTOPEN_RESULT_FAILED_ACTIVATE_PDP, ENUM_DESC("Failed to activate PDP")},
+    {QMTOPEN_RESULT_FAILED_PARSE_DOMAIN, ENUM_DESC("Failed to parse domain name")},
+    {QMTOPEN_RESULT_NETWORK_CONN_ERROR, ENUM_DESC("Network connection error")}};
 
 static esp_err_t qmtopen_read_parser(const char* response, void* parsed_data)
 {
@@ -194,7 +194,7 @@ static esp_err_t qmtopen_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTOPEN
 const at_cmd_t AT_CMD_QMTOPEN = {
     .name        = "QMTOPEN",
-    .description = "Open a Network Connection for MQTT Client",
+    .description = AT_CMD_DESCRIPTION("Open a Network Connection for MQTT Client"),
     .type_info   = {[AT_CMD_TYPE_TEST] =
                         AT_CMD_TYPE_NOT_IMPLEMENTED, // As requested, skipping test command
                     [AT_CMD_TYPE_READ]    = {.parser        = qmtopen_read_parser,
@@ -10,17 +10,18 @@ static const char* TAG = "AT_CMD_QMTPUB";
 
 // Define the mapping arrays
 const enum_str_map_t QMTPUB_RESULT_MAP[QMTPUB_RESULT_MAP_SIZE] = {
-    {QMTPUB_RESULT_SUCCESS, "Packet sent successfully and ACK received"},
-    {QMTPUB_RESULT_RETRANSMISSION, "Packet retransmission"},
-    {QMTPUB_RESULT_FAILED_TO_SEND, "Failed to send a packet"}};
+    {QMTPUB_RESULT_SUCCESS, ENUM_DESC("Packet sent successfully and ACK received")},
+    {QMTPUB_RESULT_RETRANSMISSION, ENUM_DESC("Packet retransmission")},
+    {QMTPUB_RESULT_FAILED_TO_SEND, ENUM_DESC("Failed to send a packet")}};
 
 const enum_str_map_t QMTPUB_QOS_MAP[QMTPUB_QOS_MAP_SIZE] = {
-    {QMTPUB_QOS_AT_MOST_ONCE, "At most once"},
-    {QMTPUB_QOS_AT_LEAST_ONCE, "At least once"},
-    {QMTPUB_QOS_EXACTLY_ONCE, "Exactly once"}};
+    {QMTPUB_QOS_AT_MOST_ONCE, ENUM_DESC("At most once")},
+    {QMTPUB_QOS_AT_LEAST_ONCE, ENUM_DESC("At least once")},
+    {QMTPUB_QOS_EXACTLY_ONCE, ENUM_DESC("Exactly once")}};
 
 const enum_str_map_t QMTPUB_RETAIN_MAP[QMTPUB_RETAIN_MAP_SIZE] = {
-    {QMTPUB_RETAIN_DISABLED, "Do not retain"}, {QMTPUB_RETAIN_ENABLED, "Retain message"}};
+    {QMTPUB_RETAIN_DISABLED, ENUM_DESC("Do not retain")},
+    {QMTPUB_RETAIN_ENABLED, ENUM_DESC("Retain message")}};
 
 static esp_err_t qmtpub_write_formatter(const void* params, char* buffer, size_t buffer_size)
 {
@@ -184,7 +185,7 @@ static esp_err_t qmtpub_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTPUB
 const at_cmd_t AT_CMD_QMTPUB = {
     .name        = "QMTPUB",
-    .description = "Publish Messages to MQTT Server",
+    .description = AT_CMD_DESCRIPTION("Publish Messages to MQTT Server"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
                     [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
                     [AT_CMD_TYPE_WRITE]   = {.parser        = qmtpub_write_parser,
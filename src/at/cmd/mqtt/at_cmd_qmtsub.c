@@ -11,14 +11,14 @@ static const char* TAG = "AT_CMD_QMTSUB";
 
 // Define the mapping arrays
 const enum_str_map_t QMTSUB_RESULT_MAP[QMTSUB_RESULT_MAP_SIZE] = {
-    {QMTSUB_RESULT_SUCCESS, "Packet sent successfully and ACK received"},
-    {QMTSUB_RESULT_RETRANSMISSION, "Packet retransmission"},
-    {QMTSUB_RESULT_FAILED_TO_SEND, "Failed to send a packet"}};
+    {QMTSUB_RESULT_SUCCESS, ENUM_DESC("Packet sent successfully and ACK received")},
+    {QMTSUB_RESULT_RETRANSMISSION, ENUM_DESC("Packet retransmission")},
+    {QMTSUB_RESULT_FAILED_TO_SEND, ENUM_DESC("Failed to send a packet")}};
 
 const enum_str_map_t QMTSUB_QOS_MAP[QMTSUB_QOS_MAP_SIZE] = {
-    {QMTSUB_QOS_AT_MOST_ONCE, "At most once"},
-    {QMTSUB_QOS_AT_LEAST_ONCE, "At least once"},
-    {QMTSUB_QOS_EXACTLY_ONCE, "Exactly once"}};
+    {QMTSUB_QOS_AT_MOST_ONCE, ENUM_DESC("At most once")},
+    {QMTSUB_QOS_AT_LEAST_ONCE, ENUM_DESC("At least once")},
+    {QMTSUB_QOS_EXACTLY_ONCE, ENUM_DESC("Exactly once")}};
 
 static esp_err_t qmtsub_test_parser(const char* response, void* parsed_data)
 {
@@ -263,7 +263,7 @@ static esp_err_t qmtsub_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTSUB
 const at_cmd_t AT_CMD_QMTSUB = {
     .name        = "QMTSUB",
-    .description = "Subscribe to Topics",
+    .description = AT_CMD_DESCRIPTION("Subscribe to Topics"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qmtsub_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
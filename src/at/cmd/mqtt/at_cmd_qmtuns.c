@@ -10,9 +10,9 @@ static const char* TAG = "AT_CMD_QMTUNS";
 
 // Define the mapping arrays
 const enum_str_map_t QMTUNS_RESULT_MAP[QMTUNS_RESULT_MAP_SIZE] = {
-    {QMTUNS_RESULT_SUCCESS, "Packet sent successfully and ACK received"},
-    {QMTUNS_RESULT_RETRANSMISSION, "Packet retransmission"},
-    {QMTUNS_RESULT_FAILED_TO_SEND, "Failed to send a packet"}};
+    {QMTUNS_RESULT_SUCCESS, ENUM_DESC("Packet sent successfully and ACK received")},
+    {QMTUNS_RESULT_RETRANSMISSION, ENUM_DESC("Packet retransmission")},
+    {QMTUNS_RESULT_FAILED_TO_SEND, ENUM_DESC("Failed to send a packet")}};
 
 static esp_err_t qmtuns_test_parser(const char* response, void* parsed_data)
 {
@@ -219,7 +219,7 @@ static esp_err_t qmtuns_write_parser(const char* response, void* parsed_data)
 // Command definition for QMTUNS
 const at_cmd_t AT_CMD_QMTUNS = {
     .name        = "QMTUNS",
-    .description = "Unsubscribe from Topics",
+    .description = AT_CMD_DESCRIPTION("Unsubscribe from Topics"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qmtuns_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
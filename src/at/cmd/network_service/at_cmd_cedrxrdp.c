@@ -0,0 +1,71 @@
+#include "at_cmd_cedrxrdp.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_CEDRXRDP";
+
+static esp_err_t cedrxrdp_execute_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cedrxrdp_execute_response_t* exec_data = (cedrxrdp_execute_response_t*) parsed_data;
+  memset(exec_data, 0, sizeof(cedrxrdp_execute_response_t));
+
+  // Format: +CEDRXRDP: <AcT-type>[,<Requested_eDRX_value>[,<NW-provided_eDRX_value>
+  //                    [,<Paging_time_window>]]]
+  at_tokenizer_t tok;
+  at_field_t     field;
+  int32_t        act_type;
+  if (at_tokenizer_init(&tok, response, "+CEDRXRDP: ") != ESP_OK ||
+      at_tokenizer_next(&tok, &field) != ESP_OK || at_field_get_int(&field, &act_type) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse CEDRXRDP response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  exec_data->act_type = (cedrxs_act_type_t) act_type;
+
+  // Each value is only there if the one before it is
+  if (at_tokenizer_next(&tok, &field) != ESP_OK ||
+      cedrxs_field_to_value(&field, &exec_data->requested_edrx_value) != ESP_OK)
+  {
+    return ESP_OK;
+  }
+  exec_data->present.has_requested_edrx_value = true;
+
+  if (at_tokenizer_next(&tok, &field) != ESP_OK ||
+      cedrxs_field_to_value(&field, &exec_data->nw_edrx_value) != ESP_OK)
+  {
+    return ESP_OK;
+  }
+  exec_data->present.has_nw_edrx_value = true;
+
+  if (at_tokenizer_next(&tok, &field) == ESP_OK &&
+      cedrxs_field_to_value(&field, &exec_data->paging_time_window) == ESP_OK)
+  {
+    exec_data->present.has_paging_time_window = true;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_CEDRXRDP = {
+    .name        = "CEDRXRDP",
+    .description = AT_CMD_DESCRIPTION("eDRX Read Dynamic Parameters"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_EXECUTE] = {.parser        = cedrxrdp_execute_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED}},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,251 @@
+#include "at_cmd_cedrxs.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_CEDRXS";
+
+const enum_str_map_t CEDRXS_MODE_MAP[CEDRXS_MODE_MAP_SIZE] = {
+    {CEDRXS_MODE_DISABLE, ENUM_DESC("Disable eDRX")},
+    {CEDRXS_MODE_ENABLE, ENUM_DESC("Enable eDRX")},
+    {CEDRXS_MODE_ENABLE_WITH_URC, ENUM_DESC("Enable eDRX and URC")},
+    {CEDRXS_MODE_DISABLE_AND_DISCARD, ENUM_DESC("Disable eDRX and discard params")}};
+
+const enum_str_map_t CEDRXS_ACT_TYPE_MAP[CEDRXS_ACT_TYPE_MAP_SIZE] = {
+    {CEDRXS_ACT_TYPE_NOT_USED, ENUM_DESC("Not using eDRX")},
+    {CEDRXS_ACT_TYPE_EMTC, ENUM_DESC("eMTC")},
+    {CEDRXS_ACT_TYPE_NBIOT, ENUM_DESC("NB-IoT")}};
+
+// eDRX cycle length in ms, indexed by the 4 bit eDRX value (WB-S1 mode)
+static const uint32_t EDRX_CYCLE_MS[CEDRXS_VALUE_MAX + 1] = {5120,
+                                                             10240,
+                                                             20480,
+                                                             40960,
+                                                             61440,
+                                                             81920,
+                                                             102400,
+                                                             122880,
+                                                             143360,
+                                                             163840,
+                                                             327680,
+                                                             655360,
+                                                             1310720,
+                                                             2621440,
+                                                             5242880,
+                                                             10485760};
+
+// NB-S1 mode only uses a subset of the values
+static bool cedrxs_value_is_used(cedrxs_act_type_t act_type, uint8_t edrx_value)
+{
+  if (edrx_value > CEDRXS_VALUE_MAX)
+  {
+    return false;
+  }
+
+  if (act_type == CEDRXS_ACT_TYPE_NBIOT)
+  {
+    return !(edrx_value == 0 || edrx_value == 1 || edrx_value == 4 || edrx_value == 6 ||
+             edrx_value == 7 || edrx_value == 8);
+  }
+
+  return true;
+}
+
+uint32_t cedrxs_value_to_cycle_ms(cedrxs_act_type_t act_type, uint8_t edrx_value)
+{
+  if (!cedrxs_value_is_used(act_type, edrx_value))
+  {
+    return 0;
+  }
+  return EDRX_CYCLE_MS[edrx_value];
+}
+
+esp_err_t
+cedrxs_cycle_ms_to_value(cedrxs_act_type_t act_type, uint32_t cycle_ms, uint8_t* edrx_value)
+{
+  if (NULL == edrx_value ||
+      (act_type != CEDRXS_ACT_TYPE_EMTC && act_type != CEDRXS_ACT_TYPE_NBIOT))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Table is ascending - the first cycle that is not shorter than the request
+  for (uint8_t value = 0; value <= CEDRXS_VALUE_MAX; value++)
+  {
+    if (cedrxs_value_is_used(act_type, value) && EDRX_CYCLE_MS[value] >= cycle_ms)
+    {
+      *edrx_value = value;
+      return ESP_OK;
+    }
+  }
+
+  ESP_LOGE(TAG, "eDRX cycle of %lu ms is too long", (unsigned long) cycle_ms);
+  return ESP_ERR_INVALID_ARG;
+}
+
+uint32_t cedrxs_ptw_to_ms(cedrxs_act_type_t act_type, uint8_t ptw_value)
+{
+  if (ptw_value > CEDRXS_VALUE_MAX)
+  {
+    return 0;
+  }
+  // PTW is (value + 1) * 1.28 s for WB-S1, and (value + 1) * 2.56 s for NB-S1
+  return (ptw_value + 1U) * ((act_type == CEDRXS_ACT_TYPE_NBIOT) ? 2560U : 1280U);
+}
+
+esp_err_t cedrxs_bits_to_value(const char* bits, uint8_t* value)
+{
+  if (NULL == bits || NULL == value)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint8_t result = 0;
+  for (int bit = 0; bit < CEDRXS_VALUE_BITS_LEN; bit++)
+  {
+    if (bits[bit] != '0' && bits[bit] != '1')
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    result = (uint8_t) ((result << 1) | (bits[bit] - '0'));
+  }
+
+  *value = result;
+  return ESP_OK;
+}
+
+esp_err_t cedrxs_field_to_value(const at_field_t* field, uint8_t* value)
+{
+  if (NULL == field || NULL == value)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  char bits[CEDRXS_VALUE_STR_SIZE];
+  if (field->len != CEDRXS_VALUE_BITS_LEN || at_field_copy(field, bits, sizeof(bits)) != ESP_OK)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  return cedrxs_bits_to_value(bits, value);
+}
+
+static esp_err_t cedrxs_read_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cedrxs_read_response_t* read_data = (cedrxs_read_response_t*) parsed_data;
+  memset(read_data, 0, sizeof(cedrxs_read_response_t));
+
+  // Format (one line per AcT): +CEDRXS: <AcT-type>,<Requested_eDRX_value>
+  at_tokenizer_t tok;
+  esp_err_t      err = at_tokenizer_init(&tok, response, "+CEDRXS: ");
+  for (; err == ESP_OK && read_data->num_settings < CEDRXS_MAX_ACT_TYPES;
+       err = at_tokenizer_next_line(&tok))
+  {
+    at_field_t        act_field, bits_field;
+    int32_t           act_type;
+    cedrxs_setting_t* setting = &read_data->settings[read_data->num_settings];
+    if (at_tokenizer_next(&tok, &act_field) == ESP_OK &&
+        at_field_get_int(&act_field, &act_type) == ESP_OK &&
+        at_tokenizer_next(&tok, &bits_field) == ESP_OK &&
+        cedrxs_field_to_value(&bits_field, &setting->edrx_value) == ESP_OK)
+    {
+      setting->act_type = (cedrxs_act_type_t) act_type;
+      read_data->num_settings++;
+    }
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t cedrxs_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const cedrxs_write_params_t* write_params = (const cedrxs_write_params_t*) params;
+  int                          written      = 0;
+
+  if (write_params->mode > CEDRXS_MODE_DISABLE_AND_DISCARD)
+  {
+    ESP_LOGE(TAG, "Invalid mode: %d", write_params->mode);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_act_type && write_params->act_type != CEDRXS_ACT_TYPE_EMTC &&
+      write_params->act_type != CEDRXS_ACT_TYPE_NBIOT)
+  {
+    ESP_LOGE(TAG, "Invalid AcT type: %d", write_params->act_type);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_edrx_value)
+  {
+    if (!write_params->present.has_act_type ||
+        !cedrxs_value_is_used(write_params->act_type, write_params->edrx_value))
+    {
+      ESP_LOGE(TAG, "Invalid eDRX value: %d", write_params->edrx_value);
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    char bits[CEDRXS_VALUE_STR_SIZE];
+    for (int bit = 0; bit < CEDRXS_VALUE_BITS_LEN; bit++)
+    {
+      bits[bit] = (write_params->edrx_value & (0x8 >> bit)) ? '1' : '0';
+    }
+    bits[CEDRXS_VALUE_BITS_LEN] = '\0';
+
+    written = snprintf(buffer,
+                       buffer_size,
+                       "=%d,%d,\"%s\"",
+                       write_params->mode,
+                       write_params->act_type,
+                       bits);
+  }
+  else if (write_params->present.has_act_type)
+  {
+    written = snprintf(buffer, buffer_size, "=%d,%d", write_params->mode, write_params->act_type);
+  }
+  else
+  {
+    written = snprintf(buffer, buffer_size, "=%d", write_params->mode);
+  }
+
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    ESP_LOGE(TAG, "Buffer too small for CEDRXS write command");
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_CEDRXS = {
+    .name        = "CEDRXS",
+    .description = AT_CMD_DESCRIPTION("e-I-DRX Setting"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = cedrxs_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_OPTIONAL},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = cedrxs_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,153 @@
+#include "at_cmd_cereg.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_CEREG";
+
+const enum_str_map_t CEREG_N_MAP[CEREG_N_MAP_SIZE] = {
+    {CEREG_N_DISABLE_URC, ENUM_DESC("Disable URC")},
+    {CEREG_N_ENABLE_URC, ENUM_DESC("Enable URC")},
+    {CEREG_N_ENABLE_URC_LOCATION, ENUM_DESC("Enable URC with location")},
+    {CEREG_N_ENABLE_URC_CAUSE, ENUM_DESC("Enable URC with location and cause")},
+    {CEREG_N_ENABLE_URC_PSM, ENUM_DESC("Enable URC with location and PSM timers")},
+    {CEREG_N_ENABLE_URC_PSM_CAUSE, ENUM_DESC("Enable URC with location, cause and PSM timers")}};
+
+const enum_str_map_t CEREG_STAT_MAP[CEREG_STAT_MAP_SIZE] = {
+    {CEREG_STAT_NOT_SEARCHING, ENUM_DESC("Not registered, not searching")},
+    {CEREG_STAT_HOME, ENUM_DESC("Registered, home network")},
+    {CEREG_STAT_SEARCHING, ENUM_DESC("Not registered, searching")},
+    {CEREG_STAT_DENIED, ENUM_DESC("Registration denied")},
+    {CEREG_STAT_UNKNOWN, ENUM_DESC("Unknown")},
+    {CEREG_STAT_ROAMING, ENUM_DESC("Registered, roaming")}};
+
+// Field indices of the read response
+// +CEREG: <n>,<stat>[,[<tac>],[<ci>],[<AcT>][,[<cause_type>],[<reject_cause>]
+//         [,[<Active-Time>],[<Periodic-TAU>]]]]
+#define CEREG_FIELD_TAC 2
+#define CEREG_FIELD_CI 3
+#define CEREG_FIELD_ACT 4
+#define CEREG_FIELD_ACTIVE_TIME 7
+#define CEREG_FIELD_PERIODIC_TAU 8
+#define CEREG_NUM_FIELDS 9
+
+// Copy the (optionally quoted) field at 'field_idx' into 'out'.
+// Returns false if the field does not exist or is empty
+static bool
+cereg_copy_field(const at_field_t* fields, size_t num_fields, int field_idx, char* out, size_t size)
+{
+  return (size_t) field_idx < num_fields && fields[field_idx].len > 0 &&
+         at_field_copy(&fields[field_idx], out, size) == ESP_OK;
+}
+
+static esp_err_t cereg_read_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cereg_read_response_t* read_data = (cereg_read_response_t*) parsed_data;
+  memset(read_data, 0, sizeof(cereg_read_response_t));
+
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+CEREG: ") != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to find +CEREG: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  at_field_t fields[CEREG_NUM_FIELDS];
+  size_t     num_fields = 0;
+  while (num_fields < CEREG_NUM_FIELDS && at_tokenizer_next(&tok, &fields[num_fields]) == ESP_OK)
+  {
+    num_fields++;
+  }
+
+  int32_t n, stat;
+  if (num_fields < 2 || at_field_get_int(&fields[0], &n) != ESP_OK ||
+      at_field_get_int(&fields[1], &stat) != ESP_OK || n < CEREG_N_DISABLE_URC ||
+      n > CEREG_N_ENABLE_URC_PSM_CAUSE || stat < CEREG_STAT_NOT_SEARCHING ||
+      stat > CEREG_STAT_ROAMING)
+  {
+    ESP_LOGE(TAG, "Failed to parse CEREG read response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  read_data->n    = (cereg_n_t) n;
+  read_data->stat = (cereg_stat_t) stat;
+
+  read_data->present.has_tac = cereg_copy_field(
+      fields, num_fields, CEREG_FIELD_TAC, read_data->tac, sizeof(read_data->tac));
+  read_data->present.has_ci =
+      cereg_copy_field(fields, num_fields, CEREG_FIELD_CI, read_data->ci, sizeof(read_data->ci));
+
+  int32_t act;
+  if (num_fields > CEREG_FIELD_ACT && at_field_get_int(&fields[CEREG_FIELD_ACT], &act) == ESP_OK &&
+      (act == CEREG_ACT_EMTC || act == CEREG_ACT_NBIOT))
+  {
+    read_data->act             = (cereg_act_t) act;
+    read_data->present.has_act = true;
+  }
+
+  read_data->present.has_active_time  = cereg_copy_field(fields,
+                                                        num_fields,
+                                                        CEREG_FIELD_ACTIVE_TIME,
+                                                        read_data->active_time,
+                                                        sizeof(read_data->active_time));
+  read_data->present.has_periodic_tau = cereg_copy_field(fields,
+                                                         num_fields,
+                                                         CEREG_FIELD_PERIODIC_TAU,
+                                                         read_data->periodic_tau,
+                                                         sizeof(read_data->periodic_tau));
+
+  return ESP_OK;
+}
+
+static esp_err_t cereg_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const cereg_write_params_t* write_params = (const cereg_write_params_t*) params;
+
+  if (write_params->n > CEREG_N_ENABLE_URC_PSM_CAUSE)
+  {
+    ESP_LOGE(TAG, "Invalid n: %d", write_params->n);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written = snprintf(buffer, buffer_size, "=%d", write_params->n);
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_CEREG = {
+    .name        = "CEREG",
+    .description = AT_CMD_DESCRIPTION("EPS Network Registration Status"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = cereg_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = cereg_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
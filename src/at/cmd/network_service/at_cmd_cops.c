@@ -1,33 +1,36 @@
 #include "at_cmd_cops.h"
 
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
 
 #include <esp_log.h>
-#include <string.h> // for memset, strstr, strncpy
+#include <string.h> // for memset, strcspn
 
 static const char* TAG = "AT_CMD_COPS";
 
 // Define enum-to-string mappings
 const enum_str_map_t COPS_STAT_MAP[COPS_STAT_MAP_SIZE] = {
-    {COPS_STAT_UNKNOWN, "Unknown"},
-    {COPS_STAT_OPERATOR_AVAILABLE, "Operator available"},
-    {COPS_STAT_CURRENT_OPERATOR, "Current operator"},
-    {COPS_STAT_OPERATOR_FORBIDDEN, "Operator forbidden"}};
+    {COPS_STAT_UNKNOWN, ENUM_DESC("Unknown")},
+    {COPS_STAT_OPERATOR_AVAILABLE, ENUM_DESC("Operator available")},
+    {COPS_STAT_CURRENT_OPERATOR, ENUM_DESC("Current operator")},
+    {COPS_STAT_OPERATOR_FORBIDDEN, ENUM_DESC("Operator forbidden")}};
 
 const enum_str_map_t COPS_MODE_MAP[COPS_MODE_MAP_SIZE] = {
-    {COPS_MODE_AUTO, "Automatic mode"},
-    {COPS_MODE_MANUAL, "Manual operator selection"},
-    {COPS_MODE_DEREGISTER, "Manual deregister from network"},
-    {COPS_MODE_SET_FORMAT, "Set only format"},
-    {COPS_MODE_MANUAL_AUTO, "Manual/automatic selection"}};
+    {COPS_MODE_AUTO, ENUM_DESC("Automatic mode")},
+    {COPS_MODE_MANUAL, ENUM_DESC("Manual operator selection")},
+    {COPS_MODE_DEREGISTER, ENUM_DESC("Manual deregister from network")},
+    {COPS_MODE_SET_FORMAT, ENUM_DESC("Set only format")},
+    {COPS_MODE_MANUAL_AUTO, ENUM_DESC("Manual/automatic selection")}};
 
 const enum_str_map_t COPS_FORMAT_MAP[COPS_FORMAT_MAP_SIZE] = {
-    {COPS_FORMAT_LONG_ALPHA, "Long format alphanumeric"},
-    {COPS_FORMAT_SHORT_ALPHA, "Short format alphanumeric"},
-    {COPS_FORMAT_NUMERIC, "Numeric"}};
+    {COPS_FORMAT_LONG_ALPHA, ENUM_DESC("Long format alphanumeric")},
+    {COPS_FORMAT_SHORT_ALPHA, ENUM_DESC("Short format alphanumeric")},
+    {COPS_FORMAT_NUMERIC, ENUM_DESC("Numeric")}};
 
 const enum_str_map_t COPS_ACT_MAP[COPS_ACT_MAP_SIZE] = {
-    {COPS_ACT_GSM, "GSM"}, {COPS_ACT_EMTC, "eMTC"}, {COPS_ACT_NB_IOT, "NB-IoT"}};
+    {COPS_ACT_GSM, ENUM_DESC("GSM")},
+    {COPS_ACT_EMTC, ENUM_DESC("eMTC")},
+    {COPS_ACT_NB_IOT, ENUM_DESC("NB-IoT")}};
 
 static esp_err_t cops_read_parser(const char* response, void* parsed_data)
 {
@@ -40,63 +43,183 @@ static esp_err_t cops_read_parser(const char* response, void* parsed_data)
   cops_read_response_t* read_data = (cops_read_response_t*) parsed_data;
   memset(read_data, 0, sizeof(cops_read_response_t));
 
-  // Find response start
-  const char* start = strstr(response, "+COPS: ");
-  if (!start)
+  // Format: +COPS: <mode>[,<format>,<oper>[,<AcT>]]
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+COPS: ") != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to find +COPS: in response");
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 7; // Skip "+COPS: "
 
-  int  mode, format, act;
-  char operator_name[64] = {0};
+  // Mode is always present
+  at_field_t field;
+  int32_t    value;
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || at_field_get_int(&field, &value) != ESP_OK ||
+      value < COPS_MODE_AUTO || value > COPS_MODE_MANUAL_AUTO)
+  {
+    ESP_LOGE(TAG, "Failed to parse COPS read response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  read_data->mode             = (cops_mode_t) value;
+  read_data->present.has_mode = true;
 
-  // Try to parse with different possible formats
-  // First try with all fields
-  int matched = sscanf(start, "%d,%d,\"%63[^\"]\",%d", &mode, &format, operator_name, &act);
+  // Format and operator
+  if (at_tokenizer_next(&tok, &field) != ESP_OK)
+  {
+    return ESP_OK;
+  }
+  if (at_field_get_int(&field, &value) == ESP_OK && value >= COPS_FORMAT_LONG_ALPHA &&
+      value <= COPS_FORMAT_NUMERIC)
+  {
+    read_data->format             = (cops_format_t) value;
+    read_data->present.has_format = true;
+  }
 
-  // Mode is always present
-  if (matched >= 1)
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || field.type != AT_FIELD_STRING)
+  {
+    return ESP_OK;
+  }
+  if (field.len > 0 &&
+      at_field_copy(&field, read_data->operator_name, sizeof(read_data->operator_name)) == ESP_OK)
+  {
+    read_data->present.has_operator = true;
+  }
+
+  // Act field
+  if (at_tokenizer_next(&tok, &field) == ESP_OK && at_field_get_int(&field, &value) == ESP_OK &&
+      (value == COPS_ACT_GSM || value == COPS_ACT_EMTC || value == COPS_ACT_NB_IOT))
+  {
+    read_data->act             = (cops_act_t) value;
+    read_data->present.has_act = true;
+  }
+
+  return ESP_OK;
+}
+
+// Decode the elements of one (<stat>,"<long>","<short>","<numeric>"[,<AcT>]) group.
+// Returns ESP_ERR_NOT_SUPPORTED for groups that are not operators (e.g. the (0-4) mode range)
+static esp_err_t cops_parse_operator_list(const at_field_t* list, cops_operator_info_t* info)
+{
+  at_tokenizer_t tok;
+  at_field_t     field;
+  int32_t        value;
+
+  memset(info, 0, sizeof(cops_operator_info_t));
+  at_tokenizer_init_span(&tok, list->start, list->len);
+
+  // Operator entries always start with <stat> followed by a quoted name, range lists do not
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || at_field_get_int(&field, &value) != ESP_OK ||
+      value < COPS_STAT_UNKNOWN || value > COPS_STAT_OPERATOR_FORBIDDEN)
+  {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+  info->stat = (cops_stat_t) value;
+
+  // Over-long names are truncated rather than dropping the entry
+  char*  names[]      = {info->long_name, info->short_name, info->numeric};
+  size_t name_sizes[] = {sizeof(info->long_name), sizeof(info->short_name), sizeof(info->numeric)};
+  for (size_t i = 0; i < 3; i++)
+  {
+    if (at_tokenizer_next(&tok, &field) != ESP_OK || field.type != AT_FIELD_STRING)
+    {
+      return (i == 0) ? ESP_ERR_NOT_SUPPORTED : ESP_ERR_INVALID_RESPONSE;
+    }
+    at_field_copy(&field, names[i], name_sizes[i]);
+  }
+
+  esp_err_t err = at_tokenizer_next(&tok, &field);
+  if (err == ESP_OK)
+  {
+    if (at_field_get_int(&field, &value) != ESP_OK)
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (value == COPS_ACT_GSM || value == COPS_ACT_EMTC || value == COPS_ACT_NB_IOT)
+    {
+      info->act             = (cops_act_t) value;
+      info->present.has_act = true;
+    }
+    err = at_tokenizer_next(&tok, &field);
+  }
+
+  // Nothing may follow the AcT
+  return (err == ESP_ERR_NOT_FOUND) ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+esp_err_t
+cops_parse_operator_entry(const char* entry, cops_operator_info_t* info, const char** entry_end)
+{
+  if (!entry || !info || *entry != '(')
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Names are quoted and can contain ')' - the tokenizer skips over them to the closing parenthesis
+  size_t         line_len = strcspn(entry, "\r\n");
+  at_tokenizer_t tok;
+  at_field_t     list;
+  at_tokenizer_init_span(&tok, entry, line_len);
+  if (at_tokenizer_next(&tok, &list) != ESP_OK)
+  {
+    // Not closed yet - unless the line has ended
+    return (entry[line_len] == '\0') ? ESP_ERR_NOT_FOUND : ESP_ERR_INVALID_RESPONSE;
+  }
+
+  // Skip groups that are not operators, but not malformed operator entries
+  esp_err_t err = cops_parse_operator_list(&list, info);
+  if (entry_end && (err == ESP_OK || err == ESP_ERR_NOT_SUPPORTED))
+  {
+    *entry_end = list.start + list.len + 1;
+  }
+
+  return (err == ESP_ERR_NOT_SUPPORTED) ? ESP_ERR_INVALID_RESPONSE : err;
+}
+
+static esp_err_t cops_test_parser(const char* response, void* parsed_data)
+{
+  if (!response || !parsed_data)
   {
-    if (mode >= 0 && mode <= 4)
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cops_test_response_t* test_data = (cops_test_response_t*) parsed_data;
+  memset(test_data, 0, sizeof(cops_test_response_t));
+
+  // Format: +COPS: (<stat>,"<long>","<short>","<numeric>",<AcT>),(...),...,,(0-4),(0-2)
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+COPS: ") != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to find +COPS: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  at_field_t field;
+  while (at_tokenizer_next(&tok, &field) == ESP_OK)
+  {
+    if (field.type != AT_FIELD_LIST)
     {
-      read_data->mode             = (cops_mode_t) mode;
-      read_data->present.has_mode = true;
+      continue;
+    }
 
-      // Format and operator
-      if (matched >= 2)
+    esp_err_t err =
+        cops_parse_operator_list(&field, &test_data->operators[test_data->num_operators]);
+    if (err == ESP_OK)
+    {
+      test_data->num_operators++;
+      if (test_data->num_operators >= COPS_MAX_OPERATORS)
       {
-        if (format >= 0 && format <= 2)
-        {
-          read_data->format             = (cops_format_t) format;
-          read_data->present.has_format = true;
-        }
-
-        if (matched >= 3 && operator_name[0] != '\0')
-        {
-          strcpy(read_data->operator_name, operator_name);
-          read_data->present.has_operator = true;
-        }
-
-        // Act field
-        if (matched >= 4)
-        {
-          // Validate act values
-          if (act == 0 || act == 8 || act == 9)
-          {
-            read_data->act             = (cops_act_t) act;
-            read_data->present.has_act = true;
-          }
-        }
+        ESP_LOGW(TAG, "More than %d operators found - ignoring the rest", COPS_MAX_OPERATORS);
+        break;
       }
-
-      return ESP_OK;
+    }
+    else if (err != ESP_ERR_NOT_SUPPORTED)
+    {
+      break;
     }
   }
 
-  ESP_LOGE(TAG, "Failed to parse COPS read response");
-  return ESP_ERR_INVALID_RESPONSE;
+  return ESP_OK;
 }
 
 // static esp_err_t cops_write_formatter(const void* params, char* buffer, size_t buffer_size)
@@ -181,12 +304,14 @@ static esp_err_t cops_read_parser(const char* response, void* parsed_data)
 // COPS command definition
 const at_cmd_t AT_CMD_COPS = {
     .name        = "COPS",
-    .description = "Operator Selection",
-    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED, // TODO: this
+    .description = AT_CMD_DESCRIPTION("Operator Selection"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = cops_test_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
                     [AT_CMD_TYPE_READ]    = {.parser        = cops_read_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
                     [AT_CMD_TYPE_WRITE]   = AT_CMD_TYPE_NOT_IMPLEMENTED, // TODO: this
                     [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
-    .timeout_ms  = 10000 // 180 seconds is spec
+    .timeout_ms  = 180000 // 180 seconds is spec - the test (scan) cmd really can take this long
 };
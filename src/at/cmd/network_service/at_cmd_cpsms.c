@@ -0,0 +1,301 @@
+#include "at_cmd_cpsms.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_CPSMS";
+
+const enum_str_map_t CPSMS_MODE_MAP[CPSMS_MODE_MAP_SIZE] = {
+    {CPSMS_MODE_DISABLE, ENUM_DESC("Disable PSM")},
+    {CPSMS_MODE_ENABLE, ENUM_DESC("Enable PSM")},
+    {CPSMS_MODE_DISABLE_AND_DISCARD, ENUM_DESC("Disable PSM and discard params")}};
+
+// Timer unit lookup - ordered from finest to coarsest resolution so encoding picks the most
+// accurate representation
+typedef struct
+{
+  uint8_t  unit_bits; // Value of bits 8-6
+  uint32_t unit_s;    // Seconds per unit
+} cpsms_timer_unit_t;
+
+// GPRS Timer 3 (T3412 extended)
+static const cpsms_timer_unit_t PERIODIC_TAU_UNITS[] = {
+    {0x3, 2}, {0x4, 30}, {0x5, 60}, {0x0, 600}, {0x1, 3600}, {0x2, 36000}, {0x6, 1152000}};
+
+// GPRS Timer 2 (T3324)
+static const cpsms_timer_unit_t ACTIVE_TIME_UNITS[] = {{0x0, 2}, {0x1, 60}, {0x2, 360}};
+
+#define CPSMS_TIMER_UNIT_DEACTIVATED 0x7
+
+static esp_err_t cpsms_encode_timer(const cpsms_timer_unit_t* units,
+                                    size_t                    num_units,
+                                    uint32_t                  seconds,
+                                    char*                     bits,
+                                    size_t                    bits_size)
+{
+  if (NULL == bits || bits_size < CPSMS_TIMER_STR_SIZE)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint8_t encoded = (uint8_t) (CPSMS_TIMER_UNIT_DEACTIVATED << 5);
+
+  if (seconds != CPSMS_TIMER_DEACTIVATED)
+  {
+    size_t i;
+    for (i = 0; i < num_units; i++)
+    {
+      // Round up so the network is never asked for less than the requested time
+      uint32_t value = (seconds + units[i].unit_s - 1) / units[i].unit_s;
+      if (value <= CPSMS_TIMER_VALUE_MAX)
+      {
+        encoded = (uint8_t) ((units[i].unit_bits << 5) | value);
+        break;
+      }
+    }
+
+    if (i == num_units)
+    {
+      ESP_LOGE(TAG, "Timer value %lu s is too large to encode", (unsigned long) seconds);
+      return ESP_ERR_INVALID_ARG;
+    }
+  }
+
+  for (int bit = 0; bit < CPSMS_TIMER_BITS_LEN; bit++)
+  {
+    bits[bit] = (encoded & (0x80 >> bit)) ? '1' : '0';
+  }
+  bits[CPSMS_TIMER_BITS_LEN] = '\0';
+
+  return ESP_OK;
+}
+
+// 'other_unit_s' is used for unit values not in the table (0 if those are invalid)
+static esp_err_t cpsms_decode_timer(const cpsms_timer_unit_t* units,
+                                    size_t                    num_units,
+                                    uint32_t                  other_unit_s,
+                                    const char*               bits,
+                                    uint32_t*                 seconds)
+{
+  if (NULL == bits || NULL == seconds || strlen(bits) != CPSMS_TIMER_BITS_LEN)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint8_t encoded = 0;
+  for (int bit = 0; bit < CPSMS_TIMER_BITS_LEN; bit++)
+  {
+    if (bits[bit] != '0' && bits[bit] != '1')
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    encoded = (uint8_t) ((encoded << 1) | (bits[bit] - '0'));
+  }
+
+  uint8_t unit_bits = encoded >> 5;
+  uint8_t value     = encoded & CPSMS_TIMER_VALUE_MAX;
+
+  if (unit_bits == CPSMS_TIMER_UNIT_DEACTIVATED)
+  {
+    *seconds = CPSMS_TIMER_DEACTIVATED;
+    return ESP_OK;
+  }
+
+  for (size_t i = 0; i < num_units; i++)
+  {
+    if (units[i].unit_bits == unit_bits)
+    {
+      *seconds = value * units[i].unit_s;
+      return ESP_OK;
+    }
+  }
+
+  if (other_unit_s > 0)
+  {
+    *seconds = value * other_unit_s;
+    return ESP_OK;
+  }
+
+  return ESP_ERR_INVALID_RESPONSE;
+}
+
+esp_err_t cpsms_encode_periodic_tau(uint32_t seconds, char* bits, size_t bits_size)
+{
+  return cpsms_encode_timer(PERIODIC_TAU_UNITS,
+                            sizeof(PERIODIC_TAU_UNITS) / sizeof(PERIODIC_TAU_UNITS[0]),
+                            seconds,
+                            bits,
+                            bits_size);
+}
+
+esp_err_t cpsms_decode_periodic_tau(const char* bits, uint32_t* seconds)
+{
+  return cpsms_decode_timer(PERIODIC_TAU_UNITS,
+                            sizeof(PERIODIC_TAU_UNITS) / sizeof(PERIODIC_TAU_UNITS[0]),
+                            0,
+                            bits,
+                            seconds);
+}
+
+esp_err_t cpsms_encode_active_time(uint32_t seconds, char* bits, size_t bits_size)
+{
+  return cpsms_encode_timer(ACTIVE_TIME_UNITS,
+                            sizeof(ACTIVE_TIME_UNITS) / sizeof(ACTIVE_TIME_UNITS[0]),
+                            seconds,
+                            bits,
+                            bits_size);
+}
+
+esp_err_t cpsms_decode_active_time(const char* bits, uint32_t* seconds)
+{
+  // NOTE: 24.008 says other unit values of GPRS Timer 2 are interpreted as 1 minute
+  return cpsms_decode_timer(ACTIVE_TIME_UNITS,
+                            sizeof(ACTIVE_TIME_UNITS) / sizeof(ACTIVE_TIME_UNITS[0]),
+                            60,
+                            bits,
+                            seconds);
+}
+
+static bool cpsms_is_valid_timer_str(const char* bits)
+{
+  if (strlen(bits) != CPSMS_TIMER_BITS_LEN)
+  {
+    return false;
+  }
+  return strspn(bits, "01") == CPSMS_TIMER_BITS_LEN;
+}
+
+// Field indices of the read response
+// +CPSMS: <mode>,[<Requested_Periodic-RAU>],[<Requested_GPRS-READY-timer>],
+//         [<Requested_Periodic-TAU>],[<Requested_Active-Time>]
+#define CPSMS_FIELD_PERIODIC_TAU 3
+#define CPSMS_FIELD_ACTIVE_TIME 4
+#define CPSMS_NUM_FIELDS 5
+
+// Copy the timer at 'field_idx' into 'out' (CPSMS_TIMER_STR_SIZE chars).
+// Returns false if the field does not exist, is empty or is not a timer bit string
+static bool cpsms_copy_timer(const at_field_t* fields, size_t num_fields, int field_idx, char* out)
+{
+  return (size_t) field_idx < num_fields &&
+         at_field_copy(&fields[field_idx], out, CPSMS_TIMER_STR_SIZE) == ESP_OK &&
+         cpsms_is_valid_timer_str(out);
+}
+
+static esp_err_t cpsms_read_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cpsms_read_response_t* read_data = (cpsms_read_response_t*) parsed_data;
+  memset(read_data, 0, sizeof(cpsms_read_response_t));
+
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+CPSMS: ") != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to find +CPSMS: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  at_field_t fields[CPSMS_NUM_FIELDS];
+  size_t     num_fields = 0;
+  while (num_fields < CPSMS_NUM_FIELDS && at_tokenizer_next(&tok, &fields[num_fields]) == ESP_OK)
+  {
+    num_fields++;
+  }
+
+  int32_t mode;
+  if (num_fields < 1 || at_field_get_int(&fields[0], &mode) != ESP_OK ||
+      mode < CPSMS_MODE_DISABLE || mode > CPSMS_MODE_DISABLE_AND_DISCARD)
+  {
+    ESP_LOGE(TAG, "Failed to parse CPSMS mode");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  read_data->mode = (cpsms_mode_t) mode;
+
+  read_data->present.has_periodic_tau =
+      cpsms_copy_timer(fields, num_fields, CPSMS_FIELD_PERIODIC_TAU, read_data->periodic_tau);
+  read_data->present.has_active_time =
+      cpsms_copy_timer(fields, num_fields, CPSMS_FIELD_ACTIVE_TIME, read_data->active_time);
+
+  return ESP_OK;
+}
+
+static esp_err_t cpsms_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const cpsms_write_params_t* write_params = (const cpsms_write_params_t*) params;
+  int                         written      = 0;
+
+  if (write_params->mode > CPSMS_MODE_DISABLE_AND_DISCARD)
+  {
+    ESP_LOGE(TAG, "Invalid mode: %d", write_params->mode);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if ((write_params->present.has_periodic_tau &&
+       !cpsms_is_valid_timer_str(write_params->periodic_tau)) ||
+      (write_params->present.has_active_time &&
+       !cpsms_is_valid_timer_str(write_params->active_time)))
+  {
+    ESP_LOGE(TAG, "Timers must be 8 char binary strings");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_active_time)
+  {
+    written = snprintf(buffer,
+                       buffer_size,
+                       "=%d,,,\"%s\",\"%s\"",
+                       write_params->mode,
+                       write_params->present.has_periodic_tau ? write_params->periodic_tau : "",
+                       write_params->active_time);
+  }
+  else if (write_params->present.has_periodic_tau)
+  {
+    written = snprintf(
+        buffer, buffer_size, "=%d,,,\"%s\"", write_params->mode, write_params->periodic_tau);
+  }
+  else
+  {
+    written = snprintf(buffer, buffer_size, "=%d", write_params->mode);
+  }
+
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    ESP_LOGE(TAG, "Buffer too small for CPSMS write command");
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_CPSMS = {
+    .name        = "CPSMS",
+    .description = AT_CMD_DESCRIPTION("Power Saving Mode Setting"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = {.parser        = cpsms_read_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = cpsms_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
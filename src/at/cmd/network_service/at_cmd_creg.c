@@ -1,9 +1,10 @@
 #include "at_cmd_creg.h"
 
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
 
 #include <esp_log.h>
-#include <string.h> // for memset, strstr, strncpy, strlen
+#include <string.h> // for memset
 
 static esp_err_t creg_test_parser(const char* response, void* parsed_data)
 {
@@ -11,21 +12,21 @@ static esp_err_t creg_test_parser(const char* response, void* parsed_data)
   memset(test_data, 0, sizeof(creg_test_response_t));
 
   // Find response start
-  const char* start = strstr(response, "+CREG: (");
-  if (!start)
+  at_tokenizer_t tok;
+  at_field_t     modes;
+  if (at_tokenizer_init(&tok, response, "+CREG: ") != ESP_OK ||
+      at_tokenizer_next(&tok, &modes) != ESP_OK || modes.type != AT_FIELD_LIST)
   {
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 8; // Skip "+CREG: ("
 
-  // Parse supported modes
-  while (*start && test_data->num_modes < 3)
+  // Parse supported modes, e.g. (0-2)
+  for (int mode = 0; mode <= 2; mode++)
   {
-    if (*start >= '0' && *start <= '2')
+    if (at_field_list_contains(&modes, mode))
     {
-      test_data->supported_modes[test_data->num_modes++] = *start - '0';
+      test_data->supported_modes[test_data->num_modes++] = mode;
     }
-    start++;
   }
 
   return ESP_OK;
@@ -36,54 +37,52 @@ static esp_err_t creg_read_parser(const char* response, void* parsed_data)
   creg_read_response_t* read_data = (creg_read_response_t*) parsed_data;
   memset(read_data, 0, sizeof(creg_read_response_t));
 
-  // Find response start
-  const char* start = strstr(response, "+CREG: ");
-  if (!start)
+  // Find response start: +CREG: <n>,<stat>[,<lac>,<ci>[,<AcT>]]
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+CREG: ") != ESP_OK)
   {
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 7;
-
-  int  n, stat;
-  char lac[5] = {0}, ci[9] = {0};
-  int  act = -1;
 
-  // Try to parse with all possible formats
-  int matched = sscanf(start, "%d,%d,\"%4[^\"]\",%8[^\"]\",%d", &n, &stat, lac, ci, &act);
+  // At minimum need n and stat
+  at_field_t field;
+  int32_t    n, stat;
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || at_field_get_int(&field, &n) != ESP_OK ||
+      at_tokenizer_next(&tok, &field) != ESP_OK || at_field_get_int(&field, &stat) != ESP_OK)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
 
-  if (matched >= 2)
-  { // At minimum need n and stat
-    read_data->n             = n;
-    read_data->present.has_n = true;
+  read_data->n             = n;
+  read_data->present.has_n = true;
 
-    if (stat >= 0 && stat < CREG_STATUS_MAX)
-    {
-      read_data->status             = (creg_status_t) stat;
-      read_data->present.has_status = true;
-    }
-
-    if (matched >= 3 && strlen(lac) > 0)
-    {
-      strncpy(read_data->lac, lac, sizeof(read_data->lac) - 1);
-      read_data->present.has_lac = true;
-    }
+  if (stat >= 0 && stat < CREG_STATUS_MAX)
+  {
+    read_data->status             = (creg_status_t) stat;
+    read_data->present.has_status = true;
+  }
 
-    if (matched >= 4 && strlen(ci) > 0)
-    {
-      strncpy(read_data->ci, ci, sizeof(read_data->ci) - 1);
-      read_data->present.has_ci = true;
-    }
+  if (at_tokenizer_next(&tok, &field) == ESP_OK && field.len > 0 &&
+      at_field_copy(&field, read_data->lac, sizeof(read_data->lac)) == ESP_OK)
+  {
+    read_data->present.has_lac = true;
+  }
 
-    if (matched >= 5 && act >= 0)
-    {
-      read_data->act             = (creg_act_t) act;
-      read_data->present.has_act = true;
-    }
+  if (at_tokenizer_next(&tok, &field) == ESP_OK && field.len > 0 &&
+      at_field_copy(&field, read_data->ci, sizeof(read_data->ci)) == ESP_OK)
+  {
+    read_data->present.has_ci = true;
+  }
 
-    return ESP_OK;
+  int32_t act;
+  if (at_tokenizer_next(&tok, &field) == ESP_OK && at_field_get_int(&field, &act) == ESP_OK &&
+      act >= 0)
+  {
+    read_data->act             = (creg_act_t) act;
+    read_data->present.has_act = true;
   }
 
-  return ESP_ERR_INVALID_RESPONSE;
+  return ESP_OK;
 }
 
 static esp_err_t creg_write_formatter(const void* params, char* buffer, size_t buffer_size)
@@ -99,7 +98,7 @@ static esp_err_t creg_write_formatter(const void* params, char* buffer, size_t b
 // CREG command definition
 const at_cmd_t AT_CMD_CREG = {
     .name        = "CREG",
-    .description = "Network Registration Status",
+    .description = AT_CMD_DESCRIPTION("Network Registration Status"),
     .type_info   = {[AT_CMD_TYPE_TEST]  = {.parser = creg_test_parser, .formatter = NULL},
                     [AT_CMD_TYPE_READ]  = {.parser = creg_read_parser, .formatter = NULL},
                     [AT_CMD_TYPE_WRITE] = {.parser = NULL, .formatter = creg_write_formatter}},
@@ -1,24 +1,25 @@
 #include "at_cmd_csq.h"
 
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
 #include "enum_utils.h"
 
 #include <esp_log.h>
-#include <string.h> // for memset, strstr
+#include <string.h> // for memset
 
 static const char* TAG = "AT_CMD_CSQ";
 
 // Define the mapping array for BER values
 const enum_str_map_t CSQ_BER_MAP[CSQ_BER_MAP_SIZE] = {
-    {CSQ_BER_0, "BER < 0.2%"},
-    {CSQ_BER_1, "0.2% <= BER < 0.4%"},
-    {CSQ_BER_2, "0.4% <= BER < 0.8%"},
-    {CSQ_BER_3, "0.8% <= BER < 1.6%"},
-    {CSQ_BER_4, "1.6% <= BER < 3.2%"},
-    {CSQ_BER_5, "3.2% <= BER < 6.4%"},
-    {CSQ_BER_6, "6.4% <= BER < 12.8%"},
-    {CSQ_BER_7, "12.8% <= BER"},
-    {CSQ_BER_UNKNOWN, "Unknown or not detectable"}};
+    {CSQ_BER_0, ENUM_DESC("BER < 0.2%")},
+    {CSQ_BER_1, ENUM_DESC("0.2% <= BER < 0.4%")},
+    {CSQ_BER_2, ENUM_DESC("0.4% <= BER < 0.8%")},
+    {CSQ_BER_3, ENUM_DESC("0.8% <= BER < 1.6%")},
+    {CSQ_BER_4, ENUM_DESC("1.6% <= BER < 3.2%")},
+    {CSQ_BER_5, ENUM_DESC("3.2% <= BER < 6.4%")},
+    {CSQ_BER_6, ENUM_DESC("6.4% <= BER < 12.8%")},
+    {CSQ_BER_7, ENUM_DESC("12.8% <= BER")},
+    {CSQ_BER_UNKNOWN, ENUM_DESC("Unknown or not detectable")}};
 
 // Map RSSI values (0-31, 99) to dBm
 int16_t csq_rssi_to_dbm(uint8_t rssi)
@@ -73,6 +74,29 @@ uint8_t csq_dbm_to_rssi(int16_t dbm)
   return CSQ_RSSI_UNKNOWN; // Unknown/invalid
 }
 
+// Parse a (<min>-<max>[,99]) list, 99 being the 'unknown' value
+static bool csq_parse_range_list(const at_field_t* list, int32_t* min, int32_t* max, bool* unknown)
+{
+  at_tokenizer_t tok;
+  at_field_t     field;
+  int32_t        value;
+
+  if (list->type != AT_FIELD_LIST)
+  {
+    return false;
+  }
+
+  at_tokenizer_init_span(&tok, list->start, list->len);
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || at_field_get_range(&field, min, max) != ESP_OK)
+  {
+    return false;
+  }
+
+  *unknown = at_tokenizer_next(&tok, &field) == ESP_OK &&
+             at_field_get_int(&field, &value) == ESP_OK && value == 99;
+  return true;
+}
+
 static esp_err_t csq_cmd_test_type_parser(const char* response, void* parsed_data)
 {
   csq_test_response_t* test_data = (csq_test_response_t*) parsed_data;
@@ -84,46 +108,32 @@ static esp_err_t csq_cmd_test_type_parser(const char* response, void* parsed_dat
   memset(test_data, 0, sizeof(csq_test_response_t));
 
   // Find response start
-  const char* start = strstr(response, "+CSQ: ");
-  if (!start)
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+CSQ: ") != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to find +CSQ: in response");
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 6;
-
-  int rssi_min, rssi_max, ber_min, ber_max;
-  int rssi_unknown = 0, ber_unknown = 0;
-
-  // Parse response like "(0-31,99),(0-7,99)"
-  // First try to parse with unknown values (99)
-  int matched = sscanf(start,
-                       "(%d-%d,%d),(%d-%d,%d)",
-                       &rssi_min,
-                       &rssi_max,
-                       &rssi_unknown,
-                       &ber_min,
-                       &ber_max,
-                       &ber_unknown);
 
-  if (matched < 4)
+  // Parse response like "(0-31,99),(0-7,99)" - the unknown values are optional
+  at_field_t rssi_list, ber_list;
+  int32_t    rssi_min, rssi_max, ber_min, ber_max;
+  bool       rssi_unknown, ber_unknown;
+  if (at_tokenizer_next(&tok, &rssi_list) != ESP_OK ||
+      at_tokenizer_next(&tok, &ber_list) != ESP_OK ||
+      !csq_parse_range_list(&rssi_list, &rssi_min, &rssi_max, &rssi_unknown) ||
+      !csq_parse_range_list(&ber_list, &ber_min, &ber_max, &ber_unknown))
   {
-    // Try without unknown values
-    matched = sscanf(start, "(%d-%d),(%d-%d)", &rssi_min, &rssi_max, &ber_min, &ber_max);
-
-    if (matched < 4)
-    {
-      ESP_LOGE(TAG, "Failed to parse CSQ test response format");
-      return ESP_ERR_INVALID_RESPONSE;
-    }
+    ESP_LOGE(TAG, "Failed to parse CSQ test response format");
+    return ESP_ERR_INVALID_RESPONSE;
   }
 
   test_data->rssi_min     = (uint8_t) rssi_min;
   test_data->rssi_max     = (uint8_t) rssi_max;
   test_data->ber_min      = (uint8_t) ber_min;
   test_data->ber_max      = (uint8_t) ber_max;
-  test_data->rssi_unknown = (rssi_unknown == 99);
-  test_data->ber_unknown  = (ber_unknown == 99);
+  test_data->rssi_unknown = rssi_unknown;
+  test_data->ber_unknown  = ber_unknown;
 
   ESP_LOGD(TAG,
            "CSQ test parsed: RSSI range %d-%d%s, BER range %d-%d%s",
@@ -148,16 +158,19 @@ static esp_err_t csq_cmd_execute_type_parser(const char* response, void* parsed_
   memset(exec_data, 0, sizeof(csq_execute_response_t));
 
   // Find response start
-  const char* start = strstr(response, "+CSQ: ");
-  if (!start)
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+CSQ: ") != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to find +CSQ: in response");
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 6;
 
-  int rssi, ber;
-  if (sscanf(start, "%d,%d", &rssi, &ber) == 2)
+  at_field_t rssi_field, ber_field;
+  int32_t    rssi, ber;
+  if (at_tokenizer_next(&tok, &rssi_field) == ESP_OK &&
+      at_tokenizer_next(&tok, &ber_field) == ESP_OK &&
+      at_field_get_int(&rssi_field, &rssi) == ESP_OK &&
+      at_field_get_int(&ber_field, &ber) == ESP_OK)
   {
     // Validate ranges
     if ((rssi >= 0 && rssi <= 31) || rssi == 99)
@@ -166,7 +179,7 @@ static esp_err_t csq_cmd_execute_type_parser(const char* response, void* parsed_
     }
     else
     {
-      ESP_LOGW(TAG, "Invalid RSSI value: %d, defaulting to 99 (unknown)", rssi);
+      ESP_LOGW(TAG, "Invalid RSSI value: %d, defaulting to 99 (unknown)", (int) rssi);
       exec_data->rssi = 99; // Default to unknown for invalid values
     }
 
@@ -176,7 +189,7 @@ static esp_err_t csq_cmd_execute_type_parser(const char* response, void* parsed_
     }
     else
     {
-      ESP_LOGW(TAG, "Invalid BER value: %d, defaulting to 99 (unknown)", ber);
+      ESP_LOGW(TAG, "Invalid BER value: %d, defaulting to 99 (unknown)", (int) ber);
       exec_data->ber = 99; // Default to unknown for invalid values
     }
 
@@ -192,7 +205,7 @@ static esp_err_t csq_cmd_execute_type_parser(const char* response, void* parsed_
 // CSQ command definition
 const at_cmd_t AT_CMD_CSQ = {
     .name        = "CSQ",
-    .description = "Signal Quality Report",
+    .description = AT_CMD_DESCRIPTION("Signal Quality Report"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = csq_cmd_test_type_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
@@ -0,0 +1,425 @@
+#include "at_cmd_qcfg.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QCFG";
+
+const enum_str_map_t QCFG_TYPE_MAP[QCFG_TYPE_MAP_SIZE] = {{QCFG_TYPE_NWSCANSEQ, "nwscanseq"},
+                                                          {QCFG_TYPE_NWSCANMODE, "nwscanmode"},
+                                                          {QCFG_TYPE_IOTOPMODE, "iotopmode"},
+                                                          {QCFG_TYPE_BAND, "band"}};
+
+const enum_str_map_t QCFG_RAT_MAP[QCFG_RAT_MAP_SIZE] = {{QCFG_RAT_AUTO, ENUM_DESC("Automatic")},
+                                                        {QCFG_RAT_GSM, ENUM_DESC("GSM")},
+                                                        {QCFG_RAT_EMTC, ENUM_DESC("eMTC")},
+                                                        {QCFG_RAT_NBIOT, ENUM_DESC("NB-IoT")}};
+
+const enum_str_map_t QCFG_NWSCANMODE_MAP[QCFG_NWSCANMODE_MAP_SIZE] = {
+    {QCFG_NWSCANMODE_AUTO, ENUM_DESC("Automatic")},
+    {QCFG_NWSCANMODE_GSM_ONLY, ENUM_DESC("GSM only")},
+    {QCFG_NWSCANMODE_LTE_ONLY, ENUM_DESC("LTE only")}};
+
+const enum_str_map_t QCFG_IOTOPMODE_MAP[QCFG_IOTOPMODE_MAP_SIZE] = {
+    {QCFG_IOTOPMODE_EMTC, ENUM_DESC("eMTC")},
+    {QCFG_IOTOPMODE_NBIOT, ENUM_DESC("NB-IoT")},
+    {QCFG_IOTOPMODE_EMTC_NBIOT, ENUM_DESC("eMTC and NB-IoT")}};
+
+void qcfg_lte_band_mask_set(qcfg_lte_band_mask_t* mask, uint8_t band)
+{
+  if (!mask || band == 0 || band > QCFG_LTE_BAND_MAX)
+  {
+    return;
+  }
+
+  if (band <= 64)
+  {
+    mask->low |= (1ULL << (band - 1));
+  }
+  else
+  {
+    mask->high |= (1ULL << (band - 65));
+  }
+}
+
+bool qcfg_lte_band_mask_has(const qcfg_lte_band_mask_t* mask, uint8_t band)
+{
+  if (!mask || band == 0 || band > QCFG_LTE_BAND_MAX)
+  {
+    return false;
+  }
+
+  if (band <= 64)
+  {
+    return (mask->low & (1ULL << (band - 1))) != 0;
+  }
+  return (mask->high & (1ULL << (band - 65))) != 0;
+}
+
+bool qcfg_lte_band_mask_is_empty(const qcfg_lte_band_mask_t* mask)
+{
+  return !mask || (mask->low == 0 && mask->high == 0);
+}
+
+// Format a 128 bit mask as a hex string without leading zeros, e.g. "0x100002000000000f0e189f"
+static int qcfg_format_lte_band_mask(const qcfg_lte_band_mask_t* mask, char* buffer, size_t size)
+{
+  if (mask->high != 0)
+  {
+    return snprintf(buffer, size, "0x%" PRIx64 "%016" PRIx64, mask->high, mask->low);
+  }
+  return snprintf(buffer, size, "0x%" PRIx64, mask->low);
+}
+
+// Parse a hex mask of up to 128 bits. 'end' is set past the last hex digit
+static esp_err_t
+qcfg_parse_lte_band_mask(const char* str, qcfg_lte_band_mask_t* mask, const char** end)
+{
+  if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+  {
+    str += 2; // Skip "0x"
+  }
+
+  size_t num_digits = 0;
+  while (isxdigit((unsigned char) str[num_digits]))
+  {
+    num_digits++;
+  }
+
+  if (num_digits == 0 || num_digits > 32)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  mask->low  = 0;
+  mask->high = 0;
+  for (size_t i = 0; i < num_digits; i++)
+  {
+    char     c     = str[i];
+    uint64_t digit = (uint64_t) (isdigit((unsigned char) c) ? c - '0' : tolower(c) - 'a' + 10);
+
+    // Shift the 128 bit value left by one hex digit
+    mask->high = (mask->high << 4) | (mask->low >> 60);
+    mask->low  = (mask->low << 4) | digit;
+  }
+
+  if (end)
+  {
+    *end = str + num_digits;
+  }
+  return ESP_OK;
+}
+
+static esp_err_t qcfg_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qcfg_write_response_t* write_response = (qcfg_write_response_t*) parsed_data;
+  write_response->has_data              = false;
+
+  // Format: +QCFG: "<type>",<values...>
+  const char* data_start = strstr(response, "+QCFG: \"");
+  if (NULL == data_start)
+  {
+    // No data response, only OK response - the value was set, not queried
+    return ESP_OK;
+  }
+  data_start += 8; // Skip "+QCFG: \""
+
+  char type_str[16] = {0};
+  if (sscanf(data_start, "%15[^\"]", type_str) != 1)
+  {
+    ESP_LOGE(TAG, "Malformed response: missing type string");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  enum_convert_result_t type = str_to_enum(type_str, QCFG_TYPE_MAP, QCFG_TYPE_MAP_SIZE);
+  if (!type.is_valid)
+  {
+    ESP_LOGE(TAG, "Unsupported configuration type: %s", type_str);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  write_response->type = (qcfg_type_t) type.value;
+
+  // The type string may be cut off before its closing '"'
+  const char* params_start = data_start + strlen(type_str);
+  if (params_start[0] != '"' || params_start[1] != ',')
+  {
+    ESP_LOGE(TAG, "Malformed response: missing value for %s", type_str);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  params_start += 2; // Skip '",'
+
+  switch (write_response->type)
+  {
+    case QCFG_TYPE_NWSCANSEQ:
+    {
+      // Sequence is a string of 2 digit RAT codes, e.g. 020301 (optionally quoted)
+      qcfg_nwscanseq_response_t* seq = &write_response->response.nwscanseq;
+      const char*                pos = (*params_start == '"') ? params_start + 1 : params_start;
+
+      seq->num_rats = 0;
+      while (isdigit((unsigned char) pos[0]) && isdigit((unsigned char) pos[1]) &&
+             seq->num_rats < QCFG_NWSCANSEQ_MAX_RATS)
+      {
+        int rat = (pos[0] - '0') * 10 + (pos[1] - '0');
+        if (rat > QCFG_RAT_NBIOT)
+        {
+          ESP_LOGE(TAG, "Invalid RAT code in scan sequence: %02d", rat);
+          return ESP_ERR_INVALID_RESPONSE;
+        }
+        seq->rats[seq->num_rats++] = (qcfg_rat_t) rat;
+        pos += 2;
+      }
+
+      if (seq->num_rats == 0)
+      {
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+    }
+    break;
+
+    case QCFG_TYPE_NWSCANMODE:
+    {
+      int mode;
+      if (sscanf(params_start, "%d", &mode) != 1 ||
+          (mode != QCFG_NWSCANMODE_AUTO && mode != QCFG_NWSCANMODE_GSM_ONLY &&
+           mode != QCFG_NWSCANMODE_LTE_ONLY))
+      {
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      write_response->response.nwscanmode = (qcfg_nwscanmode_t) mode;
+    }
+    break;
+
+    case QCFG_TYPE_IOTOPMODE:
+    {
+      int mode;
+      if (sscanf(params_start, "%d", &mode) != 1 || mode < QCFG_IOTOPMODE_EMTC ||
+          mode > QCFG_IOTOPMODE_EMTC_NBIOT)
+      {
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      write_response->response.iotopmode = (qcfg_iotopmode_t) mode;
+    }
+    break;
+
+    case QCFG_TYPE_BAND:
+    {
+      // Format: <gsmbandval>,<emtcbandval>,<nbiotbandval> - all hex
+      qcfg_band_config_t* bands = &write_response->response.band;
+      unsigned int        gsm   = 0;
+      const char*         pos   = NULL;
+
+      if (sscanf(params_start, "%x", &gsm) != 1)
+      {
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      bands->gsm = gsm;
+
+      pos = strchr(params_start, ',');
+      if (!pos || qcfg_parse_lte_band_mask(pos + 1, &bands->emtc, &pos) != ESP_OK ||
+          *pos != ',' || qcfg_parse_lte_band_mask(pos + 1, &bands->nbiot, &pos) != ESP_OK)
+      {
+        ESP_LOGE(TAG, "Failed to parse band masks");
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+    }
+    break;
+
+    default:
+      return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  write_response->has_data = true;
+  return ESP_OK;
+}
+
+static esp_err_t qcfg_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qcfg_write_params_t* write_params = (const qcfg_write_params_t*) params;
+  const char* type_str = enum_to_str(write_params->type, QCFG_TYPE_MAP, QCFG_TYPE_MAP_SIZE);
+  int         written  = 0;
+
+  switch (write_params->type)
+  {
+    case QCFG_TYPE_NWSCANSEQ:
+    {
+      const qcfg_write_nwscanseq_params_t* seq = &write_params->params.nwscanseq;
+
+      if (!seq->present.has_rats)
+      {
+        written = snprintf(buffer, buffer_size, "=\"%s\"", type_str);
+        break;
+      }
+
+      if (seq->num_rats == 0 || seq->num_rats > QCFG_NWSCANSEQ_MAX_RATS)
+      {
+        ESP_LOGE(TAG, "Invalid number of RATs in scan sequence: %d", seq->num_rats);
+        return ESP_ERR_INVALID_ARG;
+      }
+
+      char seq_str[QCFG_NWSCANSEQ_MAX_RATS * 2 + 1] = {0};
+      for (uint8_t i = 0; i < seq->num_rats; i++)
+      {
+        if (seq->rats[i] > QCFG_RAT_NBIOT)
+        {
+          ESP_LOGE(TAG, "Invalid RAT in scan sequence: %d", seq->rats[i]);
+          return ESP_ERR_INVALID_ARG;
+        }
+        snprintf(&seq_str[i * 2], 3, "%02d", seq->rats[i]);
+      }
+
+      if (seq->present.has_effect)
+      {
+        written =
+            snprintf(buffer, buffer_size, "=\"%s\",%s,%d", type_str, seq_str, seq->effect);
+      }
+      else
+      {
+        written = snprintf(buffer, buffer_size, "=\"%s\",%s", type_str, seq_str);
+      }
+    }
+    break;
+
+    case QCFG_TYPE_NWSCANMODE:
+    case QCFG_TYPE_IOTOPMODE:
+    {
+      // Both are a single integer value followed by the optional effect
+      bool has_mode, has_effect;
+      int  mode, effect;
+      if (write_params->type == QCFG_TYPE_NWSCANMODE)
+      {
+        const qcfg_write_nwscanmode_params_t* p = &write_params->params.nwscanmode;
+        has_mode                                = p->present.has_mode;
+        has_effect                              = p->present.has_effect;
+        mode                                    = p->mode;
+        effect                                  = p->effect;
+
+        if (has_mode && mode != QCFG_NWSCANMODE_AUTO && mode != QCFG_NWSCANMODE_GSM_ONLY &&
+            mode != QCFG_NWSCANMODE_LTE_ONLY)
+        {
+          ESP_LOGE(TAG, "Invalid scan mode: %d", mode);
+          return ESP_ERR_INVALID_ARG;
+        }
+      }
+      else
+      {
+        const qcfg_write_iotopmode_params_t* p = &write_params->params.iotopmode;
+        has_mode                               = p->present.has_mode;
+        has_effect                             = p->present.has_effect;
+        mode                                   = p->mode;
+        effect                                 = p->effect;
+
+        if (has_mode && mode > QCFG_IOTOPMODE_EMTC_NBIOT)
+        {
+          ESP_LOGE(TAG, "Invalid IoT op mode: %d", mode);
+          return ESP_ERR_INVALID_ARG;
+        }
+      }
+
+      if (!has_mode)
+      {
+        written = snprintf(buffer, buffer_size, "=\"%s\"", type_str);
+      }
+      else if (has_effect)
+      {
+        written = snprintf(buffer, buffer_size, "=\"%s\",%d,%d", type_str, mode, effect);
+      }
+      else
+      {
+        written = snprintf(buffer, buffer_size, "=\"%s\",%d", type_str, mode);
+      }
+    }
+    break;
+
+    case QCFG_TYPE_BAND:
+    {
+      const qcfg_write_band_params_t* band = &write_params->params.band;
+
+      if (!band->present.has_bands)
+      {
+        written = snprintf(buffer, buffer_size, "=\"%s\"", type_str);
+        break;
+      }
+
+      if (band->bands.gsm > QCFG_GSM_BAND_ANY)
+      {
+        ESP_LOGE(TAG, "Invalid GSM band mask: 0x%lx", (unsigned long) band->bands.gsm);
+        return ESP_ERR_INVALID_ARG;
+      }
+
+      // Longest mask is "0x" + 32 hex digits
+      char emtc_str[35];
+      char nbiot_str[35];
+      qcfg_format_lte_band_mask(&band->bands.emtc, emtc_str, sizeof(emtc_str));
+      qcfg_format_lte_band_mask(&band->bands.nbiot, nbiot_str, sizeof(nbiot_str));
+
+      if (band->present.has_effect)
+      {
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",0x%lx,%s,%s,%d",
+                           type_str,
+                           (unsigned long) band->bands.gsm,
+                           emtc_str,
+                           nbiot_str,
+                           band->effect);
+      }
+      else
+      {
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",0x%lx,%s,%s",
+                           type_str,
+                           (unsigned long) band->bands.gsm,
+                           emtc_str,
+                           nbiot_str);
+      }
+    }
+    break;
+
+    default:
+      ESP_LOGE(TAG, "Unknown configuration type: %d", write_params->type);
+      return ESP_ERR_INVALID_ARG;
+  }
+
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QCFG = {
+    .name        = "QCFG",
+    .description = AT_CMD_DESCRIPTION("Extended Configuration Settings"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qcfg_write_parser,
+                                             .formatter     = qcfg_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_OPTIONAL},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 1500 // NOTE: 300ms per spec, but changing band/RAT can take longer
+};
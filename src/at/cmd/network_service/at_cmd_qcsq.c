@@ -2,6 +2,7 @@
 #include "at_cmd_qcsq.h"
 
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
 #include "esp_log.h"
 
 #include <string.h>
@@ -54,23 +55,27 @@ static esp_err_t qcsq_test_parser(const char* response, void* parsed_data)
   memset(test_data, 0, sizeof(qcsq_test_response_t));
 
   // Find response start
-  const char* start = strstr(response, "+QCSQ: ");
-  if (!start)
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+QCSQ: ") != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to find +QCSQ: in response");
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 7; // Skip "+QCSQ: "
-
-  // Parse supported system modes
-  if (strstr(start, "\"NOSERVICE\""))
-    test_data->supports_sysmode[QCSQ_SYSMODE_NOSERVICE] = true;
-  if (strstr(start, "\"GSM\""))
-    test_data->supports_sysmode[QCSQ_SYSMODE_GSM] = true;
-  if (strstr(start, "\"eMTC\""))
-    test_data->supports_sysmode[QCSQ_SYSMODE_EMTC] = true;
-  if (strstr(start, "\"NBIoT\""))
-    test_data->supports_sysmode[QCSQ_SYSMODE_NBIOT] = true;
+
+  // Parse supported system modes, e.g. ("NOSERVICE","GSM","eMTC","NBIoT")
+  at_field_t field;
+  while (at_tokenizer_next(&tok, &field) == ESP_OK)
+  {
+    int sysmode;
+    if (field.type == AT_FIELD_LIST)
+    {
+      at_tokenizer_init_span(&tok, field.start, field.len); // Continue with the list elements
+    }
+    else if (at_field_to_enum(&field, QCSQ_SYSMODE_MAP, QCSQ_SYSMODE_MAP_SIZE, &sysmode) == ESP_OK)
+    {
+      test_data->supports_sysmode[sysmode] = true;
+    }
+  }
 
   return ESP_OK;
 }
@@ -89,104 +94,80 @@ static esp_err_t qcsq_execute_parser(const char* response, void* parsed_data)
   memset(exec_data, 0, sizeof(qcsq_execute_response_t));
 
   // Find response start
-  const char* start = strstr(response, "+QCSQ: ");
-  if (!start)
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+QCSQ: ") != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to find +QCSQ: in response");
     return ESP_ERR_INVALID_RESPONSE;
   }
-  start += 7; // Skip "+QCSQ: "
 
   // Parse system mode - it's a quoted string
-  char sysmode_str[16] = {0};
-  if (sscanf(start, "\"%15[^\"]\"", sysmode_str) != 1)
+  at_field_t field;
+  int        sysmode;
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || field.type != AT_FIELD_STRING)
   {
     ESP_LOGE(TAG, "Failed to parse system mode");
     return ESP_ERR_INVALID_RESPONSE;
   }
 
-  // Set system mode
-  bool found_sysmode = false;
-  for (int i = 0; i < QCSQ_SYSMODE_MAP_SIZE; i++)
+  if (at_field_to_enum(&field, QCSQ_SYSMODE_MAP, QCSQ_SYSMODE_MAP_SIZE, &sysmode) != ESP_OK)
   {
-    if (strcmp(sysmode_str, QCSQ_SYSMODE_MAP[i].string) == 0)
-    {
-      exec_data->sysmode             = (qcsq_sysmode_t) QCSQ_SYSMODE_MAP[i].value;
-      exec_data->present.has_sysmode = true;
-      found_sysmode                  = true;
-      break;
-    }
-  }
-
-  if (!found_sysmode)
-  {
-    ESP_LOGE(TAG, "Unknown system mode: %s", sysmode_str);
+    ESP_LOGE(TAG, "Unknown system mode: %.*s", (int) field.len, field.start);
     return ESP_ERR_INVALID_RESPONSE;
   }
+  exec_data->sysmode             = (qcsq_sysmode_t) sysmode;
+  exec_data->present.has_sysmode = true;
 
-  // Skip to after the sysmode and the following quote and comma
-  const char* value_start = strchr(start, '\"');
-  if (!value_start)
-    return ESP_ERR_INVALID_RESPONSE;
-  value_start++; // Skip first quote
-  value_start = strchr(value_start, '\"');
-  if (!value_start)
-    return ESP_ERR_INVALID_RESPONSE;
-  value_start++; // Skip second quote
-
-  // Skip comma if present
-  if (*value_start == ',')
-    value_start++;
-
-  // Depending on the system mode, parse the appropriate number of values
-  int value1 = 0, value2 = 0, value3 = 0, value4 = 0;
-  int parsed_values = 0;
-
+  // Depending on the system mode, parse the appropriate number of values:
+  // GSM has one (GSM_RSSI), eMTC and NB-IoT four (LTE_RSSI, LTE_RSRP, LTE_SINR, LTE_RSRQ)
+  int num_values = 0;
   switch (exec_data->sysmode)
   {
     case QCSQ_SYSMODE_NOSERVICE:
-      // No values to parse
       break;
 
     case QCSQ_SYSMODE_GSM:
-      // Only one value (GSM_RSSI)
-      parsed_values = sscanf(value_start, "%d", &value1);
-      if (parsed_values >= 1)
-      {
-        exec_data->value1             = (int16_t) value1;
-        exec_data->present.has_value1 = true;
-      }
+      num_values = 1;
       break;
 
     case QCSQ_SYSMODE_EMTC:
     case QCSQ_SYSMODE_NBIOT:
-      // Four values (LTE_RSSI, LTE_RSRP, LTE_SINR, LTE_RSRQ)
-      parsed_values = sscanf(value_start, "%d,%d,%d,%d", &value1, &value2, &value3, &value4);
-
-      if (parsed_values >= 1)
-      {
-        exec_data->value1             = (int16_t) value1;
-        exec_data->present.has_value1 = true;
-      }
-      if (parsed_values >= 2)
-      {
-        exec_data->value2             = (int16_t) value2;
-        exec_data->present.has_value2 = true;
-      }
-      if (parsed_values >= 3)
-      {
-        exec_data->value3             = (int16_t) value3;
-        exec_data->present.has_value3 = true;
-      }
-      if (parsed_values >= 4)
-      {
-        exec_data->value4             = (int16_t) value4;
-        exec_data->present.has_value4 = true;
-      }
+      num_values = 4;
       break;
   }
 
-  ESP_LOGI(TAG, "QCSQ parsed: sysmode=%s", sysmode_str);
+  int32_t values[4]     = {0};
+  int     parsed_values = 0;
+  while (parsed_values < num_values && at_tokenizer_next(&tok, &field) == ESP_OK &&
+         at_field_get_int(&field, &values[parsed_values]) == ESP_OK)
+  {
+    parsed_values++;
+  }
+
+  if (parsed_values >= 1)
+  {
+    exec_data->value1             = (int16_t) values[0];
+    exec_data->present.has_value1 = true;
+  }
+  if (parsed_values >= 2)
+  {
+    exec_data->value2             = (int16_t) values[1];
+    exec_data->present.has_value2 = true;
+  }
+  if (parsed_values >= 3)
+  {
+    exec_data->value3             = (int16_t) values[2];
+    exec_data->present.has_value3 = true;
+  }
+  if (parsed_values >= 4)
+  {
+    exec_data->value4             = (int16_t) values[3];
+    exec_data->present.has_value4 = true;
+  }
+
+  ESP_LOGI(TAG,
+           "QCSQ parsed: sysmode=%s",
+           enum_to_str(exec_data->sysmode, QCSQ_SYSMODE_MAP, QCSQ_SYSMODE_MAP_SIZE));
   if (exec_data->present.has_value1)
     ESP_LOGI(TAG, "  value1=%d (RSSI)", exec_data->value1);
   if (exec_data->present.has_value2)
@@ -202,7 +183,7 @@ static esp_err_t qcsq_execute_parser(const char* response, void* parsed_data)
 // QCSQ command definition
 const at_cmd_t AT_CMD_QCSQ = {
     .name        = "QCSQ",
-    .description = "Query and Report Signal Strength",
+    .description = AT_CMD_DESCRIPTION("Query and Report Signal Strength"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = {.parser        = qcsq_test_parser,
                                              .formatter     = NULL,
                                              .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
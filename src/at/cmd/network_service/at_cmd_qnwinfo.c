@@ -0,0 +1,96 @@
+#include "at_cmd_qnwinfo.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QNWINFO";
+
+// NOTE: strings as reported by the module in the <Act> field
+const enum_str_map_t QNWINFO_ACT_MAP[QNWINFO_ACT_MAP_SIZE] = {{QNWINFO_ACT_NONE, "No Service"},
+                                                              {QNWINFO_ACT_GSM, "GSM"},
+                                                              {QNWINFO_ACT_EMTC, "eMTC"},
+                                                              {QNWINFO_ACT_NBIOT, "NBIoT"}};
+
+static esp_err_t qnwinfo_execute_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qnwinfo_execute_response_t* exec_data = (qnwinfo_execute_response_t*) parsed_data;
+  memset(exec_data, 0, sizeof(qnwinfo_execute_response_t));
+
+  // Format: +QNWINFO: "<Act>","<oper>","<band>",<channel>  or  +QNWINFO: No Service
+  at_tokenizer_t tok;
+  at_field_t     field;
+  if (at_tokenizer_init(&tok, response, "+QNWINFO: ") != ESP_OK ||
+      at_tokenizer_next(&tok, &field) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to find +QNWINFO: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  int act;
+  if (at_field_to_enum(&field, QNWINFO_ACT_MAP, QNWINFO_ACT_MAP_SIZE, &act) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Unknown access technology: %.*s", (int) field.len, field.start);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  exec_data->act = (qnwinfo_act_t) act;
+  if (exec_data->act == QNWINFO_ACT_NONE)
+  {
+    return ESP_OK;
+  }
+
+  // Each field is only taken if the one before it was
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || field.len == 0 ||
+      at_field_copy(&field, exec_data->operator_numeric, sizeof(exec_data->operator_numeric)) !=
+          ESP_OK)
+  {
+    return ESP_OK;
+  }
+  exec_data->present.has_operator = true;
+
+  if (at_tokenizer_next(&tok, &field) != ESP_OK || field.len == 0 ||
+      at_field_copy(&field, exec_data->band_str, sizeof(exec_data->band_str)) != ESP_OK)
+  {
+    return ESP_OK;
+  }
+  exec_data->present.has_band = true;
+
+  int lte_band = 0;
+  if (sscanf(exec_data->band_str, "LTE BAND %d", &lte_band) == 1 && lte_band > 0)
+  {
+    exec_data->lte_band             = (uint8_t) lte_band;
+    exec_data->present.has_lte_band = true;
+  }
+
+  int32_t channel;
+  if (at_tokenizer_next(&tok, &field) == ESP_OK && at_field_get_int(&field, &channel) == ESP_OK &&
+      channel >= 0)
+  {
+    exec_data->channel             = (uint32_t) channel;
+    exec_data->present.has_channel = true;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QNWINFO = {
+    .name        = "QNWINFO",
+    .description = AT_CMD_DESCRIPTION("Query Network Information"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_EXECUTE] = {.parser        = qnwinfo_execute_parser,
+                                             .formatter     = NULL,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED}},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -9,7 +9,8 @@
 static const char* TAG = "AT_CMD_CGACT";
 
 const enum_str_map_t CGACT_STATE_MAP[CGACT_STATE_MAP_SIZE] = {
-    {CGACT_STATE_DEACTIVATED, "Deactivated"}, {CGACT_STATE_ACTIVATED, "Activated"}};
+    {CGACT_STATE_DEACTIVATED, ENUM_DESC("Deactivated")},
+    {CGACT_STATE_ACTIVATED, ENUM_DESC("Activated")}};
 
 static esp_err_t cgact_read_parser(const char* response, void* parsed_data)
 {
@@ -122,7 +123,7 @@ static esp_err_t cgact_write_formatter(const void* params, char* buffer, size_t
 
 const at_cmd_t AT_CMD_CGACT = {
     .name        = "CGACT",
-    .description = "Activate or Deactivate specified PDP context",
+    .description = AT_CMD_DESCRIPTION("Activate or Deactivate specified PDP context"),
     .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
                     [AT_CMD_TYPE_READ]    = {.parser        = cgact_read_parser,
                                              .formatter     = NULL,
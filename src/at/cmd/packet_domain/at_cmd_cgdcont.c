@@ -1,10 +1,11 @@
 #include "at_cmd_cgdcont.h"
 
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
 #include "enum_utils.h"
 
 #include <esp_log.h>
-#include <string.h> // for strstr, strchr, memset, etc.
+#include <string.h> // for memset
 
 static const char* TAG = "AT_CMD_CGDCONT";
 
@@ -17,19 +18,19 @@ const enum_str_map_t CGDCONT_PDP_TYPE_MAP[CGDCONT_PDP_TYPE_MAP_SIZE] = {
     {CGDCONT_PDP_TYPE_NON_IP, "Non-IP"}};
 
 const enum_str_map_t CGDCONT_DATA_COMP_MAP[CGDCONT_DATA_COMP_MAP_SIZE] = {
-    {CGDCONT_DATA_COMP_OFF, "OFF"},
-    {CGDCONT_DATA_COMP_ON, "ON"},
-    {CGDCONT_DATA_COMP_V42BIS, "V.42bis"}};
+    {CGDCONT_DATA_COMP_OFF, ENUM_DESC("OFF")},
+    {CGDCONT_DATA_COMP_ON, ENUM_DESC("ON")},
+    {CGDCONT_DATA_COMP_V42BIS, ENUM_DESC("V.42bis")}};
 
 const enum_str_map_t CGDCONT_HEAD_COMP_MAP[CGDCONT_HEAD_COMP_MAP_SIZE] = {
-    {CGDCONT_HEAD_COMP_OFF, "OFF"},
-    {CGDCONT_HEAD_COMP_ON, "ON"},
-    {CGDCONT_HEAD_COMP_RFC1144, "RFC 1144"},
-    {CGDCONT_HEAD_COMP_RFC2507, "RFC 2507"},
-    {CGDCONT_HEAD_COMP_RFC3095, "RFC 3095"}};
+    {CGDCONT_HEAD_COMP_OFF, ENUM_DESC("OFF")},
+    {CGDCONT_HEAD_COMP_ON, ENUM_DESC("ON")},
+    {CGDCONT_HEAD_COMP_RFC1144, ENUM_DESC("RFC 1144")},
+    {CGDCONT_HEAD_COMP_RFC2507, ENUM_DESC("RFC 2507")},
+    {CGDCONT_HEAD_COMP_RFC3095, ENUM_DESC("RFC 3095")}};
 
 const enum_str_map_t CGDCONT_IPV4_ADDR_ALLOC_MAP[CGDCONT_IPV4_ADDR_ALLOC_MAP_SIZE] = {
-    {CGDCONT_IPV4_ADDR_ALLOC_NAS, "NAS signaling"}};
+    {CGDCONT_IPV4_ADDR_ALLOC_NAS, ENUM_DESC("NAS signaling")}};
 
 // Parser for test command
 // static esp_err_t cgdcont_test_parser(const char* response, void* parsed_data)
@@ -110,292 +111,101 @@ const enum_str_map_t CGDCONT_IPV4_ADDR_ALLOC_MAP[CGDCONT_IPV4_ADDR_ALLOC_MAP_SIZ
 //   return ESP_OK;
 // }
 
-static esp_err_t cgdcont_read_parser(const char* response, void* parsed_data)
+/* Parse one +CGDCONT: <cid>,<PDP_type>,<APN>,<PDP_addr>,<data_comp>,<head_comp>[,<IPv4AddrAlloc>]
+ * line - everything after the CID is optional. Returns false if the line has no valid CID */
+static bool cgdcont_parse_context(at_tokenizer_t* tok, cgdcont_pdp_context_t* ctx)
 {
-  /* Validate input parameters */
-  if (NULL == response || NULL == parsed_data)
-  {
-    ESP_LOGE(TAG, "Invalid arguments");
-    return ESP_ERR_INVALID_ARG;
-  }
-
-  cgdcont_read_response_t* read_data = (cgdcont_read_response_t*) parsed_data;
-
-  /* Initialize output structure */
-  (void) memset(read_data, 0, sizeof(cgdcont_read_response_t));
+  at_field_t field;
+  int32_t    value;
+  int        enum_value;
 
-  const char* line_start = response;
-  const char* next_line  = NULL;
+  /* Initialize context structure */
+  (void) memset(ctx, 0, sizeof(cgdcont_pdp_context_t));
 
-  /* Process each line in response */
-  while ((line_start = strstr(line_start, "+CGDCONT: ")) != NULL &&
-         read_data->num_contexts < 15) /* Bounds check for maximum contexts */
+  /* Parse CID (required field) */
+  if (at_tokenizer_next(tok, &field) != ESP_OK || at_field_get_int(&field, &value) != ESP_OK ||
+      value < 0 || value > 15)
   {
-    line_start += 10; /* Skip "+CGDCONT: " */
-
-    /* Find the end of this line */
-    next_line = strstr(line_start, "\r\n");
-    if (NULL == next_line)
-    {
-      break; /* No more complete lines */
-    }
-
-    /* Check for empty fields (malformed response) */
-    if (next_line == line_start)
-    {
-      /* Empty field, skip to next line */
-      line_start = next_line + 2;
-      continue;
-    }
-
-    /* Ensure we have enough space for another context */
-    if (read_data->num_contexts >= 15)
-    {
-      break; /* Maximum contexts reached */
-    }
-
-    cgdcont_pdp_context_t* ctx = &read_data->contexts[read_data->num_contexts];
-
-    /* Initialize context structure */
-    (void) memset(ctx, 0, sizeof(cgdcont_pdp_context_t));
-
-    /* Parse CID (required field) */
-    int cid = 0;
-    if (sscanf(line_start, "%d", &cid) != 1)
-    {
-      line_start = next_line + 2; /* Skip to next line */
-      continue;
-    }
-
-    /* Validate CID range for uint8_t */
-    if (cid < 0 || cid > 15)
-    {
-      line_start = next_line + 2;
-      continue;
-    }
-
-    ctx->cid             = (uint8_t) cid;
-    ctx->present.has_cid = true;
-
-    /* Move past the CID to the next field */
-    const char* pos = line_start;
-    while (*pos != ',' && pos < next_line)
-    {
-      pos++;
-    }
-
-    /* Check if we reached a comma or end of line */
-    if (*pos != ',' || pos >= next_line)
-    {
-      read_data->num_contexts++;
-      line_start = next_line + 2;
-      continue;
-    }
-    pos++; /* Skip comma */
-
-    /* Parse PDP type */
-    if (*pos == '"' && (pos + 1) < next_line)
-    {
-      pos++; /* Skip opening quote */
-      const char* pdp_type_end = strchr(pos, '"');
-
-      /* Validate pdp_type_end is within this line */
-      if (pdp_type_end != NULL && pdp_type_end < next_line)
-      {
-        size_t pdp_type_len = pdp_type_end - pos;
-
-        /* Ensure we have space in our buffer with room for null terminator */
-        if (pdp_type_len < 31) /* 32-1 to ensure space for null terminator */
-        {
-          char pdp_type_str[32] = {0};
-          (void) strncpy(pdp_type_str, pos, pdp_type_len);
-          pdp_type_str[pdp_type_len] = '\0'; /* Ensure null-terminated */
-
-          /* Map string to enum */
-          for (int i = 0; i < CGDCONT_PDP_TYPE_MAP_SIZE; i++)
-          {
-            if (strcmp(pdp_type_str, CGDCONT_PDP_TYPE_MAP[i].string) == 0)
-            {
-              ctx->pdp_type             = (cgdcont_pdp_type_t) CGDCONT_PDP_TYPE_MAP[i].value;
-              ctx->present.has_pdp_type = true;
-              break;
-            }
-          }
-
-          pos = pdp_type_end + 1; /* Move past closing quote */
-        }
-      }
-    }
-
-    /* Skip to next field with bounds checking */
-    while (*pos != ',' && pos < next_line)
-    {
-      pos++;
-    }
+    return false;
+  }
+  ctx->cid             = (uint8_t) value;
+  ctx->present.has_cid = true;
 
-    /* Check if we reached a comma or end of line */
-    if (*pos != ',' || pos >= next_line)
-    {
-      read_data->num_contexts++;
-      line_start = next_line + 2;
-      continue;
-    }
-    pos++; /* Skip comma */
+  /* Parse PDP type */
+  if (at_tokenizer_next(tok, &field) == ESP_OK &&
+      at_field_to_enum(&field, CGDCONT_PDP_TYPE_MAP, CGDCONT_PDP_TYPE_MAP_SIZE, &enum_value) ==
+          ESP_OK)
+  {
+    ctx->pdp_type             = (cgdcont_pdp_type_t) enum_value;
+    ctx->present.has_pdp_type = true;
+  }
 
-    /* Parse APN */
-    if (*pos == '"' && (pos + 1) < next_line)
-    {
-      pos++; /* Skip opening quote */
-      const char* apn_end = strchr(pos, '"');
+  /* Parse APN - an empty one is still present */
+  if (at_tokenizer_next(tok, &field) == ESP_OK && AT_FIELD_STRING == field.type &&
+      at_field_copy(&field, ctx->apn, sizeof(ctx->apn)) == ESP_OK)
+  {
+    ctx->present.has_apn = true;
+  }
 
-      /* Validate apn_end is within this line */
-      if (apn_end != NULL && apn_end < next_line)
-      {
-        size_t apn_len     = apn_end - pos;
-        size_t max_apn_len = sizeof(ctx->apn) - 1; /* Leave room for null terminator */
-
-        if (apn_len <= max_apn_len)
-        {
-          (void) strncpy(ctx->apn, pos, apn_len);
-          ctx->apn[apn_len]    = '\0'; /* Ensure null-terminated */
-          ctx->present.has_apn = true;
-          pos                  = apn_end + 1; /* Move past closing quote */
-        }
-      }
-    }
+  /* Parse PDP address */
+  if (at_tokenizer_next(tok, &field) == ESP_OK && AT_FIELD_STRING == field.type &&
+      at_field_copy(&field, ctx->pdp_addr, sizeof(ctx->pdp_addr)) == ESP_OK)
+  {
+    ctx->present.has_pdp_addr = true;
+  }
 
-    /* Skip to next field with bounds checking */
-    while (*pos != ',' && pos < next_line)
-    {
-      pos++;
-    }
+  /* Parse data compression */
+  if (at_tokenizer_next(tok, &field) == ESP_OK && at_field_get_int(&field, &value) == ESP_OK &&
+      value >= 0 && value < CGDCONT_DATA_COMP_MAP_SIZE)
+  {
+    ctx->data_comp             = (cgdcont_data_comp_t) value;
+    ctx->present.has_data_comp = true;
+  }
 
-    /* Check if we reached a comma or end of line */
-    if (*pos != ',' || pos >= next_line)
-    {
-      read_data->num_contexts++;
-      line_start = next_line + 2;
-      continue;
-    }
-    pos++; /* Skip comma */
+  /* Parse header compression */
+  if (at_tokenizer_next(tok, &field) == ESP_OK && at_field_get_int(&field, &value) == ESP_OK &&
+      value >= 0 && value < CGDCONT_HEAD_COMP_MAP_SIZE)
+  {
+    ctx->head_comp             = (cgdcont_head_comp_t) value;
+    ctx->present.has_head_comp = true;
+  }
 
-    /* Parse PDP address */
-    if (*pos == '"' && (pos + 1) < next_line)
-    {
-      pos++; /* Skip opening quote */
-      const char* addr_end = strchr(pos, '"');
+  /* Parse IPv4 address allocation if present */
+  if (at_tokenizer_next(tok, &field) == ESP_OK && at_field_get_int(&field, &value) == ESP_OK &&
+      value >= 0 && value < CGDCONT_IPV4_ADDR_ALLOC_MAP_SIZE)
+  {
+    ctx->ipv4_addr_alloc             = (cgdcont_ipv4_addr_alloc_t) value;
+    ctx->present.has_ipv4_addr_alloc = true;
+  }
 
-      /* Validate addr_end is within this line */
-      if (addr_end != NULL && addr_end < next_line)
-      {
-        size_t addr_len     = addr_end - pos;
-        size_t max_addr_len = sizeof(ctx->pdp_addr) - 1; /* Leave room for null terminator */
-
-        if (addr_len <= max_addr_len)
-        {
-          (void) strncpy(ctx->pdp_addr, pos, addr_len);
-          ctx->pdp_addr[addr_len]   = '\0'; /* Ensure null-terminated */
-          ctx->present.has_pdp_addr = true;
-          pos                       = addr_end + 1; /* Move past closing quote */
-        }
-      }
-    }
+  return true;
+}
 
-    /* Skip to next field with bounds checking */
-    while (*pos != ',' && pos < next_line)
-    {
-      pos++;
-    }
+static esp_err_t cgdcont_read_parser(const char* response, void* parsed_data)
+{
+  /* Validate input parameters */
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
 
-    /* Check if we reached a comma or end of line */
-    if (*pos != ',' || pos >= next_line)
-    {
-      read_data->num_contexts++;
-      line_start = next_line + 2;
-      continue;
-    }
-    pos++; /* Skip comma */
+  cgdcont_read_response_t* read_data = (cgdcont_read_response_t*) parsed_data;
 
-    /* Parse data compression with bounds checking */
-    if (pos < next_line)
-    {
-      int data_comp = 0;
-      if (sscanf(pos, "%d", &data_comp) == 1)
-      {
-        if (data_comp >= 0 && data_comp < CGDCONT_DATA_COMP_MAP_SIZE)
-        {
-          ctx->data_comp             = (cgdcont_data_comp_t) data_comp;
-          ctx->present.has_data_comp = true;
-        }
-      }
-    }
+  /* Initialize output structure */
+  (void) memset(read_data, 0, sizeof(cgdcont_read_response_t));
 
-    /* Skip to next field with bounds checking */
-    while (*pos != ',' && pos < next_line)
-    {
-      pos++;
-    }
+  /* Process each line in response */
+  at_tokenizer_t tok;
+  esp_err_t      err = at_tokenizer_init(&tok, response, "+CGDCONT: ");
 
-    /* Check if we reached a comma or end of line */
-    if (*pos != ',' || pos >= next_line)
+  while (ESP_OK == err && read_data->num_contexts < 15) /* Bounds check for maximum contexts */
+  {
+    if (cgdcont_parse_context(&tok, &read_data->contexts[read_data->num_contexts]))
     {
       read_data->num_contexts++;
-      line_start = next_line + 2;
-      continue;
-    }
-    pos++; /* Skip comma */
-
-    /* Parse header compression with bounds checking */
-    if (pos < next_line)
-    {
-      int head_comp = 0;
-      if (sscanf(pos, "%d", &head_comp) == 1)
-      {
-        if (head_comp >= 0 && head_comp < CGDCONT_HEAD_COMP_MAP_SIZE)
-        {
-          ctx->head_comp             = (cgdcont_head_comp_t) head_comp;
-          ctx->present.has_head_comp = true;
-        }
-      }
-    }
-
-    /* Skip to next field with bounds checking */
-    while (*pos != ',' && pos < next_line)
-    {
-      pos++;
-    }
-
-    /* Process IPv4 address allocation if present */
-    if (*pos == ',' && (pos + 1) < next_line)
-    {
-      pos++; /* Skip comma */
-
-      /* Parse IPv4 address allocation with bounds checking */
-      if (pos < next_line)
-      {
-        int ipv4_addr_alloc = 0;
-        if (sscanf(pos, "%d", &ipv4_addr_alloc) == 1)
-        {
-          if (ipv4_addr_alloc >= 0 && ipv4_addr_alloc < CGDCONT_IPV4_ADDR_ALLOC_MAP_SIZE)
-          {
-            ctx->ipv4_addr_alloc             = (cgdcont_ipv4_addr_alloc_t) ipv4_addr_alloc;
-            ctx->present.has_ipv4_addr_alloc = true;
-          }
-        }
-      }
-    }
-
-    read_data->num_contexts++;
-
-    /* Move to next line with safety check */
-    if (next_line != NULL && next_line + 2 <= response + strlen(response))
-    {
-      line_start = next_line + 2;
-    }
-    else
-    {
-      break; /* End of string or no more complete lines */
     }
+    err = at_tokenizer_next_line(&tok);
   }
 
   return ESP_OK;
@@ -535,7 +345,7 @@ static esp_err_t cgdcont_write_formatter(const void* params, char* buffer, size_
 // CGDCONT command definition
 const at_cmd_t AT_CMD_CGDCONT = {
     .name        = "CGDCONT",
-    .description = "Define PDP Context",
+    .description = AT_CMD_DESCRIPTION("Define PDP Context"),
     .type_info   = {[AT_CMD_TYPE_TEST] = AT_CMD_TYPE_NOT_IMPLEMENTED,
                     // [AT_CMD_TYPE_TEST]    = {.parser = cgdcont_test_parser, .formatter = NULL},
                     [AT_CMD_TYPE_READ]    = {.parser        = cgdcont_read_parser,
@@ -94,7 +94,7 @@ static esp_err_t cpin_cmd_write_type_formatter(const void* params, char* buffer,
 // CPIN command definition
 const at_cmd_t AT_CMD_CPIN = {
     .name        = "CPIN",
-    .description = "Enter PIN",
+    .description = AT_CMD_DESCRIPTION("Enter PIN"),
     .type_info   = {[AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_NOT_IMPLEMENTED,
                     [AT_CMD_TYPE_TEST]    = {.parser        = NULL,
                                              .formatter     = NULL,
@@ -0,0 +1,286 @@
+#include "at_cmd_qsslcfg.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QSSLCFG";
+
+const enum_str_map_t QSSLCFG_TYPE_MAP[QSSLCFG_TYPE_MAP_SIZE] = {
+    {QSSLCFG_TYPE_SSLVERSION, "sslversion"},
+    {QSSLCFG_TYPE_CIPHERSUITE, "ciphersuite"},
+    {QSSLCFG_TYPE_CACERT, "cacert"},
+    {QSSLCFG_TYPE_CLIENTCERT, "clientcert"},
+    {QSSLCFG_TYPE_CLIENTKEY, "clientkey"},
+    {QSSLCFG_TYPE_SECLEVEL, "seclevel"},
+    {QSSLCFG_TYPE_IGNORELOCALTIME, "ignorelocaltime"},
+    {QSSLCFG_TYPE_NEGOTIATETIME, "negotiatetime"},
+    {QSSLCFG_TYPE_SNI, "sni"},
+    {QSSLCFG_TYPE_SESSION_CACHE, "session_cache"}};
+
+const enum_str_map_t QSSLCFG_SSLVERSION_MAP[QSSLCFG_SSLVERSION_MAP_SIZE] = {
+    {QSSLCFG_SSLVERSION_SSL3_0, ENUM_DESC("SSL 3.0")},
+    {QSSLCFG_SSLVERSION_TLS1_0, ENUM_DESC("TLS 1.0")},
+    {QSSLCFG_SSLVERSION_TLS1_1, ENUM_DESC("TLS 1.1")},
+    {QSSLCFG_SSLVERSION_TLS1_2, ENUM_DESC("TLS 1.2")},
+    {QSSLCFG_SSLVERSION_ALL, ENUM_DESC("All")}};
+
+const enum_str_map_t QSSLCFG_SECLEVEL_MAP[QSSLCFG_SECLEVEL_MAP_SIZE] = {
+    {QSSLCFG_SECLEVEL_NONE, ENUM_DESC("No authentication")},
+    {QSSLCFG_SECLEVEL_SERVER, ENUM_DESC("Server authentication")},
+    {QSSLCFG_SECLEVEL_SERVER_CLIENT, ENUM_DESC("Server and client authentication")}};
+
+static esp_err_t qsslcfg_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qsslcfg_write_params_t* write_params = (const qsslcfg_write_params_t*) params;
+
+  const char* type_str = enum_to_str(write_params->type, QSSLCFG_TYPE_MAP, QSSLCFG_TYPE_MAP_SIZE);
+  if (strcmp(type_str, "UNKNOWN") == 0)
+  {
+    ESP_LOGE(TAG, "Invalid QSSLCFG type: %d", write_params->type);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->ctx_id > QSSLCFG_CTX_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid SSL context: %d", write_params->ctx_id);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: ="<type>",<SSL_ctxID>[,<value>]
+  int written;
+  if (!write_params->present.has_value)
+  {
+    written = snprintf(buffer, buffer_size, "=\"%s\",%d", type_str, write_params->ctx_id);
+  }
+  else
+  {
+    switch (write_params->type)
+    {
+      case QSSLCFG_TYPE_SSLVERSION:
+        if (write_params->value.sslversion > QSSLCFG_SSLVERSION_ALL)
+        {
+          ESP_LOGE(TAG, "Invalid SSL version: %d", write_params->value.sslversion);
+          return ESP_ERR_INVALID_ARG;
+        }
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",%d,%d",
+                           type_str,
+                           write_params->ctx_id,
+                           write_params->value.sslversion);
+        break;
+      case QSSLCFG_TYPE_CIPHERSUITE:
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",%d,0X%04X",
+                           type_str,
+                           write_params->ctx_id,
+                           write_params->value.ciphersuite);
+        break;
+      case QSSLCFG_TYPE_CACERT:
+      case QSSLCFG_TYPE_CLIENTCERT:
+      case QSSLCFG_TYPE_CLIENTKEY:
+      {
+        size_t path_len = strnlen(write_params->value.path, sizeof(write_params->value.path));
+        if (path_len == 0 || path_len > QSSLCFG_PATH_MAX_LEN)
+        {
+          ESP_LOGE(TAG, "Invalid %s path", type_str);
+          return ESP_ERR_INVALID_ARG;
+        }
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",%d,\"%s\"",
+                           type_str,
+                           write_params->ctx_id,
+                           write_params->value.path);
+        break;
+      }
+      case QSSLCFG_TYPE_SECLEVEL:
+        if (write_params->value.seclevel > QSSLCFG_SECLEVEL_SERVER_CLIENT)
+        {
+          ESP_LOGE(TAG, "Invalid security level: %d", write_params->value.seclevel);
+          return ESP_ERR_INVALID_ARG;
+        }
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",%d,%d",
+                           type_str,
+                           write_params->ctx_id,
+                           write_params->value.seclevel);
+        break;
+      case QSSLCFG_TYPE_NEGOTIATETIME:
+        if (write_params->value.negotiate_time_s < QSSLCFG_NEGOTIATE_TIME_MIN_S ||
+            write_params->value.negotiate_time_s > QSSLCFG_NEGOTIATE_TIME_MAX_S)
+        {
+          ESP_LOGE(TAG, "Invalid negotiate time: %d", write_params->value.negotiate_time_s);
+          return ESP_ERR_INVALID_ARG;
+        }
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",%d,%d",
+                           type_str,
+                           write_params->ctx_id,
+                           write_params->value.negotiate_time_s);
+        break;
+      case QSSLCFG_TYPE_IGNORELOCALTIME:
+      case QSSLCFG_TYPE_SNI:
+      case QSSLCFG_TYPE_SESSION_CACHE:
+        written = snprintf(buffer,
+                           buffer_size,
+                           "=\"%s\",%d,%d",
+                           type_str,
+                           write_params->ctx_id,
+                           write_params->value.enable ? 1 : 0);
+        break;
+      default:
+        return ESP_ERR_INVALID_ARG;
+    }
+  }
+
+  if ((written < 0) || ((size_t) written >= buffer_size))
+  {
+    if (buffer_size > 0U)
+    {
+      buffer[0] = '\0';
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qsslcfg_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qsslcfg_write_response_t* write_response = (qsslcfg_write_response_t*) parsed_data;
+  memset(write_response, 0, sizeof(qsslcfg_write_response_t));
+
+  // Format: +QSSLCFG: "<type>",<SSL_ctxID>,<value>
+  const char* data_start = strstr(response, "+QSSLCFG: \"");
+  if (NULL == data_start)
+  {
+    // No data response, only OK response - the value was set, not queried
+    return ESP_OK;
+  }
+  data_start += 11; // Skip "+QSSLCFG: \""
+
+  char type_str[16] = {0};
+  int  ctx_id;
+  int  consumed = 0;
+  if (sscanf(data_start, "%15[^\"]\",%d,%n", type_str, &ctx_id, &consumed) != 2 || consumed == 0 ||
+      ctx_id < 0 || ctx_id > QSSLCFG_CTX_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Malformed response: %s", data_start);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  enum_convert_result_t type = str_to_enum(type_str, QSSLCFG_TYPE_MAP, QSSLCFG_TYPE_MAP_SIZE);
+  if (!type.is_valid)
+  {
+    ESP_LOGE(TAG, "Unsupported SSL setting: %s", type_str);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  write_response->type   = (qsslcfg_type_t) type.value;
+  write_response->ctx_id = (uint8_t) ctx_id;
+
+  const char*      value_start = data_start + consumed;
+  qsslcfg_value_t* value       = &write_response->value;
+  int              number;
+  switch (write_response->type)
+  {
+    case QSSLCFG_TYPE_CIPHERSUITE:
+    {
+      // e.g. 0X0035 - the module may quote it
+      unsigned int suite;
+      if (sscanf(value_start, "\"%x", &suite) != 1 && sscanf(value_start, "%x", &suite) != 1)
+      {
+        ESP_LOGE(TAG, "Malformed cipher suite: %s", value_start);
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      value->ciphersuite = (uint16_t) suite;
+      break;
+    }
+    case QSSLCFG_TYPE_CACERT:
+    case QSSLCFG_TYPE_CLIENTCERT:
+    case QSSLCFG_TYPE_CLIENTKEY:
+    {
+      // Quoted path
+      if (value_start[0] != '"')
+      {
+        ESP_LOGE(TAG, "Malformed %s path: %s", type_str, value_start);
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      size_t len = strcspn(value_start + 1, "\"\r\n");
+      if (value_start[1 + len] != '"' || len > QSSLCFG_PATH_MAX_LEN)
+      {
+        ESP_LOGE(TAG, "Malformed %s path: %s", type_str, value_start);
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      memcpy(value->path, value_start + 1, len);
+      value->path[len] = '\0';
+      break;
+    }
+    default:
+      if (sscanf(value_start, "%d", &number) != 1 || number < 0)
+      {
+        ESP_LOGE(TAG, "Malformed %s value: %s", type_str, value_start);
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      if ((write_response->type == QSSLCFG_TYPE_SSLVERSION && number > QSSLCFG_SSLVERSION_ALL) ||
+          (write_response->type == QSSLCFG_TYPE_SECLEVEL &&
+           number > QSSLCFG_SECLEVEL_SERVER_CLIENT) ||
+          number > UINT16_MAX)
+      {
+        ESP_LOGE(TAG, "Invalid %s value: %d", type_str, number);
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+
+      if (write_response->type == QSSLCFG_TYPE_SSLVERSION)
+      {
+        value->sslversion = (qsslcfg_sslversion_t) number;
+      }
+      else if (write_response->type == QSSLCFG_TYPE_SECLEVEL)
+      {
+        value->seclevel = (qsslcfg_seclevel_t) number;
+      }
+      else if (write_response->type == QSSLCFG_TYPE_NEGOTIATETIME)
+      {
+        value->negotiate_time_s = (uint16_t) number;
+      }
+      else
+      {
+        value->enable = number != 0;
+      }
+      break;
+  }
+
+  write_response->has_data = true;
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QSSLCFG = {
+    .name        = "QSSLCFG",
+    .description = AT_CMD_DESCRIPTION("Configure Parameters of an SSL Context"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qsslcfg_write_parser,
+                                             .formatter     = qsslcfg_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_OPTIONAL},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 300 // 300ms per spec
+};
@@ -0,0 +1,62 @@
+#include "at_cmd_qiclose.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QICLOSE";
+
+static esp_err_t qiclose_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qiclose_write_params_t* write_params = (const qiclose_write_params_t*) params;
+
+  if (write_params->connect_id > QICLOSE_CONNECT_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid connect_id: %d", write_params->connect_id);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written;
+  if (write_params->present.has_timeout)
+  {
+    written = snprintf(
+        buffer, buffer_size, "=%d,%d", write_params->connect_id, write_params->timeout_s);
+  }
+  else
+  {
+    written = snprintf(buffer, buffer_size, "=%d", write_params->connect_id);
+  }
+
+  if (written < 0 || (size_t) written >= buffer_size)
+  {
+    ESP_LOGE(TAG, "Buffer too small for QICLOSE write command");
+    if (buffer_size > 0)
+    {
+      buffer[0] = '\0'; // Ensure null-terminated in case of overflow
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QICLOSE = {
+    .name        = "QICLOSE",
+    .description = AT_CMD_DESCRIPTION("Close a Socket Service"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qiclose_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 11000 // Default close timeout (10s) plus margin
+};
@@ -0,0 +1,157 @@
+#include "at_cmd_qiopen.h"
+
+#include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QIOPEN";
+
+const enum_str_map_t QIOPEN_SERVICE_TYPE_MAP[QIOPEN_SERVICE_TYPE_MAP_SIZE] = {
+    {QIOPEN_SERVICE_TYPE_TCP, "TCP"}, {QIOPEN_SERVICE_TYPE_UDP, "UDP"}};
+
+const enum_str_map_t QIOPEN_ACCESS_MODE_MAP[QIOPEN_ACCESS_MODE_MAP_SIZE] = {
+    {QIOPEN_ACCESS_MODE_BUFFER, ENUM_DESC("Buffer access mode")},
+    {QIOPEN_ACCESS_MODE_DIRECT_PUSH, ENUM_DESC("Direct push mode")},
+    {QIOPEN_ACCESS_MODE_TRANSPARENT, ENUM_DESC("Transparent access mode")}};
+
+static esp_err_t qiopen_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qiopen_write_params_t* write_params = (const qiopen_write_params_t*) params;
+
+  if (write_params->context_id < QIOPEN_CONTEXT_ID_MIN ||
+      write_params->context_id > QIOPEN_CONTEXT_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid context_id: %d", write_params->context_id);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->connect_id > QIOPEN_CONNECT_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid connect_id: %d", write_params->connect_id);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const char* service_type = enum_to_str(
+      write_params->service_type, QIOPEN_SERVICE_TYPE_MAP, QIOPEN_SERVICE_TYPE_MAP_SIZE);
+  if (strcmp(service_type, "UNKNOWN") == 0)
+  {
+    ESP_LOGE(TAG, "Invalid service type: %d", write_params->service_type);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->host[0] == '\0')
+  {
+    ESP_LOGE(TAG, "Empty host is not allowed");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->present.has_access_mode &&
+      write_params->access_mode > QIOPEN_ACCESS_MODE_TRANSPARENT)
+  {
+    ESP_LOGE(TAG, "Invalid access mode: %d", write_params->access_mode);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Format: =<contextID>,<connectID>,<service_type>,<IP_address>/<domain_name>,<remote_port>
+  //         [,<local_port>[,<access_mode>]]
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "=%d,%d,\"%s\",\"%s\",%d",
+                         write_params->context_id,
+                         write_params->connect_id,
+                         service_type,
+                         write_params->host,
+                         write_params->remote_port);
+
+  // The access mode can only be given together with the local port
+  if (written > 0 && (size_t) written < buffer_size &&
+      (write_params->present.has_local_port || write_params->present.has_access_mode))
+  {
+    written += snprintf(buffer + written, buffer_size - written, ",%d", write_params->local_port);
+  }
+
+  if (written > 0 && (size_t) written < buffer_size && write_params->present.has_access_mode)
+  {
+    written += snprintf(buffer + written, buffer_size - written, ",%d", write_params->access_mode);
+  }
+
+  if (written < 0 || (size_t) written >= buffer_size)
+  {
+    ESP_LOGE(TAG, "Buffer too small for QIOPEN write command");
+    if (buffer_size > 0)
+    {
+      buffer[0] = '\0'; // Ensure null-terminated in case of overflow
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qiopen_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qiopen_write_response_t* write_resp = (qiopen_write_response_t*) parsed_data;
+  memset(write_resp, 0, sizeof(qiopen_write_response_t));
+
+  // URC response format: +QIOPEN: <connectID>,<err>
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, "+QIOPEN: ") != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to find +QIOPEN: in response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  at_field_t id_field, result_field;
+  int32_t    connect_id, result;
+  if (at_tokenizer_next(&tok, &id_field) != ESP_OK ||
+      at_tokenizer_next(&tok, &result_field) != ESP_OK ||
+      at_field_get_int(&id_field, &connect_id) != ESP_OK ||
+      at_field_get_int(&result_field, &result) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse QIOPEN response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  if (connect_id >= QIOPEN_CONNECT_ID_MIN && connect_id <= QIOPEN_CONNECT_ID_MAX)
+  {
+    write_resp->connect_id             = (uint8_t) connect_id;
+    write_resp->present.has_connect_id = true;
+  }
+  else
+  {
+    ESP_LOGW(TAG, "Invalid connect_id in response: %ld", (long) connect_id);
+  }
+
+  write_resp->result             = result;
+  write_resp->present.has_result = true;
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QIOPEN = {
+    .name        = "QIOPEN",
+    .description = AT_CMD_DESCRIPTION("Open a Socket Service"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qiopen_write_parser,
+                                             .formatter     = qiopen_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 150000 // 150s per spec (depends on the network)
+};
@@ -0,0 +1,120 @@
+#include "at_cmd_qird.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QIRD";
+
+esp_err_t qird_locate_payload(const char* response, size_t* payload_offset, size_t* payload_len)
+{
+  if (NULL == response || NULL == payload_offset || NULL == payload_len)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const char* start = strstr(response, "+QIRD: ");
+  if (!start)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // The header is only complete once its CRLF has been received
+  const char* header_end = strstr(start, "\r\n");
+  if (!header_end)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  char*         end;
+  unsigned long length = strtoul(start + 7, &end, 10); // Skip "+QIRD: "
+  if (end == start + 7 || end != header_end || length > QIRD_READ_MAX_LEN)
+  {
+    ESP_LOGE(TAG, "Invalid QIRD header");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  *payload_offset = (size_t) (header_end + 2 - response);
+  *payload_len    = (size_t) length;
+  return ESP_OK;
+}
+
+static esp_err_t qird_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qird_write_params_t* write_params = (const qird_write_params_t*) params;
+
+  if (write_params->connect_id > QIRD_CONNECT_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid connect_id: %d", write_params->connect_id);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // NOTE: A read length of 0 queries the buffer state instead, which has a different response
+  if (write_params->read_length == 0 || write_params->read_length > QIRD_READ_MAX_LEN)
+  {
+    ESP_LOGE(TAG,
+             "Invalid read_length: %d (must be 1-%d)",
+             write_params->read_length,
+             QIRD_READ_MAX_LEN);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written =
+      snprintf(buffer, buffer_size, "=%d,%d", write_params->connect_id, write_params->read_length);
+  if (written < 0 || (size_t) written >= buffer_size)
+  {
+    ESP_LOGE(TAG, "Buffer too small for QIRD write command");
+    if (buffer_size > 0)
+    {
+      buffer[0] = '\0'; // Ensure null-terminated in case of overflow
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t qird_write_parser(const char* response, void* parsed_data)
+{
+  if (NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qird_write_response_t* write_resp = (qird_write_response_t*) parsed_data;
+  memset(write_resp, 0, sizeof(qird_write_response_t));
+
+  size_t    payload_offset, payload_len;
+  esp_err_t err = qird_locate_payload(response, &payload_offset, &payload_len);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to parse QIRD response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  write_resp->read_actual_length = (uint16_t) payload_len;
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QIRD = {
+    .name        = "QIRD",
+    .description = AT_CMD_DESCRIPTION("Retrieve the Received TCP/IP Data"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = qird_write_parser,
+                                             .formatter     = qird_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_DATA_REQUIRED},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 1000 // Data is already buffered in the module
+};
@@ -0,0 +1,62 @@
+#include "at_cmd_qisend.h"
+
+#include "at_cmd_structure.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_QISEND";
+
+static esp_err_t qisend_write_formatter(const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const qisend_write_params_t* write_params = (const qisend_write_params_t*) params;
+
+  if (write_params->connect_id > QISEND_CONNECT_ID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid connect_id: %d", write_params->connect_id);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (write_params->send_length == 0 || write_params->send_length > QISEND_DATA_MAX_LEN)
+  {
+    ESP_LOGE(TAG,
+             "Invalid send_length: %d (must be 1-%d)",
+             write_params->send_length,
+             QISEND_DATA_MAX_LEN);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int written =
+      snprintf(buffer, buffer_size, "=%d,%d", write_params->connect_id, write_params->send_length);
+  if (written < 0 || (size_t) written >= buffer_size)
+  {
+    ESP_LOGE(TAG, "Buffer too small for QISEND write command");
+    if (buffer_size > 0)
+    {
+      buffer[0] = '\0'; // Ensure null-terminated in case of overflow
+    }
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  return ESP_OK;
+}
+
+const at_cmd_t AT_CMD_QISEND = {
+    .name        = "QISEND",
+    .description = AT_CMD_DESCRIPTION("Send Data"),
+    .type_info   = {[AT_CMD_TYPE_TEST]    = AT_CMD_TYPE_NOT_IMPLEMENTED,
+                    [AT_CMD_TYPE_READ]    = AT_CMD_TYPE_DOES_NOT_EXIST,
+                    [AT_CMD_TYPE_WRITE]   = {.parser        = NULL,
+                                             .formatter     = qisend_write_formatter,
+                                             .response_type = AT_CMD_RESPONSE_TYPE_SIMPLE_ONLY},
+                    [AT_CMD_TYPE_EXECUTE] = AT_CMD_TYPE_DOES_NOT_EXIST},
+    .timeout_ms  = 5000 // SEND OK only means the data reached the module send buffer
+};
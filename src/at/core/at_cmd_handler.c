@@ -7,6 +7,7 @@
 #include "esp_log.h"
 #include "freertos/projdefs.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 static const char* TAG = "AT_CMD_HANDLER";
@@ -20,9 +21,88 @@ esp_err_t at_cmd_handler_init(at_cmd_handler_t* handler, bg95_uart_interface_t*
 
   memset(handler, 0, sizeof(at_cmd_handler_t));
   handler->uart = *uart;
+
+  handler->lock = xSemaphoreCreateRecursiveMutex();
+  if (!handler->lock)
+  {
+    ESP_LOGE(TAG, "Failed to create handler lock");
+    return ESP_ERR_NO_MEM;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_handler_deinit(at_cmd_handler_t* handler)
+{
+  if (!handler)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (handler->lock)
+  {
+    vSemaphoreDelete(handler->lock);
+    handler->lock = NULL;
+  }
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_handler_bind_uart(at_cmd_handler_t* handler, const bg95_uart_interface_t* uart)
+{
+  if (!handler || !handler->lock || !uart || !uart->write || !uart->read)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  if (handler->mode != AT_CMD_MODE_COMMAND)
+  {
+    xSemaphoreGiveRecursive(handler->lock);
+    ESP_LOGE(TAG, "Can not change the UART in data mode");
+    return ESP_ERR_INVALID_STATE;
+  }
+  handler->uart = *uart;
+  xSemaphoreGiveRecursive(handler->lock);
   return ESP_OK;
 }
 
+// Everything the handler sends or receives goes through these, so the bytes of an exchange can be
+// counted for the metrics
+static esp_err_t uart_write(at_cmd_handler_t* handler, const char* data, size_t len)
+{
+  esp_err_t err = handler->uart.write(data, len, handler->uart.context);
+  if (err == ESP_OK)
+  {
+    handler->exchange.bytes_tx += (uint32_t) len;
+  }
+  return err;
+}
+
+static esp_err_t uart_read(at_cmd_handler_t* handler,
+                           char*             buffer,
+                           size_t            max_len,
+                           size_t*           bytes_read,
+                           uint32_t          timeout_ms)
+{
+  esp_err_t err =
+      handler->uart.read(buffer, max_len, bytes_read, timeout_ms, handler->uart.context);
+  if (err == ESP_OK)
+  {
+    handler->exchange.bytes_rx += (uint32_t) *bytes_read;
+  }
+  return err;
+}
+
+// UART writes only queue the data. Only needed where timing starts once the bytes are on the wire
+static esp_err_t wait_tx_done(at_cmd_handler_t* handler)
+{
+  if (!handler->uart.wait_tx_done)
+  {
+    return ESP_OK;
+  }
+  return handler->uart.wait_tx_done(AT_CMD_TX_DONE_TIMEOUT_MS, handler->uart.context);
+}
+
 bool has_command_terminated(const char* raw_response, const at_cmd_t* cmd, at_cmd_type_t type)
 {
   if (NULL == raw_response || NULL == cmd)
@@ -42,6 +122,12 @@ bool has_command_terminated(const char* raw_response, const at_cmd_t* cmd, at_cm
   const char* error_pos = strstr(raw_response, AT_ERROR);
   const char* cme_pos   = strstr(raw_response, AT_CME_ERROR);
 
+  // Data written after a '>' prompt (e.g. QISEND) is acknowledged with SEND OK / SEND FAIL instead
+  if (strstr(raw_response, AT_SEND_OK) || strstr(raw_response, AT_SEND_FAIL))
+  {
+    return true;
+  }
+
   // No terminator found yet
   if (!ok_pos && !error_pos && !cme_pos)
   {
@@ -165,6 +251,57 @@ esp_err_t parse_at_cmd_specific_data_response(const at_cmd_t*             cmd,
   }
 }
 
+// Pass every complete '+' line of 'text' to the URC handler. The lines of the command's own data
+// response are passed as well - the URC handler only acts on the prefixes it knows
+static void dispatch_urcs(at_cmd_handler_t* handler, const char* text)
+{
+  if (!handler->urc_handler)
+  {
+    return;
+  }
+
+  const char* line = text;
+  while ((line = strchr(line, '+')) != NULL)
+  {
+    const char* line_end = strstr(line, AT_CRLF);
+    if (!line_end)
+    {
+      break; // Incomplete line
+    }
+
+    // Only lines that start with '+' (not a '+' within a line)
+    if (line == text || line[-1] == '\n')
+    {
+      handler->urc_handler(line, (size_t) (line_end - line), handler->urc_context);
+    }
+    line = line_end;
+  }
+}
+
+// Any character sent while a command is running aborts it (e.g. AT+COPS=?). Send a full 'AT' so the
+// module also answers, then drain until the UART is quiet
+static void abort_at_cmd(at_cmd_handler_t* handler)
+{
+  char     drain_buffer[AT_CMD_READ_CHUNK_SIZE];
+  size_t   bytes_read = 0;
+  uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  uart_write(handler, "AT\r\n", 4);
+
+  while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < AT_CMD_ABORT_DRAIN_MS)
+  {
+    if (uart_read(handler,
+                  drain_buffer,
+                  sizeof(drain_buffer) - 1,
+                  &bytes_read,
+                  AT_CMD_READ_CHUNK_INTERVAL_MS) != ESP_OK ||
+        bytes_read == 0)
+    {
+      break;
+    }
+  }
+}
+
 esp_err_t read_at_cmd_response(at_cmd_handler_t* handler,
                                const at_cmd_t*   cmd,
                                at_cmd_type_t     type,
@@ -176,14 +313,19 @@ esp_err_t read_at_cmd_response(at_cmd_handler_t* handler,
   char     temp_buffer[AT_CMD_READ_CHUNK_SIZE];
   bool     response_complete = false;
 
+  if (buffer_size > 0)
+  {
+    response_buffer[0] = '\0';
+  }
+
   while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < cmd->timeout_ms)
   {
     size_t    bytes_read = 0;
-    esp_err_t err        = handler->uart.read(temp_buffer,
-                                       sizeof(temp_buffer) - 1,
-                                       &bytes_read,
-                                       AT_CMD_READ_CHUNK_INTERVAL_MS,
-                                       handler->uart.context);
+    esp_err_t err        = uart_read(handler,
+                                     temp_buffer,
+                                     sizeof(temp_buffer) - 1,
+                                     &bytes_read,
+                                     AT_CMD_READ_CHUNK_INTERVAL_MS);
 
     if (err == ESP_OK && bytes_read > 0)
     {
@@ -202,24 +344,75 @@ esp_err_t read_at_cmd_response(at_cmd_handler_t* handler,
         break;
       }
     }
+
+    // Also on reads without data, so a command the module is silent on (AT+COPS=? until the scan
+    // ends) can still be cancelled
+    if (handler->rx_observer &&
+        !handler->rx_observer(response_buffer, total_bytes_read, handler->rx_observer_context))
+    {
+      ESP_LOGW(TAG, "Command %s aborted while reading response", cmd->name);
+      abort_at_cmd(handler);
+      return ESP_ERR_INVALID_STATE;
+    }
     vTaskDelay(pdMS_TO_TICKS(1));
   }
 
   return response_complete ? ESP_OK : ESP_ERR_TIMEOUT;
 }
 
-esp_err_t at_cmd_handler_send_and_receive_cmd(at_cmd_handler_t* handler,
-                                              const at_cmd_t*   cmd,
-                                              at_cmd_type_t     type,
-                                              const void*       params,
-                                              void*             response_data)
+// Trace an event of the command being sent - the latency is counted from the write of the command
+static void trace_cmd_event(at_cmd_handler_t*    handler,
+                            at_cmd_trace_event_t event,
+                            const at_cmd_t*      cmd,
+                            at_cmd_type_t        type,
+                            esp_err_t            result,
+                            const char*          data,
+                            size_t               len)
 {
-  if (!handler || !cmd)
+  if (handler->trace)
   {
-    ESP_LOGE(TAG, "Invalid arguments provided");
-    return ESP_ERR_INVALID_ARG;
+    uint32_t latency_ms = pdTICKS_TO_MS(xTaskGetTickCount()) - handler->cmd_sent_ms;
+    at_cmd_trace_record(handler->trace, event, cmd, type, result, latency_ms, data, len);
+  }
+}
+
+static void trace_response(at_cmd_handler_t* handler,
+                           const at_cmd_t*   cmd,
+                           at_cmd_type_t     type,
+                           esp_err_t         result,
+                           const char*       response)
+{
+  if (handler->trace)
+  {
+    trace_cmd_event(
+        handler, AT_CMD_TRACE_EVENT_RESPONSE, cmd, type, result, response, strlen(response));
+  }
+}
+
+// Keep the code of a +CME ERROR answer for the metrics
+static void note_error_response(at_cmd_handler_t* handler, const char* response)
+{
+  const char* cme = strstr(response, AT_CME_ERROR);
+  if (!cme)
+  {
+    return;
   }
 
+  const char* code_start = cme + strlen(AT_CME_ERROR);
+  char*       code_end;
+  long        code = strtol(code_start, &code_end, 10);
+
+  handler->exchange.cme_error = true;
+  handler->exchange.cme_code  = (code_end != code_start && code >= 0 && code <= INT16_MAX)
+                                    ? (int16_t) code
+                                    : AT_CMD_METRICS_CME_UNKNOWN;
+}
+
+static esp_err_t format_and_send_cmd(at_cmd_handler_t* handler,
+                                     const at_cmd_t*   cmd,
+                                     at_cmd_type_t     type,
+                                     const void*       params)
+{
   // Add this check early
   if (!at_cmd_type_is_implemented(cmd, type))
   {
@@ -244,13 +437,39 @@ esp_err_t at_cmd_handler_send_and_receive_cmd(at_cmd_handler_t* handler,
   }
 
   // Send command
-  ESP_LOGI(TAG, "Sending command: %s (timeout: %lu ms)", cmd_str, (long unsigned) cmd->timeout_ms);
-  err = handler->uart.write(cmd_str, strlen(cmd_str), handler->uart.context);
+  ESP_LOGD(TAG, "Sending command: %s (timeout: %lu ms)", cmd_str, (long unsigned) cmd->timeout_ms);
+  size_t cmd_len       = strlen(cmd_str);
+  handler->cmd_sent_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+  err                  = uart_write(handler, cmd_str, cmd_len);
+  trace_cmd_event(handler, AT_CMD_TRACE_EVENT_SEND, cmd, type, err, cmd_str, cmd_len);
   if (err != ESP_OK)
   {
     ESP_LOGE(TAG, "UART interface WRITE failed: %s", esp_err_to_name(err));
     return err;
   }
+  handler->exchange.sent = true;
+
+  return ESP_OK;
+}
+
+// Module is assumed to be awake here (see at_cmd_handler_send_and_receive_cmd)
+static esp_err_t send_and_receive_cmd_awake(at_cmd_handler_t* handler,
+                                            const at_cmd_t*   cmd,
+                                            at_cmd_type_t     type,
+                                            const void*       params,
+                                            void*             response_data)
+{
+  if (!handler || !cmd)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = format_and_send_cmd(handler, cmd, type, params);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
 
   // Allocate and read response
   char* raw_response = malloc(AT_CMD_MAX_RESPONSE_LEN);
@@ -258,21 +477,28 @@ esp_err_t at_cmd_handler_send_and_receive_cmd(at_cmd_handler_t* handler,
   {
     return ESP_ERR_NO_MEM;
   }
+  raw_response[0] = '\0';
 
   err = read_at_cmd_response(handler, cmd, type, raw_response, AT_CMD_MAX_RESPONSE_LEN);
+  trace_response(handler, cmd, type, err, raw_response);
   if (err != ESP_OK)
   {
     free(raw_response);
     return err;
   }
 
-  ESP_LOGI(TAG, "Received response: %s", raw_response);
+  ESP_LOGD(TAG, "Received response: %s", raw_response);
+  dispatch_urcs(handler, raw_response);
+
+  // Module answered - used to estimate when it will next enter PSM
+  handler->last_activity_ms = pdTICKS_TO_MS(xTaskGetTickCount());
 
   // Parse and validate basic response
   at_parsed_response_t parsed_base = {0};
   err                              = validate_basic_response(raw_response, &parsed_base);
   if (err != ESP_OK)
   {
+    note_error_response(handler, raw_response);
     free(raw_response);
     return err;
   }
@@ -284,72 +510,122 @@ esp_err_t at_cmd_handler_send_and_receive_cmd(at_cmd_handler_t* handler,
   return err;
 }
 
-esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
-                                          const at_cmd_t*   cmd,
-                                          at_cmd_type_t     type,
-                                          const void*       params,
-                                          const void*       data,
-                                          size_t            data_len,
-                                          void*             response_data)
+// Pull 'len' bytes from the source and write them in AT_CMD_STREAM_CHUNK_SIZE pieces
+static esp_err_t write_from_source(at_cmd_handler_t*       handler,
+                                   at_cmd_stream_source_fn source,
+                                   void*                   source_context,
+                                   size_t                  len)
 {
-  if (!handler || !cmd || !data || data_len == 0)
+  char   chunk[AT_CMD_STREAM_CHUNK_SIZE];
+  size_t written = 0;
+
+  while (written < len)
   {
-    ESP_LOGE(TAG, "Invalid arguments provided");
-    return ESP_ERR_INVALID_ARG;
+    size_t    wanted = len - written < sizeof(chunk) ? len - written : sizeof(chunk);
+    size_t    got    = 0;
+    esp_err_t err    = source(chunk, wanted, &got, source_context);
+    if (err != ESP_OK)
+    {
+      return err;
+    }
+
+    if (got == 0 || got > wanted)
+    {
+      ESP_LOGE(TAG, "Data source ended after %d of %d bytes", (int) written, (int) len);
+      return ESP_ERR_INVALID_SIZE;
+    }
+
+    err = uart_write(handler, chunk, got);
+    if (err != ESP_OK)
+    {
+      return err;
+    }
+    written += got;
   }
 
-  // Add this check early
-  if (!at_cmd_type_is_implemented(cmd, type))
+  return ESP_OK;
+}
+
+// If the data stops short the module stays in data mode until its input time runs out. Wait for it
+// to give up and answer, or the next command would be taken as data
+static void wait_out_short_data(at_cmd_handler_t* handler, const at_cmd_t* cmd, at_cmd_type_t type)
+{
+  char* raw_response = malloc(AT_CMD_MAX_RESPONSE_LEN);
+  if (raw_response)
   {
-    ESP_LOGE(TAG, "Command %s does not implement type %d", cmd->name, type);
-    return ESP_ERR_NOT_SUPPORTED;
+    read_at_cmd_response(handler, cmd, type, raw_response, AT_CMD_MAX_RESPONSE_LEN);
+    free(raw_response);
   }
+}
 
-  // Validate UART interface
-  if (!handler->uart.write || !handler->uart.read || !handler->uart.context)
+// The data is taken either from 'data', or (if 'source' is set) pulled from the source
+static esp_err_t send_with_prompt_awake(at_cmd_handler_t*       handler,
+                                        const at_cmd_t*         cmd,
+                                        at_cmd_type_t           type,
+                                        const void*             params,
+                                        const void*             data,
+                                        at_cmd_stream_source_fn source,
+                                        void*                   source_context,
+                                        size_t                  data_len,
+                                        void*                   response_data)
+{
+  if (!handler || !cmd || (!data && !source) || data_len == 0)
   {
-    ESP_LOGE(TAG, "UART interface not properly initialized");
-    return ESP_ERR_INVALID_STATE;
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // Format command
-  char      cmd_str[AT_CMD_MAX_CMD_LEN];
-  esp_err_t err = format_at_cmd(cmd, type, params, cmd_str, sizeof(cmd_str));
-  if (err != ESP_OK)
+  esp_err_t err = format_and_send_cmd(handler, cmd, type, params);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "AT cmd formatting failed for %s", cmd->name);
-    return err;
+    err = wait_tx_done(handler);
   }
-
-  // Send command
-  ESP_LOGI(TAG, "Sending command: %s (timeout: %lu ms)", cmd_str, (long unsigned) cmd->timeout_ms);
-  err = handler->uart.write(cmd_str, strlen(cmd_str), handler->uart.context);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "UART interface WRITE failed: %s", esp_err_to_name(err));
     return err;
   }
 
-  // Wait for '>' prompt
-  char     prompt_buffer[16] = {0};
-  size_t   bytes_read        = 0;
-  uint32_t start_time        = pdTICKS_TO_MS(xTaskGetTickCount());
+  // Wait for '>' prompt - or CONNECT, for commands that take their data in data mode (e.g. QHTTPURL)
+  char     prompt_buffer[AT_CMD_READ_CHUNK_SIZE] = {0};
+  size_t   prompt_len                            = 0;
+  size_t   bytes_read                            = 0;
+  uint32_t start_time                            = pdTICKS_TO_MS(xTaskGetTickCount());
 
   bool prompt_received = false;
   while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < 5000) // 5 second timeout for prompt
   {
-    err = handler->uart.read(
-        prompt_buffer, sizeof(prompt_buffer) - 1, &bytes_read, 100, handler->uart.context);
+    err = uart_read(handler,
+                    prompt_buffer + prompt_len,
+                    sizeof(prompt_buffer) - prompt_len,
+                    &bytes_read,
+                    100);
     if (err == ESP_OK && bytes_read > 0)
     {
-      prompt_buffer[bytes_read] = '\0';
-      ESP_LOGI(TAG, "Received: %s", prompt_buffer);
+      prompt_len += bytes_read;
+      ESP_LOGD(TAG, "Received: %s", prompt_buffer);
 
-      if (strchr(prompt_buffer, '>') != NULL)
+      if (strchr(prompt_buffer, '>') != NULL || strstr(prompt_buffer, AT_CONNECT) != NULL)
       {
         prompt_received = true;
         break;
       }
+
+      if (strstr(prompt_buffer, AT_ERROR) || strstr(prompt_buffer, AT_CME_ERROR))
+      {
+        ESP_LOGE(TAG, "Command %s refused: %s", cmd->name, prompt_buffer);
+        note_error_response(handler, prompt_buffer);
+        trace_cmd_event(
+            handler, AT_CMD_TRACE_EVENT_PROMPT, cmd, type, ESP_FAIL, prompt_buffer, prompt_len);
+        return ESP_FAIL;
+      }
+
+      // Keep the tail, a CONNECT can be split over two reads
+      if (prompt_len > sizeof(prompt_buffer) / 2)
+      {
+        size_t keep = sizeof(AT_CONNECT) - 2;
+        memmove(prompt_buffer, prompt_buffer + prompt_len - keep, keep + 1);
+        prompt_len = keep;
+      }
     }
     vTaskDelay(pdMS_TO_TICKS(10));
   }
@@ -357,16 +633,34 @@ esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
   if (!prompt_received)
   {
     ESP_LOGE(TAG, "Timeout waiting for '>' prompt");
+    trace_cmd_event(handler, AT_CMD_TRACE_EVENT_PROMPT, cmd, type, ESP_ERR_TIMEOUT, NULL, 0);
     return ESP_ERR_TIMEOUT;
   }
 
-  ESP_LOGI(TAG, "Prompt '>' received, sending data (%d bytes)", data_len);
+  trace_cmd_event(handler, AT_CMD_TRACE_EVENT_PROMPT, cmd, type, ESP_OK, prompt_buffer, prompt_len);
+  ESP_LOGD(TAG, "Prompt '>' received, sending data (%d bytes)", (int) data_len);
 
   // Send data
-  err = handler->uart.write(data, data_len, handler->uart.context);
+  if (source)
+  {
+    err = write_from_source(handler, source, source_context, data_len);
+  }
+  else
+  {
+    err = uart_write(handler, data, data_len);
+  }
+  if (err == ESP_OK)
+  {
+    // The response timeout is counted from the end of the data, not from when it was queued
+    err = wait_tx_done(handler);
+  }
   if (err != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to send data after prompt: %s", esp_err_to_name(err));
+    if (source)
+    {
+      wait_out_short_data(handler, cmd, type);
+    }
     return err;
   }
 
@@ -376,21 +670,28 @@ esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
   {
     return ESP_ERR_NO_MEM;
   }
+  raw_response[0] = '\0';
 
   err = read_at_cmd_response(handler, cmd, type, raw_response, AT_CMD_MAX_RESPONSE_LEN);
+  trace_response(handler, cmd, type, err, raw_response);
   if (err != ESP_OK)
   {
     free(raw_response);
     return err;
   }
 
-  ESP_LOGI(TAG, "Received response: %s", raw_response);
+  ESP_LOGD(TAG, "Received response: %s", raw_response);
+  dispatch_urcs(handler, raw_response);
+
+  // Module answered - used to estimate when it will next enter PSM
+  handler->last_activity_ms = pdTICKS_TO_MS(xTaskGetTickCount());
 
   // Parse and validate basic response
   at_parsed_response_t parsed_base = {0};
   err                              = validate_basic_response(raw_response, &parsed_base);
   if (err != ESP_OK)
   {
+    note_error_response(handler, raw_response);
     free(raw_response);
     return err;
   }
@@ -401,3 +702,1273 @@ esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
   free(raw_response);
   return err;
 }
+
+// Read exactly 'len' payload bytes straight into 'payload'. The UART read NUL terminates what it
+// reads, so the last bytes (that would put the terminator past the end) go through a small buffer
+static esp_err_t read_payload(at_cmd_handler_t* handler,
+                              char*             payload,
+                              size_t            payload_size,
+                              size_t            received,
+                              size_t            len,
+                              uint32_t          start_time,
+                              uint32_t          timeout_ms)
+{
+  char temp_buffer[AT_CMD_READ_CHUNK_SIZE];
+
+  while (received < len)
+  {
+    if ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) >= timeout_ms)
+    {
+      return ESP_ERR_TIMEOUT;
+    }
+
+    size_t    remaining  = len - received;
+    size_t    bytes_read = 0;
+    esp_err_t err;
+    if (payload_size - received > remaining)
+    {
+      err = uart_read(handler,
+                      payload + received,
+                      remaining + 1,
+                      &bytes_read,
+                      AT_CMD_READ_CHUNK_INTERVAL_MS);
+    }
+    else
+    {
+      size_t max_len = remaining + 1 < sizeof(temp_buffer) ? remaining + 1 : sizeof(temp_buffer);
+      err            = uart_read(handler,
+                                 temp_buffer,
+                                 max_len,
+                                 &bytes_read,
+                                 AT_CMD_READ_CHUNK_INTERVAL_MS);
+      if (err == ESP_OK && bytes_read > 0)
+      {
+        memcpy(payload + received, temp_buffer, bytes_read);
+      }
+    }
+
+    if (err != ESP_OK)
+    {
+      return err;
+    }
+    received += bytes_read;
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t send_and_receive_payload_awake(at_cmd_handler_t*         handler,
+                                                const at_cmd_t*           cmd,
+                                                at_cmd_type_t             type,
+                                                const void*               params,
+                                                void*                     response_data,
+                                                at_cmd_payload_locator_fn locate_payload,
+                                                char*                     payload,
+                                                size_t                    payload_size,
+                                                size_t*                   payload_len)
+{
+  esp_err_t err = format_and_send_cmd(handler, cmd, type, params);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  char* raw_response = malloc(AT_CMD_MAX_RESPONSE_LEN);
+  if (!raw_response)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  uint32_t start_time     = pdTICKS_TO_MS(xTaskGetTickCount());
+  size_t   total_read     = 0;
+  size_t   payload_offset = 0;
+  size_t   len            = 0;
+  bool     located        = false;
+  char     temp_buffer[AT_CMD_READ_CHUNK_SIZE];
+
+  // Read until the header announcing the payload length is complete. The last chunk can already
+  // hold the start of the payload
+  while (!located && (pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < cmd->timeout_ms)
+  {
+    size_t bytes_read = 0;
+    err               = uart_read(handler,
+                                  temp_buffer,
+                                  sizeof(temp_buffer) - 1,
+                                  &bytes_read,
+                                  AT_CMD_READ_CHUNK_INTERVAL_MS);
+    if (err != ESP_OK || bytes_read == 0)
+    {
+      continue;
+    }
+
+    if ((total_read + bytes_read) >= AT_CMD_MAX_RESPONSE_LEN)
+    {
+      free(raw_response);
+      return ESP_ERR_INVALID_SIZE;
+    }
+
+    memcpy(raw_response + total_read, temp_buffer, bytes_read);
+    total_read += bytes_read;
+    raw_response[total_read] = '\0';
+
+    err = locate_payload(raw_response, &payload_offset, &len);
+    if (err == ESP_OK)
+    {
+      located = true;
+    }
+    else if (err != ESP_ERR_NOT_FOUND)
+    {
+      free(raw_response);
+      return err;
+    }
+    else if (strstr(raw_response, AT_ERROR) || strstr(raw_response, AT_CME_ERROR))
+    {
+      ESP_LOGE(TAG, "Command %s answered with an error: %s", cmd->name, raw_response);
+      note_error_response(handler, raw_response);
+      free(raw_response);
+      return ESP_FAIL;
+    }
+  }
+
+  if (!located)
+  {
+    free(raw_response);
+    return ESP_ERR_TIMEOUT;
+  }
+
+  if (len > payload_size)
+  {
+    ESP_LOGE(TAG,
+             "Payload of %d bytes does not fit the %d byte buffer",
+             (int) len,
+             (int) payload_size);
+    abort_at_cmd(handler);
+    free(raw_response);
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  // Split what was already read into payload, and the start of the final result
+  size_t already_read = total_read - payload_offset;
+  size_t payload_part = already_read < len ? already_read : len;
+  memcpy(payload, raw_response + payload_offset, payload_part);
+
+  char   trailer[AT_CMD_READ_CHUNK_SIZE * 2];
+  size_t trailer_len = already_read - payload_part;
+  memcpy(trailer, raw_response + payload_offset + payload_part, trailer_len);
+  trailer[trailer_len] = '\0';
+
+  // Header only - the payload is not text
+  raw_response[payload_offset] = '\0';
+  ESP_LOGD(TAG, "Received payload header: %s", raw_response);
+  trace_response(handler, cmd, type, ESP_OK, raw_response);
+  dispatch_urcs(handler, raw_response);
+
+  at_parsed_response_t parsed_base = {0};
+  err                              = at_cmd_parse_response(raw_response, &parsed_base);
+  if (err == ESP_OK)
+  {
+    err = parse_at_cmd_specific_data_response(cmd, type, raw_response, &parsed_base, response_data);
+  }
+  free(raw_response);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = read_payload(
+      handler, payload, payload_size, payload_part, len, start_time, cmd->timeout_ms);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+  *payload_len = len;
+
+  // The payload is followed by '\r\n' and the final result
+  while (!strstr(trailer, AT_OK))
+  {
+    if (strstr(trailer, AT_ERROR) || strstr(trailer, AT_CME_ERROR))
+    {
+      note_error_response(handler, trailer);
+      return ESP_FAIL;
+    }
+
+    if ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) >= cmd->timeout_ms ||
+        trailer_len >= sizeof(trailer) - 1)
+    {
+      return ESP_ERR_TIMEOUT;
+    }
+
+    size_t bytes_read = 0;
+    err               = uart_read(handler,
+                                  trailer + trailer_len,
+                                  sizeof(trailer) - trailer_len,
+                                  &bytes_read,
+                                  AT_CMD_READ_CHUNK_INTERVAL_MS);
+    if (err == ESP_OK)
+    {
+      trailer_len += bytes_read;
+      trailer[trailer_len] = '\0';
+    }
+  }
+
+  handler->last_activity_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+  return ESP_OK;
+}
+
+// Unlock the handler at the end of an exchange. The wake line is released only if no other exchange
+// is queued on the lock - otherwise the next one runs in the same wake interval, and the wake it
+// saves (assert, probe, wait for OK) usually costs more than the few ms the module stays up
+static void release_cmd_lock(at_cmd_handler_t* handler)
+{
+  if (atomic_load(&handler->lock_waiters) == 0)
+  {
+    at_cmd_handler_allow_sleep(handler);
+  }
+  else if (handler->sleep.enabled && handler->sleep.awake && handler->sleep.batch_depth == 0)
+  {
+    handler->sleep.stats.kept_awake_count++;
+  }
+  xSemaphoreGiveRecursive(handler->lock);
+}
+
+// Lock the handler and make sure the module can take a command. Must be paired with
+// end_cmd_exchange on success
+static esp_err_t begin_cmd_exchange(at_cmd_handler_t* handler)
+{
+  // Queued while another exchange holds the UART
+  at_cmd_metrics_t* metrics = handler->metrics;
+  at_cmd_metrics_gauge_add(metrics, AT_CMD_METRICS_GAUGE_QUEUE_DEPTH, 1);
+  atomic_fetch_add(&handler->lock_waiters, 1);
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  atomic_fetch_sub(&handler->lock_waiters, 1);
+  at_cmd_metrics_gauge_add(metrics, AT_CMD_METRICS_GAUGE_QUEUE_DEPTH, -1);
+
+  handler->exchange_start_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+  memset(&handler->exchange, 0, sizeof(handler->exchange));
+
+  // In data mode every byte written goes to the peer - the channel must be escaped (+++) first
+  if (handler->mode == AT_CMD_MODE_DATA)
+  {
+    ESP_LOGE(TAG, "Channel is in data mode - commands cannot be sent");
+    release_cmd_lock(handler);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  esp_err_t err = at_cmd_handler_wake(handler);
+  if (err != ESP_OK)
+  {
+    release_cmd_lock(handler);
+    return err;
+  }
+
+  if (handler->sleep.enabled)
+  {
+    handler->sleep.stats.cmd_count++;
+  }
+  return ESP_OK;
+}
+
+// 'cmd' is NULL for exchanges that are not a command of the table (e.g. ATO)
+static void end_cmd_exchange(at_cmd_handler_t* handler,
+                             const at_cmd_t*   cmd,
+                             at_cmd_type_t     type,
+                             esp_err_t         result)
+{
+  uint32_t now_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+  if (handler->trace)
+  {
+    uint32_t latency_ms = now_ms - handler->exchange_start_ms;
+    at_cmd_trace_record(
+        handler->trace, AT_CMD_TRACE_EVENT_DONE, cmd, type, result, latency_ms, NULL, 0);
+  }
+
+  if (handler->metrics)
+  {
+    handler->exchange.result     = result;
+    handler->exchange.latency_ms = handler->exchange.sent ? now_ms - handler->cmd_sent_ms : 0;
+    at_cmd_metrics_record(handler->metrics, cmd, type, &handler->exchange);
+  }
+
+  release_cmd_lock(handler);
+}
+
+esp_err_t at_cmd_handler_send_and_receive_cmd(at_cmd_handler_t* handler,
+                                              const at_cmd_t*   cmd,
+                                              at_cmd_type_t     type,
+                                              const void*       params,
+                                              void*             response_data)
+{
+  return at_cmd_handler_send_and_receive_cmd_observed(
+      handler, cmd, type, params, response_data, NULL, NULL);
+}
+
+esp_err_t at_cmd_handler_send_and_receive_cmd_observed(at_cmd_handler_t*     handler,
+                                                       const at_cmd_t*       cmd,
+                                                       at_cmd_type_t         type,
+                                                       const void*           params,
+                                                       void*                 response_data,
+                                                       at_cmd_rx_observer_fn observer,
+                                                       void*                 observer_context)
+{
+  if (!handler || !cmd || !handler->lock)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  handler->rx_observer         = observer;
+  handler->rx_observer_context = observer_context;
+
+  err = send_and_receive_cmd_awake(handler, cmd, type, params, response_data);
+
+  handler->rx_observer         = NULL;
+  handler->rx_observer_context = NULL;
+
+  end_cmd_exchange(handler, cmd, type, err);
+  return err;
+}
+
+esp_err_t at_cmd_handler_send_with_prompt(at_cmd_handler_t* handler,
+                                          const at_cmd_t*   cmd,
+                                          at_cmd_type_t     type,
+                                          const void*       params,
+                                          const void*       data,
+                                          size_t            data_len,
+                                          void*             response_data)
+{
+  if (!handler || !cmd || !handler->lock)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = send_with_prompt_awake(
+      handler, cmd, type, params, data, NULL, NULL, data_len, response_data);
+
+  end_cmd_exchange(handler, cmd, type, err);
+  return err;
+}
+
+esp_err_t at_cmd_handler_send_with_prompt_stream(at_cmd_handler_t*       handler,
+                                                 const at_cmd_t*         cmd,
+                                                 at_cmd_type_t           type,
+                                                 const void*             params,
+                                                 at_cmd_stream_source_fn source,
+                                                 void*                   source_context,
+                                                 size_t                  data_len,
+                                                 void*                   response_data)
+{
+  if (!handler || !cmd || !handler->lock || !source)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = send_with_prompt_awake(
+      handler, cmd, type, params, NULL, source, source_context, data_len, response_data);
+
+  end_cmd_exchange(handler, cmd, type, err);
+  return err;
+}
+
+esp_err_t at_cmd_handler_send_and_receive_payload(at_cmd_handler_t*         handler,
+                                                  const at_cmd_t*           cmd,
+                                                  at_cmd_type_t             type,
+                                                  const void*               params,
+                                                  void*                     response_data,
+                                                  at_cmd_payload_locator_fn locate_payload,
+                                                  void*                     payload,
+                                                  size_t                    payload_size,
+                                                  size_t*                   payload_len)
+{
+  if (!handler || !cmd || !handler->lock || !locate_payload || !payload || !payload_len)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  *payload_len = 0;
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = send_and_receive_payload_awake(handler,
+                                       cmd,
+                                       type,
+                                       params,
+                                       response_data,
+                                       locate_payload,
+                                       (char*) payload,
+                                       payload_size,
+                                       payload_len);
+
+  end_cmd_exchange(handler, cmd, type, err);
+  return err;
+}
+
+// ---------------------------- URC HANDLING ----------------------------------
+
+esp_err_t at_cmd_handler_set_urc_handler(at_cmd_handler_t* handler,
+                                         at_cmd_urc_fn     urc_handler,
+                                         void*             context)
+{
+  if (!handler || !handler->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  handler->urc_handler = urc_handler;
+  handler->urc_context = context;
+  xSemaphoreGiveRecursive(handler->lock);
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_handler_poll_urcs(at_cmd_handler_t* handler, uint32_t timeout_ms)
+{
+  if (!handler || !handler->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+
+  // Everything received in data mode belongs to the peer
+  if (handler->mode == AT_CMD_MODE_DATA)
+  {
+    xSemaphoreGiveRecursive(handler->lock);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  char   urc_buffer[AT_CMD_URC_POLL_BUFFER_SIZE];
+  size_t total_read = 0;
+
+  // Wait up to 'timeout_ms' for the first bytes, then keep reading until the UART is quiet
+  uint32_t wait_ms = timeout_ms;
+  while (total_read < sizeof(urc_buffer) - 1)
+  {
+    size_t    bytes_read = 0;
+    esp_err_t err        = uart_read(handler,
+                                     urc_buffer + total_read,
+                                     sizeof(urc_buffer) - total_read,
+                                     &bytes_read,
+                                     wait_ms);
+    if (err != ESP_OK || bytes_read == 0)
+    {
+      break;
+    }
+    total_read += bytes_read;
+    wait_ms = AT_CMD_READ_CHUNK_INTERVAL_MS;
+  }
+  urc_buffer[total_read] = '\0';
+
+  if (total_read > 0)
+  {
+    ESP_LOGD(TAG, "Polled: %s", urc_buffer);
+    at_cmd_trace_record(handler->trace,
+                        AT_CMD_TRACE_EVENT_URC,
+                        NULL,
+                        AT_CMD_TYPE_EXECUTE,
+                        ESP_OK,
+                        0,
+                        urc_buffer,
+                        total_read);
+    dispatch_urcs(handler, urc_buffer);
+  }
+
+  xSemaphoreGiveRecursive(handler->lock);
+  return ESP_OK;
+}
+
+// ---------------------------- TRACE ----------------------------------
+
+esp_err_t at_cmd_handler_set_trace(at_cmd_handler_t* handler, at_cmd_trace_t* trace)
+{
+  if (!handler || !handler->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  handler->trace = trace;
+  xSemaphoreGiveRecursive(handler->lock);
+  return ESP_OK;
+}
+
+// ---------------------------- METRICS ----------------------------------
+
+esp_err_t at_cmd_handler_set_metrics(at_cmd_handler_t* handler, at_cmd_metrics_t* metrics)
+{
+  if (!handler || !handler->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  handler->metrics = metrics;
+  xSemaphoreGiveRecursive(handler->lock);
+  return ESP_OK;
+}
+
+// ---------------------------- DATA MODE ----------------------------------
+
+// Wait for the CONNECT that switches the channel to data mode. Anything other than CONNECT (ERROR,
+// NO CARRIER) means the channel stays in command mode
+static esp_err_t wait_for_connect(at_cmd_handler_t* handler, uint32_t timeout_ms)
+{
+  char     response[AT_CMD_URC_POLL_BUFFER_SIZE];
+  size_t   total_read = 0;
+  uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  // Read byte by byte - data can follow CONNECT immediately, and it belongs to the caller
+  while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < timeout_ms &&
+         total_read < sizeof(response) - 1)
+  {
+    size_t    bytes_read = 0;
+    esp_err_t err        = uart_read(handler,
+                                     response + total_read,
+                                     2,
+                                     &bytes_read,
+                                     AT_CMD_READ_CHUNK_INTERVAL_MS);
+    if (err != ESP_OK || bytes_read == 0)
+    {
+      continue;
+    }
+    total_read += bytes_read;
+    response[total_read] = '\0';
+
+    if (strstr(response, AT_CONNECT))
+    {
+      ESP_LOGI(TAG, "Channel switched to data mode");
+      return ESP_OK;
+    }
+
+    if (strstr(response, AT_ERROR) || strstr(response, AT_CME_ERROR) ||
+        strstr(response, AT_NO_CARRIER))
+    {
+      ESP_LOGE(TAG, "Failed to enter data mode: %s", response);
+      note_error_response(handler, response);
+      return ESP_FAIL;
+    }
+  }
+
+  return ESP_ERR_TIMEOUT;
+}
+
+// Binary safe search - the streamed body and data mode reads can hold NUL bytes
+static bool find_bytes(
+    const char* haystack, size_t len, const char* needle, size_t needle_len, size_t* pos)
+{
+  for (size_t i = 0; i + needle_len <= len; i++)
+  {
+    if (memcmp(haystack + i, needle, needle_len) == 0)
+    {
+      *pos = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Data mode holds the module awake (as one long batch) until the channel is back in command mode
+static void data_mode_started(at_cmd_handler_t* handler)
+{
+  handler->mode          = AT_CMD_MODE_DATA;
+  handler->data_tail_len = 0;
+  at_cmd_handler_begin_batch(handler);
+}
+
+static void data_mode_ended(at_cmd_handler_t* handler)
+{
+  handler->mode = AT_CMD_MODE_COMMAND;
+  at_cmd_handler_end_batch(handler);
+}
+
+esp_err_t at_cmd_handler_enter_data_mode(at_cmd_handler_t* handler,
+                                         const at_cmd_t*   cmd,
+                                         at_cmd_type_t     type,
+                                         const void*       params)
+{
+  if (!handler || !cmd || !handler->lock)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = format_and_send_cmd(handler, cmd, type, params);
+  if (err == ESP_OK)
+  {
+    err = wait_for_connect(handler, cmd->timeout_ms);
+  }
+
+  if (err == ESP_OK)
+  {
+    handler->last_activity_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+    data_mode_started(handler);
+  }
+
+  end_cmd_exchange(handler, cmd, type, err);
+  return err;
+}
+
+esp_err_t at_cmd_handler_resume_data_mode(at_cmd_handler_t* handler)
+{
+  if (!handler || !handler->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  ESP_LOGD(TAG, "Sending command: ATO");
+  err = uart_write(handler, "ATO\r\n", 5);
+  if (err == ESP_OK)
+  {
+    err = wait_for_connect(handler, AT_CMD_DATA_MODE_RESUME_TIMEOUT_MS);
+  }
+
+  if (err == ESP_OK)
+  {
+    data_mode_started(handler);
+  }
+
+  end_cmd_exchange(handler, NULL, AT_CMD_TYPE_EXECUTE, err);
+  return err;
+}
+
+esp_err_t at_cmd_handler_exit_data_mode(at_cmd_handler_t* handler)
+{
+  if (!handler || !handler->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+
+  if (handler->mode != AT_CMD_MODE_DATA)
+  {
+    xSemaphoreGiveRecursive(handler->lock);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // The escape is only recognized with no other data sent for the guard time before and after it,
+  // counted from when the bytes are actually on the wire
+  esp_err_t err = wait_tx_done(handler);
+  if (err == ESP_OK)
+  {
+    vTaskDelay(pdMS_TO_TICKS(AT_CMD_ESCAPE_GUARD_MS));
+    err = uart_write(handler, "+++", 3);
+  }
+  if (err == ESP_OK)
+  {
+    err = wait_tx_done(handler);
+  }
+  if (err != ESP_OK)
+  {
+    xSemaphoreGiveRecursive(handler->lock);
+    return err;
+  }
+  vTaskDelay(pdMS_TO_TICKS(AT_CMD_ESCAPE_GUARD_MS));
+
+  // Data still in flight from the peer arrives ahead of the OK, and is dropped
+  char     response[AT_CMD_READ_CHUNK_SIZE * 2] = {0};
+  size_t   total_read                           = 0;
+  uint32_t start_time                           = pdTICKS_TO_MS(xTaskGetTickCount());
+  err                                           = ESP_ERR_TIMEOUT;
+  while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < AT_CMD_DATA_MODE_RESUME_TIMEOUT_MS)
+  {
+    size_t bytes_read = 0;
+    if (uart_read(handler,
+                  response + total_read,
+                  sizeof(response) - total_read,
+                  &bytes_read,
+                  AT_CMD_READ_CHUNK_INTERVAL_MS) != ESP_OK ||
+        bytes_read == 0)
+    {
+      continue;
+    }
+    total_read += bytes_read;
+    response[total_read] = '\0';
+
+    if (strstr(response, AT_OK) || strstr(response, AT_NO_CARRIER))
+    {
+      err = ESP_OK;
+      break;
+    }
+
+    // Keep the tail, so a terminator split across reads is still found
+    if (total_read > AT_CMD_READ_CHUNK_SIZE)
+    {
+      memmove(response, response + total_read - AT_CMD_READ_CHUNK_SIZE, AT_CMD_READ_CHUNK_SIZE);
+      total_read = AT_CMD_READ_CHUNK_SIZE;
+    }
+  }
+
+  if (err == ESP_OK)
+  {
+    ESP_LOGI(TAG, "Channel switched to command mode");
+    data_mode_ended(handler);
+  }
+  else
+  {
+    ESP_LOGE(TAG, "No answer to the +++ escape");
+  }
+
+  xSemaphoreGiveRecursive(handler->lock);
+  return err;
+}
+
+at_cmd_mode_t at_cmd_handler_get_mode(at_cmd_handler_t* handler)
+{
+  return handler ? handler->mode : AT_CMD_MODE_COMMAND;
+}
+
+esp_err_t at_cmd_handler_data_write(at_cmd_handler_t* handler, const void* data, size_t len)
+{
+  if (!handler || !data || len == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (handler->mode != AT_CMD_MODE_DATA)
+  {
+    ESP_LOGE(TAG, "Channel is not in data mode");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  return uart_write(handler, (const char*) data, len);
+}
+
+esp_err_t at_cmd_handler_data_read(at_cmd_handler_t* handler,
+                                   void*             buffer,
+                                   size_t            buffer_size,
+                                   size_t*           bytes_read,
+                                   uint32_t          timeout_ms)
+{
+  if (!handler || !buffer || buffer_size <= AT_CMD_DATA_TAIL_LEN + 1 || !bytes_read)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  *bytes_read = 0;
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  if (handler->mode != AT_CMD_MODE_DATA)
+  {
+    xSemaphoreGiveRecursive(handler->lock);
+    ESP_LOGE(TAG, "Channel is not in data mode");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // What the last read held back comes first
+  char*  data = (char*) buffer;
+  size_t held = handler->data_tail_len;
+  memcpy(data, handler->data_tail, held);
+  handler->data_tail_len = 0;
+
+  size_t    received = 0;
+  esp_err_t err      = uart_read(handler, data + held, buffer_size - held, &received, timeout_ms);
+  if (err != ESP_OK)
+  {
+    // Nothing was consumed - keep the held bytes for the next read
+    memcpy(handler->data_tail, data, held);
+    handler->data_tail_len = held;
+    xSemaphoreGiveRecursive(handler->lock);
+    return err;
+  }
+  size_t len = held + received;
+
+  // The module leaves data mode by itself once the peer closes the connection. The marker can be
+  // anywhere in the chunk - what follows it is not data
+  const size_t marker_len = strlen(AT_NO_CARRIER);
+  size_t       marker_pos;
+  if (find_bytes(data, len, AT_NO_CARRIER, marker_len, &marker_pos))
+  {
+    ESP_LOGI(TAG, "Connection closed by peer - channel switched to command mode");
+    *bytes_read = marker_pos;
+    data_mode_ended(handler);
+    xSemaphoreGiveRecursive(handler->lock);
+    return ESP_OK;
+  }
+
+  // Hold back the longest end of the chunk that starts the marker - unless nothing new arrived,
+  // then what was held is data after all
+  if (received > 0)
+  {
+    for (size_t tail = (len < marker_len - 1) ? len : marker_len - 1; tail > 0; tail--)
+    {
+      if (memcmp(data + len - tail, AT_NO_CARRIER, tail) == 0)
+      {
+        memcpy(handler->data_tail, data + len - tail, tail);
+        handler->data_tail_len = tail;
+        len -= tail;
+        break;
+      }
+    }
+  }
+
+  *bytes_read = len;
+  xSemaphoreGiveRecursive(handler->lock);
+  return ESP_OK;
+}
+
+// ---------------------------- STREAMED RESPONSES ----------------------------------
+
+static esp_err_t send_and_stream_awake(at_cmd_handler_t*     handler,
+                                       const at_cmd_t*       cmd,
+                                       at_cmd_type_t         type,
+                                       const void*           params,
+                                       const char*           end_marker,
+                                       void*                 response_data,
+                                       at_cmd_stream_sink_fn sink,
+                                       void*                 sink_context)
+{
+  // The body ends where the final result starts - by default OK, then the '+<NAME>: ' result line
+  char marker[AT_CMD_READ_CHUNK_SIZE];
+  int  marker_len;
+  if (end_marker)
+  {
+    marker_len = snprintf(marker, sizeof(marker), "%s", end_marker);
+  }
+  else
+  {
+    marker_len = snprintf(marker, sizeof(marker), AT_OK AT_CRLF "+%s: ", cmd->name);
+  }
+  if (marker_len < 0 || (size_t) marker_len >= sizeof(marker))
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  esp_err_t err = format_and_send_cmd(handler, cmd, type, params);
+  if (err == ESP_OK)
+  {
+    err = wait_for_connect(handler, cmd->timeout_ms);
+  }
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  // Only a window of the stream is held - everything that can not be the start of the marker is
+  // handed to the sink as soon as it arrives
+  char     window[AT_CMD_STREAM_CHUNK_SIZE + sizeof(marker)];
+  size_t   held         = 0;
+  size_t   body_end     = 0;
+  bool     body_done    = false;
+  uint32_t last_rx_time = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  while (!body_done)
+  {
+    // The command timeout applies to the gap between packets, not to the whole transfer
+    if ((pdTICKS_TO_MS(xTaskGetTickCount()) - last_rx_time) >= cmd->timeout_ms)
+    {
+      ESP_LOGE(TAG, "Stream of %s stalled", cmd->name);
+      return ESP_ERR_TIMEOUT;
+    }
+
+    size_t bytes_read = 0;
+    err               = uart_read(handler,
+                                  window + held,
+                                  sizeof(window) - held,
+                                  &bytes_read,
+                                  AT_CMD_READ_CHUNK_INTERVAL_MS);
+    if (err != ESP_OK || bytes_read == 0)
+    {
+      continue;
+    }
+    last_rx_time = pdTICKS_TO_MS(xTaskGetTickCount());
+    held += bytes_read;
+
+    body_done = find_bytes(window, held, marker, marker_len, &body_end);
+    if (!body_done && held >= (size_t) marker_len)
+    {
+      size_t body_len = held - (marker_len - 1);
+      err             = sink(window, body_len, sink_context);
+      if (err != ESP_OK)
+      {
+        ESP_LOGW(TAG, "Stream of %s aborted by the sink", cmd->name);
+        abort_at_cmd(handler);
+        return err;
+      }
+      memmove(window, window + body_len, held - body_len);
+      held -= body_len;
+    }
+  }
+
+  if (body_end > 0)
+  {
+    err = sink(window, body_end, sink_context);
+    if (err != ESP_OK)
+    {
+      abort_at_cmd(handler);
+      return err;
+    }
+  }
+
+  // Collect the rest of the result
+  char   result[AT_CMD_URC_POLL_BUFFER_SIZE];
+  size_t result_len = held - body_end;
+  memcpy(result, window + body_end, result_len);
+  result[result_len] = '\0';
+
+  while (!has_command_terminated(result, cmd, type))
+  {
+    if ((pdTICKS_TO_MS(xTaskGetTickCount()) - last_rx_time) >= cmd->timeout_ms ||
+        result_len >= sizeof(result) - 1)
+    {
+      return ESP_ERR_TIMEOUT;
+    }
+
+    size_t bytes_read = 0;
+    err               = uart_read(handler,
+                                  result + result_len,
+                                  sizeof(result) - result_len,
+                                  &bytes_read,
+                                  AT_CMD_READ_CHUNK_INTERVAL_MS);
+    if (err == ESP_OK)
+    {
+      result_len += bytes_read;
+      result[result_len] = '\0';
+    }
+  }
+
+  ESP_LOGD(TAG, "Received stream result: %s", result);
+  trace_response(handler, cmd, type, ESP_OK, result);
+  dispatch_urcs(handler, result);
+  handler->last_activity_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  at_parsed_response_t parsed_base = {0};
+  err                              = validate_basic_response(result, &parsed_base);
+  if (err != ESP_OK)
+  {
+    note_error_response(handler, result);
+    return err;
+  }
+
+  return parse_at_cmd_specific_data_response(cmd, type, result, &parsed_base, response_data);
+}
+
+esp_err_t at_cmd_handler_send_and_stream(at_cmd_handler_t*     handler,
+                                         const at_cmd_t*       cmd,
+                                         at_cmd_type_t         type,
+                                         const void*           params,
+                                         const char*           end_marker,
+                                         void*                 response_data,
+                                         at_cmd_stream_sink_fn sink,
+                                         void*                 sink_context)
+{
+  if (!handler || !cmd || !handler->lock || !sink)
+  {
+    ESP_LOGE(TAG, "Invalid arguments provided");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = begin_cmd_exchange(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = send_and_stream_awake(
+      handler, cmd, type, params, end_marker, response_data, sink, sink_context);
+
+  end_cmd_exchange(handler, cmd, type, err);
+  return err;
+}
+
+// ---------------------------- SLEEP CONTROL ----------------------------------
+
+// Add the time spent in the current awake / asleep period to the totals, and start a new period
+static void sleep_account_period(at_cmd_sleep_ctrl_t* sleep, uint32_t now_ms)
+{
+  uint32_t elapsed = now_ms - sleep->state_since_ms;
+  if (sleep->awake)
+  {
+    sleep->stats.awake_total_ms += elapsed;
+  }
+  else
+  {
+    sleep->stats.asleep_total_ms += elapsed;
+  }
+  sleep->state_since_ms = now_ms;
+}
+
+static esp_err_t sleep_set_wake_line(at_cmd_handler_t* handler, bool awake)
+{
+  at_cmd_sleep_ctrl_t* sleep = &handler->sleep;
+
+  esp_err_t err = sleep->set_wake_line(awake, sleep->wake_line_context);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to drive wake line: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  sleep_account_period(sleep, pdTICKS_TO_MS(xTaskGetTickCount()));
+  sleep->awake = awake;
+  return ESP_OK;
+}
+
+// Number of "OK" in 'text'. 'text' starts with the last byte of the previous chunk, so an OK split
+// across two reads is still counted once
+static uint32_t count_ok(const char* text)
+{
+  uint32_t count = 0;
+  while ((text = strstr(text, "OK")) != NULL)
+  {
+    count++;
+    text += 2;
+  }
+  return count;
+}
+
+// The first bytes sent to a sleeping module can be lost, so probe with 'AT' until it answers. Once
+// it does, the answers (and echoes) to the earlier probes are still on their way - they are drained
+// until every probe is answered or the line is quiet, so the next command does not read them
+static esp_err_t sleep_probe_until_awake(at_cmd_handler_t* handler, uint32_t timeout_ms)
+{
+  const char probe[]    = "AT\r\n";
+  uint32_t   start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+  uint32_t   probes     = 0;
+  uint32_t   answers    = 0;
+  char       rx_buffer[AT_CMD_READ_CHUNK_SIZE + 1];
+  rx_buffer[0] = ' ';
+
+  while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < timeout_ms)
+  {
+    if (answers == 0)
+    {
+      esp_err_t err = uart_write(handler, probe, strlen(probe));
+      if (err != ESP_OK)
+      {
+        return err;
+      }
+      probes++;
+    }
+
+    // rx_buffer[0] holds the last byte of the previous read
+    size_t    bytes_read = 0;
+    esp_err_t err        = uart_read(handler,
+                                     rx_buffer + 1,
+                                     sizeof(rx_buffer) - 2,
+                                     &bytes_read,
+                                     AT_CMD_WAKE_PROBE_INTERVAL_MS);
+    if (err != ESP_OK || bytes_read == 0)
+    {
+      if (answers > 0)
+      {
+        return ESP_OK; // Quiet - the other probes were lost while the module was asleep
+      }
+      continue;
+    }
+
+    rx_buffer[bytes_read + 1] = '\0';
+    answers += count_ok(rx_buffer);
+    if (answers >= probes)
+    {
+      return ESP_OK;
+    }
+    rx_buffer[0] = rx_buffer[bytes_read];
+  }
+
+  return answers > 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t at_cmd_handler_sleep_enable(at_cmd_handler_t*   handler,
+                                      at_cmd_wake_line_fn set_wake_line,
+                                      void*               context)
+{
+  if (!handler || !set_wake_line)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  at_cmd_sleep_ctrl_t* sleep = &handler->sleep;
+  memset(sleep, 0, sizeof(at_cmd_sleep_ctrl_t));
+  sleep->set_wake_line     = set_wake_line;
+  sleep->wake_line_context = context;
+  sleep->awake             = true; // Line is assumed asserted until released below
+  sleep->state_since_ms    = pdTICKS_TO_MS(xTaskGetTickCount());
+  sleep->enabled           = true;
+
+  return sleep_set_wake_line(handler, false);
+}
+
+esp_err_t at_cmd_handler_sleep_disable(at_cmd_handler_t* handler)
+{
+  if (!handler)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (!handler->sleep.enabled)
+  {
+    return ESP_OK;
+  }
+
+  xSemaphoreTakeRecursive(handler->lock, portMAX_DELAY);
+  esp_err_t err = at_cmd_handler_wake(handler);
+  if (err == ESP_OK)
+  {
+    handler->sleep.enabled = false;
+  }
+  xSemaphoreGiveRecursive(handler->lock);
+
+  return err;
+}
+
+esp_err_t at_cmd_handler_wake(at_cmd_handler_t* handler)
+{
+  if (!handler)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  at_cmd_sleep_ctrl_t* sleep = &handler->sleep;
+  if (!sleep->enabled)
+  {
+    return ESP_OK;
+  }
+
+  if (sleep->awake)
+  {
+    return ESP_OK;
+  }
+
+  uint32_t  wake_start = pdTICKS_TO_MS(xTaskGetTickCount());
+  esp_err_t err        = sleep_set_wake_line(handler, true);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = sleep_probe_until_awake(handler, AT_CMD_WAKE_TIMEOUT_MS);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Module did not wake within %d ms", AT_CMD_WAKE_TIMEOUT_MS);
+    return err;
+  }
+
+  uint32_t latency = pdTICKS_TO_MS(xTaskGetTickCount()) - wake_start;
+  sleep->stats.wake_count++;
+  sleep->stats.wake_latency_total_ms += latency;
+  if (latency > sleep->stats.wake_latency_max_ms)
+  {
+    sleep->stats.wake_latency_max_ms = latency;
+  }
+
+  ESP_LOGD(TAG, "Module woken in %lu ms", (unsigned long) latency);
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_handler_allow_sleep(at_cmd_handler_t* handler)
+{
+  if (!handler)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  at_cmd_sleep_ctrl_t* sleep = &handler->sleep;
+  if (!sleep->enabled || !sleep->awake || sleep->batch_depth > 0)
+  {
+    return ESP_OK;
+  }
+
+  // Bytes still being sent when the module falls asleep would be lost
+  esp_err_t err = wait_tx_done(handler);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  return sleep_set_wake_line(handler, false);
+}
+
+esp_err_t at_cmd_handler_begin_batch(at_cmd_handler_t* handler)
+{
+  if (!handler)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (handler->sleep.batch_depth == UINT8_MAX)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  handler->sleep.batch_depth++;
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_handler_end_batch(at_cmd_handler_t* handler)
+{
+  if (!handler)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (handler->sleep.batch_depth == 0)
+  {
+    ESP_LOGE(TAG, "end_batch called without a matching begin_batch");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  handler->sleep.batch_depth--;
+  return at_cmd_handler_allow_sleep(handler);
+}
+
+uint32_t at_cmd_handler_avg_wake_latency_ms(const at_cmd_handler_t* handler)
+{
+  if (!handler || handler->sleep.stats.wake_count == 0)
+  {
+    return 0;
+  }
+
+  return handler->sleep.stats.wake_latency_total_ms / handler->sleep.stats.wake_count;
+}
+
+esp_err_t at_cmd_handler_get_sleep_stats(at_cmd_handler_t* handler, at_cmd_sleep_stats_t* stats)
+{
+  if (!handler || !stats)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (handler->sleep.enabled)
+  {
+    sleep_account_period(&handler->sleep, pdTICKS_TO_MS(xTaskGetTickCount()));
+  }
+
+  *stats = handler->sleep.stats;
+  return ESP_OK;
+}
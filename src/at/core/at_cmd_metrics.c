@@ -0,0 +1,446 @@
+#include "at_cmd_metrics.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/projdefs.h"
+
+#include <freertos/task.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_METRICS";
+
+esp_err_t at_cmd_metrics_init(at_cmd_metrics_t*       metrics,
+                              at_cmd_metrics_entry_t* entries,
+                              uint16_t                max_entries)
+{
+  if (!metrics || !entries || max_entries == 0)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(metrics, 0, sizeof(at_cmd_metrics_t));
+  metrics->entries         = entries;
+  metrics->max_entries     = max_entries;
+  metrics->period_start_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  metrics->lock = xSemaphoreCreateMutex();
+  if (!metrics->lock)
+  {
+    ESP_LOGE(TAG, "Failed to create metrics lock");
+    return ESP_ERR_NO_MEM;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_metrics_deinit(at_cmd_metrics_t* metrics)
+{
+  if (!metrics)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (metrics->lock)
+  {
+    vSemaphoreDelete(metrics->lock);
+    metrics->lock = NULL;
+  }
+  return ESP_OK;
+}
+
+// Caller holds the lock
+static void reset_locked(at_cmd_metrics_t* metrics, uint32_t now_ms)
+{
+  metrics->num_entries   = 0;
+  metrics->dropped       = 0;
+  metrics->num_cme_codes = 0;
+  metrics->cme_other     = 0;
+  for (int i = 0; i < AT_CMD_METRICS_GAUGE_MAX; i++)
+  {
+    metrics->gauges[i].peak = metrics->gauges[i].current;
+  }
+  metrics->period_start_ms = now_ms;
+}
+
+void at_cmd_metrics_reset(at_cmd_metrics_t* metrics)
+{
+  if (!metrics || !metrics->lock)
+  {
+    return;
+  }
+
+  uint32_t now = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  xSemaphoreTake(metrics->lock, portMAX_DELAY);
+  reset_locked(metrics, now);
+  xSemaphoreGive(metrics->lock);
+}
+
+// ------------------------------ RECORDING ---------------------------------
+
+uint8_t at_cmd_metrics_latency_bucket(uint32_t latency_ms)
+{
+  uint8_t bucket = 0;
+  while (latency_ms > 0 && bucket < AT_CMD_METRICS_LATENCY_BUCKETS - 1)
+  {
+    latency_ms >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+// Caller holds the lock. NULL once all entries are taken
+static at_cmd_metrics_entry_t*
+find_entry(at_cmd_metrics_t* metrics, const at_cmd_t* cmd, at_cmd_type_t type)
+{
+  for (uint16_t i = 0; i < metrics->num_entries; i++)
+  {
+    if (metrics->entries[i].cmd == cmd && metrics->entries[i].type == (uint8_t) type)
+    {
+      return &metrics->entries[i];
+    }
+  }
+
+  if (metrics->num_entries == metrics->max_entries)
+  {
+    return NULL;
+  }
+
+  at_cmd_metrics_entry_t* entry = &metrics->entries[metrics->num_entries++];
+  memset(entry, 0, sizeof(at_cmd_metrics_entry_t));
+  entry->cmd           = cmd;
+  entry->type          = (uint8_t) type;
+  entry->last_cme_code = AT_CMD_METRICS_CME_UNKNOWN;
+  return entry;
+}
+
+// Caller holds the lock
+static void count_cme_code(at_cmd_metrics_t* metrics, int16_t code)
+{
+  for (uint8_t i = 0; i < metrics->num_cme_codes; i++)
+  {
+    if (metrics->cme_codes[i].code == code)
+    {
+      metrics->cme_codes[i].count++;
+      return;
+    }
+  }
+
+  if (metrics->num_cme_codes == AT_CMD_METRICS_MAX_CME_CODES)
+  {
+    metrics->cme_other++;
+    return;
+  }
+
+  metrics->cme_codes[metrics->num_cme_codes].code  = code;
+  metrics->cme_codes[metrics->num_cme_codes].count = 1;
+  metrics->num_cme_codes++;
+}
+
+void at_cmd_metrics_record(at_cmd_metrics_t*                metrics,
+                           const at_cmd_t*                  cmd,
+                           at_cmd_type_t                    type,
+                           const at_cmd_metrics_exchange_t* exchange)
+{
+  if (!metrics || !metrics->lock || !cmd || !exchange)
+  {
+    return;
+  }
+
+  xSemaphoreTake(metrics->lock, portMAX_DELAY);
+
+  at_cmd_metrics_entry_t* entry = find_entry(metrics, cmd, type);
+  if (!entry)
+  {
+    metrics->dropped++;
+    xSemaphoreGive(metrics->lock);
+    return;
+  }
+
+  if (exchange->result == ESP_OK)
+  {
+    entry->ok++;
+  }
+  else if (exchange->result == ESP_ERR_TIMEOUT)
+  {
+    entry->timeout++;
+  }
+  else if (exchange->cme_error)
+  {
+    entry->cme_error++;
+    entry->last_cme_code = exchange->cme_code;
+    count_cme_code(metrics, exchange->cme_code);
+  }
+  else if (exchange->result == ESP_FAIL)
+  {
+    entry->error++;
+  }
+  else
+  {
+    entry->failed++;
+  }
+
+  entry->bytes_tx += exchange->bytes_tx;
+  entry->bytes_rx += exchange->bytes_rx;
+
+  // Latency only means something for commands that made it onto the UART
+  if (exchange->sent)
+  {
+    entry->sent++;
+    entry->latency_total_ms += exchange->latency_ms;
+    if (exchange->latency_ms > entry->latency_max_ms)
+    {
+      entry->latency_max_ms = exchange->latency_ms;
+    }
+    entry->latency_hist[at_cmd_metrics_latency_bucket(exchange->latency_ms)]++;
+  }
+
+  xSemaphoreGive(metrics->lock);
+}
+
+void at_cmd_metrics_gauge_add(at_cmd_metrics_t*      metrics,
+                              at_cmd_metrics_gauge_t gauge,
+                              int32_t                delta)
+{
+  if (!metrics || !metrics->lock || gauge >= AT_CMD_METRICS_GAUGE_MAX)
+  {
+    return;
+  }
+
+  xSemaphoreTake(metrics->lock, portMAX_DELAY);
+  at_cmd_metrics_gauge_value_t* value = &metrics->gauges[gauge];
+  value->current += delta;
+  if (value->current > value->peak)
+  {
+    value->peak = value->current;
+  }
+  xSemaphoreGive(metrics->lock);
+}
+
+// ------------------------------ READING ---------------------------------
+
+esp_err_t at_cmd_metrics_snapshot(at_cmd_metrics_t*          metrics,
+                                  at_cmd_metrics_snapshot_t* snapshot,
+                                  at_cmd_metrics_entry_t*    entries,
+                                  uint16_t                   max_entries,
+                                  bool                       reset)
+{
+  if (!metrics || !metrics->lock || !snapshot || (!entries && max_entries > 0))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint32_t now = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  xSemaphoreTake(metrics->lock, portMAX_DELAY);
+
+  uint16_t copied = (metrics->num_entries < max_entries) ? metrics->num_entries : max_entries;
+  if (copied > 0)
+  {
+    memcpy(entries, metrics->entries, copied * sizeof(at_cmd_metrics_entry_t));
+  }
+
+  snapshot->period_ms     = now - metrics->period_start_ms;
+  snapshot->num_entries   = copied;
+  snapshot->total_entries = metrics->num_entries;
+  snapshot->dropped       = metrics->dropped;
+  snapshot->num_cme_codes = metrics->num_cme_codes;
+  snapshot->cme_other     = metrics->cme_other;
+  memcpy(snapshot->gauges, metrics->gauges, sizeof(snapshot->gauges));
+  memcpy(snapshot->cme_codes, metrics->cme_codes, sizeof(snapshot->cme_codes));
+
+  if (reset)
+  {
+    reset_locked(metrics, now);
+  }
+
+  xSemaphoreGive(metrics->lock);
+  return ESP_OK;
+}
+
+// ------------------------------ ENCODING ---------------------------------
+
+typedef struct
+{
+  uint8_t* buffer;
+  size_t   size;
+  size_t   pos;
+  bool     overflow;
+} encoder_t;
+
+static void put_varint(encoder_t* enc, uint64_t value)
+{
+  do
+  {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value)
+    {
+      byte |= 0x80;
+    }
+
+    if (enc->pos < enc->size)
+    {
+      enc->buffer[enc->pos++] = byte;
+    }
+    else
+    {
+      enc->overflow = true;
+    }
+  } while (value);
+}
+
+static void put_signed(encoder_t* enc, int32_t value)
+{
+  put_varint(enc, ((uint32_t) value << 1) ^ (uint32_t) (value >> 31));
+}
+
+static void put_bytes(encoder_t* enc, const char* data, size_t len)
+{
+  if (enc->pos + len > enc->size)
+  {
+    enc->overflow = true;
+    return;
+  }
+  memcpy(enc->buffer + enc->pos, data, len);
+  enc->pos += len;
+}
+
+static void put_entry(encoder_t* enc, const at_cmd_metrics_entry_t* entry)
+{
+  const char* name     = entry->cmd->name ? entry->cmd->name : "";
+  size_t      name_len = strlen(name);
+
+  put_varint(enc, name_len);
+  put_bytes(enc, name, name_len);
+  put_varint(enc, entry->type);
+  put_varint(enc, entry->sent);
+  put_varint(enc, entry->ok);
+  put_varint(enc, entry->error);
+  put_varint(enc, entry->cme_error);
+  put_varint(enc, entry->timeout);
+  put_varint(enc, entry->failed);
+  put_signed(enc, entry->last_cme_code);
+  put_varint(enc, entry->bytes_tx);
+  put_varint(enc, entry->bytes_rx);
+  put_varint(enc, entry->latency_total_ms);
+  put_varint(enc, entry->latency_max_ms);
+
+  // Most buckets of a command are empty - only the used ones are sent
+  uint32_t mask = 0;
+  for (int i = 0; i < AT_CMD_METRICS_LATENCY_BUCKETS; i++)
+  {
+    if (entry->latency_hist[i])
+    {
+      mask |= 1UL << i;
+    }
+  }
+  put_varint(enc, mask);
+  for (int i = 0; i < AT_CMD_METRICS_LATENCY_BUCKETS; i++)
+  {
+    if (entry->latency_hist[i])
+    {
+      put_varint(enc, entry->latency_hist[i]);
+    }
+  }
+}
+
+esp_err_t at_cmd_metrics_encode(const at_cmd_metrics_snapshot_t* snapshot,
+                                const at_cmd_metrics_entry_t*    entries,
+                                uint8_t*                         buffer,
+                                size_t                           buffer_size,
+                                size_t*                          len)
+{
+  if (!snapshot || (!entries && snapshot->num_entries > 0) || !buffer || !len)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  encoder_t enc = {.buffer = buffer, .size = buffer_size, .pos = 0, .overflow = false};
+
+  put_varint(&enc, AT_CMD_METRICS_ENCODING_VERSION);
+  put_varint(&enc, snapshot->period_ms);
+  put_varint(&enc, snapshot->dropped);
+  for (int i = 0; i < AT_CMD_METRICS_GAUGE_MAX; i++)
+  {
+    put_signed(&enc, snapshot->gauges[i].current);
+    put_signed(&enc, snapshot->gauges[i].peak);
+  }
+
+  put_varint(&enc, snapshot->num_cme_codes);
+  for (uint8_t i = 0; i < snapshot->num_cme_codes; i++)
+  {
+    put_signed(&enc, snapshot->cme_codes[i].code);
+    put_varint(&enc, snapshot->cme_codes[i].count);
+  }
+  put_varint(&enc, snapshot->cme_other);
+
+  put_varint(&enc, snapshot->num_entries);
+  for (uint16_t i = 0; i < snapshot->num_entries && !enc.overflow; i++)
+  {
+    put_entry(&enc, &entries[i]);
+  }
+
+  if (enc.overflow)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  *len = enc.pos;
+  return ESP_OK;
+}
+
+static const char* type_suffix(uint8_t type)
+{
+  switch (type)
+  {
+    case AT_CMD_TYPE_TEST:
+      return "=?";
+    case AT_CMD_TYPE_READ:
+      return "?";
+    case AT_CMD_TYPE_WRITE:
+      return "=";
+    default:
+      return "";
+  }
+}
+
+void at_cmd_metrics_log(const at_cmd_metrics_snapshot_t* snapshot,
+                        const at_cmd_metrics_entry_t*    entries)
+{
+  if (!snapshot || (!entries && snapshot->num_entries > 0))
+  {
+    return;
+  }
+
+  ESP_LOGI(TAG,
+           "%lu ms: %u cmds (%lu dropped), queue %ld (peak %ld), publishes %ld (peak %ld)",
+           (unsigned long) snapshot->period_ms,
+           (unsigned) snapshot->total_entries,
+           (unsigned long) snapshot->dropped,
+           (long) snapshot->gauges[AT_CMD_METRICS_GAUGE_QUEUE_DEPTH].current,
+           (long) snapshot->gauges[AT_CMD_METRICS_GAUGE_QUEUE_DEPTH].peak,
+           (long) snapshot->gauges[AT_CMD_METRICS_GAUGE_PUBLISHES_IN_FLIGHT].current,
+           (long) snapshot->gauges[AT_CMD_METRICS_GAUGE_PUBLISHES_IN_FLIGHT].peak);
+
+  for (uint16_t i = 0; i < snapshot->num_entries; i++)
+  {
+    const at_cmd_metrics_entry_t* entry = &entries[i];
+    ESP_LOGI(TAG,
+             "AT+%s%s sent %lu ok %lu err %lu cme %lu (last %d) tmo %lu fail %lu, tx %llu rx %llu"
+             ", avg %lu ms max %lu ms",
+             entry->cmd->name,
+             type_suffix(entry->type),
+             (unsigned long) entry->sent,
+             (unsigned long) entry->ok,
+             (unsigned long) entry->error,
+             (unsigned long) entry->cme_error,
+             entry->last_cme_code,
+             (unsigned long) entry->timeout,
+             (unsigned long) entry->failed,
+             (unsigned long long) entry->bytes_tx,
+             (unsigned long long) entry->bytes_rx,
+             (unsigned long) (entry->sent ? entry->latency_total_ms / entry->sent : 0),
+             (unsigned long) entry->latency_max_ms);
+  }
+}
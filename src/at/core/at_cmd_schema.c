@@ -0,0 +1,198 @@
+#include "at_cmd_schema.h"
+
+#include "at_cmd_tokenizer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_SCHEMA";
+
+// ------------------------------ MEMBER ACCESS ---------------------------------
+
+static int32_t load_int(const at_schema_field_t* field, const void* base)
+{
+  const uint8_t* member    = (const uint8_t*) base + field->offset;
+  bool           is_signed = field->min < 0;
+
+  switch (field->size)
+  {
+    case 1:
+    {
+      uint8_t value;
+      memcpy(&value, member, sizeof(value));
+      return is_signed ? (int32_t) (int8_t) value : (int32_t) value;
+    }
+    case 2:
+    {
+      uint16_t value;
+      memcpy(&value, member, sizeof(value));
+      return is_signed ? (int32_t) (int16_t) value : (int32_t) value;
+    }
+    default:
+    {
+      int32_t value;
+      memcpy(&value, member, sizeof(value));
+      return value;
+    }
+  }
+}
+
+static void store_int(const at_schema_field_t* field, void* base, int32_t value)
+{
+  uint8_t* member = (uint8_t*) base + field->offset;
+
+  switch (field->size)
+  {
+    case 1:
+    {
+      uint8_t narrow = (uint8_t) value;
+      memcpy(member, &narrow, sizeof(narrow));
+      break;
+    }
+    case 2:
+    {
+      uint16_t narrow = (uint16_t) value;
+      memcpy(member, &narrow, sizeof(narrow));
+      break;
+    }
+    default:
+      memcpy(member, &value, sizeof(value));
+      break;
+  }
+}
+
+static bool int_is_valid(const at_schema_field_t* field, int32_t value)
+{
+  if (field->values)
+  {
+    for (uint8_t i = 0; i < field->num_values; i++)
+    {
+      if (field->values[i].value == value)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  return value >= field->min && value <= field->max;
+}
+
+// ------------------------------ PARSE ---------------------------------
+
+esp_err_t at_schema_parse(const at_schema_t* schema, const char* response, void* parsed_data)
+{
+  if (NULL == schema || NULL == response || NULL == parsed_data)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(parsed_data, 0, schema->size);
+
+  at_tokenizer_t tok;
+  if (at_tokenizer_init(&tok, response, schema->prefix) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "No '%s' line in response", schema->prefix);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  for (uint8_t i = 0; i < schema->num_fields; i++)
+  {
+    const at_schema_field_t* field = &schema->fields[i];
+
+    at_field_t token;
+    esp_err_t  err = at_tokenizer_next(&tok, &token);
+    if (err == ESP_ERR_NOT_FOUND && i >= schema->num_required)
+    {
+      return ESP_OK;
+    }
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "%sfield %u is missing or malformed", schema->prefix, (unsigned) (i + 1));
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    if (field->kind == AT_SCHEMA_KIND_STRING)
+    {
+      if (at_field_copy(&token, (char*) parsed_data + field->offset, field->size) != ESP_OK)
+      {
+        ESP_LOGE(TAG, "%sfield %u is too long", schema->prefix, (unsigned) (i + 1));
+        return ESP_ERR_INVALID_RESPONSE;
+      }
+      continue;
+    }
+
+    int32_t value;
+    err = at_field_get_int(&token, &value);
+    if (err == ESP_ERR_NOT_FOUND && i >= schema->num_required)
+    {
+      continue;
+    }
+    if (err != ESP_OK || !int_is_valid(field, value))
+    {
+      ESP_LOGE(TAG, "%sfield %u is invalid", schema->prefix, (unsigned) (i + 1));
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    store_int(field, parsed_data, value);
+  }
+
+  return ESP_OK;
+}
+
+// ------------------------------ FORMAT ---------------------------------
+
+esp_err_t
+at_schema_format(const at_schema_t* schema, const void* params, char* buffer, size_t buffer_size)
+{
+  if (NULL == schema || NULL == params || NULL == buffer || 0 == buffer_size)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  size_t pos = 0;
+  for (uint8_t i = 0; i < schema->num_fields; i++)
+  {
+    const at_schema_field_t* field     = &schema->fields[i];
+    const char*              separator = (i == 0) ? "=" : ",";
+    int                      written;
+
+    if (field->kind == AT_SCHEMA_KIND_STRING)
+    {
+      const char* value = (const char*) params + field->offset;
+      size_t      len   = strnlen(value, field->size);
+      if (len == field->size || len < (size_t) field->min || memchr(value, '"', len))
+      {
+        ESP_LOGE(TAG, "Invalid string for %sfield %u", schema->prefix, (unsigned) (i + 1));
+        return ESP_ERR_INVALID_ARG;
+      }
+      written = snprintf(buffer + pos, buffer_size - pos, "%s\"%s\"", separator, value);
+    }
+    else
+    {
+      int32_t value = load_int(field, params);
+      if (!int_is_valid(field, value))
+      {
+        ESP_LOGE(TAG,
+                 "Invalid value %d for %sfield %u",
+                 (int) value,
+                 schema->prefix,
+                 (unsigned) (i + 1));
+        return ESP_ERR_INVALID_ARG;
+      }
+      written = snprintf(buffer + pos, buffer_size - pos, "%s%d", separator, (int) value);
+    }
+
+    if ((written < 0) || ((size_t) written >= buffer_size - pos))
+    {
+      buffer[0] = '\0';
+      return ESP_ERR_INVALID_SIZE;
+    }
+    pos += (size_t) written;
+  }
+
+  return ESP_OK;
+}
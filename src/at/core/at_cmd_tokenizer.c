@@ -0,0 +1,450 @@
+#include "at_cmd_tokenizer.h"
+
+#include "esp_err.h"
+
+#include <string.h>
+
+// Ends at CR, LF or NUL
+static const char* find_line_end(const char* pos)
+{
+  return pos + strcspn(pos, "\r\n");
+}
+
+esp_err_t at_tokenizer_init(at_tokenizer_t* tok, const char* response, const char* prefix)
+{
+  if (!tok || !response || !prefix)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const char* start = strstr(response, prefix);
+  if (!start)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  tok->prefix     = prefix;
+  tok->prefix_len = strlen(prefix);
+  tok->pos        = start + tok->prefix_len;
+  tok->end        = find_line_end(tok->pos);
+  tok->done       = false;
+
+  return ESP_OK;
+}
+
+esp_err_t at_tokenizer_next_line(at_tokenizer_t* tok)
+{
+  if (!tok || !tok->prefix)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // A NUL (rather than CR / LF) ended the string, so there is nothing after this line
+  if (*tok->end == '\0')
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  const char* start = strstr(tok->end, tok->prefix);
+  if (!start)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  tok->pos  = start + tok->prefix_len;
+  tok->end  = find_line_end(tok->pos);
+  tok->done = false;
+
+  return ESP_OK;
+}
+
+esp_err_t at_tokenizer_init_span(at_tokenizer_t* tok, const char* start, size_t len)
+{
+  if (!tok || !start)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  tok->prefix     = NULL;
+  tok->prefix_len = 0;
+  tok->pos        = start;
+  tok->end        = start + len;
+  tok->done       = false;
+
+  return ESP_OK;
+}
+
+// Returns the closing parenthesis matching the one at 'open', skipping over quoted strings
+static const char* find_list_end(const char* open, const char* end)
+{
+  int  depth  = 0;
+  bool quoted = false;
+
+  for (const char* pos = open; pos < end; pos++)
+  {
+    if (*pos == '"')
+    {
+      quoted = !quoted;
+    }
+    else if (!quoted && *pos == '(')
+    {
+      depth++;
+    }
+    else if (!quoted && *pos == ')' && --depth == 0)
+    {
+      return pos;
+    }
+  }
+
+  return NULL;
+}
+
+esp_err_t at_tokenizer_next(at_tokenizer_t* tok, at_field_t* field)
+{
+  if (!tok || !field)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (tok->done)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  const char* pos = tok->pos;
+
+  if (pos < tok->end && *pos == '"')
+  {
+    const char* close = memchr(pos + 1, '"', (size_t) (tok->end - pos - 1));
+    if (!close)
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    field->type  = AT_FIELD_STRING;
+    field->start = pos + 1;
+    field->len   = (size_t) (close - pos - 1);
+    pos          = close + 1;
+  }
+  else if (pos < tok->end && *pos == '(')
+  {
+    const char* close = find_list_end(pos, tok->end);
+    if (!close)
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    field->type  = AT_FIELD_LIST;
+    field->start = pos + 1;
+    field->len   = (size_t) (close - pos - 1);
+    pos          = close + 1;
+  }
+  else
+  {
+    const char* value_end = pos;
+    while (value_end < tok->end && *value_end != ',')
+    {
+      value_end++;
+    }
+    field->type  = (value_end == pos) ? AT_FIELD_EMPTY : AT_FIELD_VALUE;
+    field->start = pos;
+    field->len   = (size_t) (value_end - pos);
+    pos          = value_end;
+  }
+
+  if (pos == tok->end)
+  {
+    tok->done = true;
+  }
+  else if (*pos == ',')
+  {
+    pos++;
+  }
+  else
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  tok->pos = pos;
+  return ESP_OK;
+}
+
+// ------------------------------ FIELD VALUES ---------------------------------
+
+// Parse a signed decimal number at [*pos, end) and move 'pos' past it
+static bool parse_int(const char** pos, const char* end, int32_t* value)
+{
+  const char* p        = *pos;
+  bool        negative = (p < end && *p == '-');
+  if (negative || (p < end && *p == '+'))
+  {
+    p++;
+  }
+
+  const char* digits = p;
+  int64_t     result = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++)
+  {
+    result = result * 10 + (*p - '0');
+    if (result > (int64_t) INT32_MAX + 1)
+    {
+      return false;
+    }
+  }
+
+  if (p == digits || (!negative && result > INT32_MAX))
+  {
+    return false;
+  }
+
+  *value = (int32_t) (negative ? -result : result);
+  *pos   = p;
+  return true;
+}
+
+static esp_err_t check_field(const at_field_t* field)
+{
+  if (!field)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  return (field->type == AT_FIELD_EMPTY || field->len == 0) ? ESP_ERR_NOT_FOUND : ESP_OK;
+}
+
+esp_err_t at_field_get_int(const at_field_t* field, int32_t* value)
+{
+  esp_err_t err = check_field(field);
+  if (err != ESP_OK || !value)
+  {
+    return value ? err : ESP_ERR_INVALID_ARG;
+  }
+
+  const char* pos = field->start;
+  const char* end = field->start + field->len;
+  if (field->type != AT_FIELD_VALUE || !parse_int(&pos, end, value) || pos != end)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t at_field_get_hex(const at_field_t* field, uint32_t* value)
+{
+  esp_err_t err = check_field(field);
+  if (err != ESP_OK || !value)
+  {
+    return value ? err : ESP_ERR_INVALID_ARG;
+  }
+
+  if (field->type == AT_FIELD_LIST || field->len > 8)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  uint32_t result = 0;
+  for (size_t i = 0; i < field->len; i++)
+  {
+    char c = field->start[i];
+    int  digit;
+    if (c >= '0' && c <= '9')
+    {
+      digit = c - '0';
+    }
+    else if (c >= 'A' && c <= 'F')
+    {
+      digit = c - 'A' + 10;
+    }
+    else if (c >= 'a' && c <= 'f')
+    {
+      digit = c - 'a' + 10;
+    }
+    else
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    result = (result << 4) | (uint32_t) digit;
+  }
+
+  *value = result;
+  return ESP_OK;
+}
+
+esp_err_t at_field_get_fixed(const at_field_t* field, uint8_t decimals, int64_t* value)
+{
+  esp_err_t err = check_field(field);
+  if (err != ESP_OK || !value)
+  {
+    return value ? err : ESP_ERR_INVALID_ARG;
+  }
+
+  if (field->type != AT_FIELD_VALUE || decimals > 9)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  const char* pos      = field->start;
+  const char* end      = field->start + field->len;
+  bool        negative = (*pos == '-');
+  if (negative)
+  {
+    pos++;
+  }
+
+  // Keeps the result (with all of its fraction digits) well within int64
+  const int64_t limit = INT64_MAX / 10000000000LL;
+
+  int64_t result = 0;
+  bool    digits = false;
+  for (; pos < end && *pos >= '0' && *pos <= '9'; pos++)
+  {
+    result = result * 10 + (*pos - '0');
+    digits = true;
+    if (result > limit)
+    {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+  }
+
+  if (pos < end && *pos == '.')
+  {
+    pos++;
+  }
+  for (uint8_t i = 0; i < decimals; i++)
+  {
+    result *= 10;
+    if (pos < end && *pos >= '0' && *pos <= '9')
+    {
+      result += *pos++ - '0';
+      digits = true;
+    }
+  }
+
+  while (pos < end && *pos >= '0' && *pos <= '9')
+  {
+    pos++;
+  }
+
+  if (!digits || pos != end)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  *value = negative ? -result : result;
+  return ESP_OK;
+}
+
+// Parse 'a-b' (or just 'a') at [*pos, end) and move 'pos' past it
+static bool parse_range(const char** pos, const char* end, int32_t* min, int32_t* max)
+{
+  if (!parse_int(pos, end, min))
+  {
+    return false;
+  }
+
+  *max = *min;
+  if (*pos < end && **pos == '-')
+  {
+    (*pos)++;
+    return parse_int(pos, end, max) && *max >= *min;
+  }
+
+  return true;
+}
+
+esp_err_t at_field_get_range(const at_field_t* field, int32_t* min, int32_t* max)
+{
+  esp_err_t err = check_field(field);
+  if (err != ESP_OK || !min || !max)
+  {
+    return (min && max) ? err : ESP_ERR_INVALID_ARG;
+  }
+
+  const char* pos = field->start;
+  const char* end = field->start + field->len;
+  if (field->type == AT_FIELD_STRING || !parse_range(&pos, end, min, max) || pos != end)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  return ESP_OK;
+}
+
+bool at_field_list_contains(const at_field_t* field, int32_t value)
+{
+  if (check_field(field) != ESP_OK || field->type == AT_FIELD_STRING)
+  {
+    return false;
+  }
+
+  const char* pos = field->start;
+  const char* end = field->start + field->len;
+  while (pos < end)
+  {
+    int32_t min, max;
+    if (!parse_range(&pos, end, &min, &max))
+    {
+      return false;
+    }
+    if (value >= min && value <= max)
+    {
+      return true;
+    }
+    if (pos < end && *pos != ',')
+    {
+      return false;
+    }
+    pos++;
+  }
+
+  return false;
+}
+
+esp_err_t at_field_copy(const at_field_t* field, char* out, size_t out_size)
+{
+  if (!field || !out || out_size == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  size_t len = field->len;
+  if (len >= out_size)
+  {
+    len = out_size - 1;
+  }
+  memcpy(out, field->start, len);
+  out[len] = '\0';
+
+  return (len < field->len) ? ESP_ERR_INVALID_SIZE : ESP_OK;
+}
+
+bool at_field_equals(const at_field_t* field, const char* str)
+{
+  if (!field || !str)
+  {
+    return false;
+  }
+
+  return strlen(str) == field->len && memcmp(field->start, str, field->len) == 0;
+}
+
+esp_err_t at_field_to_enum(const at_field_t*     field,
+                           const enum_str_map_t* map,
+                           size_t                map_size,
+                           int*                  value)
+{
+  esp_err_t err = check_field(field);
+  if (err != ESP_OK || !map || !value)
+  {
+    return (map && value) ? err : ESP_ERR_INVALID_ARG;
+  }
+
+  for (size_t i = 0; i < map_size; i++)
+  {
+    if (at_field_equals(field, map[i].string))
+    {
+      *value = map[i].value;
+      return ESP_OK;
+    }
+  }
+
+  return ESP_ERR_INVALID_RESPONSE;
+}
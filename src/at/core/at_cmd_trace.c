@@ -0,0 +1,334 @@
+#include "at_cmd_trace.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/projdefs.h"
+
+#include <freertos/task.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "AT_CMD_TRACE";
+
+esp_err_t at_cmd_trace_init(at_cmd_trace_t*        trace,
+                            at_cmd_trace_record_t* records,
+                            uint16_t               num_records,
+                            uint8_t*               capture,
+                            size_t                 capture_size,
+                            uint16_t               capture_max)
+{
+  if (!trace || !records || num_records == 0 || (capture && capture_size == 0))
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(trace, 0, sizeof(at_cmd_trace_t));
+  trace->records      = records;
+  trace->num_records  = num_records;
+  trace->capture      = capture;
+  trace->capture_size = capture ? capture_size : 0;
+  trace->capture_max  = capture ? capture_max : 0;
+  trace->enabled      = true;
+
+  trace->lock = xSemaphoreCreateMutex();
+  if (!trace->lock)
+  {
+    ESP_LOGE(TAG, "Failed to create trace lock");
+    return ESP_ERR_NO_MEM;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t at_cmd_trace_deinit(at_cmd_trace_t* trace)
+{
+  if (!trace)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (trace->lock)
+  {
+    vSemaphoreDelete(trace->lock);
+    trace->lock = NULL;
+  }
+  trace->enabled = false;
+  return ESP_OK;
+}
+
+void at_cmd_trace_enable(at_cmd_trace_t* trace, bool enabled)
+{
+  if (trace)
+  {
+    trace->enabled = enabled;
+  }
+}
+
+void at_cmd_trace_clear(at_cmd_trace_t* trace)
+{
+  if (!trace || !trace->lock)
+  {
+    return;
+  }
+
+  xSemaphoreTake(trace->lock, portMAX_DELAY);
+  trace->next_seq     = 0;
+  trace->capture_pos  = 0;
+  trace->capture_head = 0;
+  xSemaphoreGive(trace->lock);
+}
+
+// ------------------------------ CAPTURE RING ---------------------------------
+// 'capture_pos' counts all bytes ever captured (records keep it to find their bytes again), and
+// 'capture_head' is where the next byte goes. The bytes of a record are intact while no more than
+// 'capture_size' bytes have been captured since it started
+
+static void capture_write(at_cmd_trace_t* trace, const uint8_t* data, size_t len)
+{
+  size_t first = trace->capture_size - trace->capture_head;
+  if (first > len)
+  {
+    first = len;
+  }
+
+  memcpy(trace->capture + trace->capture_head, data, first);
+  memcpy(trace->capture, data + first, len - first);
+  trace->capture_head = (trace->capture_head + len) % trace->capture_size;
+  trace->capture_pos += (uint32_t) len;
+}
+
+static bool capture_read(const at_cmd_trace_t* trace, uint32_t pos, uint8_t* out, size_t len)
+{
+  uint32_t distance = trace->capture_pos - pos; // Unsigned - also right once the count wraps
+  if (distance > trace->capture_size)
+  {
+    return false;
+  }
+
+  size_t offset = (trace->capture_head + trace->capture_size - distance) % trace->capture_size;
+  size_t first  = trace->capture_size - offset;
+  if (first > len)
+  {
+    first = len;
+  }
+
+  memcpy(out, trace->capture + offset, first);
+  memcpy(out + first, trace->capture, len - first);
+  return true;
+}
+
+// ------------------------------ RECORDING ---------------------------------
+
+void at_cmd_trace_record(at_cmd_trace_t*      trace,
+                         at_cmd_trace_event_t event,
+                         const at_cmd_t*      cmd,
+                         at_cmd_type_t        type,
+                         esp_err_t            result,
+                         uint32_t             latency_ms,
+                         const void*          data,
+                         size_t               len)
+{
+  if (!trace || !trace->enabled || !trace->lock)
+  {
+    return;
+  }
+
+  uint32_t now = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  xSemaphoreTake(trace->lock, portMAX_DELAY);
+
+  at_cmd_trace_record_t* record = &trace->records[trace->next_seq % trace->num_records];
+  record->seq                   = trace->next_seq++;
+  record->timestamp_ms          = now;
+  record->cmd                   = cmd;
+  record->latency_ms            = latency_ms;
+  record->result                = result;
+  record->len                   = (len > UINT16_MAX) ? UINT16_MAX : (uint16_t) len;
+  record->event                 = (uint8_t) event;
+  record->cmd_type              = (uint8_t) type;
+  record->capture_pos           = trace->capture_pos;
+  record->capture_len           = 0;
+
+  if (trace->capture && data && len > 0)
+  {
+    size_t capture_len = len;
+    if (capture_len > trace->capture_max)
+    {
+      capture_len = trace->capture_max;
+    }
+    if (capture_len > trace->capture_size)
+    {
+      capture_len = trace->capture_size;
+    }
+    capture_write(trace, (const uint8_t*) data, capture_len);
+    record->capture_len = (uint16_t) capture_len;
+  }
+
+  xSemaphoreGive(trace->lock);
+}
+
+// ------------------------------ READING ---------------------------------
+
+esp_err_t at_cmd_trace_read(at_cmd_trace_t*        trace,
+                            uint32_t*              seq,
+                            at_cmd_trace_record_t* record,
+                            void*                  capture,
+                            size_t                 capture_size)
+{
+  if (!trace || !trace->lock || !seq || !record)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTake(trace->lock, portMAX_DELAY);
+
+  uint32_t held = (trace->next_seq < trace->num_records) ? trace->next_seq : trace->num_records;
+  if (*seq >= trace->next_seq)
+  {
+    xSemaphoreGive(trace->lock);
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (trace->next_seq - *seq > held)
+  {
+    *seq = trace->next_seq - held;
+  }
+
+  *record = trace->records[*seq % trace->num_records];
+
+  size_t capture_len = capture ? record->capture_len : 0;
+  if (capture_len > capture_size)
+  {
+    capture_len = capture_size;
+  }
+  if (capture_len > 0 &&
+      !capture_read(trace, record->capture_pos, (uint8_t*) capture, capture_len))
+  {
+    capture_len = 0;
+  }
+  record->capture_len = (uint16_t) capture_len;
+
+  *seq = record->seq + 1;
+
+  xSemaphoreGive(trace->lock);
+  return ESP_OK;
+}
+
+static const char* event_name(uint8_t event)
+{
+  switch (event)
+  {
+    case AT_CMD_TRACE_EVENT_SEND:
+      return "SEND";
+    case AT_CMD_TRACE_EVENT_PROMPT:
+      return "PROMPT";
+    case AT_CMD_TRACE_EVENT_RESPONSE:
+      return "RESPONSE";
+    case AT_CMD_TRACE_EVENT_DONE:
+      return "DONE";
+    case AT_CMD_TRACE_EVENT_URC:
+      return "URC";
+    default:
+      return "?";
+  }
+}
+
+static const char* type_suffix(uint8_t type)
+{
+  switch (type)
+  {
+    case AT_CMD_TYPE_TEST:
+      return "=?";
+    case AT_CMD_TYPE_READ:
+      return "?";
+    case AT_CMD_TYPE_WRITE:
+      return "=";
+    default:
+      return "";
+  }
+}
+
+int at_cmd_trace_format(const at_cmd_trace_record_t* record,
+                        const void*                  capture,
+                        char*                        buffer,
+                        size_t                       buffer_size)
+{
+  if (!record || !buffer || buffer_size == 0)
+  {
+    return -1;
+  }
+
+  int written = snprintf(buffer,
+                         buffer_size,
+                         "#%lu %lu ms %-8s %s%s%s len %u, %lu ms, %s",
+                         (unsigned long) record->seq,
+                         (unsigned long) record->timestamp_ms,
+                         event_name(record->event),
+                         record->cmd ? "AT+" : "",
+                         record->cmd ? record->cmd->name : "-",
+                         record->cmd ? type_suffix(record->cmd_type) : "",
+                         (unsigned) record->len,
+                         (unsigned long) record->latency_ms,
+                         esp_err_to_name(record->result));
+  if (written < 0 || (size_t) written >= buffer_size || !capture || record->capture_len == 0)
+  {
+    return written;
+  }
+
+  // Escaped excerpt, as much of it as fits
+  size_t         pos   = (size_t) written;
+  const uint8_t* bytes = (const uint8_t*) capture;
+  const char*    open  = " \"";
+  for (const char* c = open; *c && pos + 1 < buffer_size; c++)
+  {
+    buffer[pos++] = *c;
+  }
+  for (uint16_t i = 0; i < record->capture_len && pos + 5 < buffer_size; i++)
+  {
+    if (bytes[i] == '\r')
+    {
+      pos += (size_t) snprintf(buffer + pos, buffer_size - pos, "\\r");
+    }
+    else if (bytes[i] == '\n')
+    {
+      pos += (size_t) snprintf(buffer + pos, buffer_size - pos, "\\n");
+    }
+    else if (bytes[i] < 0x20 || bytes[i] >= 0x7F || bytes[i] == '"')
+    {
+      pos += (size_t) snprintf(buffer + pos, buffer_size - pos, "\\x%02X", bytes[i]);
+    }
+    else
+    {
+      buffer[pos++] = (char) bytes[i];
+    }
+  }
+  if (pos + 1 < buffer_size)
+  {
+    buffer[pos++] = '"';
+  }
+  buffer[pos] = '\0';
+
+  return (int) pos;
+}
+
+esp_err_t at_cmd_trace_dump(at_cmd_trace_t* trace)
+{
+  if (!trace || !trace->lock)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint8_t               capture[AT_CMD_TRACE_LINE_MAX_LEN / 2];
+  char                  line[AT_CMD_TRACE_LINE_MAX_LEN];
+  at_cmd_trace_record_t record;
+  uint32_t              seq = 0;
+
+  // Formatting happens outside the lock, a record at a time, so recording is never held up for long
+  while (at_cmd_trace_read(trace, &seq, &record, capture, sizeof(capture)) == ESP_OK)
+  {
+    at_cmd_trace_format(&record, capture, line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+  }
+
+  return ESP_OK;
+}
@@ -0,0 +1,625 @@
+#include "bg95_cmux.h"
+
+#include "freertos/projdefs.h"
+
+#include <esp_log.h>
+#include <string.h>
+
+static const char* TAG = "BG95_CMUX";
+
+// Frame fields (27.010 basic option)
+#define CMUX_FLAG 0xF9
+#define CMUX_EA 0x01 // Extension bit - set on the last byte of a field
+#define CMUX_CR 0x02 // Command / response bit
+#define CMUX_PF 0x10 // Poll / final bit
+
+// Frame types (control field, P/F bit cleared)
+#define CMUX_SABM 0x2F
+#define CMUX_UA 0x63
+#define CMUX_DM 0x0F
+#define CMUX_DISC 0x43
+#define CMUX_UIH 0xEF
+
+// Control channel (DLCI 0) message types (EA set, C/R cleared)
+#define CMUX_MSG_MSC 0xE1 // Modem status command - carries the flow control bit
+#define CMUX_MSG_CLD 0xC1 // Multiplexer close down
+
+// V.24 signals of the MSC message
+#define CMUX_V24_FC 0x02 // Flow control - set means stop sending
+#define CMUX_V24_RTC 0x04
+#define CMUX_V24_RTR 0x08
+#define CMUX_V24_DV 0x80
+
+#define CMUX_NO_RESPONSE 0xFF
+#define CMUX_RX_CHUNK_SIZE 64
+#define CMUX_RX_POLL_MS 10
+
+uint8_t bg95_cmux_fcs(const uint8_t* data, size_t len)
+{
+  // CRC-8, polynomial x^8 + x^2 + x + 1 processed LSB first (reversed 0xE0), initial value 0xFF
+  uint8_t fcs = 0xFF;
+  for (size_t i = 0; i < len; i++)
+  {
+    fcs ^= data[i];
+    for (int bit = 0; bit < 8; bit++)
+    {
+      fcs = (fcs & 0x01) ? (uint8_t) ((fcs >> 1) ^ 0xE0) : (uint8_t) (fcs >> 1);
+    }
+  }
+  return (uint8_t) (0xFF - fcs);
+}
+
+static bg95_cmux_channel_t* cmux_find_channel(bg95_cmux_t* cmux, uint8_t dlci)
+{
+  if (dlci == 0)
+  {
+    return &cmux->control;
+  }
+  if (dlci <= BG95_CMUX_MAX_CHANNELS)
+  {
+    return &cmux->channels[dlci - 1];
+  }
+  return NULL;
+}
+
+// Frames are always sent as the initiator, so the address C/R bit is set on commands
+static esp_err_t cmux_send_frame(
+    bg95_cmux_t* cmux, uint8_t dlci, uint8_t control, const uint8_t* data, size_t len)
+{
+  if (len > BG95_CMUX_MAX_FRAME_DATA)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  uint8_t frame[BG95_CMUX_MAX_FRAME_DATA + 6];
+  size_t  pos = 0;
+
+  frame[pos++] = CMUX_FLAG;
+  frame[pos++] = (uint8_t) ((dlci << 2) | CMUX_CR | CMUX_EA);
+  frame[pos++] = control;
+  frame[pos++] = (uint8_t) ((len << 1) | CMUX_EA);
+  if (len > 0)
+  {
+    memcpy(&frame[pos], data, len);
+    pos += len;
+  }
+  frame[pos++] = bg95_cmux_fcs(&frame[1], 3);
+  frame[pos++] = CMUX_FLAG;
+
+  xSemaphoreTake(cmux->tx_lock, portMAX_DELAY);
+  esp_err_t err = cmux->physical.write((const char*) frame, pos, cmux->physical.context);
+  if (err == ESP_OK)
+  {
+    cmux->stats.frames_tx++;
+  }
+  xSemaphoreGive(cmux->tx_lock);
+  return err;
+}
+
+static esp_err_t cmux_send_msc(bg95_cmux_t* cmux, uint8_t dlci, bool flow_stop)
+{
+  uint8_t msg[] = {CMUX_MSG_MSC | CMUX_CR,
+                   (2 << 1) | CMUX_EA,
+                   (uint8_t) ((dlci << 2) | CMUX_CR | CMUX_EA),
+                   (uint8_t) (CMUX_EA | CMUX_V24_RTC | CMUX_V24_RTR | CMUX_V24_DV |
+                              (flow_stop ? CMUX_V24_FC : 0))};
+  return cmux_send_frame(cmux, 0, CMUX_UIH, msg, sizeof(msg));
+}
+
+// Messages from the module on the control channel
+static void cmux_handle_control_message(bg95_cmux_t* cmux, const uint8_t* data, size_t len)
+{
+  if (len < 2)
+  {
+    return;
+  }
+
+  uint8_t type      = data[0];
+  size_t  value_len = data[1] >> 1;
+  if (value_len + 2 > len)
+  {
+    cmux->stats.invalid_frames++;
+    return;
+  }
+
+  if ((type & ~CMUX_CR) == CMUX_MSG_MSC && value_len >= 2)
+  {
+    // Responses to our own MSC need no action
+    if (!(type & CMUX_CR))
+    {
+      return;
+    }
+
+    bg95_cmux_channel_t* channel = cmux_find_channel(cmux, data[2] >> 2);
+    if (channel)
+    {
+      bool stop                    = (data[3] & CMUX_V24_FC) != 0;
+      channel->remote_flow_stopped = stop;
+      if (stop)
+      {
+        cmux->stats.flow_stops_received++;
+      }
+    }
+
+    // Acknowledge with the same content, as a response
+    uint8_t response[4] = {(uint8_t) (type & ~CMUX_CR), data[1], data[2], data[3]};
+    cmux_send_frame(cmux, 0, CMUX_UIH, response, sizeof(response));
+  }
+}
+
+static void cmux_handle_frame(bg95_cmux_t* cmux)
+{
+  bg95_cmux_rx_frame_t* frame   = &cmux->rx_frame;
+  uint8_t               dlci    = frame->address >> 2;
+  uint8_t               type    = frame->control & ~CMUX_PF;
+  bg95_cmux_channel_t*  channel = cmux_find_channel(cmux, dlci);
+
+  if (!channel)
+  {
+    cmux->stats.invalid_frames++;
+    return;
+  }
+  cmux->stats.frames_rx++;
+
+  switch (type)
+  {
+    case CMUX_UA:
+    case CMUX_DM:
+      cmux->last_response_control = type;
+      cmux->last_response_dlci    = dlci;
+      break;
+
+    case CMUX_DISC:
+      channel->open = false;
+      break;
+
+    case CMUX_UIH:
+      if (dlci == 0)
+      {
+        cmux_handle_control_message(cmux, frame->data, frame->length);
+        break;
+      }
+
+      size_t sent = xStreamBufferSend(channel->rx_buffer, frame->data, frame->length, 0);
+      if (sent < frame->length)
+      {
+        cmux->stats.rx_overflow_bytes += frame->length - sent;
+      }
+
+      // Ask the module to hold off before the buffer overflows
+      if (!channel->local_flow_stopped &&
+          xStreamBufferSpacesAvailable(channel->rx_buffer) < BG95_CMUX_RX_FLOW_STOP_SPACE)
+      {
+        channel->local_flow_stopped = true;
+        cmux->stats.flow_stops_sent++;
+        cmux_send_msc(cmux, dlci, true);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+static void cmux_frame_invalid(bg95_cmux_t* cmux)
+{
+  cmux->stats.invalid_frames++;
+  cmux->rx_frame.state = BG95_CMUX_RX_WAIT_FLAG;
+}
+
+static void cmux_frame_length_done(bg95_cmux_t* cmux)
+{
+  bg95_cmux_rx_frame_t* frame = &cmux->rx_frame;
+  if (frame->length > BG95_CMUX_MAX_FRAME_DATA)
+  {
+    cmux_frame_invalid(cmux);
+    return;
+  }
+  frame->received = 0;
+  frame->state    = frame->length > 0 ? BG95_CMUX_RX_DATA : BG95_CMUX_RX_FCS;
+}
+
+static void cmux_rx_byte(bg95_cmux_t* cmux, uint8_t byte)
+{
+  bg95_cmux_rx_frame_t* frame = &cmux->rx_frame;
+
+  switch (frame->state)
+  {
+    case BG95_CMUX_RX_WAIT_FLAG:
+      if (byte == CMUX_FLAG)
+      {
+        frame->state = BG95_CMUX_RX_ADDRESS;
+      }
+      break;
+
+    case BG95_CMUX_RX_ADDRESS:
+      if (byte == CMUX_FLAG)
+      {
+        break; // Consecutive flags (closing flag followed by an opening flag)
+      }
+      if (!(byte & CMUX_EA))
+      {
+        cmux_frame_invalid(cmux);
+        break;
+      }
+      frame->address    = byte;
+      frame->header[0]  = byte;
+      frame->header_len = 1;
+      frame->state      = BG95_CMUX_RX_CONTROL;
+      break;
+
+    case BG95_CMUX_RX_CONTROL:
+      frame->control                     = byte;
+      frame->header[frame->header_len++] = byte;
+      frame->state                       = BG95_CMUX_RX_LENGTH;
+      break;
+
+    case BG95_CMUX_RX_LENGTH:
+      frame->header[frame->header_len++] = byte;
+      frame->length                      = byte >> 1;
+      if (byte & CMUX_EA)
+      {
+        cmux_frame_length_done(cmux);
+      }
+      else
+      {
+        frame->state = BG95_CMUX_RX_LENGTH_2;
+      }
+      break;
+
+    case BG95_CMUX_RX_LENGTH_2:
+      frame->header[frame->header_len++] = byte;
+      frame->length |= (uint16_t) byte << 7;
+      cmux_frame_length_done(cmux);
+      break;
+
+    case BG95_CMUX_RX_DATA:
+      frame->data[frame->received++] = byte;
+      if (frame->received == frame->length)
+      {
+        frame->state = BG95_CMUX_RX_FCS;
+      }
+      break;
+
+    case BG95_CMUX_RX_FCS:
+      frame->fcs   = byte;
+      frame->state = BG95_CMUX_RX_END_FLAG;
+      break;
+
+    case BG95_CMUX_RX_END_FLAG:
+      if (byte != CMUX_FLAG)
+      {
+        cmux_frame_invalid(cmux);
+        break;
+      }
+
+      // UIH frames are only checked over the header, like every other frame type in basic mode
+      if (frame->fcs != bg95_cmux_fcs(frame->header, frame->header_len))
+      {
+        cmux->stats.fcs_errors++;
+      }
+      else
+      {
+        cmux_handle_frame(cmux);
+      }
+      frame->state = BG95_CMUX_RX_ADDRESS; // The closing flag can also open the next frame
+      break;
+  }
+}
+
+static void cmux_rx_task(void* arg)
+{
+  bg95_cmux_t* cmux = (bg95_cmux_t*) arg;
+  char         buffer[CMUX_RX_CHUNK_SIZE];
+
+  while (!cmux->stop_requested)
+  {
+    size_t bytes_read = 0;
+    if (cmux->physical.read(
+            buffer, sizeof(buffer), &bytes_read, CMUX_RX_POLL_MS, cmux->physical.context) != ESP_OK)
+    {
+      vTaskDelay(pdMS_TO_TICKS(CMUX_RX_POLL_MS));
+      continue;
+    }
+
+    for (size_t i = 0; i < bytes_read; i++)
+    {
+      cmux_rx_byte(cmux, (uint8_t) buffer[i]);
+    }
+  }
+
+  cmux->running = false;
+  vTaskDelete(NULL);
+}
+
+// Send SABM / DISC and wait for the module to answer UA (accepted) or DM (refused)
+static esp_err_t cmux_channel_request(bg95_cmux_t* cmux, uint8_t dlci, uint8_t frame_type)
+{
+  cmux->last_response_dlci = CMUX_NO_RESPONSE;
+
+  esp_err_t err = cmux_send_frame(cmux, dlci, frame_type | CMUX_PF, NULL, 0);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+  while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < BG95_CMUX_RESPONSE_TIMEOUT_MS)
+  {
+    if (cmux->last_response_dlci == dlci)
+    {
+      return cmux->last_response_control == CMUX_UA ? ESP_OK : ESP_FAIL;
+    }
+    vTaskDelay(pdMS_TO_TICKS(CMUX_RX_POLL_MS));
+  }
+
+  return ESP_ERR_TIMEOUT;
+}
+
+// ---------------------------- VIRTUAL UART ----------------------------------
+
+static esp_err_t cmux_channel_write(const char* data, size_t len, void* context)
+{
+  bg95_cmux_channel_t* channel = (bg95_cmux_channel_t*) context;
+  if (!channel || !data || len == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_cmux_t* cmux = channel->cmux;
+  if (!channel->open)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  size_t sent = 0;
+  while (sent < len)
+  {
+    // Hold off while the module has asked us to stop sending on this channel
+    uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+    while (channel->remote_flow_stopped)
+    {
+      if ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) >= BG95_CMUX_TX_FLOW_TIMEOUT_MS)
+      {
+        ESP_LOGE(TAG, "DLCI %d flow stopped for too long", channel->dlci);
+        return ESP_ERR_TIMEOUT;
+      }
+      vTaskDelay(pdMS_TO_TICKS(CMUX_RX_POLL_MS));
+    }
+
+    size_t chunk = len - sent;
+    if (chunk > cmux->frame_size)
+    {
+      chunk = cmux->frame_size;
+    }
+
+    esp_err_t err =
+        cmux_send_frame(cmux, channel->dlci, CMUX_UIH, (const uint8_t*) data + sent, chunk);
+    if (err != ESP_OK)
+    {
+      return err;
+    }
+    sent += chunk;
+  }
+
+  return ESP_OK;
+}
+
+// Frames of all channels share the physical UART - waits for the frames of the other channels too
+static esp_err_t cmux_channel_wait_tx_done(uint32_t timeout_ms, void* context)
+{
+  bg95_cmux_channel_t* channel = (bg95_cmux_channel_t*) context;
+  if (!channel)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_cmux_t* cmux = channel->cmux;
+  return cmux->physical.wait_tx_done(timeout_ms, cmux->physical.context);
+}
+
+static esp_err_t cmux_channel_read(
+    char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context)
+{
+  bg95_cmux_channel_t* channel = (bg95_cmux_channel_t*) context;
+  if (!channel || !buffer || !bytes_read || max_len < 2)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Same contract as the hardware UART - at most max_len - 1 bytes, NUL terminated
+  *bytes_read =
+      xStreamBufferReceive(channel->rx_buffer, buffer, max_len - 1, pdMS_TO_TICKS(timeout_ms));
+  buffer[*bytes_read] = '\0';
+
+  if (channel->local_flow_stopped &&
+      xStreamBufferSpacesAvailable(channel->rx_buffer) >= BG95_CMUX_CHANNEL_RX_BUFFER_SIZE / 2)
+  {
+    channel->local_flow_stopped = false;
+    cmux_send_msc(channel->cmux, channel->dlci, false);
+  }
+
+  return ESP_OK;
+}
+
+// ---------------------------- START / STOP ----------------------------------
+
+static void cmux_release(bg95_cmux_t* cmux)
+{
+  if (cmux->running)
+  {
+    cmux->stop_requested = true;
+    while (cmux->running)
+    {
+      vTaskDelay(pdMS_TO_TICKS(CMUX_RX_POLL_MS));
+    }
+  }
+
+  for (int i = 0; i < BG95_CMUX_MAX_CHANNELS; i++)
+  {
+    if (cmux->channels[i].rx_buffer)
+    {
+      vStreamBufferDelete(cmux->channels[i].rx_buffer);
+      cmux->channels[i].rx_buffer = NULL;
+    }
+    cmux->channels[i].open = false;
+  }
+  cmux->control.open = false;
+
+  if (cmux->tx_lock)
+  {
+    vSemaphoreDelete(cmux->tx_lock);
+    cmux->tx_lock = NULL;
+  }
+}
+
+esp_err_t bg95_cmux_start(bg95_cmux_t*                 cmux,
+                          const bg95_uart_interface_t* physical,
+                          uint16_t                     frame_size,
+                          uint8_t                      num_channels)
+{
+  if (!cmux || !physical || !physical->write || !physical->read || frame_size == 0 ||
+      frame_size > BG95_CMUX_MAX_FRAME_DATA || num_channels == 0 ||
+      num_channels > BG95_CMUX_MAX_CHANNELS)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(cmux, 0, sizeof(bg95_cmux_t));
+  cmux->physical   = *physical;
+  cmux->frame_size = frame_size;
+
+  cmux->tx_lock = xSemaphoreCreateMutex();
+  if (!cmux->tx_lock)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  cmux->control.cmux = cmux;
+  cmux->control.dlci = 0;
+  for (uint8_t i = 0; i < num_channels; i++)
+  {
+    bg95_cmux_channel_t* channel = &cmux->channels[i];
+    channel->cmux                = cmux;
+    channel->dlci                = i + 1;
+    channel->rx_buffer           = xStreamBufferCreate(BG95_CMUX_CHANNEL_RX_BUFFER_SIZE, 1);
+    if (!channel->rx_buffer)
+    {
+      cmux_release(cmux);
+      return ESP_ERR_NO_MEM;
+    }
+  }
+
+  cmux->running = true;
+  if (xTaskCreate(cmux_rx_task,
+                  "bg95_cmux_rx",
+                  BG95_CMUX_RX_TASK_STACK_SIZE,
+                  cmux,
+                  BG95_CMUX_RX_TASK_PRIORITY,
+                  &cmux->rx_task) != pdPASS)
+  {
+    cmux->running = false;
+    cmux_release(cmux);
+    return ESP_ERR_NO_MEM;
+  }
+
+  // The control channel has to be opened first
+  esp_err_t err = cmux_channel_request(cmux, 0, CMUX_SABM);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Control channel not accepted: %s", esp_err_to_name(err));
+    cmux_release(cmux);
+    return err;
+  }
+  cmux->control.open = true;
+
+  for (uint8_t i = 0; i < num_channels; i++)
+  {
+    bg95_cmux_channel_t* channel = &cmux->channels[i];
+
+    err = cmux_channel_request(cmux, channel->dlci, CMUX_SABM);
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "DLCI %d not accepted: %s", channel->dlci, esp_err_to_name(err));
+      bg95_cmux_stop(cmux);
+      return err;
+    }
+    channel->open = true;
+
+    // Signal that we are ready to receive on the channel
+    cmux_send_msc(cmux, channel->dlci, false);
+  }
+
+  ESP_LOGI(TAG, "Multiplexer started with %d channels (N1 %d)", num_channels, frame_size);
+  return ESP_OK;
+}
+
+esp_err_t bg95_cmux_stop(bg95_cmux_t* cmux)
+{
+  if (!cmux || !cmux->running)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  for (int i = 0; i < BG95_CMUX_MAX_CHANNELS; i++)
+  {
+    bg95_cmux_channel_t* channel = &cmux->channels[i];
+    if (channel->open)
+    {
+      channel->open = false;
+      if (cmux_channel_request(cmux, channel->dlci, CMUX_DISC) != ESP_OK)
+      {
+        ESP_LOGW(TAG, "DLCI %d did not confirm the disconnect", channel->dlci);
+      }
+    }
+  }
+
+  // Close down - the module returns to plain AT command mode on the UART
+  if (cmux->control.open)
+  {
+    uint8_t msg[] = {CMUX_MSG_CLD | CMUX_CR, CMUX_EA};
+    cmux_send_frame(cmux, 0, CMUX_UIH, msg, sizeof(msg));
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+
+  cmux_release(cmux);
+  ESP_LOGI(TAG,
+           "Multiplexer stopped (%lu frames rx, %lu frames tx, %lu FCS errors)",
+           (unsigned long) cmux->stats.frames_rx,
+           (unsigned long) cmux->stats.frames_tx,
+           (unsigned long) cmux->stats.fcs_errors);
+  return ESP_OK;
+}
+
+esp_err_t bg95_cmux_get_channel(bg95_cmux_t* cmux, uint8_t dlci, bg95_uart_interface_t* channel)
+{
+  if (!cmux || !channel || dlci == 0 || dlci > BG95_CMUX_MAX_CHANNELS)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (!cmux->channels[dlci - 1].open)
+  {
+    ESP_LOGE(TAG, "DLCI %d is not open", dlci);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  memset(channel, 0, sizeof(bg95_uart_interface_t));
+  channel->write        = cmux_channel_write;
+  channel->read         = cmux_channel_read;
+  channel->wait_tx_done = cmux->physical.wait_tx_done ? cmux_channel_wait_tx_done : NULL;
+  channel->context      = &cmux->channels[dlci - 1];
+  channel->uart_num     = cmux->physical.uart_num;
+  return ESP_OK;
+}
+
+esp_err_t bg95_cmux_get_stats(bg95_cmux_t* cmux, bg95_cmux_stats_t* stats)
+{
+  if (!cmux || !stats)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *stats = cmux->stats;
+  return ESP_OK;
+}
@@ -1,19 +1,47 @@
 #include "bg95_driver.h"
 
 #include "at_cmd_at.h"
+#include "at_cmd_cedrxrdp.h"
+#include "at_cmd_cereg.h"
 #include "at_cmd_cfun.h"
 #include "at_cmd_cgact.h"
 #include "at_cmd_cgdcont.h"
 #include "at_cmd_cgpaddr.h"
+#include "at_cmd_cmux.h"
 #include "at_cmd_cops.h"
 #include "at_cmd_csq.h"
-#include "at_cmd_gmr.h"
 #include "at_cmd_handler.h"
+#include "at_cmd_ifc.h"
+#include "at_cmd_ipr.h"
 #include "at_cmd_qcsq.h"
+#include "at_cmd_qfclose.h"
+#include "at_cmd_qfdwl.h"
+#include "at_cmd_qfopen.h"
+#include "at_cmd_qfread.h"
+#include "at_cmd_qfseek.h"
+#include "at_cmd_qfwrite.h"
+#include "at_cmd_qgps.h"
+#include "at_cmd_qgpscfg.h"
+#include "at_cmd_qgpsend.h"
+#include "at_cmd_qgpsgnmea.h"
+#include "at_cmd_qgpsloc.h"
+#include "at_cmd_qhttpcfg.h"
+#include "at_cmd_qhttpget.h"
+#include "at_cmd_qhttpgetex.h"
+#include "at_cmd_qhttppost.h"
+#include "at_cmd_qhttpread.h"
+#include "at_cmd_qhttpurl.h"
+#include "at_cmd_qiclose.h"
+#include "at_cmd_qird.h"
+#include "at_cmd_qisend.h"
 #include "at_cmd_qmtclose.h"
 #include "at_cmd_qmtconn.h"
 #include "at_cmd_qmtopen.h"
+#include "at_cmd_qsclk.h"
+#include "at_cmd_qsslcfg.h"
 #include "at_cmd_structure.h"
+#include "at_cmd_tokenizer.h"
+#include "bg95_persist.h"
 #include "freertos/projdefs.h"
 #include "hal/gpio_types.h"
 
@@ -21,13 +49,37 @@
 #include <esp_err.h>
 #include <esp_log.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h> // for memset
 
 static const char* TAG = "BG95_DRIVER";
 
+static void bg95_urc_handler(const char* line, size_t len, void* context);
+
 esp_err_t bg95_init(bg95_handle_t* handle, bg95_uart_interface_t* uart, uint8_t pwrkey_gpio_num)
 {
-  if (!handle || !uart)
+  bg95_config_t config = {.pwrkey_gpio_num = pwrkey_gpio_num,
+                          .status_gpio_num = BG95_GPIO_NOT_USED,
+                          .dtr_gpio_num    = BG95_GPIO_NOT_USED};
+
+  return bg95_init_with_config(handle, uart, &config);
+}
+
+// Returns true if a STATUS pin is configured and it reads LOW (module is powered off)
+static bool bg95_status_pin_reports_off(bg95_handle_t* handle)
+{
+  if (handle->status_gpio_num == BG95_GPIO_NOT_USED)
+  {
+    return false;
+  }
+  return gpio_get_level((gpio_num_t) handle->status_gpio_num) == 0;
+}
+
+esp_err_t bg95_init_with_config(bg95_handle_t*         handle,
+                                bg95_uart_interface_t* uart,
+                                const bg95_config_t*   config)
+{
+  if (!handle || !uart || !config)
   {
     return ESP_ERR_INVALID_ARG;
   }
@@ -42,17 +94,22 @@ esp_err_t bg95_init(bg95_handle_t* handle, bg95_uart_interface_t* uart, uint8_t
     ESP_LOGE(TAG, "ERROR: AT CMD handler init has FAILED: %s", esp_err_to_name(err));
     return err;
   }
-
-  vTaskDelay(pdMS_TO_TICKS(1000));
+  at_cmd_handler_set_urc_handler(&handle->at_handler, bg95_urc_handler, handle);
+  bg95_nmea_parser_init(&handle->gnss.parser);
+  bg95_gnss_fix_store_init(&handle->gnss.latest_fix);
+  handle->uart_link.version   = BG95_UART_LINK_VERSION;
+  handle->uart_link.baud_rate = uart->baud_rate ? uart->baud_rate : BG95_BAUD_RATE;
 
   // Configure PWRKEY GPIO as an output and disable pulldown and pullup
-  handle->pwrkey_gpio_num = pwrkey_gpio_num;
+  handle->pwrkey_gpio_num = config->pwrkey_gpio_num;
+  handle->status_gpio_num = config->status_gpio_num;
+  handle->dtr_gpio_num    = config->dtr_gpio_num;
 
   gpio_config_t io_conf = {};
   io_conf.intr_type     = GPIO_INTR_DISABLE;
   io_conf.mode          = GPIO_MODE_OUTPUT;
   // Bitwise operations to toggle the nth bit, here pwrkey_gpio_num is n
-  io_conf.pin_bit_mask = (1ULL << pwrkey_gpio_num);
+  io_conf.pin_bit_mask = (1ULL << config->pwrkey_gpio_num);
   io_conf.pull_down_en = 0;
   io_conf.pull_up_en   = 0;
   err                  = gpio_config(&io_conf);
@@ -62,26 +119,54 @@ esp_err_t bg95_init(bg95_handle_t* handle, bg95_uart_interface_t* uart, uint8_t
     return err;
   }
 
-  // First test if module is responsive
-  bool is_responsive = bg95_test_module_is_responsive(handle);
+  // STATUS GPIO is optional - it is an input driven by the module
+  if (config->status_gpio_num != BG95_GPIO_NOT_USED)
+  {
+    io_conf.mode         = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL << config->status_gpio_num);
+    err                  = gpio_config(&io_conf);
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "ERROR: STATUS GPIO config has FAILED: %s", esp_err_to_name(err));
+      return err;
+    }
+  }
 
-  if (!is_responsive)
+  // DTR GPIO is optional - held LOW (module awake) until sleep is enabled with bg95_sleep_enable
+  if (config->dtr_gpio_num != BG95_GPIO_NOT_USED)
   {
-    ESP_LOGI(TAG, "BG95 module not responsive - attempting power on");
-    err = bg95_pulse_pwrkey_pin(handle);
+    io_conf.mode         = GPIO_MODE_OUTPUT;
+    io_conf.pin_bit_mask = (1ULL << config->dtr_gpio_num);
+    err                  = gpio_config(&io_conf);
     if (err != ESP_OK)
     {
-      ESP_LOGE(TAG, "ERROR: BG95 Module power ON has FAILED: %s", esp_err_to_name(err));
+      ESP_LOGE(TAG, "ERROR: DTR GPIO config has FAILED: %s", esp_err_to_name(err));
       return err;
     }
+    gpio_set_level((gpio_num_t) config->dtr_gpio_num, 0);
+  }
 
-    // Wait for device to power on after the PWRKEY pulse
-    vTaskDelay(pdMS_TO_TICKS(15000));
+  // First test if module is responsive - skip the AT probe if STATUS already says it is off
+  bool module_is_off = bg95_status_pin_reports_off(handle);
+  bool is_responsive = !module_is_off && bg95_test_module_is_responsive(handle);
 
-    // Now try again to check device responsiveness
-    is_responsive = bg95_test_module_is_responsive(handle);
+  if (!is_responsive)
+  {
+    // If STATUS says the module is on, it may still be booting - a PWRKEY pulse would turn it OFF
+    if (module_is_off || handle->status_gpio_num == BG95_GPIO_NOT_USED)
+    {
+      ESP_LOGI(TAG, "BG95 module not responsive - attempting power on");
+      err = bg95_pulse_pwrkey_pin(handle);
+      if (err != ESP_OK)
+      {
+        ESP_LOGE(TAG, "ERROR: BG95 Module power ON has FAILED: %s", esp_err_to_name(err));
+        return err;
+      }
+    }
 
-    if (!is_responsive)
+    // Wait (at most BG95_BOOT_TIMEOUT_MS) for the device to finish booting
+    err = bg95_wait_for_boot(handle, BG95_BOOT_TIMEOUT_MS);
+    if (err != ESP_OK)
     {
       ESP_LOGE(TAG, "ERROR: BG95 Module not responsive after pwrkey pulse");
       return ESP_ERR_TIMEOUT; // Return an appropriate error code
@@ -94,6 +179,79 @@ esp_err_t bg95_init(bg95_handle_t* handle, bg95_uart_interface_t* uart, uint8_t
   return ESP_OK;
 }
 
+esp_err_t bg95_wait_for_boot(bg95_handle_t* handle, uint32_t timeout_ms)
+{
+  if (NULL == handle)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  at_cmd_handler_t* handler        = &handle->at_handler;
+  uint32_t          start_time     = pdTICKS_TO_MS(xTaskGetTickCount());
+  uint32_t          probe_interval = BG95_BOOT_PROBE_INTERVAL_MIN_MS;
+  uint32_t          next_probe     = start_time + probe_interval;
+  bool              ready_urc_seen = false;
+
+  // Sliding window over the RX stream, large enough to catch a URC split across two reads
+  char   urc_window[2 * AT_CMD_READ_CHUNK_SIZE] = {0};
+  size_t window_len                             = 0;
+
+  while ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) < timeout_ms)
+  {
+    char      chunk[AT_CMD_READ_CHUNK_SIZE];
+    size_t    bytes_read = 0;
+    esp_err_t err =
+        handler->uart.read(chunk, sizeof(chunk) - 1, &bytes_read, 20, handler->uart.context);
+
+    if (err == ESP_OK && bytes_read > 0)
+    {
+      // Keep only the tail of the previous window so a split URC can still be matched
+      if (window_len + bytes_read >= sizeof(urc_window))
+      {
+        size_t keep = sizeof(BG95_BOOT_URC_APP_READY) - 1;
+        memmove(urc_window, urc_window + window_len - keep, keep);
+        window_len = keep;
+      }
+      memcpy(urc_window + window_len, chunk, bytes_read);
+      window_len += bytes_read;
+      urc_window[window_len] = '\0';
+
+      if (strstr(urc_window, BG95_BOOT_URC_APP_READY) != NULL)
+      {
+        ESP_LOGI(TAG,
+                 "Boot URC received after %lu ms",
+                 (unsigned long) (pdTICKS_TO_MS(xTaskGetTickCount()) - start_time));
+        ready_urc_seen = true;
+        window_len     = 0;
+      }
+    }
+
+    uint32_t now       = pdTICKS_TO_MS(xTaskGetTickCount());
+    bool     probe_due = ready_urc_seen || (int32_t) (now - next_probe) >= 0;
+
+    // No point in probing while the STATUS pin still reports the module as off
+    if (probe_due && !bg95_status_pin_reports_off(handle))
+    {
+      if (bg95_test_module_is_responsive(handle))
+      {
+        ESP_LOGI(TAG,
+                 "BG95 responsive after %lu ms",
+                 (unsigned long) (pdTICKS_TO_MS(xTaskGetTickCount()) - start_time));
+        return ESP_OK;
+      }
+
+      ready_urc_seen = false;
+      probe_interval = (probe_interval * 2 > BG95_BOOT_PROBE_INTERVAL_MAX_MS)
+                           ? BG95_BOOT_PROBE_INTERVAL_MAX_MS
+                           : probe_interval * 2;
+      next_probe     = pdTICKS_TO_MS(xTaskGetTickCount()) + probe_interval;
+    }
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+
+  return ESP_ERR_TIMEOUT;
+}
+
 esp_err_t bg95_deinit(bg95_handle_t* handle)
 {
   if (NULL == handle)
@@ -101,6 +259,25 @@ esp_err_t bg95_deinit(bg95_handle_t* handle)
     ESP_LOGE(TAG, "Driver handle deinit failed");
     return ESP_ERR_INVALID_ARG;
   }
+  // The scan task uses the handle - wait for it to stop before freeing
+  if (atomic_load(&handle->operator_scan.in_progress))
+  {
+    atomic_store(&handle->operator_scan.cancel_requested, true);
+    while (atomic_load(&handle->operator_scan.in_progress))
+    {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+  }
+  // Same for the flush task
+  bg95_psm_stop_auto_flush(handle);
+
+  if (handle->cmux)
+  {
+    bg95_cmux_disable(handle);
+  }
+
+  at_cmd_handler_deinit(&handle->at_handler);
+
   // free pointer for bg95  handle
   free(handle);
   return ESP_OK;
@@ -197,8 +374,17 @@ esp_err_t bg95_get_sim_card_status(bg95_handle_t* handle, cpin_status_t* cpin_st
     return ESP_ERR_INVALID_ARG;
   }
 
-  return at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_CPIN, AT_CMD_TYPE_READ, NULL, cpin_status);
+  cpin_read_response_t cpin_response = {0};
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CPIN, AT_CMD_TYPE_READ, NULL, &cpin_response);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  *cpin_status = cpin_response.status;
+  return ESP_OK;
 }
 
 esp_err_t bg95_get_signal_quality_dbm(bg95_handle_t* handle, int16_t* rssi_dbm)
@@ -242,7 +428,7 @@ esp_err_t bg95_get_signal_quality_dbm(bg95_handle_t* handle, int16_t* rssi_dbm)
   //          csq_response.ber,
   //          enum_to_str(csq_response.ber, CSQ_BER_MAP, CSQ_BER_MAP_SIZE));
 
-  ESP_LOGI("BG95_SIGNAL", "Signal Quality: RSSI=%d (%d dBm)", csq_response.rssi, *rssi_dbm);
+  ESP_LOGD("BG95_SIGNAL", "Signal Quality: RSSI=%d (%d dBm)", csq_response.rssi, *rssi_dbm);
 
   // Check if the signal quality is known
   if (csq_response.rssi == CSQ_RSSI_UNKNOWN)
@@ -334,1900 +520,5098 @@ esp_err_t bg95_get_current_operator(bg95_handle_t* handle, cops_operator_data_t*
   return ESP_OK;
 }
 
-esp_err_t bg95_define_pdp_context(bg95_handle_t*     handle,
-                                  uint8_t            cid,
-                                  cgdcont_pdp_type_t pdp_type,
-                                  const char*        apn)
+// Decode the operator entries that have fully arrived since the last call, and pass them on
+static bool bg95_operator_scan_observer(const char* response, size_t len, void* context)
 {
-  if (handle == NULL || apn == NULL || !handle->initialized)
-  {
-    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
-    return ESP_ERR_INVALID_ARG;
-  }
+  bg95_operator_scan_t* scan = (bg95_operator_scan_t*) context;
 
-  /* Validate CID range (1-15 as per specification) */
-  if (cid < 1 || cid > 15)
+  const char* data = strstr(response, "+COPS: ");
+  if (data)
   {
-    ESP_LOGE(TAG, "Invalid CID: %d (must be 1-15)", cid);
-    return ESP_ERR_INVALID_ARG;
-  }
+    const char* pos = response + scan->stream_offset;
+    if (pos < data)
+    {
+      pos = data;
+    }
 
-  /* Create write parameters with required fields */
-  cgdcont_write_params_t write_params;
-  memset(&write_params, 0, sizeof(cgdcont_write_params_t));
+    while ((pos = strchr(pos, '(')) != NULL)
+    {
+      cops_operator_info_t op        = {0};
+      const char*          entry_end = NULL;
+      esp_err_t            err       = cops_parse_operator_entry(pos, &op, &entry_end);
 
-  /* Set the fields and present flags */
-  write_params.cid      = cid;
-  write_params.pdp_type = pdp_type;
-  strncpy(write_params.apn, apn, sizeof(write_params.apn) - 1);
-  write_params.apn[sizeof(write_params.apn) - 1] = '\0';
+      if (err == ESP_ERR_NOT_FOUND)
+      {
+        break; // Rest of the entry has not arrived yet
+      }
 
-  /* Set present flags */
-  write_params.present.has_cid      = true;
-  write_params.present.has_pdp_type = true;
-  write_params.present.has_apn      = true;
+      if (err == ESP_OK && scan->on_found)
+      {
+        scan->on_found(&op, scan->user_context);
+      }
 
-  /* Send the command */
-  ESP_LOGI(
-      TAG, "Defining PDP context: CID=%d, PDP_TYPE=%d, APN=%s", cid, pdp_type, write_params.apn);
+      pos                 = entry_end ? entry_end : pos + 1;
+      scan->stream_offset = (size_t) (pos - response);
+    }
+  }
 
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_CGDCONT, AT_CMD_TYPE_WRITE, &write_params, NULL);
+  (void) len;
+  return !atomic_load(&scan->cancel_requested);
+}
+
+// Check and set in one step - two tasks starting a scan at once cannot both get it
+static bool bg95_operator_scan_claim(bg95_operator_scan_t* scan)
+{
+  bool idle = false;
+  if (!atomic_compare_exchange_strong(&scan->in_progress, &idle, true))
+  {
+    return false;
+  }
+  atomic_store(&scan->cancel_requested, false);
+  return true;
+}
 
+static esp_err_t bg95_run_operator_scan(bg95_handle_t* handle, cops_test_response_t* operators)
+{
+  bg95_operator_scan_t* scan = &handle->operator_scan;
+  scan->stream_offset        = 0;
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd_observed(&handle->at_handler,
+                                                               &AT_CMD_COPS,
+                                                               AT_CMD_TYPE_TEST,
+                                                               NULL,
+                                                               operators,
+                                                               bg95_operator_scan_observer,
+                                                               scan);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to define PDP context: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Operator scan failed: %s", esp_err_to_name(err));
     return err;
   }
 
-  ESP_LOGI(TAG, "Successfully defined PDP context (CID=%d, APN=%s)", cid, apn);
+  scan->cache              = *operators;
+  scan->cache_timestamp_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+  scan->cache_valid        = true;
+
+  ESP_LOGI(TAG, "Operator scan found %d operators", operators->num_operators);
   return ESP_OK;
 }
 
-esp_err_t bg95_activate_pdp_context(bg95_handle_t* handle, const int cid)
+static void bg95_operator_scan_task(void* arg)
 {
+  bg95_handle_t*        handle = (bg95_handle_t*) arg;
+  bg95_operator_scan_t* scan   = &handle->operator_scan;
 
-  if (handle == NULL || !handle->initialized)
+  esp_err_t err = bg95_run_operator_scan(handle, &scan->result);
+
+  if (scan->on_done)
+  {
+    scan->on_done(err, (err == ESP_OK) ? &scan->cache : NULL, scan->user_context);
+  }
+
+  scan->task = NULL;
+  atomic_store(&scan->in_progress, false);
+  vTaskDelete(NULL);
+}
+
+esp_err_t bg95_get_available_operators(bg95_handle_t* handle, cops_test_response_t* operators)
+{
+  if (!handle || !operators || !handle->initialized)
   {
     ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  cgact_write_params_t write_params;
-  memset(&write_params, 0, sizeof(cgact_write_params_t));
+  bg95_operator_scan_t* scan = &handle->operator_scan;
+  if (!bg95_operator_scan_claim(scan))
+  {
+    ESP_LOGE(TAG, "Operator scan already in progress");
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  write_params.cid   = cid;
-  write_params.state = CGACT_STATE_ACTIVATED;
+  scan->on_found = NULL;
+  scan->on_done  = NULL;
 
-  return at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_CGACT, AT_CMD_TYPE_WRITE, &write_params, NULL);
+  esp_err_t err = bg95_run_operator_scan(handle, operators);
+
+  atomic_store(&scan->in_progress, false);
+  return err;
 }
 
-esp_err_t bg95_is_pdp_context_active(bg95_handle_t* handle, uint8_t cid, bool* is_active)
+esp_err_t bg95_start_operator_scan(bg95_handle_t*             handle,
+                                   bg95_operator_found_cb     on_found,
+                                   bg95_operator_scan_done_cb on_done,
+                                   void*                      context)
 {
-  if (NULL == handle || NULL == is_active)
+  if (!handle || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Invalid arguments");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Initialize output
-  *is_active = false;
+  bg95_operator_scan_t* scan = &handle->operator_scan;
+  if (!bg95_operator_scan_claim(scan))
+  {
+    ESP_LOGE(TAG, "Operator scan already in progress");
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  // Create response structure
-  cgact_read_response_t response = {0};
+  scan->on_found     = on_found;
+  scan->on_done      = on_done;
+  scan->user_context = context;
 
-  // Send CGACT read command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_CGACT, AT_CMD_TYPE_READ, NULL, &response);
+  if (xTaskCreate(bg95_operator_scan_task,
+                  "bg95_cops_scan",
+                  BG95_OPERATOR_SCAN_TASK_STACK_SIZE,
+                  handle,
+                  BG95_OPERATOR_SCAN_TASK_PRIORITY,
+                  &scan->task) != pdPASS)
+  {
+    ESP_LOGE(TAG, "Failed to create operator scan task");
+    atomic_store(&scan->in_progress, false);
+    return ESP_ERR_NO_MEM;
+  }
 
-  if (err != ESP_OK)
+  return ESP_OK;
+}
+
+esp_err_t bg95_cancel_operator_scan(bg95_handle_t* handle)
+{
+  if (!handle)
   {
-    ESP_LOGE(TAG, "Failed to get PDP context activation status: %s", esp_err_to_name(err));
-    return err;
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // Search for the specified CID
-  for (int i = 0; i < response.num_contexts; i++)
+  if (!atomic_load(&handle->operator_scan.in_progress))
   {
-    if (response.contexts[i].cid == cid)
-    {
-      *is_active = (response.contexts[i].state == CGACT_STATE_ACTIVATED);
-      ESP_LOGI(TAG, "PDP context %d is %s", cid, *is_active ? "active" : "inactive");
-      return ESP_OK;
-    }
+    return ESP_ERR_INVALID_STATE;
   }
 
-  // CID not found in response
-  ESP_LOGW(TAG, "PDP context %d not found in CGACT response", cid);
-  return ESP_ERR_NOT_FOUND;
+  atomic_store(&handle->operator_scan.cancel_requested, true);
+  return ESP_OK;
+}
+
+bool bg95_operator_scan_in_progress(bg95_handle_t* handle)
+{
+  return handle && atomic_load(&handle->operator_scan.in_progress);
 }
 
 esp_err_t
-bg95_get_pdp_address_for_cid(bg95_handle_t* handle, uint8_t cid, char* address, size_t address_size)
+bg95_get_cached_operators(bg95_handle_t* handle, cops_test_response_t* operators, uint32_t* age_ms)
 {
-  if (NULL == handle || NULL == address || address_size == 0)
+  if (!handle || !operators)
   {
-    ESP_LOGE(TAG, "Invalid arguments");
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Validate CID range
-  if (cid < CGPADDR_CID_RANGE_MIN_VALUE || cid > CGPADDR_CID_RANGE_MAX_VALUE)
+  bg95_operator_scan_t* scan = &handle->operator_scan;
+  if (!scan->cache_valid)
   {
-    ESP_LOGE(TAG, "Invalid CID: %d (must be 1-15)", cid);
-    return ESP_ERR_INVALID_ARG;
+    return ESP_ERR_NOT_FOUND;
   }
 
-  // Initialize output
-  address[0] = '\0';
+  *operators = scan->cache;
+  if (age_ms)
+  {
+    *age_ms = pdTICKS_TO_MS(xTaskGetTickCount()) - scan->cache_timestamp_ms;
+  }
 
-  // Create command parameters
-  cgpaddr_write_params_t params = {.cid = cid};
+  return ESP_OK;
+}
 
-  // Create response structure
-  cgpaddr_write_response_t response = {0};
+// Factory default band masks of the BG95-M2 (AT+QCFG="band" defaults)
+static const qcfg_band_config_t BG95_DEFAULT_BANDS = {
+    .gsm   = QCFG_GSM_BAND_ANY,
+    .emtc  = {.low = 0x000000000F0E189FULL, .high = 0x100002ULL},
+    .nbiot = {.low = 0x00000000090E189FULL, .high = 0x100042ULL}};
 
-  // Send CGPADDR write command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_CGPADDR, AT_CMD_TYPE_WRITE, &params, &response);
+static esp_err_t bg95_qcfg_write(bg95_handle_t*             handle,
+                                 const qcfg_write_params_t* params,
+                                 qcfg_write_response_t*     response)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
 
+  qcfg_write_response_t local_response = {0};
+  esp_err_t             err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      params,
+                                                      response ? response : &local_response);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to get PDP address for CID %d: %s", cid, esp_err_to_name(err));
+    ESP_LOGE(TAG,
+             "QCFG \"%s\" failed: %s",
+             enum_to_str(params->type, QCFG_TYPE_MAP, QCFG_TYPE_MAP_SIZE),
+             esp_err_to_name(err));
     return err;
   }
 
-  // Verify that the CID in response matches requested CID
-  if (response.cid != cid)
+  // A query must return the requested setting
+  if (response && (!response->has_data || response->type != params->type))
   {
-    ESP_LOGE(TAG, "Response CID (%d) doesn't match requested CID (%d)", response.cid, cid);
+    ESP_LOGE(TAG, "QCFG query returned no data");
     return ESP_ERR_INVALID_RESPONSE;
   }
 
-  // Check if an address was returned
-  if (response.address[0] == '\0')
-  {
-    ESP_LOGW(TAG, "No PDP address available for CID %d", cid);
-    return ESP_ERR_NOT_FOUND;
-  }
+  return ESP_OK;
+}
 
-  // Copy address to output buffer
-  if (strlen(response.address) >= address_size)
+esp_err_t bg95_set_scan_sequence(bg95_handle_t*    handle,
+                                 const qcfg_rat_t* rats,
+                                 uint8_t           num_rats,
+                                 qcfg_effect_t     effect)
+{
+  if (!rats || num_rats == 0 || num_rats > QCFG_NWSCANSEQ_MAX_RATS)
   {
-    ESP_LOGW(TAG, "Address buffer too small, truncating result");
+    ESP_LOGE(TAG, "Invalid scan sequence");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  strncpy(address, response.address, address_size - 1);
-  address[address_size - 1] = '\0'; // Ensure null termination
+  qcfg_write_params_t params = {.type = QCFG_TYPE_NWSCANSEQ};
+  memcpy(params.params.nwscanseq.rats, rats, num_rats * sizeof(qcfg_rat_t));
+  params.params.nwscanseq.num_rats           = num_rats;
+  params.params.nwscanseq.effect             = effect;
+  params.params.nwscanseq.present.has_rats   = true;
+  params.params.nwscanseq.present.has_effect = true;
 
-  ESP_LOGI(TAG, "PDP address for CID %d: %s", cid, address);
-  return ESP_OK;
+  return bg95_qcfg_write(handle, &params, NULL);
 }
 
-esp_err_t bg95_connect_to_network(bg95_handle_t* handle)
+esp_err_t bg95_get_scan_sequence(bg95_handle_t* handle, qcfg_nwscanseq_response_t* sequence)
 {
-  esp_err_t err;
-  // Check SIM card status (AT+CPIN)
-  // -----------------------------------------------------------
-  cpin_status_t sim_card_status;
-  err = bg95_get_sim_card_status(handle, &sim_card_status);
-  if (err != ESP_OK)
+  if (!sequence)
   {
-    ESP_LOGE(TAG, "Failed to get PIN status: %s", esp_err_to_name(err));
-    return err;
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // TODO:  REPLACE THIS WITH QCSQ - extended signal quality check (regular CSQ is for 2G)
-  //  Check signal quality (AT+CSQ)
-  //  -----------------------------------------------------------
-  // int16_t rssi_dbm;
-  // err = bg95_get_signal_quality_dbm(handle, &rssi_dbm);
-  // if (err != ESP_OK)
-  // {
-  //   ESP_LOGE(TAG, "Failed to check signal quality: %s", esp_err_to_name(err));
-  //   return err;
-  // }
+  qcfg_write_params_t   params   = {.type = QCFG_TYPE_NWSCANSEQ};
+  qcfg_write_response_t response = {0};
 
-  qcsq_execute_response_t qcsq_execute_response = {0};
-  err = bg95_get_extended_signal_quality(handle, &qcsq_execute_response);
-  if (err != ESP_OK)
+  esp_err_t err = bg95_qcfg_write(handle, &params, &response);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to check signal quality: %s", esp_err_to_name(err));
-    return err;
+    *sequence = response.response.nwscanseq;
   }
+  return err;
+}
 
-  // Check available operators list (AT+COPS)
-  // -----------------------------------------------------------
-  cops_operator_data_t operator_data;
-  err = bg95_get_current_operator(handle, &operator_data);
-  if (err != ESP_OK)
-  {
-    ESP_LOGE(TAG, "Failed to get current operator: %s", esp_err_to_name(err));
-    return err;
-  }
+esp_err_t bg95_set_scan_mode(bg95_handle_t* handle, qcfg_nwscanmode_t mode, qcfg_effect_t effect)
+{
+  qcfg_write_params_t params = {
+      .type              = QCFG_TYPE_NWSCANMODE,
+      .params.nwscanmode = {
+          .mode = mode, .effect = effect, .present = {.has_mode = true, .has_effect = true}}};
 
-  // Define PDP context with your carriers APN (AT+CGDCONT)
-  // -----------------------------------------------------------
-  int                cid      = 1;
-  cgdcont_pdp_type_t pdp_type = CGDCONT_PDP_TYPE_IPV4V6;
-  const char*        apn      = "simbase"; // Use 'simbase' as the APN
-  err                         = bg95_define_pdp_context(handle, cid, pdp_type, apn);
-  if (err != ESP_OK)
-  {
-    ESP_LOGE(
-        TAG, "Failed to define PDP context (set cid, pdp type, apn): %s", esp_err_to_name(err));
-    return err;
-  }
+  return bg95_qcfg_write(handle, &params, NULL);
+}
 
-  // Soft restart needed for setting to take place (AT+CFUN=0, AT+CFUN=1)
-  // -----------------------------------------------------------
-  err = bg95_soft_restart(handle);
-  if (err != ESP_OK)
+esp_err_t bg95_get_scan_mode(bg95_handle_t* handle, qcfg_nwscanmode_t* mode)
+{
+  if (!mode)
   {
-    ESP_LOGE(TAG, "Failed to soft restart BG95 %s", esp_err_to_name(err));
-    return err;
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // Activate PDP context (AT+CGACT)
-  // -----------------------------------------------------------
-  err = bg95_activate_pdp_context(handle, cid);
-  if (err != ESP_OK)
-  {
-    ESP_LOGE(
-        TAG, "Failed to activate PDP context for cid: %d, error: %s", cid, esp_err_to_name(err));
-    return err;
-  }
+  qcfg_write_params_t   params   = {.type = QCFG_TYPE_NWSCANMODE};
+  qcfg_write_response_t response = {0};
 
-  // Verify IP address assignment (AT+CGPADDR)
-  // -----------------------------------------------------------
-  char ip_address[CGPADDR_ADDRESS_MAX_CHARS];
-  err = bg95_get_pdp_address_for_cid(handle, cid, ip_address, sizeof(ip_address));
-  if (err != ESP_OK)
+  esp_err_t err = bg95_qcfg_write(handle, &params, &response);
+  if (err == ESP_OK)
   {
-
-    ESP_LOGI(TAG, "Failed to get PDP context address: %s", esp_err_to_name(err));
-    return err;
+    *mode = response.response.nwscanmode;
   }
+  return err;
+}
 
-  ESP_LOGI(TAG, "Successfully connected to network");
-  return ESP_OK;
+esp_err_t bg95_set_iot_op_mode(bg95_handle_t* handle, qcfg_iotopmode_t mode, qcfg_effect_t effect)
+{
+  qcfg_write_params_t params = {
+      .type             = QCFG_TYPE_IOTOPMODE,
+      .params.iotopmode = {
+          .mode = mode, .effect = effect, .present = {.has_mode = true, .has_effect = true}}};
+
+  return bg95_qcfg_write(handle, &params, NULL);
 }
 
-//////////////////////  MQTT  STUFF   /////////////////////////
-// -----------------------------------------------------------
-esp_err_t bg95_get_mqtt_config_params(bg95_handle_t* handle, qmtcfg_test_response_t* config_params)
+esp_err_t bg95_get_iot_op_mode(bg95_handle_t* handle, qcfg_iotopmode_t* mode)
 {
-  if (NULL == handle || NULL == config_params || !handle->initialized)
+  if (!mode)
   {
-    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  // TODO: Implement this - it should call query for each  of the config params one by one
+  qcfg_write_params_t   params   = {.type = QCFG_TYPE_IOTOPMODE};
+  qcfg_write_response_t response = {0};
 
-  return ESP_OK;
+  esp_err_t err = bg95_qcfg_write(handle, &params, &response);
+  if (err == ESP_OK)
+  {
+    *mode = response.response.iotopmode;
+  }
+  return err;
 }
 
 esp_err_t
-bg95_mqtt_config_set_pdp_context(bg95_handle_t* handle, uint8_t client_idx, uint8_t pdp_cid)
+bg95_set_bands(bg95_handle_t* handle, const qcfg_band_config_t* bands, qcfg_effect_t effect)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!bands)
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  qcfg_write_params_t params = {
+      .type        = QCFG_TYPE_BAND,
+      .params.band = {
+          .bands = *bands, .effect = effect, .present = {.has_bands = true, .has_effect = true}}};
+
+  return bg95_qcfg_write(handle, &params, NULL);
+}
+
+esp_err_t bg95_get_bands(bg95_handle_t* handle, qcfg_band_config_t* bands)
+{
+  if (!bands)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (pdp_cid < 1 || pdp_cid > 16)
+  qcfg_write_params_t   params   = {.type = QCFG_TYPE_BAND};
+  qcfg_write_response_t response = {0};
+
+  esp_err_t err = bg95_qcfg_write(handle, &params, &response);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid PDP CID: %d (must be 1-16)", pdp_cid);
-    return ESP_ERR_INVALID_ARG;
+    *bands = response.response.band;
   }
+  return err;
+}
 
-  qmtcfg_write_params_t write_params             = {0};
-  write_params.type                              = QMTCFG_TYPE_PDPCID;
-  write_params.params.pdpcid.client_idx          = client_idx;
-  write_params.params.pdpcid.pdp_cid             = pdp_cid;
-  write_params.params.pdpcid.present.has_pdp_cid = true;
-
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, NULL);
+esp_err_t bg95_restore_default_scan_config(bg95_handle_t* handle)
+{
+  const qcfg_rat_t auto_seq[] = {QCFG_RAT_AUTO};
 
+  esp_err_t err = bg95_set_scan_sequence(handle, auto_seq, 1, QCFG_EFFECT_IMMEDIATELY);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to set MQTT PDP context: %s", esp_err_to_name(err));
     return err;
   }
 
-  ESP_LOGI(TAG, "Successfully set MQTT PDP context to %d for client %d", pdp_cid, client_idx);
-  return ESP_OK;
+  return bg95_set_bands(handle, &BG95_DEFAULT_BANDS, QCFG_EFFECT_IMMEDIATELY);
 }
 
-esp_err_t bg95_mqtt_config_query_pdp_context(bg95_handle_t*                  handle,
-                                             uint8_t                         client_idx,
-                                             qmtcfg_write_pdpcid_response_t* response)
+esp_err_t bg95_get_scan_config(bg95_handle_t* handle, bg95_scan_config_t* config)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  if (!config)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  esp_err_t err = bg95_get_scan_sequence(handle, &config->sequence);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    return err;
   }
 
-  qmtcfg_write_params_t write_params             = {0};
-  write_params.type                              = QMTCFG_TYPE_PDPCID;
-  write_params.params.pdpcid.client_idx          = client_idx;
-  write_params.params.pdpcid.present.has_pdp_cid = false; // Query mode - no PDP CID provided
-
-  qmtcfg_write_response_t write_response = {0};
+  return bg95_get_bands(handle, &config->bands);
+}
 
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+esp_err_t bg95_set_scan_config(bg95_handle_t* handle, const bg95_scan_config_t* config)
+{
+  if (!config)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
 
+  esp_err_t err = bg95_set_scan_sequence(
+      handle, config->sequence.rats, config->sequence.num_rats, QCFG_EFFECT_IMMEDIATELY);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to query MQTT PDP context: %s", esp_err_to_name(err));
     return err;
   }
 
-  // Copy the relevant part of the response
-  *response = write_response.response.pdpcid;
+  return bg95_set_bands(handle, &config->bands, QCFG_EFFECT_IMMEDIATELY);
+}
 
-  // Log the result
-  if (response->present.has_pdp_cid)
+esp_err_t bg95_get_network_info(bg95_handle_t* handle, qnwinfo_execute_response_t* info)
+{
+  if (!handle || !info || !handle->initialized)
   {
-    ESP_LOGI(TAG, "Current MQTT PDP context for client %d: %d", client_idx, response->pdp_cid);
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
   }
-  else
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QNWINFO, AT_CMD_TYPE_EXECUTE, NULL, info);
+  if (err != ESP_OK)
   {
-    ESP_LOGW(TAG, "PDP context information not available in response");
+    ESP_LOGE(TAG, "Failed to get network info: %s", esp_err_to_name(err));
+    return err;
   }
 
+  ESP_LOGI(TAG,
+           "Network info: %s, operator %s, band %s",
+           enum_to_str(info->act, QNWINFO_ACT_MAP, QNWINFO_ACT_MAP_SIZE),
+           info->present.has_operator ? info->operator_numeric : "-",
+           info->present.has_band ? info->band_str : "-");
+
   return ESP_OK;
 }
 
-// Set MQTT SSL mode and context index
-esp_err_t bg95_mqtt_config_set_ssl(bg95_handle_t*    handle,
-                                   uint8_t           client_idx,
-                                   qmtcfg_ssl_mode_t ssl_enable,
-                                   uint8_t           ctx_index)
+esp_err_t bg95_save_attach_hint(bg95_handle_t* handle)
 {
-  if (NULL == handle || !handle->initialized)
+  qnwinfo_execute_response_t info = {0};
+
+  esp_err_t err = bg95_get_network_info(handle, &info);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
-    return ESP_ERR_INVALID_ARG;
+    return err;
   }
 
-  if (client_idx > 5)
+  bg95_attach_hint_t hint = {.version = BG95_ATTACH_HINT_VERSION};
+  switch (info.act)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    case QNWINFO_ACT_GSM:
+      hint.rat = QCFG_RAT_GSM;
+      break;
+    case QNWINFO_ACT_EMTC:
+      hint.rat = QCFG_RAT_EMTC;
+      break;
+    case QNWINFO_ACT_NBIOT:
+      hint.rat = QCFG_RAT_NBIOT;
+      break;
+    default:
+      ESP_LOGW(TAG, "Not attached - no attach hint saved");
+      return ESP_ERR_INVALID_STATE;
   }
 
-  if (ssl_enable != QMTCFG_SSL_DISABLE && ssl_enable != QMTCFG_SSL_ENABLE)
+  if (info.present.has_lte_band)
   {
-    ESP_LOGE(TAG, "Invalid SSL enable value: %d", ssl_enable);
-    return ESP_ERR_INVALID_ARG;
+    hint.lte_band = info.lte_band;
   }
-
-  if (ctx_index > 5)
+  if (info.present.has_operator)
   {
-    ESP_LOGE(TAG, "Invalid SSL context index: %d (must be 0-5)", ctx_index);
-    return ESP_ERR_INVALID_ARG;
+    snprintf(hint.operator_numeric, sizeof hint.operator_numeric, "%s", info.operator_numeric);
   }
 
-  qmtcfg_write_params_t write_params             = {0};
-  write_params.type                              = QMTCFG_TYPE_SSL;
-  write_params.params.ssl.client_idx             = client_idx;
-  write_params.params.ssl.ssl_enable             = ssl_enable;
-  write_params.params.ssl.ctx_index              = ctx_index;
-  write_params.params.ssl.present.has_ssl_enable = true;
-  write_params.params.ssl.present.has_ctx_index  = true;
-
-  // Set command only expects OK response, no data
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCFG,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &write_params,
-                                                      NULL); // No response data needed
+  return bg95_persist_save(BG95_PERSIST_KEY_ATTACH_HINT, &hint, sizeof(hint));
+}
 
-  if (err != ESP_OK)
+esp_err_t bg95_load_attach_hint(bg95_attach_hint_t* hint)
+{
+  if (!hint)
   {
-    ESP_LOGE(TAG, "Failed to set MQTT SSL mode: %s", esp_err_to_name(err));
+    return ESP_ERR_INVALID_ARG;
   }
-  else
+
+  esp_err_t err = bg95_persist_load(BG95_PERSIST_KEY_ATTACH_HINT, hint, sizeof(*hint));
+  if (err == ESP_ERR_INVALID_SIZE ||
+      (err == ESP_OK &&
+       (hint->version != BG95_ATTACH_HINT_VERSION || hint->rat == QCFG_RAT_AUTO ||
+        hint->rat > QCFG_RAT_NBIOT)))
   {
-    ESP_LOGI(TAG,
-             "Successfully set MQTT SSL mode to %d with context %d for client %d",
-             ssl_enable,
-             ctx_index,
-             client_idx);
+    ESP_LOGW(TAG, "Ignoring invalid attach hint");
+    return ESP_ERR_NOT_FOUND;
   }
 
   return err;
 }
 
-// Query MQTT SSL configuration
-esp_err_t bg95_mqtt_config_query_ssl(bg95_handle_t*               handle,
-                                     uint8_t                      client_idx,
-                                     qmtcfg_write_ssl_response_t* response)
+esp_err_t bg95_apply_attach_hint(bg95_handle_t* handle, bg95_scan_config_t* previous)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  bg95_attach_hint_t hint;
+  bg95_scan_config_t current;
+
+  esp_err_t err = bg95_load_attach_hint(&hint);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
-    return ESP_ERR_INVALID_ARG;
+    return err;
   }
 
-  if (client_idx > 5)
+  // Read before anything is narrowed - this is what a failed attempt restores
+  err = bg95_get_scan_config(handle, &current);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    return err;
+  }
+  if (previous)
+  {
+    *previous = current;
   }
 
-  qmtcfg_write_params_t write_params             = {0};
-  write_params.type                              = QMTCFG_TYPE_SSL;
-  write_params.params.ssl.client_idx             = client_idx;
-  write_params.params.ssl.present.has_ssl_enable = false; // Query mode
-  write_params.params.ssl.present.has_ctx_index  = false; // Query mode
-
-  qmtcfg_write_response_t write_response = {0};
+  // Hinted RAT first, then the remaining ones in the default (eMTC, NB-IoT, GSM) order
+  const qcfg_rat_t default_order[] = {QCFG_RAT_EMTC, QCFG_RAT_NBIOT, QCFG_RAT_GSM};
+  qcfg_rat_t       sequence[QCFG_NWSCANSEQ_MAX_RATS];
+  uint8_t          num_rats = 0;
 
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+  sequence[num_rats++] = hint.rat;
+  for (size_t i = 0; i < sizeof(default_order) / sizeof(default_order[0]); i++)
+  {
+    if (default_order[i] != hint.rat)
+    {
+      sequence[num_rats++] = default_order[i];
+    }
+  }
 
+  err = bg95_set_scan_sequence(handle, sequence, num_rats, QCFG_EFFECT_IMMEDIATELY);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to query MQTT SSL mode: %s", esp_err_to_name(err));
     return err;
   }
 
-  // Copy the relevant part of the response
-  *response = write_response.response.ssl;
-
-  // Log the result
-  if (response->present.has_ssl_enable)
+  // Only scan the hinted band for the hinted RAT - the other RATs keep their bands
+  if (hint.lte_band != 0 && (hint.rat == QCFG_RAT_EMTC || hint.rat == QCFG_RAT_NBIOT))
   {
-    ESP_LOGI(TAG,
-             "MQTT SSL mode for client %d: %s",
-             client_idx,
-             response->ssl_enable == QMTCFG_SSL_ENABLE ? "Enabled" : "Disabled");
+    qcfg_band_config_t    bands = current.bands;
+    qcfg_lte_band_mask_t* mask  = (hint.rat == QCFG_RAT_EMTC) ? &bands.emtc : &bands.nbiot;
 
-    if (response->present.has_ctx_index && response->ssl_enable == QMTCFG_SSL_ENABLE)
+    *mask = (qcfg_lte_band_mask_t) {0};
+    qcfg_lte_band_mask_set(mask, hint.lte_band);
+
+    err = bg95_set_bands(handle, &bands, QCFG_EFFECT_IMMEDIATELY);
+    if (err != ESP_OK)
     {
-      ESP_LOGI(TAG, "Using SSL context index: %d", response->ctx_index);
+      return err;
     }
   }
-  else
-  {
-    ESP_LOGW(TAG, "SSL configuration information not available in response");
-  }
+
+  ESP_LOGI(TAG,
+           "Applied attach hint: %s first, LTE band %d, operator %s",
+           enum_to_str(hint.rat, QCFG_RAT_MAP, QCFG_RAT_MAP_SIZE),
+           hint.lte_band,
+           hint.operator_numeric);
 
   return ESP_OK;
 }
 
-// Set MQTT keepalive time
+#define BG95_ATTACH_HINT_POLL_MS 1000
+
 esp_err_t
-bg95_mqtt_config_set_keepalive(bg95_handle_t* handle, uint8_t client_idx, uint16_t keep_alive_time)
+bg95_attach_with_hint(bg95_handle_t* handle, uint32_t timeout_ms, bg95_scan_config_t* previous)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!handle || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  bg95_scan_config_t saved = {0};
+  esp_err_t          err   = bg95_apply_attach_hint(handle, &saved);
+  if (err == ESP_ERR_NOT_FOUND || saved.sequence.num_rats == 0)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    return err; // Nothing was narrowed (no hint, or the config could not be read)
   }
-
-  if (keep_alive_time > 3600) // Maximum allowed value per documentation
+  if (err == ESP_OK && previous)
   {
-    ESP_LOGE(TAG, "Invalid keep-alive time: %d (must be 0-3600)", keep_alive_time);
-    return ESP_ERR_INVALID_ARG;
+    *previous = saved;
   }
 
-  qmtcfg_write_params_t write_params                        = {0};
-  write_params.type                                         = QMTCFG_TYPE_KEEPALIVE;
-  write_params.params.keepalive.client_idx                  = client_idx;
-  write_params.params.keepalive.keep_alive_time             = keep_alive_time;
+  // Registered on the hinted RAT / band in time - keep the narrowed config (see the header)
+  uint32_t start_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+  while (err == ESP_OK)
+  {
+    cereg_read_response_t cereg = {0};
+    err                         = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_CEREG, AT_CMD_TYPE_READ, NULL, &cereg);
+    if (err != ESP_OK)
+    {
+      break;
+    }
+    if (cereg.stat == CEREG_STAT_HOME || cereg.stat == CEREG_STAT_ROAMING)
+    {
+      ESP_LOGI(TAG, "Attached with the hint");
+      return ESP_OK;
+    }
+    if (cereg.stat == CEREG_STAT_DENIED)
+    {
+      err = ESP_FAIL;
+      break;
+    }
+    if (pdTICKS_TO_MS(xTaskGetTickCount()) - start_ms >= timeout_ms)
+    {
+      err = ESP_ERR_TIMEOUT;
+      break;
+    }
+    vTaskDelay(pdMS_TO_TICKS(BG95_ATTACH_HINT_POLL_MS));
+  }
+
+  // The hinted band mask must not outlive a failed attempt - a module that moved would never find
+  // a cell outside it. The user's own config goes back, not the factory one
+  ESP_LOGW(TAG, "Attach with the hint failed (%s) - restoring scan config", esp_err_to_name(err));
+  esp_err_t restore_err = bg95_set_scan_config(handle, &saved);
+  if (restore_err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to restore the scan config: %s", esp_err_to_name(restore_err));
+    return restore_err;
+  }
+  return err;
+}
+
+esp_err_t bg95_clear_attach_hint(void)
+{
+  return bg95_persist_erase(BG95_PERSIST_KEY_ATTACH_HINT);
+}
+
+esp_err_t bg95_define_pdp_context(bg95_handle_t*     handle,
+                                  uint8_t            cid,
+                                  cgdcont_pdp_type_t pdp_type,
+                                  const char*        apn)
+{
+  if (handle == NULL || apn == NULL || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  /* Validate CID range (1-15 as per specification) */
+  if (cid < 1 || cid > 15)
+  {
+    ESP_LOGE(TAG, "Invalid CID: %d (must be 1-15)", cid);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  /* Create write parameters with required fields */
+  cgdcont_write_params_t write_params;
+  memset(&write_params, 0, sizeof(cgdcont_write_params_t));
+
+  /* Set the fields and present flags */
+  write_params.cid      = cid;
+  write_params.pdp_type = pdp_type;
+  strncpy(write_params.apn, apn, sizeof(write_params.apn) - 1);
+  write_params.apn[sizeof(write_params.apn) - 1] = '\0';
+
+  /* Set present flags */
+  write_params.present.has_cid      = true;
+  write_params.present.has_pdp_type = true;
+  write_params.present.has_apn      = true;
+
+  /* Send the command */
+  ESP_LOGI(
+      TAG, "Defining PDP context: CID=%d, PDP_TYPE=%d, APN=%s", cid, pdp_type, write_params.apn);
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CGDCONT, AT_CMD_TYPE_WRITE, &write_params, NULL);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to define PDP context: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  ESP_LOGI(TAG, "Successfully defined PDP context (CID=%d, APN=%s)", cid, apn);
+  return ESP_OK;
+}
+
+esp_err_t bg95_activate_pdp_context(bg95_handle_t* handle, const int cid)
+{
+
+  if (handle == NULL || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cgact_write_params_t write_params;
+  memset(&write_params, 0, sizeof(cgact_write_params_t));
+
+  write_params.cid   = cid;
+  write_params.state = CGACT_STATE_ACTIVATED;
+
+  return at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CGACT, AT_CMD_TYPE_WRITE, &write_params, NULL);
+}
+
+esp_err_t bg95_is_pdp_context_active(bg95_handle_t* handle, uint8_t cid, bool* is_active)
+{
+  if (NULL == handle || NULL == is_active)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Initialize output
+  *is_active = false;
+
+  // Create response structure
+  cgact_read_response_t response = {0};
+
+  // Send CGACT read command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CGACT, AT_CMD_TYPE_READ, NULL, &response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get PDP context activation status: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Search for the specified CID
+  for (int i = 0; i < response.num_contexts; i++)
+  {
+    if (response.contexts[i].cid == cid)
+    {
+      *is_active = (response.contexts[i].state == CGACT_STATE_ACTIVATED);
+      ESP_LOGI(TAG, "PDP context %d is %s", cid, *is_active ? "active" : "inactive");
+      return ESP_OK;
+    }
+  }
+
+  // CID not found in response
+  ESP_LOGW(TAG, "PDP context %d not found in CGACT response", cid);
+  return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t
+bg95_get_pdp_address_for_cid(bg95_handle_t* handle, uint8_t cid, char* address, size_t address_size)
+{
+  if (NULL == handle || NULL == address || address_size == 0)
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Validate CID range
+  if (cid < CGPADDR_CID_RANGE_MIN_VALUE || cid > CGPADDR_CID_RANGE_MAX_VALUE)
+  {
+    ESP_LOGE(TAG, "Invalid CID: %d (must be 1-15)", cid);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Initialize output
+  address[0] = '\0';
+
+  // Create command parameters
+  cgpaddr_write_params_t params = {.cid = cid};
+
+  // Create response structure
+  cgpaddr_write_response_t response = {0};
+
+  // Send CGPADDR write command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CGPADDR, AT_CMD_TYPE_WRITE, &params, &response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get PDP address for CID %d: %s", cid, esp_err_to_name(err));
+    return err;
+  }
+
+  // Verify that the CID in response matches requested CID
+  if (response.cid != cid)
+  {
+    ESP_LOGE(TAG, "Response CID (%d) doesn't match requested CID (%d)", response.cid, cid);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  // Check if an address was returned
+  if (response.address[0] == '\0')
+  {
+    ESP_LOGW(TAG, "No PDP address available for CID %d", cid);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // Copy address to output buffer
+  if (strlen(response.address) >= address_size)
+  {
+    ESP_LOGW(TAG, "Address buffer too small, truncating result");
+  }
+
+  strncpy(address, response.address, address_size - 1);
+  address[address_size - 1] = '\0'; // Ensure null termination
+
+  ESP_LOGI(TAG, "PDP address for CID %d: %s", cid, address);
+  return ESP_OK;
+}
+
+esp_err_t bg95_connect_to_network(bg95_handle_t* handle)
+{
+  esp_err_t err;
+  // Check SIM card status (AT+CPIN)
+  // -----------------------------------------------------------
+  cpin_status_t sim_card_status;
+  err = bg95_get_sim_card_status(handle, &sim_card_status);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get PIN status: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // TODO:  REPLACE THIS WITH QCSQ - extended signal quality check (regular CSQ is for 2G)
+  //  Check signal quality (AT+CSQ)
+  //  -----------------------------------------------------------
+  // int16_t rssi_dbm;
+  // err = bg95_get_signal_quality_dbm(handle, &rssi_dbm);
+  // if (err != ESP_OK)
+  // {
+  //   ESP_LOGE(TAG, "Failed to check signal quality: %s", esp_err_to_name(err));
+  //   return err;
+  // }
+
+  qcsq_execute_response_t qcsq_execute_response = {0};
+  err = bg95_get_extended_signal_quality(handle, &qcsq_execute_response);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to check signal quality: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Check available operators list (AT+COPS)
+  // -----------------------------------------------------------
+  cops_operator_data_t operator_data;
+  err = bg95_get_current_operator(handle, &operator_data);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get current operator: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Define PDP context with your carriers APN (AT+CGDCONT)
+  // -----------------------------------------------------------
+  int                cid      = 1;
+  cgdcont_pdp_type_t pdp_type = CGDCONT_PDP_TYPE_IPV4V6;
+  const char*        apn      = "simbase"; // Use 'simbase' as the APN
+  err                         = bg95_define_pdp_context(handle, cid, pdp_type, apn);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(
+        TAG, "Failed to define PDP context (set cid, pdp type, apn): %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Soft restart needed for setting to take place (AT+CFUN=0, AT+CFUN=1)
+  // -----------------------------------------------------------
+  err = bg95_soft_restart(handle);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to soft restart BG95 %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Activate PDP context (AT+CGACT)
+  // -----------------------------------------------------------
+  err = bg95_activate_pdp_context(handle, cid);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(
+        TAG, "Failed to activate PDP context for cid: %d, error: %s", cid, esp_err_to_name(err));
+    return err;
+  }
+
+  // Verify IP address assignment (AT+CGPADDR)
+  // -----------------------------------------------------------
+  char ip_address[CGPADDR_ADDRESS_MAX_CHARS];
+  err = bg95_get_pdp_address_for_cid(handle, cid, ip_address, sizeof(ip_address));
+  if (err != ESP_OK)
+  {
+
+    ESP_LOGI(TAG, "Failed to get PDP context address: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  ESP_LOGI(TAG, "Successfully connected to network");
+  return ESP_OK;
+}
+
+//////////////////////  MQTT  STUFF   /////////////////////////
+// -----------------------------------------------------------
+esp_err_t bg95_get_mqtt_config_params(bg95_handle_t* handle, qmtcfg_test_response_t* config_params)
+{
+  if (NULL == handle || NULL == config_params || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // TODO: Implement this - it should call query for each  of the config params one by one
+
+  return ESP_OK;
+}
+
+esp_err_t
+bg95_mqtt_config_set_pdp_context(bg95_handle_t* handle, uint8_t client_idx, uint8_t pdp_cid)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (pdp_cid < 1 || pdp_cid > 16)
+  {
+    ESP_LOGE(TAG, "Invalid PDP CID: %d (must be 1-16)", pdp_cid);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params             = {0};
+  write_params.type                              = QMTCFG_TYPE_PDPCID;
+  write_params.params.pdpcid.client_idx          = client_idx;
+  write_params.params.pdpcid.pdp_cid             = pdp_cid;
+  write_params.params.pdpcid.present.has_pdp_cid = true;
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, NULL);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT PDP context: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  ESP_LOGI(TAG, "Successfully set MQTT PDP context to %d for client %d", pdp_cid, client_idx);
+  return ESP_OK;
+}
+
+esp_err_t bg95_mqtt_config_query_pdp_context(bg95_handle_t*                  handle,
+                                             uint8_t                         client_idx,
+                                             qmtcfg_write_pdpcid_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params             = {0};
+  write_params.type                              = QMTCFG_TYPE_PDPCID;
+  write_params.params.pdpcid.client_idx          = client_idx;
+  write_params.params.pdpcid.present.has_pdp_cid = false; // Query mode - no PDP CID provided
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT PDP context: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.pdpcid;
+
+  // Log the result
+  if (response->present.has_pdp_cid)
+  {
+    ESP_LOGI(TAG, "Current MQTT PDP context for client %d: %d", client_idx, response->pdp_cid);
+  }
+  else
+  {
+    ESP_LOGW(TAG, "PDP context information not available in response");
+  }
+
+  return ESP_OK;
+}
+
+// Set MQTT SSL mode and context index
+esp_err_t bg95_mqtt_config_set_ssl(bg95_handle_t*    handle,
+                                   uint8_t           client_idx,
+                                   qmtcfg_ssl_mode_t ssl_enable,
+                                   uint8_t           ctx_index)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (ssl_enable != QMTCFG_SSL_DISABLE && ssl_enable != QMTCFG_SSL_ENABLE)
+  {
+    ESP_LOGE(TAG, "Invalid SSL enable value: %d", ssl_enable);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (ctx_index > 5)
+  {
+    ESP_LOGE(TAG, "Invalid SSL context index: %d (must be 0-5)", ctx_index);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params             = {0};
+  write_params.type                              = QMTCFG_TYPE_SSL;
+  write_params.params.ssl.client_idx             = client_idx;
+  write_params.params.ssl.ssl_enable             = ssl_enable;
+  write_params.params.ssl.ctx_index              = ctx_index;
+  write_params.params.ssl.present.has_ssl_enable = true;
+  write_params.params.ssl.present.has_ctx_index  = true;
+
+  // Set command only expects OK response, no data
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &write_params,
+                                                      NULL); // No response data needed
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT SSL mode: %s", esp_err_to_name(err));
+  }
+  else
+  {
+    ESP_LOGI(TAG,
+             "Successfully set MQTT SSL mode to %d with context %d for client %d",
+             ssl_enable,
+             ctx_index,
+             client_idx);
+  }
+
+  return err;
+}
+
+// Query MQTT SSL configuration
+esp_err_t bg95_mqtt_config_query_ssl(bg95_handle_t*               handle,
+                                     uint8_t                      client_idx,
+                                     qmtcfg_write_ssl_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params             = {0};
+  write_params.type                              = QMTCFG_TYPE_SSL;
+  write_params.params.ssl.client_idx             = client_idx;
+  write_params.params.ssl.present.has_ssl_enable = false; // Query mode
+  write_params.params.ssl.present.has_ctx_index  = false; // Query mode
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT SSL mode: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.ssl;
+
+  // Log the result
+  if (response->present.has_ssl_enable)
+  {
+    ESP_LOGI(TAG,
+             "MQTT SSL mode for client %d: %s",
+             client_idx,
+             response->ssl_enable == QMTCFG_SSL_ENABLE ? "Enabled" : "Disabled");
+
+    if (response->present.has_ctx_index && response->ssl_enable == QMTCFG_SSL_ENABLE)
+    {
+      ESP_LOGI(TAG, "Using SSL context index: %d", response->ctx_index);
+    }
+  }
+  else
+  {
+    ESP_LOGW(TAG, "SSL configuration information not available in response");
+  }
+
+  return ESP_OK;
+}
+
+// Set MQTT keepalive time
+esp_err_t
+bg95_mqtt_config_set_keepalive(bg95_handle_t* handle, uint8_t client_idx, uint16_t keep_alive_time)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (keep_alive_time > 3600) // Maximum allowed value per documentation
+  {
+    ESP_LOGE(TAG, "Invalid keep-alive time: %d (must be 0-3600)", keep_alive_time);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                        = {0};
+  write_params.type                                         = QMTCFG_TYPE_KEEPALIVE;
+  write_params.params.keepalive.client_idx                  = client_idx;
+  write_params.params.keepalive.keep_alive_time             = keep_alive_time;
   write_params.params.keepalive.present.has_keep_alive_time = true;
 
-  // Set command only expects OK response, no data
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCFG,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &write_params,
-                                                      NULL); // No response data needed
+  // Set command only expects OK response, no data
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &write_params,
+                                                      NULL); // No response data needed
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT keep-alive time: %s", esp_err_to_name(err));
+  }
+  else
+  {
+    ESP_LOGI(TAG,
+             "Successfully set MQTT keep-alive time to %d seconds for client %d",
+             keep_alive_time,
+             client_idx);
+  }
+
+  return err;
+}
+
+// Query MQTT keepalive configuration
+esp_err_t bg95_mqtt_config_query_keepalive(bg95_handle_t*                     handle,
+                                           uint8_t                            client_idx,
+                                           qmtcfg_write_keepalive_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                        = {0};
+  write_params.type                                         = QMTCFG_TYPE_KEEPALIVE;
+  write_params.params.keepalive.client_idx                  = client_idx;
+  write_params.params.keepalive.present.has_keep_alive_time = false; // Query mode
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT keep-alive time: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.keepalive;
+
+  // Log the result
+  if (response->present.has_keep_alive_time)
+  {
+    ESP_LOGI(TAG,
+             "MQTT keep-alive time for client %d: %d seconds",
+             client_idx,
+             response->keep_alive_time);
+  }
+  else
+  {
+    ESP_LOGW(TAG, "Keep-alive time information not available in response");
+  }
+
+  return ESP_OK;
+}
+
+// Set MQTT session type
+esp_err_t bg95_mqtt_config_set_session(bg95_handle_t*         handle,
+                                       uint8_t                client_idx,
+                                       qmtcfg_clean_session_t clean_session)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (clean_session != QMTCFG_CLEAN_SESSION_DISABLE && clean_session != QMTCFG_CLEAN_SESSION_ENABLE)
+  {
+    ESP_LOGE(TAG, "Invalid clean session value: %d", clean_session);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                    = {0};
+  write_params.type                                     = QMTCFG_TYPE_SESSION;
+  write_params.params.session.client_idx                = client_idx;
+  write_params.params.session.clean_session             = clean_session;
+  write_params.params.session.present.has_clean_session = true;
+
+  // Set command only expects OK response, no data
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &write_params,
+                                                      NULL); // No response data needed
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT session type: %s", esp_err_to_name(err));
+  }
+  else
+  {
+    ESP_LOGI(TAG,
+             "Successfully set MQTT session type to %s for client %d",
+             clean_session == QMTCFG_CLEAN_SESSION_ENABLE ? "clean (discard previous info)"
+                                                          : "persistent (store subscriptions)",
+             client_idx);
+  }
+
+  return err;
+}
+
+// Query MQTT session configuration
+esp_err_t bg95_mqtt_config_query_session(bg95_handle_t*                   handle,
+                                         uint8_t                          client_idx,
+                                         qmtcfg_write_session_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                    = {0};
+  write_params.type                                     = QMTCFG_TYPE_SESSION;
+  write_params.params.session.client_idx                = client_idx;
+  write_params.params.session.present.has_clean_session = false; // Query mode
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT session type: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.session;
+
+  // Log the result
+  if (response->present.has_clean_session)
+  {
+    ESP_LOGI(TAG,
+             "MQTT session type for client %d: %s",
+             client_idx,
+             response->clean_session == QMTCFG_CLEAN_SESSION_ENABLE
+                 ? "Clean (discard information)"
+                 : "Persistent (store subscriptions)");
+  }
+  else
+  {
+    ESP_LOGW(TAG, "Session type information not available in response");
+  }
+
+  return ESP_OK;
+}
+
+// Set MQTT timeout parameters
+esp_err_t bg95_mqtt_config_set_timeout(bg95_handle_t*          handle,
+                                       uint8_t                 client_idx,
+                                       uint8_t                 pkt_timeout,
+                                       uint8_t                 retry_times,
+                                       qmtcfg_timeout_notice_t timeout_notice)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (pkt_timeout < 1 || pkt_timeout > 60)
+  {
+    ESP_LOGE(TAG, "Invalid packet timeout: %d (must be 1-60)", pkt_timeout);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (retry_times > 10)
+  {
+    ESP_LOGE(TAG, "Invalid retry times: %d (must be 0-10)", retry_times);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (timeout_notice != QMTCFG_TIMEOUT_NOTICE_DISABLE &&
+      timeout_notice != QMTCFG_TIMEOUT_NOTICE_ENABLE)
+  {
+    ESP_LOGE(TAG, "Invalid timeout notice value: %d", timeout_notice);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                     = {0};
+  write_params.type                                      = QMTCFG_TYPE_TIMEOUT;
+  write_params.params.timeout.client_idx                 = client_idx;
+  write_params.params.timeout.pkt_timeout                = pkt_timeout;
+  write_params.params.timeout.retry_times                = retry_times;
+  write_params.params.timeout.timeout_notice             = timeout_notice;
+  write_params.params.timeout.present.has_pkt_timeout    = true;
+  write_params.params.timeout.present.has_retry_times    = true;
+  write_params.params.timeout.present.has_timeout_notice = true;
+
+  // Set command only expects OK response, no data
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &write_params,
+                                                      NULL); // No response data needed
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT timeout parameters: %s", esp_err_to_name(err));
+  }
+  else
+  {
+    ESP_LOGI(TAG,
+             "Successfully set MQTT timeout parameters for client %d: "
+             "packet timeout=%d, retry times=%d, timeout notice=%d",
+             client_idx,
+             pkt_timeout,
+             retry_times,
+             timeout_notice);
+  }
+
+  return err;
+}
+
+// Query MQTT timeout configuration
+esp_err_t bg95_mqtt_config_query_timeout(bg95_handle_t*                   handle,
+                                         uint8_t                          client_idx,
+                                         qmtcfg_write_timeout_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params     = {0};
+  write_params.type                      = QMTCFG_TYPE_TIMEOUT;
+  write_params.params.timeout.client_idx = client_idx;
+  // Set all present flags to false for query mode
+  write_params.params.timeout.present.has_pkt_timeout    = false;
+  write_params.params.timeout.present.has_retry_times    = false;
+  write_params.params.timeout.present.has_timeout_notice = false;
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT timeout parameters: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.timeout;
+
+  // Log the result
+  ESP_LOGI(TAG, "MQTT timeout parameters for client %d:", client_idx);
+
+  if (response->present.has_pkt_timeout)
+  {
+    ESP_LOGI(TAG, "  Packet timeout: %d seconds", response->pkt_timeout);
+  }
+
+  if (response->present.has_retry_times)
+  {
+    ESP_LOGI(TAG, "  Retry times: %d", response->retry_times);
+  }
+
+  if (response->present.has_timeout_notice)
+  {
+    ESP_LOGI(TAG,
+             "  Timeout notice: %s",
+             response->timeout_notice == QMTCFG_TIMEOUT_NOTICE_ENABLE ? "Enabled" : "Disabled");
+  }
+
+  return ESP_OK;
+}
+
+// Set MQTT will configuration
+esp_err_t bg95_mqtt_config_set_will(bg95_handle_t*       handle,
+                                    uint8_t              client_idx,
+                                    qmtcfg_will_flag_t   will_flag,
+                                    qmtcfg_will_qos_t    will_qos,
+                                    qmtcfg_will_retain_t will_retain,
+                                    const char*          will_topic,
+                                    const char*          will_message)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (will_flag != QMTCFG_WILL_FLAG_IGNORE && will_flag != QMTCFG_WILL_FLAG_REQUIRE)
+  {
+    ESP_LOGE(TAG, "Invalid will flag value: %d", will_flag);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params             = {0};
+  write_params.type                              = QMTCFG_TYPE_WILL;
+  write_params.params.will.client_idx            = client_idx;
+  write_params.params.will.will_flag             = will_flag;
+  write_params.params.will.present.has_will_flag = true;
+
+  // If will flag is REQUIRE, additional parameters are needed
+  if (will_flag == QMTCFG_WILL_FLAG_REQUIRE)
+  {
+    if (will_qos > QMTCFG_WILL_QOS_2)
+    {
+      ESP_LOGE(TAG, "Invalid will QoS value: %d", will_qos);
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    if (will_retain != QMTCFG_WILL_RETAIN_DISABLE && will_retain != QMTCFG_WILL_RETAIN_ENABLE)
+    {
+      ESP_LOGE(TAG, "Invalid will retain value: %d", will_retain);
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    if (will_topic == NULL || will_message == NULL)
+    {
+      ESP_LOGE(TAG, "Will topic and message must be provided when will flag is REQUIRE");
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    write_params.params.will.will_qos    = will_qos;
+    write_params.params.will.will_retain = will_retain;
+    strncpy(write_params.params.will.will_topic,
+            will_topic,
+            sizeof(write_params.params.will.will_topic) - 1);
+    strncpy(write_params.params.will.will_message,
+            will_message,
+            sizeof(write_params.params.will.will_message) - 1);
+
+    write_params.params.will.present.has_will_qos     = true;
+    write_params.params.will.present.has_will_retain  = true;
+    write_params.params.will.present.has_will_topic   = true;
+    write_params.params.will.present.has_will_message = true;
+  }
+
+  // Set command only expects OK response, no data
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &write_params,
+                                                      NULL); // No response data needed
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT will configuration: %s", esp_err_to_name(err));
+  }
+  else
+  {
+    if (will_flag == QMTCFG_WILL_FLAG_IGNORE)
+    {
+      ESP_LOGI(TAG, "Successfully disabled MQTT will for client %d", client_idx);
+    }
+    else
+    {
+      ESP_LOGI(TAG,
+               "Successfully set MQTT will for client %d: QoS=%d, Retain=%d, "
+               "Topic='%s', Message='%s'",
+               client_idx,
+               will_qos,
+               will_retain,
+               will_topic,
+               will_message);
+    }
+  }
+
+  return err;
+}
+
+// Query MQTT will configuration
+esp_err_t bg95_mqtt_config_query_will(bg95_handle_t*                handle,
+                                      uint8_t                       client_idx,
+                                      qmtcfg_write_will_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params             = {0};
+  write_params.type                              = QMTCFG_TYPE_WILL;
+  write_params.params.will.client_idx            = client_idx;
+  write_params.params.will.present.has_will_flag = false; // Query mode
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT will configuration: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.will;
+
+  // Log the result
+  if (response->present.has_will_flag)
+  {
+    if (response->will_flag == QMTCFG_WILL_FLAG_IGNORE)
+    {
+      ESP_LOGI(TAG, "MQTT will is disabled for client %d", client_idx);
+    }
+    else
+    {
+      ESP_LOGI(TAG, "MQTT will is enabled for client %d", client_idx);
+
+      if (response->present.has_will_qos)
+      {
+        ESP_LOGI(TAG, "  Will QoS: %d", response->will_qos);
+      }
+
+      if (response->present.has_will_retain)
+      {
+        ESP_LOGI(TAG,
+                 "  Will retain: %s",
+                 response->will_retain == QMTCFG_WILL_RETAIN_ENABLE ? "Yes" : "No");
+      }
+
+      if (response->present.has_will_topic)
+      {
+        ESP_LOGI(TAG, "  Will topic: %s", response->will_topic);
+      }
+
+      if (response->present.has_will_message)
+      {
+        ESP_LOGI(TAG, "  Will message: %s", response->will_message);
+      }
+    }
+  }
+  else
+  {
+    ESP_LOGW(TAG, "Will configuration information not available in response");
+  }
+
+  return ESP_OK;
+}
+
+// Set MQTT message receive mode
+esp_err_t bg95_mqtt_config_set_recv_mode(bg95_handle_t*          handle,
+                                         uint8_t                 client_idx,
+                                         qmtcfg_msg_recv_mode_t  msg_recv_mode,
+                                         qmtcfg_msg_len_enable_t msg_len_enable)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (msg_recv_mode != QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC &&
+      msg_recv_mode != QMTCFG_MSG_RECV_MODE_NOT_CONTAIN_IN_URC)
+  {
+    ESP_LOGE(TAG, "Invalid message receive mode: %d", msg_recv_mode);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (msg_len_enable != QMTCFG_MSG_LEN_DISABLE && msg_len_enable != QMTCFG_MSG_LEN_ENABLE)
+  {
+    ESP_LOGE(TAG, "Invalid message length enable value: %d", msg_len_enable);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                       = {0};
+  write_params.type                                        = QMTCFG_TYPE_RECV_MODE;
+  write_params.params.recv_mode.client_idx                 = client_idx;
+  write_params.params.recv_mode.msg_recv_mode              = msg_recv_mode;
+  write_params.params.recv_mode.msg_len_enable             = msg_len_enable;
+  write_params.params.recv_mode.present.has_msg_recv_mode  = true;
+  write_params.params.recv_mode.present.has_msg_len_enable = true;
+
+  // Set command only expects OK response, no data
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCFG,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &write_params,
+                                                      NULL); // No response data needed
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to set MQTT receive mode: %s", esp_err_to_name(err));
+  }
+  else
+  {
+    ESP_LOGI(TAG,
+             "Successfully set MQTT receive mode for client %d: "
+             "Message %s in URC, Length %s in URC",
+             client_idx,
+             msg_recv_mode == QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC ? "contained" : "not contained",
+             msg_len_enable == QMTCFG_MSG_LEN_ENABLE ? "contained" : "not contained");
+  }
+
+  return err;
+}
+
+// Query MQTT receive mode configuration
+esp_err_t bg95_mqtt_config_query_recv_mode(bg95_handle_t*                     handle,
+                                           uint8_t                            client_idx,
+                                           qmtcfg_write_recv_mode_response_t* response)
+{
+  if (NULL == handle || !handle->initialized || NULL == response)
+  {
+    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > 5)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  qmtcfg_write_params_t write_params                       = {0};
+  write_params.type                                        = QMTCFG_TYPE_RECV_MODE;
+  write_params.params.recv_mode.client_idx                 = client_idx;
+  write_params.params.recv_mode.present.has_msg_recv_mode  = false; // Query mode
+  write_params.params.recv_mode.present.has_msg_len_enable = false; // Query mode
+
+  qmtcfg_write_response_t write_response = {0};
+
+  // Send query command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to query MQTT receive mode: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Copy the relevant part of the response
+  *response = write_response.response.recv_mode;
+
+  // Log the result
+  ESP_LOGI(TAG, "MQTT receive mode for client %d:", client_idx);
+
+  if (response->present.has_msg_recv_mode)
+  {
+    ESP_LOGI(TAG,
+             "  Message receive mode: %s",
+             response->msg_recv_mode == QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC
+                 ? "Contained in URC"
+                 : "Not contained in URC");
+  }
+  else
+  {
+    ESP_LOGW(TAG, "  Message receive mode information not available");
+  }
+
+  if (response->present.has_msg_len_enable)
+  {
+    ESP_LOGI(TAG,
+             "  Message length: %s",
+             response->msg_len_enable == QMTCFG_MSG_LEN_ENABLE ? "Contained in URC"
+                                                               : "Not contained in URC");
+  }
+  else
+  {
+    ESP_LOGW(TAG, "  Message length enable information not available");
+  }
+
+  return ESP_OK;
+}
+
+// Get current MQTT network connection status
+esp_err_t bg95_mqtt_network_open_status(bg95_handle_t*           handle,
+                                        uint8_t                  client_idx,
+                                        qmtopen_read_response_t* status)
+{
+  if (NULL == handle || NULL == status || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTOPEN_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTOPEN_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Send read command (AT+QMTOPEN?) to get current connections
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTOPEN, AT_CMD_TYPE_READ, NULL, status);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get MQTT network connection status: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Check if we got info for the requested client_idx
+  if (!status->present.has_client_idx || status->client_idx != client_idx)
+  {
+    ESP_LOGW(TAG, "No connection info found for MQTT client %d", client_idx);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  ESP_LOGI(TAG,
+           "MQTT client %d connected to %s:%d",
+           status->client_idx,
+           status->host_name,
+           status->port);
+
+  return ESP_OK;
+}
+
+// Open a network connection for MQTT client
+esp_err_t bg95_mqtt_open_network(bg95_handle_t*            handle,
+                                 uint8_t                   client_idx,
+                                 const char*               host_name,
+                                 uint16_t                  port,
+                                 qmtopen_write_response_t* response)
+{
+  if (NULL == handle || NULL == host_name || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTOPEN_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTOPEN_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (port > QMTOPEN_PORT_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid port: %d (must be 0-%d)", port, QMTOPEN_PORT_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (strlen(host_name) > QMTOPEN_HOST_NAME_MAX_SIZE)
+  {
+    ESP_LOGE(TAG, "Host name too long (max %d chars)", QMTOPEN_HOST_NAME_MAX_SIZE);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Prepare write parameters
+  qmtopen_write_params_t params = {.client_idx = client_idx, .port = port};
+  strncpy(params.host_name, host_name, sizeof(params.host_name) - 1);
+  params.host_name[sizeof(params.host_name) - 1] = '\0'; // Ensure null termination
+
+  ESP_LOGI(
+      TAG, "Opening MQTT network connection for client %d to %s:%d", client_idx, host_name, port);
+
+  // Send the command
+  qmtopen_write_response_t local_response = {0};
+  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTOPEN,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &params,
+                                                      response ? response : &local_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT open network command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if ((response && response->present.has_result) ||
+      (!response && local_response.present.has_result))
+  {
+    qmtopen_result_t result = response ? response->result : local_response.result;
+
+    if (result != QMTOPEN_RESULT_OPEN_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT open network failed with result: %d (%s)",
+               result,
+               enum_to_str(result, QMTOPEN_RESULT_MAP, QMTOPEN_RESULT_MAP_SIZE));
+      return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "MQTT network connection opened successfully for client %d", client_idx);
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGI(TAG, "MQTT open network command sent successfully, waiting for connection result");
+  }
+
+  return ESP_OK;
+}
+
+// Close a network connection for MQTT client
+esp_err_t bg95_mqtt_close_network(bg95_handle_t*             handle,
+                                  uint8_t                    client_idx,
+                                  qmtclose_write_response_t* response)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTCLOSE_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTCLOSE_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Prepare write parameters
+  qmtclose_write_params_t params = {.client_idx = client_idx};
+
+  ESP_LOGI(TAG, "Closing MQTT network connection for client %d", client_idx);
+
+  // Send the command
+  qmtclose_write_response_t local_response = {0};
+  esp_err_t                 err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCLOSE,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &params,
+                                                      response ? response : &local_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT close network command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if ((response && response->present.has_result) ||
+      (!response && local_response.present.has_result))
+  {
+    qmtclose_result_t result = response ? response->result : local_response.result;
+
+    if (result != QMTCLOSE_RESULT_CLOSE_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT close network failed with result: %d (%s)",
+               result,
+               enum_to_str(result, QMTCLOSE_RESULT_MAP, QMTCLOSE_RESULT_MAP_SIZE));
+      return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "MQTT network connection closed successfully for client %d", client_idx);
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGI(TAG, "MQTT close network command sent successfully, waiting for result");
+  }
+
+  return ESP_OK;
+}
+
+// Check the current connection state of an MQTT client
+esp_err_t bg95_mqtt_query_connection_state(bg95_handle_t*           handle,
+                                           uint8_t                  client_idx,
+                                           qmtconn_read_response_t* status)
+{
+  if (NULL == handle || NULL == status || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTCONN_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTCONN_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Send read command (AT+QMTCONN?) to get current connection state
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTCONN, AT_CMD_TYPE_READ, NULL, status);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get MQTT connection status: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If no status returned but command succeeded, this means no client is connected
+  if (!status->present.has_client_idx || status->client_idx != client_idx)
+  {
+    ESP_LOGD(TAG, "No connection information found for MQTT client %d", client_idx);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  ESP_LOGI(TAG,
+           "MQTT client %d connection state: %d (%s)",
+           client_idx,
+           status->state,
+           enum_to_str(status->state, QMTCONN_STATE_MAP, QMTCONN_STATE_MAP_SIZE));
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_mqtt_connect(bg95_handle_t*            handle,
+                            uint8_t                   client_idx,
+                            const char*               client_id_str,
+                            const char*               username,
+                            const char*               password,
+                            qmtconn_write_response_t* response)
+{
+  if (NULL == handle || NULL == client_id_str || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTCONN_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTCONN_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (strlen(client_id_str) > QMTCONN_CLIENT_ID_MAX_SIZE)
+  {
+    ESP_LOGE(TAG, "Client ID too long (max %d chars)", QMTCONN_CLIENT_ID_MAX_SIZE);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (username != NULL && strlen(username) > QMTCONN_USERNAME_MAX_SIZE)
+  {
+    ESP_LOGE(TAG, "Username too long (max %d chars)", QMTCONN_USERNAME_MAX_SIZE);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (password != NULL && strlen(password) > QMTCONN_PASSWORD_MAX_SIZE)
+  {
+    ESP_LOGE(TAG, "Password too long (max %d chars)", QMTCONN_PASSWORD_MAX_SIZE);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Password can only be provided if username is also provided
+  if (password != NULL && username == NULL)
+  {
+    ESP_LOGE(TAG, "Cannot provide password without username");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Prepare write parameters
+  qmtconn_write_params_t params = {.client_idx = client_idx};
+  strncpy(params.client_id, client_id_str, sizeof(params.client_id) - 1);
+  params.client_id[sizeof(params.client_id) - 1] = '\0'; // Ensure null termination
+
+  if (username != NULL)
+  {
+    params.present.has_username = true;
+    strncpy(params.username, username, sizeof(params.username) - 1);
+    params.username[sizeof(params.username) - 1] = '\0'; // Ensure null termination
+
+    if (password != NULL)
+    {
+      params.present.has_password = true;
+      strncpy(params.password, password, sizeof(params.password) - 1);
+      params.password[sizeof(params.password) - 1] = '\0'; // Ensure null termination
+    }
+  }
+
+  ESP_LOGI(TAG, "Connecting MQTT client %d with client ID '%s'", client_idx, client_id_str);
+
+  // Send the command
+  qmtconn_write_response_t local_response = {0};
+  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTCONN,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &params,
+                                                      response ? response : &local_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT connect command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if ((response && response->present.has_result) ||
+      (!response && local_response.present.has_result))
+  {
+    qmtconn_result_t result = response ? response->result : local_response.result;
+
+    if (result != QMTCONN_RESULT_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT connect operation failed with result: %d (%s)",
+               result,
+               enum_to_str(result, QMTCONN_RESULT_MAP, QMTCONN_RESULT_MAP_SIZE));
+
+      // If we have a return code, log it for more detail
+      if ((response && response->present.has_ret_code) ||
+          (!response && local_response.present.has_ret_code))
+      {
+        qmtconn_ret_code_t ret_code = response ? response->ret_code : local_response.ret_code;
+        ESP_LOGE(TAG,
+                 "MQTT connect return code: %d (%s)",
+                 ret_code,
+                 enum_to_str(ret_code, QMTCONN_RET_CODE_MAP, QMTCONN_RET_CODE_MAP_SIZE));
+      }
+
+      return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "MQTT client %d connected successfully", client_idx);
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGI(TAG, "MQTT connect command sent successfully, waiting for connection result");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t
+bg95_mqtt_disconnect(bg95_handle_t* handle, uint8_t client_idx, qmtdisc_write_response_t* response)
+{
+  if (NULL == handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid handle or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTDISC_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTDISC_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Prepare write parameters
+  qmtdisc_write_params_t params = {.client_idx = client_idx};
+
+  ESP_LOGI(TAG, "Disconnecting MQTT client %d from server", client_idx);
+
+  // Send the command
+  qmtdisc_write_response_t local_response = {0};
+  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                                      &AT_CMD_QMTDISC,
+                                                      AT_CMD_TYPE_WRITE,
+                                                      &params,
+                                                      response ? response : &local_response);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT disconnect command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if ((response && response->present.has_result) ||
+      (!response && local_response.present.has_result))
+  {
+    qmtdisc_result_t result = response ? response->result : local_response.result;
+
+    if (result != QMTDISC_RESULT_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT disconnect failed with result: %d (%s)",
+               result,
+               enum_to_str(result, QMTDISC_RESULT_MAP, QMTDISC_RESULT_MAP_SIZE));
+      return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "MQTT client %d disconnected successfully", client_idx);
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGI(TAG, "MQTT disconnect command sent successfully, waiting for result");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_mqtt_publish_fixed_length(bg95_handle_t*           handle,
+                                         uint8_t                  client_idx,
+                                         uint16_t                 msgid,
+                                         qmtpub_qos_t             qos,
+                                         qmtpub_retain_t          retain,
+                                         const char*              topic,
+                                         const void*              message,
+                                         uint16_t                 message_length,
+                                         qmtpub_write_response_t* response)
+{
+  if (NULL == handle || NULL == topic || NULL == message || message_length == 0 ||
+      !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTPUB_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTPUB_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (message_length > QMTPUB_MSG_MAX_LEN)
+  {
+    ESP_LOGE(TAG, "Message too long: %d bytes (max %d)", message_length, QMTPUB_MSG_MAX_LEN);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // QoS 0 requires msgid to be 0
+  if (qos == QMTPUB_QOS_AT_MOST_ONCE && msgid != 0)
+  {
+    ESP_LOGW(TAG, "QoS 0 requires msgid=0, forcing msgid to 0");
+    msgid = 0;
+  }
+
+  // For QoS 1 and 2, msgid must be non-zero
+  if ((qos == QMTPUB_QOS_AT_LEAST_ONCE || qos == QMTPUB_QOS_EXACTLY_ONCE) && msgid == 0)
+  {
+    ESP_LOGW(TAG, "QoS %d requires non-zero msgid, using msgid=1", qos);
+    msgid = 1;
+  }
+
+  // Prepare write parameters
+  qmtpub_write_params_t params = {.client_idx = client_idx,
+                                  .msgid      = msgid,
+                                  .qos        = qos,
+                                  .retain     = retain,
+                                  .msglen     = message_length};
+
+  strncpy(params.topic, topic, sizeof(params.topic) - 1);
+  params.topic[sizeof(params.topic) - 1] = '\0'; // Ensure null termination
+
+  ESP_LOGD(TAG,
+           "Publishing fixed-length MQTT message on topic '%s' with QoS %d, client %d, msgid %d, "
+           "length %d",
+           topic,
+           qos,
+           client_idx,
+           msgid,
+           message_length);
+
+  // Send the command with data - it is in flight until the module reports the result
+  at_cmd_metrics_t* metrics = handle->at_handler.metrics;
+  at_cmd_metrics_gauge_add(metrics, AT_CMD_METRICS_GAUGE_PUBLISHES_IN_FLIGHT, 1);
+
+  qmtpub_write_response_t local_response = {0};
+  esp_err_t               err            = at_cmd_handler_send_with_prompt(&handle->at_handler,
+                                                  &AT_CMD_QMTPUB,
+                                                  AT_CMD_TYPE_WRITE,
+                                                  &params,
+                                                  message,
+                                                  message_length,
+                                                  response ? response : &local_response);
+
+  at_cmd_metrics_gauge_add(metrics, AT_CMD_METRICS_GAUGE_PUBLISHES_IN_FLIGHT, -1);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT publish command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if ((response && response->present.has_result) ||
+      (!response && local_response.present.has_result))
+  {
+    qmtpub_result_t result = response ? response->result : local_response.result;
+
+    if (result != QMTPUB_RESULT_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT publish failed with result: %d (%s)",
+               result,
+               enum_to_str(result, QMTPUB_RESULT_MAP, QMTPUB_RESULT_MAP_SIZE));
+      return ESP_FAIL;
+    }
+
+    ESP_LOGD(TAG, "MQTT message published successfully");
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGD(TAG, "MQTT publish command sent successfully, waiting for publication result");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_mqtt_subscribe(bg95_handle_t*           handle,
+                              uint8_t                  client_idx,
+                              uint16_t                 msgid,
+                              const char*              topic,
+                              qmtsub_qos_t             qos,
+                              qmtsub_write_response_t* response)
+{
+  // Validate parameters
+  if (NULL == handle || NULL == topic || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTSUB_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTSUB_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (msgid < QMTSUB_MSGID_MIN || msgid > QMTSUB_MSGID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid msgid: %d (must be %d-%d)", msgid, QMTSUB_MSGID_MIN, QMTSUB_MSGID_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (qos > QMTSUB_QOS_EXACTLY_ONCE)
+  {
+    ESP_LOGE(TAG, "Invalid QoS: %d (must be 0-2)", qos);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (topic[0] == '\0' || strlen(topic) >= QMTSUB_TOPIC_MAX_SIZE)
+  {
+    ESP_LOGE(TAG, "Invalid topic: empty or too long (max %d chars)", QMTSUB_TOPIC_MAX_SIZE - 1);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Prepare write parameters
+  qmtsub_write_params_t params = {.client_idx = client_idx, .msgid = msgid, .topic_count = 1};
+
+  // Set the topic and QoS
+  strncpy(params.topics[0].topic, topic, QMTSUB_TOPIC_MAX_SIZE - 1);
+  params.topics[0].topic[QMTSUB_TOPIC_MAX_SIZE - 1] = '\0'; // Ensure null termination
+  params.topics[0].qos                              = qos;
+
+  ESP_LOGI(TAG,
+           "Subscribing MQTT client %d to topic '%s' with QoS %d, msgid %d",
+           client_idx,
+           topic,
+           qos,
+           msgid);
+
+  // Create local response structure if user didn't provide one
+  qmtsub_write_response_t  local_response = {0};
+  qmtsub_write_response_t* resp_ptr       = (response != NULL) ? response : &local_response;
+
+  // Send the command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTSUB, AT_CMD_TYPE_WRITE, &params, resp_ptr);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT subscribe command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if (resp_ptr->present.has_result)
+  {
+    if (resp_ptr->result != QMTSUB_RESULT_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT subscribe failed with result: %d (%s)",
+               resp_ptr->result,
+               enum_to_str(resp_ptr->result, QMTSUB_RESULT_MAP, QMTSUB_RESULT_MAP_SIZE));
+      return ESP_FAIL;
+    }
+
+    if (resp_ptr->present.has_value)
+    {
+      ESP_LOGI(TAG, "MQTT subscription successful, granted QoS: %d", resp_ptr->value);
+    }
+    else
+    {
+      ESP_LOGI(TAG, "MQTT subscription successful");
+    }
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGI(TAG, "MQTT subscribe command sent successfully, waiting for subscription result");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_mqtt_unsubscribe(bg95_handle_t*           handle,
+                                uint8_t                  client_idx,
+                                uint16_t                 msgid,
+                                const char*              topic,
+                                qmtuns_write_response_t* response)
+{
+  // Validate parameters
+  if (NULL == handle || NULL == topic || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (client_idx > QMTUNS_CLIENT_IDX_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTUNS_CLIENT_IDX_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (msgid < QMTUNS_MSGID_MIN || msgid > QMTUNS_MSGID_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid msgid: %d (must be %d-%d)", msgid, QMTUNS_MSGID_MIN, QMTUNS_MSGID_MAX);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (topic[0] == '\0' || strlen(topic) >= QMTUNS_TOPIC_MAX_SIZE)
+  {
+    ESP_LOGE(TAG, "Invalid topic: empty or too long (max %d chars)", QMTUNS_TOPIC_MAX_SIZE - 1);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Prepare write parameters
+  qmtuns_write_params_t params = {.client_idx = client_idx, .msgid = msgid, .topic_count = 1};
+
+  // Set the topic
+  strncpy(params.topics[0], topic, QMTUNS_TOPIC_MAX_SIZE - 1);
+  params.topics[0][QMTUNS_TOPIC_MAX_SIZE - 1] = '\0'; // Ensure null termination
+
+  ESP_LOGI(TAG, "Unsubscribing MQTT client %d from topic '%s', msgid %d", client_idx, topic, msgid);
+
+  // Create local response structure if user didn't provide one
+  qmtuns_write_response_t  local_response = {0};
+  qmtuns_write_response_t* resp_ptr       = (response != NULL) ? response : &local_response;
+
+  // Send the command
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QMTUNS, AT_CMD_TYPE_WRITE, &params, resp_ptr);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to send MQTT unsubscribe command: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // If we got a result code in the immediate response, check if it was successful
+  if (resp_ptr->present.has_result)
+  {
+    if (resp_ptr->result != QMTUNS_RESULT_SUCCESS)
+    {
+      ESP_LOGE(TAG,
+               "MQTT unsubscribe failed with result: %d (%s)",
+               resp_ptr->result,
+               enum_to_str(resp_ptr->result, QMTUNS_RESULT_MAP, QMTUNS_RESULT_MAP_SIZE));
+      return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "MQTT unsubscribe successful");
+  }
+  else
+  {
+    // If no result code in the immediate response, that's expected
+    // The URC with the result will come later, the caller needs to wait for it
+    ESP_LOGI(TAG, "MQTT unsubscribe command sent successfully, waiting for result");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_get_extended_signal_quality(bg95_handle_t*           handle,
+                                           qcsq_execute_response_t* signal_quality)
+{
+  if (!handle || !signal_quality || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Execute QCSQ command to get detailed signal quality
+  esp_err_t err =
+      at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
+                                          &AT_CMD_QCSQ,
+                                          AT_CMD_TYPE_EXECUTE,
+                                          NULL, // No parameters needed for EXECUTE command
+                                          signal_quality);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to get extended signal quality: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Log detailed information based on system mode
+  ESP_LOGD(TAG, "Extended signal quality:");
+  ESP_LOGD(TAG,
+           "  System mode: %s",
+           enum_to_str(signal_quality->sysmode, QCSQ_SYSMODE_MAP, QCSQ_SYSMODE_MAP_SIZE));
+
+  switch (signal_quality->sysmode)
+  {
+    case QCSQ_SYSMODE_NOSERVICE:
+      ESP_LOGD(TAG, "  No service");
+      break;
+
+    case QCSQ_SYSMODE_GSM:
+      if (signal_quality->present.has_value1)
+        ESP_LOGD(TAG, "  GSM RSSI: %d dBm", signal_quality->value1);
+      break;
+
+    case QCSQ_SYSMODE_EMTC:
+      if (signal_quality->present.has_value1)
+        ESP_LOGD(TAG, "  LTE RSSI: %d dBm", signal_quality->value1);
+      if (signal_quality->present.has_value2)
+        ESP_LOGD(TAG, "  LTE RSRP: %d dBm", signal_quality->value2);
+      if (signal_quality->present.has_value3)
+        ESP_LOGD(TAG, "  LTE SINR: %.1f dB", qcsq_sinr_to_db(signal_quality->value3));
+      if (signal_quality->present.has_value4)
+        ESP_LOGD(TAG, "  LTE RSRQ: %d dB", signal_quality->value4);
+      break;
+
+    case QCSQ_SYSMODE_NBIOT:
+      if (signal_quality->present.has_value1)
+        ESP_LOGD(TAG, "  NB-IoT RSSI: %d dBm", signal_quality->value1);
+      if (signal_quality->present.has_value2)
+        ESP_LOGD(TAG, "  NB-IoT RSRP: %d dBm", signal_quality->value2);
+      if (signal_quality->present.has_value3)
+        ESP_LOGD(TAG, "  NB-IoT SINR: %.1f dB", qcsq_sinr_to_db(signal_quality->value3));
+      if (signal_quality->present.has_value4)
+        ESP_LOGD(TAG, "  NB-IoT RSRQ: %d dB", signal_quality->value4);
+      break;
+  }
+
+  return ESP_OK;
+}
+
+// ------------------------- POWER SAVING (PSM / eDRX) -----------------------------
+
+esp_err_t
+bg95_psm_request(bg95_handle_t* handle, uint32_t periodic_tau_s, uint32_t active_time_s)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cpsms_write_params_t params = {.mode    = CPSMS_MODE_ENABLE,
+                                 .present = {.has_periodic_tau = true, .has_active_time = true}};
+
+  esp_err_t err =
+      cpsms_encode_periodic_tau(periodic_tau_s, params.periodic_tau, sizeof(params.periodic_tau));
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Periodic TAU of %lu s can not be encoded", (unsigned long) periodic_tau_s);
+    return err;
+  }
+
+  err = cpsms_encode_active_time(active_time_s, params.active_time, sizeof(params.active_time));
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Active time of %lu s can not be encoded", (unsigned long) active_time_s);
+    return err;
+  }
+
+  err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CPSMS, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to request PSM: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Track what was actually sent - the encoding rounds up to the timer resolution
+  bg95_power_saving_t* ps = &handle->power_saving;
+  cpsms_decode_periodic_tau(params.periodic_tau, &ps->requested_periodic_tau_s);
+  cpsms_decode_active_time(params.active_time, &ps->requested_active_time_s);
+  ps->psm_requested     = true;
+  ps->psm_granted_known = false;
+
+  ESP_LOGI(TAG,
+           "PSM requested: TAU %lu s (\"%s\"), active time %lu s (\"%s\")",
+           (unsigned long) ps->requested_periodic_tau_s,
+           params.periodic_tau,
+           (unsigned long) ps->requested_active_time_s,
+           params.active_time);
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_disable(bg95_handle_t* handle)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cpsms_write_params_t params = {.mode = CPSMS_MODE_DISABLE};
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CPSMS, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to disable PSM: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  handle->power_saving.psm_requested     = false;
+  handle->power_saving.psm_granted_known = false;
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_query_granted(bg95_handle_t* handle,
+                                 uint32_t*      periodic_tau_s,
+                                 uint32_t*      active_time_s)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cereg_read_response_t cereg = {0};
+  esp_err_t             err   = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CEREG, AT_CMD_TYPE_READ, NULL, &cereg);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to read registration status: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // The granted timers are only reported with n=4 (or 5) - switch to it for one read, then put back
+  // the n the application uses
+  if (cereg.n < CEREG_N_ENABLE_URC_PSM)
+  {
+    cereg_write_params_t restore_params = {.n = cereg.n};
+    cereg_write_params_t cereg_params   = {.n = CEREG_N_ENABLE_URC_PSM};
+    err                                 = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_CEREG, AT_CMD_TYPE_WRITE, &cereg_params, NULL);
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "Failed to enable CEREG PSM reporting: %s", esp_err_to_name(err));
+      return err;
+    }
+
+    err = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_CEREG, AT_CMD_TYPE_READ, NULL, &cereg);
+
+    esp_err_t restore_err = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_CEREG, AT_CMD_TYPE_WRITE, &restore_params, NULL);
+    if (restore_err != ESP_OK)
+    {
+      ESP_LOGW(TAG,
+               "Failed to restore CEREG n=%d: %s",
+               restore_params.n,
+               esp_err_to_name(restore_err));
+    }
+
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "Failed to read registration status: %s", esp_err_to_name(err));
+      return err;
+    }
+  }
+
+  if (!cereg.present.has_active_time || !cereg.present.has_periodic_tau)
+  {
+    ESP_LOGW(TAG,
+             "Network has not provided PSM timers (%s)",
+             enum_to_str(cereg.stat, CEREG_STAT_MAP, CEREG_STAT_MAP_SIZE));
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  if (cpsms_decode_periodic_tau(cereg.periodic_tau, &ps->granted_periodic_tau_s) != ESP_OK ||
+      cpsms_decode_active_time(cereg.active_time, &ps->granted_active_time_s) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Invalid PSM timers in CEREG response");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  ps->psm_granted_known = true;
+
+  ESP_LOGI(TAG,
+           "PSM granted: TAU \"%s\", active time \"%s\"",
+           cereg.periodic_tau,
+           cereg.active_time);
+
+  if (periodic_tau_s)
+  {
+    *periodic_tau_s = ps->granted_periodic_tau_s;
+  }
+  if (active_time_s)
+  {
+    *active_time_s = ps->granted_active_time_s;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_verify(bg95_handle_t* handle, bool* matches_request)
+{
+  if (!handle || !matches_request)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  if (!ps->psm_requested)
+  {
+    ESP_LOGE(TAG, "PSM has not been requested");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  esp_err_t err = bg95_psm_query_granted(handle, NULL, NULL);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  if (ps->granted_active_time_s == CPSMS_TIMER_DEACTIVATED ||
+      ps->granted_periodic_tau_s == CPSMS_TIMER_DEACTIVATED)
+  {
+    ESP_LOGW(TAG, "Network did not grant PSM");
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  *matches_request = ps->granted_periodic_tau_s == ps->requested_periodic_tau_s &&
+                     ps->granted_active_time_s == ps->requested_active_time_s;
+
+  if (!*matches_request)
+  {
+    ESP_LOGW(TAG,
+             "Network changed PSM timers: TAU %lu -> %lu s, active time %lu -> %lu s",
+             (unsigned long) ps->requested_periodic_tau_s,
+             (unsigned long) ps->granted_periodic_tau_s,
+             (unsigned long) ps->requested_active_time_s,
+             (unsigned long) ps->granted_active_time_s);
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t
+bg95_edrx_request(bg95_handle_t* handle, cedrxs_act_type_t act_type, uint32_t cycle_ms)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cedrxs_write_params_t params = {.mode     = CEDRXS_MODE_ENABLE,
+                                  .act_type = act_type,
+                                  .present  = {.has_act_type = true, .has_edrx_value = true}};
+
+  esp_err_t err = cedrxs_cycle_ms_to_value(act_type, cycle_ms, &params.edrx_value);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "No eDRX cycle available for AcT %d", act_type);
+    return err;
+  }
+
+  err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CEDRXS, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to request eDRX: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  bg95_power_saving_t* ps     = &handle->power_saving;
+  ps->edrx_requested          = true;
+  ps->edrx_act_type           = act_type;
+  ps->requested_edrx_cycle_ms = cedrxs_value_to_cycle_ms(act_type, params.edrx_value);
+  ps->edrx_granted_known      = false;
+
+  ESP_LOGI(TAG,
+           "eDRX requested: %s, cycle %lu ms",
+           enum_to_str(act_type, CEDRXS_ACT_TYPE_MAP, CEDRXS_ACT_TYPE_MAP_SIZE),
+           (unsigned long) ps->requested_edrx_cycle_ms);
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_edrx_disable(bg95_handle_t* handle, cedrxs_act_type_t act_type)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cedrxs_write_params_t params = {
+      .mode = CEDRXS_MODE_DISABLE, .act_type = act_type, .present = {.has_act_type = true}};
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CEDRXS, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to disable eDRX: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  handle->power_saving.edrx_requested     = false;
+  handle->power_saving.edrx_granted_known = false;
+  return ESP_OK;
+}
+
+esp_err_t
+bg95_edrx_query_granted(bg95_handle_t* handle, uint32_t* cycle_ms, uint32_t* paging_window_ms)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cedrxrdp_execute_response_t rdp = {0};
+  esp_err_t                   err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CEDRXRDP, AT_CMD_TYPE_EXECUTE, NULL, &rdp);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to read eDRX dynamic params: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  bg95_power_saving_t* ps      = &handle->power_saving;
+  ps->edrx_granted_known       = true;
+  ps->granted_edrx_cycle_ms    = 0;
+  ps->granted_paging_window_ms = 0;
+
+  if (rdp.act_type == CEDRXS_ACT_TYPE_NOT_USED || !rdp.present.has_nw_edrx_value)
+  {
+    ESP_LOGW(TAG, "Network is not using eDRX");
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  ps->granted_edrx_cycle_ms = cedrxs_value_to_cycle_ms(rdp.act_type, rdp.nw_edrx_value);
+  if (rdp.present.has_paging_time_window)
+  {
+    ps->granted_paging_window_ms = cedrxs_ptw_to_ms(rdp.act_type, rdp.paging_time_window);
+  }
+
+  ESP_LOGI(TAG,
+           "eDRX granted: cycle %lu ms, paging window %lu ms",
+           (unsigned long) ps->granted_edrx_cycle_ms,
+           (unsigned long) ps->granted_paging_window_ms);
+
+  if (cycle_ms)
+  {
+    *cycle_ms = ps->granted_edrx_cycle_ms;
+  }
+  if (paging_window_ms)
+  {
+    *paging_window_ms = ps->granted_paging_window_ms;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_edrx_verify(bg95_handle_t* handle, bool* matches_request)
+{
+  if (!handle || !matches_request)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  if (!ps->edrx_requested)
+  {
+    ESP_LOGE(TAG, "eDRX has not been requested");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  esp_err_t err = bg95_edrx_query_granted(handle, NULL, NULL);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  *matches_request = ps->granted_edrx_cycle_ms == ps->requested_edrx_cycle_ms;
+
+  if (!*matches_request)
+  {
+    ESP_LOGW(TAG,
+             "Network changed eDRX cycle: %lu -> %lu ms",
+             (unsigned long) ps->requested_edrx_cycle_ms,
+             (unsigned long) ps->granted_edrx_cycle_ms);
+  }
+
+  return ESP_OK;
+}
+
+// Time since the module last answered a command - the PSM active timer (re)starts from there
+static uint32_t bg95_ms_since_last_activity(bg95_handle_t* handle)
+{
+  return pdTICKS_TO_MS(xTaskGetTickCount()) - handle->at_handler.last_activity_ms;
+}
+
+esp_err_t bg95_psm_ms_until_sleep(bg95_handle_t* handle, uint32_t* ms)
+{
+  if (!handle || !ms)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  if (!ps->psm_granted_known || ps->granted_active_time_s == CPSMS_TIMER_DEACTIVATED)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  uint64_t active_ms = (uint64_t) ps->granted_active_time_s * 1000U;
+  uint32_t elapsed   = bg95_ms_since_last_activity(handle);
+
+  *ms = (elapsed >= active_ms) ? 0 : (uint32_t) (active_ms - elapsed);
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_ms_until_next_wake(bg95_handle_t* handle, uint32_t* ms)
+{
+  if (!handle || !ms)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  if (!ps->psm_granted_known || ps->granted_periodic_tau_s == CPSMS_TIMER_DEACTIVATED)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // The periodic TAU timer runs from the moment the module goes idle, like the active timer
+  uint64_t tau_ms  = (uint64_t) ps->granted_periodic_tau_s * 1000U;
+  uint32_t elapsed = bg95_ms_since_last_activity(handle);
+
+  if (elapsed >= tau_ms)
+  {
+    *ms = 0;
+  }
+  else
+  {
+    uint64_t remaining = tau_ms - elapsed;
+    *ms                = (remaining > UINT32_MAX) ? UINT32_MAX : (uint32_t) remaining;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_queue_publish(bg95_handle_t*  handle,
+                                 uint8_t         client_idx,
+                                 uint16_t        msgid,
+                                 qmtpub_qos_t    qos,
+                                 qmtpub_retain_t retain,
+                                 const char*     topic,
+                                 const void*     message,
+                                 uint16_t        message_length)
+{
+  if (!handle || !topic || !message || message_length == 0 || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  size_t topic_len = strlen(topic);
+  if (topic_len >= QMTPUB_TOPIC_MAX_SIZE || message_length > BG95_PSM_PUBLISH_MAX_MESSAGE_LEN)
+  {
+    ESP_LOGE(TAG,
+             "Publish does not fit a queue slot (topic %d, message %d bytes)",
+             (int) topic_len,
+             message_length);
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  xSemaphoreTakeRecursive(handle->at_handler.lock, portMAX_DELAY);
+  if (ps->publish_queue_count >= BG95_PSM_PUBLISH_QUEUE_LEN)
+  {
+    xSemaphoreGiveRecursive(handle->at_handler.lock);
+    ESP_LOGW(TAG, "PSM publish queue is full (%d)", BG95_PSM_PUBLISH_QUEUE_LEN);
+    return ESP_ERR_NO_MEM;
+  }
+
+  // Copied - the caller's buffers need not outlive the call
+  bg95_queued_publish_t* pub = &ps->publish_queue[ps->publish_queue_count++];
+  pub->client_idx            = client_idx;
+  pub->msgid                 = msgid;
+  pub->qos                   = qos;
+  pub->retain                = retain;
+  pub->message_length        = message_length;
+  memcpy(pub->topic, topic, topic_len + 1);
+  memcpy(pub->message, message, message_length);
+  xSemaphoreGiveRecursive(handle->at_handler.lock);
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_flush_publish_queue(bg95_handle_t* handle, uint8_t* published)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps   = &handle->power_saving;
+  uint8_t              sent = 0;
+  esp_err_t            err  = ESP_OK;
+
+  // Send everything back to back so the whole queue fits in a single active time window. The lock
+  // keeps publishes queued meanwhile out until the queue has been compacted
+  xSemaphoreTakeRecursive(handle->at_handler.lock, portMAX_DELAY);
+  at_cmd_handler_begin_batch(&handle->at_handler);
+  while (sent < ps->publish_queue_count)
+  {
+    const bg95_queued_publish_t* pub = &ps->publish_queue[sent];
+
+    err = bg95_mqtt_publish_fixed_length(handle,
+                                         pub->client_idx,
+                                         pub->msgid,
+                                         pub->qos,
+                                         pub->retain,
+                                         pub->topic,
+                                         pub->message,
+                                         pub->message_length,
+                                         NULL);
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "Queued publish %d failed: %s", sent, esp_err_to_name(err));
+      break;
+    }
+    sent++;
+  }
+  at_cmd_handler_end_batch(&handle->at_handler);
+
+  // Keep whatever was not sent at the front of the queue
+  memmove(&ps->publish_queue[0],
+          &ps->publish_queue[sent],
+          (ps->publish_queue_count - sent) * sizeof(bg95_queued_publish_t));
+  ps->publish_queue_count -= sent;
+  xSemaphoreGiveRecursive(handle->at_handler.lock);
+
+  if (published)
+  {
+    *published = sent;
+  }
+
+  return err;
+}
+
+// Whether the module is at a wake boundary - awake, or about to wake for its periodic TAU
+static bool bg95_psm_flush_is_due(bg95_handle_t* handle)
+{
+  uint32_t ms = 0;
+  if (bg95_psm_ms_until_sleep(handle, &ms) != ESP_OK || ms > 0)
+  {
+    return true; // Awake, or PSM not granted (yet) - the module answers right away
+  }
+  return bg95_psm_ms_until_next_wake(handle, &ms) == ESP_OK && ms == 0;
+}
+
+static void bg95_psm_flush_task(void* arg)
+{
+  bg95_handle_t*       handle = (bg95_handle_t*) arg;
+  bg95_power_saving_t* ps     = &handle->power_saving;
+
+  while (!atomic_load(&ps->auto_flush_stop))
+  {
+    uint32_t wait_ms = BG95_PSM_FLUSH_POLL_MS;
+
+    xSemaphoreTakeRecursive(handle->at_handler.lock, portMAX_DELAY);
+    bool queued = ps->publish_queue_count > 0;
+    xSemaphoreGiveRecursive(handle->at_handler.lock);
+
+    if (queued && bg95_psm_flush_is_due(handle))
+    {
+      uint8_t   published = 0;
+      esp_err_t err       = bg95_psm_flush_publish_queue(handle, &published);
+      if (err != ESP_OK)
+      {
+        ESP_LOGW(TAG,
+                 "Automatic flush sent %d, retrying later: %s",
+                 published,
+                 esp_err_to_name(err));
+        wait_ms = BG95_PSM_FLUSH_RETRY_MS;
+      }
+    }
+
+    // In short steps, so a stop request is seen quickly
+    for (uint32_t waited = 0; waited < wait_ms && !atomic_load(&ps->auto_flush_stop);
+         waited += BG95_PSM_FLUSH_POLL_MS)
+    {
+      vTaskDelay(pdMS_TO_TICKS(BG95_PSM_FLUSH_POLL_MS));
+    }
+  }
+
+  ps->flush_task = NULL;
+  atomic_store(&ps->auto_flush_running, false);
+  vTaskDelete(NULL);
+}
+
+esp_err_t bg95_psm_start_auto_flush(bg95_handle_t* handle)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps   = &handle->power_saving;
+  bool                 idle = false;
+  if (!atomic_compare_exchange_strong(&ps->auto_flush_running, &idle, true))
+  {
+    ESP_LOGE(TAG, "Automatic flush already running");
+    return ESP_ERR_INVALID_STATE;
+  }
+  atomic_store(&ps->auto_flush_stop, false);
+
+  if (xTaskCreate(bg95_psm_flush_task,
+                  "bg95_psm_flush",
+                  BG95_PSM_FLUSH_TASK_STACK_SIZE,
+                  handle,
+                  BG95_PSM_FLUSH_TASK_PRIORITY,
+                  &ps->flush_task) != pdPASS)
+  {
+    ESP_LOGE(TAG, "Failed to create PSM flush task");
+    atomic_store(&ps->auto_flush_running, false);
+    return ESP_ERR_NO_MEM;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_psm_stop_auto_flush(bg95_handle_t* handle)
+{
+  if (!handle)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_power_saving_t* ps = &handle->power_saving;
+  if (!atomic_load(&ps->auto_flush_running))
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  atomic_store(&ps->auto_flush_stop, true);
+  while (atomic_load(&ps->auto_flush_running))
+  {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  return ESP_OK;
+}
+
+// ------------------------- UART SLEEP (QSCLK / DTR) -----------------------------
+
+// Module sleeps while DTR is HIGH and wakes once it is pulled LOW
+static esp_err_t bg95_set_dtr_wake_line(bool awake, void* context)
+{
+  bg95_handle_t* handle = (bg95_handle_t*) context;
+  return gpio_set_level((gpio_num_t) handle->dtr_gpio_num, awake ? 0 : 1);
+}
+
+esp_err_t bg95_sleep_enable(bg95_handle_t* handle)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (handle->dtr_gpio_num == BG95_GPIO_NOT_USED)
+  {
+    ESP_LOGE(TAG, "UART sleep requires a DTR pin");
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  qsclk_write_params_t params = {.mode = QSCLK_SLEEP_ENABLE};
+  esp_err_t            err    = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QSCLK, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to enable sleep mode: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  return at_cmd_handler_sleep_enable(&handle->at_handler, bg95_set_dtr_wake_line, handle);
+}
+
+esp_err_t bg95_sleep_disable(bg95_handle_t* handle)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
 
+  // Wake (and keep awake) before telling the module to stop sleeping
+  esp_err_t err = at_cmd_handler_sleep_disable(&handle->at_handler);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to set MQTT keep-alive time: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to wake module: %s", esp_err_to_name(err));
+    return err;
   }
-  else
+
+  qsclk_write_params_t params = {.mode = QSCLK_SLEEP_DISABLE};
+  err                         = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QSCLK, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
   {
-    ESP_LOGI(TAG,
-             "Successfully set MQTT keep-alive time to %d seconds for client %d",
-             keep_alive_time,
-             client_idx);
+    ESP_LOGE(TAG, "Failed to disable sleep mode: %s", esp_err_to_name(err));
+    return err;
   }
 
-  return err;
+  return ESP_OK;
 }
 
-// Query MQTT keepalive configuration
-esp_err_t bg95_mqtt_config_query_keepalive(bg95_handle_t*                     handle,
-                                           uint8_t                            client_idx,
-                                           qmtcfg_write_keepalive_response_t* response)
+esp_err_t bg95_sleep_begin_batch(bg95_handle_t* handle)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  if (!handle)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
     return ESP_ERR_INVALID_ARG;
   }
+  return at_cmd_handler_begin_batch(&handle->at_handler);
+}
 
-  if (client_idx > 5)
+esp_err_t bg95_sleep_end_batch(bg95_handle_t* handle)
+{
+  if (!handle)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
     return ESP_ERR_INVALID_ARG;
   }
+  return at_cmd_handler_end_batch(&handle->at_handler);
+}
 
-  qmtcfg_write_params_t write_params                        = {0};
-  write_params.type                                         = QMTCFG_TYPE_KEEPALIVE;
-  write_params.params.keepalive.client_idx                  = client_idx;
-  write_params.params.keepalive.present.has_keep_alive_time = false; // Query mode
-
-  qmtcfg_write_response_t write_response = {0};
-
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+esp_err_t bg95_get_sleep_stats(bg95_handle_t* handle, at_cmd_sleep_stats_t* stats)
+{
+  if (!handle || !stats)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
 
+  esp_err_t err = at_cmd_handler_get_sleep_stats(&handle->at_handler, stats);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to query MQTT keep-alive time: %s", esp_err_to_name(err));
     return err;
   }
 
-  // Copy the relevant part of the response
-  *response = write_response.response.keepalive;
-
-  // Log the result
-  if (response->present.has_keep_alive_time)
-  {
-    ESP_LOGI(TAG,
-             "MQTT keep-alive time for client %d: %d seconds",
-             client_idx,
-             response->keep_alive_time);
-  }
-  else
-  {
-    ESP_LOGW(TAG, "Keep-alive time information not available in response");
-  }
+  ESP_LOGI(TAG,
+           "Sleep stats: %lu cmds, %lu wakes (%lu saved by queued cmds), avg wake %lu ms (max %lu "
+           "ms), awake %lu ms, asleep %lu ms",
+           (unsigned long) stats->cmd_count,
+           (unsigned long) stats->wake_count,
+           (unsigned long) stats->kept_awake_count,
+           (unsigned long) at_cmd_handler_avg_wake_latency_ms(&handle->at_handler),
+           (unsigned long) stats->wake_latency_max_ms,
+           (unsigned long) stats->awake_total_ms,
+           (unsigned long) stats->asleep_total_ms);
 
   return ESP_OK;
 }
 
-// Set MQTT session type
-esp_err_t bg95_mqtt_config_set_session(bg95_handle_t*         handle,
-                                       uint8_t                client_idx,
-                                       qmtcfg_clean_session_t clean_session)
+// ------------------------------ METRICS ---------------------------------
+
+esp_err_t bg95_enable_stats(bg95_handle_t* handle, at_cmd_metrics_t* metrics)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!handle)
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
     return ESP_ERR_INVALID_ARG;
   }
+  return at_cmd_handler_set_metrics(&handle->at_handler, metrics);
+}
 
-  if (client_idx > 5)
+esp_err_t bg95_get_stats(bg95_handle_t*             handle,
+                         at_cmd_metrics_snapshot_t* snapshot,
+                         at_cmd_metrics_entry_t*    entries,
+                         uint16_t                   max_entries,
+                         bool                       reset)
+{
+  if (!handle || !snapshot)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (clean_session != QMTCFG_CLEAN_SESSION_DISABLE && clean_session != QMTCFG_CLEAN_SESSION_ENABLE)
+  at_cmd_metrics_t* metrics = handle->at_handler.metrics;
+  if (!metrics)
   {
-    ESP_LOGE(TAG, "Invalid clean session value: %d", clean_session);
-    return ESP_ERR_INVALID_ARG;
+    return ESP_ERR_INVALID_STATE;
   }
+  return at_cmd_metrics_snapshot(metrics, snapshot, entries, max_entries, reset);
+}
 
-  qmtcfg_write_params_t write_params                    = {0};
-  write_params.type                                     = QMTCFG_TYPE_SESSION;
-  write_params.params.session.client_idx                = client_idx;
-  write_params.params.session.clean_session             = clean_session;
-  write_params.params.session.present.has_clean_session = true;
+// ------------------------- UART LINK (IPR / IFC) -----------------------------
 
-  // Set command only expects OK response, no data
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCFG,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &write_params,
-                                                      NULL); // No response data needed
+#define BG95_UART_LINK_SWITCH_DELAY_MS 100 // Module needs a moment after OK to change its UART
+#define BG95_UART_LINK_PROBE_ATTEMPTS 3
 
-  if (err != ESP_OK)
-  {
-    ESP_LOGE(TAG, "Failed to set MQTT session type: %s", esp_err_to_name(err));
-  }
-  else
+static bool bg95_uart_link_probe(bg95_handle_t* handle)
+{
+  for (int attempt = 0; attempt < BG95_UART_LINK_PROBE_ATTEMPTS; attempt++)
   {
-    ESP_LOGI(TAG,
-             "Successfully set MQTT session type to %s for client %d",
-             clean_session == QMTCFG_CLEAN_SESSION_ENABLE ? "clean (discard previous info)"
-                                                          : "persistent (store subscriptions)",
-             client_idx);
+    if (at_cmd_handler_send_and_receive_cmd(
+            &handle->at_handler, &AT_CMD_AT, AT_CMD_TYPE_EXECUTE, NULL, NULL) == ESP_OK)
+    {
+      return true;
+    }
   }
+  return false;
+}
 
-  return err;
+static esp_err_t bg95_uart_link_send_ifc(bg95_handle_t* handle, bool hw_flow_control)
+{
+  ifc_flow_control_t flow   = hw_flow_control ? IFC_FLOW_CONTROL_RTS_CTS : IFC_FLOW_CONTROL_NONE;
+  ifc_write_params_t params = {.dce_by_dte = flow, .dte_by_dce = flow};
+  return at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_IFC, AT_CMD_TYPE_WRITE, &params, NULL);
 }
 
-// Query MQTT session configuration
-esp_err_t bg95_mqtt_config_query_session(bg95_handle_t*                   handle,
-                                         uint8_t                          client_idx,
-                                         qmtcfg_write_session_response_t* response)
+static esp_err_t bg95_uart_link_send_ipr(bg95_handle_t* handle, uint32_t baud_rate, bool save)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  ipr_write_params_t params = {.rate = baud_rate, .save = save};
+  return at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_IPR, AT_CMD_TYPE_WRITE, &params, NULL);
+}
+
+// The reply to IFC / IPR can be lost to the switch itself, so only an ERROR (the module refused,
+// nothing changed) stops the switch - whether the link works is decided by the probe afterwards
+static esp_err_t bg95_uart_link_switch_flow_control(bg95_handle_t* handle, bool hw_flow_control)
+{
+  const bg95_uart_interface_t* uart = &handle->at_handler.uart;
+
+  esp_err_t err = bg95_uart_link_send_ifc(handle, hw_flow_control);
+  if (err == ESP_FAIL)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG, "Module refused to change the flow control");
+    return err;
   }
 
-  if (client_idx > 5)
+  err = uart->set_flow_control(hw_flow_control, uart->context);
+  if (err == ESP_OK && bg95_uart_link_probe(handle))
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    handle->uart_link.hw_flow_control = hw_flow_control;
+    return ESP_OK;
   }
 
-  qmtcfg_write_params_t write_params                    = {0};
-  write_params.type                                     = QMTCFG_TYPE_SESSION;
-  write_params.params.session.client_idx                = client_idx;
-  write_params.params.session.present.has_clean_session = false; // Query mode
-
-  qmtcfg_write_response_t write_response = {0};
+  ESP_LOGW(TAG, "No answer with flow control %s - falling back", hw_flow_control ? "on" : "off");
+  uart->set_flow_control(handle->uart_link.hw_flow_control, uart->context);
+  bg95_uart_link_send_ifc(handle, handle->uart_link.hw_flow_control);
+  if (!bg95_uart_link_probe(handle))
+  {
+    ESP_LOGE(TAG, "Module does not answer after the flow control fallback");
+  }
+  return (err != ESP_OK) ? err : ESP_ERR_TIMEOUT;
+}
 
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+static esp_err_t bg95_uart_link_switch_baud_rate(bg95_handle_t* handle, uint32_t baud_rate)
+{
+  const bg95_uart_interface_t* uart     = &handle->at_handler.uart;
+  uint32_t                     old_rate = handle->uart_link.baud_rate;
 
-  if (err != ESP_OK)
+  esp_err_t err = bg95_uart_link_send_ipr(handle, baud_rate, false);
+  if (err == ESP_FAIL)
   {
-    ESP_LOGE(TAG, "Failed to query MQTT session type: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Module refused baud rate %lu", (unsigned long) baud_rate);
     return err;
   }
+  vTaskDelay(pdMS_TO_TICKS(BG95_UART_LINK_SWITCH_DELAY_MS));
 
-  // Copy the relevant part of the response
-  *response = write_response.response.session;
-
-  // Log the result
-  if (response->present.has_clean_session)
+  err = uart->set_baud_rate(baud_rate, uart->context);
+  if (err == ESP_OK && bg95_uart_link_probe(handle))
   {
-    ESP_LOGI(TAG,
-             "MQTT session type for client %d: %s",
-             client_idx,
-             response->clean_session == QMTCFG_CLEAN_SESSION_ENABLE
-                 ? "Clean (discard information)"
-                 : "Persistent (store subscriptions)");
+    handle->uart_link.baud_rate = baud_rate;
+    return ESP_OK;
   }
-  else
+
+  ESP_LOGW(TAG,
+           "No answer at %lu baud - falling back to %lu",
+           (unsigned long) baud_rate,
+           (unsigned long) old_rate);
+  uart->set_baud_rate(old_rate, uart->context);
+  if (bg95_uart_link_probe(handle))
   {
-    ESP_LOGW(TAG, "Session type information not available in response");
+    return (err != ESP_OK) ? err : ESP_ERR_TIMEOUT;
   }
 
-  return ESP_OK;
+  // The module did switch, but the link does not work at the new rate - switch it back blindly
+  uart->set_baud_rate(baud_rate, uart->context);
+  bg95_uart_link_send_ipr(handle, old_rate, false);
+  vTaskDelay(pdMS_TO_TICKS(BG95_UART_LINK_SWITCH_DELAY_MS));
+  uart->set_baud_rate(old_rate, uart->context);
+  if (!bg95_uart_link_probe(handle))
+  {
+    ESP_LOGE(TAG, "Module does not answer after the baud rate fallback");
+  }
+  return (err != ESP_OK) ? err : ESP_ERR_TIMEOUT;
 }
 
-// Set MQTT timeout parameters
-esp_err_t bg95_mqtt_config_set_timeout(bg95_handle_t*          handle,
-                                       uint8_t                 client_idx,
-                                       uint8_t                 pkt_timeout,
-                                       uint8_t                 retry_times,
-                                       qmtcfg_timeout_notice_t timeout_notice)
+esp_err_t bg95_set_uart_link(bg95_handle_t* handle, uint32_t baud_rate, bool hw_flow_control)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!handle || !handle->initialized || !ipr_rate_is_valid(baud_rate))
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  if (handle->cmux)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG, "Can not change the UART link while CMUX is enabled");
+    return ESP_ERR_INVALID_STATE;
   }
 
-  if (pkt_timeout < 1 || pkt_timeout > 60)
+  const bg95_uart_interface_t* uart = &handle->at_handler.uart;
+  if (!uart->set_baud_rate || (hw_flow_control && !uart->set_flow_control))
   {
-    ESP_LOGE(TAG, "Invalid packet timeout: %d (must be 1-60)", pkt_timeout);
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG, "UART interface can not change its baud rate / flow control");
+    return ESP_ERR_NOT_SUPPORTED;
   }
 
-  if (retry_times > 10)
+  // Flow control first - it makes the faster rate safe against RX overruns
+  esp_err_t err = ESP_OK;
+  at_cmd_handler_begin_batch(&handle->at_handler);
+  if (hw_flow_control != handle->uart_link.hw_flow_control)
   {
-    ESP_LOGE(TAG, "Invalid retry times: %d (must be 0-10)", retry_times);
-    return ESP_ERR_INVALID_ARG;
+    err = bg95_uart_link_switch_flow_control(handle, hw_flow_control);
   }
-
-  if (timeout_notice != QMTCFG_TIMEOUT_NOTICE_DISABLE &&
-      timeout_notice != QMTCFG_TIMEOUT_NOTICE_ENABLE)
+  if (err == ESP_OK && baud_rate != handle->uart_link.baud_rate)
   {
-    ESP_LOGE(TAG, "Invalid timeout notice value: %d", timeout_notice);
-    return ESP_ERR_INVALID_ARG;
+    err = bg95_uart_link_switch_baud_rate(handle, baud_rate);
   }
 
-  qmtcfg_write_params_t write_params                     = {0};
-  write_params.type                                      = QMTCFG_TYPE_TIMEOUT;
-  write_params.params.timeout.client_idx                 = client_idx;
-  write_params.params.timeout.pkt_timeout                = pkt_timeout;
-  write_params.params.timeout.retry_times                = retry_times;
-  write_params.params.timeout.timeout_notice             = timeout_notice;
-  write_params.params.timeout.present.has_pkt_timeout    = true;
-  write_params.params.timeout.present.has_retry_times    = true;
-  write_params.params.timeout.present.has_timeout_notice = true;
-
-  // Set command only expects OK response, no data
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCFG,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &write_params,
-                                                      NULL); // No response data needed
+  // Only a verified link is saved - AT&W stores the flow control along with the rate
+  if (err == ESP_OK)
+  {
+    err = bg95_uart_link_send_ipr(handle, baud_rate, true);
+  }
+  at_cmd_handler_end_batch(&handle->at_handler);
 
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to set MQTT timeout parameters: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to change the UART link: %s", esp_err_to_name(err));
+    return err;
   }
-  else
+
+  err = bg95_persist_save(BG95_PERSIST_KEY_UART_LINK, &handle->uart_link, sizeof(bg95_uart_link_t));
+  if (err != ESP_OK)
   {
-    ESP_LOGI(TAG,
-             "Successfully set MQTT timeout parameters for client %d: "
-             "packet timeout=%d, retry times=%d, timeout notice=%d",
-             client_idx,
-             pkt_timeout,
-             retry_times,
-             timeout_notice);
+    ESP_LOGW(TAG, "UART link works, but could not be saved on the host: %s", esp_err_to_name(err));
+    return err;
   }
 
-  return err;
+  ESP_LOGI(TAG,
+           "UART link: %lu baud, flow control %s",
+           (unsigned long) handle->uart_link.baud_rate,
+           handle->uart_link.hw_flow_control ? "RTS/CTS" : "off");
+  return ESP_OK;
 }
 
-// Query MQTT timeout configuration
-esp_err_t bg95_mqtt_config_query_timeout(bg95_handle_t*                   handle,
-                                         uint8_t                          client_idx,
-                                         qmtcfg_write_timeout_response_t* response)
+esp_err_t bg95_load_uart_link(bg95_uart_link_t* link)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  if (!link)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  esp_err_t err = bg95_persist_load(BG95_PERSIST_KEY_UART_LINK, link, sizeof(*link));
+  if (err == ESP_ERR_INVALID_SIZE ||
+      (err == ESP_OK &&
+       (link->version != BG95_UART_LINK_VERSION || !ipr_rate_is_valid(link->baud_rate))))
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGW(TAG, "Ignoring invalid UART link");
+    return ESP_ERR_NOT_FOUND;
   }
 
-  qmtcfg_write_params_t write_params     = {0};
-  write_params.type                      = QMTCFG_TYPE_TIMEOUT;
-  write_params.params.timeout.client_idx = client_idx;
-  // Set all present flags to false for query mode
-  write_params.params.timeout.present.has_pkt_timeout    = false;
-  write_params.params.timeout.present.has_retry_times    = false;
-  write_params.params.timeout.present.has_timeout_notice = false;
+  return err;
+}
 
-  qmtcfg_write_response_t write_response = {0};
+// ------------------------- TCP/IP SOCKETS -----------------------------
 
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+#define BG95_URC_QIURC "+QIURC: "
 
-  if (err != ESP_OK)
+// Socket URCs: +QIURC: "recv",<connectID> / +QIURC: "closed",<connectID> /
+//              +QIURC: "pdpdeact",<contextID>
+static void bg95_urc_handler(const char* line, size_t len, void* context)
+{
+  bg95_handle_t* handle     = (bg95_handle_t*) context;
+  size_t         prefix_len = strlen(BG95_URC_QIURC);
+
+  if (len <= prefix_len || strncmp(line, BG95_URC_QIURC, prefix_len) != 0)
   {
-    ESP_LOGE(TAG, "Failed to query MQTT timeout parameters: %s", esp_err_to_name(err));
-    return err;
+    return;
   }
 
-  // Copy the relevant part of the response
-  *response = write_response.response.timeout;
+  at_tokenizer_t tok;
+  at_field_t     type;
+  at_field_t     id;
+  if (at_tokenizer_init_span(&tok, line + prefix_len, len - prefix_len) != ESP_OK ||
+      at_tokenizer_next(&tok, &type) != ESP_OK)
+  {
+    return;
+  }
 
-  // Log the result
-  ESP_LOGI(TAG, "MQTT timeout parameters for client %d:", client_idx);
+  bool is_recv     = at_field_equals(&type, "recv");
+  bool is_closed   = at_field_equals(&type, "closed");
+  bool is_pdpdeact = at_field_equals(&type, "pdpdeact");
+  if (!is_recv && !is_closed && !is_pdpdeact)
+  {
+    return; // Other URCs (e.g. "dnsgip") are not about a socket
+  }
 
-  if (response->present.has_pkt_timeout)
+  int32_t value;
+  if (at_tokenizer_next(&tok, &id) != ESP_OK || at_field_get_int(&id, &value) != ESP_OK)
   {
-    ESP_LOGI(TAG, "  Packet timeout: %d seconds", response->pkt_timeout);
+    ESP_LOGW(TAG, "Malformed socket URC: %.*s", (int) len, line);
+    return;
+  }
+
+  if (is_recv || is_closed)
+  {
+    if (value < 0 || value >= BG95_SOCKET_MAX)
+    {
+      ESP_LOGW(TAG, "Socket URC for unknown connect ID %ld", (long) value);
+      return;
+    }
+
+    bg95_socket_t*      socket = &handle->sockets.sockets[value];
+    bg95_socket_event_t event;
+    if (is_recv)
+    {
+      atomic_store(&socket->data_pending, true);
+      event = BG95_SOCKET_EVENT_DATA;
+    }
+    else
+    {
+      atomic_store(&socket->remote_closed, true);
+      event = BG95_SOCKET_EVENT_CLOSED;
+    }
+
+    if (handle->sockets.on_event)
+    {
+      handle->sockets.on_event((uint8_t) value, event, handle->sockets.event_context);
+    }
   }
-
-  if (response->present.has_retry_times)
+  else
   {
-    ESP_LOGI(TAG, "  Retry times: %d", response->retry_times);
+    // Every socket on the context is gone
+    for (uint8_t i = 0; i < BG95_SOCKET_MAX; i++)
+    {
+      bg95_socket_t* socket = &handle->sockets.sockets[i];
+      if (socket->open && socket->context_id == value)
+      {
+        atomic_store(&socket->remote_closed, true);
+        if (handle->sockets.on_event)
+        {
+          handle->sockets.on_event(i, BG95_SOCKET_EVENT_CLOSED, handle->sockets.event_context);
+        }
+      }
+    }
   }
+}
 
-  if (response->present.has_timeout_notice)
+esp_err_t bg95_socket_set_event_callback(bg95_handle_t*       handle,
+                                         bg95_socket_event_cb on_event,
+                                         void*                context)
+{
+  if (!handle || !handle->initialized)
   {
-    ESP_LOGI(TAG,
-             "  Timeout notice: %s",
-             response->timeout_notice == QMTCFG_TIMEOUT_NOTICE_ENABLE ? "Enabled" : "Disabled");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
   }
 
+  // The callback runs from the URC handler, which holds the AT handler lock
+  xSemaphoreTakeRecursive(handle->at_handler.lock, portMAX_DELAY);
+  handle->sockets.on_event      = on_event;
+  handle->sockets.event_context = context;
+  xSemaphoreGiveRecursive(handle->at_handler.lock);
   return ESP_OK;
 }
 
-// Set MQTT will configuration
-esp_err_t bg95_mqtt_config_set_will(bg95_handle_t*       handle,
-                                    uint8_t              client_idx,
-                                    qmtcfg_will_flag_t   will_flag,
-                                    qmtcfg_will_qos_t    will_qos,
-                                    qmtcfg_will_retain_t will_retain,
-                                    const char*          will_topic,
-                                    const char*          will_message)
+esp_err_t bg95_socket_open(bg95_handle_t*           handle,
+                           uint8_t                  context_id,
+                           uint8_t                  connect_id,
+                           qiopen_service_type_t    service_type,
+                           const char*              host,
+                           uint16_t                 remote_port,
+                           qiopen_write_response_t* response)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!handle || !host || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  if (connect_id >= BG95_SOCKET_MAX)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    ESP_LOGE(TAG, "Invalid connect_id: %d (must be 0-%d)", connect_id, BG95_SOCKET_MAX - 1);
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (will_flag != QMTCFG_WILL_FLAG_IGNORE && will_flag != QMTCFG_WILL_FLAG_REQUIRE)
+  if (strlen(host) > QIOPEN_HOST_MAX_SIZE)
   {
-    ESP_LOGE(TAG, "Invalid will flag value: %d", will_flag);
+    ESP_LOGE(TAG, "Host too long (max %d chars)", QIOPEN_HOST_MAX_SIZE);
     return ESP_ERR_INVALID_ARG;
   }
 
-  qmtcfg_write_params_t write_params             = {0};
-  write_params.type                              = QMTCFG_TYPE_WILL;
-  write_params.params.will.client_idx            = client_idx;
-  write_params.params.will.will_flag             = will_flag;
-  write_params.params.will.present.has_will_flag = true;
+  bg95_socket_t* socket = &handle->sockets.sockets[connect_id];
+  if (socket->open)
+  {
+    ESP_LOGE(TAG, "Socket %d is already open", connect_id);
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  // If will flag is REQUIRE, additional parameters are needed
-  if (will_flag == QMTCFG_WILL_FLAG_REQUIRE)
+  qiopen_write_params_t params = {.context_id   = context_id,
+                                  .connect_id   = connect_id,
+                                  .service_type = service_type,
+                                  .remote_port  = remote_port};
+  strncpy(params.host, host, sizeof(params.host) - 1);
+  params.host[sizeof(params.host) - 1] = '\0'; // Ensure null termination
+
+  ESP_LOGI(TAG,
+           "Opening %s socket %d to %s:%d",
+           enum_to_str(service_type, QIOPEN_SERVICE_TYPE_MAP, QIOPEN_SERVICE_TYPE_MAP_SIZE),
+           connect_id,
+           host,
+           remote_port);
+
+  qiopen_write_response_t  local_response = {0};
+  qiopen_write_response_t* open_response  = response ? response : &local_response;
+  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QIOPEN, AT_CMD_TYPE_WRITE, &params, open_response);
+  if (err != ESP_OK)
   {
-    if (will_qos > QMTCFG_WILL_QOS_2)
-    {
-      ESP_LOGE(TAG, "Invalid will QoS value: %d", will_qos);
-      return ESP_ERR_INVALID_ARG;
-    }
+    ESP_LOGE(TAG, "Failed to send socket open command: %s", esp_err_to_name(err));
+    return err;
+  }
 
-    if (will_retain != QMTCFG_WILL_RETAIN_DISABLE && will_retain != QMTCFG_WILL_RETAIN_ENABLE)
-    {
-      ESP_LOGE(TAG, "Invalid will retain value: %d", will_retain);
-      return ESP_ERR_INVALID_ARG;
-    }
+  if (!open_response->present.has_result || open_response->result != QIOPEN_RESULT_SUCCESS)
+  {
+    ESP_LOGE(TAG, "Socket %d failed to open, error: %d", connect_id, open_response->result);
+    return ESP_FAIL;
+  }
 
-    if (will_topic == NULL || will_message == NULL)
-    {
-      ESP_LOGE(TAG, "Will topic and message must be provided when will flag is REQUIRE");
-      return ESP_ERR_INVALID_ARG;
-    }
+  memset(socket, 0, sizeof(bg95_socket_t));
+  socket->open         = true;
+  socket->context_id   = context_id;
+  socket->service_type = service_type;
 
-    write_params.params.will.will_qos    = will_qos;
-    write_params.params.will.will_retain = will_retain;
-    strncpy(write_params.params.will.will_topic,
-            will_topic,
-            sizeof(write_params.params.will.will_topic) - 1);
-    strncpy(write_params.params.will.will_message,
-            will_message,
-            sizeof(write_params.params.will.will_message) - 1);
+  ESP_LOGI(TAG, "Socket %d opened", connect_id);
+  return ESP_OK;
+}
 
-    write_params.params.will.present.has_will_qos     = true;
-    write_params.params.will.present.has_will_retain  = true;
-    write_params.params.will.present.has_will_topic   = true;
-    write_params.params.will.present.has_will_message = true;
+esp_err_t bg95_socket_close(bg95_handle_t* handle, uint8_t connect_id)
+{
+  if (!handle || !handle->initialized || connect_id >= BG95_SOCKET_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // Set command only expects OK response, no data
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCFG,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &write_params,
-                                                      NULL); // No response data needed
-
+  qiclose_write_params_t params = {.connect_id = connect_id};
+  esp_err_t              err    = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QICLOSE, AT_CMD_TYPE_WRITE, &params, NULL);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to set MQTT will configuration: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to close socket %d: %s", connect_id, esp_err_to_name(err));
+    return err;
   }
-  else
+
+  bg95_socket_t* socket = &handle->sockets.sockets[connect_id];
+  ESP_LOGI(TAG,
+           "Socket %d closed (%lu bytes sent, %lu bytes received)",
+           connect_id,
+           (unsigned long) socket->bytes_sent,
+           (unsigned long) socket->bytes_received);
+  memset(socket, 0, sizeof(bg95_socket_t));
+  if (handle->sockets.transparent_open && handle->sockets.transparent_connect_id == connect_id)
   {
-    if (will_flag == QMTCFG_WILL_FLAG_IGNORE)
+    handle->sockets.transparent_open = false;
+  }
+  return ESP_OK;
+}
+
+esp_err_t bg95_socket_send(bg95_handle_t* handle, uint8_t connect_id, const void* data, size_t len)
+{
+  if (!handle || !data || len == 0 || !handle->initialized || connect_id >= BG95_SOCKET_MAX)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_socket_t* socket = &handle->sockets.sockets[connect_id];
+  if (!socket->open || atomic_load(&socket->remote_closed))
+  {
+    ESP_LOGE(TAG, "Socket %d is not connected", connect_id);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // All chunks share one wake interval
+  at_cmd_handler_begin_batch(&handle->at_handler);
+
+  const char* bytes = (const char*) data;
+  size_t      sent  = 0;
+  esp_err_t   err   = ESP_OK;
+  while (sent < len)
+  {
+    size_t chunk = len - sent;
+    if (chunk > QISEND_DATA_MAX_LEN)
     {
-      ESP_LOGI(TAG, "Successfully disabled MQTT will for client %d", client_idx);
+      chunk = QISEND_DATA_MAX_LEN;
     }
-    else
+
+    qisend_write_params_t params = {.connect_id = connect_id, .send_length = (uint16_t) chunk};
+    err                          = at_cmd_handler_send_with_prompt(&handle->at_handler,
+                                          &AT_CMD_QISEND,
+                                          AT_CMD_TYPE_WRITE,
+                                          &params,
+                                          bytes + sent,
+                                          chunk,
+                                          NULL);
+    if (err != ESP_OK)
     {
-      ESP_LOGI(TAG,
-               "Successfully set MQTT will for client %d: QoS=%d, Retain=%d, "
-               "Topic='%s', Message='%s'",
-               client_idx,
-               will_qos,
-               will_retain,
-               will_topic,
-               will_message);
+      // SEND FAIL means the send buffer of the module is full - the caller can retry later
+      ESP_LOGE(TAG,
+               "Socket %d send failed after %d of %d bytes: %s",
+               connect_id,
+               (int) sent,
+               (int) len,
+               esp_err_to_name(err));
+      break;
     }
+
+    sent += chunk;
+    socket->bytes_sent += chunk;
   }
 
+  at_cmd_handler_end_batch(&handle->at_handler);
   return err;
 }
 
-// Query MQTT will configuration
-esp_err_t bg95_mqtt_config_query_will(bg95_handle_t*                handle,
-                                      uint8_t                       client_idx,
-                                      qmtcfg_write_will_response_t* response)
+esp_err_t bg95_socket_recv(bg95_handle_t* handle,
+                           uint8_t        connect_id,
+                           void*          buffer,
+                           size_t         buffer_size,
+                           size_t*        received)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  if (!handle || !buffer || buffer_size == 0 || !received || !handle->initialized ||
+      connect_id >= BG95_SOCKET_MAX)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > 5)
+  *received             = 0;
+  bg95_socket_t* socket = &handle->sockets.sockets[connect_id];
+  if (!socket->open)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG, "Socket %d is not open", connect_id);
+    return ESP_ERR_INVALID_STATE;
   }
 
-  qmtcfg_write_params_t write_params             = {0};
-  write_params.type                              = QMTCFG_TYPE_WILL;
-  write_params.params.will.client_idx            = client_idx;
-  write_params.params.will.present.has_will_flag = false; // Query mode
-
-  qmtcfg_write_response_t write_response = {0};
+  size_t read_length = buffer_size < QIRD_READ_MAX_LEN ? buffer_size : QIRD_READ_MAX_LEN;
 
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+  // Cleared before the read - a 'recv' URC that arrives during or after it sets it again
+  bool was_pending = atomic_exchange(&socket->data_pending, false);
 
+  qird_write_params_t   params = {.connect_id = connect_id, .read_length = (uint16_t) read_length};
+  qird_write_response_t read_response = {0};
+  esp_err_t             err           = at_cmd_handler_send_and_receive_payload(&handle->at_handler,
+                                                          &AT_CMD_QIRD,
+                                                          AT_CMD_TYPE_WRITE,
+                                                          &params,
+                                                          &read_response,
+                                                          qird_locate_payload,
+                                                          buffer,
+                                                          buffer_size,
+                                                          received);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to query MQTT will configuration: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to read socket %d: %s", connect_id, esp_err_to_name(err));
+    if (was_pending)
+    {
+      atomic_store(&socket->data_pending, true);
+    }
     return err;
   }
 
-  // Copy the relevant part of the response
-  *response = write_response.response.will;
-
-  // Log the result
-  if (response->present.has_will_flag)
+  // A full read means the receive buffer of the module may hold more
+  if (*received == read_length)
   {
-    if (response->will_flag == QMTCFG_WILL_FLAG_IGNORE)
-    {
-      ESP_LOGI(TAG, "MQTT will is disabled for client %d", client_idx);
-    }
-    else
-    {
-      ESP_LOGI(TAG, "MQTT will is enabled for client %d", client_idx);
-
-      if (response->present.has_will_qos)
-      {
-        ESP_LOGI(TAG, "  Will QoS: %d", response->will_qos);
-      }
-
-      if (response->present.has_will_retain)
-      {
-        ESP_LOGI(TAG,
-                 "  Will retain: %s",
-                 response->will_retain == QMTCFG_WILL_RETAIN_ENABLE ? "Yes" : "No");
-      }
+    atomic_store(&socket->data_pending, true);
+  }
+  socket->bytes_received += *received;
 
-      if (response->present.has_will_topic)
-      {
-        ESP_LOGI(TAG, "  Will topic: %s", response->will_topic);
-      }
+  return ESP_OK;
+}
 
-      if (response->present.has_will_message)
-      {
-        ESP_LOGI(TAG, "  Will message: %s", response->will_message);
-      }
-    }
-  }
-  else
+bool bg95_socket_data_pending(bg95_handle_t* handle, uint8_t connect_id)
+{
+  if (!handle || connect_id >= BG95_SOCKET_MAX)
   {
-    ESP_LOGW(TAG, "Will configuration information not available in response");
+    return false;
   }
-
-  return ESP_OK;
+  return atomic_load(&handle->sockets.sockets[connect_id].data_pending);
 }
 
-// Set MQTT message receive mode
-esp_err_t bg95_mqtt_config_set_recv_mode(bg95_handle_t*          handle,
-                                         uint8_t                 client_idx,
-                                         qmtcfg_msg_recv_mode_t  msg_recv_mode,
-                                         qmtcfg_msg_len_enable_t msg_len_enable)
+esp_err_t bg95_socket_poll(bg95_handle_t* handle, uint32_t timeout_ms)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!handle || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Invalid handle or driver not initialized");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
+  return at_cmd_handler_poll_urcs(&handle->at_handler, timeout_ms);
+}
 
-  if (client_idx > 5)
+esp_err_t bg95_socket_open_transparent(bg95_handle_t*        handle,
+                                       uint8_t               context_id,
+                                       uint8_t               connect_id,
+                                       qiopen_service_type_t service_type,
+                                       const char*           host,
+                                       uint16_t              remote_port)
+{
+  if (!handle || !host || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (msg_recv_mode != QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC &&
-      msg_recv_mode != QMTCFG_MSG_RECV_MODE_NOT_CONTAIN_IN_URC)
+  if (connect_id >= BG95_SOCKET_MAX)
   {
-    ESP_LOGE(TAG, "Invalid message receive mode: %d", msg_recv_mode);
+    ESP_LOGE(TAG, "Invalid connect_id: %d (must be 0-%d)", connect_id, BG95_SOCKET_MAX - 1);
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (msg_len_enable != QMTCFG_MSG_LEN_DISABLE && msg_len_enable != QMTCFG_MSG_LEN_ENABLE)
+  if (strlen(host) > QIOPEN_HOST_MAX_SIZE)
   {
-    ESP_LOGE(TAG, "Invalid message length enable value: %d", msg_len_enable);
+    ESP_LOGE(TAG, "Host too long (max %d chars)", QIOPEN_HOST_MAX_SIZE);
     return ESP_ERR_INVALID_ARG;
   }
 
-  qmtcfg_write_params_t write_params                       = {0};
-  write_params.type                                        = QMTCFG_TYPE_RECV_MODE;
-  write_params.params.recv_mode.client_idx                 = client_idx;
-  write_params.params.recv_mode.msg_recv_mode              = msg_recv_mode;
-  write_params.params.recv_mode.msg_len_enable             = msg_len_enable;
-  write_params.params.recv_mode.present.has_msg_recv_mode  = true;
-  write_params.params.recv_mode.present.has_msg_len_enable = true;
+  if (handle->sockets.transparent_open || handle->sockets.sockets[connect_id].open)
+  {
+    ESP_LOGE(TAG, "A transparent socket (or socket %d) is already open", connect_id);
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  // Set command only expects OK response, no data
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCFG,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &write_params,
-                                                      NULL); // No response data needed
+  qiopen_write_params_t params = {.context_id   = context_id,
+                                  .connect_id   = connect_id,
+                                  .service_type = service_type,
+                                  .remote_port  = remote_port,
+                                  .local_port   = 0,
+                                  .access_mode  = QIOPEN_ACCESS_MODE_TRANSPARENT};
+  params.present.has_local_port  = true;
+  params.present.has_access_mode = true;
+  strncpy(params.host, host, sizeof(params.host) - 1);
+  params.host[sizeof(params.host) - 1] = '\0'; // Ensure null termination
+
+  ESP_LOGI(TAG, "Opening transparent socket %d to %s:%d", connect_id, host, remote_port);
 
+  // Answers CONNECT (instead of the +QIOPEN URC) once the connection is up
+  esp_err_t err = at_cmd_handler_enter_data_mode(
+      &handle->at_handler, &AT_CMD_QIOPEN, AT_CMD_TYPE_WRITE, &params);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to set MQTT receive mode: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to open transparent socket %d: %s", connect_id, esp_err_to_name(err));
+    return err;
   }
-  else
+
+  bg95_socket_t* socket = &handle->sockets.sockets[connect_id];
+  memset(socket, 0, sizeof(bg95_socket_t));
+  socket->open                           = true;
+  socket->context_id                     = context_id;
+  socket->service_type                   = service_type;
+  socket->access_mode                    = QIOPEN_ACCESS_MODE_TRANSPARENT;
+  handle->sockets.transparent_open       = true;
+  handle->sockets.transparent_connect_id = connect_id;
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_transparent_write(bg95_handle_t* handle, const void* data, size_t len)
+{
+  if (!handle || !data || len == 0 || !handle->initialized || !handle->sockets.transparent_open)
   {
-    ESP_LOGI(TAG,
-             "Successfully set MQTT receive mode for client %d: "
-             "Message %s in URC, Length %s in URC",
-             client_idx,
-             msg_recv_mode == QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC ? "contained" : "not contained",
-             msg_len_enable == QMTCFG_MSG_LEN_ENABLE ? "contained" : "not contained");
+    ESP_LOGE(TAG, "Invalid arguments or no transparent socket open");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = at_cmd_handler_data_write(&handle->at_handler, data, len);
+  if (err == ESP_OK)
+  {
+    handle->sockets.sockets[handle->sockets.transparent_connect_id].bytes_sent += len;
+  }
+  return err;
+}
+
+esp_err_t bg95_transparent_read(bg95_handle_t* handle,
+                                void*          buffer,
+                                size_t         buffer_size,
+                                size_t*        bytes_read,
+                                uint32_t       timeout_ms)
+{
+  if (!handle || !buffer || !bytes_read || !handle->initialized ||
+      !handle->sockets.transparent_open)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or no transparent socket open");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err =
+      at_cmd_handler_data_read(&handle->at_handler, buffer, buffer_size, bytes_read, timeout_ms);
+  if (err != ESP_OK)
+  {
+    return err;
   }
 
-  return err;
+  bg95_socket_t* socket = &handle->sockets.sockets[handle->sockets.transparent_connect_id];
+  socket->bytes_received += *bytes_read;
+
+  // Peer closed the connection (NO CARRIER) - the module is back in command mode
+  if (at_cmd_handler_get_mode(&handle->at_handler) == AT_CMD_MODE_COMMAND)
+  {
+    atomic_store(&socket->remote_closed, true);
+    if (handle->sockets.on_event)
+    {
+      handle->sockets.on_event(handle->sockets.transparent_connect_id,
+                               BG95_SOCKET_EVENT_CLOSED,
+                               handle->sockets.event_context);
+    }
+  }
+
+  return ESP_OK;
 }
 
-// Query MQTT receive mode configuration
-esp_err_t bg95_mqtt_config_query_recv_mode(bg95_handle_t*                     handle,
-                                           uint8_t                            client_idx,
-                                           qmtcfg_write_recv_mode_response_t* response)
+esp_err_t bg95_transparent_exit(bg95_handle_t* handle)
 {
-  if (NULL == handle || !handle->initialized || NULL == response)
+  if (!handle || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Invalid handle, uninitialized driver, or NULL response pointer");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
+  return at_cmd_handler_exit_data_mode(&handle->at_handler);
+}
 
-  if (client_idx > 5)
+esp_err_t bg95_transparent_resume(bg95_handle_t* handle)
+{
+  if (!handle || !handle->initialized || !handle->sockets.transparent_open)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-5)", client_idx);
+    ESP_LOGE(TAG, "Invalid arguments or no transparent socket open");
     return ESP_ERR_INVALID_ARG;
   }
 
-  qmtcfg_write_params_t write_params                       = {0};
-  write_params.type                                        = QMTCFG_TYPE_RECV_MODE;
-  write_params.params.recv_mode.client_idx                 = client_idx;
-  write_params.params.recv_mode.present.has_msg_recv_mode  = false; // Query mode
-  write_params.params.recv_mode.present.has_msg_len_enable = false; // Query mode
+  if (atomic_load(&handle->sockets.sockets[handle->sockets.transparent_connect_id].remote_closed))
+  {
+    ESP_LOGE(TAG, "Transparent socket was closed by the peer");
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  qmtcfg_write_response_t write_response = {0};
+  return at_cmd_handler_resume_data_mode(&handle->at_handler);
+}
 
-  // Send query command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCFG, AT_CMD_TYPE_WRITE, &write_params, &write_response);
+// ------------------------- CMUX (3GPP TS 27.010) -----------------------------
 
-  if (err != ESP_OK)
-  {
-    ESP_LOGE(TAG, "Failed to query MQTT receive mode: %s", esp_err_to_name(err));
-    return err;
+static cmux_port_speed_t bg95_cmux_port_speed(uint32_t baud_rate)
+{
+  switch (baud_rate)
+  {
+    case 9600:
+      return CMUX_PORT_SPEED_9600;
+    case 19200:
+      return CMUX_PORT_SPEED_19200;
+    case 38400:
+      return CMUX_PORT_SPEED_38400;
+    case 57600:
+      return CMUX_PORT_SPEED_57600;
+    case 230400:
+      return CMUX_PORT_SPEED_230400;
+    case 460800:
+      return CMUX_PORT_SPEED_460800;
+    case 921600:
+      return CMUX_PORT_SPEED_921600;
+    default:
+      return CMUX_PORT_SPEED_115200;
   }
+}
 
-  // Copy the relevant part of the response
-  *response = write_response.response.recv_mode;
+esp_err_t bg95_cmux_enable(bg95_handle_t* handle, bg95_cmux_t* cmux, uint8_t num_channels)
+{
+  if (!handle || !handle->initialized || !cmux)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
 
-  // Log the result
-  ESP_LOGI(TAG, "MQTT receive mode for client %d:", client_idx);
+  if (handle->cmux)
+  {
+    ESP_LOGE(TAG, "CMUX already enabled");
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  if (response->present.has_msg_recv_mode)
+  // Port speed must match the current UART baud rate, N1 the largest frame the driver buffers
+  cmux_write_params_t params = {.mode       = CMUX_MODE_BASIC,
+                                .subset     = CMUX_SUBSET_UIH,
+                                .port_speed = bg95_cmux_port_speed(handle->uart_link.baud_rate),
+                                .n1         = BG95_CMUX_MAX_FRAME_DATA,
+                                .present    = {.has_port_speed = true, .has_n1 = true}};
+  esp_err_t           err    = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_CMUX, AT_CMD_TYPE_WRITE, &params, NULL);
+  if (err != ESP_OK)
   {
-    ESP_LOGI(TAG,
-             "  Message receive mode: %s",
-             response->msg_recv_mode == QMTCFG_MSG_RECV_MODE_CONTAIN_IN_URC
-                 ? "Contained in URC"
-                 : "Not contained in URC");
+    ESP_LOGE(TAG, "Failed to enable CMUX: %s", esp_err_to_name(err));
+    return err;
   }
-  else
+
+  err = bg95_cmux_start(cmux, &handle->at_handler.uart, BG95_CMUX_MAX_FRAME_DATA, num_channels);
+  if (err != ESP_OK)
   {
-    ESP_LOGW(TAG, "  Message receive mode information not available");
+    ESP_LOGE(TAG, "Failed to start the multiplexer: %s", esp_err_to_name(err));
+    return err;
   }
 
-  if (response->present.has_msg_len_enable)
+  bg95_uart_interface_t at_channel;
+  err = bg95_cmux_get_channel(cmux, BG95_CMUX_DLCI_AT, &at_channel);
+  if (err == ESP_OK)
   {
-    ESP_LOGI(TAG,
-             "  Message length: %s",
-             response->msg_len_enable == QMTCFG_MSG_LEN_ENABLE ? "Contained in URC"
-                                                               : "Not contained in URC");
+    err = at_cmd_handler_bind_uart(&handle->at_handler, &at_channel);
   }
-  else
+  if (err != ESP_OK)
   {
-    ESP_LOGW(TAG, "  Message length enable information not available");
+    bg95_cmux_stop(cmux);
+    return err;
   }
 
+  handle->cmux = cmux;
   return ESP_OK;
 }
 
-// Get current MQTT network connection status
-esp_err_t bg95_mqtt_network_open_status(bg95_handle_t*           handle,
-                                        uint8_t                  client_idx,
-                                        qmtopen_read_response_t* status)
+esp_err_t bg95_cmux_bind_at_channel(bg95_handle_t* handle, uint8_t dlci)
 {
-  if (NULL == handle || NULL == status || !handle->initialized)
+  if (!handle || !handle->initialized || !handle->cmux)
   {
-    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    ESP_LOGE(TAG, "Invalid arguments or CMUX not enabled");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > QMTOPEN_CLIENT_IDX_MAX)
+  bg95_uart_interface_t channel;
+  esp_err_t             err = bg95_cmux_get_channel(handle->cmux, dlci, &channel);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTOPEN_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
+    return err;
   }
 
-  // Send read command (AT+QMTOPEN?) to get current connections
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTOPEN, AT_CMD_TYPE_READ, NULL, status);
+  return at_cmd_handler_bind_uart(&handle->at_handler, &channel);
+}
 
-  if (err != ESP_OK)
+esp_err_t bg95_cmux_disable(bg95_handle_t* handle)
+{
+  if (!handle || !handle->cmux)
   {
-    ESP_LOGE(TAG, "Failed to get MQTT network connection status: %s", esp_err_to_name(err));
-    return err;
+    ESP_LOGE(TAG, "Invalid arguments or CMUX not enabled");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // Check if we got info for the requested client_idx
-  if (!status->present.has_client_idx || status->client_idx != client_idx)
+  // The rx task has to be running to see the channels being confirmed closed
+  bg95_cmux_t* cmux = handle->cmux;
+  esp_err_t    err  = bg95_cmux_stop(cmux);
+  if (err != ESP_OK)
   {
-    ESP_LOGW(TAG, "No connection info found for MQTT client %d", client_idx);
-    return ESP_ERR_NOT_FOUND;
+    ESP_LOGW(TAG, "Multiplexer did not stop cleanly: %s", esp_err_to_name(err));
   }
 
-  ESP_LOGI(TAG,
-           "MQTT client %d connected to %s:%d",
-           status->client_idx,
-           status->host_name,
-           status->port);
-
-  return ESP_OK;
+  handle->cmux = NULL;
+  return at_cmd_handler_bind_uart(&handle->at_handler, &cmux->physical);
 }
 
-// Open a network connection for MQTT client
-esp_err_t bg95_mqtt_open_network(bg95_handle_t*            handle,
-                                 uint8_t                   client_idx,
-                                 const char*               host_name,
-                                 uint16_t                  port,
-                                 qmtopen_write_response_t* response)
+// ------------------------------ SSL CONTEXTS ---------------------------------
+
+static esp_err_t bg95_ssl_set(bg95_handle_t* handle, const qsslcfg_write_params_t* params)
 {
-  if (NULL == handle || NULL == host_name || !handle->initialized)
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, params, NULL);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG,
+             "Failed to set SSL context %d %s: %s",
+             params->ctx_id,
+             enum_to_str(params->type, QSSLCFG_TYPE_MAP, QSSLCFG_TYPE_MAP_SIZE),
+             esp_err_to_name(err));
   }
+  return err;
+}
 
-  if (client_idx > QMTOPEN_CLIENT_IDX_MAX)
+static esp_err_t bg95_ssl_set_path(bg95_handle_t* handle,
+                                   uint8_t        ctx_id,
+                                   qsslcfg_type_t type,
+                                   const char*    path)
+{
+  qsslcfg_write_params_t params = {.type = type, .ctx_id = ctx_id, .present = {.has_value = true}};
+  if (strlen(path) > QSSLCFG_PATH_MAX_LEN)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTOPEN_CLIENT_IDX_MAX);
+    ESP_LOGE(TAG, "Certificate path too long: %s", path);
     return ESP_ERR_INVALID_ARG;
   }
+  strcpy(params.value.path, path);
+  return bg95_ssl_set(handle, &params);
+}
 
-  if (port > QMTOPEN_PORT_MAX)
+esp_err_t
+bg95_ssl_configure(bg95_handle_t* handle, uint8_t ctx_id, const bg95_ssl_config_t* config)
+{
+  if (!handle || !config || !handle->initialized || ctx_id > QSSLCFG_CTX_ID_MAX)
   {
-    ESP_LOGE(TAG, "Invalid port: %d (must be 0-%d)", port, QMTOPEN_PORT_MAX);
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (strlen(host_name) > QMTOPEN_HOST_NAME_MAX_SIZE)
+  if ((config->seclevel >= QSSLCFG_SECLEVEL_SERVER && !config->cacert_path) ||
+      (config->seclevel == QSSLCFG_SECLEVEL_SERVER_CLIENT &&
+       (!config->client_cert_path || !config->client_key_path)))
   {
-    ESP_LOGE(TAG, "Host name too long (max %d chars)", QMTOPEN_HOST_NAME_MAX_SIZE);
+    ESP_LOGE(TAG, "Certificates missing for security level %d", config->seclevel);
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Prepare write parameters
-  qmtopen_write_params_t params = {.client_idx = client_idx, .port = port};
-  strncpy(params.host_name, host_name, sizeof(params.host_name) - 1);
-  params.host_name[sizeof(params.host_name) - 1] = '\0'; // Ensure null termination
+  at_cmd_handler_begin_batch(&handle->at_handler);
 
-  ESP_LOGI(
-      TAG, "Opening MQTT network connection for client %d to %s:%d", client_idx, host_name, port);
+  qsslcfg_write_params_t params = {
+      .type = QSSLCFG_TYPE_SSLVERSION, .ctx_id = ctx_id, .present = {.has_value = true}};
+  params.value.sslversion = config->version;
+  esp_err_t err           = bg95_ssl_set(handle, &params);
 
-  // Send the command
-  qmtopen_write_response_t local_response = {0};
-  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTOPEN,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &params,
-                                                      response ? response : &local_response);
+  if (err == ESP_OK)
+  {
+    params.type              = QSSLCFG_TYPE_CIPHERSUITE;
+    params.value.ciphersuite = config->cipher_suite;
+    err                      = bg95_ssl_set(handle, &params);
+  }
 
-  if (err != ESP_OK)
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT open network command: %s", esp_err_to_name(err));
-    return err;
+    params.type           = QSSLCFG_TYPE_SECLEVEL;
+    params.value.seclevel = config->seclevel;
+    err                   = bg95_ssl_set(handle, &params);
   }
 
-  // If we got a result code in the immediate response, check if it was successful
-  if ((response && response->present.has_result) ||
-      (!response && local_response.present.has_result))
+  if (err == ESP_OK && config->seclevel >= QSSLCFG_SECLEVEL_SERVER)
   {
-    qmtopen_result_t result = response ? response->result : local_response.result;
+    err = bg95_ssl_set_path(handle, ctx_id, QSSLCFG_TYPE_CACERT, config->cacert_path);
+  }
 
-    if (result != QMTOPEN_RESULT_OPEN_SUCCESS)
+  if (err == ESP_OK && config->seclevel == QSSLCFG_SECLEVEL_SERVER_CLIENT)
+  {
+    err = bg95_ssl_set_path(handle, ctx_id, QSSLCFG_TYPE_CLIENTCERT, config->client_cert_path);
+    if (err == ESP_OK)
     {
-      ESP_LOGE(TAG,
-               "MQTT open network failed with result: %d (%s)",
-               result,
-               enum_to_str(result, QMTOPEN_RESULT_MAP, QMTOPEN_RESULT_MAP_SIZE));
-      return ESP_FAIL;
+      err = bg95_ssl_set_path(handle, ctx_id, QSSLCFG_TYPE_CLIENTKEY, config->client_key_path);
     }
+  }
 
-    ESP_LOGI(TAG, "MQTT network connection opened successfully for client %d", client_idx);
+  if (err == ESP_OK && config->negotiate_time_s)
+  {
+    params.type                   = QSSLCFG_TYPE_NEGOTIATETIME;
+    params.value.negotiate_time_s = config->negotiate_time_s;
+    err                           = bg95_ssl_set(handle, &params);
   }
-  else
+
+  // Boolean settings
+  const struct
   {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT open network command sent successfully, waiting for connection result");
+    qsslcfg_type_t type;
+    bool           enable;
+  } flags[] = {{QSSLCFG_TYPE_IGNORELOCALTIME, config->ignore_local_time},
+               {QSSLCFG_TYPE_SNI, config->sni},
+               {QSSLCFG_TYPE_SESSION_CACHE, config->session_resumption}};
+  for (size_t i = 0; err == ESP_OK && i < sizeof(flags) / sizeof(flags[0]); i++)
+  {
+    params.type         = flags[i].type;
+    params.value.enable = flags[i].enable;
+    err                 = bg95_ssl_set(handle, &params);
   }
 
-  return ESP_OK;
+  at_cmd_handler_end_batch(&handle->at_handler);
+
+  if (err == ESP_OK)
+  {
+    ESP_LOGI(TAG,
+             "SSL context %d configured (%s, cipher 0x%04X, session resumption %s)",
+             ctx_id,
+             enum_to_str(config->version, QSSLCFG_SSLVERSION_MAP, QSSLCFG_SSLVERSION_MAP_SIZE),
+             config->cipher_suite,
+             config->session_resumption ? "on" : "off");
+  }
+  return err;
 }
 
-// Close a network connection for MQTT client
-esp_err_t bg95_mqtt_close_network(bg95_handle_t*             handle,
-                                  uint8_t                    client_idx,
-                                  qmtclose_write_response_t* response)
+esp_err_t bg95_ssl_get(bg95_handle_t*   handle,
+                       uint8_t          ctx_id,
+                       qsslcfg_type_t   type,
+                       qsslcfg_value_t* value)
 {
-  if (NULL == handle || !handle->initialized)
+  if (!handle || !value || !handle->initialized || ctx_id > QSSLCFG_CTX_ID_MAX)
   {
-    ESP_LOGE(TAG, "Invalid handle or handle not initialized");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > QMTCLOSE_CLIENT_IDX_MAX)
+  qsslcfg_write_params_t   params   = {.type = type, .ctx_id = ctx_id};
+  qsslcfg_write_response_t response = {0};
+
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QSSLCFG, AT_CMD_TYPE_WRITE, &params, &response);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTCLOSE_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG,
+             "Failed to read SSL context %d %s: %s",
+             ctx_id,
+             enum_to_str(type, QSSLCFG_TYPE_MAP, QSSLCFG_TYPE_MAP_SIZE),
+             esp_err_to_name(err));
+    return err;
   }
 
-  // Prepare write parameters
-  qmtclose_write_params_t params = {.client_idx = client_idx};
+  // A query must return the requested setting
+  if (!response.has_data || response.type != type || response.ctx_id != ctx_id)
+  {
+    ESP_LOGE(TAG, "QSSLCFG query returned no matching data");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
 
-  ESP_LOGI(TAG, "Closing MQTT network connection for client %d", client_idx);
+  *value = response.value;
+  return ESP_OK;
+}
 
-  // Send the command
-  qmtclose_write_response_t local_response = {0};
-  esp_err_t                 err = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCLOSE,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &params,
-                                                      response ? response : &local_response);
+// ------------------------------ HTTP(S) CLIENT ---------------------------------
 
-  if (err != ESP_OK)
+esp_err_t bg95_http_configure(bg95_handle_t* handle, const bg95_http_config_t* config)
+{
+  if (!handle || !config || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT close network command: %s", esp_err_to_name(err));
-    return err;
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // If we got a result code in the immediate response, check if it was successful
-  if ((response && response->present.has_result) ||
-      (!response && local_response.present.has_result))
-  {
-    qmtclose_result_t result = response ? response->result : local_response.result;
+  // The module builds the request headers, and QHTTPREAD outputs the body only (no headers)
+  qhttpcfg_write_params_t settings[] = {
+      {.type = QHTTPCFG_TYPE_CONTEXTID, .value = config->context_id},
+      {.type = QHTTPCFG_TYPE_REQUESTHEADER, .value = 0},
+      {.type = QHTTPCFG_TYPE_RESPONSEHEADER, .value = 0},
+      {.type = QHTTPCFG_TYPE_SSLCTXID, .value = config->ssl_context_id},
+      {.type = QHTTPCFG_TYPE_CONTENTTYPE, .value = config->content_type}};
 
-    if (result != QMTCLOSE_RESULT_CLOSE_SUCCESS)
-    {
-      ESP_LOGE(TAG,
-               "MQTT close network failed with result: %d (%s)",
-               result,
-               enum_to_str(result, QMTCLOSE_RESULT_MAP, QMTCLOSE_RESULT_MAP_SIZE));
-      return ESP_FAIL;
-    }
+  at_cmd_handler_begin_batch(&handle->at_handler);
 
-    ESP_LOGI(TAG, "MQTT network connection closed successfully for client %d", client_idx);
+  esp_err_t err = ESP_OK;
+  for (size_t i = 0; i < sizeof(settings) / sizeof(settings[0]) && err == ESP_OK; i++)
+  {
+    err = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_QHTTPCFG, AT_CMD_TYPE_WRITE, &settings[i], NULL);
   }
-  else
+
+  at_cmd_handler_end_batch(&handle->at_handler);
+
+  if (err != ESP_OK)
   {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT close network command sent successfully, waiting for result");
+    ESP_LOGE(TAG, "Failed to configure HTTP(S): %s", esp_err_to_name(err));
+    return err;
   }
 
+  handle->http_config = *config;
   return ESP_OK;
 }
 
-// Check the current connection state of an MQTT client
-esp_err_t bg95_mqtt_query_connection_state(bg95_handle_t*           handle,
-                                           uint8_t                  client_idx,
-                                           qmtconn_read_response_t* status)
+static uint16_t bg95_http_rsptime(const bg95_handle_t* handle)
 {
-  if (NULL == handle || NULL == status || !handle->initialized)
+  return handle->http_config.rsptime_s ? handle->http_config.rsptime_s : QHTTP_RSPTIME_DEFAULT_S;
+}
+
+static esp_err_t bg95_http_set_url(bg95_handle_t* handle, const char* url)
+{
+  size_t url_len = strlen(url);
+  if (url_len == 0 || url_len > QHTTPURL_URL_MAX_LEN)
   {
-    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    ESP_LOGE(TAG, "Invalid URL length: %d", (int) url_len);
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > QMTCONN_CLIENT_IDX_MAX)
+  qhttpurl_write_params_t params = {.url_length   = (uint16_t) url_len,
+                                    .input_time_s = QHTTPURL_INPUT_TIME_DEFAULT_S};
+  esp_err_t               err    = at_cmd_handler_send_with_prompt(
+      &handle->at_handler, &AT_CMD_QHTTPURL, AT_CMD_TYPE_WRITE, &params, url, url_len, NULL);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTCONN_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
+    ESP_LOGE(TAG, "Failed to set URL: %s", esp_err_to_name(err));
+  }
+  return err;
+}
+
+typedef struct
+{
+  bg95_http_sink_fn sink;
+  void*             context;
+  uint32_t          body_length;
+} bg95_http_sink_counter_t;
+
+static esp_err_t bg95_http_count_body(const char* data, size_t len, void* context)
+{
+  bg95_http_sink_counter_t* counter = (bg95_http_sink_counter_t*) context;
+  counter->body_length += len;
+  return counter->sink(data, len, counter->context);
+}
+
+// Check the request result, then stream the body (if a sink is given)
+static esp_err_t bg95_http_finish_request(bg95_handle_t*                handle,
+                                          const qhttp_request_result_t* result,
+                                          bg95_http_sink_fn             sink,
+                                          void*                         sink_context,
+                                          bg95_http_response_t*         response)
+{
+  if (result->err != QHTTP_ERR_OK)
+  {
+    ESP_LOGE(TAG, "HTTP(S) request failed with error %d", result->err);
+    return ESP_FAIL;
   }
 
-  // Send read command (AT+QMTCONN?) to get current connection state
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTCONN, AT_CMD_TYPE_READ, NULL, status);
+  response->http_status        = result->http_status;
+  response->content_length     = result->content_length;
+  response->has_content_length = result->present.has_content_length;
+  ESP_LOGI(TAG, "HTTP(S) status %d", response->http_status);
+
+  if (!sink)
+  {
+    return ESP_OK;
+  }
 
+  bg95_http_sink_counter_t   counter     = {.sink = sink, .context = sink_context};
+  qhttpread_write_params_t   read_params = {.wait_time_s = QHTTPREAD_WAIT_TIME_DEFAULT_S};
+  qhttpread_write_response_t read_result = {0};
+  esp_err_t                  err         = at_cmd_handler_send_and_stream(&handle->at_handler,
+                                                 &AT_CMD_QHTTPREAD,
+                                                 AT_CMD_TYPE_WRITE,
+                                                 &read_params,
+                                                 NULL,
+                                                 &read_result,
+                                                 bg95_http_count_body,
+                                                 &counter);
+  response->body_length = counter.body_length;
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to get MQTT connection status: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to read the response body: %s", esp_err_to_name(err));
     return err;
   }
 
-  // If no status returned but command succeeded, this means no client is connected
-  if (!status->present.has_client_idx || status->client_idx != client_idx)
+  if (read_result.err != QHTTP_ERR_OK)
   {
-    ESP_LOGD(TAG, "No connection information found for MQTT client %d", client_idx);
-    return ESP_ERR_NOT_FOUND;
+    ESP_LOGE(TAG, "Response body read ended with error %d", read_result.err);
+    return ESP_FAIL;
   }
 
-  ESP_LOGI(TAG,
-           "MQTT client %d connection state: %d (%s)",
-           client_idx,
-           status->state,
-           enum_to_str(status->state, QMTCONN_STATE_MAP, QMTCONN_STATE_MAP_SIZE));
-
   return ESP_OK;
 }
 
-esp_err_t bg95_mqtt_connect(bg95_handle_t*            handle,
-                            uint8_t                   client_idx,
-                            const char*               client_id_str,
-                            const char*               username,
-                            const char*               password,
-                            qmtconn_write_response_t* response)
+esp_err_t bg95_http_get(bg95_handle_t*        handle,
+                        const char*           url,
+                        bg95_http_sink_fn     sink,
+                        void*                 sink_context,
+                        bg95_http_response_t* response)
 {
-  if (NULL == handle || NULL == client_id_str || !handle->initialized)
+  if (!handle || !url || !handle->initialized)
   {
     ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > QMTCONN_CLIENT_IDX_MAX)
-  {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTCONN_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
-  }
+  bg95_http_response_t  local_response = {0};
+  bg95_http_response_t* resp           = response ? response : &local_response;
+  memset(resp, 0, sizeof(bg95_http_response_t));
 
-  if (strlen(client_id_str) > QMTCONN_CLIENT_ID_MAX_SIZE)
+  // URL, request and read share one wake interval
+  at_cmd_handler_begin_batch(&handle->at_handler);
+
+  esp_err_t err = bg95_http_set_url(handle, url);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Client ID too long (max %d chars)", QMTCONN_CLIENT_ID_MAX_SIZE);
-    return ESP_ERR_INVALID_ARG;
+    qhttpget_write_params_t   params = {.rsptime_s = bg95_http_rsptime(handle)};
+    qhttpget_write_response_t result = {0};
+    err                              = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_QHTTPGET, AT_CMD_TYPE_WRITE, &params, &result);
+    if (err == ESP_OK)
+    {
+      err = bg95_http_finish_request(handle, &result, sink, sink_context, resp);
+    }
   }
 
-  if (username != NULL && strlen(username) > QMTCONN_USERNAME_MAX_SIZE)
+  at_cmd_handler_end_batch(&handle->at_handler);
+  return err;
+}
+
+esp_err_t bg95_http_get_range(bg95_handle_t*        handle,
+                              const char*           url,
+                              uint32_t              offset,
+                              uint32_t              len,
+                              bg95_http_sink_fn     sink,
+                              void*                 sink_context,
+                              bg95_http_response_t* response)
+{
+  if (!handle || !url || len == 0 || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Username too long (max %d chars)", QMTCONN_USERNAME_MAX_SIZE);
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (password != NULL && strlen(password) > QMTCONN_PASSWORD_MAX_SIZE)
+  bg95_http_response_t  local_response = {0};
+  bg95_http_response_t* resp           = response ? response : &local_response;
+  memset(resp, 0, sizeof(bg95_http_response_t));
+
+  at_cmd_handler_begin_batch(&handle->at_handler);
+
+  esp_err_t err = bg95_http_set_url(handle, url);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Password too long (max %d chars)", QMTCONN_PASSWORD_MAX_SIZE);
-    return ESP_ERR_INVALID_ARG;
+    qhttpgetex_write_params_t   params = {.rsptime_s      = bg95_http_rsptime(handle),
+                                          .start_position = offset,
+                                          .read_len       = len};
+    qhttpgetex_write_response_t result = {0};
+    err                                = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_QHTTPGETEX, AT_CMD_TYPE_WRITE, &params, &result);
+    if (err == ESP_OK)
+    {
+      err = bg95_http_finish_request(handle, &result, sink, sink_context, resp);
+    }
   }
 
-  // Password can only be provided if username is also provided
-  if (password != NULL && username == NULL)
+  at_cmd_handler_end_batch(&handle->at_handler);
+  return err;
+}
+
+// Either 'body' or 'source' is used
+static esp_err_t bg95_http_post_common(bg95_handle_t*        handle,
+                                       const char*           url,
+                                       const void*           body,
+                                       bg95_http_source_fn   source,
+                                       void*                 source_context,
+                                       size_t                body_len,
+                                       bg95_http_sink_fn     sink,
+                                       void*                 sink_context,
+                                       bg95_http_response_t* response)
+{
+  if (body_len == 0 || body_len > QHTTPPOST_DATA_MAX_LEN)
   {
-    ESP_LOGE(TAG, "Cannot provide password without username");
+    ESP_LOGE(TAG, "Invalid body length: %d", (int) body_len);
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Prepare write parameters
-  qmtconn_write_params_t params = {.client_idx = client_idx};
-  strncpy(params.client_id, client_id_str, sizeof(params.client_id) - 1);
-  params.client_id[sizeof(params.client_id) - 1] = '\0'; // Ensure null termination
+  bg95_http_response_t  local_response = {0};
+  bg95_http_response_t* resp           = response ? response : &local_response;
+  memset(resp, 0, sizeof(bg95_http_response_t));
 
-  if (username != NULL)
+  at_cmd_handler_begin_batch(&handle->at_handler);
+
+  esp_err_t err = bg95_http_set_url(handle, url);
+  if (err == ESP_OK)
   {
-    params.present.has_username = true;
-    strncpy(params.username, username, sizeof(params.username) - 1);
-    params.username[sizeof(params.username) - 1] = '\0'; // Ensure null termination
+    qhttppost_write_params_t   params = {.data_length  = (uint32_t) body_len,
+                                         .input_time_s = QHTTPPOST_INPUT_TIME_DEFAULT_S,
+                                         .rsptime_s    = bg95_http_rsptime(handle)};
+    qhttppost_write_response_t result = {0};
+    if (source)
+    {
+      err = at_cmd_handler_send_with_prompt_stream(&handle->at_handler,
+                                                   &AT_CMD_QHTTPPOST,
+                                                   AT_CMD_TYPE_WRITE,
+                                                   &params,
+                                                   source,
+                                                   source_context,
+                                                   body_len,
+                                                   &result);
+    }
+    else
+    {
+      err = at_cmd_handler_send_with_prompt(&handle->at_handler,
+                                            &AT_CMD_QHTTPPOST,
+                                            AT_CMD_TYPE_WRITE,
+                                            &params,
+                                            body,
+                                            body_len,
+                                            &result);
+    }
 
-    if (password != NULL)
+    if (err == ESP_OK)
     {
-      params.present.has_password = true;
-      strncpy(params.password, password, sizeof(params.password) - 1);
-      params.password[sizeof(params.password) - 1] = '\0'; // Ensure null termination
+      err = bg95_http_finish_request(handle, &result, sink, sink_context, resp);
     }
   }
 
-  ESP_LOGI(TAG, "Connecting MQTT client %d with client ID '%s'", client_idx, client_id_str);
-
-  // Send the command
-  qmtconn_write_response_t local_response = {0};
-  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTCONN,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &params,
-                                                      response ? response : &local_response);
+  at_cmd_handler_end_batch(&handle->at_handler);
+  return err;
+}
 
-  if (err != ESP_OK)
+esp_err_t bg95_http_post(bg95_handle_t*        handle,
+                         const char*           url,
+                         const void*           body,
+                         size_t                body_len,
+                         bg95_http_sink_fn     sink,
+                         void*                 sink_context,
+                         bg95_http_response_t* response)
+{
+  if (!handle || !url || !body || !handle->initialized)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT connect command: %s", esp_err_to_name(err));
-    return err;
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // If we got a result code in the immediate response, check if it was successful
-  if ((response && response->present.has_result) ||
-      (!response && local_response.present.has_result))
-  {
-    qmtconn_result_t result = response ? response->result : local_response.result;
-
-    if (result != QMTCONN_RESULT_SUCCESS)
-    {
-      ESP_LOGE(TAG,
-               "MQTT connect operation failed with result: %d (%s)",
-               result,
-               enum_to_str(result, QMTCONN_RESULT_MAP, QMTCONN_RESULT_MAP_SIZE));
-
-      // If we have a return code, log it for more detail
-      if ((response && response->present.has_ret_code) ||
-          (!response && local_response.present.has_ret_code))
-      {
-        qmtconn_ret_code_t ret_code = response ? response->ret_code : local_response.ret_code;
-        ESP_LOGE(TAG,
-                 "MQTT connect return code: %d (%s)",
-                 ret_code,
-                 enum_to_str(ret_code, QMTCONN_RET_CODE_MAP, QMTCONN_RET_CODE_MAP_SIZE));
-      }
-
-      return ESP_FAIL;
-    }
+  return bg95_http_post_common(
+      handle, url, body, NULL, NULL, body_len, sink, sink_context, response);
+}
 
-    ESP_LOGI(TAG, "MQTT client %d connected successfully", client_idx);
-  }
-  else
+esp_err_t bg95_http_post_stream(bg95_handle_t*        handle,
+                                const char*           url,
+                                bg95_http_source_fn   source,
+                                void*                 source_context,
+                                size_t                body_len,
+                                bg95_http_sink_fn     sink,
+                                void*                 sink_context,
+                                bg95_http_response_t* response)
+{
+  if (!handle || !url || !source || !handle->initialized)
   {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT connect command sent successfully, waiting for connection result");
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
   }
 
-  return ESP_OK;
+  return bg95_http_post_common(
+      handle, url, NULL, source, source_context, body_len, sink, sink_context, response);
 }
 
-esp_err_t
-bg95_mqtt_disconnect(bg95_handle_t* handle, uint8_t client_idx, qmtdisc_write_response_t* response)
+// ------------------------------ FILE SYSTEM (UFS) -------------------------------
+
+uint16_t bg95_file_checksum_update(uint16_t checksum, uint32_t offset, const void* data, size_t len)
 {
-  if (NULL == handle || !handle->initialized)
+  const uint8_t* bytes = (const uint8_t*) data;
+  for (size_t i = 0; i < len; i++)
   {
-    ESP_LOGE(TAG, "Invalid handle or handle not initialized");
-    return ESP_ERR_INVALID_ARG;
+    // Even positions are the high byte of a word
+    checksum ^= ((offset + i) & 1) ? bytes[i] : (uint16_t) (bytes[i] << 8);
   }
+  return checksum;
+}
 
-  if (client_idx > QMTDISC_CLIENT_IDX_MAX)
+static esp_err_t bg95_file_check_name(const char* filename)
+{
+  size_t len = strlen(filename);
+  if (len == 0 || len > QFOPEN_FILENAME_MAX_LEN)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTDISC_CLIENT_IDX_MAX);
+    ESP_LOGE(TAG, "Invalid file name length: %d", (int) len);
     return ESP_ERR_INVALID_ARG;
   }
+  return ESP_OK;
+}
 
-  // Prepare write parameters
-  qmtdisc_write_params_t params = {.client_idx = client_idx};
-
-  ESP_LOGI(TAG, "Disconnecting MQTT client %d from server", client_idx);
-
-  // Send the command
-  qmtdisc_write_response_t local_response = {0};
-  esp_err_t                err            = at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                                      &AT_CMD_QMTDISC,
-                                                      AT_CMD_TYPE_WRITE,
-                                                      &params,
-                                                      response ? response : &local_response);
+static esp_err_t bg95_file_open(bg95_handle_t* handle,
+                                const char*    filename,
+                                qfopen_mode_t  mode,
+                                uint32_t       offset,
+                                uint32_t*      file_handle)
+{
+  qfopen_write_params_t   params = {.mode = mode};
+  qfopen_write_response_t opened = {0};
+  strncpy(params.filename, filename, QFOPEN_FILENAME_MAX_LEN);
 
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QFOPEN, AT_CMD_TYPE_WRITE, &params, &opened);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT disconnect command: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to open %s: %s", filename, esp_err_to_name(err));
     return err;
   }
+  *file_handle = opened.file_handle;
 
-  // If we got a result code in the immediate response, check if it was successful
-  if ((response && response->present.has_result) ||
-      (!response && local_response.present.has_result))
+  if (offset > 0)
   {
-    qmtdisc_result_t result = response ? response->result : local_response.result;
-
-    if (result != QMTDISC_RESULT_SUCCESS)
+    qfseek_write_params_t seek = {
+        .file_handle = opened.file_handle, .offset = offset, .position = QFSEEK_POSITION_BEGIN};
+    err = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_QFSEEK, AT_CMD_TYPE_WRITE, &seek, NULL);
+    if (err != ESP_OK)
     {
-      ESP_LOGE(TAG,
-               "MQTT disconnect failed with result: %d (%s)",
-               result,
-               enum_to_str(result, QMTDISC_RESULT_MAP, QMTDISC_RESULT_MAP_SIZE));
-      return ESP_FAIL;
+      ESP_LOGE(TAG, "Failed to seek %s to %lu", filename, (unsigned long) offset);
+      qfclose_write_params_t close = {.file_handle = opened.file_handle};
+      at_cmd_handler_send_and_receive_cmd(
+          &handle->at_handler, &AT_CMD_QFCLOSE, AT_CMD_TYPE_WRITE, &close, NULL);
     }
-
-    ESP_LOGI(TAG, "MQTT client %d disconnected successfully", client_idx);
-  }
-  else
-  {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT disconnect command sent successfully, waiting for result");
   }
 
-  return ESP_OK;
+  return err;
 }
 
-esp_err_t bg95_mqtt_publish_fixed_length(bg95_handle_t*           handle,
-                                         uint8_t                  client_idx,
-                                         uint16_t                 msgid,
-                                         qmtpub_qos_t             qos,
-                                         qmtpub_retain_t          retain,
-                                         const char*              topic,
-                                         const void*              message,
-                                         uint16_t                 message_length,
-                                         qmtpub_write_response_t* response)
+static esp_err_t bg95_file_close(bg95_handle_t* handle, uint32_t file_handle)
 {
-  if (NULL == handle || NULL == topic || NULL == message || message_length == 0 ||
-      !handle->initialized)
-  {
-    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
-    return ESP_ERR_INVALID_ARG;
-  }
+  qfclose_write_params_t params = {.file_handle = file_handle};
+  return at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QFCLOSE, AT_CMD_TYPE_WRITE, &params, NULL);
+}
 
-  if (client_idx > QMTPUB_CLIENT_IDX_MAX)
-  {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTPUB_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
-  }
+// Checksum the data as it passes from the caller's source to the UART
+typedef struct
+{
+  bg95_file_source_fn source;
+  void*               context;
+  uint32_t            offset;
+  uint16_t            checksum;
+} bg95_file_source_state_t;
+
+static esp_err_t
+bg95_file_checksum_source(char* buffer, size_t buffer_size, size_t* len, void* context)
+{
+  bg95_file_source_state_t* state = (bg95_file_source_state_t*) context;
 
-  if (message_length > QMTPUB_MSG_MAX_LEN)
+  esp_err_t err = state->source(buffer, buffer_size, len, state->context);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Message too long: %d bytes (max %d)", message_length, QMTPUB_MSG_MAX_LEN);
-    return ESP_ERR_INVALID_ARG;
+    state->checksum = bg95_file_checksum_update(state->checksum, state->offset, buffer, *len);
+    state->offset += *len;
   }
+  return err;
+}
 
-  // QoS 0 requires msgid to be 0
-  if (qos == QMTPUB_QOS_AT_MOST_ONCE && msgid != 0)
-  {
-    ESP_LOGW(TAG, "QoS 0 requires msgid=0, forcing msgid to 0");
-    msgid = 0;
-  }
+// Checksum the data (and advance the transfer) once the caller's sink has taken it
+typedef struct
+{
+  bg95_file_sink_fn     sink;
+  void*                 context;
+  bg95_file_transfer_t* transfer;
+} bg95_file_sink_state_t;
 
-  // For QoS 1 and 2, msgid must be non-zero
-  if ((qos == QMTPUB_QOS_AT_LEAST_ONCE || qos == QMTPUB_QOS_EXACTLY_ONCE) && msgid == 0)
+static esp_err_t bg95_file_checksum_sink(const char* data, size_t len, void* context)
+{
+  bg95_file_sink_state_t* state = (bg95_file_sink_state_t*) context;
+
+  esp_err_t err = state->sink(data, len, state->context);
+  if (err == ESP_OK)
   {
-    ESP_LOGW(TAG, "QoS %d requires non-zero msgid, using msgid=1", qos);
-    msgid = 1;
+    bg95_file_transfer_t* transfer = state->transfer;
+    transfer->checksum = bg95_file_checksum_update(transfer->checksum, transfer->offset, data, len);
+    transfer->offset += len;
   }
+  return err;
+}
 
-  // Prepare write parameters
-  qmtpub_write_params_t params = {.client_idx = client_idx,
-                                  .msgid      = msgid,
-                                  .qos        = qos,
-                                  .retain     = retain,
-                                  .msglen     = message_length};
-
-  strncpy(params.topic, topic, sizeof(params.topic) - 1);
-  params.topic[sizeof(params.topic) - 1] = '\0'; // Ensure null termination
+static esp_err_t bg95_file_discard(const char* data, size_t len, void* context)
+{
+  (void) data;
+  (void) len;
+  (void) context;
+  return ESP_OK;
+}
 
-  ESP_LOGI(TAG,
-           "Publishing fixed-length MQTT message on topic '%s' with QoS %d, client %d, msgid %d, "
-           "length %d",
-           topic,
-           qos,
-           client_idx,
-           msgid,
-           message_length);
+static esp_err_t bg95_file_check_result(const qfdwl_write_response_t* result,
+                                        const bg95_file_transfer_t*   transfer)
+{
+  if (result->download_size != transfer->offset || result->checksum != transfer->checksum)
+  {
+    ESP_LOGE(TAG,
+             "File mismatch: module %lu bytes (checksum %04x), expected %lu bytes (checksum %04x)",
+             (unsigned long) result->download_size,
+             result->checksum,
+             (unsigned long) transfer->offset,
+             transfer->checksum);
+    return ESP_ERR_INVALID_CRC;
+  }
+  return ESP_OK;
+}
 
-  // Send the command with data
-  qmtpub_write_response_t local_response = {0};
-  esp_err_t               err            = at_cmd_handler_send_with_prompt(&handle->at_handler,
-                                                  &AT_CMD_QMTPUB,
-                                                  AT_CMD_TYPE_WRITE,
-                                                  &params,
-                                                  message,
-                                                  message_length,
-                                                  response ? response : &local_response);
+esp_err_t
+bg95_file_verify(bg95_handle_t* handle, const char* filename, const bg95_file_transfer_t* transfer)
+{
+  if (!handle || !filename || !transfer || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
 
+  esp_err_t err = bg95_file_check_name(filename);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT publish command: %s", esp_err_to_name(err));
     return err;
   }
 
-  // If we got a result code in the immediate response, check if it was successful
-  if ((response && response->present.has_result) ||
-      (!response && local_response.present.has_result))
-  {
-    qmtpub_result_t result = response ? response->result : local_response.result;
-
-    if (result != QMTPUB_RESULT_SUCCESS)
-    {
-      ESP_LOGE(TAG,
-               "MQTT publish failed with result: %d (%s)",
-               result,
-               enum_to_str(result, QMTPUB_RESULT_MAP, QMTPUB_RESULT_MAP_SIZE));
-      return ESP_FAIL;
-    }
+  qfdwl_write_params_t   params = {0};
+  qfdwl_write_response_t result = {0};
+  strncpy(params.filename, filename, QFOPEN_FILENAME_MAX_LEN);
 
-    ESP_LOGI(TAG, "MQTT message published successfully");
-  }
-  else
+  err = at_cmd_handler_send_and_stream(&handle->at_handler,
+                                       &AT_CMD_QFDWL,
+                                       AT_CMD_TYPE_WRITE,
+                                       &params,
+                                       QFDWL_END_MARKER,
+                                       &result,
+                                       bg95_file_discard,
+                                       NULL);
+  if (err != ESP_OK)
   {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT publish command sent successfully, waiting for publication result");
+    ESP_LOGE(TAG, "Failed to read back %s: %s", filename, esp_err_to_name(err));
+    return err;
   }
 
-  return ESP_OK;
+  return bg95_file_check_result(&result, transfer);
 }
 
-esp_err_t bg95_mqtt_subscribe(bg95_handle_t*           handle,
-                              uint8_t                  client_idx,
-                              uint16_t                 msgid,
-                              const char*              topic,
-                              qmtsub_qos_t             qos,
-                              qmtsub_write_response_t* response)
+esp_err_t bg95_file_upload(bg95_handle_t*        handle,
+                           const char*           filename,
+                           bg95_file_source_fn   source,
+                           void*                 source_context,
+                           uint32_t              size,
+                           bg95_file_transfer_t* transfer)
 {
-  // Validate parameters
-  if (NULL == handle || NULL == topic || !handle->initialized)
+  if (!handle || !filename || !source || !transfer || size == 0 || !handle->initialized)
   {
     ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > QMTSUB_CLIENT_IDX_MAX)
+  esp_err_t err = bg95_file_check_name(filename);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTSUB_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
+    return err;
   }
 
-  if (msgid < QMTSUB_MSGID_MIN || msgid > QMTSUB_MSGID_MAX)
+  if (transfer->offset > size)
   {
-    ESP_LOGE(TAG, "Invalid msgid: %d (must be %d-%d)", msgid, QMTSUB_MSGID_MIN, QMTSUB_MSGID_MAX);
+    ESP_LOGE(TAG, "Transfer offset %lu is past the end", (unsigned long) transfer->offset);
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (qos > QMTSUB_QOS_EXACTLY_ONCE)
-  {
-    ESP_LOGE(TAG, "Invalid QoS: %d (must be 0-2)", qos);
-    return ESP_ERR_INVALID_ARG;
-  }
+  // A fresh upload replaces the file, a resumed one writes on from the offset
+  qfopen_mode_t mode =
+      transfer->offset == 0 ? QFOPEN_MODE_CREATE_OR_CLEAR : QFOPEN_MODE_CREATE_OR_OPEN;
 
-  if (topic[0] == '\0' || strlen(topic) >= QMTSUB_TOPIC_MAX_SIZE)
+  at_cmd_handler_begin_batch(&handle->at_handler);
+  uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  uint32_t file_handle;
+  err = bg95_file_open(handle, filename, mode, transfer->offset, &file_handle);
+  if (err == ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid topic: empty or too long (max %d chars)", QMTSUB_TOPIC_MAX_SIZE - 1);
-    return ESP_ERR_INVALID_ARG;
+    while (err == ESP_OK && transfer->offset < size)
+    {
+      uint32_t window = size - transfer->offset;
+      if (window > BG95_FILE_WINDOW_SIZE)
+      {
+        window = BG95_FILE_WINDOW_SIZE;
+      }
+
+      bg95_file_source_state_t state   = {.source   = source,
+                                          .context  = source_context,
+                                          .offset   = transfer->offset,
+                                          .checksum = transfer->checksum};
+      qfwrite_write_params_t   params  = {.file_handle  = file_handle,
+                                          .length       = (uint16_t) window,
+                                          .input_time_s = QFWRITE_INPUT_TIME_DEFAULT_S};
+      qfwrite_write_response_t written = {0};
+      err = at_cmd_handler_send_with_prompt_stream(&handle->at_handler,
+                                                   &AT_CMD_QFWRITE,
+                                                   AT_CMD_TYPE_WRITE,
+                                                   &params,
+                                                   bg95_file_checksum_source,
+                                                   &state,
+                                                   window,
+                                                   &written);
+      if (err == ESP_OK && written.written_length != window)
+      {
+        ESP_LOGE(TAG,
+                 "Only %lu of %lu bytes written",
+                 (unsigned long) written.written_length,
+                 (unsigned long) window);
+        err = ESP_ERR_INVALID_SIZE;
+      }
+
+      if (err == ESP_OK)
+      {
+        transfer->offset   = state.offset;
+        transfer->checksum = state.checksum;
+      }
+    }
+
+    esp_err_t close_err = bg95_file_close(handle, file_handle);
+    if (err == ESP_OK)
+    {
+      err = close_err;
+    }
   }
 
-  // Prepare write parameters
-  qmtsub_write_params_t params = {.client_idx = client_idx, .msgid = msgid, .topic_count = 1};
+  transfer->elapsed_ms += pdTICKS_TO_MS(xTaskGetTickCount()) - start_time;
+  at_cmd_handler_end_batch(&handle->at_handler);
 
-  // Set the topic and QoS
-  strncpy(params.topics[0].topic, topic, QMTSUB_TOPIC_MAX_SIZE - 1);
-  params.topics[0].topic[QMTSUB_TOPIC_MAX_SIZE - 1] = '\0'; // Ensure null termination
-  params.topics[0].qos                              = qos;
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG,
+             "Upload of %s stopped at %lu of %lu bytes: %s",
+             filename,
+             (unsigned long) transfer->offset,
+             (unsigned long) size,
+             esp_err_to_name(err));
+    return err;
+  }
 
   ESP_LOGI(TAG,
-           "Subscribing MQTT client %d to topic '%s' with QoS %d, msgid %d",
-           client_idx,
-           topic,
-           qos,
-           msgid);
-
-  // Create local response structure if user didn't provide one
-  qmtsub_write_response_t  local_response = {0};
-  qmtsub_write_response_t* resp_ptr       = (response != NULL) ? response : &local_response;
+           "Uploaded %s (%lu bytes in %lu ms)",
+           filename,
+           (unsigned long) size,
+           (unsigned long) transfer->elapsed_ms);
+  return bg95_file_verify(handle, filename, transfer);
+}
 
-  // Send the command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTSUB, AT_CMD_TYPE_WRITE, &params, resp_ptr);
+// Resumed download - read on from the offset in windows
+static esp_err_t bg95_file_read_from(bg95_handle_t*        handle,
+                                     const char*           filename,
+                                     bg95_file_sink_fn     sink,
+                                     void*                 sink_context,
+                                     bg95_file_transfer_t* transfer)
+{
+  char* window = malloc(BG95_FILE_WINDOW_SIZE);
+  if (!window)
+  {
+    return ESP_ERR_NO_MEM;
+  }
 
+  uint32_t  file_handle;
+  esp_err_t err =
+      bg95_file_open(handle, filename, QFOPEN_MODE_READ_ONLY, transfer->offset, &file_handle);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT subscribe command: %s", esp_err_to_name(err));
+    free(window);
     return err;
   }
 
-  // If we got a result code in the immediate response, check if it was successful
-  if (resp_ptr->present.has_result)
+  while (err == ESP_OK)
   {
-    if (resp_ptr->result != QMTSUB_RESULT_SUCCESS)
-    {
-      ESP_LOGE(TAG,
-               "MQTT subscribe failed with result: %d (%s)",
-               resp_ptr->result,
-               enum_to_str(resp_ptr->result, QMTSUB_RESULT_MAP, QMTSUB_RESULT_MAP_SIZE));
-      return ESP_FAIL;
-    }
+    qfread_write_params_t params = {.file_handle = file_handle, .length = BG95_FILE_WINDOW_SIZE};
+    size_t                len    = 0;
 
-    if (resp_ptr->present.has_value)
+    err = at_cmd_handler_send_and_receive_payload(&handle->at_handler,
+                                                  &AT_CMD_QFREAD,
+                                                  AT_CMD_TYPE_WRITE,
+                                                  &params,
+                                                  NULL,
+                                                  qfread_locate_payload,
+                                                  window,
+                                                  BG95_FILE_WINDOW_SIZE,
+                                                  &len);
+    if (err != ESP_OK || len == 0)
     {
-      ESP_LOGI(TAG, "MQTT subscription successful, granted QoS: %d", resp_ptr->value);
+      break; // 0 bytes read - end of the file
     }
-    else
+
+    err = sink(window, len, sink_context);
+    if (err == ESP_OK)
     {
-      ESP_LOGI(TAG, "MQTT subscription successful");
+      transfer->checksum =
+          bg95_file_checksum_update(transfer->checksum, transfer->offset, window, len);
+      transfer->offset += len;
     }
   }
-  else
+
+  esp_err_t close_err = bg95_file_close(handle, file_handle);
+  if (err == ESP_OK)
   {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT subscribe command sent successfully, waiting for subscription result");
+    err = close_err;
   }
 
-  return ESP_OK;
+  free(window);
+  return err;
 }
 
-esp_err_t bg95_mqtt_unsubscribe(bg95_handle_t*           handle,
-                                uint8_t                  client_idx,
-                                uint16_t                 msgid,
-                                const char*              topic,
-                                qmtuns_write_response_t* response)
+esp_err_t bg95_file_download(bg95_handle_t*        handle,
+                             const char*           filename,
+                             bg95_file_sink_fn     sink,
+                             void*                 sink_context,
+                             bg95_file_transfer_t* transfer)
 {
-  // Validate parameters
-  if (NULL == handle || NULL == topic || !handle->initialized)
+  if (!handle || !filename || !sink || !transfer || !handle->initialized)
   {
     ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (client_idx > QMTUNS_CLIENT_IDX_MAX)
+  esp_err_t err = bg95_file_check_name(filename);
+  if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Invalid client_idx: %d (must be 0-%d)", client_idx, QMTUNS_CLIENT_IDX_MAX);
-    return ESP_ERR_INVALID_ARG;
+    return err;
   }
 
-  if (msgid < QMTUNS_MSGID_MIN || msgid > QMTUNS_MSGID_MAX)
+  bool resumed = transfer->offset > 0;
+
+  at_cmd_handler_begin_batch(&handle->at_handler);
+  uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+
+  if (resumed)
   {
-    ESP_LOGE(TAG, "Invalid msgid: %d (must be %d-%d)", msgid, QMTUNS_MSGID_MIN, QMTUNS_MSGID_MAX);
-    return ESP_ERR_INVALID_ARG;
+    err = bg95_file_read_from(handle, filename, sink, sink_context, transfer);
   }
-
-  if (topic[0] == '\0' || strlen(topic) >= QMTUNS_TOPIC_MAX_SIZE)
+  else
   {
-    ESP_LOGE(TAG, "Invalid topic: empty or too long (max %d chars)", QMTUNS_TOPIC_MAX_SIZE - 1);
-    return ESP_ERR_INVALID_ARG;
+    // The whole file in one stream, with the checksum reported at the end
+    bg95_file_sink_state_t state  = {.sink = sink, .context = sink_context, .transfer = transfer};
+    qfdwl_write_params_t   params = {0};
+    qfdwl_write_response_t result = {0};
+    strncpy(params.filename, filename, QFOPEN_FILENAME_MAX_LEN);
+
+    err = at_cmd_handler_send_and_stream(&handle->at_handler,
+                                         &AT_CMD_QFDWL,
+                                         AT_CMD_TYPE_WRITE,
+                                         &params,
+                                         QFDWL_END_MARKER,
+                                         &result,
+                                         bg95_file_checksum_sink,
+                                         &state);
+    if (err == ESP_OK)
+    {
+      err = bg95_file_check_result(&result, transfer);
+    }
   }
 
-  // Prepare write parameters
-  qmtuns_write_params_t params = {.client_idx = client_idx, .msgid = msgid, .topic_count = 1};
+  transfer->elapsed_ms += pdTICKS_TO_MS(xTaskGetTickCount()) - start_time;
+  at_cmd_handler_end_batch(&handle->at_handler);
 
-  // Set the topic
-  strncpy(params.topics[0], topic, QMTUNS_TOPIC_MAX_SIZE - 1);
-  params.topics[0][QMTUNS_TOPIC_MAX_SIZE - 1] = '\0'; // Ensure null termination
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG,
+             "Download of %s stopped at %lu bytes: %s",
+             filename,
+             (unsigned long) transfer->offset,
+             esp_err_to_name(err));
+    return err;
+  }
 
-  ESP_LOGI(TAG, "Unsubscribing MQTT client %d from topic '%s', msgid %d", client_idx, topic, msgid);
+  ESP_LOGI(TAG,
+           "Downloaded %s (%lu bytes in %lu ms)",
+           filename,
+           (unsigned long) transfer->offset,
+           (unsigned long) transfer->elapsed_ms);
+  return resumed ? bg95_file_verify(handle, filename, transfer) : ESP_OK;
+}
 
-  // Create local response structure if user didn't provide one
-  qmtuns_write_response_t  local_response = {0};
-  qmtuns_write_response_t* resp_ptr       = (response != NULL) ? response : &local_response;
+// ------------------------------ GNSS ---------------------------------
 
-  // Send the command
-  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
-      &handle->at_handler, &AT_CMD_QMTUNS, AT_CMD_TYPE_WRITE, &params, resp_ptr);
+esp_err_t bg95_gnss_start(bg95_handle_t* handle)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  at_cmd_handler_begin_batch(&handle->at_handler);
 
+  qgpscfg_write_params_t nmeasrc = {.type = QGPSCFG_TYPE_NMEASRC, .value.nmeasrc = true};
+  esp_err_t              err     = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QGPSCFG, AT_CMD_TYPE_WRITE, &nmeasrc, NULL);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to send MQTT unsubscribe command: %s", esp_err_to_name(err));
+    ESP_LOGE(TAG, "Failed to enable the NMEA source: %s", esp_err_to_name(err));
+    at_cmd_handler_end_batch(&handle->at_handler);
     return err;
   }
 
-  // If we got a result code in the immediate response, check if it was successful
-  if (resp_ptr->present.has_result)
+  // Turning GNSS on while it is already on is an error
+  qgps_read_response_t state = {0};
+  err                        = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QGPS, AT_CMD_TYPE_READ, NULL, &state);
+  if (err == ESP_OK && state.state == QGPS_STATE_OFF)
   {
-    if (resp_ptr->result != QMTUNS_RESULT_SUCCESS)
-    {
-      ESP_LOGE(TAG,
-               "MQTT unsubscribe failed with result: %d (%s)",
-               resp_ptr->result,
-               enum_to_str(resp_ptr->result, QMTUNS_RESULT_MAP, QMTUNS_RESULT_MAP_SIZE));
-      return ESP_FAIL;
-    }
-
-    ESP_LOGI(TAG, "MQTT unsubscribe successful");
+    qgps_write_params_t params = {.mode = QGPS_MODE_STANDALONE};
+    err                        = at_cmd_handler_send_and_receive_cmd(
+        &handle->at_handler, &AT_CMD_QGPS, AT_CMD_TYPE_WRITE, &params, NULL);
   }
-  else
+
+  at_cmd_handler_end_batch(&handle->at_handler);
+
+  if (err != ESP_OK)
   {
-    // If no result code in the immediate response, that's expected
-    // The URC with the result will come later, the caller needs to wait for it
-    ESP_LOGI(TAG, "MQTT unsubscribe command sent successfully, waiting for result");
+    ESP_LOGE(TAG, "Failed to turn on GNSS: %s", esp_err_to_name(err));
+    return err;
   }
 
+  ESP_LOGI(TAG, "GNSS on");
   return ESP_OK;
 }
 
-esp_err_t bg95_get_extended_signal_quality(bg95_handle_t*           handle,
-                                           qcsq_execute_response_t* signal_quality)
+esp_err_t bg95_gnss_stop(bg95_handle_t* handle)
 {
-  if (!handle || !signal_quality || !handle->initialized)
+  if (!handle || !handle->initialized)
   {
     ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Execute QCSQ command to get detailed signal quality
-  esp_err_t err =
-      at_cmd_handler_send_and_receive_cmd(&handle->at_handler,
-                                          &AT_CMD_QCSQ,
-                                          AT_CMD_TYPE_EXECUTE,
-                                          NULL, // No parameters needed for EXECUTE command
-                                          signal_quality);
+  return at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QGPSEND, AT_CMD_TYPE_EXECUTE, NULL, NULL);
+}
+
+esp_err_t bg95_gnss_get_location(bg95_handle_t* handle, bg95_gnss_fix_t* fix)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
 
+  qgpsloc_write_params_t   params   = {.mode = QGPSLOC_MODE_DECIMAL};
+  qgpsloc_write_response_t location = {0};
+  esp_err_t                err      = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QGPSLOC, AT_CMD_TYPE_WRITE, &params, &location);
   if (err != ESP_OK)
   {
-    ESP_LOGE(TAG, "Failed to get extended signal quality: %s", esp_err_to_name(err));
-    return err;
+    return err; // ESP_FAIL (+CME ERROR: 516) until there is a fix
   }
 
-  // Log detailed information based on system mode
-  ESP_LOGI(TAG, "Extended signal quality:");
-  ESP_LOGI(TAG,
-           "  System mode: %s",
-           enum_to_str(signal_quality->sysmode, QCSQ_SYSMODE_MAP, QCSQ_SYSMODE_MAP_SIZE));
+  // QGPSLOC only answers with a fix, so this replaces whatever the NMEA sentences gave
+  bg95_gnss_fix_t* latest = &handle->gnss.parser.fix;
 
-  switch (signal_quality->sysmode)
+  latest->valid          = true;
+  latest->fix_type       = location.fix == QGPSLOC_FIX_3D ? BG95_GNSS_FIX_3D : BG95_GNSS_FIX_2D;
+  latest->hour           = location.hour;
+  latest->minute         = location.minute;
+  latest->second         = location.second;
+  latest->millisecond    = location.millisecond;
+  latest->day            = location.day;
+  latest->month          = location.month;
+  latest->year           = location.year;
+  latest->latitude_e7    = location.latitude_e7;
+  latest->longitude_e7   = location.longitude_e7;
+  latest->altitude_cm    = location.altitude_cm;
+  latest->hdop_x100      = location.hdop_x100;
+  latest->course_x100    = location.course_x100;
+  latest->speed_kmh_x100 = location.speed_kmh_x100;
+  latest->satellites     = location.satellites;
+  latest->updated_ms     = pdTICKS_TO_MS(xTaskGetTickCount());
+  bg95_gnss_fix_store_publish(&handle->gnss.latest_fix, latest);
+
+  if (fix)
   {
-    case QCSQ_SYSMODE_NOSERVICE:
-      ESP_LOGI(TAG, "  No service");
-      break;
+    *fix = *latest;
+  }
+  return ESP_OK;
+}
 
-    case QCSQ_SYSMODE_GSM:
-      if (signal_quality->present.has_value1)
-        ESP_LOGI(TAG, "  GSM RSSI: %d dBm", signal_quality->value1);
-      break;
+esp_err_t bg95_gnss_poll_nmea(bg95_handle_t* handle, qgpsgnmea_sentence_t sentence)
+{
+  if (!handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
 
-    case QCSQ_SYSMODE_EMTC:
-      if (signal_quality->present.has_value1)
-        ESP_LOGI(TAG, "  LTE RSSI: %d dBm", signal_quality->value1);
-      if (signal_quality->present.has_value2)
-        ESP_LOGI(TAG, "  LTE RSRP: %d dBm", signal_quality->value2);
-      if (signal_quality->present.has_value3)
-        ESP_LOGI(TAG, "  LTE SINR: %.1f dB", qcsq_sinr_to_db(signal_quality->value3));
-      if (signal_quality->present.has_value4)
-        ESP_LOGI(TAG, "  LTE RSRQ: %d dB", signal_quality->value4);
-      break;
+  qgpsgnmea_write_params_t params = {.sentence = sentence};
+  // Too big for the stack of most tasks
+  qgpsgnmea_write_response_t* nmea = malloc(sizeof(qgpsgnmea_write_response_t));
+  if (!nmea)
+  {
+    return ESP_ERR_NO_MEM;
+  }
 
-    case QCSQ_SYSMODE_NBIOT:
-      if (signal_quality->present.has_value1)
-        ESP_LOGI(TAG, "  NB-IoT RSSI: %d dBm", signal_quality->value1);
-      if (signal_quality->present.has_value2)
-        ESP_LOGI(TAG, "  NB-IoT RSRP: %d dBm", signal_quality->value2);
-      if (signal_quality->present.has_value3)
-        ESP_LOGI(TAG, "  NB-IoT SINR: %.1f dB", qcsq_sinr_to_db(signal_quality->value3));
-      if (signal_quality->present.has_value4)
-        ESP_LOGI(TAG, "  NB-IoT RSRQ: %d dB", signal_quality->value4);
-      break;
+  esp_err_t err = at_cmd_handler_send_and_receive_cmd(
+      &handle->at_handler, &AT_CMD_QGPSGNMEA, AT_CMD_TYPE_WRITE, &params, nmea);
+  if (err == ESP_OK)
+  {
+    bg95_nmea_parser_feed(
+        &handle->gnss.parser, nmea->nmea, nmea->nmea_len, &handle->gnss.latest_fix);
   }
 
+  free(nmea);
+  return err;
+}
+
+esp_err_t bg95_gnss_feed_nmea(bg95_handle_t* handle, const char* data, size_t len)
+{
+  if (!handle || !data || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_nmea_parser_feed(&handle->gnss.parser, data, len, &handle->gnss.latest_fix);
   return ESP_OK;
 }
+
+esp_err_t bg95_gnss_get_latest_fix(bg95_handle_t* handle, bg95_gnss_fix_t* fix)
+{
+  if (!handle || !fix)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  return bg95_gnss_fix_store_read(&handle->gnss.latest_fix, fix) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
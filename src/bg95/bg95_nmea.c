@@ -0,0 +1,437 @@
+#include "bg95_nmea.h"
+
+#include "at_cmd_tokenizer.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+// -------------------- LATEST FIX --------------------
+
+void bg95_gnss_fix_store_init(bg95_gnss_fix_store_t* store)
+{
+  memset(store->copies, 0, sizeof(store->copies));
+  atomic_init(&store->sequence, 0);
+}
+
+void bg95_gnss_fix_store_publish(bg95_gnss_fix_store_t* store, const bg95_gnss_fix_t* fix)
+{
+  unsigned int sequence = atomic_load_explicit(&store->sequence, memory_order_relaxed);
+  unsigned int next     = sequence + 2 != 0 ? sequence + 2 : 2; // 0 is kept for 'nothing yet'
+
+  // Odd: readers use copy 1 while copy 0 is written, then even: copy 0 while copy 1 is written
+  atomic_store_explicit(&store->sequence, sequence + 1, memory_order_release);
+  atomic_thread_fence(memory_order_release);
+  store->copies[0] = *fix;
+
+  atomic_store_explicit(&store->sequence, next, memory_order_release);
+  atomic_thread_fence(memory_order_release);
+  store->copies[1] = *fix;
+}
+
+bool bg95_gnss_fix_store_read(const bg95_gnss_fix_store_t* store, bg95_gnss_fix_t* fix)
+{
+  unsigned int sequence;
+  do
+  {
+    sequence = atomic_load_explicit(&store->sequence, memory_order_acquire);
+    if (sequence == 0)
+    {
+      return false;
+    }
+    *fix = store->copies[sequence & 1];
+    atomic_thread_fence(memory_order_acquire);
+  } while (atomic_load_explicit(&store->sequence, memory_order_relaxed) != sequence);
+
+  return true;
+}
+
+// -------------------- FIELDS --------------------
+
+static int hex_value(char c)
+{
+  if (c >= '0' && c <= '9')
+  {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F')
+  {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f')
+  {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// Parse a (signed) decimal field into fixed point with 'decimals' fraction digits. Extra fraction
+// digits are truncated. Returns false for empty / malformed fields
+static bool nmea_parse_fixed(const char* field, uint8_t decimals, int64_t* value)
+{
+  at_field_t view = {.type = AT_FIELD_VALUE, .start = field, .len = strlen(field)};
+  return at_field_get_fixed(&view, decimals, value) == ESP_OK;
+}
+
+// (d)ddmm.mmmm plus hemisphere to degrees * 10^7
+static bool nmea_parse_coordinate(const char* field, const char* hemisphere, int32_t* value)
+{
+  int64_t raw; // (d)ddmm.mmmmmmm * 10^7
+  if (!nmea_parse_fixed(field, 7, &raw) || raw < 0)
+  {
+    return false;
+  }
+
+  int64_t degrees_e7 = raw / 1000000000LL * 10000000LL + raw % 1000000000LL / 60;
+  if (degrees_e7 > 1800000000LL)
+  {
+    return false;
+  }
+
+  switch (hemisphere[0])
+  {
+    case 'N':
+    case 'E':
+      *value = (int32_t) degrees_e7;
+      return true;
+    case 'S':
+    case 'W':
+      *value = (int32_t) -degrees_e7;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// hhmmss(.sss)
+static void nmea_parse_time(const char* field, bg95_gnss_fix_t* fix)
+{
+  int64_t time;
+  if (nmea_parse_fixed(field, 3, &time) && time < 240000000LL)
+  {
+    fix->hour        = (uint8_t) (time / 10000000);
+    fix->minute      = (uint8_t) (time / 100000 % 100);
+    fix->second      = (uint8_t) (time / 1000 % 100);
+    fix->millisecond = (uint16_t) (time % 1000);
+  }
+}
+
+static void nmea_parse_position(const char* const* fields, bg95_gnss_fix_t* fix)
+{
+  int32_t latitude, longitude;
+  if (nmea_parse_coordinate(fields[0], fields[1], &latitude) &&
+      nmea_parse_coordinate(fields[2], fields[3], &longitude) && latitude >= -900000000 &&
+      latitude <= 900000000)
+  {
+    fix->latitude_e7  = latitude;
+    fix->longitude_e7 = longitude;
+  }
+}
+
+static void nmea_parse_u16(const char* field, uint8_t decimals, uint16_t* value)
+{
+  int64_t parsed;
+  if (nmea_parse_fixed(field, decimals, &parsed) && parsed >= 0 && parsed <= UINT16_MAX)
+  {
+    *value = (uint16_t) parsed;
+  }
+}
+
+static void nmea_parse_speed_knots(const char* field, bg95_gnss_fix_t* fix)
+{
+  int64_t knots_x100;
+  if (nmea_parse_fixed(field, 2, &knots_x100) && knots_x100 >= 0)
+  {
+    fix->speed_kmh_x100 = (uint32_t) (knots_x100 * 1852 / 1000);
+  }
+}
+
+// -------------------- SENTENCES --------------------
+
+// $--GGA,<time>,<lat>,<N/S>,<lon>,<E/W>,<quality>,<numsats>,<hdop>,<alt>,M,...
+static bool nmea_parse_gga(const char* const* fields, int num_fields, bg95_gnss_fix_t* fix)
+{
+  if (num_fields < 10)
+  {
+    return false;
+  }
+
+  nmea_parse_time(fields[1], fix);
+  nmea_parse_position(&fields[2], fix);
+
+  int64_t quality;
+  fix->valid = nmea_parse_fixed(fields[6], 0, &quality) && quality > 0;
+  if (!fix->valid)
+  {
+    fix->fix_type = BG95_GNSS_FIX_NONE;
+  }
+
+  int64_t value;
+  if (nmea_parse_fixed(fields[7], 0, &value) && value >= 0 && value <= UINT8_MAX)
+  {
+    fix->satellites = (uint8_t) value;
+  }
+  nmea_parse_u16(fields[8], 2, &fix->hdop_x100);
+  if (nmea_parse_fixed(fields[9], 2, &value))
+  {
+    fix->altitude_cm = (int32_t) value;
+  }
+  return true;
+}
+
+// $--GNS,<time>,<lat>,<N/S>,<lon>,<E/W>,<mode per constellation>,<numsats>,<hdop>,<alt>,...
+static bool nmea_parse_gns(const char* const* fields, int num_fields, bg95_gnss_fix_t* fix)
+{
+  if (num_fields < 10)
+  {
+    return false;
+  }
+
+  nmea_parse_time(fields[1], fix);
+  nmea_parse_position(&fields[2], fix);
+
+  // 'N' means no fix for that constellation
+  fix->valid = strspn(fields[6], "N") != strlen(fields[6]);
+  if (!fix->valid)
+  {
+    fix->fix_type = BG95_GNSS_FIX_NONE;
+  }
+
+  int64_t value;
+  if (nmea_parse_fixed(fields[7], 0, &value) && value >= 0 && value <= UINT8_MAX)
+  {
+    fix->satellites = (uint8_t) value;
+  }
+  nmea_parse_u16(fields[8], 2, &fix->hdop_x100);
+  if (nmea_parse_fixed(fields[9], 2, &value))
+  {
+    fix->altitude_cm = (int32_t) value;
+  }
+  return true;
+}
+
+// $--RMC,<time>,<A/V>,<lat>,<N/S>,<lon>,<E/W>,<speed knots>,<course>,<ddmmyy>,...
+static bool nmea_parse_rmc(const char* const* fields, int num_fields, bg95_gnss_fix_t* fix)
+{
+  if (num_fields < 10)
+  {
+    return false;
+  }
+
+  nmea_parse_time(fields[1], fix);
+  fix->valid = (fields[2][0] == 'A');
+  if (!fix->valid)
+  {
+    fix->fix_type = BG95_GNSS_FIX_NONE;
+  }
+  nmea_parse_position(&fields[3], fix);
+  nmea_parse_speed_knots(fields[7], fix);
+  nmea_parse_u16(fields[8], 2, &fix->course_x100);
+
+  int64_t date;
+  if (nmea_parse_fixed(fields[9], 0, &date) && date > 0 && date <= 311299)
+  {
+    fix->day   = (uint8_t) (date / 10000);
+    fix->month = (uint8_t) (date / 100 % 100);
+    fix->year  = (uint16_t) (2000 + date % 100);
+  }
+  return true;
+}
+
+// $--GSA,<A/M>,<1: no fix / 2: 2D / 3: 3D>,<sats x12>,<pdop>,<hdop>,<vdop>
+static bool nmea_parse_gsa(const char* const* fields, int num_fields, bg95_gnss_fix_t* fix)
+{
+  int64_t fix_type;
+  if (num_fields < 3 || !nmea_parse_fixed(fields[2], 0, &fix_type))
+  {
+    return false;
+  }
+
+  if (fix_type == BG95_GNSS_FIX_2D || fix_type == BG95_GNSS_FIX_3D)
+  {
+    fix->fix_type = (bg95_gnss_fix_type_t) fix_type;
+  }
+  else
+  {
+    fix->fix_type = BG95_GNSS_FIX_NONE;
+  }
+  return true;
+}
+
+// $--VTG,<course true>,T,<course magnetic>,M,<speed knots>,N,<speed km/h>,K,...
+static bool nmea_parse_vtg(const char* const* fields, int num_fields, bg95_gnss_fix_t* fix)
+{
+  if (num_fields < 8)
+  {
+    return false;
+  }
+
+  nmea_parse_u16(fields[1], 2, &fix->course_x100);
+
+  int64_t speed;
+  if (nmea_parse_fixed(fields[7], 2, &speed) && speed >= 0)
+  {
+    fix->speed_kmh_x100 = (uint32_t) speed;
+  }
+  return true;
+}
+
+typedef bool (*nmea_sentence_parser_t)(const char* const* fields,
+                                       int                num_fields,
+                                       bg95_gnss_fix_t*   fix);
+
+static const struct
+{
+  const char             type[4];
+  nmea_sentence_parser_t parse;
+  bool                   completes_update;
+} NMEA_SENTENCES[] = {
+    {"GGA", nmea_parse_gga, true},
+    {"GNS", nmea_parse_gns, true},
+    {"RMC", nmea_parse_rmc, true},
+    {"GSA", nmea_parse_gsa, false},
+    {"VTG", nmea_parse_vtg, false},
+};
+
+// Check the checksum and split the sentence into its fields in place. Returns the number of fields
+static int nmea_split_sentence(char* sentence, size_t len, char** fields)
+{
+  // $<body>*<hh>
+  char* star = memchr(sentence, '*', len);
+  if (!star || (size_t) (star - sentence) + 3 != len)
+  {
+    return -1;
+  }
+
+  int high = hex_value(star[1]);
+  int low  = hex_value(star[2]);
+  if (high < 0 || low < 0)
+  {
+    return -1;
+  }
+
+  uint8_t checksum = 0;
+  for (const char* c = sentence + 1; c < star; c++)
+  {
+    checksum ^= (uint8_t) *c;
+  }
+  if (checksum != (uint8_t) ((high << 4) | low))
+  {
+    return -1;
+  }
+
+  *star          = '\0';
+  int   count    = 0;
+  char* position = sentence + 1;
+  while (count < BG95_NMEA_MAX_FIELDS)
+  {
+    fields[count++] = position;
+    position        = strchr(position, ',');
+    if (!position)
+    {
+      break;
+    }
+    *position++ = '\0';
+  }
+  return count;
+}
+
+// Returns true if the sentence completed an update
+static bool nmea_process_sentence(bg95_nmea_parser_t* parser)
+{
+  char* fields[BG95_NMEA_MAX_FIELDS];
+  int   num_fields = nmea_split_sentence(parser->sentence, parser->len, fields);
+  if (num_fields < 0)
+  {
+    parser->stats.checksum_errors++;
+    return false;
+  }
+
+  // Address is the talker (GP, GL, GN, ...) followed by the type
+  size_t address_len = strlen(fields[0]);
+  if (address_len == 5)
+  {
+    const char* type = fields[0] + 2;
+    for (size_t i = 0; i < sizeof(NMEA_SENTENCES) / sizeof(NMEA_SENTENCES[0]); i++)
+    {
+      if (memcmp(type, NMEA_SENTENCES[i].type, 3) == 0 &&
+          NMEA_SENTENCES[i].parse((const char* const*) fields, num_fields, &parser->fix))
+      {
+        parser->stats.sentences++;
+        return NMEA_SENTENCES[i].completes_update;
+      }
+    }
+  }
+
+  parser->stats.skipped++;
+  return false;
+}
+
+void bg95_nmea_parser_init(bg95_nmea_parser_t* parser)
+{
+  memset(parser, 0, sizeof(bg95_nmea_parser_t));
+}
+
+size_t bg95_nmea_parser_feed(bg95_nmea_parser_t*    parser,
+                             const char*            data,
+                             size_t                 len,
+                             bg95_gnss_fix_store_t* store)
+{
+  size_t updates = 0;
+
+  for (size_t i = 0; i < len; i++)
+  {
+    char c = data[i];
+
+    if (c == '$')
+    {
+      // A new sentence always starts over - also after a truncated one
+      parser->sentence[0] = c;
+      parser->len         = 1;
+      parser->in_sentence = true;
+      parser->overflowed  = false;
+      continue;
+    }
+
+    if (!parser->in_sentence)
+    {
+      continue;
+    }
+
+    if (c == '\r' || c == '\n')
+    {
+      parser->in_sentence = false;
+      if (parser->overflowed)
+      {
+        continue;
+      }
+
+      parser->sentence[parser->len] = '\0';
+      if (nmea_process_sentence(parser))
+      {
+        parser->fix.updated_ms = pdTICKS_TO_MS(xTaskGetTickCount());
+        if (store)
+        {
+          bg95_gnss_fix_store_publish(store, &parser->fix);
+        }
+        updates++;
+      }
+      continue;
+    }
+
+    // Leave room for the CRLF that is part of the max length
+    if (parser->overflowed || parser->len >= BG95_NMEA_MAX_SENTENCE_LEN - 2)
+    {
+      if (!parser->overflowed)
+      {
+        parser->overflowed = true;
+        parser->stats.overflows++;
+      }
+      continue;
+    }
+
+    parser->sentence[parser->len++] = c;
+  }
+
+  return updates;
+}
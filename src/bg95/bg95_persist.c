@@ -0,0 +1,101 @@
+#include "bg95_persist.h"
+
+#include <esp_log.h>
+#include <nvs.h>
+
+static const char* TAG = "BG95_PERSIST";
+
+esp_err_t bg95_persist_save(const char* key, const void* data, size_t len)
+{
+  if (!key || !data || len == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  nvs_handle_t nvs;
+  esp_err_t    err = nvs_open(BG95_PERSIST_NAMESPACE, NVS_READWRITE, &nvs);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to open NVS namespace: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  err = nvs_set_blob(nvs, key, data, len);
+  if (err == ESP_OK)
+  {
+    err = nvs_commit(nvs);
+  }
+  nvs_close(nvs);
+
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to save '%s': %s", key, esp_err_to_name(err));
+  }
+  return err;
+}
+
+esp_err_t bg95_persist_load(const char* key, void* data, size_t len)
+{
+  if (!key || !data || len == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  nvs_handle_t nvs;
+  esp_err_t    err = nvs_open(BG95_PERSIST_NAMESPACE, NVS_READONLY, &nvs);
+  if (err == ESP_ERR_NVS_NOT_FOUND)
+  {
+    return ESP_ERR_NOT_FOUND; // Namespace does not exist until the first save
+  }
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Failed to open NVS namespace: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  size_t stored_len = len;
+  err               = nvs_get_blob(nvs, key, data, &stored_len);
+  nvs_close(nvs);
+
+  if (err == ESP_ERR_NVS_NOT_FOUND)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (err == ESP_OK && stored_len != len)
+  {
+    ESP_LOGW(TAG,
+             "Stored '%s' has unexpected size %d (expected %d)",
+             key,
+             (int) stored_len,
+             (int) len);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  return err;
+}
+
+esp_err_t bg95_persist_erase(const char* key)
+{
+  if (!key)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  nvs_handle_t nvs;
+  esp_err_t    err = nvs_open(BG95_PERSIST_NAMESPACE, NVS_READWRITE, &nvs);
+  if (err == ESP_ERR_NVS_NOT_FOUND)
+  {
+    return ESP_OK;
+  }
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = nvs_erase_key(nvs, key);
+  if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND)
+  {
+    err = nvs_commit(nvs);
+  }
+  nvs_close(nvs);
+  return err;
+}
@@ -0,0 +1,524 @@
+#include "bg95_pool.h"
+
+#include <esp_log.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "BG95_POOL";
+
+// A publish moving between modems until one of them takes it
+typedef struct
+{
+  bg95_pool_t*      pool;
+  qmtpub_qos_t      qos;
+  qmtpub_retain_t   retain;
+  uint16_t          message_length;
+  uint8_t           attempts;
+  bg95_pool_done_cb on_done;
+  void*             context;
+  char*             topic; // Topic and message are stored right after this struct
+  uint8_t*          message;
+} pool_publish_t;
+
+static uint32_t pool_now_ms(void)
+{
+  return pdTICKS_TO_MS(xTaskGetTickCount());
+}
+
+static int pool_modem_index(bg95_pool_t* pool, bg95_handle_t* handle)
+{
+  for (int i = 0; i < pool->num_modems; i++)
+  {
+    if (pool->modems[i].handle == handle)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// ------------------------------- WORKERS -------------------------------------
+
+// Caller holds the lock and owns the modem (scheduled). Gives the modem up, or queues it again
+// behind the other ready modems if more jobs are waiting
+static void pool_release_modem(bg95_pool_t* pool, uint8_t modem_idx)
+{
+  bg95_pool_modem_t* modem = &pool->modems[modem_idx];
+  if (uxQueueMessagesWaiting(modem->jobs) > 0)
+  {
+    xQueueSend(pool->ready, &modem_idx, 0);
+  }
+  else
+  {
+    modem->scheduled = false;
+  }
+}
+
+static void pool_run_job(bg95_pool_t* pool, uint8_t modem_idx)
+{
+  bg95_pool_modem_t* modem = &pool->modems[modem_idx];
+  bg95_pool_job_t    job;
+
+  if (xQueueReceive(modem->jobs, &job, 0) == pdTRUE)
+  {
+    esp_err_t result = job.fn(modem->handle, job.context);
+
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    modem->stats.jobs_run++;
+    if (result != ESP_OK)
+    {
+      modem->stats.jobs_failed++;
+    }
+    xSemaphoreGive(pool->lock);
+
+    if (job.on_done)
+    {
+      job.on_done(modem->handle, result, job.context);
+    }
+  }
+
+  xSemaphoreTake(pool->lock, portMAX_DELAY);
+  pool_release_modem(pool, modem_idx);
+  xSemaphoreGive(pool->lock);
+}
+
+// Pick up URCs on the modems that have nothing queued
+static void pool_poll_idle_modems(bg95_pool_t* pool)
+{
+  for (uint8_t i = 0; i < pool->num_modems; i++)
+  {
+    bg95_pool_modem_t* modem = &pool->modems[i];
+
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    bool due = !modem->scheduled &&
+               (pool_now_ms() - modem->last_poll_ms) >= BG95_POOL_POLL_INTERVAL_MS;
+    if (due)
+    {
+      modem->scheduled = true; // Keeps the other workers off the modem while polling
+    }
+    xSemaphoreGive(pool->lock);
+
+    if (!due)
+    {
+      continue;
+    }
+
+    // Fails harmlessly while the modem is in data mode
+    bg95_socket_poll(modem->handle, 0);
+
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    modem->last_poll_ms = pool_now_ms();
+    pool_release_modem(pool, i);
+    xSemaphoreGive(pool->lock);
+  }
+}
+
+static void pool_worker_task(void* arg)
+{
+  bg95_pool_t* pool = (bg95_pool_t*) arg;
+
+  while (!pool->stop_requested)
+  {
+    uint8_t modem_idx;
+    if (xQueueReceive(pool->ready, &modem_idx, pdMS_TO_TICKS(BG95_POOL_POLL_INTERVAL_MS)) ==
+        pdTRUE)
+    {
+      pool_run_job(pool, modem_idx);
+    }
+    else
+    {
+      pool_poll_idle_modems(pool);
+    }
+  }
+
+  xSemaphoreTake(pool->lock, portMAX_DELAY);
+  pool->running_workers--;
+  xSemaphoreGive(pool->lock);
+  vTaskDelete(NULL);
+}
+
+// ------------------------------- PUBLISH -------------------------------------
+
+// Caller holds the lock. Online modem with the fewest queued jobs - ties go round robin.
+// Returns -1 (with 'all_full' set if some modem is online) if no modem can take the publish
+static int pool_pick_publish_modem(bg95_pool_t* pool, bool* all_full)
+{
+  int         best      = -1;
+  UBaseType_t best_load = 0;
+
+  *all_full = false;
+  for (uint8_t n = 0; n < pool->num_modems; n++)
+  {
+    uint8_t            i     = (pool->next_publish_modem + n) % pool->num_modems;
+    bg95_pool_modem_t* modem = &pool->modems[i];
+    if (!modem->online)
+    {
+      continue;
+    }
+
+    UBaseType_t waiting = uxQueueMessagesWaiting(modem->jobs);
+    if (waiting >= BG95_POOL_QUEUE_LEN)
+    {
+      *all_full = true;
+      continue;
+    }
+
+    UBaseType_t load = waiting + (modem->scheduled ? 1 : 0);
+    if (best < 0 || load < best_load)
+    {
+      best      = i;
+      best_load = load;
+    }
+  }
+
+  if (best >= 0)
+  {
+    pool->next_publish_modem = (best + 1) % pool->num_modems;
+  }
+  return best;
+}
+
+static esp_err_t pool_publish_job(bg95_handle_t* handle, void* context)
+{
+  pool_publish_t* pub = (pool_publish_t*) context;
+  int             idx = pool_modem_index(pub->pool, handle);
+  if (idx < 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Only QoS 0 publishes go out with msgid 0
+  bg95_pool_modem_t* modem = &pub->pool->modems[idx];
+  uint16_t           msgid = 0;
+  if (pub->qos != QMTPUB_QOS_AT_MOST_ONCE)
+  {
+    modem->next_msgid = (modem->next_msgid == UINT16_MAX) ? 1 : modem->next_msgid + 1;
+    msgid             = modem->next_msgid;
+  }
+
+  return bg95_mqtt_publish_fixed_length(handle,
+                                        modem->mqtt_client_idx,
+                                        msgid,
+                                        pub->qos,
+                                        pub->retain,
+                                        pub->topic,
+                                        pub->message,
+                                        pub->message_length,
+                                        NULL);
+}
+
+static void pool_publish_done(bg95_handle_t* handle, esp_err_t result, void* context);
+
+// Caller must not hold the lock
+static esp_err_t pool_publish_submit(pool_publish_t* pub)
+{
+  bg95_pool_t* pool = pub->pool;
+
+  bool all_full;
+  xSemaphoreTake(pool->lock, portMAX_DELAY);
+  int modem_idx = pool_pick_publish_modem(pool, &all_full);
+  xSemaphoreGive(pool->lock);
+
+  if (modem_idx < 0)
+  {
+    return all_full ? ESP_ERR_NO_MEM : ESP_ERR_NOT_FOUND;
+  }
+
+  pub->attempts++;
+  bg95_pool_job_t job = {.fn = pool_publish_job, .on_done = pool_publish_done, .context = pub};
+  return bg95_pool_submit(pool, (uint8_t) modem_idx, &job);
+}
+
+static void pool_publish_done(bg95_handle_t* handle, esp_err_t result, void* context)
+{
+  pool_publish_t* pub  = (pool_publish_t*) context;
+  bg95_pool_t*    pool = pub->pool;
+  int             idx  = pool_modem_index(pool, handle);
+
+  if (result == ESP_OK)
+  {
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    pool->modems[idx].stats.publishes++;
+    xSemaphoreGive(pool->lock);
+  }
+  else if (!pool->stop_requested && idx >= 0)
+  {
+    ESP_LOGW(TAG,
+             "Publish failed on modem %d (%s) - taking it offline",
+             idx,
+             esp_err_to_name(result));
+
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    pool->modems[idx].online = false;
+    pool->modems[idx].stats.publish_failures++;
+    xSemaphoreGive(pool->lock);
+
+    if (pub->attempts < pool->num_modems && pool_publish_submit(pub) == ESP_OK)
+    {
+      return;
+    }
+  }
+
+  if (pub->on_done)
+  {
+    pub->on_done(handle, result, pub->context);
+  }
+  free(pub);
+}
+
+// --------------------------------- API ---------------------------------------
+
+esp_err_t bg95_pool_init(bg95_pool_t* pool)
+{
+  if (!pool)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(pool, 0, sizeof(bg95_pool_t));
+  pool->lock  = xSemaphoreCreateMutex();
+  pool->ready = xQueueCreate(BG95_POOL_MAX_MODEMS, sizeof(uint8_t));
+  if (!pool->lock || !pool->ready)
+  {
+    bg95_pool_stop(pool);
+    return ESP_ERR_NO_MEM;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t bg95_pool_add_modem(bg95_pool_t*   pool,
+                              bg95_handle_t* handle,
+                              uint8_t        mqtt_client_idx,
+                              uint8_t*       modem_idx)
+{
+  if (!pool || !pool->lock || !handle || !handle->initialized)
+  {
+    ESP_LOGE(TAG, "Invalid arguments or handle not initialized");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (pool->num_workers > 0)
+  {
+    ESP_LOGE(TAG, "Modems can only be added before the pool is started");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (pool->num_modems >= BG95_POOL_MAX_MODEMS || pool_modem_index(pool, handle) >= 0)
+  {
+    ESP_LOGE(TAG, "Pool is full, or the modem was already added");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  bg95_pool_modem_t* modem = &pool->modems[pool->num_modems];
+  memset(modem, 0, sizeof(bg95_pool_modem_t));
+  modem->jobs = xQueueCreate(BG95_POOL_QUEUE_LEN, sizeof(bg95_pool_job_t));
+  if (!modem->jobs)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  modem->handle          = handle;
+  modem->mqtt_client_idx = mqtt_client_idx;
+
+  if (modem_idx)
+  {
+    *modem_idx = pool->num_modems;
+  }
+  pool->num_modems++;
+  return ESP_OK;
+}
+
+esp_err_t bg95_pool_start(bg95_pool_t* pool, uint8_t num_workers)
+{
+  if (!pool || !pool->lock || pool->num_modems == 0 || num_workers == 0 ||
+      num_workers > BG95_POOL_MAX_WORKERS)
+  {
+    ESP_LOGE(TAG, "Invalid arguments, or no modems added");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (pool->num_workers > 0)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  for (uint8_t i = 0; i < num_workers; i++)
+  {
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    pool->running_workers++;
+    xSemaphoreGive(pool->lock);
+
+    if (xTaskCreate(pool_worker_task,
+                    "bg95_pool",
+                    BG95_POOL_WORKER_STACK_SIZE,
+                    pool,
+                    BG95_POOL_WORKER_PRIORITY,
+                    &pool->workers[i]) != pdPASS)
+    {
+      ESP_LOGE(TAG, "Failed to create worker %d", i);
+      xSemaphoreTake(pool->lock, portMAX_DELAY);
+      pool->running_workers--;
+      xSemaphoreGive(pool->lock);
+      bg95_pool_stop(pool);
+      return ESP_ERR_NO_MEM;
+    }
+    pool->num_workers++;
+  }
+
+  ESP_LOGI(TAG, "Started %d workers for %d modems", num_workers, pool->num_modems);
+  return ESP_OK;
+}
+
+esp_err_t bg95_pool_stop(bg95_pool_t* pool)
+{
+  if (!pool)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Read under the lock - a worker is only done with the pool once it has given the lock back
+  pool->stop_requested = true;
+  while (pool->lock)
+  {
+    xSemaphoreTake(pool->lock, portMAX_DELAY);
+    uint8_t running = pool->running_workers;
+    xSemaphoreGive(pool->lock);
+    if (running == 0)
+    {
+      break;
+    }
+    vTaskDelay(pdMS_TO_TICKS(BG95_POOL_POLL_INTERVAL_MS));
+  }
+
+  // Complete whatever is left, so the owners of the jobs can release them
+  for (uint8_t i = 0; i < pool->num_modems; i++)
+  {
+    bg95_pool_modem_t* modem = &pool->modems[i];
+    bg95_pool_job_t    job;
+    while (xQueueReceive(modem->jobs, &job, 0) == pdTRUE)
+    {
+      if (job.on_done)
+      {
+        job.on_done(modem->handle, ESP_ERR_INVALID_STATE, job.context);
+      }
+    }
+    vQueueDelete(modem->jobs);
+    modem->jobs = NULL;
+  }
+  pool->num_modems = 0;
+
+  if (pool->ready)
+  {
+    vQueueDelete(pool->ready);
+    pool->ready = NULL;
+  }
+  if (pool->lock)
+  {
+    vSemaphoreDelete(pool->lock);
+    pool->lock = NULL;
+  }
+  pool->num_workers = 0;
+  return ESP_OK;
+}
+
+esp_err_t bg95_pool_submit(bg95_pool_t* pool, uint8_t modem_idx, const bg95_pool_job_t* job)
+{
+  if (!pool || !pool->lock || !job || !job->fn || modem_idx >= pool->num_modems)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (pool->stop_requested)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  bg95_pool_modem_t* modem = &pool->modems[modem_idx];
+  esp_err_t          err   = ESP_OK;
+
+  xSemaphoreTake(pool->lock, portMAX_DELAY);
+  if (xQueueSend(modem->jobs, job, 0) != pdTRUE)
+  {
+    err = ESP_ERR_NO_MEM;
+  }
+  else if (!modem->scheduled)
+  {
+    modem->scheduled = true;
+    xQueueSend(pool->ready, &modem_idx, 0);
+  }
+  xSemaphoreGive(pool->lock);
+
+  return err;
+}
+
+esp_err_t bg95_pool_set_online(bg95_pool_t* pool, uint8_t modem_idx, bool online)
+{
+  if (!pool || !pool->lock || modem_idx >= pool->num_modems)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTake(pool->lock, portMAX_DELAY);
+  pool->modems[modem_idx].online = online;
+  xSemaphoreGive(pool->lock);
+  return ESP_OK;
+}
+
+esp_err_t bg95_pool_publish(bg95_pool_t*      pool,
+                            const char*       topic,
+                            const void*       message,
+                            uint16_t          message_length,
+                            qmtpub_qos_t      qos,
+                            qmtpub_retain_t   retain,
+                            bg95_pool_done_cb on_done,
+                            void*             context)
+{
+  if (!pool || !pool->lock || !topic || (!message && message_length > 0))
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  size_t          topic_size = strlen(topic) + 1;
+  pool_publish_t* pub        = malloc(sizeof(pool_publish_t) + topic_size + message_length);
+  if (!pub)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+
+  memset(pub, 0, sizeof(pool_publish_t));
+  pub->pool           = pool;
+  pub->qos            = qos;
+  pub->retain         = retain;
+  pub->message_length = message_length;
+  pub->on_done        = on_done;
+  pub->context        = context;
+  pub->topic          = (char*) (pub + 1);
+  pub->message        = (uint8_t*) pub->topic + topic_size;
+  memcpy(pub->topic, topic, topic_size);
+  if (message_length > 0)
+  {
+    memcpy(pub->message, message, message_length);
+  }
+
+  esp_err_t err = pool_publish_submit(pub);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Publish not queued: %s", esp_err_to_name(err));
+    free(pub);
+  }
+  return err;
+}
+
+esp_err_t bg95_pool_get_stats(bg95_pool_t* pool, uint8_t modem_idx, bg95_pool_modem_stats_t* stats)
+{
+  if (!pool || !pool->lock || !stats || modem_idx >= pool->num_modems)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTake(pool->lock, portMAX_DELAY);
+  *stats = pool->modems[modem_idx].stats;
+  xSemaphoreGive(pool->lock);
+  return ESP_OK;
+}
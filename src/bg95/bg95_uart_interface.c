@@ -10,7 +10,8 @@
 
 static const char* TAG = "BG95_UART_INTERFACE";
 
-// Add these function implementations
+// Only queues the data in the driver TX ring buffer - the UART sends it in the background. If the
+// ring is full, waits (up to BG95_UART_TX_TIMEOUT_MS) for space instead of dropping anything
 static esp_err_t uart_hw_write_impl(const char* data, size_t len, void* context)
 {
   bg95_uart_interface_t* interface = (bg95_uart_interface_t*) context;
@@ -19,56 +20,64 @@ static esp_err_t uart_hw_write_impl(const char* data, size_t len, void* context)
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Get how much space is available in TX buffer
-  size_t    available = 0;
-  esp_err_t err       = uart_get_tx_buffer_free_size(interface->uart_num, &available);
-  if (err != ESP_OK)
+  size_t   written    = 0;
+  uint32_t start_time = pdTICKS_TO_MS(xTaskGetTickCount());
+  while (written < len)
   {
-    ESP_LOGE(TAG, "Failed to get TX buffer size: %s", esp_err_to_name(err));
-    return err;
-  }
+    size_t    available = 0;
+    esp_err_t err       = uart_get_tx_buffer_free_size(interface->uart_num, &available);
+    if (err != ESP_OK)
+    {
+      ESP_LOGE(TAG, "Failed to get TX buffer size: %s", esp_err_to_name(err));
+      return err;
+    }
 
-  if (available < len)
-  {
-    ESP_LOGW(TAG,
-             "TX buffer doesn't have enough space. Available: %d, Need: %d. Flushing...",
-             (int) available,
-             (int) len);
-    // Flush both buffers
-    uart_flush(interface->uart_num);
-
-    // Check space again
-    err = uart_get_tx_buffer_free_size(interface->uart_num, &available);
-    if (err != ESP_OK || available < len)
+    if (available == 0)
     {
-      ESP_LOGE(TAG, "Still not enough space after flush");
-      return ESP_ERR_NO_MEM;
+      if ((pdTICKS_TO_MS(xTaskGetTickCount()) - start_time) >= BG95_UART_TX_TIMEOUT_MS)
+      {
+        ESP_LOGE(TAG, "TX buffer full for %d ms", BG95_UART_TX_TIMEOUT_MS);
+        return ESP_ERR_TIMEOUT;
+      }
+      vTaskDelay(pdMS_TO_TICKS(1));
+      continue;
     }
-  }
 
-  // Write data in chunks if needed
-  size_t written = 0;
-  while (written < len)
-  {
     size_t chunk_size = len - written;
-    int    result     = uart_write_bytes(interface->uart_num, data + written, chunk_size);
+    if (chunk_size > available)
+    {
+      chunk_size = available;
+    }
+
+    int result = uart_write_bytes(interface->uart_num, data + written, chunk_size);
     if (result < 0)
     {
       ESP_LOGE(TAG, "Failed to write to UART");
       return ESP_FAIL;
     }
     written += result;
+
+    // The timeout is for a stalled UART (e.g. CTS held), not for long writes
+    start_time = pdTICKS_TO_MS(xTaskGetTickCount());
   }
 
-  // Wait for transmission to complete
-  err = uart_wait_tx_done(interface->uart_num, pdMS_TO_TICKS(1000));
+  return ESP_OK;
+}
+
+static esp_err_t uart_hw_wait_tx_done_impl(uint32_t timeout_ms, void* context)
+{
+  bg95_uart_interface_t* interface = (bg95_uart_interface_t*) context;
+  if (!interface)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = uart_wait_tx_done(interface->uart_num, pdMS_TO_TICKS(timeout_ms));
   if (err != ESP_OK)
   {
     ESP_LOGE(TAG, "Failed to wait for TX complete: %s", esp_err_to_name(err));
-    return err;
   }
-
-  return ESP_OK;
+  return err;
 }
 
 static esp_err_t uart_hw_read_impl(
@@ -107,6 +116,65 @@ static esp_err_t uart_hw_read_impl(
   return ESP_OK;
 }
 
+// Drains what is already queued at the old rate first - the reply to AT+IPR must get out intact
+static esp_err_t uart_hw_set_baud_rate_impl(uint32_t baud_rate, void* context)
+{
+  bg95_uart_interface_t* interface = (bg95_uart_interface_t*) context;
+  if (!interface || baud_rate == 0)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  esp_err_t err = uart_hw_wait_tx_done_impl(BG95_UART_TX_TIMEOUT_MS, interface);
+  if (err != ESP_OK)
+  {
+    return err;
+  }
+
+  err = uart_set_baudrate(interface->uart_num, baud_rate);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG,
+             "Failed to set baud rate %lu: %s",
+             (unsigned long) baud_rate,
+             esp_err_to_name(err));
+    return err;
+  }
+
+  // Anything received around the switch was sampled at the wrong rate
+  uart_flush_input(interface->uart_num);
+  return ESP_OK;
+}
+
+static esp_err_t uart_hw_set_flow_control_impl(bool enable, void* context)
+{
+  bg95_uart_interface_t* interface = (bg95_uart_interface_t*) context;
+  if (!interface)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (!enable)
+  {
+    return uart_set_hw_flow_ctrl(interface->uart_num, UART_HW_FLOWCTRL_DISABLE, 0);
+  }
+
+  esp_err_t err = uart_set_pin(interface->uart_num,
+                               UART_PIN_NO_CHANGE,
+                               UART_PIN_NO_CHANGE,
+                               interface->rts_gpio_num,
+                               interface->cts_gpio_num);
+  if (err != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Error setting RTS / CTS pins: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  // Deassert RTS with a few bytes of FIFO left, so nothing is lost while the task is busy
+  return uart_set_hw_flow_ctrl(
+      interface->uart_num, UART_HW_FLOWCTRL_CTS_RTS, BG95_UART_RTS_THRESHOLD);
+}
+
 // Real UART implementation
 esp_err_t bg95_uart_interface_init_hw(bg95_uart_interface_t* interface, bg95_uart_config_t config)
 {
@@ -126,13 +194,22 @@ esp_err_t bg95_uart_interface_init_hw(bg95_uart_interface_t* interface, bg95_uar
   // Clear interface first
   memset(interface, 0, sizeof(bg95_uart_interface_t));
 
-  interface->uart_num = (uart_port_t) config.port_num;
-  interface->context  = interface; // Store self as context
-  interface->write    = uart_hw_write_impl;
-  interface->read     = uart_hw_read_impl;
+  interface->uart_num      = (uart_port_t) config.port_num;
+  interface->context       = interface; // Store self as context
+  interface->write         = uart_hw_write_impl;
+  interface->read          = uart_hw_read_impl;
+  interface->wait_tx_done  = uart_hw_wait_tx_done_impl;
+  interface->set_baud_rate = uart_hw_set_baud_rate_impl;
+  interface->baud_rate     = config.baud_rate ? config.baud_rate : BG95_BAUD_RATE;
+  interface->rts_gpio_num  = config.rts_gpio_num;
+  interface->cts_gpio_num  = config.cts_gpio_num;
+  if (config.rts_gpio_num != config.cts_gpio_num)
+  {
+    interface->set_flow_control = uart_hw_set_flow_control_impl;
+  }
 
   uart_config_t uart_config = {
-      .baud_rate  = BG95_BAUD_RATE,
+      .baud_rate  = (int) interface->baud_rate,
       .data_bits  = UART_DATA_8_BITS,
       .parity     = UART_PARITY_DISABLE,
       .stop_bits  = UART_STOP_BITS_1,
@@ -181,7 +258,7 @@ esp_err_t bg95_uart_interface_init_hw(bg95_uart_interface_t* interface, bg95_uar
     return err;
   }
 
-  uart_flush(interface->uart_num);
+  uart_flush_input(interface->uart_num);
 
   vTaskDelay(pdMS_TO_TICKS(100));
 
@@ -210,8 +287,8 @@ esp_err_t bg95_uart_interface_loopback_test(bg95_uart_interface_t* interface)
 
   ESP_LOGI(TAG, "Starting UART loopback test...");
 
-  // First, flush any existing data
-  uart_flush(interface->uart_num);
+  // First, drop anything already received
+  uart_flush_input(interface->uart_num);
 
   // Send test string
   esp_err_t err = interface->write(test_str, strlen(test_str), interface->context);
@@ -261,8 +338,8 @@ esp_err_t bg95_uart_interface_test_at(bg95_uart_interface_t* interface)
 
   ESP_LOGI(TAG, "Sending AT test command...");
 
-  // First flush any existing data
-  uart_flush(interface->uart_num);
+  // First drop anything already received
+  uart_flush_input(interface->uart_num);
 
   // Send AT command
   esp_err_t err = interface->write(test_cmd, strlen(test_cmd), interface->context);
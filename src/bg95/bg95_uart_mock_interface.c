@@ -1,8 +1,9 @@
-#pragma once
-
 #include "bg95_uart_interface.h"
 #include "esp_log.h"
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdlib.h>
 #include <string.h>
 
 // NOTE: Was going to make this all static allocated on stack (no dynamic mem usage) - but its only
@@ -37,10 +38,17 @@ static esp_err_t uart_mock_write_impl(const char* data, size_t len, void* contex
 
   mock_uart_state_t* state = (mock_uart_state_t*) context;
 
-  // Store the command for later matching
-  state->last_received_cmd = data; // Assuming data remains valid
+  // Store the command for later matching (truncated - only a prefix of it is matched)
+  size_t copy_len = len;
+  if (copy_len >= sizeof(state->last_received_cmd))
+  {
+    copy_len = sizeof(state->last_received_cmd) - 1;
+  }
+  memcpy(state->last_received_cmd, data, copy_len);
+  state->last_received_cmd[copy_len] = '\0';
+  state->response_offset             = 0;
 
-  ESP_LOGI(TAG, "Mock UART write: %.*s", (int) len, data);
+  ESP_LOGD(TAG, "Mock UART write: %.*s", (int) len, data);
   return ESP_OK;
 }
 
@@ -55,6 +63,12 @@ static esp_err_t uart_mock_read_impl(
   mock_uart_state_t* state = (mock_uart_state_t*) context;
   *bytes_read              = 0;
 
+  // Nothing has been sent yet, so there is nothing to respond to
+  if (state->last_received_cmd[0] == '\0')
+  {
+    return ESP_OK;
+  }
+
   // Find matching response for last command
   const mock_uart_response_t* response = find_matching_response(state, state->last_received_cmd);
   if (!response)
@@ -63,24 +77,26 @@ static esp_err_t uart_mock_read_impl(
     return ESP_ERR_NOT_FOUND;
   }
 
-  // Handle delay if specified
-  if (response->delay_ms > 0)
+  // Handle delay if specified (once, before the first bytes of the response)
+  if (response->delay_ms > 0 && state->response_offset == 0)
   {
     vTaskDelay(pdMS_TO_TICKS(response->delay_ms));
   }
 
-  // Copy response data
-  size_t response_len = strlen(response->cmd_response);
+  // Copy what is left of the response - the handler reads it in chunks
+  const char* remaining    = response->cmd_response + state->response_offset;
+  size_t      response_len = strlen(remaining);
   if (response_len > max_len)
   {
     // IF response is longer than assigned buffer, copy up to the available buffer len of the
     // response
     response_len = max_len;
   }
-  memcpy(buffer, response->cmd_response, response_len);
+  memcpy(buffer, remaining, response_len);
   *bytes_read = response_len;
+  state->response_offset += response_len;
 
-  ESP_LOGI(TAG, "Mock UART read returned: %.*s", (int) response_len, response->cmd_response);
+  ESP_LOGD(TAG, "Mock UART read returned: %.*s", (int) response_len, remaining);
   return ESP_OK;
 }
 
@@ -101,14 +117,18 @@ esp_err_t mock_uart_init(bg95_uart_interface_t*      interface,
   }
 
   // Initialize state
-  state->responses         = responses;
-  state->num_responses     = num_responses;
-  state->last_received_cmd = NULL;
+  state->responses            = responses;
+  state->num_responses        = num_responses;
+  state->last_received_cmd[0] = '\0';
+  state->response_offset      = 0;
 
   // Set up interface
-  interface->write   = uart_mock_write_impl;
-  interface->read    = uart_mock_read_impl;
-  interface->context = state;
+  interface->write            = uart_mock_write_impl;
+  interface->read             = uart_mock_read_impl;
+  interface->wait_tx_done     = NULL;
+  interface->set_baud_rate    = NULL;
+  interface->set_flow_control = NULL;
+  interface->context          = state;
 
   return ESP_OK;
 }
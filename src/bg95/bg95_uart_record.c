@@ -0,0 +1,463 @@
+#include "bg95_uart_record.h"
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include <esp_timer.h>
+#include <string.h>
+
+static const char* TAG = "BG95_UART_RECORD";
+
+static const uint8_t HEADER_MAGIC[4] = {'B', '9', '5', 'R'};
+
+// ------------------------------ VARINTS ---------------------------------
+
+static size_t put_varint(uint8_t* out, uint64_t value)
+{
+  size_t len = 0;
+  do
+  {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    out[len++] = value ? (byte | 0x80) : byte;
+  } while (value);
+  return len;
+}
+
+// Returns the bytes used, 0 if 'data' ends inside the varint (or it is longer than 64 bits)
+static size_t get_varint(const uint8_t* data, size_t len, uint64_t* value)
+{
+  *value = 0;
+  for (size_t i = 0; i < len && i < 10; i++)
+  {
+    *value |= (uint64_t) (data[i] & 0x7F) << (7 * i);
+    if (!(data[i] & 0x80))
+    {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+static size_t put_chunk_header(uint8_t* out, uint8_t kind, uint64_t delta_us, size_t len)
+{
+  size_t pos = put_varint(out, kind);
+  pos += put_varint(out + pos, delta_us);
+  pos += put_varint(out + pos, len);
+  return pos;
+}
+
+// ------------------------------ RING ---------------------------------
+// Whole chunks, encoded as in the capture. 'ring_head' is where the next byte goes and the oldest
+// chunk starts 'ring_used' bytes before it - room is made by dropping chunks from there
+
+static void
+ring_copy_out(const bg95_uart_record_t* recorder, size_t offset, uint8_t* out, size_t len)
+{
+  size_t size  = recorder->config.ring_size;
+  size_t first = size - offset;
+  if (first > len)
+  {
+    first = len;
+  }
+  memcpy(out, recorder->config.ring + offset, first);
+  memcpy(out + first, recorder->config.ring, len - first);
+}
+
+static size_t ring_oldest(const bg95_uart_record_t* recorder)
+{
+  size_t size = recorder->config.ring_size;
+  return (recorder->ring_head + size - recorder->ring_used) % size;
+}
+
+// Header of the oldest chunk - copied out first, it may wrap
+static size_t ring_oldest_header(const bg95_uart_record_t* recorder,
+                                 uint64_t*                 kind,
+                                 uint64_t*                 delta_us,
+                                 uint64_t*                 len)
+{
+  uint8_t header[BG95_UART_RECORD_CHUNK_OVERHEAD];
+  size_t  available = recorder->ring_used < sizeof(header) ? recorder->ring_used : sizeof(header);
+  ring_copy_out(recorder, ring_oldest(recorder), header, available);
+
+  size_t pos = get_varint(header, available, kind);
+  pos += get_varint(header + pos, available - pos, delta_us);
+  pos += get_varint(header + pos, available - pos, len);
+  return pos;
+}
+
+static void ring_drop_oldest(bg95_uart_record_t* recorder)
+{
+  uint64_t kind;
+  uint64_t delta_us;
+  uint64_t len;
+  size_t   header_len = ring_oldest_header(recorder, &kind, &delta_us, &len);
+
+  recorder->ring_used -= header_len + (size_t) len;
+  recorder->stats.chunks_dropped++;
+}
+
+static void ring_write(bg95_uart_record_t* recorder, const uint8_t* data, size_t len)
+{
+  size_t size  = recorder->config.ring_size;
+  size_t first = size - recorder->ring_head;
+  if (first > len)
+  {
+    first = len;
+  }
+  memcpy(recorder->config.ring + recorder->ring_head, data, first);
+  memcpy(recorder->config.ring, data + first, len - first);
+  recorder->ring_head = (recorder->ring_head + len) % size;
+  recorder->ring_used += len;
+}
+
+// ------------------------------ RECORDING ---------------------------------
+
+static void sink_write(bg95_uart_record_t* recorder, const void* data, size_t len)
+{
+  if (!recorder->config.sink || recorder->sink_failed)
+  {
+    return;
+  }
+  if (recorder->config.sink(data, len, recorder->config.sink_context) != ESP_OK)
+  {
+    ESP_LOGW(TAG, "Sink failed - streaming stopped");
+    recorder->sink_failed = true;
+    recorder->stats.sink_errors++;
+  }
+}
+
+// Caller holds the lock
+static void record_piece(bg95_uart_record_t* recorder,
+                         uint8_t             kind,
+                         int64_t             time_us,
+                         const uint8_t*      data,
+                         size_t              len)
+{
+  uint8_t  header[BG95_UART_RECORD_CHUNK_OVERHEAD];
+  uint64_t delta_us = (time_us > recorder->last_us) ? (uint64_t) (time_us - recorder->last_us) : 0;
+  recorder->last_us = time_us;
+
+  size_t header_len = put_chunk_header(header, kind, delta_us, len);
+
+  if (recorder->config.ring)
+  {
+    while (recorder->ring_used + header_len + len > recorder->config.ring_size)
+    {
+      ring_drop_oldest(recorder);
+    }
+    ring_write(recorder, header, header_len);
+    ring_write(recorder, data, len);
+  }
+
+  sink_write(recorder, header, header_len);
+  sink_write(recorder, data, len);
+}
+
+static void record_chunk(bg95_uart_record_t* recorder,
+                         uint8_t             kind,
+                         int64_t             time_us,
+                         const void*         data,
+                         size_t              len)
+{
+  if (!recorder->enabled || len == 0)
+  {
+    return;
+  }
+
+  // A chunk must fit the ring with room to spare, or it would push out everything else
+  size_t max_piece = recorder->config.ring ? recorder->config.ring_size / 2 : len;
+
+  xSemaphoreTake(recorder->lock, portMAX_DELAY);
+
+  const uint8_t* bytes = (const uint8_t*) data;
+  for (size_t pos = 0; pos < len; pos += max_piece)
+  {
+    size_t piece = (len - pos < max_piece) ? len - pos : max_piece;
+    record_piece(recorder, kind, time_us, bytes + pos, piece);
+  }
+
+  if (kind == BG95_UART_RECORD_TX)
+  {
+    recorder->stats.chunks_tx++;
+    recorder->stats.bytes_tx += len;
+  }
+  else if (kind == BG95_UART_RECORD_RX)
+  {
+    recorder->stats.chunks_rx++;
+    recorder->stats.bytes_rx += len;
+  }
+
+  xSemaphoreGive(recorder->lock);
+}
+
+// ------------------------------ INTERFACE ---------------------------------
+
+static esp_err_t record_write(const char* data, size_t len, void* context)
+{
+  bg95_uart_record_t* recorder = (bg95_uart_record_t*) context;
+  int64_t             time_us  = esp_timer_get_time();
+
+  esp_err_t err = recorder->inner.write(data, len, recorder->inner.context);
+  if (err == ESP_OK)
+  {
+    record_chunk(recorder, BG95_UART_RECORD_TX, time_us, data, len);
+  }
+  return err;
+}
+
+static esp_err_t
+record_read(char* buffer, size_t max_len, size_t* bytes_read, uint32_t timeout_ms, void* context)
+{
+  bg95_uart_record_t* recorder = (bg95_uart_record_t*) context;
+
+  esp_err_t err =
+      recorder->inner.read(buffer, max_len, bytes_read, timeout_ms, recorder->inner.context);
+  if (err == ESP_OK && bytes_read)
+  {
+    record_chunk(recorder, BG95_UART_RECORD_RX, esp_timer_get_time(), buffer, *bytes_read);
+  }
+  return err;
+}
+
+static esp_err_t record_wait_tx_done(uint32_t timeout_ms, void* context)
+{
+  bg95_uart_record_t* recorder = (bg95_uart_record_t*) context;
+  return recorder->inner.wait_tx_done(timeout_ms, recorder->inner.context);
+}
+
+static esp_err_t record_set_baud_rate(uint32_t baud_rate, void* context)
+{
+  bg95_uart_record_t* recorder = (bg95_uart_record_t*) context;
+
+  esp_err_t err = recorder->inner.set_baud_rate(baud_rate, recorder->inner.context);
+  if (err == ESP_OK)
+  {
+    uint8_t rate[4] = {(uint8_t) baud_rate,
+                       (uint8_t) (baud_rate >> 8),
+                       (uint8_t) (baud_rate >> 16),
+                       (uint8_t) (baud_rate >> 24)};
+    record_chunk(recorder, BG95_UART_RECORD_BAUD, esp_timer_get_time(), rate, sizeof(rate));
+  }
+  return err;
+}
+
+static esp_err_t record_set_flow_control(bool enable, void* context)
+{
+  bg95_uart_record_t* recorder = (bg95_uart_record_t*) context;
+  return recorder->inner.set_flow_control(enable, recorder->inner.context);
+}
+
+esp_err_t bg95_uart_record_init(bg95_uart_record_t*              recorder,
+                                const bg95_uart_interface_t*     inner,
+                                const bg95_uart_record_config_t* config,
+                                bg95_uart_interface_t*           uart)
+{
+  if (!recorder || !inner || !inner->write || !inner->read || !config || !uart ||
+      (config->ring && config->ring_size < BG95_UART_RECORD_MIN_RING_SIZE))
+  {
+    ESP_LOGE(TAG, "Invalid arguments");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(recorder, 0, sizeof(bg95_uart_record_t));
+  recorder->inner   = *inner;
+  recorder->config  = *config;
+  recorder->last_us = esp_timer_get_time();
+  recorder->enabled = true;
+
+  recorder->lock = xSemaphoreCreateMutex();
+  if (!recorder->lock)
+  {
+    ESP_LOGE(TAG, "Failed to create recorder lock");
+    return ESP_ERR_NO_MEM;
+  }
+
+  uint8_t header[BG95_UART_RECORD_HEADER_LEN];
+  memcpy(header, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+  header[sizeof(HEADER_MAGIC)] = BG95_UART_RECORD_VERSION;
+  sink_write(recorder, header, sizeof(header));
+
+  *uart                  = *inner;
+  uart->write            = record_write;
+  uart->read             = record_read;
+  uart->wait_tx_done     = inner->wait_tx_done ? record_wait_tx_done : NULL;
+  uart->set_baud_rate    = inner->set_baud_rate ? record_set_baud_rate : NULL;
+  uart->set_flow_control = inner->set_flow_control ? record_set_flow_control : NULL;
+  uart->context          = recorder;
+  return ESP_OK;
+}
+
+esp_err_t bg95_uart_record_deinit(bg95_uart_record_t* recorder)
+{
+  if (!recorder)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (recorder->lock)
+  {
+    vSemaphoreDelete(recorder->lock);
+    recorder->lock = NULL;
+  }
+  recorder->enabled = false;
+  return ESP_OK;
+}
+
+void bg95_uart_record_enable(bg95_uart_record_t* recorder, bool enabled)
+{
+  if (recorder)
+  {
+    recorder->enabled = enabled;
+  }
+}
+
+void bg95_uart_record_clear(bg95_uart_record_t* recorder)
+{
+  if (!recorder || !recorder->lock)
+  {
+    return;
+  }
+
+  xSemaphoreTake(recorder->lock, portMAX_DELAY);
+  recorder->ring_head = 0;
+  recorder->ring_used = 0;
+  memset(&recorder->stats, 0, sizeof(recorder->stats));
+  xSemaphoreGive(recorder->lock);
+}
+
+esp_err_t bg95_uart_record_read(bg95_uart_record_t* recorder,
+                                uint8_t*            buffer,
+                                size_t              buffer_size,
+                                size_t*             len)
+{
+  if (!recorder || !recorder->lock || !len || (!buffer && buffer_size > 0))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!recorder->config.ring)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake(recorder->lock, portMAX_DELAY);
+
+  uint8_t first_header[BG95_UART_RECORD_CHUNK_OVERHEAD];
+  size_t  first_header_len = 0;
+  size_t  skip             = 0;
+
+  // The time of the oldest chunk is relative to one that is gone - it starts the capture instead
+  if (recorder->ring_used > 0)
+  {
+    uint64_t kind;
+    uint64_t delta_us;
+    uint64_t chunk_len;
+    skip             = ring_oldest_header(recorder, &kind, &delta_us, &chunk_len);
+    first_header_len = put_chunk_header(first_header, (uint8_t) kind, 0, (size_t) chunk_len);
+  }
+
+  *len = BG95_UART_RECORD_HEADER_LEN + first_header_len + recorder->ring_used - skip;
+  if (*len > buffer_size)
+  {
+    xSemaphoreGive(recorder->lock);
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  memcpy(buffer, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+  buffer[sizeof(HEADER_MAGIC)] = BG95_UART_RECORD_VERSION;
+  memcpy(buffer + BG95_UART_RECORD_HEADER_LEN, first_header, first_header_len);
+  ring_copy_out(recorder,
+                (ring_oldest(recorder) + skip) % recorder->config.ring_size,
+                buffer + BG95_UART_RECORD_HEADER_LEN + first_header_len,
+                recorder->ring_used - skip);
+
+  xSemaphoreGive(recorder->lock);
+  return ESP_OK;
+}
+
+esp_err_t bg95_uart_record_get_stats(bg95_uart_record_t* recorder, bg95_uart_record_stats_t* stats)
+{
+  if (!recorder || !recorder->lock || !stats)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTake(recorder->lock, portMAX_DELAY);
+  *stats = recorder->stats;
+  xSemaphoreGive(recorder->lock);
+  return ESP_OK;
+}
+
+// ------------------------------ READER ---------------------------------
+
+esp_err_t bg95_uart_record_reader_init(bg95_uart_record_reader_t* reader,
+                                       const void*                capture,
+                                       size_t                     len)
+{
+  if (!reader || !capture)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  const uint8_t* bytes = (const uint8_t*) capture;
+  if (len < BG95_UART_RECORD_HEADER_LEN || memcmp(bytes, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0)
+  {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  if (bytes[sizeof(HEADER_MAGIC)] > BG95_UART_RECORD_VERSION)
+  {
+    return ESP_ERR_INVALID_VERSION;
+  }
+
+  reader->capture = bytes;
+  reader->len     = len;
+  reader->pos     = BG95_UART_RECORD_HEADER_LEN;
+  reader->time_us = 0;
+  return ESP_OK;
+}
+
+esp_err_t bg95_uart_record_reader_next(bg95_uart_record_reader_t* reader,
+                                       bg95_uart_record_chunk_t*  chunk)
+{
+  if (!reader || !reader->capture || !chunk)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (reader->pos >= reader->len)
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  const uint8_t* data = reader->capture + reader->pos;
+  size_t         left = reader->len - reader->pos;
+  uint64_t       kind;
+  uint64_t       delta_us;
+  uint64_t       len;
+  size_t         used;
+  size_t         pos = 0;
+
+  if ((used = get_varint(data, left, &kind)) == 0)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  pos += used;
+  if ((used = get_varint(data + pos, left - pos, &delta_us)) == 0)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  pos += used;
+  if ((used = get_varint(data + pos, left - pos, &len)) == 0 || len > left - pos - used)
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  pos += used;
+
+  reader->time_us += delta_us;
+  reader->pos += pos + (size_t) len;
+
+  chunk->kind    = (bg95_uart_record_kind_t) kind;
+  chunk->time_us = reader->time_us;
+  chunk->data    = data + pos;
+  chunk->len     = (size_t) len;
+  return ESP_OK;
+}
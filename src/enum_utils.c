@@ -10,6 +10,11 @@ const char* enum_to_str(int value, const enum_str_map_t* mapping, size_t map_siz
     return "INVALID_MAP";
   }
 
+  if (value >= 0 && (size_t) value < map_size && mapping[value].value == value)
+  {
+    return mapping[value].string;
+  }
+
   for (size_t i = 0U; i < map_size; i++)
   {
     if (value == mapping[i].value)